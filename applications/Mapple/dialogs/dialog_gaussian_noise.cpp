@@ -70,11 +70,14 @@ void DialogGaussianNoise::apply() {
     const float sigma = lineEditGaussianNoiseSigma->text().toFloat();
     if (dynamic_cast<SurfaceMesh *>(model)) {
         GaussianNoise::apply(dynamic_cast<SurfaceMesh *>(model), sigma);
-        model->renderer()->update();
+        // the vertices are moved (without changing the connectivity), so only the affected buffers are updated
+        model->mark_modified("v:point");
+        model->renderer()->update_modified();
         viewer_->update();
     } else if (dynamic_cast<PointCloud *>(model)) {
         GaussianNoise::apply(dynamic_cast<PointCloud *>(model), sigma);
-        model->renderer()->update();
+        model->mark_modified("v:point");
+        model->renderer()->update_modified();
         viewer_->update();
     }
 }
@@ -32,6 +32,7 @@
 #include <easy3d/core/graph.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/string.h>
+#include <easy3d/util/memory.h>
 #include <easy3d/renderer/renderer.h>
 #include <easy3d/fileio/image_io.h>
 #include <easy3d/fileio/resources.h>
@@ -40,6 +41,7 @@
 #include "main_window.h"
 
 #include <algorithm>
+#include <sstream>
 #include <QDockWidget>
 
 
@@ -1073,6 +1075,7 @@ namespace details {
 
 void DialogProperties::propertyChanged(const QString &name) {
     comboBoxSourceType->clear();
+    updateMemoryUsage(name);
 
     if (name.isEmpty())
         return;
@@ -1128,6 +1131,47 @@ void DialogProperties::propertyChanged(const QString &name) {
 }
 
 
+void DialogProperties::updateMemoryUsage(const QString &name) {
+    labelMemoryUsage->clear();
+    labelMemoryUsage->setToolTip("");
+
+    Model *model = getModel();
+    if (!model)
+        return;
+
+    const memory::Usage usage = model->memory_usage();
+    memory::Usage gpu_usage;
+    if (model->renderer())
+        gpu_usage = model->renderer()->memory_usage();
+
+    QString text;
+    // e.g., "Vertex" -> "vertex properties"
+    const std::string location = comboBoxPropertyLocation->currentText().toLower().toStdString() + " properties";
+    for (const auto &properties : usage.children) {
+        if (properties.name != location)
+            continue;
+        for (const auto &p : properties.children) {
+            if (p.name == name.toStdString()) {
+                text = QString("%1 (allocated %2); ")
+                        .arg(QString::fromStdString(memory::to_string(p.used)))
+                        .arg(QString::fromStdString(memory::to_string(p.allocated)));
+            }
+        }
+    }
+    text += QString("model: %1, GPU: %2")
+            .arg(QString::fromStdString(memory::to_string(usage.allocated)))
+            .arg(QString::fromStdString(memory::to_string(gpu_usage.used)));
+    labelMemoryUsage->setText(text);
+
+    // the detailed report
+    std::ostringstream report;
+    usage.print(report);
+    gpu_usage.print(report);
+    memory::process_usage().print(report);
+    labelMemoryUsage->setToolTip(QString::fromStdString(report.str()));
+}
+
+
 void DialogProperties::updateProperties() {
     const std::string &model_text = comboBoxModels->currentText().toStdString();
     bool model_text_has_match = false;
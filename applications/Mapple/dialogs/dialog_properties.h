@@ -56,6 +56,9 @@ private Q_SLOTS:
 private:
     easy3d::Model *getModel();
 
+    // shows the memory used by the selected property and the model
+    void updateMemoryUsage(const QString &name);
+
     bool removeProperty();
     bool renameProperty();
     bool convertPropertyDataType();
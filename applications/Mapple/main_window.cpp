@@ -432,9 +432,9 @@ bool MainWindow::onOpen() {
                 this,
                 "Open file(s)",
                 curDataDirectory_,
-                "Supported formats (*.ply *.obj *.off *.stl *.sm *.geojson *.trilist *.bin *.las *.laz *.xyz *.bxyz *.vg *.bvg *.ptx *.plm *.pm *.mesh)\n"
-                "Surface Mesh (*.ply *.obj *.off *.stl *.sm *.geojson *.trilist)\n"
-                "Point Cloud (*.ply *.bin *.ptx *.las *.laz *.xyz *.bxyz *.vg *.bvg *.ptx)\n"
+                "Supported formats (*.ply *.obj *.off *.stl *.sm *.csm *.geojson *.trilist *.bin *.cbin *.las *.laz *.xyz *.bxyz *.vg *.bvg *.ptx *.plm *.pm *.mesh)\n"
+                "Surface Mesh (*.ply *.obj *.off *.stl *.sm *.csm *.geojson *.trilist)\n"
+                "Point Cloud (*.ply *.bin *.cbin *.ptx *.las *.laz *.xyz *.bxyz *.vg *.bvg *.ptx)\n"
                 "Polyhedral Mesh (*.plm *.pm *.mesh)\n"
                 "Graph (*.ply)\n"
                 "All formats (*.*)"
@@ -465,9 +465,9 @@ bool MainWindow::onSave() {
                 this,
                 "Save file",
                 QString::fromStdString(default_file_name),
-                "Supported formats (*.ply *.obj *.off *.stl *.sm *.bin *.las *.laz *.xyz *.bxyz *.vg *.bvg *.plm *.pm *.mesh)\n"
-                "Surface Mesh (*.ply *.obj *.off *.stl *.sm)\n"
-                "Point Cloud (*.ply *.bin *.ptx *.las *.laz *.xyz *.bxyz *.vg *.bvg)\n"
+                "Supported formats (*.ply *.obj *.off *.stl *.sm *.csm *.bin *.cbin *.las *.laz *.xyz *.bxyz *.vg *.bvg *.plm *.pm *.mesh)\n"
+                "Surface Mesh (*.ply *.obj *.off *.stl *.sm *.csm)\n"
+                "Point Cloud (*.ply *.bin *.cbin *.ptx *.las *.laz *.xyz *.bxyz *.vg *.bvg)\n"
                 "Polyhedral Mesh (*.plm *.pm *.mesh)\n"
                 "Graph (*.ply)\n"
                 "All formats (*.*)"
@@ -519,7 +519,7 @@ Model* MainWindow::open(const std::string& file_name) {
         is_ply_mesh = (io::PlyReader::num_instances(file_name, "face") > 0);
 
     Model* model = nullptr;
-    if ((ext == "ply" && is_ply_mesh) || ext == "obj" || ext == "off" || ext == "stl" || ext == "sm" || ext == "geojson" || ext == "trilist") { // mesh
+    if ((ext == "ply" && is_ply_mesh) || ext == "obj" || ext == "off" || ext == "stl" || ext == "sm" || ext == "csm" || ext == "geojson" || ext == "trilist") { // mesh
         model = SurfaceMeshIO::load(file_name);
     }
     else if (ext == "ply" && io::PlyReader::num_instances(file_name, "edge") > 0) {
@@ -530,8 +530,8 @@ Model* MainWindow::open(const std::string& file_name) {
     else { // point cloud
         if (ext == "ptx") {
             io::PointCloudIO_ptx serializer(file_name);
-            PointCloud* cloud = nullptr;
-            while ((cloud = serializer.load_next())) {
+            const std::vector<PointCloud*> clouds = serializer.load_all();
+            for (auto cloud : clouds) {
                 viewer_->addModel(cloud);
                 ui->treeWidgetModels->addModel(cloud, true);
             }
@@ -540,6 +540,9 @@ Model* MainWindow::open(const std::string& file_name) {
             model = PointCloudIO::load(file_name);
     }
 
+    // the number of the (rate-limited) messages suppressed while loading the file, e.g., on bad faces
+    logging::report_suppressed();
+
     if (model) {
         model->set_name(file_name);
         viewer_->addModel(model);
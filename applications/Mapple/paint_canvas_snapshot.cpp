@@ -25,6 +25,7 @@
  ********************************************************************/
 
 
+
 #define USE_QT_FBO
 #define SHOW_PROGRESS
 
@@ -38,6 +39,9 @@
 #include <QMessageBox>
 #include <QApplication>
 
+#include <cstring>
+#include <algorithm>
+
 #include "paint_canvas.h"
 #include "main_window.h"
 #include "walk_through.h"
@@ -45,6 +49,9 @@
 #include <easy3d/renderer/camera.h>
 #include <easy3d/renderer/transform.h>
 #include <easy3d/renderer/key_frame_interpolator.h>
+#include <easy3d/renderer/async_pixel_reader.h>
+#include <easy3d/fileio/frame_sink.h>
+#include <easy3d/fileio/image_io.h>
 #include <easy3d/core//model.h>
 #include <easy3d/util/logging.h>
 #include <easy3d/util/file_system.h>
@@ -56,6 +63,63 @@
 
 using namespace easy3d;
 
+
+namespace details {
+
+#ifdef USE_QT_FBO
+    typedef QOpenGLFramebufferObject FBO;
+#else
+    typedef FramebufferObject FBO;
+#endif
+
+    FBO *create_fbo(int w, int h, int samples) {
+#ifdef USE_QT_FBO
+        QOpenGLFramebufferObjectFormat format;
+        format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+        format.setSamples(samples);
+        QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(w, h, format);
+        fbo->addColorAttachment(w, h);
+#else
+        FramebufferObject* fbo = new FramebufferObject(w, h, samples);
+        fbo->add_color_buffer();
+        fbo->add_depth_buffer();
+#endif
+        return fbo;
+    }
+
+    // Pixels can't be read from a multisample framebuffer directly. It is resolved into this one before readback.
+    FBO *create_resolve_fbo(int w, int h, int samples) {
+        if (samples <= 0)
+            return nullptr;
+#ifdef USE_QT_FBO
+        return new QOpenGLFramebufferObject(w, h);
+#else
+        FramebufferObject* fbo = new FramebufferObject(w, h, 0);
+        fbo->add_color_buffer();
+        return fbo;
+#endif
+    }
+
+    // Starts the asynchronous readback of the color buffer of the rendered framebuffer. Returns immediately.
+    bool request_pixels(AsyncPixelReader &reader, FBO *fbo, FBO *resolve_fbo, int w, int h, GLenum format) {
+        FBO *source = fbo;
+        if (resolve_fbo) {
+#ifdef USE_QT_FBO
+            QOpenGLFramebufferObject::blitFramebuffer(resolve_fbo, fbo);
+#else
+            FramebufferObject::blit_framebuffer(resolve_fbo, fbo, GL_COLOR_BUFFER_BIT);
+#endif
+            source = resolve_fbo;
+        }
+        source->bind();
+        const bool success = reader.request(0, 0, w, h, format);
+        source->release();
+        return success;
+    }
+
+}
+
+
 bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_name, bool bk_white, bool expand) {
     int max_samples = 0;
     makeCurrent();
@@ -92,12 +156,28 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
             yMin = xMin / newAspectRatio;
     }
 
-    QImage image(w, h, QImage::Format_RGBA8888);
-    if (image.isNull()) {
-        QMessageBox::warning(this, "Image saving error", "Failed to allocate the image", QMessageBox::Ok,
-                             QMessageBox::NoButton);
-        doneCurrent();
-        return false;
+    // For these formats, the image is written band by band (each band is a row of tiles) while the tiles are being
+    // rendered. Otherwise, the tiles are assembled into a full image that is saved at the end.
+    const std::string ext = file_system::extension(file_name.toStdString());
+    const bool streamed = (ext == "png" || ext == "ppm" || ext == "bmp" || ext == "tga");
+    const int channels = (ext == "ppm") ? 3 : 4;
+    const GLenum format = (channels == 3) ? GL_RGB : GL_RGBA;
+
+    ImageStreamWriter writer;
+    QImage image;
+    if (streamed) {
+        if (!writer.open(file_name.toStdString(), w, h, channels)) {
+            QMessageBox::warning(this, "Image saving error", "Failed to create the image file", QMessageBox::Ok,
+                                 QMessageBox::NoButton);
+            return false;
+        }
+    } else {
+        image = QImage(w, h, QImage::Format_RGBA8888);
+        if (image.isNull()) {
+            QMessageBox::warning(this, "Image saving error", "Failed to allocate the image", QMessageBox::Ok,
+                                 QMessageBox::NoButton);
+            return false;
+        }
     }
 
     double scaleX = sub_w / static_cast<double>(w);
@@ -110,6 +190,27 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
     if (nbX * sub_w < w) ++nbX;
     if (nbY * sub_h < h) ++nbY;
 
+    // The tiles are copied into the current band (or the image) on a worker thread. A single worker consumes the
+    // tiles in order, from the top-left to the bottom-right.
+    std::vector<unsigned char> band(streamed ? static_cast<std::size_t>(w) * sub_h * channels : 0);
+    FrameSink sink([&](FrameSink::Frame &tile) -> bool {
+        const int i = static_cast<int>(tile.index % nbX);
+        const int j = static_cast<int>(tile.index / nbX);
+        const int band_h = std::min(sub_h, h - j * sub_h);
+        const int tile_w = std::min(sub_w, w - i * sub_w);
+        // the rows of a tile are bottom-up (OpenGL convention), and the rows of the image are top-down
+        for (int row = 0; row < band_h; ++row) {
+            const std::size_t src_row = tile.height - 1 - row;
+            const unsigned char *src = tile.pixels.data() + src_row * tile.width * channels;
+            unsigned char *dst = streamed ? band.data() + static_cast<std::size_t>(row) * w * channels
+                                          : image.scanLine(j * sub_h + row);
+            std::memcpy(dst + static_cast<std::size_t>(i) * sub_w * channels, src, tile_w * channels);
+        }
+        if (streamed && i == nbX - 1)   // the band is complete
+            return writer.write_rows(band.data(), band_h);
+        return true;
+    }, 1, 4);
+
     // remember the current projection matrix
     // const mat4& proj_matrix = camera()->projectionMatrix(); // Liangliang: This will definitely NOT work !!!
     const mat4 proj_matrix = camera()->projectionMatrix();
@@ -119,27 +220,27 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
 
     makeCurrent();
 
-#ifdef USE_QT_FBO
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setSamples(samples);
-    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(sub_w, sub_h, format);
-    fbo->addColorAttachment(sub_w, sub_h);
-#else
-    FramebufferObject* fbo = new FramebufferObject(sub_w, sub_h, samples);
-    fbo->add_color_buffer();
-    fbo->add_depth_buffer();
-#endif
+    details::FBO *fbo = details::create_fbo(sub_w, sub_h, samples);
+    details::FBO *resolve_fbo = details::create_resolve_fbo(sub_w, sub_h, samples);
+
+    // the pixels of a tile are retrieved after the next tile has been rendered
+    AsyncPixelReader reader;
+    std::size_t next_tile = 0;
+    auto retrieve_tile = [&]() -> bool {
+        FrameSink::Frame tile = sink.new_frame(next_tile++, sub_w, sub_h, channels);
+        return reader.retrieve(tile.pixels, tile.width, tile.height) && sink.push(std::move(tile));
+    };
 
-    int count = 0;
+    bool success = true;
 #ifdef SHOW_PROGRESS
-    ProgressLogger progress(nbX * nbY * 1.1f, false, false); // the extra 0.1 is for saving the "big" image (time-consuming)
+    ProgressLogger progress(nbX * nbY, false, false);
 #endif
-    for (int i = 0; i < nbX; i++) {
-        for (int j = 0; j < nbY; j++) {
+    for (int j = 0; j < nbY && success; j++) {
+        for (int i = 0; i < nbX; i++) {
 #ifdef SHOW_PROGRESS
             if (progress.is_canceled()) {
                 LOG(WARNING) << "snapshot cancelled";
+                success = false;
                 break;
             }
 #endif
@@ -175,33 +276,11 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
 
             //---------------------------------------------------------------------------
 
-
-#ifdef USE_QT_FBO
-            const QImage subImage = fbo->toImage();
-#else
-            QImage subImage(sub_w, sub_h, QImage::Format_RGBA8888);
-            fbo->read_color(0, const_cast<unsigned char*>(subImage.constBits()), GL_RGBA);
-#endif
-
-            // Copy subImage in image
-            for (int ii = 0; ii < sub_w; ii++) {
-                int fi = i * sub_w + ii;
-                if (fi == image.width())
-                    break;
-                for (int jj = 0; jj < sub_h; jj++) {
-                    int fj = j * sub_h + jj;
-                    if (fj == image.height())
-                        break;
-                    image.setPixel(fi, fj, subImage.pixel(ii, jj));
-                }
+            if ((reader.is_full() && !retrieve_tile()) ||
+                !details::request_pixels(reader, fbo, resolve_fbo, sub_w, sub_h, format)) {
+                success = false;
+                break;
             }
-            /************************************************************************/
-            // save each tile (mainly for debug purpose)
-            //QString name = QString("tmp-%1.png").arg(count);
-            //subImage.save(name);
-            //std::cout << "tile: " << count << "/" << nbX * nbY << std::endl;
-            /************************************************************************/
-            ++count;
 
 #ifdef SHOW_PROGRESS
             progress.next();
@@ -209,10 +288,15 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
         }
     }
 
-    // this very important (the progress bar may interfere the framebuffer)
+    // retrieve the remaining tiles
     makeCurrent();
+    while (success && reader.num_pending() > 0)
+        success = retrieve_tile();
+
     // clean
+    reader.release();
     delete fbo;
+    delete resolve_fbo;
     // restore the clear color
     func_->glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
     doneCurrent();
@@ -223,7 +307,19 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
     // enable updating the rendering
     easy3d::connect(&camera_->frame_modified, this, static_cast<void (PaintCanvas::*)(void)>(&PaintCanvas::update));
 
-    return image.save(file_name);
+    // wait for the tiles to be written
+    if (!sink.finish())
+        success = false;
+
+    if (streamed) {
+        if (!success) {
+            writer.close();
+            file_system::delete_file(file_name.toStdString());
+            return false;
+        }
+        return writer.close();
+    }
+    return success && image.save(file_name);
 }
 
 
@@ -270,22 +366,36 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
         return;
     }
 
+    // The color conversion and encoding are done on a worker thread. The encoder requires the frames in order, so
+    // a single worker is used.
+    QString encoding_error;
+    FrameSink sink([&encoder, &encoding_error](FrameSink::Frame &frame) -> bool {
+        // the pixels are bottom-up RGBA, while QVideoEncoder only accepts Format_RGB32, Format_ARGB32, or
+        // Format_ARGB32_Premultiplied
+        const QImage image = QImage(frame.pixels.data(), frame.width, frame.height, QImage::Format_RGBA8888)
+                .mirrored().convertToFormat(QImage::Format_ARGB32);
+        QString errorString;
+        if (!encoder.encodeImage(image, static_cast<int>(frame.index), &errorString)) {
+            encoding_error = QString("Failed to encode frame #%1: %2").arg(frame.index + 1).arg(errorString);
+            return false;
+        }
+        return true;
+    }, 1, 4);
+
     const auto &frames = kfi->interpolate();
     makeCurrent();
 
-#ifdef USE_QT_FBO
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setSamples(samples());
-    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(fw, fh, format);
-    fbo->addColorAttachment(fw, fh);
-#else
-    FramebufferObject* fbo = new FramebufferObject(fw, fh, samples());
-    fbo->add_color_buffer();
-    fbo->add_depth_buffer();
-#endif
+    details::FBO *fbo = details::create_fbo(fw, fh, samples());
+    details::FBO *resolve_fbo = details::create_resolve_fbo(fw, fh, samples());
+
+    // the pixels of a frame are retrieved after the next frame has been rendered
+    AsyncPixelReader reader;
+    std::size_t next_frame = 0;
+    auto retrieve_frame = [&]() -> bool {
+        FrameSink::Frame frame = sink.new_frame(next_frame++, fw, fh, 4);
+        return reader.retrieve(frame.pixels, frame.width, frame.height) && sink.push(std::move(frame));
+    };
 
-    const QString ext_less_name = file_name.left(file_name.lastIndexOf('.'));
 #ifdef SHOW_PROGRESS
     ProgressLogger progress(frames.size(), true, false);
 #endif
@@ -320,25 +430,8 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
 
         //---------------------------------------------------------------------------
 
-#ifdef USE_QT_FBO
-        const QImage image = fbo->toImage();
-        if (image.isNull()) {
-            QMessageBox::critical(this, "Error", "Failed to grab the framebuffer!");
-            success = false;
-            break;
-        }
-#else
-        QImage image(fw, fh, QImage::Format_RGBA8888);
-        fbo->read_color(0, const_cast<unsigned char*>(image.constBits()), GL_RGBA);
-
-        // QVideoEncoder only accepted Format_RGB32, Format_ARGB32, or Format_ARGB32_Premultiplied
-        image.convertTo(QImage::Format_ARGB32);
-#endif
-
-        QString errorString;
-        if (!encoder.encodeImage(image, frame_index, &errorString)) {
-            QMessageBox::critical(this, "Error",
-                                  QString("Failed to encode frame #%1: %2").arg(frame_index + 1).arg(errorString));
+        if ((reader.is_full() && !retrieve_frame()) ||
+            !details::request_pixels(reader, fbo, resolve_fbo, fw, fh, GL_RGBA)) {
             success = false;
             break;
         }
@@ -350,12 +443,24 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
 
     // this very important (the progress bar may interfere the framebuffer)
     makeCurrent();
+    // retrieve the remaining frames (also when cancelled, to keep the frames recorded so far)
+    while (!sink.failed() && reader.num_pending() > 0) {
+        if (!retrieve_frame())
+            success = false;
+    }
     // clean
+    reader.release();
     delete fbo;
+    delete resolve_fbo;
     // restore the clear color
     func_->glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
     doneCurrent();
 
+    // wait for the remaining frames to be encoded
+    if (!sink.finish()) {
+        success = false;
+        QMessageBox::critical(this, "Error", encoding_error);
+    }
     encoder.close();
 
     // enable updating the rendering
@@ -407,22 +512,25 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
     const int fw = w * dpi_scaling();
     const int fh = h * dpi_scaling();
     const auto &frames = kfi->interpolate();
+
+    // The frames are independent images, so they are encoded and saved by all available worker threads.
+    const QString ext_less_name = file_name.left(file_name.lastIndexOf('.'));
+    FrameSink sink(FrameSink::image_sequence((ext_less_name + ".png").toStdString()), 0, 8);
+
     makeCurrent();
 
-#ifdef USE_QT_FBO
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setSamples(samples());
-    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(fw, fh, format);
-    fbo->addColorAttachment(fw, fh);
-#else
-    FramebufferObject* fbo = new FramebufferObject(fw, fh, samples());
-    fbo->add_color_buffer();
-    fbo->add_depth_buffer();
-#endif
+    details::FBO *fbo = details::create_fbo(fw, fh, samples());
+    details::FBO *resolve_fbo = details::create_resolve_fbo(fw, fh, samples());
+
+    // the pixels of a frame are retrieved after the next frame has been rendered
+    AsyncPixelReader reader;
+    std::size_t next_frame = 0;
+    auto retrieve_frame = [&]() -> bool {
+        FrameSink::Frame frame = sink.new_frame(next_frame++, fw, fh, 4);
+        return reader.retrieve(frame.pixels, frame.width, frame.height) && sink.push(std::move(frame));
+    };
 
     bool success = true;
-    const QString ext_less_name = file_name.left(file_name.lastIndexOf('.'));
 #ifdef SHOW_PROGRESS
     ProgressLogger progress(frames.size(), true, false);
 #endif
@@ -457,21 +565,8 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
 
         //---------------------------------------------------------------------------
 
-#ifdef USE_QT_FBO
-        const QImage image = fbo->toImage();
-        if (image.isNull()) {
-            QMessageBox::critical(this, "Error", "Failed to grab the framebuffer!");
-            success = false;
-            break;
-        }
-#else
-        QImage image(fw, fh, QImage::Format_RGBA8888);
-        fbo->read_color(0, const_cast<unsigned char*>(image.constBits()), GL_RGBA);
-#endif
-
-        const QString full_name = ext_less_name + QString("-%1.png").arg(frame_index, 4, 10, QChar('0'));
-        if (!image.save(full_name)) {
-            QMessageBox::critical(this, "Error", QString("failed to save the %1-th frame").arg(frame_index));
+        if ((reader.is_full() && !retrieve_frame()) ||
+            !details::request_pixels(reader, fbo, resolve_fbo, fw, fh, GL_RGBA)) {
             success = false;
             break;
         }
@@ -483,12 +578,25 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
 
     // this very important (the progress bar may interfere the framebuffer)
     makeCurrent();
+    // retrieve the remaining frames
+    while (!sink.failed() && reader.num_pending() > 0) {
+        if (!retrieve_frame())
+            success = false;
+    }
     // clean
+    reader.release();
     delete fbo;
+    delete resolve_fbo;
     // restore the clear color
     func_->glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
     doneCurrent();
 
+    // wait for the remaining frames to be saved
+    if (!sink.finish()) {
+        QMessageBox::critical(this, "Error", QString("failed to save the %1-th frame").arg(sink.num_consumed()));
+        success = false;
+    }
+
     // enable updating the rendering
     easy3d::connect(&camera_->frame_modified, this, static_cast<void (PaintCanvas::*)(void)>(&PaintCanvas::update));
 
@@ -381,6 +381,8 @@ namespace lines_details {
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_edge_property<unsigned int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
+            else if (model->template get_edge_property<unsigned short>(name))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_edge_property<int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_edge_property<unsigned char>(name))
@@ -398,6 +400,8 @@ namespace lines_details {
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<unsigned int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
+            else if (model->template get_vertex_property<unsigned short>(name))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<unsigned char>(name))
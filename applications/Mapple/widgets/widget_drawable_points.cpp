@@ -187,6 +187,8 @@ namespace points_details {
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<unsigned int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
+            else if (model->template get_vertex_property<unsigned short>(name))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<char>(name))
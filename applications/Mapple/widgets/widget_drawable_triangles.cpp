@@ -318,6 +318,8 @@ namespace triangles_details {
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_face_property<unsigned int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
+            else if (model->template get_face_property<unsigned short>(name))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_face_property<int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_face_property<char>(name))
@@ -336,6 +338,8 @@ namespace triangles_details {
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<unsigned int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
+            else if (model->template get_vertex_property<unsigned short>(name))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<int>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
             else if (model->template get_vertex_property<char>(name))
@@ -0,0 +1,145 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+#include "datasets.h"
+
+#include <memory>
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/attribute_packing.h>
+#include <easy3d/algo/triangle_order_optimizer.h>
+#include <easy3d/renderer/chunk_culler.h>
+
+
+using namespace easy3d;
+
+namespace bench {
+
+    namespace internal {
+
+        // the vertex indices of the triangles of a (triangle) mesh
+        std::vector<unsigned int> triangle_indices(const SurfaceMesh *mesh) {
+            std::vector<unsigned int> indices;
+            indices.reserve(mesh->n_faces() * 3);
+            for (auto f : mesh->faces()) {
+                for (auto v : mesh->vertices(f))
+                    indices.push_back(v.idx());
+            }
+            return indices;
+        }
+
+    }
+
+
+    // The CPU-side stages of preparing the vertex/element buffers of the drawables. buffers::update() itself needs
+    // an OpenGL context, so the stages are timed separately on the data they would get.
+    void register_buffer_benchmarks(Suite &suite) {
+        suite.add("buffers/surface_mesh/gather", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            mesh->update_vertex_normals();
+            auto points = mesh->get_vertex_property<vec3>("v:point");
+            auto normals = mesh->get_vertex_property<vec3>("v:normal");
+            std::vector<vec3> d_points, d_normals;
+            context.set_elements(mesh->n_faces());
+            context.measure([&]() {
+                // the corners of the triangles, as for the per-face and per-halfedge attributes
+                d_points.clear();
+                d_normals.clear();
+                d_points.reserve(mesh->n_faces() * 3);
+                d_normals.reserve(mesh->n_faces() * 3);
+                for (auto f : mesh->faces()) {
+                    for (auto h : mesh->halfedges(f)) {
+                        const auto v = mesh->target(h);
+                        d_points.push_back(points[v]);
+                        d_normals.push_back(normals[v]);
+                    }
+                }
+                consume(d_points.back().x);
+            });
+        });
+
+        suite.add("buffers/triangle_order", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            const auto indices = internal::triangle_indices(mesh.get());
+            const auto &points = mesh->get_vertex_property<vec3>("v:point").vector();
+            const std::vector<unsigned int> groups;
+            context.set_elements(mesh->n_faces());
+            context.measure([&]() {
+                const auto order = TriangleOrderOptimizer::optimize(indices, points, groups);
+                consume(order.size());
+            });
+        });
+
+        suite.add("buffers/chunk_partition", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            std::vector<vec3> centers;
+            centers.reserve(mesh->n_faces());
+            for (auto f : mesh->faces()) {
+                vec3 c(0.0f, 0.0f, 0.0f);
+                for (auto v : mesh->vertices(f))
+                    c += mesh->position(v);
+                centers.push_back(c / 3.0f);
+            }
+            std::vector<unsigned int> order;
+            context.set_elements(centers.size());
+            context.measure([&]() {
+                const auto offsets = ChunkCuller::partition(centers, 4096, order);
+                consume(offsets.size());
+            });
+        });
+
+        suite.add("buffers/pack/positions", [](Context &context) {
+            std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+            const auto &points = cloud->points();
+            Box3 box;
+            for (const auto &p : points)
+                box.grow(p);
+            std::vector<uint16_t> packed(points.size() * 4);
+            context.set_elements(points.size());
+            context.measure([&]() { packing::quantize_positions(points.data(), points.size(), box, packed.data()); });
+        });
+
+        suite.add("buffers/pack/normals", [](Context &context) {
+            std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+            const auto &normals = cloud->get_vertex_property<vec3>("v:normal").vector();
+            std::vector<uint32_t> packed(normals.size());
+            context.set_elements(normals.size());
+            context.measure([&]() { packing::pack_normals(normals.data(), normals.size(), packed.data()); });
+        });
+
+        suite.add("buffers/pack/colors", [](Context &context) {
+            std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+            const auto &colors = cloud->get_vertex_property<vec3>("v:color").vector();
+            std::vector<uint32_t> packed(colors.size());
+            context.set_elements(colors.size());
+            context.measure([&]() { packing::pack_colors(colors.data(), colors.size(), packed.data()); });
+        });
+    }
+
+}
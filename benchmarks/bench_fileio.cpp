@@ -0,0 +1,177 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+#include "datasets.h"
+
+#include <memory>
+#include <fstream>
+#include <iomanip>
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/fileio/surface_mesh_io.h>
+#include <easy3d/fileio/point_cloud_io.h>
+#include <easy3d/fileio/graph_io.h>
+#include <easy3d/fileio/poly_mesh_io.h>
+#include <easy3d/util/file_system.h>
+
+
+using namespace easy3d;
+
+namespace bench {
+
+    namespace internal {
+
+        // registers the saver and the loader of each format of a type of models
+        template<typename Model, typename IO>
+        void register_io(Suite &suite, const std::string &type, const std::vector<std::string> &formats,
+                         Model *(*make)(Scale), unsigned int (Model::*elements)() const) {
+            for (const auto &ext : formats) {
+                const std::string name = "fileio/" + type + "/" + ext;
+
+                suite.add(name + "/save", [=](Context &context) {
+                    std::unique_ptr<Model> model(make(context.scale()));
+                    const std::string file = scratch_directory() + "/" + type + "." + ext;
+                    bool success = true;
+                    context.set_elements(((*model).*elements)());
+                    context.measure([&]() { success = IO::save(file, model.get()) && success; });
+                    file_system::delete_file(file);
+                    if (!success)
+                        context.skip("failed saving the " + ext + " format");
+                });
+
+                suite.add(name + "/load", [=](Context &context) {
+                    std::unique_ptr<Model> model(make(context.scale()));
+                    const std::string file = scratch_directory() + "/" + type + "." + ext;
+                    if (!IO::save(file, model.get())) {
+                        file_system::delete_file(file);
+                        context.skip("failed saving the " + ext + " format");
+                        return;
+                    }
+                    bool success = true;
+                    context.set_elements(((*model).*elements)());
+                    context.measure([&]() {
+                        std::unique_ptr<Model> loaded(IO::load(file));
+                        success = loaded && success;
+                    });
+                    file_system::delete_file(file);
+                    if (!success)
+                        context.skip("failed loading the " + ext + " format");
+                });
+            }
+        }
+
+
+        // the trilist format can only be loaded: each line has the coordinates of the 3 points of a triangle
+        bool write_trilist(const std::string &file, const SurfaceMesh *mesh) {
+            std::ofstream output(file.c_str());
+            output << std::setprecision(9);
+            for (auto f : mesh->faces()) {
+                for (auto v : mesh->vertices(f))
+                    output << mesh->position(v) << " ";
+                output << "\n";
+            }
+            return !output.fail();
+        }
+
+
+        // the geojson format can only be loaded: each face is written as a 2D polygon feature (without repeating the
+        // first point at the end, which the loader would take as a duplicate vertex). A few faces perpendicular to the
+        // XY plane degenerate and are skipped by the loader.
+        bool write_geojson(const std::string &file, const SurfaceMesh *mesh) {
+            std::ofstream output(file.c_str());
+            output << std::fixed << std::setprecision(6);   // the loader reads floating-point numbers only
+            output << "{\"type\": \"FeatureCollection\", \"features\": [\n";
+            bool first = true;
+            for (auto f : mesh->faces()) {
+                output << (first ? "" : ",\n")
+                       << "{\"type\": \"Feature\", \"geometry\": {\"type\": \"Polygon\", \"coordinates\": [[";
+                bool first_point = true;
+                for (auto v : mesh->vertices(f)) {
+                    const vec3 &p = mesh->position(v);
+                    output << (first_point ? "" : ", ") << "[" << p.x << ", " << p.y << "]";
+                    first_point = false;
+                }
+                output << "]]}}";
+                first = false;
+            }
+            output << "\n]}\n";
+            return !output.fail();
+        }
+
+
+        // registers the loader of a surface mesh format that cannot be saved, the file is written by \p write
+        void register_load_only(Suite &suite, const std::string &ext,
+                                bool (*write)(const std::string &, const SurfaceMesh *)) {
+            suite.add("fileio/surface_mesh/" + ext + "/load", [=](Context &context) {
+                std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+                const std::string file = scratch_directory() + "/surface_mesh." + ext;
+                if (!write(file, mesh.get())) {
+                    file_system::delete_file(file);
+                    context.skip("failed writing the " + ext + " format");
+                    return;
+                }
+                bool success = true;
+                context.set_elements(mesh->n_faces());
+                context.measure([&]() {
+                    std::unique_ptr<SurfaceMesh> loaded(SurfaceMeshIO::load(file));
+                    success = loaded && success;
+                });
+                file_system::delete_file(file);
+                if (!success)
+                    context.skip("failed loading the " + ext + " format");
+            });
+        }
+
+    }
+
+
+    void register_fileio_benchmarks(Suite &suite) {
+        internal::register_io<SurfaceMesh, SurfaceMeshIO>(
+                suite, "surface_mesh", {"ply", "sm", "csm", "obj", "off", "stl"},
+                make_surface_mesh, &SurfaceMesh::n_faces);
+        internal::register_load_only(suite, "trilist", internal::write_trilist);
+        internal::register_load_only(suite, "geojson", internal::write_geojson);
+        internal::register_io<PointCloud, PointCloudIO>(
+                suite, "point_cloud", {"ply", "bin", "cbin", "xyz", "bxyz", "vg", "bvg"},
+                make_point_cloud, &PointCloud::n_vertices);
+        internal::register_io<PointCloud, PointCloudIO>(
+                suite, "point_cloud", {"las", "laz"},
+                make_lidar_point_cloud, &PointCloud::n_vertices);
+        // ply is the only format for graphs
+        internal::register_io<Graph, GraphIO>(
+                suite, "graph", {"ply"},
+                make_graph, &Graph::n_edges);
+        internal::register_io<PolyMesh, PolyMeshIO>(
+                suite, "poly_mesh", {"plm", "pm", "mesh"},
+                make_poly_mesh, &PolyMesh::n_cells);
+    }
+
+}
@@ -0,0 +1,131 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+#include "datasets.h"
+
+#include <memory>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/kdtree/kdtree_search_ann.h>
+#include <easy3d/kdtree/kdtree_search_eth.h>
+#include <easy3d/kdtree/kdtree_search_flann.h>
+#include <easy3d/kdtree/kdtree_search_nanoflann.h>
+
+
+using namespace easy3d;
+
+namespace bench {
+
+    namespace internal {
+
+        // the number of queries of the query benchmarks
+        const std::size_t num_queries = 100000;
+
+        template<typename KdTree>
+        void register_kdtree(Suite &suite, const std::string &backend) {
+            suite.add("kdtree/" + backend + "/build", [](Context &context) {
+                std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+                context.set_elements(cloud->n_vertices());
+                context.measure([&]() {
+                    KdTree tree;
+                    tree.begin();
+                    tree.add_point_cloud(cloud.get());
+                    tree.end();
+                });
+            });
+
+            suite.add("kdtree/" + backend + "/closest_point", [](Context &context) {
+                std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+                KdTree tree;
+                tree.begin();
+                tree.add_point_cloud(cloud.get());
+                tree.end();
+                const auto queries = make_queries(cloud->points(), num_queries);
+                context.set_elements(queries.size());
+                context.measure([&]() {
+                    int sum = 0;
+                    for (const auto &q : queries)
+                        sum += tree.find_closest_point(q);
+                    consume(sum);
+                });
+            });
+
+            suite.add("kdtree/" + backend + "/k_nearest_16", [](Context &context) {
+                std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+                KdTree tree;
+                tree.begin();
+                tree.add_point_cloud(cloud.get());
+                tree.end();
+                const auto queries = make_queries(cloud->points(), num_queries);
+                context.set_elements(queries.size());
+                context.measure([&]() {
+                    std::vector<int> neighbors;
+                    std::size_t sum = 0;
+                    for (const auto &q : queries) {
+                        tree.find_closest_k_points(q, 16, neighbors);
+                        sum += neighbors.size();
+                    }
+                    consume(static_cast<double>(sum));
+                });
+            });
+
+            suite.add("kdtree/" + backend + "/range", [](Context &context) {
+                std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+                KdTree tree;
+                tree.begin();
+                tree.add_point_cloud(cloud.get());
+                tree.end();
+                // query at the points themselves (not in the empty space), with a radius giving ~16 neighbors
+                std::vector<vec3> queries(num_queries);
+                for (std::size_t i = 0; i < queries.size(); ++i)
+                    queries[i] = cloud->points()[i % cloud->n_vertices()];
+                const float radius = context.pick(0.16f, 0.05f, 0.016f);
+                context.set_elements(queries.size());
+                context.measure([&]() {
+                    std::vector<int> neighbors;
+                    std::size_t sum = 0;
+                    for (const auto &q : queries) {
+                        tree.find_points_in_range(q, radius * radius, neighbors);
+                        sum += neighbors.size();
+                    }
+                    consume(static_cast<double>(sum));
+                });
+            });
+        }
+
+    }
+
+
+    void register_kdtree_benchmarks(Suite &suite) {
+        internal::register_kdtree<KdTreeSearch_ANN>(suite, "ann");
+        internal::register_kdtree<KdTreeSearch_ETH>(suite, "eth");
+        internal::register_kdtree<KdTreeSearch_FLANN>(suite, "flann");
+        internal::register_kdtree<KdTreeSearch_NanoFLANN>(suite, "nanoflann");
+    }
+
+}
@@ -0,0 +1,74 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+#include "datasets.h"
+
+#include <memory>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/algo/point_cloud_normals.h>
+#include <easy3d/algo/point_cloud_poisson_reconstruction.h>
+#include <easy3d/algo/point_cloud_ransac.h>
+
+
+using namespace easy3d;
+
+namespace bench {
+
+    void register_point_cloud_benchmarks(Suite &suite) {
+        suite.add("point_cloud/normals/estimate", [](Context &context) {
+            std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+            context.set_elements(cloud->n_vertices());
+            context.measure([&]() { PointCloudNormals().estimate(cloud.get(), 16); });
+        });
+
+        suite.add("point_cloud/poisson_reconstruction", [](Context &context) {
+            std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+            PoissonReconstruction poisson;
+            poisson.set_depth(context.pick(7, 8, 9));
+            context.set_elements(cloud->n_vertices());
+            context.measure([&]() {
+                std::unique_ptr<SurfaceMesh> mesh(poisson.apply(cloud.get()));
+                consume(mesh ? static_cast<double>(mesh->n_faces()) : 0.0);
+            });
+        }, MEDIUM);
+
+        suite.add("point_cloud/ransac", [](Context &context) {
+            std::unique_ptr<PointCloud> cloud(make_point_cloud(context.scale()));
+            PrimitivesRansac ransac;
+            ransac.add_primitive_type(PrimitivesRansac::PLANE);
+            ransac.add_primitive_type(PrimitivesRansac::SPHERE);
+            ransac.add_primitive_type(PrimitivesRansac::CYLINDER);
+            const auto min_support = static_cast<unsigned int>(cloud->n_vertices() / 50);
+            context.set_elements(cloud->n_vertices());
+            context.measure([&]() { consume(ransac.detect(cloud.get(), min_support)); });
+        }, MEDIUM);
+    }
+
+}
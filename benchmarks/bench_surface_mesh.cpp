@@ -0,0 +1,130 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+#include "datasets.h"
+
+#include <memory>
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/algo/surface_mesh_simplification.h>
+#include <easy3d/algo/surface_mesh_remeshing.h>
+#include <easy3d/algo/surface_mesh_smoothing.h>
+
+
+using namespace easy3d;
+
+namespace bench {
+
+    void register_surface_mesh_benchmarks(Suite &suite) {
+        suite.add("surface_mesh/traversal/one_rings", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            auto points = mesh->get_vertex_property<vec3>("v:point");
+            context.set_elements(mesh->n_vertices());
+            context.measure([&]() {
+                vec3 sum(0.0f, 0.0f, 0.0f);
+                for (auto v : mesh->vertices()) {
+                    for (auto u : mesh->vertices(v))
+                        sum += points[u];
+                }
+                consume(sum.x);
+            });
+        });
+
+        suite.add("surface_mesh/traversal/face_vertices", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            auto points = mesh->get_vertex_property<vec3>("v:point");
+            context.set_elements(mesh->n_faces());
+            context.measure([&]() {
+                vec3 sum(0.0f, 0.0f, 0.0f);
+                for (auto f : mesh->faces()) {
+                    for (auto v : mesh->vertices(f))
+                        sum += points[v];
+                }
+                consume(sum.x);
+            });
+        });
+
+        suite.add("surface_mesh/normals/faces", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            context.set_elements(mesh->n_faces());
+            context.measure([&]() { mesh->update_face_normals(); });
+        });
+
+        suite.add("surface_mesh/normals/vertices", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> mesh(make_surface_mesh(context.scale()));
+            context.set_elements(mesh->n_vertices());
+            context.measure([&]() { mesh->update_vertex_normals(); });
+        });
+
+        // the algorithms below modify the mesh, so each repetition starts from a copy of the input
+
+        suite.add("surface_mesh/simplification", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> input(make_surface_mesh(context.scale()));
+            SurfaceMesh mesh;
+            context.set_elements(input->n_vertices());
+            context.measure([&]() {
+                SurfaceMeshSimplification simplifier(&mesh);
+                simplifier.initialize(10.0f, 0.0f, 0.0f, 180.0f, 0.0f);
+                simplifier.simplify(static_cast<unsigned int>(input->n_vertices() / 10));
+            }, [&]() { mesh = *input; });
+        }, MEDIUM);
+
+        suite.add("surface_mesh/remeshing/uniform", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> input(make_surface_mesh(context.scale()));
+            float length = 0.0f;
+            for (auto e : input->edges())
+                length += input->edge_length(e);
+            length /= static_cast<float>(input->n_edges());
+
+            SurfaceMesh mesh;
+            context.set_elements(input->n_vertices());
+            context.measure([&]() {
+                SurfaceMeshRemeshing(&mesh).uniform_remeshing(length, 3);
+            }, [&]() { mesh = *input; });
+        }, MEDIUM);
+
+        suite.add("surface_mesh/smoothing/explicit", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> input(make_surface_mesh(context.scale()));
+            SurfaceMesh mesh;
+            context.set_elements(input->n_vertices());
+            context.measure([&]() {
+                SurfaceMeshSmoothing(&mesh).explicit_smoothing(10, false);
+            }, [&]() { mesh = *input; });
+        }, MEDIUM);
+
+        suite.add("surface_mesh/smoothing/implicit", [](Context &context) {
+            std::unique_ptr<SurfaceMesh> input(make_surface_mesh(context.scale()));
+            SurfaceMesh mesh;
+            context.set_elements(input->n_vertices());
+            context.measure([&]() {
+                SurfaceMeshSmoothing(&mesh).implicit_smoothing(0.001f, false, true);
+            }, [&]() { mesh = *input; });
+        }, MEDIUM);
+    }
+
+}
@@ -0,0 +1,286 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+
+#include <map>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <exception>
+
+#include <easy3d/util/memory.h>
+
+#include <3rd_party/json/json.hpp>
+
+
+using json = nlohmann::json;
+
+
+namespace bench {
+
+    const char *scale_name(Scale scale) {
+        switch (scale) {
+            case SMALL:
+                return "small";
+            case MEDIUM:
+                return "medium";
+            default:
+                return "large";
+        }
+    }
+
+
+    namespace internal {
+        volatile double sink = 0.0;
+    }
+
+
+    void consume(double value) {
+        internal::sink = internal::sink + value;
+    }
+
+
+    void Context::measure(const std::function<void()> &body, const std::function<void()> &setup) {
+        std::vector<double> times;
+        std::size_t peak = 0;
+        for (int i = 0; i < repetitions_; ++i) {
+            if (setup)
+                setup();
+            easy3d::memory::PeakScope scope;
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            const auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            peak = std::max(peak, scope.peak());
+        }
+        if (times.empty())
+            return;
+
+        result_.repetitions = static_cast<int>(times.size());
+        result_.peak_bytes = peak;
+        double sum = 0.0;
+        for (auto t : times)
+            sum += t;
+        result_.mean_ms = sum / static_cast<double>(times.size());
+        std::sort(times.begin(), times.end());
+        result_.min_ms = times.front();
+        const std::size_t mid = times.size() / 2;
+        result_.median_ms = (times.size() % 2) ? times[mid] : 0.5 * (times[mid - 1] + times[mid]);
+    }
+
+
+    namespace internal {
+
+        std::string throughput(const Result &r) {
+            if (r.elements == 0 || r.median_ms <= 0.0)
+                return "-";
+            const double per_second = static_cast<double>(r.elements) / (r.median_ms * 0.001);
+            std::ostringstream s;
+            s << std::fixed << std::setprecision(1);
+            if (per_second >= 1e6)
+                s << per_second * 1e-6 << " M/s";
+            else if (per_second >= 1e3)
+                s << per_second * 1e-3 << " K/s";
+            else
+                s << per_second << " /s";
+            return s.str();
+        }
+
+        void print(const Result &r) {
+            std::cout << std::left << std::setw(44) << r.name << std::setw(8) << r.scale << std::right
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(12) << r.median_ms << " ms"
+                      << std::setw(12) << r.min_ms << " ms"
+                      << std::setw(14) << throughput(r);
+            if (r.peak_bytes > 0)
+                std::cout << "    peak " << easy3d::memory::to_string(r.peak_bytes);
+            std::cout << std::endl;
+        }
+
+        std::string &scratch_directory() {
+            static std::string dir = ".";
+            return dir;
+        }
+
+    }
+
+
+    std::vector<Result> Suite::run(const std::vector<Scale> &scales, int repetitions, const std::string &filter) const {
+        std::cout << std::left << std::setw(44) << "benchmark" << std::setw(8) << "scale" << std::right
+                  << std::setw(15) << "median" << std::setw(15) << "min" << std::setw(14) << "throughput"
+                  << std::endl;
+
+        std::vector<Result> results;
+        for (auto scale : scales) {
+            for (const auto &b : benchmarks_) {
+                if (scale > b.max_scale || (!filter.empty() && b.name.find(filter) == std::string::npos))
+                    continue;
+
+                Context context(scale, repetitions);
+                try {
+                    b.function(context);
+                }
+                catch (const std::exception &e) {
+                    context.skip(e.what());
+                }
+
+                if (!context.skipped().empty()) {
+                    std::cout << std::left << std::setw(44) << b.name << std::setw(8) << scale_name(scale)
+                              << "skipped: " << context.skipped() << std::endl;
+                    continue;
+                }
+                if (context.result().repetitions == 0)
+                    continue;
+
+                Result r = context.result();
+                r.name = b.name;
+                r.scale = scale_name(scale);
+                internal::print(r);
+                results.push_back(r);
+            }
+        }
+        return results;
+    }
+
+
+    bool save_results(const std::string &file_name, const std::vector<Result> &results) {
+        std::ofstream output(file_name.c_str());
+        if (output.fail()) {
+            std::cerr << "could not open file: " << file_name << std::endl;
+            return false;
+        }
+
+        json report;
+#ifdef EASY3D_VERSION
+        report["easy3d_version"] = EASY3D_VERSION;
+#endif
+        report["allocation_counter"] = easy3d::memory::allocation_counter_enabled();
+        report["results"] = json::array();
+        for (const auto &r : results) {
+            report["results"].push_back({
+                    {"name",        r.name},
+                    {"scale",       r.scale},
+                    {"elements",    r.elements},
+                    {"repetitions", r.repetitions},
+                    {"min_ms",      r.min_ms},
+                    {"median_ms",   r.median_ms},
+                    {"mean_ms",     r.mean_ms},
+                    {"peak_bytes",  r.peak_bytes}
+            });
+        }
+        output << report.dump(2) << std::endl;
+        return !output.fail();
+    }
+
+
+    bool load_results(const std::string &file_name, std::vector<Result> &results) {
+        std::ifstream input(file_name.c_str());
+        if (input.fail()) {
+            std::cerr << "could not open file: " << file_name << std::endl;
+            return false;
+        }
+
+        try {
+            json report;
+            input >> report;
+            for (const auto &entry : report.at("results")) {
+                Result r;
+                r.name = entry.at("name").get<std::string>();
+                r.scale = entry.at("scale").get<std::string>();
+                r.elements = entry.value("elements", std::size_t(0));
+                r.repetitions = entry.value("repetitions", 0);
+                r.min_ms = entry.value("min_ms", 0.0);
+                r.median_ms = entry.value("median_ms", 0.0);
+                r.mean_ms = entry.value("mean_ms", 0.0);
+                r.peak_bytes = entry.value("peak_bytes", std::size_t(0));
+                results.push_back(r);
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "could not read results from file: " << file_name << " (" << e.what() << ")" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+
+    std::size_t compare(const std::vector<Result> &baseline, const std::vector<Result> &results, double tolerance) {
+        // differences below this are considered as noise, whatever the ratio is
+        const double noise_ms = 0.05;
+
+        std::map<std::string, const Result *> previous;
+        for (const auto &r : baseline)
+            previous[r.name + "@" + r.scale] = &r;
+
+        std::cout << std::endl << std::left << std::setw(44) << "benchmark" << std::setw(8) << "scale" << std::right
+                  << std::setw(15) << "baseline" << std::setw(15) << "current" << std::setw(10) << "change"
+                  << std::endl;
+
+        std::size_t regressions = 0;
+        for (const auto &r : results) {
+            auto pos = previous.find(r.name + "@" + r.scale);
+            std::cout << std::left << std::setw(44) << r.name << std::setw(8) << r.scale << std::right
+                      << std::fixed << std::setprecision(3);
+            if (pos == previous.end()) {
+                std::cout << std::setw(15) << "-" << std::setw(12) << r.median_ms << " ms" << "    (new)" << std::endl;
+                continue;
+            }
+
+            const double before = pos->second->median_ms;
+            const double change = before > 0.0 ? (r.median_ms - before) / before : 0.0;
+            std::cout << std::setw(12) << before << " ms" << std::setw(12) << r.median_ms << " ms"
+                      << std::setw(9) << std::setprecision(1) << std::showpos << change * 100.0 << "%"
+                      << std::noshowpos;
+            if (change > tolerance && r.median_ms - before > noise_ms) {
+                std::cout << "    REGRESSION";
+                ++regressions;
+            }
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl << regressions << " regression(s) (tolerance " << tolerance * 100.0 << "%)"
+                  << std::endl;
+        return regressions;
+    }
+
+
+    void set_scratch_directory(const std::string &dir) {
+        internal::scratch_directory() = dir;
+    }
+
+
+    const std::string &scratch_directory() {
+        return internal::scratch_directory();
+    }
+
+}
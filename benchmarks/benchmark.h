@@ -0,0 +1,163 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_BENCHMARKS_BENCHMARK_H
+#define EASY3D_BENCHMARKS_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+
+/**
+ * \brief A minimal harness for the Easy3D benchmarks.
+ * \details A benchmark is a function that prepares its (synthetic) input at a given scale and then times a body
+ *      with Context::measure(). Only the body is timed. The results can be written to a JSON file and compared
+ *      with a baseline written by a previous run, e.g.,
+ *      \code
+ *          ./benchmarks --output=before.json
+ *          ... change the code ...
+ *          ./benchmarks --baseline=before.json --tolerance=0.1
+ *      \endcode
+ *      The benchmarks run headless (no OpenGL context is created) and do not access the network.
+ */
+namespace bench {
+
+    /// The scales of the synthetic datasets.
+    enum Scale { SMALL = 0, MEDIUM = 1, LARGE = 2 };
+
+    /// Returns the name of a scale, i.e., "small", "medium", or "large".
+    const char *scale_name(Scale scale);
+
+    /// The timings of a benchmark at a scale.
+    struct Result {
+        std::string name;
+        std::string scale;
+        std::size_t elements = 0;    // the number of elements processed by one repetition
+        int repetitions = 0;
+        double min_ms = 0.0;
+        double median_ms = 0.0;
+        double mean_ms = 0.0;
+        std::size_t peak_bytes = 0;  // the peak heap usage (requires EASY3D_ENABLE_ALLOCATION_COUNTER)
+    };
+
+    /// Consumes a value computed by a benchmark, such that the compiler cannot optimize the computation away.
+    void consume(double value);
+
+    /// The context in which a benchmark runs.
+    class Context {
+    public:
+        Context(Scale scale, int repetitions) : scale_(scale), repetitions_(repetitions) {}
+
+        /// The scale of the input to prepare.
+        Scale scale() const { return scale_; }
+
+        /// Picks a value according to the scale.
+        template<typename T>
+        T pick(const T &small, const T &medium, const T &large) const {
+            return scale_ == SMALL ? small : (scale_ == MEDIUM ? medium : large);
+        }
+
+        /// Sets the number of elements processed by one repetition (used to report the throughput).
+        void set_elements(std::size_t n) { result_.elements = n; }
+
+        /**
+         * \brief Times \p body for all the repetitions.
+         * \param body The code to time.
+         * \param setup If provided, it is called (untimed) before each repetition, e.g., to restore an input that is
+         *      modified by \p body.
+         */
+        void measure(const std::function<void()> &body, const std::function<void()> &setup = nullptr);
+
+        /// Marks the benchmark as skipped, e.g., if the input could not be prepared.
+        void skip(const std::string &reason) { skipped_ = reason; }
+
+        const Result &result() const { return result_; }
+        const std::string &skipped() const { return skipped_; }
+
+    private:
+        Scale scale_;
+        int repetitions_;
+        Result result_;
+        std::string skipped_;
+    };
+
+    /// A registered benchmark.
+    struct Benchmark {
+        std::string name;
+        std::function<void(Context &)> function;
+        Scale max_scale;    // the benchmark is not run at larger scales (e.g., the expensive algorithms)
+    };
+
+    /// The collection of all the benchmarks.
+    class Suite {
+    public:
+        /// Registers a benchmark.
+        void add(const std::string &name, const std::function<void(Context &)> &function, Scale max_scale = LARGE) {
+            benchmarks_.push_back({name, function, max_scale});
+        }
+
+        const std::vector<Benchmark> &benchmarks() const { return benchmarks_; }
+
+        /**
+         * \brief Runs the benchmarks whose names contain \p filter at each of the \p scales.
+         * \details The results are printed as they come and also returned.
+         */
+        std::vector<Result> run(const std::vector<Scale> &scales, int repetitions, const std::string &filter) const;
+
+    private:
+        std::vector<Benchmark> benchmarks_;
+    };
+
+    /// Writes the results to a JSON file (one result per line). Returns false if the file cannot be written.
+    bool save_results(const std::string &file_name, const std::vector<Result> &results);
+
+    /// Reads the results from a JSON file written by save_results(). Returns false if the file cannot be read.
+    bool load_results(const std::string &file_name, std::vector<Result> &results);
+
+    /**
+     * \brief Compares the results with a baseline and prints the differences of the median times.
+     * \param tolerance A benchmark regresses if it is slower than the baseline by more than this fraction.
+     * \return The number of regressions.
+     */
+    std::size_t compare(const std::vector<Result> &baseline, const std::vector<Result> &results, double tolerance);
+
+    /// Sets the directory for the files written by the benchmarks (e.g., by the savers).
+    void set_scratch_directory(const std::string &dir);
+    /// Returns the directory for the files written by the benchmarks.
+    const std::string &scratch_directory();
+
+    // the benchmarks of each module (see the corresponding bench_*.cpp)
+    void register_surface_mesh_benchmarks(Suite &suite);
+    void register_point_cloud_benchmarks(Suite &suite);
+    void register_kdtree_benchmarks(Suite &suite);
+    void register_fileio_benchmarks(Suite &suite);
+    void register_buffer_benchmarks(Suite &suite);
+
+}
+
+#endif  // EASY3D_BENCHMARKS_BENCHMARK_H
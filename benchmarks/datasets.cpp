@@ -0,0 +1,207 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "datasets.h"
+
+#include <cmath>
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/algo/surface_mesh_factory.h>
+
+
+using namespace easy3d;
+
+namespace bench {
+
+    Random::Random(uint32_t seed) : state_(seed ? seed : 1u) {
+    }
+
+
+    float Random::next() {
+        // xorshift32: unlike the distributions of <random>, it gives the same sequence on all platforms
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return static_cast<float>(state_ >> 8) * (1.0f / 16777216.0f);
+    }
+
+
+    SurfaceMesh *make_surface_mesh(Scale scale) {
+        const std::size_t subdivisions[] = {5, 6, 7};
+        auto mesh = new SurfaceMesh(SurfaceMeshFactory::icosphere(subdivisions[scale]));
+
+        Random random(1);
+        auto points = mesh->get_vertex_property<vec3>("v:point");
+        for (auto v : mesh->vertices())
+            points[v] *= 1.0f + random.next(-0.01f, 0.01f);
+        return mesh;
+    }
+
+
+    PointCloud *make_point_cloud(Scale scale) {
+        const std::size_t sizes[] = {10000, 100000, 1000000};
+        const std::size_t num = sizes[scale];
+        const float two_pi = static_cast<float>(2.0 * M_PI);
+        const float noise = 0.002f;
+
+        auto cloud = new PointCloud;
+        auto normals = cloud->add_vertex_property<vec3>("v:normal");
+        auto colors = cloud->add_vertex_property<vec3>("v:color");
+        // the planes of the box, labeled as in PrimitivesRansac (the vg format supports only planes)
+        auto types = cloud->add_vertex_property<int>("v:primitive_type");
+        auto indices = cloud->add_vertex_property<int>("v:primitive_index");
+
+        Random random(2);
+        for (std::size_t i = 0; i < num; ++i) {
+            vec3 p, n, c;
+            int type = -1, index = -1;
+            if (i < num / 2) {          // the box [-1, 1]^3
+                const int face = std::min(static_cast<int>(random.next() * 6.0f), 5);
+                const int axis = face / 2;
+                const float side = (face % 2) ? 1.0f : -1.0f;
+                p = vec3(random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f));
+                p[axis] = side;
+                n = vec3(0.0f, 0.0f, 0.0f);
+                n[axis] = side;
+                c = vec3(0.8f, 0.3f, 0.3f);
+                type = 0;
+                index = face;
+            } else if (i < num * 3 / 4) { // the sphere centered at (3, 0, 0) with radius 1
+                const float z = random.next(-1.0f, 1.0f);
+                const float phi = random.next(0.0f, two_pi);
+                const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+                n = vec3(r * std::cos(phi), r * std::sin(phi), z);
+                p = vec3(3.0f, 0.0f, 0.0f) + n;
+                c = vec3(0.3f, 0.8f, 0.3f);
+            } else {                    // the cylinder along z centered at (-3, 0, 0) with radius 0.5
+                const float phi = random.next(0.0f, two_pi);
+                n = vec3(std::cos(phi), std::sin(phi), 0.0f);
+                p = vec3(-3.0f, 0.0f, random.next(-1.0f, 1.0f)) + n * 0.5f;
+                c = vec3(0.3f, 0.3f, 0.8f);
+            }
+            auto v = cloud->add_vertex(p + n * random.next(-noise, noise));
+            normals[v] = n;
+            colors[v] = c * random.next(0.8f, 1.0f);
+            types[v] = type;
+            indices[v] = index;
+        }
+        return cloud;
+    }
+
+
+    PointCloud *make_lidar_point_cloud(Scale scale) {
+        auto cloud = make_point_cloud(scale);
+        cloud->remove_vertex_property("v:normal");
+        return cloud;
+    }
+
+
+    Graph *make_graph(Scale scale) {
+        const int sizes[] = {100, 316, 1000};
+        const int n = sizes[scale];
+
+        auto graph = new Graph;
+        std::vector<Graph::Vertex> vertices;
+        vertices.reserve(static_cast<std::size_t>(n) * n);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i)
+                vertices.push_back(graph->add_vertex(vec3(static_cast<float>(i), static_cast<float>(j), 0.0f)));
+        }
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                const auto v = vertices[j * n + i];
+                if (i + 1 < n)
+                    graph->add_edge(v, vertices[j * n + i + 1]);
+                if (j + 1 < n)
+                    graph->add_edge(v, vertices[(j + 1) * n + i]);
+            }
+        }
+        return graph;
+    }
+
+
+    PolyMesh *make_poly_mesh(Scale scale) {
+        const int sizes[] = {8, 16, 32};
+        const int n = sizes[scale];
+        const int m = n + 1;    // the number of vertices along each axis
+
+        auto mesh = new PolyMesh;
+        std::vector<PolyMesh::Vertex> vertices;
+        vertices.reserve(static_cast<std::size_t>(m) * m * m);
+        for (int k = 0; k < m; ++k) {
+            for (int j = 0; j < m; ++j) {
+                for (int i = 0; i < m; ++i)
+                    vertices.push_back(mesh->add_vertex(vec3(static_cast<float>(i), static_cast<float>(j),
+                                                             static_cast<float>(k))));
+            }
+        }
+
+        // each cube is split into 6 tetrahedra along its diagonal (Kuhn's subdivision, which is consistent across
+        // neighboring cubes), one for each order of the axes in which the diagonal is walked
+        const int orders[6][3] = {{0, 1, 2}, {1, 2, 0}, {2, 0, 1}, {0, 2, 1}, {2, 1, 0}, {1, 0, 2}};
+        for (int k = 0; k < n; ++k) {
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    for (int t = 0; t < 6; ++t) {
+                        int corner[3] = {i, j, k};
+                        PolyMesh::Vertex v[4];
+                        v[0] = vertices[(corner[2] * m + corner[1]) * m + corner[0]];
+                        for (int s = 0; s < 3; ++s) {
+                            ++corner[orders[t][s]];
+                            v[s + 1] = vertices[(corner[2] * m + corner[1]) * m + corner[0]];
+                        }
+                        // the last three orders are odd permutations: swap two vertices for a positive orientation
+                        if (t < 3)
+                            mesh->add_tetra(v[0], v[1], v[2], v[3]);
+                        else
+                            mesh->add_tetra(v[0], v[1], v[3], v[2]);
+                    }
+                }
+            }
+        }
+        return mesh;
+    }
+
+
+    std::vector<vec3> make_queries(const std::vector<vec3> &points, std::size_t num) {
+        Box3 box;
+        for (const auto &p : points)
+            box.grow(p);
+
+        Random random(3);
+        std::vector<vec3> queries(num);
+        for (auto &q : queries) {
+            for (int i = 0; i < 3; ++i)
+                q[i] = random.next(box.min_coord(i), box.max_coord(i));
+        }
+        return queries;
+    }
+
+}
@@ -0,0 +1,88 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_BENCHMARKS_DATASETS_H
+#define EASY3D_BENCHMARKS_DATASETS_H
+
+#include <vector>
+#include <cstdint>
+
+#include <easy3d/core/types.h>
+
+#include "benchmark.h"
+
+
+namespace easy3d {
+    class SurfaceMesh;
+    class PointCloud;
+    class Graph;
+    class PolyMesh;
+}
+
+
+/**
+ * \brief The synthetic datasets of the benchmarks.
+ * \details All datasets are generated from a fixed seed with a portable random generator, so they are identical
+ *      across runs and platforms, and the benchmarks do not depend on any data file.
+ */
+namespace bench {
+
+    /// A deterministic random generator of floats in [0, 1).
+    class Random {
+    public:
+        explicit Random(uint32_t seed = 2021);
+        float next();
+        float next(float min_value, float max_value) { return min_value + next() * (max_value - min_value); }
+    private:
+        uint32_t state_;
+    };
+
+    /// A unit sphere with a little radial noise, triangulated by subdividing an icosahedron 5, 6, or 7 times (i.e.,
+    /// 10242, 40962, or 163842 vertices).
+    easy3d::SurfaceMesh *make_surface_mesh(Scale scale);
+
+    /// Points with normals and colors, sampled on the faces of a box, a sphere, and a cylinder (i.e., shapes that
+    /// can be detected by RANSAC). It has 10K, 100K, or 1M points. The points on the box are labeled by their planes in
+    /// "v:primitive_type" and "v:primitive_index", as required by the vg format.
+    easy3d::PointCloud *make_point_cloud(Scale scale);
+
+    /// The point cloud of make_point_cloud() without normals, as for the LiDAR formats (las/laz).
+    easy3d::PointCloud *make_lidar_point_cloud(Scale scale);
+
+    /// A 2D grid of vertices connected to their 4 neighbors, of 100x100, 316x316, or 1000x1000 vertices.
+    easy3d::Graph *make_graph(Scale scale);
+
+    /// A 3D grid of 8x8x8, 16x16x16, or 32x32x32 cubes, each split into 6 tetrahedra (i.e., 3072, 24576, or 196608
+    /// tetrahedra, which all the polyhedral mesh formats support).
+    easy3d::PolyMesh *make_poly_mesh(Scale scale);
+
+    /// Random points in the bounding box of a set of points.
+    std::vector<easy3d::vec3> make_queries(const std::vector<easy3d::vec3> &points, std::size_t num);
+
+}
+
+#endif  // EASY3D_BENCHMARKS_DATASETS_H
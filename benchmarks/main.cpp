@@ -0,0 +1,176 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include "benchmark.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+
+#include <easy3d/util/logging.h>
+#include <easy3d/util/file_system.h>
+
+
+using namespace bench;
+
+namespace {
+
+    void print_usage(const char *program) {
+        std::cout << "Usage: " << program << " [options]" << std::endl
+                  << "  --scales=<list>       comma separated scales among small, medium, large, or all "
+                     "(default: small,medium)" << std::endl
+                  << "  --repetitions=<n>     the number of timed repetitions of each benchmark (default: 5)"
+                  << std::endl
+                  << "  --filter=<text>       runs only the benchmarks whose names contain the text" << std::endl
+                  << "  --output=<file>       writes the results to a JSON file" << std::endl
+                  << "  --baseline=<file>     compares the results with a JSON file written by a previous run, "
+                     "and exits with 1 if any benchmark regressed" << std::endl
+                  << "  --tolerance=<ratio>   the slowdown tolerated by the comparison (default: 0.1, i.e., 10%)"
+                  << std::endl
+                  << "  --scratch=<dir>       the directory for the files written by the IO benchmarks "
+                     "(default: the current directory)" << std::endl
+                  << "  --list                lists the benchmarks" << std::endl;
+    }
+
+
+    // returns the value of an option in the form "--key=value"
+    bool option(const std::string &arg, const std::string &key, std::string &value) {
+        const std::string prefix = "--" + key + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+
+
+    bool parse_scales(const std::string &list, std::vector<Scale> &scales) {
+        scales.clear();
+        if (list == "all") {
+            scales = {SMALL, MEDIUM, LARGE};
+            return true;
+        }
+        std::size_t start = 0;
+        while (start <= list.size()) {
+            auto end = list.find(',', start);
+            if (end == std::string::npos)
+                end = list.size();
+            const std::string name = list.substr(start, end - start);
+            if (name == "small")
+                scales.push_back(SMALL);
+            else if (name == "medium")
+                scales.push_back(MEDIUM);
+            else if (name == "large")
+                scales.push_back(LARGE);
+            else {
+                std::cerr << "unknown scale: " << name << std::endl;
+                return false;
+            }
+            start = end + 1;
+        }
+        return !scales.empty();
+    }
+
+}
+
+
+int main(int argc, char **argv) {
+    // only warnings and errors: the loaders and the algorithms are quite verbose
+    easy3d::logging::initialize(false, true, true);
+
+    std::vector<Scale> scales = {SMALL, MEDIUM};
+    int repetitions = 5;
+    double tolerance = 0.1;
+    std::string filter, output, baseline, scratch = ".";
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string value;
+        if (option(arg, "scales", value)) {
+            if (!parse_scales(value, scales))
+                return EXIT_FAILURE;
+        } else if (option(arg, "repetitions", value))
+            repetitions = std::max(1, std::atoi(value.c_str()));
+        else if (option(arg, "filter", value))
+            filter = value;
+        else if (option(arg, "output", value))
+            output = value;
+        else if (option(arg, "baseline", value))
+            baseline = value;
+        else if (option(arg, "tolerance", value))
+            tolerance = std::atof(value.c_str());
+        else if (option(arg, "scratch", value))
+            scratch = value;
+        else if (arg == "--list")
+            list = true;
+        else {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+#ifndef NDEBUG
+    std::cerr << "warning: the benchmarks are built without NDEBUG, use the Release build type for meaningful timings"
+              << std::endl;
+#endif
+
+    Suite suite;
+    register_surface_mesh_benchmarks(suite);
+    register_point_cloud_benchmarks(suite);
+    register_kdtree_benchmarks(suite);
+    register_fileio_benchmarks(suite);
+    register_buffer_benchmarks(suite);
+
+    if (list) {
+        for (const auto &b : suite.benchmarks())
+            std::cout << b.name << " (up to " << scale_name(b.max_scale) << ")" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (!easy3d::file_system::is_directory(scratch) && !easy3d::file_system::create_directory(scratch)) {
+        std::cerr << "could not create the scratch directory: " << scratch << std::endl;
+        return EXIT_FAILURE;
+    }
+    set_scratch_directory(scratch);
+
+    std::vector<Result> previous;
+    if (!baseline.empty() && !load_results(baseline, previous))
+        return EXIT_FAILURE;
+
+    const auto results = suite.run(scales, repetitions, filter);
+
+    if (!output.empty()) {
+        if (!save_results(output, results))
+            return EXIT_FAILURE;
+        std::cout << "results written to " << output << std::endl;
+    }
+
+    if (!baseline.empty() && compare(previous, results, tolerance) > 0)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
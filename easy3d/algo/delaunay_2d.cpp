@@ -13,6 +13,7 @@
 #include <cstring> // for memset
 
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/profiler.h>
 
 extern "C" {
 #include <3rd_party/triangle/triangle.h>
@@ -60,6 +61,8 @@ namespace easy3d {
     }
 
     void Delaunay2::set_vertices(unsigned int nb_vertices, const float *vertices) {
+        EASY3D_PROFILE_ZONE("Delaunay2::set_vertices");
+        EASY3D_PROFILE_ELEMENTS(nb_vertices);
         LOG(INFO) << "Delaunay triangulation...";
         StopWatch t;
 
@@ -10,6 +10,7 @@
 
 #include <easy3d/algo/delaunay_3d.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/tetgen/tetgen.h>
 
@@ -31,6 +32,8 @@ namespace easy3d {
     }
 
     void Delaunay3::set_vertices(unsigned int nb_vertices, const float *vertices) {
+        EASY3D_PROFILE_ZONE("Delaunay3::set_vertices");
+        EASY3D_PROFILE_ELEMENTS(nb_vertices);
         Delaunay::set_vertices(nb_vertices, vertices);
         tetgen_out_->clean_memory();
         tetgen_in_->numberofpoints = nb_vertices;
@@ -30,6 +30,9 @@
 #include <easy3d/kdtree/kdtree_search_nanoflann.h>
 
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/progress.h>
+#include <easy3d/util/thread_pool.h>
+#include <easy3d/util/profiler.h>
 
 
 #ifdef HAS_BOOST
@@ -51,6 +54,8 @@ namespace easy3d {
 
     bool PointCloudNormals::estimate(PointCloud *cloud, unsigned int k /* = 16 */,
                                      bool compute_curvature /* = false */) const {
+        EASY3D_PROFILE_ZONE("PointCloudNormals::estimate");
+        EASY3D_PROFILE_ELEMENTS(cloud ? cloud->n_vertices() : 0);
         if (!cloud) {
             LOG(ERROR) << "empty input point cloud";
             return false;
@@ -77,8 +82,8 @@ namespace easy3d {
         w.restart();
         LOG(INFO) << "estimating normals...";
 
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
+        ProgressLogger progress(num, false);
+        const bool finished = parallel_for(0, num, [&](int i) {
             const vec3 &p = points[i];
             std::vector<int> neighbors;
             kdtree.find_closest_k_points(p, k, neighbors);
@@ -99,6 +104,12 @@ namespace easy3d {
             if (compute_curvature)
                 (*curvatures)[i] = float(
                         pca.eigen_value(2) / (pca.eigen_value(0) + pca.eigen_value(1) + pca.eigen_value(2)));
+            progress.next();
+        }, &progress);
+
+        if (!finished) {
+            LOG(WARNING) << "normal estimation canceled";
+            return false;
         }
 
         LOG(INFO) << "done. " << w.time_string();
@@ -373,6 +384,8 @@ namespace easy3d {
 
 
     bool PointCloudNormals::reorient(PointCloud *cloud, unsigned int k) const {
+        EASY3D_PROFILE_ZONE("PointCloudNormals::reorient");
+        EASY3D_PROFILE_ELEMENTS(cloud ? cloud->n_vertices() : 0);
         if (!cloud) {
             LOG(ERROR) << "empty input point cloud";
             return false;
@@ -32,6 +32,8 @@
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/thread_pool.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/poisson/MyTime.h>
 #include <3rd_party/poisson/MemoryUsage.h>
@@ -100,7 +102,7 @@ namespace easy3d {
         scale_ = 1.1f;
         pointWeight_ = 4.0f;
         gsIter_ = 8;
-        threads_ = omp_get_num_procs();
+        threads_ = static_cast<int>(ThreadPool::concurrency());   // respects the global limit
         LOG(INFO) << "number of threads: " << threads_;
 
         confidence_ = false;
@@ -196,6 +198,8 @@ namespace easy3d {
     // \endcond
 
     SurfaceMesh *PoissonReconstruction::apply(const PointCloud *cloud, const std::string &density_attr_name) {
+        EASY3D_PROFILE_ZONE("PoissonReconstruction::apply");
+        EASY3D_PROFILE_ELEMENTS(cloud ? cloud->n_vertices() : 0);
         if (!cloud) {
             LOG(ERROR) << "nullptr point cloud";
             return nullptr;
@@ -278,9 +282,9 @@ namespace easy3d {
                                                    *samples, sampleData);
             iXForm = xForm.inverse();
 
-#pragma omp parallel for num_threads(threads_)
-            for (int i = 0; i < (int) samples->size(); i++)
+            parallel_for(0, static_cast<int>(samples->size()), [samples](int i) {
                 (*samples)[i].sample.data.n *= (REAL) -1;
+            });
 
             if (verbose_)
                 profiler.print(" - Load input into tree: ");
@@ -412,14 +416,21 @@ namespace easy3d {
             profiler.start();
             double valueSum = 0, weightSum = 0;
             typename Octree<REAL>::template MultiThreadedEvaluator<DEGREE, BType> evaluator(&tree, solution, threads_);
-#pragma omp parallel for num_threads(threads_) reduction( + : valueSum, weightSum )
-            for (int j = 0; j < samples->size(); j++) {
-                ProjectiveData<OrientedPoint3D<REAL>, REAL> &sample = (*samples)[j].sample;
-                REAL w = sample.weight;
-                if (w > 0)
-                    weightSum += w, valueSum += evaluator.value(sample.data.p / sample.weight, omp_get_thread_num(),
-                                                                (*samples)[j].node) * w;
-            }
+            // one chunk per slot of the evaluator, so a slot is never used by two threads at the same time
+            const std::size_t num_samples = samples->size();
+            std::vector<double> valueSums(threads_, 0.0), weightSums(threads_, 0.0);
+            parallel_for(0, threads_, [&](int c) {
+                const std::size_t b = num_samples * c / threads_, e = num_samples * (c + 1) / threads_;
+                for (std::size_t j = b; j < e; j++) {
+                    ProjectiveData<OrientedPoint3D<REAL>, REAL> &sample = (*samples)[j].sample;
+                    REAL w = sample.weight;
+                    if (w > 0)
+                        weightSums[c] += w, valueSums[c] += evaluator.value(sample.data.p / sample.weight, c,
+                                                                            (*samples)[j].node) * w;
+                }
+            }, nullptr, 1);
+            for (int c = 0; c < threads_; ++c)
+                valueSum += valueSums[c], weightSum += weightSums[c];
             isoValue = (REAL) (valueSum / weightSum);
 
             PointCloud::VertexProperty<vec3> colors = cloud->get_vertex_property<vec3>("v:color");
@@ -499,6 +510,7 @@ namespace easy3d {
             float trim_value,
             float area_ratio,
             bool triangulate) {
+        EASY3D_PROFILE_ZONE("PoissonReconstruction::trim");
         if (!mesh)
             return nullptr;
 
@@ -30,6 +30,8 @@
 #include <list>
 
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/thread_pool.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/ransac/RansacShapeDetector.h>
 #include <3rd_party/ransac/PlanePrimitiveShapeConstructor.h>
@@ -238,6 +240,7 @@ namespace easy3d {
             float bitmap_reso /* = 0.02 */,
             float normal_thresh /* = 0.8 */,
             float overlook_prob /* = 0.001 */ ) {
+        EASY3D_PROFILE_ZONE("PrimitivesRansac::detect");
         if (!cloud) {
             LOG(ERROR) << "no data exists";
             return 0;
@@ -265,8 +268,7 @@ namespace easy3d {
 
         const std::vector<vec3> &nms = normals.vector();
         const std::vector<vec3> &pts = cloud->points();
-#pragma omp parallel for
-        for (int i = 0; i < pts.size(); ++i) {
+        parallel_for(std::size_t(0), pts.size(), [&](std::size_t i) {
             const vec3 &p = pts[i];
             const vec3 &n = nms[i];
             pc[i] = Point(
@@ -274,7 +276,7 @@ namespace easy3d {
                     Vec3f(n.x, n.y, n.z)
             );
             pc[i].index = i;
-        }
+        });
 
         return details::do_detect(cloud, pc, types_, min_support, dist_thresh, bitmap_reso, normal_thresh, overlook_prob);
     }
@@ -288,6 +290,7 @@ namespace easy3d {
             float bitmap_reso /* = 0.02 */,
             float normal_thresh /* = 0.8 */,
             float overlook_prob /* = 0.001 */ ) {
+        EASY3D_PROFILE_ZONE("PrimitivesRansac::detect");
         if (!cloud) {
             LOG(ERROR) << "no data exists";
             return 0;
@@ -315,8 +318,7 @@ namespace easy3d {
 
         const std::vector<vec3> &nms = normals.vector();
         const std::vector<vec3> &pts = cloud->points();
-#pragma omp parallel for
-        for (int index = 0; index < vertitces.size(); ++index) {
+        parallel_for(std::size_t(0), vertitces.size(), [&](std::size_t index) {
             std::size_t idx = vertitces[index];
             const vec3 &p = pts[idx];
             const vec3 &n = nms[idx];
@@ -325,7 +327,7 @@ namespace easy3d {
                     Vec3f(n.x, n.y, n.z)
             );
             pc[index].index = idx;
-        }
+        });
 
         return details::do_detect(cloud, pc, types_, min_support, dist_thresh, bitmap_reso, normal_thresh, overlook_prob);
     }
@@ -32,6 +32,7 @@
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/util/logging.h>
 #include <easy3d/kdtree/kdtree_search_eth.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -133,6 +134,7 @@ namespace easy3d {
 
 
     std::vector<PointCloud::Vertex> PointCloudSimplification::grid_simplification(PointCloud *cloud, float epsilon) {
+        EASY3D_PROFILE_ZONE("PointCloudSimplification::grid_simplification");
         assert(epsilon > 0);
 
         struct Point {
@@ -161,6 +163,7 @@ namespace easy3d {
 
     std::vector<PointCloud::Vertex>
     PointCloudSimplification::uniform_simplification(PointCloud *cloud, float epsilon, KdTreeSearch *tree) {
+        EASY3D_PROFILE_ZONE("PointCloudSimplification::uniform_simplification");
         KdTreeSearch *kdtree = tree;
         bool need_delete(false);
         if (!kdtree) {
@@ -293,6 +296,7 @@ namespace easy3d {
 
     std::vector<PointCloud::Vertex>
     PointCloudSimplification::uniform_simplification(PointCloud *cloud, unsigned int num_expected) {
+        EASY3D_PROFILE_ZONE("PointCloudSimplification::uniform_simplification");
         std::vector<PointCloud::Vertex> points_to_delete;
 
         int num_original = cloud->n_vertices();
@@ -12,6 +12,7 @@
 #include <easy3d/algo/surface_mesh_curvature.h>
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/core/eigen_solver.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -29,6 +30,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshCurvature::analyze(unsigned int post_smoothing_steps) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshCurvature::analyze");
         float kmin, kmax, mean, gauss;
         float area, sum_angles;
         float weight, sum_weights;
@@ -16,6 +16,7 @@
 
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -50,6 +51,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshFairing::fair(unsigned int k) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshFairing::fair");
         // compute cotan weights
         for (auto v : mesh_->vertices()) {
             vweight_[v] = 0.5 / geom::voronoi_area(mesh_, v);
@@ -10,6 +10,7 @@
  ********************************************************************/
 
 #include <easy3d/algo/surface_mesh_geodesic.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -135,6 +136,7 @@ namespace easy3d {
     unsigned int SurfaceMeshGeodesic::compute(const std::vector<SurfaceMesh::Vertex> &seed,
                                               float maxdist, unsigned int maxnum,
                                               std::vector<SurfaceMesh::Vertex> *neighbors) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshGeodesic::compute");
         unsigned int num(0);
 
         // generate front
@@ -16,6 +16,7 @@
 
 #include <easy3d/algo/surface_mesh_fairing.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/profiler.h>
 
 using SparseMatrix = Eigen::SparseMatrix<double>;
 using Triplet = Eigen::Triplet<double>;
@@ -62,6 +63,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     bool SurfaceMeshHoleFilling::fill_hole(SurfaceMesh::Halfedge _h) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshHoleFilling::fill_hole");
         // is it really a hole?
         if (!mesh_->is_border(_h)) {
             return false;
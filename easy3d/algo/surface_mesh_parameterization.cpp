@@ -17,6 +17,7 @@
 
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -91,6 +92,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshParameterization::harmonic(bool use_uniform_weights) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshParameterization::harmonic");
         // map boundary to circle
         if (!setup_boundary_constraints()) {
             LOG(ERROR) << "failed setup boundary constraints.";
@@ -226,6 +228,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshParameterization::lscm() {
+        EASY3D_PROFILE_ZONE("SurfaceMeshParameterization::lscm");
         // boundary constraints
         if (!setup_lscm_boundary())
             return;
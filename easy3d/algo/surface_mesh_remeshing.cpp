@@ -18,6 +18,7 @@
 #include <easy3d/algo/surface_mesh_curvature.h>
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/util/progress.h>
+#include <easy3d/util/profiler.h>
 
 namespace easy3d {
 
@@ -37,6 +38,7 @@ namespace easy3d {
     void SurfaceMeshRemeshing::uniform_remeshing(float edge_length,
                                                  unsigned int iterations,
                                                  bool use_projection) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshRemeshing::uniform_remeshing");
         uniform_ = true;
         use_projection_ = use_projection;
         target_edge_length_ = edge_length;
@@ -72,6 +74,7 @@ namespace easy3d {
                                                   float approx_error,
                                                   unsigned int iterations,
                                                   bool use_projection) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshRemeshing::adaptive_remeshing");
         uniform_ = false;
         min_edge_length_ = min_edge_length;
         max_edge_length_ = max_edge_length;
@@ -30,12 +30,14 @@
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/progress.h>
 #include <easy3d/algo/surface_mesh_triangulation.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
 
 
     PointCloud *SurfaceMeshSampler::apply(const SurfaceMesh *input_mesh, int expected_num /* = 1000000 */) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSampler::apply");
         auto func = [](const SurfaceMesh *mesh, int num) -> PointCloud * {
             PointCloud *cloud = new PointCloud;
             const std::string &name = file_system::name_less_extension(mesh->name()) + "_sampled.ply";
@@ -10,6 +10,7 @@
  ********************************************************************/
 
 #include <easy3d/algo/surface_mesh_simplification.h>
+#include <easy3d/util/profiler.h>
 
 #include <cfloat>
 #include <iterator> // for back_inserter on Windows
@@ -123,6 +124,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshSimplification::simplify(unsigned int n_vertices) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSimplification::simplify");
         if (!mesh_->is_triangle_mesh()) {
             std::cerr << "Not a triangle mesh!" << std::endl;
             return;
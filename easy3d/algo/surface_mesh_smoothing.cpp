@@ -15,6 +15,7 @@
 #include <Eigen/Sparse>
 
 #include <easy3d/algo/surface_mesh_geometry.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -79,6 +80,7 @@ namespace easy3d {
 
     void SurfaceMeshSmoothing::explicit_smoothing(unsigned int iters,
                                                   bool use_uniform_laplace) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSmoothing::explicit_smoothing");
         if (!mesh_->n_vertices())
             return;
 
@@ -130,6 +132,7 @@ namespace easy3d {
     void SurfaceMeshSmoothing::implicit_smoothing(float timestep,
                                                   bool use_uniform_laplace,
                                                   bool rescale) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSmoothing::implicit_smoothing");
         if (!mesh_->n_vertices())
             return;
 
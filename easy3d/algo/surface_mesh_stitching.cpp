@@ -30,6 +30,7 @@
 #include <cassert>
 
 #include <easy3d/core/surface_mesh.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/kdtree/ANN/ANN.h>
 
@@ -167,6 +168,7 @@ namespace easy3d {
 
 
     void SurfaceMeshStitching::apply(float dist_threshold) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshStitching::apply");
         auto scheduled = mesh_->add_halfedge_property<bool>("h::scheduled::SurfaceMeshStitching::apply", false);
         std::vector<std::pair<SurfaceMesh::Halfedge, SurfaceMesh::Halfedge> > to_stitch;
 
@@ -13,11 +13,13 @@
 #include <easy3d/algo/surface_mesh_subdivision.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/algo/surface_mesh_geometry.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
 
     bool SurfaceMeshSubdivision::catmull_clark(SurfaceMesh *mesh) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSubdivision::catmull_clark");
         if (!mesh)
             return false;
 
@@ -177,6 +179,7 @@ namespace easy3d {
 
 
     bool SurfaceMeshSubdivision::loop(SurfaceMesh *mesh) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSubdivision::loop");
         if (!mesh)
             return false;
 
@@ -328,6 +331,7 @@ namespace easy3d {
 
 
     bool SurfaceMeshSubdivision::sqrt3(SurfaceMesh *mesh) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshSubdivision::sqrt3");
         if (!mesh)
             return false;
 
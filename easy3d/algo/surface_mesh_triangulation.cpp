@@ -10,6 +10,7 @@
  ********************************************************************/
 
 #include <easy3d/algo/surface_mesh_triangulation.h>
+#include <easy3d/util/profiler.h>
 
 #include <climits>
 
@@ -25,6 +26,7 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshTriangulation::triangulate(Objective o) {
+        EASY3D_PROFILE_ZONE("SurfaceMeshTriangulation::triangulate");
         for (auto f: mesh_->faces())
             triangulate(f, o);
     }
@@ -0,0 +1,336 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/algo/triangle_order_optimizer.h>
+
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+
+namespace easy3d {
+
+    namespace details {
+
+        // the number of groups
+        inline std::size_t num_groups(const std::vector<unsigned int> &indices, const std::vector<unsigned int> &groups) {
+            return groups.empty() ? indices.size() / 3 : groups.size() - 1;
+        }
+
+        // the first and the past-the-end triangles of a group
+        inline std::pair<std::size_t, std::size_t> group_range(const std::vector<unsigned int> &groups, std::size_t g) {
+            if (groups.empty())
+                return std::make_pair(g, g + 1);
+            return std::make_pair(std::size_t(groups[g]), std::size_t(groups[g + 1]));
+        }
+
+        // A FIFO vertex cache, simulated using time stamps: a vertex is in the cache if less than 'size' vertices
+        // entered the cache after it.
+        class VertexCache {
+        public:
+            VertexCache(std::size_t num_vertices, std::size_t size)
+                    : size_(size), time_(size + 1), stamps_(num_vertices, 0) {}
+
+            // returns true if the vertex was not in the cache
+            bool access(unsigned int v) {
+                if (time_ - stamps_[v] > size_) {
+                    stamps_[v] = time_++;
+                    return true;
+                }
+                return false;
+            }
+
+            // the number of vertices that entered the cache after v
+            std::size_t age(unsigned int v) const { return time_ - stamps_[v]; }
+
+            void flush() { time_ += size_ + 1; }
+
+        private:
+            std::size_t size_;
+            std::size_t time_;
+            std::vector<std::size_t> stamps_;
+        };
+
+    }
+
+
+    TriangleOrderOptimizer::Statistics
+    TriangleOrderOptimizer::analyze(const std::vector<unsigned int> &indices, std::size_t num_vertices,
+                                    std::size_t cache_size) {
+        Statistics stats;
+        if (indices.size() < 3)
+            return stats;
+
+        details::VertexCache cache(num_vertices, cache_size);
+        std::vector<bool> referenced(num_vertices, false);
+        std::size_t misses = 0, num_referenced = 0;
+        for (auto v : indices) {
+            assert(v < num_vertices);
+            if (cache.access(v))
+                ++misses;
+            if (!referenced[v]) {
+                referenced[v] = true;
+                ++num_referenced;
+            }
+        }
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(num_referenced);
+        return stats;
+    }
+
+
+    std::vector<unsigned int>
+    TriangleOrderOptimizer::optimize_vertex_cache(const std::vector<unsigned int> &indices, std::size_t num_vertices,
+                                                  const std::vector<unsigned int> &groups, std::size_t cache_size,
+                                                  std::vector<unsigned int> *clusters) {
+        const std::size_t num = details::num_groups(indices, groups);
+        std::vector<unsigned int> order;
+        order.reserve(num);
+        if (clusters)
+            clusters->clear();
+
+        // the groups incident to each vertex (one entry per corner) and the number of corners not emitted yet
+        std::vector<unsigned int> live(num_vertices, 0);
+        for (auto v : indices)
+            ++live[v];
+        std::vector<unsigned int> offsets(num_vertices + 1, 0);
+        std::partial_sum(live.begin(), live.end(), offsets.begin() + 1);
+        std::vector<unsigned int> adjacency(indices.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t g = 0; g < num; ++g) {
+            const auto range = details::group_range(groups, g);
+            for (std::size_t i = range.first * 3; i < range.second * 3; ++i)
+                adjacency[fill[indices[i]]++] = static_cast<unsigned int>(g);
+        }
+
+        details::VertexCache cache(num_vertices, cache_size);
+        std::vector<bool> emitted(num, false);
+        std::vector<unsigned int> dead_end;     // recently used vertices, in case the fanning gets stuck
+        std::vector<unsigned int> candidates;
+        std::size_t cursor = 0;                 // for finding a vertex with remaining groups in the input order
+
+        auto skip_dead_end = [&]() -> int {
+            while (!dead_end.empty()) {
+                const unsigned int v = dead_end.back();
+                dead_end.pop_back();
+                if (live[v] > 0)
+                    return static_cast<int>(v);
+            }
+            for (; cursor < num_vertices; ++cursor) {
+                if (live[cursor] > 0)
+                    return static_cast<int>(cursor);
+            }
+            return -1;
+        };
+
+        int fan = skip_dead_end();
+        bool restarted = true;
+        while (fan >= 0) {
+            if (restarted && clusters)
+                clusters->push_back(static_cast<unsigned int>(order.size()));
+
+            // emit all the remaining groups around the fanning vertex
+            candidates.clear();
+            for (unsigned int k = offsets[fan]; k < offsets[fan + 1]; ++k) {
+                const unsigned int g = adjacency[k];
+                if (emitted[g])
+                    continue;
+                const auto range = details::group_range(groups, g);
+                for (std::size_t i = range.first * 3; i < range.second * 3; ++i) {
+                    const unsigned int v = indices[i];
+                    dead_end.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    cache.access(v);
+                }
+                emitted[g] = true;
+                order.push_back(g);
+            }
+
+            // the next fanning vertex: the oldest candidate that will still be in the cache after emitting its groups
+            int best = -1;
+            std::size_t best_priority = 0;
+            for (auto v : candidates) {
+                if (live[v] == 0)
+                    continue;
+                std::size_t priority = 0;
+                const std::size_t age = cache.age(v);
+                if (age + 2 * live[v] <= cache_size)
+                    priority = age;
+                if (best < 0 || priority > best_priority) {
+                    best = static_cast<int>(v);
+                    best_priority = priority;
+                }
+            }
+
+            restarted = (best < 0);
+            fan = restarted ? skip_dead_end() : best;
+        }
+
+        assert(order.size() == num);
+        return order;
+    }
+
+
+    std::vector<unsigned int>
+    TriangleOrderOptimizer::optimize_overdraw(const std::vector<unsigned int> &indices, const std::vector<vec3> &points,
+                                              const std::vector<unsigned int> &groups,
+                                              const std::vector<unsigned int> &order,
+                                              const std::vector<unsigned int> &clusters,
+                                              std::size_t cache_size, float threshold) {
+        if (order.empty())
+            return order;
+
+        // the cache misses and the number of triangles of the groups in [begin, end) of the order
+        details::VertexCache cache(points.size(), cache_size);
+        auto simulate = [&](std::size_t g, std::size_t &misses, std::size_t &triangles) {
+            const auto range = details::group_range(groups, g);
+            for (std::size_t i = range.first * 3; i < range.second * 3; ++i) {
+                if (cache.access(indices[i]))
+                    ++misses;
+            }
+            triangles += range.second - range.first;
+        };
+
+        // split the hard clusters into smaller ones with a comparable cache efficiency
+        std::vector<unsigned int> starts;
+        std::vector<unsigned int> hard = clusters;
+        if (hard.empty() || hard.front() != 0)
+            hard.insert(hard.begin(), 0);
+        hard.push_back(static_cast<unsigned int>(order.size()));
+        for (std::size_t c = 0; c + 1 < hard.size(); ++c) {
+            const std::size_t begin = hard[c], end = hard[c + 1];
+            if (begin >= end)
+                continue;
+            std::size_t misses = 0, triangles = 0;
+            cache.flush();
+            for (std::size_t i = begin; i < end; ++i)
+                simulate(order[i], misses, triangles);
+            const float cluster_acmr = static_cast<float>(misses) / static_cast<float>(std::max<std::size_t>(triangles, 1));
+
+            starts.push_back(static_cast<unsigned int>(begin));
+            misses = triangles = 0;
+            cache.flush();
+            for (std::size_t i = begin; i < end; ++i) {
+                simulate(order[i], misses, triangles);
+                const float acmr = static_cast<float>(misses) / static_cast<float>(std::max<std::size_t>(triangles, 1));
+                if (i + 1 < end && acmr <= cluster_acmr * threshold) {
+                    starts.push_back(static_cast<unsigned int>(i + 1));
+                    misses = triangles = 0;
+                    cache.flush();
+                }
+            }
+        }
+        starts.push_back(static_cast<unsigned int>(order.size()));
+
+        // the area weighted centroid and normal of each cluster, and of the whole model
+        const std::size_t num_clusters = starts.size() - 1;
+        std::vector<vec3> centroids(num_clusters), normals(num_clusters);
+        std::vector<float> areas(num_clusters, 0.0f);
+        vec3 center(0, 0, 0);
+        float total_area = 0.0f;
+        for (std::size_t c = 0; c < num_clusters; ++c) {
+            vec3 centroid(0, 0, 0), normal(0, 0, 0);
+            float area = 0.0f;
+            for (std::size_t i = starts[c]; i < starts[c + 1]; ++i) {
+                const auto range = details::group_range(groups, order[i]);
+                for (std::size_t t = range.first; t < range.second; ++t) {
+                    const vec3 &a = points[indices[t * 3]];
+                    const vec3 &b = points[indices[t * 3 + 1]];
+                    const vec3 &d = points[indices[t * 3 + 2]];
+                    const vec3 n = cross(b - a, d - a);
+                    const float s = n.length() * 0.5f;
+                    centroid += (a + b + d) * (s / 3.0f);
+                    normal += n;
+                    area += s;
+                }
+            }
+            if (area > 0.0f)
+                centroids[c] = centroid / area;
+            else if (starts[c] < starts[c + 1]) {
+                const auto range = details::group_range(groups, order[starts[c]]);
+                centroids[c] = points[indices[range.first * 3]];
+            }
+            normals[c] = normalize(normal);
+            areas[c] = area;
+            center += centroid;
+            total_area += area;
+        }
+        if (total_area > 0.0f)
+            center /= total_area;
+
+        // the clusters facing outwards (i.e., more likely to occlude the others) are drawn first
+        std::vector<float> keys(num_clusters);
+        for (std::size_t c = 0; c < num_clusters; ++c)
+            keys[c] = dot(centroids[c] - center, normals[c]);
+        std::vector<unsigned int> sorted(num_clusters);
+        std::iota(sorted.begin(), sorted.end(), 0u);
+        std::stable_sort(sorted.begin(), sorted.end(), [&keys](unsigned int a, unsigned int b) {
+            return keys[a] > keys[b];
+        });
+
+        std::vector<unsigned int> result;
+        result.reserve(order.size());
+        for (auto c : sorted)
+            result.insert(result.end(), order.begin() + starts[c], order.begin() + starts[c + 1]);
+        return result;
+    }
+
+
+    std::vector<unsigned int>
+    TriangleOrderOptimizer::optimize(const std::vector<unsigned int> &indices, const std::vector<vec3> &points,
+                                     const std::vector<unsigned int> &groups, std::size_t cache_size, float threshold) {
+        std::vector<unsigned int> clusters;
+        const std::vector<unsigned int> &order = optimize_vertex_cache(indices, points.size(), groups, cache_size, &clusters);
+        return optimize_overdraw(indices, points, groups, order, clusters, cache_size, threshold);
+    }
+
+
+    void TriangleOrderOptimizer::apply(const std::vector<unsigned int> &order, std::vector<unsigned int> &indices,
+                                       std::vector<unsigned int> &groups) {
+        assert(order.size() == details::num_groups(indices, groups));
+
+        std::vector<unsigned int> new_indices;
+        new_indices.reserve(indices.size());
+        std::vector<unsigned int> new_groups;
+        if (!groups.empty())
+            new_groups.reserve(groups.size());
+
+        for (auto g : order) {
+            const auto range = details::group_range(groups, g);
+            if (!groups.empty())
+                new_groups.push_back(static_cast<unsigned int>(new_indices.size() / 3));
+            new_indices.insert(new_indices.end(), indices.begin() + range.first * 3, indices.begin() + range.second * 3);
+        }
+        if (!groups.empty()) {
+            new_groups.push_back(static_cast<unsigned int>(new_indices.size() / 3));
+            groups.swap(new_groups);
+        }
+        indices.swap(new_indices);
+    }
+
+}
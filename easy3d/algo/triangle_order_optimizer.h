@@ -0,0 +1,143 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_ALGO_TRIANGLE_ORDER_OPTIMIZER_H
+#define EASY3D_ALGO_TRIANGLE_ORDER_OPTIMIZER_H
+
+
+#include <vector>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Reorders triangles for efficient rendering, i.e., to reduce the vertex shader invocations (by making
+     *      better use of the post-transform vertex cache) and the overdraw.
+     * \class TriangleOrderOptimizer easy3d/algo/triangle_order_optimizer.h
+     * \details The triangles are given by their vertex indices (3 per triangle), in the same form as an element
+     *      buffer. Consecutive triangles can be grouped (e.g., the triangles of a polygonal face), and the triangles
+     *      of a group are kept together and in their original order. The result is a new order of the groups. See
+     *      the following paper for more details:
+     *      - Pedro V. Sander, Diego Nehab, and Joshua Barczak. Fast triangle reordering for vertex locality and
+     *        reduced overdraw. ACM Transactions on Graphics (SIGGRAPH), 2007.
+     *
+     *      Example usage:
+     *      \code
+     *          const auto order = TriangleOrderOptimizer::optimize(indices, points, groups);
+     *          TriangleOrderOptimizer::apply(order, indices, groups);
+     *      \endcode
+     */
+    class TriangleOrderOptimizer {
+    public:
+        /// \brief The efficiency of an order of triangles w.r.t. a FIFO post-transform vertex cache.
+        struct Statistics {
+            Statistics() : acmr(0.0f), atvr(0.0f) {}
+            /// The average cache miss ratio, i.e., the number of transformed vertices per triangle. It is within
+            /// [0.5, 3] for typical meshes (lower is better).
+            float acmr;
+            /// The average transformed vertex ratio, i.e., the number of transformed vertices per referenced vertex.
+            /// The optimum is 1.
+            float atvr;
+        };
+
+        /**
+         * \brief Simulates a FIFO vertex cache to measure the efficiency of an order of triangles.
+         * \param indices The vertex indices of the triangles (3 per triangle).
+         * \param num_vertices The number of vertices (i.e., all indices are smaller than this number).
+         * \param cache_size The number of entries of the simulated cache.
+         */
+        static Statistics analyze(const std::vector<unsigned int> &indices, std::size_t num_vertices,
+                                  std::size_t cache_size = 16);
+
+        /**
+         * \brief Computes an order of the groups of triangles that makes good use of the vertex cache (Tipsify).
+         * \param indices The vertex indices of the triangles (3 per triangle).
+         * \param num_vertices The number of vertices (i.e., all indices are smaller than this number).
+         * \param groups The index of the first triangle of each group, followed by the total number of triangles,
+         *      e.g., {0, 1, 3} for two groups made of 1 and 2 triangles. If empty, each triangle is a group.
+         * \param cache_size The number of entries of the vertex cache.
+         * \param clusters If provided, returns the positions (in the returned order) where the cache had to be
+         *      restarted. These hard boundaries are used by optimize_overdraw().
+         * \return The groups in their new order.
+         */
+        static std::vector<unsigned int> optimize_vertex_cache(const std::vector<unsigned int> &indices,
+                                                               std::size_t num_vertices,
+                                                               const std::vector<unsigned int> &groups,
+                                                               std::size_t cache_size = 16,
+                                                               std::vector<unsigned int> *clusters = nullptr);
+
+        /**
+         * \brief Reorders clusters of groups such that the clusters facing outwards are drawn first. This reduces
+         *      overdraw from most viewpoints, for a bounded loss of vertex cache efficiency.
+         * \param indices The vertex indices of the triangles (3 per triangle).
+         * \param points The vertex positions.
+         * \param groups The groups of triangles (see optimize_vertex_cache()).
+         * \param order The order of the groups computed by optimize_vertex_cache().
+         * \param clusters The hard cluster boundaries computed by optimize_vertex_cache().
+         * \param cache_size The number of entries of the vertex cache.
+         * \param threshold The clusters are split further as long as the cache miss ratio of the resulting clusters
+         *      does not exceed \p threshold times the one of the unsplit cluster. Larger values give more and smaller
+         *      clusters, and thus less overdraw.
+         * \return The groups in their new order.
+         */
+        static std::vector<unsigned int> optimize_overdraw(const std::vector<unsigned int> &indices,
+                                                           const std::vector<vec3> &points,
+                                                           const std::vector<unsigned int> &groups,
+                                                           const std::vector<unsigned int> &order,
+                                                           const std::vector<unsigned int> &clusters,
+                                                           std::size_t cache_size = 16, float threshold = 1.05f);
+
+        /**
+         * \brief Computes an order of the groups of triangles for both vertex cache efficiency and reduced overdraw.
+         * \details This is optimize_vertex_cache() followed by optimize_overdraw().
+         * \param indices The vertex indices of the triangles (3 per triangle).
+         * \param points The vertex positions.
+         * \param groups The groups of triangles (see optimize_vertex_cache()).
+         * \return The groups in their new order.
+         */
+        static std::vector<unsigned int> optimize(const std::vector<unsigned int> &indices,
+                                                  const std::vector<vec3> &points,
+                                                  const std::vector<unsigned int> &groups,
+                                                  std::size_t cache_size = 16, float threshold = 1.05f);
+
+        /**
+         * \brief Reorders the triangles (and the groups) according to a new order of the groups.
+         * \param order The new order of the groups, e.g., computed by optimize().
+         * \param indices The vertex indices of the triangles, which will be reordered.
+         * \param groups The groups of triangles, which will be updated to the new order. If empty, each triangle is a
+         *      group and it remains empty.
+         */
+        static void apply(const std::vector<unsigned int> &order, std::vector<unsigned int> &indices,
+                          std::vector<unsigned int> &groups);
+    };
+
+}
+
+
+#endif  // EASY3D_ALGO_TRIANGLE_ORDER_OPTIMIZER_H
@@ -0,0 +1,142 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/core/attribute_packing.h>
+
+#include <cmath>
+
+
+namespace easy3d {
+
+    namespace packing {
+
+        void quantize_positions(const vec3 *points, std::size_t num, const Box3 &box, uint16_t *quantized) {
+            const vec3 &origin = box.min_point();
+            vec3 scale(0.0f, 0.0f, 0.0f);
+            for (unsigned int d = 0; d < 3; ++d) {
+                const float extent = box.range(d);
+                scale[d] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+            }
+
+            for (std::size_t i = 0; i < num; ++i) {
+                for (unsigned int d = 0; d < 3; ++d) {
+                    const float v = (points[i][d] - origin[d]) * scale[d];
+                    quantized[i * 4 + d] = static_cast<uint16_t>(std::min(std::max(v, 0.0f), 65535.0f) + 0.5f);
+                }
+                quantized[i * 4 + 3] = 65535;
+            }
+        }
+
+
+        void dequantize_positions(const uint16_t *quantized, std::size_t num, const Box3 &box, vec3 *points) {
+            const vec3 &origin = box.min_point();
+            const vec3 scale(box.range(0) / 65535.0f, box.range(1) / 65535.0f, box.range(2) / 65535.0f);
+            for (std::size_t i = 0; i < num; ++i) {
+                for (unsigned int d = 0; d < 3; ++d)
+                    points[i][d] = origin[d] + static_cast<float>(quantized[i * 4 + d]) * scale[d];
+            }
+        }
+
+
+        mat4 dequantization_matrix(const Box3 &box) {
+            return mat4::translation(box.min_point()) * mat4::scale(box.range(0), box.range(1), box.range(2), 1.0f);
+        }
+
+
+        void pack_normals(const vec3 *normals, std::size_t num, uint32_t *packed) {
+            for (std::size_t i = 0; i < num; ++i)
+                packed[i] = pack_normal(normals[i]);
+        }
+
+
+        void unpack_normals(const uint32_t *packed, std::size_t num, vec3 *normals) {
+            for (std::size_t i = 0; i < num; ++i)
+                normals[i] = unpack_normal(packed[i]);
+        }
+
+
+        uint32_t encode_octahedral(const vec3 &n) {
+            const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            float x = 0.0f, y = 0.0f;
+            if (l1 > 0.0f) {
+                x = n.x / l1;
+                y = n.y / l1;
+                if (n.z < 0.0f) {
+                    const float ox = x;
+                    x = (1.0f - std::abs(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+                    y = (1.0f - std::abs(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+                }
+            }
+            const auto u = static_cast<int16_t>(std::lround(std::max(-1.0f, std::min(1.0f, x)) * 32767.0f));
+            const auto v = static_cast<int16_t>(std::lround(std::max(-1.0f, std::min(1.0f, y)) * 32767.0f));
+            return static_cast<uint32_t>(static_cast<uint16_t>(u)) | (static_cast<uint32_t>(static_cast<uint16_t>(v)) << 16);
+        }
+
+
+        vec3 decode_octahedral(uint32_t code) {
+            float x = static_cast<int16_t>(code & 0xffff) / 32767.0f;
+            float y = static_cast<int16_t>(code >> 16) / 32767.0f;
+            const float z = 1.0f - std::abs(x) - std::abs(y);
+            if (z < 0.0f) {
+                const float ox = x;
+                x = (1.0f - std::abs(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+                y = (1.0f - std::abs(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+            }
+            vec3 n(x, y, z);
+            const float len = n.length();
+            return len > 0.0f ? n / len : vec3(0, 0, 1);
+        }
+
+
+        void pack_colors(const vec3 *colors, std::size_t num, uint32_t *packed) {
+            for (std::size_t i = 0; i < num; ++i)
+                packed[i] = pack_color(vec4(colors[i], 1.0f));
+        }
+
+
+        void unpack_colors(const uint32_t *packed, std::size_t num, vec3 *colors) {
+            for (std::size_t i = 0; i < num; ++i)
+                colors[i] = vec3(unpack_color(packed[i]));
+        }
+
+
+        void pack_texcoords(const vec2 *texcoords, std::size_t num, uint16_t *packed) {
+            for (std::size_t i = 0; i < num; ++i) {
+                packed[i * 2] = half::from_float(texcoords[i].x);
+                packed[i * 2 + 1] = half::from_float(texcoords[i].y);
+            }
+        }
+
+
+        void unpack_texcoords(const uint16_t *packed, std::size_t num, vec2 *texcoords) {
+            for (std::size_t i = 0; i < num; ++i)
+                texcoords[i] = vec2(half::to_float(packed[i * 2]), half::to_float(packed[i * 2 + 1]));
+        }
+
+    }
+
+}
@@ -0,0 +1,145 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_CORE_ATTRIBUTE_PACKING_H
+#define EASY3D_CORE_ATTRIBUTE_PACKING_H
+
+
+#include <cstdint>
+#include <algorithm>
+
+#include <easy3d/core/types.h>
+#include <easy3d/core/box.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Conversion of vertex attributes into compact formats that can be decoded by the GPU on the fly.
+     * \namespace easy3d::packing
+     * \details The formats match the normalized vertex attribute formats of OpenGL, so no decoding is needed in the
+     *      shaders (except for the positions, whose dequantization is a transformation):
+     *      - positions: 4 x 16-bit unsigned normalized (GL_UNSIGNED_SHORT), quantized w.r.t. a bounding box. The
+     *        fourth component is 65535, i.e., the shaders see 1.0 for the w component. 8 bytes instead of 12.
+     *      - normals: 10:10:10:2 signed normalized (GL_INT_2_10_10_10_REV). 4 bytes instead of 12. For storage, the
+     *        octahedral encoding (also 4 bytes, but more precise) is provided.
+     *      - colors: RGBA8 unsigned normalized (GL_UNSIGNED_BYTE). 4 bytes instead of 12.
+     *      - texture coordinates: 2 x half float (GL_HALF_FLOAT). 4 bytes instead of 8.
+     *
+     *      The array versions are simple loops over contiguous memory that compilers can vectorize.
+     */
+    namespace packing {
+
+        /// \name Positions
+        //@{
+        /**
+         * \brief Quantizes positions to 16 bits per coordinate w.r.t. a bounding box.
+         * \param points The positions.
+         * \param num The number of positions.
+         * \param box The bounding box. Positions outside the box are clamped.
+         * \param quantized The quantized positions (4 values per position).
+         */
+        void quantize_positions(const vec3 *points, std::size_t num, const Box3 &box, uint16_t *quantized);
+
+        /// \brief Converts quantized positions back (see quantize_positions()).
+        void dequantize_positions(const uint16_t *quantized, std::size_t num, const Box3 &box, vec3 *points);
+
+        /// \brief The transformation from quantized positions (in [0, 1], as decoded by the GPU) to the box.
+        mat4 dequantization_matrix(const Box3 &box);
+        //@}
+
+        /// \name Normals
+        //@{
+        /// \brief Packs a unit vector into 10:10:10:2 signed normalized integers (the last component is 0).
+        inline uint32_t pack_normal(const vec3 &n) {
+            auto pack = [](float v) -> uint32_t {
+                const float c = std::min(std::max(v, -1.0f), 1.0f) * 511.0f;
+                return static_cast<uint32_t>(static_cast<int32_t>(c + (c < 0.0f ? -0.5f : 0.5f))) & 0x3ffu;
+            };
+            return pack(n.x) | (pack(n.y) << 10) | (pack(n.z) << 20);
+        }
+
+        /// \brief Unpacks a vector from 10:10:10:2 signed normalized integers.
+        inline vec3 unpack_normal(uint32_t p) {
+            auto unpack = [](uint32_t bits) -> float {
+                const int32_t v = (bits & 0x200u) ? static_cast<int32_t>(bits) - 1024 : static_cast<int32_t>(bits);
+                return std::max(static_cast<float>(v) / 511.0f, -1.0f);
+            };
+            return vec3(unpack(p & 0x3ffu), unpack((p >> 10) & 0x3ffu), unpack((p >> 20) & 0x3ffu));
+        }
+
+        /// \brief Packs normals into 10:10:10:2 signed normalized integers.
+        void pack_normals(const vec3 *normals, std::size_t num, uint32_t *packed);
+        /// \brief Unpacks normals from 10:10:10:2 signed normalized integers.
+        void unpack_normals(const uint32_t *packed, std::size_t num, vec3 *normals);
+
+        /**
+         * \brief Encodes a unit vector into two 16-bit signed integers (octahedral mapping), packed into 32 bits.
+         * \details This is more precise than pack_normal() for the same size, but it needs decoding. It is used for
+         *      storing normals in files (e.g., the compressed point cloud and surface mesh formats).
+         */
+        uint32_t encode_octahedral(const vec3 &n);
+        /// \brief Decodes a unit vector encoded by encode_octahedral().
+        vec3 decode_octahedral(uint32_t code);
+        //@}
+
+        /// \name Colors
+        //@{
+        /// \brief Packs a color into RGBA8 (in this order in memory). The components are clamped to [0, 1].
+        inline uint32_t pack_color(const vec4 &c) {
+            auto pack = [](float v) -> uint32_t {
+                return static_cast<uint32_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+            };
+            return pack(c.x) | (pack(c.y) << 8) | (pack(c.z) << 16) | (pack(c.w) << 24);
+        }
+
+        /// \brief Unpacks a color from RGBA8.
+        inline vec4 unpack_color(uint32_t p) {
+            return vec4(static_cast<float>(p & 0xffu), static_cast<float>((p >> 8) & 0xffu),
+                        static_cast<float>((p >> 16) & 0xffu), static_cast<float>(p >> 24)) / 255.0f;
+        }
+
+        /// \brief Packs opaque colors into RGBA8.
+        void pack_colors(const vec3 *colors, std::size_t num, uint32_t *packed);
+        /// \brief Unpacks colors from RGBA8 (the alpha is ignored).
+        void unpack_colors(const uint32_t *packed, std::size_t num, vec3 *colors);
+        //@}
+
+        /// \name Texture coordinates
+        //@{
+        /// \brief Packs texture coordinates into half floats (2 values per texture coordinate).
+        void pack_texcoords(const vec2 *texcoords, std::size_t num, uint16_t *packed);
+        /// \brief Unpacks texture coordinates from half floats.
+        void unpack_texcoords(const uint16_t *packed, std::size_t num, vec2 *texcoords);
+        //@}
+
+    }
+
+}
+
+
+#endif  // EASY3D_CORE_ATTRIBUTE_PACKING_H
@@ -0,0 +1,171 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/core/dirty_ranges.h>
+
+#include <algorithm>
+
+
+namespace easy3d {
+
+    DirtyRanges::DirtyRanges(std::size_t merge_gap)
+            : merge_gap_(merge_gap)
+            , all_(false)
+    {
+    }
+
+
+    void DirtyRanges::add(std::size_t begin, std::size_t end) {
+        if (all_ || begin >= end)
+            return;
+
+        // the first range that could be merged with [begin, end), i.e., the first one with
+        // range.second + merge_gap >= begin
+        auto first = std::lower_bound(ranges_.begin(), ranges_.end(), begin,
+                                      [this](const Range &r, std::size_t b) { return r.second + merge_gap_ < b; }
+        );
+        // the ranges in [first, last) will be merged with [begin, end)
+        auto last = first;
+        while (last != ranges_.end() && last->first <= end + merge_gap_)
+            ++last;
+
+        if (first == last) {
+            ranges_.insert(first, Range(begin, end));
+            return;
+        }
+
+        first->first = std::min(first->first, begin);
+        first->second = std::max((last - 1)->second, end);
+        ranges_.erase(first + 1, last);
+    }
+
+
+    void DirtyRanges::add(const DirtyRanges &other) {
+        if (other.all_)
+            add_all();
+        else {
+            for (const auto &r : other.ranges_)
+                add(r.first, r.second);
+        }
+    }
+
+
+    void DirtyRanges::add_all() {
+        all_ = true;
+        ranges_.clear();
+    }
+
+
+    void DirtyRanges::clear() {
+        all_ = false;
+        ranges_.clear();
+    }
+
+
+    bool DirtyRanges::contains(std::size_t index) const {
+        if (all_)
+            return true;
+        auto pos = std::upper_bound(ranges_.begin(), ranges_.end(), index,
+                                    [](std::size_t i, const Range &r) { return i < r.second; }
+        );
+        return pos != ranges_.end() && pos->first <= index;
+    }
+
+
+    DirtyRanges::Range DirtyRanges::bounds() const {
+        if (ranges_.empty())
+            return Range(0, 0);
+        return Range(ranges_.front().first, ranges_.back().second);
+    }
+
+
+    std::size_t DirtyRanges::count() const {
+        std::size_t num = 0;
+        for (const auto &r : ranges_)
+            num += r.second - r.first;
+        return num;
+    }
+
+
+    void DirtyRanges::clip(std::size_t size) {
+        if (all_) {
+            all_ = false;
+            ranges_.clear();
+            if (size > 0)
+                ranges_.emplace_back(0, size);
+            return;
+        }
+
+        while (!ranges_.empty() && ranges_.back().first >= size)
+            ranges_.pop_back();
+        if (!ranges_.empty())
+            ranges_.back().second = std::min(ranges_.back().second, size);
+    }
+
+
+    void DirtyRanges::coalesce(std::size_t max_ranges) {
+        if (max_ranges == 0)
+            max_ranges = 1;
+        if (ranges_.size() <= max_ranges)
+            return;
+
+        // the largest gaps are kept; all ranges separated by smaller gaps are merged
+        std::vector<std::size_t> gaps(ranges_.size() - 1);
+        for (std::size_t i = 0; i < gaps.size(); ++i)
+            gaps[i] = ranges_[i + 1].first - ranges_[i].second;
+
+        std::vector<std::size_t> sorted = gaps;
+        const std::size_t num_kept = max_ranges - 1;   // number of gaps that can be kept
+        std::nth_element(sorted.begin(), sorted.begin() + (sorted.size() - num_kept - 1), sorted.end());
+        const std::size_t threshold = sorted[sorted.size() - num_kept - 1];
+
+        // gaps larger than the threshold are kept. Ties at the threshold are kept only while there is room.
+        std::size_t num_larger = 0;
+        for (auto g : gaps) {
+            if (g > threshold)
+                ++num_larger;
+        }
+        std::size_t ties_allowed = num_kept - num_larger;
+
+        std::vector<Range> result;
+        result.reserve(max_ranges);
+        result.push_back(ranges_[0]);
+        for (std::size_t i = 0; i < gaps.size(); ++i) {
+            bool keep = gaps[i] > threshold;
+            if (!keep && gaps[i] == threshold && ties_allowed > 0) {
+                keep = true;
+                --ties_allowed;
+            }
+            if (keep)
+                result.push_back(ranges_[i + 1]);
+            else
+                result.back().second = ranges_[i + 1].second;
+        }
+        ranges_.swap(result);
+    }
+
+}
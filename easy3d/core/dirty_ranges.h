@@ -0,0 +1,119 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_CORE_DIRTY_RANGES_H
+#define EASY3D_CORE_DIRTY_RANGES_H
+
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+
+namespace easy3d {
+
+    /**
+     * \brief A set of modified element ranges of a property (e.g., the positions or colors of some vertices).
+     * \class DirtyRanges easy3d/core/dirty_ranges.h
+     * \details The ranges are half-open intervals [begin, end) of element indices. They are kept sorted and disjoint:
+     *      overlapping or touching ranges are merged when added. Ranges separated by a gap not larger than
+     *      \c merge_gap are also merged, which trades uploading a few unchanged elements for fewer (and larger)
+     *      buffer updates. A DirtyRanges can also be marked "all", meaning every element has to be updated (e.g.,
+     *      after a change of the topology).
+     *      This class contains no OpenGL code, so the bookkeeping can be tested without a rendering context.
+     * \see Model::mark_modified(), Drawable::update_vertex_buffer()
+     */
+    class DirtyRanges {
+    public:
+        /// A half-open range [first, second) of element indices.
+        typedef std::pair<std::size_t, std::size_t> Range;
+
+        /**
+         * \brief Constructor.
+         * \param merge_gap Two ranges are merged if the number of clean elements between them is not larger than
+         *      this value.
+         */
+        explicit DirtyRanges(std::size_t merge_gap = 0);
+
+        /// \brief Marks the element \p index as modified.
+        void add(std::size_t index) { add(index, index + 1); }
+        /// \brief Marks the elements in [\p begin, \p end) as modified. Empty ranges are ignored.
+        void add(std::size_t begin, std::size_t end);
+        /// \brief Marks all the modified elements of \p other as modified.
+        void add(const DirtyRanges& other);
+        /// \brief Marks all elements as modified.
+        void add_all();
+
+        /// \brief Returns \c true if all elements have been marked as modified.
+        bool all() const { return all_; }
+        /// \brief Returns \c true if nothing has been modified.
+        bool empty() const { return !all_ && ranges_.empty(); }
+        /// \brief Clears all the recorded modifications.
+        void clear();
+
+        /// \brief Tests if the element \p index has been marked as modified.
+        bool contains(std::size_t index) const;
+
+        /**
+         * \brief The sorted and disjoint modified ranges.
+         * \note The result is meaningless if all() is \c true.
+         */
+        const std::vector<Range>& ranges() const { return ranges_; }
+
+        /// \brief The smallest range covering all modified ranges. It is [0, 0) if there is no modified range.
+        Range bounds() const;
+
+        /// \brief The total number of elements covered by the modified ranges.
+        std::size_t count() const;
+
+        /**
+         * \brief Restricts the modified ranges to [0, \p size). If all() is \c true, it is converted to the single
+         *      range [0, \p size).
+         */
+        void clip(std::size_t size);
+
+        /**
+         * \brief Merges the ranges separated by the smallest gaps until at most \p max_ranges ranges remain. This
+         *      bounds the number of buffer updates, e.g., when many scattered elements have been modified. The
+         *      default value is what drawables use before uploading the modified ranges of their buffers.
+         */
+        void coalesce(std::size_t max_ranges = 16);
+
+        /// \brief Sets the gap below which ranges are merged. It takes effect for ranges added later.
+        void set_merge_gap(std::size_t gap) { merge_gap_ = gap; }
+        /// \brief Returns the gap below which ranges are merged.
+        std::size_t merge_gap() const { return merge_gap_; }
+
+    private:
+        std::vector<Range> ranges_;
+        std::size_t merge_gap_;
+        bool all_;
+    };
+
+}
+
+#endif  // EASY3D_CORE_DIRTY_RANGES_H
@@ -32,6 +32,7 @@ namespace easy3d {
     Model::Model(const std::string& name /* = "unknown" */)
             : name_(name)
             , bbox_known_(false)
+            , geometry_revision_(0)
             , renderer_(nullptr)
             , manipulator_(nullptr)
     {
@@ -57,4 +58,43 @@ namespace easy3d {
         return bbox_;
     }
 
+
+    void Model::invalidate_bounding_box() {
+        bbox_known_ = false;
+        ++geometry_revision_;
+    }
+
+
+    void Model::mark_modified(const std::string& property, std::size_t begin, std::size_t end) {
+        if (begin >= end)
+            return;
+        modified_[property].add(begin, end);
+        if (property == "v:point")
+            invalidate_bounding_box();
+    }
+
+
+    void Model::mark_modified(const std::string& property) {
+        modified_[property].add_all();
+        if (property == "v:point")
+            invalidate_bounding_box();
+    }
+
+
+    const DirtyRanges* Model::modified_ranges(const std::string& property) const {
+        auto pos = modified_.find(property);
+        if (pos == modified_.end())
+            return nullptr;
+        return &pos->second;
+    }
+
+
+    void Model::property_stats(std::ostream &output) const {
+        const memory::Usage usage = memory_usage();
+        for (const auto &properties : usage.children) {
+            if (!properties.children.empty())
+                properties.print(output);
+        }
+    }
+
 }
@@ -30,8 +30,11 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 #include <easy3d/core/types.h>
+#include <easy3d/core/dirty_ranges.h>
+#include <easy3d/util/memory.h>
 
 
 namespace easy3d {
@@ -70,10 +73,20 @@ namespace easy3d {
 
         /**
          * \brief Invalidates the bounding box of the model. So when bounding_box() is called, the bounding box will be
-         * re-computed. This function is typically called when the geometry of a model is changed.
+         * re-computed. This function is typically called when the geometry of a model is changed. It also increases
+         * the geometry revision of the model.
+         * \see geometry_revision().
          */
         void invalidate_bounding_box();
 
+        /**
+         * \brief The revision of the geometry of the model.
+         * \details It increases each time the geometry is changed (i.e., invalidate_bounding_box() is called, directly
+         *      or by mark_modified("v:point") and Renderer::update()). Data derived from the points can be cached with
+         *      the revision it was computed for, e.g., the cells used for selection (see SelectionEngine).
+         */
+        std::size_t geometry_revision() const { return geometry_revision_; }
+
         /** \brief The vertices of the model. */
         virtual std::vector<vec3>& points() = 0;
         /** \brief The vertices of the model. */
@@ -82,8 +95,37 @@ namespace easy3d {
         /** \brief Tests if the model is empty. */
         bool empty() const { return points().empty(); };
 
-        /** \brief Prints the names of all properties to an output stream (e.g., std::cout). */
-        virtual void property_stats(std::ostream &output) const {}
+        /**
+         * \brief Records that the values of a property have changed for the elements in [\p begin, \p end).
+         * \details This allows the drawables of this model to upload only the modified parts of their buffers (see
+         *      Renderer::update_modified()), instead of rebuilding all buffers from scratch. Modifying "v:point" also
+         *      invalidates the bounding box. Use Renderer::update() instead if the topology has changed.
+         * \param property The name of the property, e.g., "v:point", "v:color".
+         */
+        void mark_modified(const std::string& property, std::size_t begin, std::size_t end);
+        /** \brief Records that the value of a property has changed for the element \p index. */
+        void mark_modified(const std::string& property, std::size_t index) { mark_modified(property, index, index + 1); }
+        /** \brief Records that the values of a property have changed for all elements. */
+        void mark_modified(const std::string& property);
+
+        /** \brief The modified ranges of a property, or \c nullptr if no modification has been recorded. */
+        const DirtyRanges* modified_ranges(const std::string& property) const;
+        /** \brief The modified ranges of all properties that have recorded modifications. */
+        const std::map<std::string, DirtyRanges>& modified_ranges() const { return modified_; }
+        /** \brief Clears the recorded modifications. This is done by the renderer once the drawables are updated. */
+        void clear_modified() { modified_.clear(); }
+
+        /**
+         * \brief Prints the properties and their memory usage to an output stream (e.g., std::cout).
+         * \details The properties are grouped by the type of the elements, e.g., vertex properties, face properties.
+         */
+        void property_stats(std::ostream &output) const;
+
+        /**
+         * \brief The memory used by the model, i.e., its properties grouped by the type of the elements.
+         * \details The GPU memory used for rendering the model is reported by Renderer::memory_usage().
+         */
+        virtual memory::Usage memory_usage() const { return memory::Usage(name_); }
 
         /**
          * \brief Sets the renderer of this model.
@@ -111,6 +153,9 @@ namespace easy3d {
 
         Box3		bbox_;
         bool		bbox_known_;
+        std::size_t geometry_revision_;
+
+        std::map<std::string, DirtyRanges> modified_;  // modified elements of each property
 
         Renderer* renderer_;         // for rendering
         Manipulator* manipulator_;   // for manipulation
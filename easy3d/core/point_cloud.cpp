@@ -134,33 +134,12 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
 
-    void PointCloud::property_stats(std::ostream& output) const
+    memory::Usage PointCloud::memory_usage() const
     {
-        std::vector<std::string> props;
-
-        props = model_properties();
-        if (!props.empty())
-        {
-            output << "model properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = vertex_properties();
-		if (!props.empty())
-		{
-			std::cout << "vertex properties:\n";
-			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
-		}
-
-		props = model_properties();
-		if (!props.empty())
-		{
-			std::cout << "model properties:\n";
-			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
-		}
+        memory::Usage usage(name());
+        usage.add(mprops_.memory_usage("model properties"));
+        usage.add(vprops_.memory_usage("vertex properties"));
+        return usage;
     }
 
 
@@ -348,65 +348,16 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
 
-    void PolyMesh::property_stats(std::ostream& output) const
+    memory::Usage PolyMesh::memory_usage() const
     {
-        std::vector<std::string> props;
-
-        props = model_properties();
-        if (!props.empty())
-        {
-            output << "model properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = vertex_properties();
-        if (!props.empty())
-        {
-            output << "vertex properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = edge_properties();
-        if (!props.empty())
-        {
-            output<< "edge properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = halfface_properties();
-        if (!props.empty())
-        {
-            output << "halfface properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = face_properties();
-        if (!props.empty())
-        {
-            output << "face properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = cell_properties();
-        if (!props.empty())
-        {
-            output << "cell properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-        props = model_properties();
-        if (!props.empty())
-        {
-            output << "model properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
+        memory::Usage usage(name());
+        usage.add(mprops_.memory_usage("model properties"));
+        usage.add(vprops_.memory_usage("vertex properties"));
+        usage.add(eprops_.memory_usage("edge properties"));
+        usage.add(hprops_.memory_usage("halfface properties"));
+        usage.add(fprops_.memory_usage("face properties"));
+        usage.add(cprops_.memory_usage("cell properties"));
+        return usage;
     }
 
 
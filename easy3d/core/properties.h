@@ -32,6 +32,8 @@
 #include <typeinfo>
 #include <cassert>
 
+#include <easy3d/util/memory.h>
+
 
 namespace easy3d {
 
@@ -80,6 +82,19 @@ namespace easy3d {
         /// Return the type_info of the property
         virtual const std::type_info& type() const = 0;
 
+        /// Return the number of elements.
+        virtual size_t size() const = 0;
+
+        /// Return the number of elements that can be held without reallocation.
+        virtual size_t capacity() const = 0;
+
+        /// Return the memory (in bytes) holding the elements. Memory owned by the elements themselves (e.g., the
+        /// elements of a std::vector<int> property) is not counted.
+        virtual size_t used_bytes() const = 0;
+
+        /// Return the memory (in bytes) allocated for the elements, i.e., including the unused capacity.
+        virtual size_t allocated_bytes() const = 0;
+
         /// Return the name of the property
         const std::string& name() const { return name_; }
 
@@ -191,6 +206,14 @@ namespace easy3d {
 
         virtual const std::type_info& type() const { return typeid(T); }
 
+        virtual size_t size() const { return data_.size(); }
+
+        virtual size_t capacity() const { return data_.capacity(); }
+
+        virtual size_t used_bytes() const { return data_.size() * sizeof(T); }
+
+        virtual size_t allocated_bytes() const { return data_.capacity() * sizeof(T); }
+
 
     public:
 
@@ -238,6 +261,21 @@ namespace easy3d {
         return nullptr;
     }
 
+    // std::vector<bool> stores one bit per element
+    template <>
+    inline size_t
+    PropertyArray<bool>::used_bytes() const
+    {
+        return (data_.size() + 7) / 8;
+    }
+
+    template <>
+    inline size_t
+    PropertyArray<bool>::allocated_bytes() const
+    {
+        return (data_.capacity() + 7) / 8;
+    }
+
 
 
     //== CLASS DEFINITION =========================================================
@@ -419,6 +457,19 @@ namespace easy3d {
             return names;
         }
 
+        // returns the memory used by the property arrays, with one child per property. The capacity is the
+        // number of elements that can be added without reallocating any array.
+        memory::Usage memory_usage(const std::string& name) const
+        {
+            memory::Usage usage(name, size_, parrays_.empty() ? size_ : parrays_[0]->capacity());
+            for (size_t i=0; i<parrays_.size(); ++i) {
+                const BasePropertyArray* p = parrays_[i];
+                usage.add(memory::Usage(p->name(), p->size(), p->capacity(), p->used_bytes(), p->allocated_bytes()));
+                usage.capacity = std::min(usage.capacity, p->capacity());
+            }
+            return usage;
+        }
+
 
         // add a property with name \c name and default value \c t
         template <class T> Property<T> add(const std::string& name, const T t=T())
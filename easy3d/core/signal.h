@@ -29,11 +29,153 @@
 
 
 #include <functional>
-#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
 
 
 namespace easy3d {
 
+    namespace internal {
+
+        struct ConnectionState;
+
+        /// The slots being called by the current thread.
+        inline std::vector<const ConnectionState *> &calls_in_this_thread() {
+            static thread_local std::vector<const ConnectionState *> calls;
+            return calls;
+        }
+
+        /// The state of a connection, shared by the signal and the connection handles.
+        struct ConnectionState {
+            ConnectionState() : connected(true), num_calls(0) {}
+            virtual ~ConnectionState() = default;
+            /// Marks the connection as disconnected, removes it from its signal (if the signal still exists), and
+            /// waits for the calls of the slot running in other threads.
+            virtual void disconnect() = 0;
+
+            /// Waits until the calls of the slot running in other threads have returned. The calls of the current
+            /// thread (i.e., the slot disconnects itself) are not waited for.
+            void wait_for_calls() const {
+                const auto &calls = calls_in_this_thread();
+                const auto own = static_cast<int>(std::count(calls.begin(), calls.end(), this));
+                while (num_calls.load() > own)
+                    std::this_thread::yield();
+            }
+
+            std::atomic<bool> connected;
+            std::atomic<int> num_calls;     // the number of calls of the slot being executed
+        };
+
+        /// Registers a call of a slot for its lifetime, such that disconnecting the slot waits for it.
+        class CallGuard {
+        public:
+            explicit CallGuard(ConnectionState *state) : state_(state) {
+                // sequentially consistent with the store to "connected" in disconnect(): either the call sees the
+                // slot disconnected, or the disconnection sees the call
+                state_->num_calls.fetch_add(1);
+                calls_in_this_thread().push_back(state_);
+            }
+            ~CallGuard() {
+                calls_in_this_thread().pop_back();
+                state_->num_calls.fetch_sub(1, std::memory_order_release);
+            }
+            bool connected() const { return state_->connected.load(); }
+        private:
+            CallGuard(const CallGuard &);
+            CallGuard &operator=(const CallGuard &);
+            ConnectionState *state_;
+        };
+    }
+
+
+    /**
+     * \brief A handle of a connection between a signal and a slot.
+     * \class Connection easy3d/core/signal.h
+     * \details Handles are cheap to copy, and destroying a handle does not disconnect the slot (see ScopedConnection).
+     *      A handle can safely outlive its signal. For compatibility with the code using the integer ids of the
+     *      connections, a handle converts to its id.
+     */
+    class Connection {
+    public:
+        Connection() : id_(0) {}
+        Connection(const std::weak_ptr<internal::ConnectionState> &state, int id) : state_(state), id_(id) {}
+
+        /// \brief Disconnects the slot. Thread-safe.
+        /// \details When this returns, the slot is not running in any other thread and it will not be called again.
+        ///     If the slot disconnects itself, the current call continues. Since this waits for the calls running
+        ///     in other threads, it must not be called while holding a lock that the slot acquires.
+        void disconnect() {
+            auto state = state_.lock();
+            if (state)
+                state->disconnect();
+        }
+
+        /// \brief Returns whether the slot is still connected.
+        bool connected() const {
+            auto state = state_.lock();
+            return state && state->connected.load(std::memory_order_acquire);
+        }
+
+        /// \brief The id of the connection (0 for an empty handle).
+        int id() const { return id_; }
+        operator int() const { return id_; }
+
+    private:
+        std::weak_ptr<internal::ConnectionState> state_;
+        int id_;
+    };
+
+
+    /**
+     * \brief A connection handle that disconnects the slot when it goes out of scope (RAII).
+     * \class ScopedConnection easy3d/core/signal.h
+     * \details It is movable but not copyable, e.g.,
+     *      \code
+     *          class Listener {
+     *              ScopedConnection connection_;   // disconnected when the listener is destroyed
+     *          public:
+     *              explicit Listener(Camera* camera) : connection_(camera->frame_modified.connect(this, &Listener::update)) {}
+     *              void update();
+     *          };
+     *      \endcode
+     */
+    class ScopedConnection : public Connection {
+    public:
+        ScopedConnection() = default;
+        ScopedConnection(const Connection &connection) : Connection(connection) {}
+        ScopedConnection(ScopedConnection &&other) noexcept : Connection(other) { other.release(); }
+        ~ScopedConnection() { disconnect(); }
+
+        ScopedConnection &operator=(ScopedConnection &&other) noexcept {
+            if (this != &other) {
+                disconnect();
+                Connection::operator=(other);
+                other.release();
+            }
+            return *this;
+        }
+        ScopedConnection &operator=(const Connection &connection) {
+            disconnect();
+            Connection::operator=(connection);
+            return *this;
+        }
+
+        ScopedConnection(const ScopedConnection &) = delete;
+        ScopedConnection &operator=(const ScopedConnection &) = delete;
+
+        /// \brief Releases the connection without disconnecting it.
+        Connection release() {
+            Connection connection = *this;
+            Connection::operator=(Connection());
+            return connection;
+        }
+    };
+
+
     /**
      * \brief A light-weight implementation of the simple signal-slot mechanism.
      * \class Signal easy3d/core/signal.h
@@ -47,6 +189,25 @@ namespace easy3d {
      *      viewer's update() function. So in Easy3D, the viewer's update function is connected to the camera's
      *      corresponding signal.
      *
+     *      Signals are thread-safe: they can be sent from any thread while slots are connected and disconnected in
+     *      other threads. The slots are kept in an immutable list that is replaced (copy-on-write) on every
+     *      connection and disconnection, and send() calls the slots of the list it took at its beginning (with
+     *      std::atomic_load, which may use an internal lock of the standard library). So a slot connected during a
+     *      send() is not called by it. Disconnecting a slot waits for its calls running in other threads, so once
+     *      disconnect() returns, the slot is neither running nor called any more, and the objects it uses can be
+     *      destroyed. Sending a signal without any slot costs a single atomic load.
+     *
+     *      A slot can also be connected with a \c Dispatcher, which makes the connection queued: instead of calling
+     *      the slot, send() passes the call (with copies of the arguments) to the dispatcher, which executes it
+     *      later, typically on the thread running an event loop. For example, a worker thread can safely notify
+     *      the viewer via the posting queue of the TimerService (drained by the Viewer in its main loop):
+     *      \code
+     *          loader.progress.connect(viewer, &Viewer::update, [](std::function<void()> call) {
+     *              TimerService::instance()->post(std::move(call));
+     *          });
+     *      \endcode
+     *      A queued call whose slot has been disconnected in the meantime is not executed.
+     *
      * \see A more powerful implementation [sigslot](https://github.com/palacaze/sigslot) based on C++14.
      *
      * \example Test_Signal  \include test_signal.cpp
@@ -54,25 +215,28 @@ namespace easy3d {
 
     template<typename... Args>
     class Signal {
+    public:
+        /// A function that receives the call of a queued slot and decides where and when to execute it.
+        typedef std::function<void(std::function<void()>)> Dispatcher;
 
     public:
-        Signal() = default;
+        Signal() : core_(std::make_shared<Core>()) {}
         ~Signal() { disconnect_all(); }
 
         /// \brief Copy constructor and assignment create a new signal.
-        Signal(Signal const & /*unused*/) {}
+        Signal(Signal const & /*unused*/) : Signal() {}
 
         /// \brief Move constructor.
-        Signal(Signal &&other) noexcept:
-                slots_(std::move(other.slots_)),
-                current_id_(other.current_id_) {
+        Signal(Signal &&other) noexcept: core_(std::move(other.core_)) {
+            other.core_ = std::make_shared<Core>();
         }
 
         /// \brief The assignment operator
         Signal &operator=(Signal &&other) noexcept {
             if (this != &other) {
-                slots_ = std::move(other.slots_);
-                current_id_ = other.current_id_;
+                disconnect_all();
+                core_ = std::move(other.core_);
+                other.core_ = std::make_shared<Core>();
             }
             return *this;
         }
@@ -94,9 +258,18 @@ namespace easy3d {
          *      \endcode
          *     Or use the helper function \c overload for a lighter syntax.
          */
-        int connect(std::function<void(Args...)> const &slot) {
-            slots_.insert(std::make_pair(++current_id_, slot));
-            return current_id_;
+        Connection connect(std::function<void(Args...)> const &slot) {
+            return core_->add(core_, slot, Dispatcher());
+        }
+
+        /**
+         * \brief Connects a function to this signal through a queued connection.
+         * \details Each time the signal is sent, the call of \p slot (with copies of the arguments) is passed to
+         *      \p dispatcher, which executes it later, e.g., in an event loop. Since the arguments are copied, a slot
+         *      taking non-const references will not see the changes of the sender.
+         */
+        Connection connect(std::function<void(Args...)> const &slot, Dispatcher const &dispatcher) {
+            return core_->add(core_, slot, dispatcher);
         }
 
         /**
@@ -112,12 +285,20 @@ namespace easy3d {
          *     Or use the helper function \c overload for a lighter syntax.
          */
         template<typename Class>
-        int connect(Class *inst, void (Class::*func)(Args...)) {
+        Connection connect(Class *inst, void (Class::*func)(Args...)) {
             return connect([=](Args... args) {
                 (inst->*func)(args...);
             });
         }
 
+        /// \brief Connects a member function of an object to this signal through a queued connection.
+        template<typename Class>
+        Connection connect(Class *inst, void (Class::*func)(Args...), Dispatcher const &dispatcher) {
+            return connect([=](Args... args) {
+                (inst->*func)(args...);
+            }, dispatcher);
+        }
+
         /**
          * \brief Connects a const member function of an object to this signal.
          * \details The returned value can be used to disconnect the function from this signal, e.g.,
@@ -131,58 +312,184 @@ namespace easy3d {
          *     Or use the helper function \c overload for a lighter syntax.
          */
         template<typename Class>
-        int connect(Class *inst, void (Class::*func)(Args...) const) {
+        Connection connect(Class *inst, void (Class::*func)(Args...) const) {
             return connect([=](Args... args) {
                 (inst->*func)(args...);
             });
         }
 
+        /// \brief Connects a const member function of an object to this signal through a queued connection.
+        template<typename Class>
+        Connection connect(Class *inst, void (Class::*func)(Args...) const, Dispatcher const &dispatcher) {
+            return connect([=](Args... args) {
+                (inst->*func)(args...);
+            }, dispatcher);
+        }
+
         /**
          * \brief Connects this signal to another signal \p receiver.
          * \details Upon return, the emission of this signal will trigger \p receiver to emit.
          * The returned value can be used to disconnect the connected signal.
          */
-        int connect(Signal<Args...> *receiver) {
+        Connection connect(Signal<Args...> *receiver) {
             return connect(receiver, &Signal<Args...>::send);
         }
 
         /// \brief Disconnects a previously connected function.
+        /// \details It waits for the calls of the function running in other threads (see Connection::disconnect()).
         void disconnect(int id) {
-            slots_.erase(id);
+            core_->remove(id);
         }
 
         /// \brief Disconnects all previously connected functions.
+        /// \details It waits for the calls of the functions running in other threads (see Connection::disconnect()).
         void disconnect_all() {
-            slots_.clear();
+            core_->remove_all();
+        }
+
+        /// \brief Returns whether no function is connected.
+        bool empty() const {
+            return core_->num_slots.load(std::memory_order_acquire) == 0;
         }
 
         /// \brief Calls all connected functions.
         void send(Args... p) {
-            for (auto const &it : slots_) {
-                it.second(p...);
+            if (core_->num_slots.load(std::memory_order_acquire) == 0)
+                return;
+            const auto slots = std::atomic_load(&core_->slots);
+            for (auto const &slot : *slots) {
+                call(slot, p...);
             }
         }
 
         /// \brief Calls all connected functions except for one.
         void send_for_all_but_one(int excludedConnectionID, Args... p) {
-            for (auto const &it : slots_) {
-                if (it.first != excludedConnectionID) {
-                    it.second(p...);
+            if (core_->num_slots.load(std::memory_order_acquire) == 0)
+                return;
+            const auto slots = std::atomic_load(&core_->slots);
+            for (auto const &slot : *slots) {
+                if (slot->id != excludedConnectionID) {
+                    call(slot, p...);
                 }
             }
         }
 
         /// \brief Calls only one connected function.
         void emit_for(int connectionID, Args... p) {
-            auto const &it = slots_.find(connectionID);
-            if (it != slots_.end()) {
-                it->second(p...);
+            if (core_->num_slots.load(std::memory_order_acquire) == 0)
+                return;
+            const auto slots = std::atomic_load(&core_->slots);
+            for (auto const &slot : *slots) {
+                if (slot->id == connectionID) {
+                    call(slot, p...);
+                    return;
+                }
+            }
+        }
+
+    private:
+        struct Core;
+
+        struct Slot : internal::ConnectionState {
+            Slot(const std::weak_ptr<Core> &c, int i, std::function<void(Args...)> const &f, Dispatcher const &d)
+                    : core(c), id(i), function(f), dispatcher(d) {}
+
+            void disconnect() override {
+                connected.store(false);
+                auto c = core.lock();
+                if (c)
+                    c->remove(id);
+                wait_for_calls();
+            }
+
+            std::weak_ptr<Core> core;
+            int id;
+            std::function<void(Args...)> function;
+            Dispatcher dispatcher;      // empty for a direct connection
+        };
+        typedef std::vector<std::shared_ptr<Slot> > SlotList;
+
+        // The slots of a signal. It is shared with the slots, so a connection handle can remove its slot even if
+        // the signal has been moved.
+        struct Core {
+            Core() : slots(std::make_shared<SlotList>()), num_slots(0), current_id(0) {}
+
+            Connection add(const std::shared_ptr<Core> &self, std::function<void(Args...)> const &function,
+                           Dispatcher const &dispatcher) {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto slot = std::make_shared<Slot>(self, ++current_id, function, dispatcher);
+                auto copy = std::make_shared<SlotList>(*std::atomic_load(&slots));  // copy-on-write
+                copy->push_back(slot);
+                publish(copy);
+                return Connection(slot, slot->id);
+            }
+
+            void remove(int id) {
+                std::shared_ptr<Slot> removed;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    const auto current = std::atomic_load(&slots);
+                    auto copy = std::make_shared<SlotList>();
+                    copy->reserve(current->size());
+                    for (const auto &slot : *current) {
+                        if (slot->id == id)
+                            removed = slot;
+                        else
+                            copy->push_back(slot);
+                    }
+                    if (!removed)
+                        return;
+                    removed->connected.store(false);
+                    publish(copy);
+                }
+                // the calls are waited for without the lock, so the slots running can still connect and disconnect
+                removed->wait_for_calls();
+            }
+
+            void remove_all() {
+                std::shared_ptr<const SlotList> removed;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    removed = std::atomic_load(&slots);
+                    for (const auto &slot : *removed)
+                        slot->connected.store(false);
+                    publish(std::make_shared<SlotList>());
+                }
+                for (const auto &slot : *removed)
+                    slot->wait_for_calls();
+            }
+
+            // replaces the list of slots (the mutex must be locked)
+            void publish(const std::shared_ptr<const SlotList> &list) {
+                std::atomic_store(&slots, list);
+                num_slots.store(list->size(), std::memory_order_release);
+            }
+
+            std::shared_ptr<const SlotList> slots;  // immutable, accessed with atomic operations only
+            std::atomic<std::size_t> num_slots;
+            std::mutex mutex;                       // serializes the modifications of the slots
+            int current_id;
+        };
+
+        static void call(const std::shared_ptr<Slot> &slot, Args... p) {
+            if (!slot->dispatcher) {
+                internal::CallGuard guard(slot.get());
+                if (guard.connected())
+                    slot->function(p...);
+            }
+            else if (slot->connected.load(std::memory_order_acquire)) {
+                // the arguments are captured by copy, and the slot is checked again when the call is executed
+                std::shared_ptr<Slot> s = slot;
+                slot->dispatcher([s, p...]() mutable {
+                    internal::CallGuard guard(s.get());
+                    if (guard.connected())
+                        s->function(p...);
+                });
             }
         }
 
     private:
-        std::unordered_map<int, std::function<void(Args...)>> slots_;
-        int current_id_{0};
+        std::shared_ptr<Core> core_;
     };
 
 
@@ -199,7 +506,7 @@ namespace easy3d {
      *     Or use the helper function \c overload for a lighter syntax.
      */
     template<typename SIGNAL, typename FUNCTION>
-    inline int connect(SIGNAL *signal, FUNCTION const &slot) {
+    inline Connection connect(SIGNAL *signal, FUNCTION const &slot) {
         return signal->connect(slot);
     }
 
@@ -216,7 +523,7 @@ namespace easy3d {
      *     Or use the helper function \c overload for a lighter syntax.
      */
     template<typename SIGNAL, typename CLASS, typename FUNCTION>
-    inline int connect(SIGNAL *signal, CLASS *inst, FUNCTION const &slot) {
+    inline Connection connect(SIGNAL *signal, CLASS *inst, FUNCTION const &slot) {
         return signal->connect(inst, slot);
     }
 
@@ -226,7 +533,7 @@ namespace easy3d {
      * The returned value can be used to disconnect the connected signal.
      */
     template<typename... Args>
-    int connect(Signal<Args...> *sender, Signal<Args...> *receiver) {
+    Connection connect(Signal<Args...> *sender, Signal<Args...> *receiver) {
         return sender->connect(receiver);
     }
 
@@ -402,57 +402,15 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
 
-    void SurfaceMesh::property_stats(std::ostream& output) const
+    memory::Usage SurfaceMesh::memory_usage() const
     {
-        std::vector<std::string> props;
-
-        props = model_properties();
-        if (!props.empty())
-        {
-            output << "model properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-        }
-
-		props = vertex_properties();
-		if (!props.empty())
-		{
-            output << "vertex properties:\n";
-			for (const auto& p : props)
-                output << "\t" << p << std::endl;
-		}
-
-		props = halfedge_properties();
-		if (!props.empty())
-		{
-            output << "halfedge properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-		}
-
-		props = edge_properties();
-		if (!props.empty())
-		{
-            output<< "edge properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-		}
-
-		props = face_properties();
-		if (!props.empty())
-		{
-            output << "face properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-		}
-
-		props = model_properties();
-		if (!props.empty())
-		{
-            output << "model properties:\n";
-            for (const auto& p : props)
-                output << "\t" << p << std::endl;
-		}
+        memory::Usage usage(name());
+        usage.add(mprops_.memory_usage("model properties"));
+        usage.add(vprops_.memory_usage("vertex properties"));
+        usage.add(hprops_.memory_usage("halfedge properties"));
+        usage.add(eprops_.memory_usage("edge properties"));
+        usage.add(fprops_.memory_usage("face properties"));
+        return usage;
     }
 
 
@@ -596,7 +554,7 @@ namespace easy3d {
         {
             if ( !is_border(vertices[i]) )
             {
-                LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex vertex (" << vertices[i] << "). " << COUNTER;
+                LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex vertex (" << vertices[i] << ").";
 
 #ifndef NDEBUG
                 static bool show = true;
@@ -616,7 +574,7 @@ namespace easy3d {
 
             if (!is_new[i] && !is_border(halfedges[i]))
             {
-                LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edge (" << vertices[i] << " -> " << vertices[ii] << "). " << COUNTER;
+                LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edge (" << vertices[i] << " -> " << vertices[ii] << ").";
 
 #ifndef NDEBUG
                 static bool show = true;
@@ -664,7 +622,7 @@ namespace easy3d {
                     // ok ?
                     if (boundary_next == inner_next)
                     {
-                        LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: patch re-linking failed (" << vertices << "). " << COUNTER;
+                        LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: patch re-linking failed (" << vertices << ").";
 #ifndef NDEBUG
                         static bool show = true;
                         if (show) {
@@ -685,7 +643,7 @@ namespace easy3d {
                     if (!boundary_prev.is_valid() || !patch_start.is_valid() || !patch_end.is_valid() ||
                         !boundary_next.is_valid() || !inner_prev.is_valid() || !inner_next.is_valid())
                     {
-                        LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << "). " << COUNTER;
+                        LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << ").";
                         static bool show = true;
                         if (show) {
                             LOG(ERROR) << "\tvertices of the face: ";
@@ -745,7 +703,7 @@ namespace easy3d {
 #ifndef NDEBUG
                         if (!boundary_prev.is_valid() || !outer_next.is_valid())
                         {
-                            LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << "). " << COUNTER;
+                            LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << ").";
                             static bool show = true;
                             if (show) {
                                 LOG(ERROR) << "\tvertices of the face: ";
@@ -764,7 +722,7 @@ namespace easy3d {
 #ifndef NDEBUG
                         if (!outer_prev.is_valid() || !boundary_next.is_valid())
                         {
-                            LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << "). " << COUNTER;
+                            LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << ").";
                             static bool show = true;
                             if (show) {
                                 LOG(ERROR) << "\tvertices of the face: ";
@@ -785,7 +743,7 @@ namespace easy3d {
 #ifndef NDEBUG
                             if (!outer_prev.is_valid() || !outer_next.is_valid())
                             {
-                                LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << "). " << COUNTER;
+                                LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << ").";
                                 static bool show = true;
                                 if (show) {
                                     LOG(ERROR) << "\tvertices of the face: ";
@@ -804,7 +762,7 @@ namespace easy3d {
 #ifndef NDEBUG
                             if (!boundary_prev.is_valid() || !outer_next.is_valid() || !outer_prev.is_valid() || !boundary_next.is_valid())
                             {
-                                LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << "). " << COUNTER;
+                                LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << ").";
                                 static bool show = true;
                                 if (show) {
                                     LOG(ERROR) << "\tvertices of the face: ";
@@ -824,7 +782,7 @@ namespace easy3d {
 #ifndef NDEBUG
                 if (!inner_prev.is_valid() || !inner_next.is_valid())
                 {
-                    LOG_N_TIMES(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << "). " << COUNTER;
+                    LOG_FIRST_N(3, ERROR) << "SurfaceMesh::add_face: complex edges (" << vertices << ").";
                     static bool show = true;
                     if (show) {
                         LOG(ERROR) << "\tvertices of the face: ";
@@ -1604,8 +1604,8 @@ namespace easy3d {
             return mprops_.properties();
         }
 
-        /// prints the names of all properties to an output stream (e.g., std::cout).
-        void property_stats(std::ostream &output) const;
+        /// returns the memory used by the properties, grouped by the type of the elements.
+        memory::Usage memory_usage() const override;
 
         //@}
 
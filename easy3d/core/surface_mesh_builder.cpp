@@ -27,9 +27,12 @@
 #include <easy3d/core/surface_mesh_builder.h>
 
 #include <set>
+#include <atomic>
+#include <algorithm>
 
 #include <easy3d/util/logging.h>
 #include <easy3d/util/file_system.h>
+#include <easy3d/util/thread_pool.h>
 
 
 namespace easy3d {
@@ -145,7 +148,7 @@ namespace easy3d {
         std::size_t count(0);
         for (auto v : mesh_->vertices()) {
             if (!mesh_->is_manifold(v)) {
-                LOG_N_TIMES(3, ERROR) << "vertex " << v << " is not manifold. " << COUNTER;
+                LOG_FIRST_N(3, ERROR) << "vertex " << v << " is not manifold.";
                 ++count;
             }
         }
@@ -238,7 +241,7 @@ namespace easy3d {
 
         // Check #1: a face has less than 3 vertices
         if (n < 3) {
-            LOG_N_TIMES(3, ERROR) << "face has less than 3 vertices. " << COUNTER;
+            LOG_FIRST_N(3, ERROR) << "face has less than 3 vertices.";
             ++num_faces_less_three_vertices_;
             return false;
         }
@@ -246,7 +249,7 @@ namespace easy3d {
         // Check #2; a face has duplicate vertices
         for (std::size_t s = 0, t = 1; s < n; ++s, ++t, t %= n) {
             if (vertices[s] == vertices[t]) {
-                LOG_N_TIMES(3, ERROR) << "face has duplicate vertices. " << COUNTER;
+                LOG_FIRST_N(3, ERROR) << "face has duplicate vertices.";
                 ++num_faces_duplicate_vertices;
                 return false;
             }
@@ -255,8 +258,8 @@ namespace easy3d {
         // Check #3; a face has out-of-range vertices
         for (auto v : vertices) {
             if (v.idx() < 0 || v.idx() >= static_cast<int>(mesh_->n_vertices())) {
-                LOG_N_TIMES(3, ERROR) << "face has out-of-range vertices (number of vertices is "
-                                      << mesh_->n_vertices() << "). " << COUNTER;
+                LOG_FIRST_N(3, ERROR) << "face has out-of-range vertices (number of vertices is "
+                                      << mesh_->n_vertices() << ").";
                 ++num_faces_out_of_range_vertices_;
                 return false;
             }
@@ -345,7 +348,7 @@ namespace easy3d {
             }
         } else {
             ++num_faces_unknown_topology_;
-            LOG_N_TIMES(3, ERROR) << "failed adding face. " << COUNTER;
+            LOG_FIRST_N(3, ERROR) << "failed adding face.";
         }
 
         return face;
@@ -363,6 +366,193 @@ namespace easy3d {
     }
 
 
+    std::vector<SurfaceMesh::Face> SurfaceMeshBuilder::add_faces(const std::vector<Vertex> &vertices,
+                                                                 const std::vector<unsigned int> &sizes) {
+        std::vector<Face> faces(sizes.size());
+
+        std::vector<std::size_t> offsets(sizes.size() + 1, 0);
+        for (std::size_t i = 0; i < sizes.size(); ++i)
+            offsets[i + 1] = offsets[i] + sizes[i];
+        if (offsets.back() != vertices.size()) {
+            LOG(ERROR) << "the face sizes (" << offsets.back() << " vertices in total) do not match the number of "
+                       << "vertices (" << vertices.size() << ")";
+            return faces;
+        }
+
+        if (add_faces_in_bulk(vertices, offsets)) {
+            for (std::size_t i = 0; i < faces.size(); ++i)
+                faces[i] = Face(static_cast<int>(i));
+            return faces;
+        }
+
+        std::vector<Vertex> face;
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            face.assign(vertices.begin() + offsets[i], vertices.begin() + offsets[i + 1]);
+            faces[i] = add_face(face);
+        }
+        return faces;
+    }
+
+
+    bool SurfaceMeshBuilder::add_faces_in_bulk(const std::vector<Vertex> &vertices,
+                                               const std::vector<std::size_t> &offsets) {
+        if (mesh_->faces_size() > 0 || mesh_->halfedges_size() > 0)
+            return false;
+
+        const int num_faces = static_cast<int>(offsets.size()) - 1;
+        const int num_corners = static_cast<int>(vertices.size());
+        const int num_vertices = static_cast<int>(mesh_->vertices_size());
+        if (num_faces <= 0)
+            return false;
+
+        // the corner following corner c in its face f
+        auto next_corner = [&offsets](int f, int c) -> int {
+            return (c + 1 < static_cast<int>(offsets[f + 1])) ? c + 1 : static_cast<int>(offsets[f]);
+        };
+
+        // Step 1: the faces must have at least 3 vertices, which are in range and distinct.
+        std::atomic<bool> valid(true);
+        parallel_for(0, num_faces, [&](int f) {
+            const std::size_t first = offsets[f], last = offsets[f + 1];
+            if (last - first < 3) {
+                valid = false;
+                return;
+            }
+            for (std::size_t c = first; c < last; ++c) {
+                if (vertices[c].idx() < 0 || vertices[c].idx() >= num_vertices) {
+                    valid = false;
+                    return;
+                }
+            }
+            if (last - first <= 16) { // most faces are small
+                for (std::size_t c = first; c < last; ++c) {
+                    if (std::find(vertices.begin() + c + 1, vertices.begin() + last, vertices[c]) != vertices.begin() + last) {
+                        valid = false;
+                        return;
+                    }
+                }
+            } else {
+                std::vector<Vertex> ids(vertices.begin() + first, vertices.begin() + last);
+                std::sort(ids.begin(), ids.end());
+                if (std::adjacent_find(ids.begin(), ids.end()) != ids.end())
+                    valid = false;
+            }
+        });
+        if (!valid)
+            return false;
+
+        // the target of each corner, i.e., the vertex of the next corner in the face
+        std::vector<int> target(num_corners);
+        parallel_for(0, num_faces, [&](int f) {
+            for (int c = static_cast<int>(offsets[f]); c < static_cast<int>(offsets[f + 1]); ++c)
+                target[c] = vertices[next_corner(f, c)].idx();
+        });
+
+        // Step 2: the corners grouped by their vertices (i.e., the corners are the directed edges leaving the
+        // vertices) and sorted by their targets, to find the opposite corner of each corner. Each directed edge must be
+        // used by at most one face, otherwise the mesh has non-manifold edges or inconsistently oriented faces.
+        std::vector<int> start(num_vertices + 1, 0);
+        for (int c = 0; c < num_corners; ++c)
+            ++start[vertices[c].idx() + 1];
+        for (int v = 0; v < num_vertices; ++v)
+            start[v + 1] += start[v];
+        std::vector<int> outgoing(num_corners);
+        {
+            std::vector<int> pos(start.begin(), start.end() - 1);
+            for (int c = 0; c < num_corners; ++c)
+                outgoing[pos[vertices[c].idx()]++] = c;
+        }
+        auto by_target = [&target](int a, int b) -> bool { return target[a] < target[b]; };
+        parallel_for(0, num_vertices, [&](int v) {
+            const auto begin = outgoing.begin() + start[v], end = outgoing.begin() + start[v + 1];
+            std::sort(begin, end, by_target);
+            for (auto it = begin; it != end && it + 1 != end; ++it) {
+                if (target[*it] == target[*(it + 1)])
+                    valid = false;
+            }
+        });
+        if (!valid)
+            return false;
+
+        std::vector<int> opposite(num_corners, -1);
+        parallel_for(0, num_corners, [&](int c) {
+            const int s = vertices[c].idx(), t = target[c];
+            const auto begin = outgoing.begin() + start[t], end = outgoing.begin() + start[t + 1];
+            const auto pos = std::lower_bound(begin, end, s, [&target](int corner, int v) { return target[corner] < v; });
+            if (pos != end && target[*pos] == s)
+                opposite[c] = *pos;
+        });
+        std::vector<int>().swap(outgoing);
+        std::vector<int>().swap(start);
+
+        // Step 3: the boundary halfedge leaving each vertex, i.e., the opposite of a corner without opposite corner
+        // that points to the vertex. A vertex on more than one boundary is non-manifold.
+        std::vector<int> boundary_corner(num_vertices, -1);
+        for (int c = 0; c < num_corners; ++c) {
+            if (opposite[c] >= 0)
+                continue;
+            if (boundary_corner[target[c]] >= 0)
+                return false;
+            boundary_corner[target[c]] = c;
+        }
+
+        // ---------------------------------------------------------------------------------------------------------
+
+        // Now the connectivity can be built. Each pair of opposite corners makes an edge, and so does each corner
+        // without opposite corner (with a boundary halfedge).
+        std::vector<int> halfedge(num_corners, -1);
+        int num_edges = 0;
+        for (int c = 0; c < num_corners; ++c) {
+            if (opposite[c] < 0)
+                halfedge[c] = 2 * num_edges++;
+            else if (c < opposite[c]) {
+                halfedge[c] = 2 * num_edges;
+                halfedge[opposite[c]] = 2 * num_edges + 1;
+                ++num_edges;
+            }
+        }
+        mesh_->resize(num_vertices, num_edges, num_faces);
+
+        // the halfedges of the faces. The halfedge of a face points to its first vertex (as SurfaceMesh::add_face()).
+        parallel_for(0, num_faces, [&](int f) {
+            const int first = static_cast<int>(offsets[f]), last = static_cast<int>(offsets[f + 1]);
+            for (int c = first; c < last; ++c) {
+                const int n = next_corner(f, c);
+                const Halfedge h(halfedge[c]);
+                mesh_->set_target(h, Vertex(target[c]));
+                mesh_->set_face(h, Face(f));
+                mesh_->set_next(h, Halfedge(halfedge[n]));
+            }
+            mesh_->set_halfedge(Face(f), Halfedge(halfedge[last - 1]));
+        });
+
+        // the boundary halfedges. Each vertex has as many incoming as outgoing boundary halfedges, i.e., at most one.
+        parallel_for(0, num_vertices, [&](int v) {
+            const int c = boundary_corner[v];
+            if (c < 0)
+                return;
+            const Halfedge h = mesh_->opposite(Halfedge(halfedge[c]));  // from v to the vertex of corner c
+            mesh_->set_target(h, vertices[c]);
+            const int next = boundary_corner[vertices[c].idx()];
+            DLOG_IF(next < 0, FATAL) << "vertex " << vertices[c] << " has no outgoing boundary halfedge";
+            mesh_->set_next(h, mesh_->opposite(Halfedge(halfedge[next])));
+        });
+
+        // the outgoing halfedges of the vertices (boundary ones for boundary vertices)
+        std::vector<int> out(num_vertices, -1);
+        for (int c = 0; c < num_corners; ++c)
+            out[vertices[c].idx()] = halfedge[c];
+        parallel_for(0, num_vertices, [&](int v) {
+            if (boundary_corner[v] >= 0)
+                mesh_->set_out_halfedge(Vertex(v), mesh_->opposite(Halfedge(halfedge[boundary_corner[v]])));
+            else if (out[v] >= 0)
+                mesh_->set_out_halfedge(Vertex(v), Halfedge(out[v]));
+        });
+
+        return true;
+    }
+
+
     SurfaceMesh::Vertex SurfaceMeshBuilder::get(Vertex v) {
         auto pos = copied_vertices_.find(v);
         if (pos == copied_vertices_.end()) { // no copies
@@ -102,6 +102,19 @@ namespace easy3d {
          */
         Face add_quad(Vertex v1, Vertex v2, Vertex v3, Vertex v4);
 
+        /**
+         * @brief Add a set of faces to the mesh at once.
+         * @details If the mesh has no faces yet and the faces are edge-manifold and consistently oriented, the
+         *      connectivity is built in bulk (in parallel), which is much faster than adding the faces one by one.
+         *      Otherwise, the faces are added one by one using add_face(), which resolves the non-manifoldness.
+         *      The halfedge of each added face points to its first vertex in both cases.
+         * @param vertices The vertices of all faces, face after face.
+         * @param sizes The number of vertices of each face.
+         * @return The added faces, in the same order as given. A face is invalid if it could not be added.
+         * @related add_face().
+         */
+        std::vector<Face> add_faces(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &sizes);
+
         /**
          * @brief Finalize surface construction. Must be called at the end of the surface construction and used in
          *        pair with begin_surface() at the beginning of surface mesh construction.
@@ -128,6 +141,12 @@ namespace easy3d {
         //  - one of the vertex is out-of-range.
         bool vertices_valid(const std::vector<Vertex> &vertices);
 
+        // Build the connectivity of a set of faces in bulk. The vertices of face i are vertices[offsets[i]] to
+        // vertices[offsets[i + 1] - 1]. This requires that the mesh has no faces yet, the faces have no duplicate or
+        // out-of-range vertices, each directed edge is used by at most one face, and each vertex is on at most one
+        // boundary. Return false (without modifying the mesh) if the requirements are not met.
+        bool add_faces_in_bulk(const std::vector<Vertex> &vertices, const std::vector<std::size_t> &offsets);
+
         // Copy a vertex v and its attributes.
         // Return the new vertex.
         Vertex copy_vertex(Vertex v);
@@ -26,6 +26,9 @@
 #include <easy3d/core/polygon.h>
 #include <easy3d/core/constant.h>
 
+#include <cstdint>
+#include <cstring>
+
 
 /**
  * Gathers different basic types for geometric operations.
@@ -58,6 +61,11 @@ namespace easy3d {
     /// \brief A 4D point/vector of \p int32_t type.
     typedef Vec<4, int32_t> ivec4;
 
+    /// \brief A 3D vector of 8-bit unsigned integers, e.g., a compact RGB color with components in [0, 255].
+    typedef Vec<3, uint8_t> u8vec3;
+    /// \brief A 3D vector of half-precision floating point numbers, stored as their 16-bit IEEE 754 bit patterns.
+    typedef Vec<3, uint16_t> hvec3;
+
     /// \brief A 2 by 2 matrix of \p float type.
     typedef Mat2<float> mat2;
     /// \brief A 3 by 3 matrix of \p float type.
@@ -345,6 +353,87 @@ namespace easy3d {
             b = (value & 0xff);
             a = (value >> 24);
         }
+
+        /// \brief Packs an RGB color (each component in the range [0, 1]) into 8 bits per component.
+        inline u8vec3 pack(const vec3 &c) {
+            return u8vec3(
+                    static_cast<uint8_t>(std::min(std::max(c.x, 0.0f), 1.0f) * 255.0f + 0.5f),
+                    static_cast<uint8_t>(std::min(std::max(c.y, 0.0f), 1.0f) * 255.0f + 0.5f),
+                    static_cast<uint8_t>(std::min(std::max(c.z, 0.0f), 1.0f) * 255.0f + 0.5f)
+            );
+        }
+
+        /// \brief Unpacks an RGB color stored in 8 bits per component (each component in the range [0, 1]).
+        inline vec3 unpack(const u8vec3 &c) {
+            return vec3(c.x / 255.0f, c.y / 255.0f, c.z / 255.0f);
+        }
+    }
+
+
+    /// \brief Conversion between single-precision and half-precision (i.e., 16-bit IEEE 754) floating point numbers.
+    /// \details Half floats have 11 bits of precision (i.e., about 3 decimal digits) and a range of +-65504, which is
+    ///     sufficient for, e.g., unit normals.
+    namespace half {
+
+        /// \brief Converts a float into a half float (rounded to the nearest even).
+        inline uint16_t from_float(float value) {
+            uint32_t f;
+            std::memcpy(&f, &value, sizeof(f));
+            const uint32_t sign = f & 0x80000000u;
+            f ^= sign;
+
+            uint32_t h;
+            if (f >= (143u << 23))  // overflow (larger than the largest half), Inf, or NaN
+                h = (f > (255u << 23)) ? 0x7e00 : 0x7c00;
+            else if (f < (113u << 23)) { // subnormal half or zero
+                // aligns the 10 mantissa bits at the bottom of a float (the addition does the rounding)
+                const uint32_t magic_bits = 126u << 23;
+                float magic, v;
+                std::memcpy(&magic, &magic_bits, sizeof(magic));
+                std::memcpy(&v, &f, sizeof(v));
+                v += magic;
+                std::memcpy(&h, &v, sizeof(h));
+                h -= magic_bits;
+            } else {
+                const uint32_t mantissa_odd = (f >> 13) & 1;
+                f += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff + mantissa_odd; // re-bias the exponent and round
+                h = f >> 13;
+            }
+            return static_cast<uint16_t>(h | (sign >> 16));
+        }
+
+        /// \brief Converts a half float into a float.
+        inline float to_float(uint16_t value) {
+            const uint32_t shifted_exp = 0x7c00u << 13;
+            uint32_t f = (value & 0x7fffu) << 13;    // exponent and mantissa
+            const uint32_t exp = shifted_exp & f;
+            f += (127u - 15u) << 23;                // re-bias the exponent
+            if (exp == shifted_exp)                 // Inf or NaN
+                f += (128u - 16u) << 23;
+            else if (exp == 0) {                    // zero or subnormal: renormalize
+                f += 1u << 23;
+                const uint32_t magic_bits = 113u << 23;
+                float magic, v;
+                std::memcpy(&magic, &magic_bits, sizeof(magic));
+                std::memcpy(&v, &f, sizeof(v));
+                v -= magic;
+                std::memcpy(&f, &v, sizeof(f));
+            }
+            f |= static_cast<uint32_t>(value & 0x8000u) << 16;
+            float result;
+            std::memcpy(&result, &f, sizeof(result));
+            return result;
+        }
+
+        /// \brief Converts a 3D vector into half floats.
+        inline hvec3 pack(const vec3 &v) {
+            return hvec3(from_float(v.x), from_float(v.y), from_float(v.z));
+        }
+
+        /// \brief Converts a 3D vector of half floats into floats.
+        inline vec3 unpack(const hvec3 &v) {
+            return vec3(to_float(v.x), to_float(v.y), to_float(v.z));
+        }
     }
 
 }
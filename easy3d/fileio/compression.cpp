@@ -0,0 +1,373 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/compression.h>
+
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+
+#include <easy3d/util/logging.h>
+#include <easy3d/util/thread_pool.h>
+
+
+namespace easy3d {
+
+    namespace io {
+
+        namespace details {
+
+            // the size of the data (in bytes) of each chunk, before compression
+            const std::size_t chunk_bytes = 1 << 20;
+
+            const int hash_bits = 14;
+            const std::size_t min_match = 4;
+            const std::size_t max_offset = 65535;
+
+            inline void write_length(std::size_t len, std::vector<unsigned char> &out) {
+                while (len >= 255) {
+                    out.push_back(255);
+                    len -= 255;
+                }
+                out.push_back(static_cast<unsigned char>(len));
+            }
+
+            inline bool read_length(const unsigned char *&ip, const unsigned char *end, std::size_t &len) {
+                unsigned char b = 255;
+                while (b == 255) {
+                    if (ip >= end)
+                        return false;
+                    b = *ip++;
+                    len += b;
+                }
+                return true;
+            }
+
+            // Emits a sequence: a token, the literals, and (if match_len > 0) the match.
+            inline void write_sequence(const unsigned char *literals, std::size_t lit_len,
+                                       std::size_t offset, std::size_t match_len, std::vector<unsigned char> &out) {
+                const std::size_t ml = match_len > 0 ? match_len - min_match : 0;
+                const unsigned char token = static_cast<unsigned char>((std::min<std::size_t>(lit_len, 15) << 4) |
+                                                                       std::min<std::size_t>(ml, 15));
+                out.push_back(token);
+                if (lit_len >= 15)
+                    write_length(lit_len - 15, out);
+                out.insert(out.end(), literals, literals + lit_len);
+                if (match_len > 0) {
+                    out.push_back(static_cast<unsigned char>(offset & 0xff));
+                    out.push_back(static_cast<unsigned char>(offset >> 8));
+                    if (ml >= 15)
+                        write_length(ml - 15, out);
+                }
+            }
+
+            // Shuffles the bytes of 'num' elements: all the first bytes, then all the second bytes, ...
+            void shuffle(const unsigned char *src, std::size_t num, std::size_t element_size, unsigned char *dst) {
+                for (std::size_t b = 0; b < element_size; ++b) {
+                    unsigned char *plane = dst + b * num;
+                    for (std::size_t i = 0; i < num; ++i)
+                        plane[i] = src[i * element_size + b];
+                }
+            }
+
+            void unshuffle(const unsigned char *src, std::size_t num, std::size_t element_size, unsigned char *dst) {
+                for (std::size_t b = 0; b < element_size; ++b) {
+                    const unsigned char *plane = src + b * num;
+                    for (std::size_t i = 0; i < num; ++i)
+                        dst[i * element_size + b] = plane[i];
+                }
+            }
+
+            // Quantizes the points [first, last) and delta-codes them within the range (the first point is stored as
+            // is), so the range can be decoded independently of the other ranges. The deltas wrap around, so the
+            // coding is lossless for any order.
+            template<typename T>
+            void quantize(const vec3 *points, std::size_t first, std::size_t last, const dvec3 &translation,
+                          const dvec3 &bmin, const dvec3 &scale, double steps, T *codes) {
+                T prev[3] = {0, 0, 0};
+                for (std::size_t i = first; i < last; ++i) {
+                    for (int j = 0; j < 3; ++j) {
+                        const double v = (points[i][j] + translation[j] - bmin[j]) * scale[j];
+                        const T q = static_cast<T>(std::min(steps, std::max(0.0, v + 0.5)));
+                        codes[i * 3 + j] = static_cast<T>(q - prev[j]);
+                        prev[j] = q;
+                    }
+                }
+            }
+
+            // Undoes quantize() for the points [first, last).
+            template<typename T>
+            void dequantize(const T *codes, std::size_t first, std::size_t last, const dvec3 &step, vec3 *points) {
+                T prev[3] = {0, 0, 0};
+                for (std::size_t i = first; i < last; ++i) {
+                    for (int j = 0; j < 3; ++j) {
+                        prev[j] = static_cast<T>(prev[j] + codes[i * 3 + j]);
+                        points[i][j] = static_cast<float>(prev[j] * step[j]);
+                    }
+                }
+            }
+
+        } // namespace details
+
+
+        void compress(const unsigned char *data, std::size_t size, std::vector<unsigned char> &result) {
+            result.clear();
+            result.reserve(size + size / 255 + 16);
+
+            std::size_t anchor = 0;
+            std::size_t ip = 0;
+            // The last bytes are always stored as literals, so match searching never reads beyond the data.
+            if (size > 12) {
+                const std::size_t limit = size - 12;
+                std::vector<int64_t> table(std::size_t(1) << details::hash_bits, -1);
+                while (ip < limit) {
+                    uint32_t seq;
+                    std::memcpy(&seq, data + ip, 4);
+                    const uint32_t h = (seq * 2654435761u) >> (32 - details::hash_bits);
+                    const int64_t ref = table[h];
+                    table[h] = static_cast<int64_t>(ip);
+                    if (ref >= 0 && ip - ref <= details::max_offset && std::memcmp(data + ref, data + ip, 4) == 0) {
+                        std::size_t len = details::min_match;
+                        while (ip + len < size - 5 && data[ref + len] == data[ip + len])
+                            ++len;
+                        details::write_sequence(data + anchor, ip - anchor, ip - ref, len, result);
+                        ip += len;
+                        anchor = ip;
+                    } else
+                        ++ip;
+                }
+            }
+            // the remaining literals
+            details::write_sequence(data + anchor, size - anchor, 0, 0, result);
+        }
+
+
+        bool decompress(const unsigned char *data, std::size_t size, unsigned char *result, std::size_t result_size) {
+            const unsigned char *ip = data;
+            const unsigned char *end = data + size;
+            std::size_t op = 0;
+            while (ip < end) {
+                const unsigned char token = *ip++;
+                std::size_t lit_len = token >> 4;
+                if (lit_len == 15 && !details::read_length(ip, end, lit_len))
+                    return false;
+                if (lit_len > static_cast<std::size_t>(end - ip) || op + lit_len > result_size)
+                    return false;
+                std::memcpy(result + op, ip, lit_len);
+                ip += lit_len;
+                op += lit_len;
+                if (ip == end)
+                    break;  // the last sequence has no match
+
+                if (end - ip < 2)
+                    return false;
+                const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+                ip += 2;
+                std::size_t match_len = token & 15;
+                if (match_len == 15 && !details::read_length(ip, end, match_len))
+                    return false;
+                match_len += details::min_match;
+                if (offset == 0 || offset > op || op + match_len > result_size)
+                    return false;
+                // the match may overlap with the output, so copy byte by byte
+                const unsigned char *ref = result + op - offset;
+                for (std::size_t i = 0; i < match_len; ++i)
+                    result[op + i] = ref[i];
+                op += match_len;
+            }
+            return op == result_size;
+        }
+
+
+        void write_compressed_array(std::ostream &output, const void *data, std::size_t num, std::size_t element_size) {
+            const std::size_t elements_per_chunk = std::max<std::size_t>(1, details::chunk_bytes / element_size);
+            const int num_chunks = static_cast<int>((num + elements_per_chunk - 1) / elements_per_chunk);
+
+            std::vector<std::vector<unsigned char> > chunks(num_chunks);
+            std::vector<uint32_t> raw_sizes(num_chunks);
+            const auto src = static_cast<const unsigned char *>(data);
+            parallel_for(0, num_chunks, [&](int c) {
+                const std::size_t first = c * elements_per_chunk;
+                const std::size_t n = std::min(elements_per_chunk, num - first);
+                const std::size_t bytes = n * element_size;
+                std::vector<unsigned char> shuffled(bytes);
+                details::shuffle(src + first * element_size, n, element_size, shuffled.data());
+                compress(shuffled.data(), bytes, chunks[c]);
+                if (chunks[c].size() >= bytes) // not compressible: store the raw bytes
+                    chunks[c].swap(shuffled);
+                raw_sizes[c] = static_cast<uint32_t>(bytes);
+            }, nullptr, 1);
+
+            const uint32_t n = static_cast<uint32_t>(num_chunks);
+            output.write((const char *) &n, sizeof(uint32_t));
+            for (int c = 0; c < num_chunks; ++c) {
+                const uint32_t size = static_cast<uint32_t>(chunks[c].size());
+                output.write((const char *) &raw_sizes[c], sizeof(uint32_t));
+                output.write((const char *) &size, sizeof(uint32_t));
+            }
+            for (int c = 0; c < num_chunks; ++c)
+                output.write((const char *) chunks[c].data(), static_cast<std::streamsize>(chunks[c].size()));
+        }
+
+
+        bool read_compressed_array(std::istream &input, void *data, std::size_t num, std::size_t element_size) {
+            uint32_t num_chunks = 0;
+            input.read((char *) &num_chunks, sizeof(uint32_t));
+            if (input.fail())
+                return false;
+
+            std::vector<uint32_t> raw_sizes(num_chunks), sizes(num_chunks);
+            std::vector<std::size_t> raw_offsets(num_chunks + 1, 0), offsets(num_chunks + 1, 0);
+            for (uint32_t c = 0; c < num_chunks; ++c) {
+                input.read((char *) &raw_sizes[c], sizeof(uint32_t));
+                input.read((char *) &sizes[c], sizeof(uint32_t));
+                raw_offsets[c + 1] = raw_offsets[c] + raw_sizes[c];
+                offsets[c + 1] = offsets[c] + sizes[c];
+            }
+            if (input.fail() || raw_offsets[num_chunks] != num * element_size) {
+                LOG(ERROR) << "corrupted data: unexpected size of a compressed array";
+                return false;
+            }
+
+            std::vector<unsigned char> compressed(offsets[num_chunks]);
+            input.read((char *) compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            if (input.fail()) {
+                LOG(ERROR) << "unexpected end of file";
+                return false;
+            }
+
+            const auto dst = static_cast<unsigned char *>(data);
+            std::atomic<bool> success(true);
+            parallel_for(uint32_t(0), num_chunks, [&](uint32_t c) {
+                const std::size_t bytes = raw_sizes[c];
+                const unsigned char *src = compressed.data() + offsets[c];
+                std::vector<unsigned char> shuffled(bytes);
+                if (sizes[c] == raw_sizes[c])
+                    std::memcpy(shuffled.data(), src, bytes);
+                else if (!decompress(src, sizes[c], shuffled.data(), bytes)) {
+                    success = false;
+                    return;
+                }
+                details::unshuffle(shuffled.data(), bytes / element_size, element_size, dst + raw_offsets[c]);
+            }, nullptr, 1);
+            LOG_IF(!success, ERROR) << "corrupted data: failed decompressing an array";
+            return success;
+        }
+
+
+        void write_quantized_positions(std::ostream &output, const vec3 *points, std::size_t num,
+                                       const dvec3 &translation, int bits) {
+            bits = std::max(1, std::min(31, bits));
+            dvec3 bmin(0, 0, 0), bmax(0, 0, 0);
+            if (num > 0) {
+                bmin = bmax = dvec3(points[0].data()) + translation;
+                for (std::size_t i = 1; i < num; ++i) {
+                    const dvec3 p = dvec3(points[i].data()) + translation;
+                    for (int j = 0; j < 3; ++j) {
+                        bmin[j] = std::min(bmin[j], p[j]);
+                        bmax[j] = std::max(bmax[j], p[j]);
+                    }
+                }
+            }
+            const double steps = static_cast<double>((uint32_t(1) << bits) - 1);
+            dvec3 scale;
+            for (int j = 0; j < 3; ++j)
+                scale[j] = (bmax[j] > bmin[j]) ? steps / (bmax[j] - bmin[j]) : 0.0;
+
+            // The points are delta-coded in blocks matching the chunks of write_compressed_array(), so each block
+            // can be decoded independently (and in parallel). The block size is stored, and the i-th block starts at
+            // point i * block.
+            const std::size_t element_size = (bits <= 16 ? sizeof(uint16_t) : sizeof(uint32_t)) * 3;
+            const uint32_t block = static_cast<uint32_t>(std::max<std::size_t>(1, details::chunk_bytes / element_size));
+            const std::size_t num_blocks = (num + block - 1) / block;
+
+            const int32_t b = bits;
+            output.write((const char *) &b, sizeof(int32_t));
+            output.write((const char *) bmin.data(), sizeof(dvec3));
+            output.write((const char *) bmax.data(), sizeof(dvec3));
+            output.write((const char *) &block, sizeof(uint32_t));
+
+            if (bits <= 16) {
+                std::vector<uint16_t> codes(num * 3);
+                parallel_for(std::size_t(0), num_blocks, [&](std::size_t c) {
+                    details::quantize(points, c * block, std::min<std::size_t>(num, (c + 1) * block), translation,
+                                      bmin, scale, steps, codes.data());
+                }, nullptr, 1);
+                write_compressed_array(output, codes.data(), num, element_size);
+            } else {
+                std::vector<uint32_t> codes(num * 3);
+                parallel_for(std::size_t(0), num_blocks, [&](std::size_t c) {
+                    details::quantize(points, c * block, std::min<std::size_t>(num, (c + 1) * block), translation,
+                                      bmin, scale, steps, codes.data());
+                }, nullptr, 1);
+                write_compressed_array(output, codes.data(), num, element_size);
+            }
+        }
+
+
+        bool read_quantized_positions(std::istream &input, vec3 *points, std::size_t num, dvec3 &origin) {
+            int32_t bits = 0;
+            dvec3 bmin, bmax;
+            uint32_t block = 0;
+            input.read((char *) &bits, sizeof(int32_t));
+            input.read((char *) bmin.data(), sizeof(dvec3));
+            input.read((char *) bmax.data(), sizeof(dvec3));
+            input.read((char *) &block, sizeof(uint32_t));
+            if (input.fail() || bits < 1 || bits > 31 || block == 0) {
+                LOG(ERROR) << "corrupted data: invalid quantization of the point coordinates";
+                return false;
+            }
+            origin = bmin;
+
+            const double steps = static_cast<double>((uint32_t(1) << bits) - 1);
+            dvec3 step;
+            for (int j = 0; j < 3; ++j)
+                step[j] = (bmax[j] - bmin[j]) / steps;
+
+            // the blocks are delta-coded independently
+            const std::size_t num_blocks = (num + block - 1) / block;
+            if (bits <= 16) {
+                std::vector<uint16_t> codes(num * 3);
+                if (!read_compressed_array(input, codes.data(), num, sizeof(uint16_t) * 3))
+                    return false;
+                parallel_for(std::size_t(0), num_blocks, [&](std::size_t c) {
+                    details::dequantize(codes.data(), c * block, std::min<std::size_t>(num, (c + 1) * block), step, points);
+                }, nullptr, 1);
+            } else {
+                std::vector<uint32_t> codes(num * 3);
+                if (!read_compressed_array(input, codes.data(), num, sizeof(uint32_t) * 3))
+                    return false;
+                parallel_for(std::size_t(0), num_blocks, [&](std::size_t c) {
+                    details::dequantize(codes.data(), c * block, std::min<std::size_t>(num, (c + 1) * block), step, points);
+                }, nullptr, 1);
+            }
+            return true;
+        }
+
+    } // namespace io
+
+} // namespace easy3d
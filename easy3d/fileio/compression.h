@@ -0,0 +1,116 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_FILEIO_COMPRESSION_H
+#define EASY3D_FILEIO_COMPRESSION_H
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    namespace io {
+
+        /**
+         * \brief Compresses a block of bytes using a fast LZ77 codec (byte-oriented, similar to the LZ4 block format).
+         * \param data The bytes to be compressed.
+         * \param size The number of bytes.
+         * \param result The compressed bytes.
+         */
+        void compress(const unsigned char *data, std::size_t size, std::vector<unsigned char> &result);
+
+        /**
+         * \brief Decompresses a block of bytes compressed by compress().
+         * \param data The compressed bytes.
+         * \param size The number of compressed bytes.
+         * \param result The buffer to receive the decompressed bytes. It must hold \p result_size bytes.
+         * \param result_size The number of the original (i.e., decompressed) bytes.
+         * \return true on success and false if the data is corrupted.
+         */
+        bool decompress(const unsigned char *data, std::size_t size, unsigned char *result, std::size_t result_size);
+
+        /**
+         * \brief Writes an array of fixed-size elements as a sequence of independently compressed chunks.
+         * \details Within each chunk, the bytes of the elements are shuffled (i.e., all the first bytes, then all the
+         *      second bytes, ...) before compression, which makes slowly varying data (e.g., delta-coded coordinates)
+         *      much more compressible. The chunks are compressed in parallel, and they can be decompressed in parallel
+         *      by read_compressed_array().
+         * \param output The output stream (opened in binary mode).
+         * \param data The elements (of \p num * \p element_size bytes).
+         * \param num The number of elements.
+         * \param element_size The size of each element in bytes.
+         */
+        void write_compressed_array(std::ostream &output, const void *data, std::size_t num, std::size_t element_size);
+
+        /**
+         * \brief Reads an array written by write_compressed_array().
+         * \param input The input stream (opened in binary mode).
+         * \param data The buffer to receive the elements. It must hold \p num * \p element_size bytes.
+         * \param num The number of elements.
+         * \param element_size The size of each element in bytes.
+         * \return true on success.
+         */
+        bool read_compressed_array(std::istream &input, void *data, std::size_t num, std::size_t element_size);
+
+        /**
+         * \brief Writes point coordinates quantized to a regular grid over their bounding box.
+         * \details Each coordinate is quantized to \p bits bits (1 to 31) relative to the bounding box of the points,
+         *      and then delta-coded (in the order of the points) and written using write_compressed_array(). The
+         *      delta-coding restarts at fixed-size blocks of points (whose size is stored), so the blocks are encoded
+         *      and decoded independently in parallel.
+         * \param output The output stream (opened in binary mode).
+         * \param points The point coordinates.
+         * \param num The number of points.
+         * \param translation A translation added to the points before quantization (e.g., the value of the model
+         *      property "translation").
+         * \param bits The number of bits of each quantized coordinate.
+         */
+        void write_quantized_positions(std::ostream &output, const vec3 *points, std::size_t num,
+                                       const dvec3 &translation, int bits);
+
+        /**
+         * \brief Reads point coordinates written by write_quantized_positions().
+         * \param input The input stream (opened in binary mode).
+         * \param points The buffer to receive the point coordinates. It must hold \p num points.
+         * \param num The number of points.
+         * \param origin Returns the minimum corner of the bounding box of the points. The points are relative to it,
+         *      i.e., the original coordinates are \c origin + \c points[i]. This avoids loss of precision for data
+         *      sets far away from the origin.
+         * \return true on success.
+         */
+        bool read_quantized_positions(std::istream &input, vec3 *points, std::size_t num, dvec3 &origin);
+
+    } // namespace io
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_FILEIO_COMPRESSION_H
@@ -0,0 +1,166 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/frame_sink.h>
+
+#include <cstdio>
+#include <algorithm>
+
+#include <easy3d/fileio/image_io.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    FrameSink::FrameSink(const Consumer &consumer, int num_workers, std::size_t capacity)
+            : consumer_(consumer), capacity_(std::max<std::size_t>(capacity, 1)),
+              num_workers_(num_workers > 0 ? num_workers
+                                           : std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1)),
+              num_consumed_(0), failed_(false), finishing_(false) {
+        // the workers never access workers_ (they use num_workers_), so it can grow while they are running
+        for (std::size_t i = 0; i < num_workers_; ++i)
+            workers_.emplace_back(&FrameSink::run, this);
+    }
+
+
+    FrameSink::~FrameSink() {
+        finish();
+    }
+
+
+    FrameSink::Frame FrameSink::new_frame(std::size_t index, int width, int height, int channels) {
+        Frame frame;
+        frame.index = index;
+        frame.width = width;
+        frame.height = height;
+        frame.channels = channels;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_buffers_.empty()) {
+                frame.pixels.swap(free_buffers_.back());
+                free_buffers_.pop_back();
+            }
+        }
+        frame.pixels.resize(static_cast<std::size_t>(width) * height * channels);
+        return frame;
+    }
+
+
+    bool FrameSink::push(Frame &&frame) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return queue_.size() < capacity_ || failed_ || finishing_; });
+        if (failed_ || finishing_)
+            return false;
+        queue_.push_back(std::move(frame));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+
+    bool FrameSink::finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finishing_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        for (auto &worker : workers_) {
+            if (worker.joinable())
+                worker.join();
+        }
+        workers_.clear();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_buffers_.clear();
+        return !failed_;
+    }
+
+
+    bool FrameSink::failed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failed_;
+    }
+
+
+    std::size_t FrameSink::num_consumed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return num_consumed_;
+    }
+
+
+    void FrameSink::run() {
+        while (true) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                // when finishing, the remaining frames are still consumed (unless the sink has failed)
+                not_empty_.wait(lock, [this]() { return !queue_.empty() || finishing_ || failed_; });
+                if (failed_ || queue_.empty())
+                    return;
+                frame = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            not_full_.notify_one();
+
+            const bool success = consumer_(frame);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (success) {
+                    ++num_consumed_;
+                    if (free_buffers_.size() < capacity_ + num_workers_)
+                        free_buffers_.push_back(std::move(frame.pixels));
+                } else {
+                    LOG_IF(!failed_, ERROR) << "failed consuming frame " << frame.index;
+                    failed_ = true;
+                    queue_.clear();
+                }
+            }
+            if (!success) {
+                // wake up the producer and the other workers
+                not_full_.notify_all();
+                not_empty_.notify_all();
+            }
+        }
+    }
+
+
+    FrameSink::Consumer FrameSink::image_sequence(const std::string &file_name) {
+        const std::string ext = file_system::extension(file_name);
+        const std::string prefix = file_system::name_less_extension(file_name);
+        return [prefix, ext](Frame &frame) -> bool {
+            char index[32];
+            std::snprintf(index, sizeof(index), "-%04d.", static_cast<int>(frame.index));
+            return ImageIO::save(prefix + index + ext, frame.pixels, frame.width, frame.height, frame.channels,
+                                 frame.bottom_up);
+        };
+    }
+
+}
@@ -0,0 +1,153 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_FILEIO_FRAME_SINK_H
+#define EASY3D_FILEIO_FRAME_SINK_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+namespace easy3d {
+
+    /**
+     * \brief A pipeline that consumes rendered frames (e.g., saves them into image files or encodes them into a
+     *      video) on worker threads, so the rendering thread is never blocked by color conversion and encoding.
+     * \details Frames are pushed into a bounded queue by the rendering thread and taken by the worker threads. When
+     *      the queue is full, push() blocks until a worker has taken a frame, so the memory used by the pipeline is
+     *      limited by the queue capacity. The pixel buffers of consumed frames are recycled by new_frame().
+     *      With a single worker, frames are consumed in the order they were pushed, which is required by video
+     *      encoders and by consumers assembling the tiles of a large image. With more workers, frames are consumed
+     *      concurrently and the consumer must be thread-safe.
+     * \class FrameSink easy3d/fileio/frame_sink.h
+     *
+     * Example usage:
+     *      \code
+     *      FrameSink sink(FrameSink::image_sequence("animation.png"));
+     *      for (std::size_t i = 0; i < num_frames; ++i) {
+     *          // ... render the i-th frame ...
+     *          FrameSink::Frame frame = sink.new_frame(i, width, height, 4);
+     *          // ... read the pixels into frame.pixels ...
+     *          if (!sink.push(std::move(frame)))
+     *              break;
+     *      }
+     *      bool success = sink.finish();
+     *      \endcode
+     */
+    class FrameSink {
+    public:
+        /// \brief A frame, i.e., the pixels of an image, and its index in the sequence.
+        struct Frame {
+            Frame() : index(0), width(0), height(0), channels(0), bottom_up(true) {}
+            std::size_t index;
+            int width;
+            int height;
+            int channels;
+            /// true if the first row is the bottom row of the image (i.e., the OpenGL convention).
+            bool bottom_up;
+            std::vector<unsigned char> pixels;
+        };
+
+        /**
+         * The function consuming a frame. It is called on a worker thread and it returns false on failure. The pixels
+         * of the frame can be modified (e.g., for color conversion), but the frame must not be kept.
+         */
+        typedef std::function<bool(Frame &frame)> Consumer;
+
+        /**
+         * \brief Creates the pipeline and starts the worker threads.
+         * \param consumer The function consuming each frame.
+         * \param num_workers The number of worker threads. A value of 0 uses one thread per hardware core (minus the
+         *      rendering thread). Use a single worker if the frames must be consumed in order.
+         * \param capacity The maximum number of frames waiting in the queue.
+         */
+        explicit FrameSink(const Consumer &consumer, int num_workers = 1, std::size_t capacity = 4);
+
+        /// Waits for all frames to be consumed and stops the worker threads.
+        ~FrameSink();
+
+        /**
+         * \brief Creates a frame. Its pixel buffer (of size width * height * channels) is taken from the consumed
+         *      frames if available, to avoid reallocation.
+         */
+        Frame new_frame(std::size_t index, int width, int height, int channels);
+
+        /**
+         * \brief Adds a frame to the queue. Blocks if the queue is full.
+         * \return false if the sink has failed (i.e., the consumer failed on a frame) or has been finished. The frame
+         *      is discarded in this case.
+         */
+        bool push(Frame &&frame);
+
+        /**
+         * \brief Waits for all frames in the queue to be consumed and stops the worker threads.
+         * \return true if all frames have been consumed successfully.
+         */
+        bool finish();
+
+        /// Returns true if the consumer has failed on any frame.
+        bool failed() const;
+
+        /// Returns the number of frames that have been consumed successfully.
+        std::size_t num_consumed() const;
+
+        /**
+         * \brief Returns a consumer that saves each frame into an image file. The file name of each frame is derived
+         *      from 'file_name' by appending the frame index (with at least 4 digits), e.g., "animation-0012.png".
+         *      The format is determined by the extension of 'file_name' (see ImageIO::save()).
+         */
+        static Consumer image_sequence(const std::string &file_name);
+
+    private:
+        void run();
+
+    private:
+        Consumer consumer_;
+        std::size_t capacity_;
+        std::size_t num_workers_;   // fixed before the workers start, so it can be read without locking
+        std::vector<std::thread> workers_;  // accessed by the producer thread only
+
+        std::deque<Frame> queue_;
+        std::vector<std::vector<unsigned char> > free_buffers_;
+        std::size_t num_consumed_;
+        bool failed_;
+        bool finishing_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+    };
+
+}
+
+
+#endif  // EASY3D_FILEIO_FRAME_SINK_H
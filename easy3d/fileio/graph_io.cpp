@@ -32,6 +32,7 @@
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -44,6 +45,7 @@ namespace easy3d {
         Graph* graph = new Graph;
         graph->set_name(file_name);
 
+        EASY3D_PROFILE_ZONE("GraphIO::load");
         StopWatch w;
         bool success = false;
 
@@ -65,6 +67,9 @@ namespace easy3d {
             return nullptr;
         }
 
+        EASY3D_PROFILE_ELEMENTS(graph->n_vertices());
+        EASY3D_PROFILE_BYTES(static_cast<std::size_t>(file_system::file_size(file_name)));
+
         if (success)
             LOG(INFO) << "graph loaded ("
                       << "#vertex: " << graph->n_vertices() << ", "
@@ -84,6 +89,7 @@ namespace easy3d {
 			return false;
 		}
 
+		EASY3D_PROFILE_ZONE("GraphIO::save");
 		StopWatch w;
 		bool success = false;
 
@@ -102,6 +108,8 @@ namespace easy3d {
 			success = false;
 		}
 
+        EASY3D_PROFILE_ELEMENTS(graph->n_vertices());
+
         if (success) {
             LOG(INFO) << "save model done. " << w.time_string();
             return true;
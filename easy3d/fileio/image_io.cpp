@@ -26,6 +26,8 @@
 
 #include <easy3d/fileio/image_io.h>
 
+#include <algorithm>
+
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/logging.h>
 
@@ -77,8 +79,17 @@ namespace easy3d {
             return false;
         }
 
-        // flag is non-zero to flip data vertically
-        stbi_flip_vertically_on_write(flip_vertically);
+        // Flip a copy of the data instead of using stbi_flip_vertically_on_write(), which sets a global flag. This
+        // way images can be saved concurrently from multiple threads (e.g., by a FrameSink).
+        std::vector<unsigned char> flipped;
+        if (flip_vertically) {
+            const std::size_t stride = static_cast<std::size_t>(width) * channels;
+            flipped.resize(stride * height);
+            for (int row = 0; row < height; ++row)
+                std::copy(data.begin() + stride * (height - 1 - row), data.begin() + stride * (height - row),
+                          flipped.begin() + stride * row);
+        }
+        const unsigned char* pixels = flip_vertically ? flipped.data() : data.data();
 
         std::string final_name = file_name;
         const std::string &ext = file_system::extension(file_name, true);
@@ -90,16 +101,15 @@ namespace easy3d {
             }
 
             // PNG allows you to set the deflate compression level by setting the global
-            // variable 'stbi_write_png_compression_level' (it defaults to 8).
-            stbi_write_png_compression_level = 8; //
-            return ::stbi_write_png(final_name.c_str(), width, height, channels, data.data(), width * channels);
+            // variable 'stbi_write_png_compression_level' (it defaults to 8, which we use).
+            return ::stbi_write_png(final_name.c_str(), width, height, channels, pixels, width * channels);
         } else if (ext == "jpg") {
             // quality is between 1 and 100. Higher quality looks better but results in a bigger image.
-            return ::stbi_write_jpg(final_name.c_str(), width, height, channels, data.data(), 100);
+            return ::stbi_write_jpg(final_name.c_str(), width, height, channels, pixels, 100);
         } else if (ext == "bmp")
-            return ::stbi_write_bmp(final_name.c_str(), width, height, channels, data.data());
+            return ::stbi_write_bmp(final_name.c_str(), width, height, channels, pixels);
         else if (ext == "tga")
-            return ::stbi_write_tga(final_name.c_str(), width, height, channels, data.data());
+            return ::stbi_write_tga(final_name.c_str(), width, height, channels, pixels);
         else {
             LOG(ERROR) << "unsupported file format: " << ext;
             return false;
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdio>
 
 
 namespace easy3d {
@@ -124,6 +125,84 @@ namespace easy3d {
     };
 
 
+    /**
+     * \brief Writes an image into a file band by band.
+     * \details The image rows are given from top to bottom in consecutive calls of write_rows(), and they are encoded
+     *      and written to the file immediately. So the full image never has to be held in memory, which allows saving
+     *      very large images (e.g., high-resolution snapshots rendered tile by tile). The following formats are
+     *      supported: PNG (1-4 channels), PPM (1 or 3 channels), BMP and TGA (3 or 4 channels). File format is
+     *      determined by the file extension given in the file name.
+     * \class ImageStreamWriter easy3d/fileio/image_io.h
+     *
+     * Example usage:
+     *      \code
+     *      ImageStreamWriter writer;
+     *      if (writer.open("snapshot.png", width, height, 4)) {
+     *          for (int band = 0; band < num_bands; ++band) {
+     *              // ... render/compute the rows of this band ...
+     *              writer.write_rows(rows.data(), num_rows_in_band);
+     *          }
+     *          writer.close();
+     *      }
+     *      \endcode
+     */
+    class ImageStreamWriter {
+    public:
+        ImageStreamWriter();
+        /// Closes the file if it is still open.
+        ~ImageStreamWriter();
+
+        /**
+         * \brief Creates the file and writes the image header.
+         * \param file_name The image file name. Its extension determines the file format.
+         * \param width The width of the image, in pixels.
+         * \param height The height of the image, in pixels.
+         * \param channels The number of 8-bit image channels per pixel.
+         * \return true on success or false if failed.
+         */
+        bool open(const std::string& file_name, int width, int height, int channels);
+
+        /**
+         * \brief Appends rows to the image.
+         * \param rows The pixel data of the rows, from top to bottom. Each row consists of 'width' pixels with
+         *      'channels' interleaved components, and there is no padding between rows.
+         * \param num_rows The number of rows.
+         * \return true on success or false if failed.
+         */
+        bool write_rows(const unsigned char* rows, int num_rows);
+
+        /**
+         * \brief Finishes writing the image and closes the file.
+         * \return false if an error occurred or if not all rows of the image have been written.
+         */
+        bool close();
+
+        /// Returns true if the file is open.
+        bool is_open() const { return file_ != nullptr; }
+        /// Returns the number of rows that have been written so far.
+        int rows_written() const { return rows_written_; }
+
+    private:
+        bool write_png_rows(const unsigned char* rows, int num_rows);
+        bool write_png_chunk(const char* type, const unsigned char* data, std::size_t size);
+
+    private:
+        FILE* file_;
+        std::string file_name_;
+        std::string format_;
+        int width_;
+        int height_;
+        int channels_;
+        int rows_written_;
+        bool failed_;
+
+        // PNG only: the previous (unfiltered) row, the compressed data to be written, and the checksum.
+        std::vector<unsigned char> prev_row_;
+        std::vector<unsigned char> pending_;
+        unsigned int adler_;
+    };
+
+
 	namespace io {
 
         /**
@@ -0,0 +1,538 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/image_io.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+namespace easy3d {
+
+    namespace {
+
+        // CRC-32 of the PNG chunks
+        unsigned int crc32(unsigned int crc, const unsigned char* data, std::size_t size) {
+            static const std::vector<unsigned int> table = []() {
+                std::vector<unsigned int> t(256);
+                for (unsigned int n = 0; n < 256; ++n) {
+                    unsigned int c = n;
+                    for (int k = 0; k < 8; ++k)
+                        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    t[n] = c;
+                }
+                return t;
+            }();
+
+            crc = ~crc;
+            for (std::size_t i = 0; i < size; ++i)
+                crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+            return ~crc;
+        }
+
+
+        // Adler-32 checksum of the zlib stream
+        unsigned int adler32(unsigned int adler, const unsigned char* data, std::size_t size) {
+            unsigned int a = adler & 0xffff;
+            unsigned int b = adler >> 16;
+            while (size > 0) {
+                // 5552 is the largest n such that the sums don't overflow before the modulo
+                std::size_t n = std::min<std::size_t>(size, 5552);
+                size -= n;
+                while (n--) {
+                    a += *data++;
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+            }
+            return (b << 16) | a;
+        }
+
+
+        void put_uint32_be(std::vector<unsigned char>& out, unsigned int v) {
+            out.push_back(static_cast<unsigned char>(v >> 24));
+            out.push_back(static_cast<unsigned char>(v >> 16));
+            out.push_back(static_cast<unsigned char>(v >> 8));
+            out.push_back(static_cast<unsigned char>(v));
+        }
+
+
+        // Writes the bits of a deflate stream (least significant bit first).
+        class BitWriter {
+        public:
+            explicit BitWriter(std::vector<unsigned char>& out) : out_(out), buffer_(0), count_(0) {}
+
+            void put(unsigned int bits, int num) {
+                buffer_ |= static_cast<unsigned long long>(bits) << count_;
+                count_ += num;
+                while (count_ >= 8) {
+                    out_.push_back(static_cast<unsigned char>(buffer_ & 0xff));
+                    buffer_ >>= 8;
+                    count_ -= 8;
+                }
+            }
+
+            // Huffman codes are stored starting with their most significant bit
+            void put_code(unsigned int code, int num) {
+                unsigned int reversed = 0;
+                for (int i = 0; i < num; ++i, code >>= 1)
+                    reversed = (reversed << 1) | (code & 1);
+                put(reversed, num);
+            }
+
+            void align() { if (count_ > 0) put(0, 8 - count_); }
+
+        private:
+            std::vector<unsigned char>& out_;
+            unsigned long long buffer_;
+            int count_;
+        };
+
+
+        // the literal/length symbol 'sym' with the fixed Huffman codes
+        void put_fixed_symbol(BitWriter& writer, int sym) {
+            if (sym < 144)      writer.put_code(0x30 + sym, 8);
+            else if (sym < 256) writer.put_code(0x190 + sym - 144, 9);
+            else if (sym < 280) writer.put_code(sym - 256, 7);
+            else                writer.put_code(0xc0 + sym - 280, 8);
+        }
+
+
+        void put_fixed_match(BitWriter& writer, int length, int distance) {
+            static const unsigned short length_base[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35,
+                                                         43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+            static const unsigned char length_extra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                                         4, 4, 4, 4, 5, 5, 5, 5, 0};
+            static const unsigned short dist_base[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257,
+                                                       385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289,
+                                                       16385, 24577};
+            static const unsigned char dist_extra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9,
+                                                       10, 10, 11, 11, 12, 12, 13, 13};
+            int i = 28;
+            while (length_base[i] > length) --i;
+            put_fixed_symbol(writer, 257 + i);
+            writer.put(length - length_base[i], length_extra[i]);
+            int j = 29;
+            while (dist_base[j] > distance) --j;
+            writer.put_code(j, 5);
+            writer.put(distance - dist_base[j], dist_extra[j]);
+        }
+
+
+        /**
+         * Compresses a band of (filtered) rows into deflate blocks and appends them to \p out, such that the deflate
+         * stream can be continued by the blocks of the next band. The data is compressed by LZ77 (with hash chains
+         * within the band) into a block with the fixed Huffman codes, or it is stored if that is smaller. The blocks
+         * are not final, and they end with an empty stored block that brings the stream to a byte boundary (as zlib's
+         * Z_SYNC_FLUSH does).
+         */
+        void deflate_band(const unsigned char* data, std::size_t size, std::vector<unsigned char>& out) {
+            const int window = 32768, min_match = 3, max_match = 258, max_chain = 64;
+            const int hash_bits = 15;
+            std::vector<int> head(1 << hash_bits, -1);
+            std::vector<int> prev(window, -1);
+            auto hash = [data](std::size_t i) {
+                const unsigned int v = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+                return (v * 2654435761u) >> (32 - hash_bits);
+            };
+            auto insert = [&](std::size_t i) {
+                const unsigned int h = hash(i);
+                prev[i & (window - 1)] = head[h];
+                head[h] = static_cast<int>(i);
+            };
+
+            const std::size_t start = out.size();
+            BitWriter writer(out);
+            writer.put(2, 3);   // BFINAL = 0, BTYPE = 01 (fixed Huffman codes)
+            std::size_t i = 0;
+            while (i < size) {
+                int best_length = 0, best_distance = 0;
+                if (i + min_match <= size) {
+                    const int limit = static_cast<int>(std::min<std::size_t>(max_match, size - i));
+                    int candidate = head[hash(i)];
+                    for (int chain = 0; chain < max_chain && candidate >= 0; ++chain) {
+                        const int distance = static_cast<int>(i) - candidate;
+                        if (distance > window - 1)  // a slot of the ring that has been reused
+                            break;
+                        const unsigned char *a = data + candidate, *b = data + i;
+                        if (a[best_length] == b[best_length]) {
+                            int length = 0;
+                            while (length < limit && a[length] == b[length])
+                                ++length;
+                            if (length > best_length) {
+                                best_length = length;
+                                best_distance = distance;
+                                if (length == limit)
+                                    break;
+                            }
+                        }
+                        const int next = prev[candidate & (window - 1)];
+                        if (next >= candidate)
+                            break;
+                        candidate = next;
+                    }
+                }
+
+                if (best_length >= min_match) {
+                    put_fixed_match(writer, best_length, best_distance);
+                    const std::size_t end = i + best_length;
+                    for (; i < end; ++i) {
+                        if (i + min_match <= size)
+                            insert(i);
+                    }
+                } else {
+                    put_fixed_symbol(writer, data[i]);
+                    if (i + min_match <= size)
+                        insert(i);
+                    ++i;
+                }
+            }
+            put_fixed_symbol(writer, 256);  // end of block
+
+            // store the data if it could not be compressed (at most 65535 bytes per stored block)
+            const std::size_t num_stored = std::max<std::size_t>((size + 65534) / 65535, 1);
+            if (out.size() - start >= size + num_stored * 5) {
+                out.resize(start);
+                for (std::size_t pos = 0, n = 0; n < num_stored; ++n) {
+                    const unsigned int len = static_cast<unsigned int>(std::min<std::size_t>(65535, size - pos));
+                    out.push_back(0);   // BFINAL = 0, BTYPE = 00 (stored), padded to the byte boundary
+                    out.push_back(static_cast<unsigned char>(len & 0xff));
+                    out.push_back(static_cast<unsigned char>(len >> 8));
+                    out.push_back(static_cast<unsigned char>(~len & 0xff));
+                    out.push_back(static_cast<unsigned char>((~len >> 8) & 0xff));
+                    out.insert(out.end(), data + pos, data + pos + len);
+                    pos += len;
+                }
+                return;
+            }
+
+            // an empty stored block (the header, the padding, LEN = 0, and NLEN = 0xffff)
+            writer.put(0, 3);
+            writer.align();
+            static const unsigned char sync[] = {0x00, 0x00, 0xff, 0xff};
+            out.insert(out.end(), sync, sync + 4);
+        }
+
+
+        inline unsigned char paeth(int a, int b, int c) {
+            const int p = a + b - c;
+            const int pa = std::abs(p - a);
+            const int pb = std::abs(p - b);
+            const int pc = std::abs(p - c);
+            if (pa <= pb && pa <= pc) return static_cast<unsigned char>(a);
+            if (pb <= pc) return static_cast<unsigned char>(b);
+            return static_cast<unsigned char>(c);
+        }
+
+
+        // Applies the PNG filter 'type' to a row. 'prev' is the previous (unfiltered) row.
+        void filter_row(int type, const unsigned char* cur, const unsigned char* prev, int stride, int bpp,
+                        unsigned char* out) {
+            for (int i = 0; i < stride; ++i) {
+                const int a = i >= bpp ? cur[i - bpp] : 0;
+                const int b = prev[i];
+                const int c = i >= bpp ? prev[i - bpp] : 0;
+                switch (type) {
+                    case 0: out[i] = cur[i]; break;
+                    case 1: out[i] = static_cast<unsigned char>(cur[i] - a); break;
+                    case 2: out[i] = static_cast<unsigned char>(cur[i] - b); break;
+                    case 3: out[i] = static_cast<unsigned char>(cur[i] - ((a + b) >> 1)); break;
+                    default: out[i] = static_cast<unsigned char>(cur[i] - paeth(a, b, c)); break;
+                }
+            }
+        }
+
+    }
+
+
+    ImageStreamWriter::ImageStreamWriter()
+            : file_(nullptr), width_(0), height_(0), channels_(0), rows_written_(0), failed_(false), adler_(1) {
+    }
+
+
+    ImageStreamWriter::~ImageStreamWriter() {
+        if (file_)
+            close();
+    }
+
+
+    bool ImageStreamWriter::open(const std::string &file_name, int width, int height, int channels) {
+        if (file_)
+            close();
+
+        if (width <= 0 || height <= 0 || channels < 1 || channels > 4) {
+            LOG(ERROR) << "invalid image dimensions: " << width << " x " << height << " x " << channels;
+            return false;
+        }
+
+        const std::string &ext = file_system::extension(file_name, true);
+        if (ext == "png") {
+            // no constraint
+        } else if (ext == "ppm") {
+            if (channels != 1 && channels != 3) {
+                LOG(ERROR) << "ppm format requires 1 or 3 channels, but the image has " << channels;
+                return false;
+            }
+        } else if (ext == "bmp" || ext == "tga") {
+            if (channels != 3 && channels != 4) {
+                LOG(ERROR) << ext << " format requires 3 or 4 channels, but the image has " << channels;
+                return false;
+            }
+            if (ext == "tga" && (width > 65535 || height > 65535)) {
+                LOG(ERROR) << "image too large for the tga format: " << width << " x " << height;
+                return false;
+            }
+            if (ext == "bmp" && static_cast<double>((width * channels + 3) / 4 * 4) * height > 2147483647.0) {
+                LOG(ERROR) << "image too large for the bmp format: " << width << " x " << height;
+                return false;
+            }
+        } else {
+            LOG(ERROR) << "unsupported format for writing images band by band: " << ext
+                       << " (only png, ppm, bmp, and tga are supported)";
+            return false;
+        }
+
+        file_ = fopen(file_name.c_str(), "wb");
+        if (!file_) {
+            LOG(ERROR) << "could not open file: " << file_name;
+            return false;
+        }
+
+        file_name_ = file_name;
+        format_ = ext;
+        width_ = width;
+        height_ = height;
+        channels_ = channels;
+        rows_written_ = 0;
+        failed_ = false;
+
+        std::vector<unsigned char> header;
+        if (format_ == "png") {
+            static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+            header.assign(signature, signature + 8);
+            if (fwrite(header.data(), 1, header.size(), file_) != header.size())
+                failed_ = true;
+
+            static const unsigned char color_types[5] = {0, 0, 4, 2, 6};
+            std::vector<unsigned char> ihdr;
+            put_uint32_be(ihdr, static_cast<unsigned int>(width));
+            put_uint32_be(ihdr, static_cast<unsigned int>(height));
+            ihdr.push_back(8);                      // bit depth
+            ihdr.push_back(color_types[channels]);  // color type
+            ihdr.push_back(0);                      // compression method
+            ihdr.push_back(0);                      // filter method
+            ihdr.push_back(0);                      // interlace method
+            write_png_chunk("IHDR", ihdr.data(), ihdr.size());
+
+            prev_row_.assign(static_cast<std::size_t>(width) * channels, 0);
+            pending_ = {0x78, 0x5e};  // zlib header (deflate with a 32K window, no preset dictionary)
+            adler_ = 1;
+        } else if (format_ == "ppm") {
+            const std::string text = (channels == 1 ? "P5\n" : "P6\n") + std::to_string(width) + " " +
+                                     std::to_string(height) + "\n255\n";
+            header.assign(text.begin(), text.end());
+            if (fwrite(header.data(), 1, header.size(), file_) != header.size())
+                failed_ = true;
+        } else if (format_ == "bmp") {
+            const unsigned int stride = (width * channels + 3) / 4 * 4;
+            const unsigned int image_size = stride * height;
+            auto put_uint32_le = [&header](unsigned int v) {
+                for (int i = 0; i < 4; ++i) header.push_back(static_cast<unsigned char>(v >> (8 * i)));
+            };
+            auto put_uint16_le = [&header](unsigned int v) {
+                for (int i = 0; i < 2; ++i) header.push_back(static_cast<unsigned char>(v >> (8 * i)));
+            };
+            put_uint16_le(19778);           // "BM"
+            put_uint32_le(54 + image_size); // file size
+            put_uint32_le(0);               // reserved
+            put_uint32_le(54);              // offset of the pixel data
+            put_uint32_le(40);              // size of the info header
+            put_uint32_le(static_cast<unsigned int>(width));
+            put_uint32_le(static_cast<unsigned int>(-height));  // negative height: rows are stored top-down
+            put_uint16_le(1);               // planes
+            put_uint16_le(channels * 8);    // bits per pixel
+            put_uint32_le(0);               // no compression
+            put_uint32_le(image_size);
+            put_uint32_le(0);
+            put_uint32_le(0);
+            put_uint32_le(0);
+            put_uint32_le(0);
+            if (fwrite(header.data(), 1, header.size(), file_) != header.size())
+                failed_ = true;
+        } else if (format_ == "tga") {
+            header.assign(18, 0);
+            header[2] = 2;  // uncompressed true-color image
+            header[12] = static_cast<unsigned char>(width & 0xff);
+            header[13] = static_cast<unsigned char>(width >> 8);
+            header[14] = static_cast<unsigned char>(height & 0xff);
+            header[15] = static_cast<unsigned char>(height >> 8);
+            header[16] = static_cast<unsigned char>(channels * 8);
+            header[17] = static_cast<unsigned char>(0x20 | (channels == 4 ? 8 : 0)); // top-left origin, alpha bits
+            if (fwrite(header.data(), 1, header.size(), file_) != header.size())
+                failed_ = true;
+        }
+
+        if (failed_) {
+            LOG(ERROR) << "failed writing image header to file: " << file_name;
+            fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+
+    bool ImageStreamWriter::write_rows(const unsigned char *rows, int num_rows) {
+        if (!file_ || failed_) {
+            LOG(ERROR) << "image stream is not open or is in an erroneous state";
+            return false;
+        }
+        if (num_rows <= 0)
+            return true;
+        if (rows_written_ + num_rows > height_) {
+            LOG(ERROR) << "too many rows written to image (" << rows_written_ + num_rows << " vs. " << height_ << ")";
+            failed_ = true;
+            return false;
+        }
+
+        const std::size_t stride = static_cast<std::size_t>(width_) * channels_;
+        if (format_ == "png")
+            failed_ = !write_png_rows(rows, num_rows);
+        else if (format_ == "ppm")
+            failed_ = fwrite(rows, stride, num_rows, file_) != static_cast<std::size_t>(num_rows);
+        else { // bmp and tga store BGR(A), bmp rows are padded to multiples of 4 bytes
+            const std::size_t padded = (format_ == "bmp") ? (stride + 3) / 4 * 4 : stride;
+            std::vector<unsigned char> buffer(padded * num_rows, 0);
+            for (int r = 0; r < num_rows; ++r) {
+                const unsigned char *src = rows + r * stride;
+                unsigned char *dst = buffer.data() + r * padded;
+                for (int i = 0; i < width_; ++i, src += channels_, dst += channels_) {
+                    dst[0] = src[2];
+                    dst[1] = src[1];
+                    dst[2] = src[0];
+                    if (channels_ == 4)
+                        dst[3] = src[3];
+                }
+            }
+            failed_ = fwrite(buffer.data(), 1, buffer.size(), file_) != buffer.size();
+        }
+
+        if (failed_) {
+            LOG(ERROR) << "failed writing image rows to file: " << file_name_;
+            return false;
+        }
+        rows_written_ += num_rows;
+        return true;
+    }
+
+
+    bool ImageStreamWriter::write_png_rows(const unsigned char *rows, int num_rows) {
+        const int stride = width_ * channels_;
+        std::vector<unsigned char> filtered(static_cast<std::size_t>(stride + 1) * num_rows);
+        std::vector<unsigned char> candidate(stride);
+
+        // choose the filter of each row by the minimum sum of absolute differences (the usual heuristic)
+        for (int r = 0; r < num_rows; ++r) {
+            const unsigned char *cur = rows + static_cast<std::size_t>(r) * stride;
+            const unsigned char *prev = (r == 0) ? prev_row_.data() : cur - stride;
+            unsigned char *out = filtered.data() + static_cast<std::size_t>(r) * (stride + 1);
+
+            long best_sum = -1;
+            for (int type = 0; type < 5; ++type) {
+                filter_row(type, cur, prev, stride, channels_, candidate.data());
+                long sum = 0;
+                for (int i = 0; i < stride; ++i)
+                    sum += std::abs(static_cast<signed char>(candidate[i]));
+                if (best_sum < 0 || sum < best_sum) {
+                    best_sum = sum;
+                    out[0] = static_cast<unsigned char>(type);
+                    std::memcpy(out + 1, candidate.data(), stride);
+                }
+            }
+        }
+        const unsigned char *last = rows + static_cast<std::size_t>(num_rows - 1) * stride;
+        prev_row_.assign(last, last + stride);
+
+        adler_ = adler32(adler_, filtered.data(), filtered.size());
+        deflate_band(filtered.data(), filtered.size(), pending_);
+
+        const bool success = write_png_chunk("IDAT", pending_.data(), pending_.size());
+        pending_.clear();
+        return success;
+    }
+
+
+    bool ImageStreamWriter::write_png_chunk(const char *type, const unsigned char *data, std::size_t size) {
+        std::vector<unsigned char> head;
+        put_uint32_be(head, static_cast<unsigned int>(size));
+        head.insert(head.end(), type, type + 4);
+
+        unsigned int crc = crc32(0, head.data() + 4, 4);
+        crc = crc32(crc, data, size);
+        std::vector<unsigned char> tail;
+        put_uint32_be(tail, crc);
+
+        return fwrite(head.data(), 1, head.size(), file_) == head.size() &&
+               (size == 0 || fwrite(data, 1, size, file_) == size) &&
+               fwrite(tail.data(), 1, tail.size(), file_) == tail.size();
+    }
+
+
+    bool ImageStreamWriter::close() {
+        if (!file_)
+            return false;
+
+        bool success = !failed_;
+        if (success && rows_written_ != height_) {
+            LOG(ERROR) << "image incomplete: " << rows_written_ << " of " << height_ << " rows written";
+            success = false;
+        }
+
+        if (success && format_ == "png") {
+            // an empty final block (with fixed Huffman codes) terminates the deflate stream
+            pending_.push_back(0x03);
+            pending_.push_back(0x00);
+            put_uint32_be(pending_, adler_);
+            success = write_png_chunk("IDAT", pending_.data(), pending_.size()) &&
+                      write_png_chunk("IEND", nullptr, 0);
+            pending_.clear();
+        }
+
+        if (fclose(file_) != 0)
+            success = false;
+        file_ = nullptr;
+        prev_row_.clear();
+
+        LOG_IF(!success, ERROR) << "failed writing image file: " << file_name_;
+        return success;
+    }
+
+}
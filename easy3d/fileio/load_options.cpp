@@ -0,0 +1,205 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/load_options.h>
+
+#include <algorithm>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+
+
+namespace easy3d {
+
+
+    LoadOptions::LoadOptions()
+            : narrow_colors(false), half_normals(false), narrow_labels(false) {
+    }
+
+
+    LoadOptions LoadOptions::all() {
+        return LoadOptions();
+    }
+
+
+    LoadOptions LoadOptions::positions_only() {
+        LoadOptions options;
+        options.properties.push_back("v:point");
+        return options;
+    }
+
+
+    LoadOptions LoadOptions::compact() {
+        LoadOptions options;
+        options.narrow_colors = true;
+        options.half_normals = true;
+        options.narrow_labels = true;
+        return options;
+    }
+
+
+    bool LoadOptions::imports(const std::string &name) const {
+        if (properties.empty())
+            return true;
+
+        // the properties required by the data structures
+        static const std::vector<std::string> required = {
+                "v:point", "v:deleted", "e:deleted", "f:deleted", "v:connectivity", "h:connectivity", "f:connectivity"
+        };
+        if (std::find(required.begin(), required.end(), name) != required.end())
+            return true;
+
+        return std::find(properties.begin(), properties.end(), name) != properties.end();
+    }
+
+
+    namespace io {
+
+        namespace details {
+
+            // uniform access to the properties defined on the same type of elements (vertices, edges, ...)
+            struct VertexProperties {
+                template<typename MODEL>
+                static std::vector<std::string> names(const MODEL *model) { return model->vertex_properties(); }
+                template<typename T, typename MODEL>
+                static Property<T> get(MODEL *model, const std::string &name) { return model->template get_vertex_property<T>(name); }
+                template<typename T, typename MODEL>
+                static Property<T> add(MODEL *model, const std::string &name) { return model->template add_vertex_property<T>(name); }
+                template<typename MODEL>
+                static void remove(MODEL *model, const std::string &name) { model->remove_vertex_property(name); }
+            };
+
+            struct HalfedgeProperties {
+                static std::vector<std::string> names(const SurfaceMesh *mesh) { return mesh->halfedge_properties(); }
+                template<typename T>
+                static Property<T> get(SurfaceMesh *mesh, const std::string &name) { return mesh->get_halfedge_property<T>(name); }
+                template<typename T>
+                static Property<T> add(SurfaceMesh *mesh, const std::string &name) { return mesh->add_halfedge_property<T>(name); }
+                static void remove(SurfaceMesh *mesh, const std::string &name) { mesh->remove_halfedge_property(name); }
+            };
+
+            struct EdgeProperties {
+                static std::vector<std::string> names(const SurfaceMesh *mesh) { return mesh->edge_properties(); }
+                template<typename T>
+                static Property<T> get(SurfaceMesh *mesh, const std::string &name) { return mesh->get_edge_property<T>(name); }
+                template<typename T>
+                static Property<T> add(SurfaceMesh *mesh, const std::string &name) { return mesh->add_edge_property<T>(name); }
+                static void remove(SurfaceMesh *mesh, const std::string &name) { mesh->remove_edge_property(name); }
+            };
+
+            struct FaceProperties {
+                static std::vector<std::string> names(const SurfaceMesh *mesh) { return mesh->face_properties(); }
+                template<typename T>
+                static Property<T> get(SurfaceMesh *mesh, const std::string &name) { return mesh->get_face_property<T>(name); }
+                template<typename T>
+                static Property<T> add(SurfaceMesh *mesh, const std::string &name) { return mesh->add_face_property<T>(name); }
+                static void remove(SurfaceMesh *mesh, const std::string &name) { mesh->remove_face_property(name); }
+            };
+
+
+            // replaces the property 'name' of type FROM by a property of type TO named 'name' + 'suffix'. The values
+            // are converted by 'func'. The new property is filled before the old one is released, so the peak memory
+            // is the sum of both.
+            template<typename ELEMENTS, typename FROM, typename TO, typename MODEL, typename FUNC>
+            bool convert(MODEL *model, const std::string &name, const std::string &suffix, FUNC func) {
+                Property<FROM> from = ELEMENTS::template get<FROM>(model, name);
+                if (!from)
+                    return false;
+                Property<TO> to = ELEMENTS::template add<TO>(model, name + suffix);
+                if (!to)
+                    return false;
+
+                const std::vector<FROM> &src = from.vector();
+                std::vector<TO> &dst = to.vector();
+                for (std::size_t i = 0; i < src.size(); ++i)
+                    dst[i] = func(src[i]);
+
+                ELEMENTS::remove(model, name);
+                return true;
+            }
+
+
+            // narrows an integer property to unsigned char or unsigned short if all its values fit
+            template<typename ELEMENTS, typename T, typename MODEL>
+            bool narrow_integers(MODEL *model, const std::string &name) {
+                Property<T> prop = ELEMENTS::template get<T>(model, name);
+                if (!prop || prop.vector().empty())
+                    return false;
+
+                const auto range = std::minmax_element(prop.vector().begin(), prop.vector().end());
+                if (static_cast<long long>(*range.first) < 0)
+                    return false;
+                if (*range.second <= 255)
+                    return convert<ELEMENTS, T, unsigned char>(model, name, "_u8", [](T v) { return static_cast<unsigned char>(v); });
+                if (*range.second <= 65535)
+                    return convert<ELEMENTS, T, unsigned short>(model, name, "_u16", [](T v) { return static_cast<unsigned short>(v); });
+                return false;
+            }
+
+
+            template<typename ELEMENTS, typename MODEL>
+            void apply(MODEL *model, const LoadOptions &options, const std::string &color_name, bool narrow_normals) {
+                for (const auto &name : ELEMENTS::names(model)) {
+                    if (!options.imports(name)) {
+                        ELEMENTS::remove(model, name);
+                        continue;
+                    }
+
+                    if (options.narrow_colors && name == color_name)
+                        convert<ELEMENTS, vec3, u8vec3>(model, name, "_u8", [](const vec3 &c) { return rgb::pack(c); });
+                    else if (narrow_normals && name == "v:normal")
+                        convert<ELEMENTS, vec3, hvec3>(model, name, "_h", [](const vec3 &n) { return half::pack(n); });
+                    else if (options.narrow_labels) {
+                        if (!narrow_integers<ELEMENTS, int>(model, name))
+                            narrow_integers<ELEMENTS, unsigned int>(model, name);
+                    }
+                }
+            }
+
+        } // namespace details
+
+
+        void apply_load_options(PointCloud *cloud, const LoadOptions &options) {
+            if (!cloud || (options.properties.empty() && !options.narrows()))
+                return;
+            details::apply<details::VertexProperties>(cloud, options, "v:color", options.half_normals);
+        }
+
+
+        void apply_load_options(SurfaceMesh *mesh, const LoadOptions &options) {
+            if (!mesh || (options.properties.empty() && !options.narrows()))
+                return;
+            // vertex normals of surface meshes are recomputed for rendering, so they are never narrowed
+            details::apply<details::VertexProperties>(mesh, options, "v:color", false);
+            details::apply<details::HalfedgeProperties>(mesh, options, "", false);
+            details::apply<details::EdgeProperties>(mesh, options, "e:color", false);
+            details::apply<details::FaceProperties>(mesh, options, "f:color", false);
+        }
+
+    } // namespace io
+
+} // namespace easy3d
@@ -0,0 +1,118 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_FILEIO_LOAD_OPTIONS_H
+#define EASY3D_FILEIO_LOAD_OPTIONS_H
+
+#include <string>
+#include <vector>
+
+
+namespace easy3d {
+
+    class PointCloud;
+    class SurfaceMesh;
+
+    /**
+     * \brief Options controlling which properties the loaders import and how the imported properties are stored.
+     * \class LoadOptions easy3d/fileio/load_options.h
+     * \details By default, all properties found in a file are imported in full precision (e.g., colors as \c vec3,
+     *      labels as \c int). If only a few properties are needed, list them in \c properties. Storage narrowing
+     *      changes the types of the properties, and stores them under distinct names (the original name followed by
+     *      a suffix naming the storage type):
+     *      - colors ("v:color", "e:color", "f:color") are stored as \c u8vec3 (see rgb::pack()), e.g., "v:color_u8";
+     *      - normals of point clouds ("v:normal") are stored as \c hvec3 (half floats, see half::pack()) in
+     *        "v:normal_h";
+     *      - integer properties (e.g., labels, classifications) whose values fit are stored as \c unsigned \c char
+     *        or \c unsigned \c short, e.g., "v:classification_u8" or "v:classification_u16".
+     *      The buffer builders and the default rendering state of the renderer (see buffers.h) use the narrowed
+     *      properties directly. Algorithms only see the full-precision names, so they never meet a property of an
+     *      unexpected type: e.g., estimating the normals of a point cloud loaded with \c half_normals creates a new
+     *      "v:normal". Use narrowing for viewing or for pipelines that only need a subset of the data.
+     * \note Vertex normals of surface meshes are never narrowed because they are (re)computed for rendering.
+     * Example usage:
+     *      \code
+     *      LoadOptions options;
+     *      options.properties = {"v:color", "v:classification"};
+     *      options.narrow_colors = true;
+     *      options.narrow_labels = true;
+     *      PointCloud* cloud = PointCloudIO::load(file_name, options);
+     *      \endcode
+     */
+    struct LoadOptions {
+        LoadOptions();
+
+        /// \brief Options importing all properties without narrowing (i.e., the default behavior of the loaders).
+        static LoadOptions all();
+        /// \brief Options importing only the vertex coordinates (and the connectivity for surface meshes).
+        static LoadOptions positions_only();
+        /// \brief Options importing all properties with all storage narrowing enabled.
+        static LoadOptions compact();
+
+        /// \brief Returns whether the property named \p name should be imported.
+        /// \details The vertex coordinates ("v:point") and the properties holding the connectivity of a surface mesh
+        ///     are always imported.
+        bool imports(const std::string& name) const;
+
+        /// \brief Returns whether any storage narrowing is requested.
+        bool narrows() const { return narrow_colors || half_normals || narrow_labels; }
+
+        /// The names of the properties to import, e.g., "v:color", "v:normal", "f:chart". Empty means all.
+        std::vector<std::string> properties;
+        /// Stores colors as \c u8vec3 (3 bytes instead of 12).
+        bool narrow_colors;
+        /// Stores the vertex normals of point clouds as \c hvec3 (6 bytes instead of 12).
+        bool half_normals;
+        /// Stores integer properties as \c unsigned \c char or \c unsigned \c short if all their values fit.
+        bool narrow_labels;
+    };
+
+
+    namespace io {
+
+        /**
+         * \brief Removes the properties not requested by \p options from a loaded point cloud and narrows the storage of
+         *      the remaining ones.
+         * \details This is used by PointCloudIO::load() for file formats that can not select or narrow properties
+         *      while reading. It does nothing for the default options.
+         */
+        void apply_load_options(PointCloud* cloud, const LoadOptions& options);
+
+        /**
+         * \brief Removes the properties not requested by \p options from a loaded surface mesh and narrows the storage
+         *      of the remaining ones.
+         * \details This is used by SurfaceMeshIO::load() for file formats that can not select or narrow properties
+         *      while reading. It does nothing for the default options.
+         */
+        void apply_load_options(SurfaceMesh* mesh, const LoadOptions& options);
+
+    } // namespace io
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_FILEIO_LOAD_OPTIONS_H
@@ -32,32 +32,36 @@
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
 
 
-	PointCloud* PointCloudIO::load(const std::string& file_name)
+	PointCloud* PointCloudIO::load(const std::string& file_name, const LoadOptions& options)
 	{
 		std::setlocale(LC_NUMERIC, "C");
 
 		PointCloud* cloud = new PointCloud;
 		cloud->set_name(file_name);
 
+		EASY3D_PROFILE_ZONE("PointCloudIO::load");
 		StopWatch w;
 		bool success = false;
 
         const std::string& ext = file_system::extension(file_name, true);
         if (ext == "ply")
-			success = io::load_ply(file_name, cloud);
+			success = io::load_ply(file_name, cloud, options);
 		else if (ext == "bin")
 			success = io::load_bin(file_name, cloud);
+		else if (ext == "cbin")
+			success = io::load_cbin(file_name, cloud);
 		else if (ext == "xyz")
 			success = io::load_xyz(file_name, cloud);
 		else if (ext == "bxyz")
 			success = io::load_bxyz(file_name, cloud);
 		else if (ext == "las" || ext == "laz")
-			success = io::load_las(file_name, cloud);
+			success = io::load_las(file_name, cloud, options);
         else if (ext == "vg")
             success = io::PointCloudIO_vg::load_vg(file_name, cloud);
         else if (ext == "bvg")
@@ -78,6 +82,13 @@ namespace easy3d {
 			return nullptr;
 		}
 
+        // selects the properties and narrows their storage (does nothing for the properties already handled by the
+        // format-specific loader)
+        io::apply_load_options(cloud, options);
+
+        EASY3D_PROFILE_ELEMENTS(cloud->n_vertices());
+        EASY3D_PROFILE_BYTES(static_cast<std::size_t>(file_system::file_size(file_name)));
+
         if (success)
             LOG(INFO) << "point cloud loaded ("
                       << "#vertex: " << cloud->n_vertices() << "). "
@@ -95,6 +106,7 @@ namespace easy3d {
 			return false;
 		}
 
+        EASY3D_PROFILE_ZONE("PointCloudIO::save");
         StopWatch w;
         bool success = false;
 
@@ -109,6 +121,8 @@ namespace easy3d {
         }
 		else if (ext == "bin")
             success = io::save_bin(final_name, cloud);
+		else if (ext == "cbin")
+            success = io::save_cbin(final_name, cloud);
 		else if (ext == "xyz")
             success = io::save_xyz(final_name, cloud);
 		else if (ext == "bxyz")
@@ -124,6 +138,8 @@ namespace easy3d {
             success = false;
 		}
 
+        EASY3D_PROFILE_ELEMENTS(cloud->n_vertices());
+
         if (success) {
             LOG(INFO) << "save model done. " << w.time_string();
             return true;
@@ -30,6 +30,8 @@
 #include <iostream>
 #include <vector>
 
+#include <easy3d/fileio/load_options.h>
+
 
 namespace easy3d {
 
@@ -45,16 +47,20 @@ namespace easy3d {
 	public:
         /**
          * \brief Reads a point cloud from file \p file_name.
-         * \details File extension determines file format (bin, xyz/bxyz, ply, las/laz, vg/bvg)
+         * \details File extension determines file format (bin, cbin, xyz/bxyz, ply, las/laz, vg/bvg)
          * and type (i.e. binary or ASCII).
+         * \param options Which properties to import and how to store them. The ply and las/laz formats apply the
+         *      options while reading, and the other formats after reading. By default, all properties are imported in
+         *      full precision.
          * \return The pointer of the point cloud (nullptr if failed).
          */
-		static PointCloud* load(const std::string& file_name);
+		static PointCloud* load(const std::string& file_name, const LoadOptions& options = LoadOptions());
 
         /**
          * \brief Saves a point_cloud to a file.
-         * \details File extension determines file format (bin, xyz/bxyz, ply, las/laz, vg/bvg) and type (i.e. binary
-         * or ASCII).
+         * \details File extension determines file format (bin, cbin, xyz/bxyz, ply, las/laz, vg/bvg) and type (i.e.
+         * binary or ASCII). The \c cbin format is saved with 16-bit quantized coordinates (use save_cbin() for a
+         * different precision).
          * \param file_name The file name.
          * \param cloud The point cloud.
          * \return The status of the operation
@@ -76,6 +82,17 @@ namespace easy3d {
         /// and normals (optional).
 		bool save_bin(const std::string& file_name, const PointCloud* cloud);
 
+        /// \brief Reads point cloud from a \c cbin (i.e., compressed \c bin) format file.
+        /// \details The data is stored in chunks that are decompressed in parallel.
+        bool load_cbin(const std::string& file_name, PointCloud* cloud);
+        /// \brief Saves a point cloud to a \c cbin (i.e., compressed \c bin) format file.
+        /// \details The coordinates are quantized to \p bits bits w.r.t. the bounding box of the points, the normals
+        /// (optional) are encoded in 32 bits (octahedral mapping), and the colors (optional) in 24 bits. All data is
+        /// delta-coded (if applicable) and compressed in chunks.
+        /// \param bits The number of bits of each quantized coordinate (1 to 31). The maximum quantization error is
+        ///     half the bounding box size divided by (2^bits - 1).
+        bool save_cbin(const std::string& file_name, const PointCloud* cloud, int bits = 16);
+
         /// \brief Reads point cloud from an \c xyz format file.
         /// \details Each line of an \c xyz file contains three floating point numbers representing the \p x, \p y, and
         /// \p z coordinates of a point.
@@ -87,13 +104,16 @@ namespace easy3d {
 		bool save_bxyz(const std::string& file_name, const PointCloud* cloud);
 
         /// \brief Reads point cloud from a \c ply format file.
-		bool load_ply(const std::string& file_name, PointCloud* cloud);
+        /// \details Only the properties requested by \p options are imported (the storage narrowing is not applied).
+		bool load_ply(const std::string& file_name, PointCloud* cloud, const LoadOptions& options = LoadOptions());
         /// \brief Saves a point cloud to a \c ply format file.
 		bool save_ply(const std::string& file_name, const PointCloud* cloud, bool binary = true);
 
         /// \brief Reads point cloud from an \c las/laz format file.
         ///     Internally the method uses the LASlib of martin.isenburg@rapidlasso.com. See http://rapidlasso.com
-        bool load_las(const std::string &file_name, PointCloud *cloud);
+        /// \details The colors ("v:color") and classifications ("v:classification") are imported only if requested by
+        ///     \p options, and they are stored in \c u8vec3 and \c unsigned \c char if narrowing is requested.
+        bool load_las(const std::string &file_name, PointCloud *cloud, const LoadOptions &options = LoadOptions());
         /// \brief Saves a point cloud to an \c LAS/LAS format file.
         /// \details Internally it uses the LASlib of martin.isenburg@rapidlasso.com. See http://rapidlasso.com
 		bool save_las(const std::string& file_name, const PointCloud* cloud);
@@ -0,0 +1,194 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/point_cloud_io.h>
+
+#include <fstream>
+#include <cstring>
+
+#include <easy3d/fileio/compression.h>
+#include <easy3d/fileio/translator.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/attribute_packing.h>
+#include <easy3d/util/thread_pool.h>
+
+
+namespace easy3d {
+
+
+	namespace io {
+
+		namespace details {
+
+			const char cbin_magic[4] = {'E', '3', 'P', 'C'};
+			const int32_t cbin_version = 2;
+
+			enum CbinFlags {
+				CBIN_HAS_COLORS = 1,
+				CBIN_HAS_NORMALS = 2
+			};
+
+		} // namespace details
+
+
+		bool load_cbin(const std::string& file_name, PointCloud* cloud) {
+			std::ifstream input(file_name.c_str(), std::fstream::binary);
+			if (input.fail()) {
+				LOG(ERROR) << "could not open file: " << file_name;
+				return false;
+			}
+
+			char magic[4];
+			int32_t version = 0;
+			uint32_t num = 0, flags = 0;
+			input.read(magic, 4);
+			input.read((char*)&version, sizeof(int32_t));
+			input.read((char*)&num, sizeof(uint32_t));
+			input.read((char*)&flags, sizeof(uint32_t));
+			if (input.fail() || std::memcmp(magic, details::cbin_magic, 4) != 0 || version != details::cbin_version) {
+				LOG(ERROR) << "not a compressed point cloud file (or unsupported version): " << file_name;
+				return false;
+			}
+			if (num == 0) {
+				LOG(ERROR) << "no point exists in file: " << file_name;
+				return false;
+			}
+			cloud->resize(num);
+
+			// read the points block (relative to the minimum corner of the bounding box)
+			auto& points = cloud->get_vertex_property<vec3>("v:point").vector();
+			dvec3 bmin;
+			if (!read_quantized_positions(input, points.data(), num, bmin))
+				return false;
+
+			if (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT) {
+				const vec3 p0 = points[0];
+				const dvec3 origin = bmin + dvec3(p0.data());
+				Translator::instance()->set_translation(origin);
+				parallel_for(std::size_t(0), points.size(), [&](std::size_t i) {
+					points[i] -= p0;
+				});
+
+				auto trans = cloud->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
+				trans[0] = origin;
+				LOG(INFO) << "model translated w.r.t. the first vertex (" << origin
+						  << "), stored as ModelProperty<dvec3>(\"translation\")";
+			}
+			else {
+				dvec3 origin(0, 0, 0);
+				if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET)
+					origin = Translator::instance()->translation();
+				const vec3 offset(bmin - origin);
+				parallel_for(std::size_t(0), points.size(), [&](std::size_t i) {
+					points[i] += offset;
+				});
+
+				if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET) {
+					auto trans = cloud->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
+					trans[0] = origin;
+					LOG(INFO) << "model translated w.r.t. last known reference point (" << origin
+							  << "), stored as ModelProperty<dvec3>(\"translation\")";
+				}
+			}
+
+			// read the colors block if exists
+			if (flags & details::CBIN_HAS_COLORS) {
+				std::vector<unsigned char> rgb(num * 3);
+				if (!read_compressed_array(input, rgb.data(), num, 3))
+					return false;
+				auto& colors = cloud->vertex_property<vec3>("v:color").vector();
+				parallel_for(0u, num, [&](uint32_t i) {
+					colors[i] = vec3(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]) / 255.0f;
+				});
+			}
+
+			// read the normals block if exists
+			if (flags & details::CBIN_HAS_NORMALS) {
+				std::vector<uint32_t> codes(num);
+				if (!read_compressed_array(input, codes.data(), num, sizeof(uint32_t)))
+					return false;
+				auto& normals = cloud->vertex_property<vec3>("v:normal").vector();
+				parallel_for(0u, num, [&](uint32_t i) {
+					normals[i] = packing::decode_octahedral(codes[i]);
+				});
+			}
+
+			return cloud->n_vertices() > 0;
+		}
+
+
+		bool save_cbin(const std::string& file_name, const PointCloud* cloud, int bits) {
+			std::ofstream output(file_name.c_str(), std::fstream::binary);
+			if (output.fail()) {
+				LOG(ERROR) << "could not open file: " << file_name;
+				return false;
+			}
+
+			const uint32_t num = cloud->n_vertices();
+			auto colors = cloud->get_vertex_property<vec3>("v:color");
+			auto normals = cloud->get_vertex_property<vec3>("v:normal");
+			uint32_t flags = 0;
+			if (colors)
+				flags |= details::CBIN_HAS_COLORS;
+			if (normals)
+				flags |= details::CBIN_HAS_NORMALS;
+
+			output.write(details::cbin_magic, 4);
+			output.write((const char*)&details::cbin_version, sizeof(int32_t));
+			output.write((const char*)&num, sizeof(uint32_t));
+			output.write((const char*)&flags, sizeof(uint32_t));
+
+			dvec3 translation(0, 0, 0);
+			auto trans = cloud->get_model_property<dvec3>("translation");
+			if (trans)
+				translation = trans[0];
+			write_quantized_positions(output, cloud->points().data(), num, translation, bits);
+
+			if (colors) {
+				std::vector<unsigned char> rgb(num * 3);
+				parallel_for(0u, num, [&](uint32_t i) {
+					const vec3& c = colors.vector()[i];
+					for (int j = 0; j < 3; ++j)
+						rgb[i * 3 + j] = static_cast<unsigned char>(std::min(1.0f, std::max(0.0f, c[j])) * 255.0f + 0.5f);
+				});
+				write_compressed_array(output, rgb.data(), num, 3);
+			}
+
+			if (normals) {
+				std::vector<uint32_t> codes(num);
+				parallel_for(0u, num, [&](uint32_t i) {
+					codes[i] = packing::encode_octahedral(normals.vector()[i]);
+				});
+				write_compressed_array(output, codes.data(), num, sizeof(uint32_t));
+			}
+
+			return !output.fail();
+		}
+
+	} // namespace io
+
+} // namespace easy3d
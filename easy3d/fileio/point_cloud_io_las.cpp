@@ -42,7 +42,7 @@ namespace easy3d {
     namespace io {
 
 
-        bool load_las(const std::string &file_name, PointCloud *cloud) {
+        bool load_las(const std::string &file_name, PointCloud *cloud, const LoadOptions &options) {
             LASreadOpener lasreadopener;
             lasreadopener.set_file_name(file_name.c_str(), true);
 
@@ -99,11 +99,37 @@ namespace easy3d {
             float g = p0.have_rgb ? float(p0.get_G()) / USHRT_MAX : p0.intensity % 255 / 255.0f;
             float b = p0.have_rgb ? float(p0.get_B()) / USHRT_MAX : p0.intensity % 255 / 255.0f;
 
-            auto colors = cloud->add_vertex_property<vec3>("v:color");
-            auto classification = cloud->add_vertex_property<int>("v:classification");
+            // colors and classifications are stored in the requested types right away (see LoadOptions)
+            PointCloud::VertexProperty<vec3> colors;
+            PointCloud::VertexProperty<u8vec3> narrowed_colors;
+            if (options.imports("v:color")) {
+                if (options.narrow_colors)
+                    narrowed_colors = cloud->add_vertex_property<u8vec3>("v:color_u8");
+                else
+                    colors = cloud->add_vertex_property<vec3>("v:color");
+            }
+            PointCloud::VertexProperty<int> classification;
+            PointCloud::VertexProperty<unsigned char> narrowed_classification;
+            if (options.imports("v:classification")) {
+                if (options.narrow_labels)  // LAS classifications are 8-bit
+                    narrowed_classification = cloud->add_vertex_property<unsigned char>("v:classification_u8");
+                else
+                    classification = cloud->add_vertex_property<int>("v:classification");
+            }
+
+            auto store_attributes = [&](PointCloud::Vertex v, const LASpoint &p, float r, float g, float b) {
+                if (colors)
+                    colors[v] = vec3(r, g, b);
+                else if (narrowed_colors)
+                    narrowed_colors[v] = rgb::pack(vec3(r, g, b));
+                if (classification)
+                    classification[v] = p.classification;
+                else if (narrowed_classification)
+                    narrowed_classification[v] = p.classification;
+            };
+
             auto v = cloud->add_vertex(vec3(float(x0 - origin_x), float(y0 - origin_y), float(z0 - origin_z)));
-            colors[v] = vec3(r, g, b);
-            classification[v] = p0.classification;
+            store_attributes(v, p0, r, g, b);
 
             // now we read the remaining points...
             while (lasreader->read_point()) {
@@ -120,8 +146,7 @@ namespace easy3d {
                 g = p.have_rgb ? float(p.get_G()) / USHRT_MAX : p.intensity % 255 / 255.0f;
                 b = p.have_rgb ? float(p.get_B()) / USHRT_MAX : p.intensity % 255 / 255.0f;
 
-                colors[v] = vec3(r, g, b);
-                classification[v] = p.classification;
+                store_attributes(v, p, r, g, b);
             }
 
             if (translate) {
@@ -39,12 +39,14 @@ namespace easy3d {
         namespace details {
 
 			template <typename T, typename PropertyT>
-			inline void add_properties(PointCloud* cloud, const std::vector<PropertyT>& properties)
+			inline void add_properties(PointCloud* cloud, const std::vector<PropertyT>& properties, const LoadOptions& options)
 			{
 				for (const auto& p : properties) {
                     std::string name = p.name;
 					if (name.find("v:") == std::string::npos)
 						name = "v:" + name;
+					if (!options.imports(name))
+						continue;
 					auto prop = cloud->vertex_property<T>(name);
 					prop.vector() = p;
 				}
@@ -52,7 +54,7 @@ namespace easy3d {
 
 		} // namespace details
 
-		bool load_ply(const std::string& file_name, PointCloud* cloud) {
+		bool load_ply(const std::string& file_name, PointCloud* cloud, const LoadOptions& options) {
 			std::vector<Element> elements;
 			PlyReader reader;
 			if (!reader.read(file_name, elements))
@@ -69,12 +71,12 @@ namespace easy3d {
 			for (std::size_t i = 0; i < elements.size(); ++i) {
 				const Element& e = elements[i];
                 if (e.name == "vertex") {
-                    details::add_properties<vec3>(cloud, e.vec3_properties);
-                    details::add_properties<vec2>(cloud, e.vec2_properties);
-                    details::add_properties<float>(cloud, e.float_properties);
-                    details::add_properties<int>(cloud, e.int_properties);
-                    details::add_properties< std::vector<int> >(cloud, e.int_list_properties);
-                    details::add_properties< std::vector<float> >(cloud, e.float_list_properties);
+                    details::add_properties<vec3>(cloud, e.vec3_properties, options);
+                    details::add_properties<vec2>(cloud, e.vec2_properties, options);
+                    details::add_properties<float>(cloud, e.float_properties, options);
+                    details::add_properties<int>(cloud, e.int_properties, options);
+                    details::add_properties< std::vector<int> >(cloud, e.int_list_properties, options);
+                    details::add_properties< std::vector<float> >(cloud, e.float_list_properties, options);
                 }
                 else {
                     const std::string name = "element-" + e.name;
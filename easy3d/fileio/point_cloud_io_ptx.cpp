@@ -27,13 +27,17 @@
 #include <easy3d/fileio/point_cloud_io_ptx.h>
 
 #include <cassert>
+#include <cstring>
+#include <cstdlib>
 #include <fstream>
+#include <atomic>
 
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/line_stream.h>
 #include <easy3d/util/logging.h>
 #include <easy3d/util/progress.h>
+#include <easy3d/util/thread_pool.h>
 
 
 namespace easy3d {
@@ -42,6 +46,254 @@ namespace easy3d {
 
         /// TODO: Translator not implemented
 
+		namespace details {
+
+			// The header of a scan.
+			struct ScanHeader {
+				int cols;
+				int rows;
+				mat4 transform;
+			};
+
+			// Returns the beginning of the next line (or 'end' if it is the last line).
+			inline const char* next_line(const char* line, const char* end) {
+				const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+				return eol ? eol + 1 : end;
+			}
+
+			// Parses up to 'n' floating point numbers from a line [line, eol). Returns the number of values read.
+			inline int parse_values(const char* line, const char* eol, double* values, int n) {
+				int count = 0;
+				const char* cur = line;
+				while (count < n) {
+					while (cur < eol && (*cur == ' ' || *cur == '\t' || *cur == '\r'))
+						++cur;
+					if (cur >= eol || *cur == '\n')
+						break;
+					char* next = nullptr;
+					values[count] = std::strtod(cur, &next);
+					if (next == cur || next > eol)
+						break;
+					cur = next;
+					++count;
+				}
+				return count;
+			}
+
+			// Reads a file block by block. Only complete lines are exposed, i.e., [cur, end) always ends with a line
+			// break (or at the end of the file); the incomplete last line of a block is carried over to the next one.
+			class BlockReader {
+			public:
+				BlockReader(std::istream& input, std::size_t block_size)
+					: input_(input), buffer_(block_size), size_(0), consumed_(0), eof_(false)
+				{
+					cur = end = buffer_.data();
+				}
+
+				// Reads the next block (keeping the unparsed bytes). Returns false if there is nothing left to read.
+				bool fill() {
+					const std::size_t parsed = cur - buffer_.data();
+					const std::size_t kept = size_ - parsed;
+					std::memmove(buffer_.data(), cur, kept);
+					consumed_ += parsed;
+					size_ = kept;
+					while (true) {
+						if (!eof_) {
+							input_.read(buffer_.data() + size_, static_cast<std::streamsize>(buffer_.size() - size_));
+							size_ += static_cast<std::size_t>(input_.gcount());
+							eof_ = !input_;
+						}
+						cur = buffer_.data();
+						if (eof_) {
+							end = cur + size_;
+							return size_ > 0;
+						}
+						// the last line break of the block
+						for (std::size_t i = size_; i > 0; --i) {
+							if (buffer_[i - 1] == '\n') {
+								end = cur + i;
+								return true;
+							}
+						}
+						buffer_.resize(buffer_.size() * 2); // a line longer than the block
+					}
+				}
+
+				// The number of bytes parsed so far.
+				std::size_t position() const { return consumed_ + (cur - buffer_.data()); }
+
+			public:
+				const char* cur;	// the first unparsed line
+				const char* end;	// one past the last complete line
+
+			private:
+				std::istream& input_;
+				std::vector<char> buffer_;
+				std::size_t size_;		// the number of valid bytes in the buffer
+				std::size_t consumed_;	// the number of bytes discarded from the buffer
+				bool eof_;
+			};
+
+			// Reads the next non-empty line into 'values'. Returns the number of values read (0 at the end of file).
+			inline int read_header_line(BlockReader& reader, double* values, int n) {
+				while (reader.cur < reader.end || reader.fill()) {
+					const char* next = next_line(reader.cur, reader.end);
+					const int count = parse_values(reader.cur, next, values, n);
+					reader.cur = next;
+					if (count > 0)
+						return count;
+				}
+				return 0;
+			}
+
+			enum HeaderStatus { HEADER_OK, HEADER_END, HEADER_ERROR };
+
+			// Reads the header of the next scan.
+			HeaderStatus read_scan_header(BlockReader& reader, ScanHeader& scan, std::size_t index) {
+				double v[4];
+				if (read_header_line(reader, v, 1) != 1)
+					return HEADER_END;
+				scan.cols = static_cast<int>(v[0]);
+				if (read_header_line(reader, v, 1) != 1) {
+					LOG(ERROR) << "failed reading the number of rows of scan #" << index;
+					return HEADER_ERROR;
+				}
+				scan.rows = static_cast<int>(v[0]);
+				if (scan.cols <= 0 || scan.rows <= 0) {
+					LOG(ERROR) << "unrecognized file format: invalid grid size of scan #" << index;
+					return HEADER_ERROR;
+				}
+
+				// the scanner position and axes (not used)
+				for (int i = 0; i < 4; ++i) {
+					if (read_header_line(reader, v, 3) != 3) {
+						LOG(ERROR) << "failed reading sensor transformation matrix of scan #" << index;
+						return HEADER_ERROR;
+					}
+				}
+
+				// the cloud transformation matrix (transposed in the file, i.e., the last row is the translation)
+				vec4 cols[4];
+				for (int i = 0; i < 4; ++i) {
+					if (read_header_line(reader, v, 4) != 4) {
+						LOG(ERROR) << "failed reading point cloud transformation matrix of scan #" << index;
+						return HEADER_ERROR;
+					}
+					cols[i] = vec4(static_cast<float>(v[0]), static_cast<float>(v[1]),
+								   static_cast<float>(v[2]), static_cast<float>(v[3]));
+				}
+				scan.transform = mat4(cols[0], cols[1], cols[2], cols[3]);
+				return HEADER_OK;
+			}
+
+			// Reads the points of a scan (following its header), transforms them, and writes them to 'points' and the
+			// colors (if 'colors' is not null) to 'colors'. Each block is split into chunks of complete lines that are
+			// processed in parallel: the lines of the chunks are counted first, so the index of the first point of
+			// each chunk is known.
+			bool read_scan_points(BlockReader& reader, const ScanHeader& scan, vec3* points, vec3* colors,
+								  ProgressLogger& progress)
+			{
+				const std::size_t num = static_cast<std::size_t>(scan.cols) * scan.rows;
+				const int num_columns = colors ? 7 : 4;
+
+				// The matrix is affine, so no homogeneous division is needed.
+				const mat4& m = scan.transform;
+				const float m00 = m(0, 0), m01 = m(0, 1), m02 = m(0, 2), m03 = m(0, 3);
+				const float m10 = m(1, 0), m11 = m(1, 1), m12 = m(1, 2), m13 = m(1, 3);
+				const float m20 = m(2, 0), m21 = m(2, 1), m22 = m(2, 2), m23 = m(2, 3);
+
+				const std::size_t max_chunks = ThreadPool::concurrency() * 8;
+				std::vector<const char*> bounds;
+				std::vector<std::size_t> first;
+				std::size_t idx = 0;
+				while (idx < num) {
+					if (progress.is_canceled()) {
+						LOG(WARNING) << "loading point cloud file cancelled";
+						return false;
+					}
+					if (reader.cur >= reader.end && !reader.fill()) {
+						LOG(ERROR) << "unexpected end of file: the scan should have " << num << " points but only "
+								   << idx << " found";
+						return false;
+					}
+
+					// split the block into chunks of complete lines
+					const std::size_t bytes = reader.end - reader.cur;
+					bounds.assign(1, reader.cur);
+					for (std::size_t c = 1; c < max_chunks; ++c) {
+						const std::size_t split = bytes * c / max_chunks;
+						if (split == 0)
+							continue;
+						// the beginning of the first line starting at or after the split position
+						const char* pos = next_line(reader.cur + split - 1, reader.end);
+						if (pos > bounds.back() && pos < reader.end)
+							bounds.push_back(pos);
+					}
+					bounds.push_back(reader.end);
+					std::size_t num_chunks = bounds.size() - 1;
+
+					// count the lines of the chunks
+					first.assign(num_chunks + 1, 0);
+					parallel_for(std::size_t(0), num_chunks, [&](std::size_t c) {
+						std::size_t count = 0;
+						for (const char* line = bounds[c]; line < bounds[c + 1]; line = next_line(line, bounds[c + 1]))
+							++count;
+						first[c + 1] = count;
+					}, nullptr, 1);
+					for (std::size_t c = 0; c < num_chunks; ++c)
+						first[c + 1] += first[c];
+
+					// the block may contain the next scan: stop at the last point of this scan
+					const std::size_t remaining = num - idx;
+					if (first[num_chunks] > remaining) {
+						std::size_t c = 0;
+						while (first[c + 1] <= remaining)
+							++c;
+						const char* line = bounds[c];
+						for (std::size_t i = first[c]; i < remaining; ++i)
+							line = next_line(line, bounds[c + 1]);
+						bounds[c + 1] = line;
+						first[c + 1] = remaining;
+						num_chunks = c + 1;
+					}
+
+					std::atomic<bool> success(true);
+					const bool finished = parallel_for(std::size_t(0), num_chunks, [&](std::size_t c) {
+						double v[7];
+						std::size_t i = idx + first[c];
+						for (const char* line = bounds[c]; line < bounds[c + 1] && success; ++i) {
+							const char* next = next_line(line, bounds[c + 1]);
+							if (parse_values(line, next, v, num_columns) != num_columns) {
+								LOG_N_TIMES(3, ERROR) << "failed reading the " << i << "_th point. " << COUNTER;
+								success = false;
+								return;
+							}
+							const float x = static_cast<float>(v[0]), y = static_cast<float>(v[1]), z = static_cast<float>(v[2]);
+							points[i] = vec3(m00 * x + m01 * y + m02 * z + m03,
+											 m10 * x + m11 * y + m12 * z + m13,
+											 m20 * x + m21 * y + m22 * z + m23);
+							if (colors)
+								colors[i] = vec3(static_cast<float>(v[4]), static_cast<float>(v[5]), static_cast<float>(v[6])) / 255.0f;
+							line = next;
+						}
+					}, &progress, 1);
+					if (!finished) {
+						LOG(WARNING) << "loading point cloud file cancelled";
+						return false;
+					}
+					if (!success)
+						return false;
+
+					idx += first[num_chunks];
+					reader.cur = bounds[num_chunks];
+					progress.notify(reader.position());
+				}
+				return true;
+			}
+
+		} // namespace details
+
+
 		PointCloudIO_ptx::PointCloudIO_ptx(const std::string& file_name)
 			: input_(nullptr)
 			, in_(nullptr)
@@ -200,6 +452,91 @@ namespace easy3d {
 			}
 		}
 
+
+		std::vector<PointCloud*> PointCloudIO_ptx::load_all(bool merge) {
+			std::vector<PointCloud*> clouds;
+
+			std::ifstream input(file_name_.c_str(), std::ios::binary | std::ios::ate);
+			if (input.fail()) {
+				LOG(ERROR) << "could not open file: " << file_name_;
+				return clouds;
+			}
+			const std::size_t size = static_cast<std::size_t>(input.tellg());
+			input.seekg(0, std::ios::beg);
+
+			// the file is read block by block, so only a block (instead of the whole file) is held in memory
+			details::BlockReader reader(input, 8 * 1024 * 1024);
+			ProgressLogger progress(size, true, false);
+
+			PointCloud* merged = nullptr;
+			PointCloud::VertexProperty<int> scan_id;
+			std::vector<Grid> grids;
+			if (merge) {
+				merged = new PointCloud;
+				merged->set_name(file_name_);
+				scan_id = merged->add_vertex_property<int>("v:scan_id");
+				clouds.push_back(merged);
+			}
+
+			bool has_colors = false;
+			details::ScanHeader scan;
+			for (std::size_t index = 0; ; ++index) {
+				const details::HeaderStatus status = details::read_scan_header(reader, scan, index);
+				if (status == details::HEADER_END && index > 0)
+					break;
+				if (status != details::HEADER_OK) {
+					LOG_IF(status == details::HEADER_END, ERROR) << "no scan found in file: " << file_name_;
+					for (auto c : clouds)
+						delete c;
+					return std::vector<PointCloud*>();
+				}
+
+				const std::size_t num = static_cast<std::size_t>(scan.cols) * scan.rows;
+				LOG(INFO) << "loading sub scan " << file_system::simple_name(file_name_) << "-#" << index << " with "
+						  << num << " points...";
+
+				// test if the file has color information (from the first point of the first scan)
+				if (index == 0 && (reader.cur < reader.end || reader.fill())) {
+					double v[7];
+					has_colors = (details::parse_values(reader.cur, details::next_line(reader.cur, reader.end), v, 7) == 7);
+				}
+
+				PointCloud* cloud = merged;
+				std::size_t offset = 0;
+				if (merge)
+					offset = merged->n_vertices();
+				else {
+					cloud = new PointCloud;
+					cloud->set_name(file_system::name_less_extension(file_name_) + "-#" + std::to_string(index));
+					clouds.push_back(cloud);
+				}
+				cloud->resize(static_cast<unsigned int>(offset + num));
+				auto points = cloud->get_vertex_property<vec3>("v:point");
+				PointCloud::VertexProperty<vec3> colors;
+				if (has_colors)
+					colors = cloud->vertex_property<vec3>("v:color");
+
+				if (!details::read_scan_points(reader, scan, points.vector().data() + offset,
+											   has_colors ? colors.vector().data() + offset : nullptr, progress)) {
+					for (auto c : clouds)
+						delete c;
+					return std::vector<PointCloud*>();
+				}
+
+				if (merge) {
+					std::fill(scan_id.vector().begin() + offset, scan_id.vector().end(), static_cast<int>(index));
+					grids.push_back({static_cast<int>(offset), scan.cols, scan.rows});
+				}
+				else
+					cloud->add_model_property<std::vector<Grid> >("scan_grids", std::vector<Grid>(1, {0, scan.cols, scan.rows}));
+			}
+
+			if (merge)
+				merged->add_model_property<std::vector<Grid> >("scan_grids", grids);
+
+			return clouds;
+		}
+
 	} // namespace io
 
 } // namespace easy3d
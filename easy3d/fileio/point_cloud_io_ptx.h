@@ -28,6 +28,7 @@
 #define EASY3D_FILEIO_POINT_CLOUD_IO_PTX_H
 
 #include <string>
+#include <vector>
 
 namespace easy3d {
 
@@ -120,6 +121,13 @@ namespace easy3d {
 		 *			addModel(model);
 		 *		}
 		 *		\endcode
+		 *  or, for large multi-scan files, load all the scans at once (in parallel)
+		 *      \code
+		 *		PointCloudIO_ptx serializer(file_name);
+		 *		const std::vector<PointCloud*> clouds = serializer.load_all();
+		 *		for (auto cloud : clouds)
+		 *			addModel(cloud);
+		 *		\endcode
 		 */
 
 		class PointCloudIO_ptx
@@ -131,6 +139,39 @@ namespace easy3d {
 			/// \brief Reads a single point cloud from the file.
 			PointCloud* load_next();
 
+			/**
+			 * \brief The grid structure of a scan.
+			 * \details PTX scans are "fully populated", i.e., every grid cell has a point (missing points have
+			 *      coordinates (0, 0, 0)). The points of a scan are stored column by column, so the point at column
+			 *      \c col and row \c row is the vertex with index \c index(col, row). This allows image-space
+			 *      neighbor queries without a kd-tree.
+			 */
+			struct Grid {
+				int offset; ///< The index of the first point of the scan in the point cloud.
+				int cols;   ///< The number of columns of the scan.
+				int rows;   ///< The number of rows of the scan.
+				/// \brief The vertex index of the point at (\p col, \p row), or -1 if it is out of the grid.
+				int index(int col, int row) const {
+					if (col < 0 || col >= cols || row < 0 || row >= rows)
+						return -1;
+					return offset + col * rows + row;
+				}
+			};
+
+			/**
+			 * \brief Reads all point clouds (i.e., scans) from the file.
+			 * \details The file is read block by block (so only a block is held in memory besides the point clouds),
+			 *      and the points of each block are parsed and transformed in parallel. The progress is reported and
+			 *      loading can be canceled, like load_next(). The grid structure of the scans is stored as a model property
+			 *      "scan_grids" of type std::vector<PointCloudIO_ptx::Grid> (one element per scan).
+			 * \param merge If true, all scans are merged into a single point cloud, and the scan each point belongs to
+			 *      is stored in the vertex property "v:scan_id" (of type int). Otherwise, each scan is returned as a
+			 *      separate point cloud.
+			 * \return The point clouds (a single one if \p merge is true). Empty if loading failed.
+			 * \note load_all() reads the file independently of load_next().
+			 */
+			std::vector<PointCloud*> load_all(bool merge = false);
+
 		private:
 			std::ifstream*		input_;
 			LineInputStream*	in_;
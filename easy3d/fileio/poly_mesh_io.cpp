@@ -32,6 +32,7 @@
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
@@ -43,6 +44,7 @@ namespace easy3d {
         PolyMesh* mesh = new PolyMesh;
         mesh->set_name(file_name);
 
+        EASY3D_PROFILE_ZONE("PolyMeshIO::load");
         StopWatch w;
         bool success = false;
 
@@ -68,6 +70,9 @@ namespace easy3d {
             return nullptr;
         }
 
+        EASY3D_PROFILE_ELEMENTS(mesh->n_vertices());
+        EASY3D_PROFILE_BYTES(static_cast<std::size_t>(file_system::file_size(file_name)));
+
         if (success)
             LOG(INFO) << "polyhedral mesh loaded ("
                       << "#vertex: " << mesh->n_vertices() << ", "
@@ -94,6 +99,7 @@ namespace easy3d {
             return false;
         }
 
+        EASY3D_PROFILE_ZONE("PolyMeshIO::save");
         StopWatch w;
         bool success = false;
 
@@ -116,6 +122,8 @@ namespace easy3d {
             success = false;
         }
 
+        EASY3D_PROFILE_ELEMENTS(mesh->n_vertices());
+
         if (success) {
             LOG(INFO) << "save model done. " << w.time_string();
             return true;
@@ -32,25 +32,29 @@
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/profiler.h>
 
 
 namespace easy3d {
 
 
-    SurfaceMesh *SurfaceMeshIO::load(const std::string &file_name) {
+    SurfaceMesh *SurfaceMeshIO::load(const std::string &file_name, const LoadOptions &options) {
         std::setlocale(LC_NUMERIC, "C");
 
         SurfaceMesh *mesh = new SurfaceMesh;
         mesh->set_name(file_name);
 
+        EASY3D_PROFILE_ZONE("SurfaceMeshIO::load");
         StopWatch w;
         bool success = false;
 
         const std::string &ext = file_system::extension(file_name, true);
         if (ext == "ply")
-            success = io::load_ply(file_name, mesh);
+            success = io::load_ply(file_name, mesh, options);
         else if (ext == "sm")
             success = io::load_sm(file_name, mesh);
+        else if (ext == "csm")
+            success = io::load_csm(file_name, mesh);
         else if (ext == "obj")
             success = io::load_obj(file_name, mesh);
         else if (ext == "off")
@@ -75,6 +79,13 @@ namespace easy3d {
             return nullptr;
         }
 
+        // selects the properties and narrows their storage (does nothing for the properties already handled by the
+        // format-specific loader)
+        io::apply_load_options(mesh, options);
+
+        EASY3D_PROFILE_ELEMENTS(mesh->n_vertices());
+        EASY3D_PROFILE_BYTES(static_cast<std::size_t>(file_system::file_size(file_name)));
+
         if (success)
             LOG(INFO) << "surface mesh loaded ("
                       << "#face: " << mesh->n_faces() << ", "
@@ -94,6 +105,7 @@ namespace easy3d {
             return false;
         }
 
+        EASY3D_PROFILE_ZONE("SurfaceMeshIO::save");
         StopWatch w;
         bool success = false;
 
@@ -108,6 +120,8 @@ namespace easy3d {
             success = io::save_ply(final_name, mesh, true);
         } else if (ext == "sm")
             success = io::save_sm(final_name, mesh);
+        else if (ext == "csm")
+            success = io::save_csm(final_name, mesh);
         else if (ext == "obj")
             success = io::save_obj(final_name, mesh);
         else if (ext == "off")
@@ -120,6 +134,8 @@ namespace easy3d {
             success = false;
         }
 
+        EASY3D_PROFILE_ELEMENTS(mesh->n_vertices());
+
         if (success) {
             LOG(INFO) << "save model done. " << w.time_string();
             return true;
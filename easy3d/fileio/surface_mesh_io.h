@@ -30,6 +30,8 @@
 
 #include <string>
 
+#include <easy3d/fileio/load_options.h>
+
 
 namespace easy3d {
 
@@ -46,15 +48,20 @@ namespace easy3d {
 
         /**
          * \brief Reads a surface mesh from a file.
-         * \details File extension determines file format (ply, obj, off, stl, poly) and type (i.e. binary or ASCII).
+         * \details File extension determines file format (ply, obj, off, stl, sm, csm, poly) and type (i.e. binary or
+         * ASCII).
          * \param file_name The file name.
+         * \param options Which properties to import and how to store them. The ply format selects the properties while
+         *      reading, and the other formats after reading. By default, all properties are imported in full precision.
          * \return The pointer of the surface mesh (nullptr if failed).
          */
-		static SurfaceMesh* load(const std::string& file_name);
+		static SurfaceMesh* load(const std::string& file_name, const LoadOptions& options = LoadOptions());
 
         /**
          * \brief Saves a surface mesh to a file.
-         * \details File extension determines file format (ply, obj, off, stl, poly) and type (i.e. binary or ASCII).
+         * \details File extension determines file format (ply, obj, off, stl, sm, csm, poly) and type (i.e. binary or
+         * ASCII). The \c csm format is saved with 16-bit quantized coordinates (use save_csm() for a different
+         * precision).
          * \param file_name The file name.
          * \param mesh The surface mesh.
          * \return The status of the operation
@@ -71,8 +78,18 @@ namespace easy3d {
         /// Saves a surface mesh to a \p SM format file.
         bool save_sm(const std::string& file_name, const SurfaceMesh* mesh);
 
-        /// Reads a surface mesh from a \p PLY format file.
-        bool load_ply(const std::string& file_name, SurfaceMesh* mesh);
+        /// Reads a surface mesh from a \p CSM (i.e., compressed \p SM) format file.
+        /// The data is stored in chunks that are decompressed in parallel.
+        bool load_csm(const std::string& file_name, SurfaceMesh* mesh);
+        /// Saves a surface mesh to a \p CSM (i.e., compressed \p SM) format file. The coordinates are quantized to
+        /// \p bits bits (1 to 31) w.r.t. the bounding box, vertex normals (optional) are encoded in 32 bits (octahedral
+        /// mapping), and vertex colors (optional) in 24 bits. The vertices are renumbered in the order they are first
+        /// referenced by the faces, and the connectivity is delta-coded. All data is compressed in chunks.
+        bool save_csm(const std::string& file_name, const SurfaceMesh* mesh, int bits = 16);
+
+        /// Reads a surface mesh from a \p PLY format file. Only the properties requested by \p options are imported (the
+        /// storage narrowing is not applied).
+        bool load_ply(const std::string& file_name, SurfaceMesh* mesh, const LoadOptions& options = LoadOptions());
         /// Saves a surface mesh to a \p PLY format file.
         bool save_ply(const std::string& file_name, const SurfaceMesh* mesh, bool binary = true);
 
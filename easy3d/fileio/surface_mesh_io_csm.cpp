@@ -0,0 +1,397 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/surface_mesh_io.h>
+
+#include <fstream>
+#include <cstring>
+#include <atomic>
+
+#include <easy3d/fileio/compression.h>
+#include <easy3d/fileio/translator.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/surface_mesh_builder.h>
+#include <easy3d/core/attribute_packing.h>
+#include <easy3d/util/thread_pool.h>
+
+
+namespace easy3d {
+
+    namespace io {
+
+        namespace details {
+
+            const char csm_magic[4] = {'E', '3', 'S', 'M'};
+            const int32_t csm_version = 2;
+
+            enum CsmFlags {
+                CSM_HAS_COLORS = 1,
+                CSM_HAS_NORMALS = 2
+            };
+
+            inline void write_varint(uint32_t value, std::vector<unsigned char> &out) {
+                while (value >= 0x80) {
+                    out.push_back(static_cast<unsigned char>(value | 0x80));
+                    value >>= 7;
+                }
+                out.push_back(static_cast<unsigned char>(value));
+            }
+
+            inline bool read_varint(const unsigned char *&ip, const unsigned char *end, uint32_t &value) {
+                value = 0;
+                for (int shift = 0; shift < 35; shift += 7) {
+                    if (ip >= end)
+                        return false;
+                    const unsigned char b = *ip++;
+                    value |= static_cast<uint32_t>(b & 0x7f) << shift;
+                    if (!(b & 0x80))
+                        return true;
+                }
+                return false;
+            }
+
+            inline uint32_t zigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+            inline int32_t unzigzag(uint32_t v) { return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1); }
+
+        } // namespace details
+
+
+        bool load_csm(const std::string &file_name, SurfaceMesh *mesh) {
+            if (!mesh) {
+                LOG(ERROR) << "null mesh pointer";
+                return false;
+            }
+
+            std::ifstream input(file_name.c_str(), std::fstream::binary);
+            if (input.fail()) {
+                LOG(ERROR) << "could not open file: " << file_name;
+                return false;
+            }
+
+            char magic[4];
+            int32_t version = 0;
+            uint32_t nv = 0, nf = 0, flags = 0;
+            uint64_t num_bytes = 0;
+            input.read(magic, 4);
+            input.read((char *) &version, sizeof(int32_t));
+            input.read((char *) &nv, sizeof(uint32_t));
+            input.read((char *) &nf, sizeof(uint32_t));
+            input.read((char *) &flags, sizeof(uint32_t));
+            input.read((char *) &num_bytes, sizeof(uint64_t));
+            if (input.fail() || std::memcmp(magic, details::csm_magic, 4) != 0 || version != details::csm_version) {
+                LOG(ERROR) << "not a compressed surface mesh file (or unsupported version): " << file_name;
+                return false;
+            }
+            if (nv == 0 || nf == 0) {
+                LOG(ERROR) << "no face exists in file: " << file_name;
+                return false;
+            }
+
+            // read the data blocks (each is decompressed in parallel)
+            std::vector<vec3> points(nv);
+            dvec3 bmin;
+            if (!read_quantized_positions(input, points.data(), nv, bmin))
+                return false;
+
+            std::vector<unsigned char> rgb;
+            if (flags & details::CSM_HAS_COLORS) {
+                rgb.resize(nv * 3);
+                if (!read_compressed_array(input, rgb.data(), nv, 3))
+                    return false;
+            }
+
+            std::vector<uint32_t> normal_codes;
+            if (flags & details::CSM_HAS_NORMALS) {
+                normal_codes.resize(nv);
+                if (!read_compressed_array(input, normal_codes.data(), nv, sizeof(uint32_t)))
+                    return false;
+            }
+
+            std::vector<unsigned char> connectivity(num_bytes);
+            if (!read_compressed_array(input, connectivity.data(), num_bytes, 1))
+                return false;
+
+            // Decode and validate the connectivity before the mesh is touched. The faces are stored as their
+            // valences followed by the delta-coded vertex indices, so a face takes at least 4 bytes.
+            if (num_bytes < static_cast<uint64_t>(nf) * 4) {
+                LOG(ERROR) << "corrupted data: " << num_bytes << " bytes cannot hold " << nf << " faces";
+                return false;
+            }
+            // The bytes are decoded in parallel, block by block. A varint starts at the first byte or after a byte
+            // without the continuation bit, so each block knows where its values start and (after a prefix sum over
+            // the blocks) their positions in the sequence of all values.
+            const std::size_t byte_block = 1 << 16;
+            const std::size_t num_byte_blocks = (connectivity.size() + byte_block - 1) / byte_block;
+            std::vector<std::size_t> value_offsets(num_byte_blocks + 1, 0);
+            const unsigned char *data = connectivity.data();
+            parallel_for(std::size_t(0), num_byte_blocks, [&](std::size_t b) {
+                const std::size_t first = b * byte_block, last = std::min(connectivity.size(), first + byte_block);
+                std::size_t count = 0;
+                for (std::size_t i = first; i < last; ++i)
+                    count += (i == 0 || data[i - 1] < 0x80);
+                value_offsets[b + 1] = count;
+            }, nullptr, 1);
+            for (std::size_t b = 0; b < num_byte_blocks; ++b)
+                value_offsets[b + 1] += value_offsets[b];
+
+            std::vector<uint32_t> values(value_offsets[num_byte_blocks]);
+            std::atomic<bool> values_valid(true);
+            parallel_for(std::size_t(0), num_byte_blocks, [&](std::size_t b) {
+                const std::size_t first = b * byte_block, last = std::min(connectivity.size(), first + byte_block);
+                const unsigned char *end = data + connectivity.size();
+                std::size_t index = value_offsets[b];
+                for (std::size_t i = first; i < last; ++i) {
+                    if (i == 0 || data[i - 1] < 0x80) {
+                        const unsigned char *ip = data + i;
+                        if (!details::read_varint(ip, end, values[index++])) {
+                            values_valid = false;
+                            return;
+                        }
+                    }
+                }
+            }, nullptr, 1);
+            std::vector<unsigned char>().swap(connectivity);
+            if (!values_valid) {
+                LOG(ERROR) << "corrupted data: failed reading the connectivity";
+                return false;
+            }
+
+            // the valences give the position of each face in the values
+            std::vector<uint32_t> face_valences(nf);
+            std::vector<std::size_t> face_offsets(nf);
+            {
+                std::size_t pos = 0;
+                for (uint32_t f = 0; f < nf; ++f) {
+                    const uint32_t valence = (pos < values.size()) ? values[pos] : 0;
+                    if (valence < 3 || valence > nv || values.size() - pos - 1 < valence) {
+                        LOG(ERROR) << "corrupted data: failed reading face " << f;
+                        return false;
+                    }
+                    face_valences[f] = valence;
+                    face_offsets[f] = pos + 1;
+                    pos += valence + 1;
+                }
+                if (pos != values.size()) {
+                    LOG(ERROR) << "corrupted data: " << (values.size() - pos) << " values left after reading " << nf
+                               << " faces";
+                    return false;
+                }
+            }
+
+            // The vertex indices are the running sums of the deltas. The sums of the blocks of faces are computed in
+            // parallel, and then each block continues from the total of the previous blocks.
+            const std::size_t face_block = 1 << 14;
+            const std::size_t num_face_blocks = (nf + face_block - 1) / face_block;
+            std::vector<int64_t> block_sums(num_face_blocks + 1, 0);
+            parallel_for(std::size_t(0), num_face_blocks, [&](std::size_t b) {
+                const std::size_t first = b * face_block, last = std::min<std::size_t>(nf, first + face_block);
+                int64_t sum = 0;
+                for (std::size_t f = first; f < last; ++f) {
+                    for (std::size_t i = face_offsets[f]; i < face_offsets[f] + face_valences[f]; ++i)
+                        sum += details::unzigzag(values[i]);
+                }
+                block_sums[b + 1] = sum;
+            }, nullptr, 1);
+            for (std::size_t b = 0; b < num_face_blocks; ++b)
+                block_sums[b + 1] += block_sums[b];
+
+            // the vertices of face f start at face_offsets[f] - (f + 1), after skipping the valences
+            std::vector<SurfaceMesh::Vertex> face_vertices(values.size() - nf);
+            std::atomic<bool> indices_valid(true);
+            parallel_for(std::size_t(0), num_face_blocks, [&](std::size_t b) {
+                const std::size_t first = b * face_block, last = std::min<std::size_t>(nf, first + face_block);
+                int64_t prev = block_sums[b];
+                for (std::size_t f = first; f < last; ++f) {
+                    SurfaceMesh::Vertex *vertices = face_vertices.data() + face_offsets[f] - (f + 1);
+                    for (std::size_t k = 0; k < face_valences[f]; ++k) {
+                        prev += details::unzigzag(values[face_offsets[f] + k]);
+                        if (prev < 0 || prev >= nv) {
+                            indices_valid = false;
+                            return;
+                        }
+                        vertices[k] = SurfaceMesh::Vertex(static_cast<int>(prev));
+                    }
+                }
+            }, nullptr, 1);
+            if (!indices_valid) {
+                LOG(ERROR) << "corrupted data: vertex indices out of range [0, " << nv << ")";
+                return false;
+            }
+            std::vector<uint32_t>().swap(values);
+
+            // translation
+            dvec3 origin(0, 0, 0);
+            if (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT) {
+                origin = bmin + dvec3(points[0].data());
+                Translator::instance()->set_translation(origin);
+            } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET)
+                origin = Translator::instance()->translation();
+            const vec3 offset(bmin - origin);
+
+            // ------------------------ build the mesh ------------------------
+
+            mesh->clear();
+            mesh->reserve(nv, nf * 2, nf);
+
+            SurfaceMeshBuilder builder(mesh);
+            builder.begin_surface();
+
+            for (const auto &p : points)
+                builder.add_vertex(p + offset);
+
+            // The vertex attributes are assigned before the faces are added, so that vertices copied by the builder
+            // (to resolve non-manifoldness) inherit the attributes.
+            if (!rgb.empty()) {
+                auto &colors = mesh->vertex_property<vec3>("v:color").vector();
+                parallel_for(0u, nv, [&](uint32_t i) {
+                    colors[i] = vec3(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]) / 255.0f;
+                });
+            }
+            if (!normal_codes.empty()) {
+                auto &normals = mesh->vertex_property<vec3>("v:normal").vector();
+                parallel_for(0u, nv, [&](uint32_t i) {
+                    normals[i] = packing::decode_octahedral(normal_codes[i]);
+                });
+            }
+
+            builder.add_faces(face_vertices, face_valences);
+
+            builder.end_surface();
+
+            if (Translator::instance()->status() != Translator::DISABLED) {
+                auto trans = mesh->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
+                trans[0] = origin;
+                LOG(INFO) << "model translated w.r.t. "
+                          << (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT ? "the first vertex" : "last known reference point")
+                          << " (" << origin << "), stored as ModelProperty<dvec3>(\"translation\")";
+            }
+
+            return mesh->n_faces() > 0;
+        }
+
+
+        bool save_csm(const std::string &file_name, const SurfaceMesh *mesh, int bits) {
+            if (!mesh) {
+                LOG(ERROR) << "null mesh pointer";
+                return false;
+            }
+
+            std::ofstream output(file_name.c_str(), std::fstream::binary);
+            if (output.fail()) {
+                LOG(ERROR) << "could not open file: " << file_name;
+                return false;
+            }
+
+            // Renumber the vertices in the order they are first referenced by the faces (i.e., vertex-cache order),
+            // so the indices of a face are close to the previously written ones and their deltas are small.
+            // Vertices not referenced by any face are appended at the end.
+            std::vector<int> new_index(mesh->vertices_size(), -1);
+            std::vector<SurfaceMesh::Vertex> order;
+            order.reserve(mesh->n_vertices());
+            for (auto f : mesh->faces()) {
+                for (auto v : mesh->vertices(f)) {
+                    if (new_index[v.idx()] < 0) {
+                        new_index[v.idx()] = static_cast<int>(order.size());
+                        order.push_back(v);
+                    }
+                }
+            }
+            for (auto v : mesh->vertices()) {
+                if (new_index[v.idx()] < 0) {
+                    new_index[v.idx()] = static_cast<int>(order.size());
+                    order.push_back(v);
+                }
+            }
+
+            // delta-coded connectivity
+            std::vector<unsigned char> connectivity;
+            connectivity.reserve(mesh->n_faces() * 4);
+            int32_t prev = 0;
+            for (auto f : mesh->faces()) {
+                details::write_varint(mesh->valence(f), connectivity);
+                for (auto v : mesh->vertices(f)) {
+                    const int32_t id = new_index[v.idx()];
+                    details::write_varint(details::zigzag(id - prev), connectivity);
+                    prev = id;
+                }
+            }
+
+            const uint32_t nv = static_cast<uint32_t>(order.size());
+            const uint32_t nf = mesh->n_faces();
+            const uint64_t num_bytes = connectivity.size();
+            auto colors = mesh->get_vertex_property<vec3>("v:color");
+            auto normals = mesh->get_vertex_property<vec3>("v:normal");
+            uint32_t flags = 0;
+            if (colors)
+                flags |= details::CSM_HAS_COLORS;
+            if (normals)
+                flags |= details::CSM_HAS_NORMALS;
+
+            output.write(details::csm_magic, 4);
+            output.write((const char *) &details::csm_version, sizeof(int32_t));
+            output.write((const char *) &nv, sizeof(uint32_t));
+            output.write((const char *) &nf, sizeof(uint32_t));
+            output.write((const char *) &flags, sizeof(uint32_t));
+            output.write((const char *) &num_bytes, sizeof(uint64_t));
+
+            std::vector<vec3> points(nv);
+            auto prop_points = mesh->get_vertex_property<vec3>("v:point");
+            parallel_for(0u, nv, [&](uint32_t i) {
+                points[i] = prop_points[order[i]];
+            });
+            dvec3 translation(0, 0, 0);
+            auto trans = mesh->get_model_property<dvec3>("translation");
+            if (trans)
+                translation = trans[0];
+            write_quantized_positions(output, points.data(), nv, translation, bits);
+
+            if (colors) {
+                std::vector<unsigned char> rgb(nv * 3);
+                parallel_for(0u, nv, [&](uint32_t i) {
+                    const vec3 &c = colors[order[i]];
+                    for (int j = 0; j < 3; ++j)
+                        rgb[i * 3 + j] = static_cast<unsigned char>(std::min(1.0f, std::max(0.0f, c[j])) * 255.0f + 0.5f);
+                });
+                write_compressed_array(output, rgb.data(), nv, 3);
+            }
+
+            if (normals) {
+                std::vector<uint32_t> codes(nv);
+                parallel_for(0u, nv, [&](uint32_t i) {
+                    codes[i] = packing::encode_octahedral(normals[order[i]]);
+                });
+                write_compressed_array(output, codes.data(), nv, sizeof(uint32_t));
+            }
+
+            write_compressed_array(output, connectivity.data(), connectivity.size(), 1);
+
+            return !output.fail();
+        }
+
+    } // namespace io
+
+} // namespace easy3d
@@ -28,12 +28,15 @@
 
 #include <fstream>
 #include <unordered_map>
+#include <algorithm>
+#include <cstring>
 
 #include <easy3d/fileio/translator.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/surface_mesh_builder.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/thread_pool.h>
 
 
 #define USE_FAST_OBJ
@@ -49,6 +52,57 @@ namespace easy3d {
 
     namespace io {
 
+        namespace details {
+
+            // Merges the duplicated elements (each made of 'dim' values) of a fastObjMesh array, in which the first
+            // element is a dummy one. Two elements are duplicates if their values are exactly the same. The elements
+            // are sorted in parallel such that duplicates become adjacent. Returns the number of unique elements.
+            //  - ids: the id of the unique element of each element (-1 for the dummy element). The unique elements
+            //         are numbered in the order of their first appearance in the array.
+            //  - firsts: the first appearance (i.e., the index in the array) of each unique element.
+            inline int unique_elements(const double *data, std::size_t count, std::size_t dim, std::vector<int> &ids,
+                                       std::vector<unsigned int> &firsts) {
+                ids.assign(count, -1);
+                firsts.clear();
+                if (count < 2)
+                    return 0;
+
+                // compare the bits (instead of the values), which is a strict weak ordering even with NaNs
+                auto compare = [data, dim](unsigned int a, unsigned int b) -> int {
+                    return std::memcmp(data + a * dim, data + b * dim, dim * sizeof(double));
+                };
+
+                std::vector<unsigned int> order(count - 1);
+                for (std::size_t i = 0; i < order.size(); ++i)
+                    order[i] = static_cast<unsigned int>(i + 1);
+                parallel_sort(order.begin(), order.end(), [&compare](unsigned int a, unsigned int b) {
+                    const int c = compare(a, b);
+                    return c < 0 || (c == 0 && a < b);
+                });
+
+                // the first appearance of the element at each position of the sorted order
+                const int num = static_cast<int>(order.size());
+                std::vector<unsigned char> is_first(num, 1);
+                parallel_for(1, num, [&](int i) {
+                    is_first[i] = (compare(order[i - 1], order[i]) != 0);
+                });
+                std::vector<unsigned int> first(count, 0);
+                for (int i = 0; i < num; ++i)
+                    first[order[i]] = is_first[i] ? order[i] : first[order[i - 1]];
+
+                for (std::size_t e = 1; e < count; ++e) {
+                    if (first[e] == e) {
+                        ids[e] = static_cast<int>(firsts.size());
+                        firsts.push_back(static_cast<unsigned int>(e));
+                    } else
+                        ids[e] = ids[first[e]];
+                }
+                return static_cast<int>(firsts.size());
+            }
+
+        }
+
+
         bool load_obj(const std::string &file_name, SurfaceMesh *mesh) {
             if (!mesh) {
                 LOG(ERROR) << "null mesh pointer";
@@ -71,133 +125,252 @@ namespace easy3d {
             // A dummy position, normal and texture coordinate are added to the corresponding fastObjMesh arrays at
             // element 0 and then an index of 0 is used to indicate that attribute is not present at the vertex.
 
+            // ------------------------ merge duplicated positions and texture coordinates ------------------------
+
+            // Attention: Valid indices in the fastObjMesh::indices array start from 1 (see above), and the ids of the
+            // unique positions and texture coordinates start from 0.
+            std::vector<int> position_ids, texcoord_ids;
+            std::vector<unsigned int> unique_positions, unique_texcoords;
+            const int num_positions = details::unique_elements(fom->positions, fom->position_count, 3, position_ids,
+                                                               unique_positions);
+            LOG_IF(num_positions + 1 < static_cast<int>(fom->position_count), INFO)
+                << fom->position_count - 1 - num_positions << " duplicated vertices merged";
+            const bool has_texcoords = (fom->texcoord_count > 1 && fom->texcoords);
+            if (has_texcoords)
+                details::unique_elements(fom->texcoords, fom->texcoord_count, 2, texcoord_ids, unique_texcoords);
+
+            // ------------------------ collect the faces ------------------------
+
+            // Flatten the faces of all groups, recording for each face where its vertex indices start in the
+            // fastObjMesh::indices array. This is cheap and makes the per-face work below independent.
+            std::vector<unsigned int> face_ids;          // the index of each face in the fastObjMesh face_* arrays
+            std::vector<unsigned int> face_index_offset; // the first index of each face in fastObjMesh::indices
+            face_ids.reserve(fom->face_count);
+            face_index_offset.reserve(fom->face_count);
+            for (std::size_t ii = 0; ii < fom->group_count; ii++) {
+                const fastObjGroup &grp = fom->groups[ii];
+                unsigned int idx = grp.index_offset;
+                for (unsigned int jj = 0; jj < grp.face_count; ++jj) {
+                    face_ids.push_back(grp.face_offset + jj);
+                    face_index_offset.push_back(idx);
+                    idx += fom->face_vertices[grp.face_offset + jj];
+                }
+            }
+            const int num_faces = static_cast<int>(face_ids.size());
+
+            // the (merged) vertex of a face corner, -1 if the corner has no valid position
+            auto corner_vertex = [&](const fastObjIndex &mi) -> int {
+                return (mi.p > 0 && mi.p < fom->position_count) ? position_ids[mi.p] : -1;
+            };
+
+            // Verify the validity of the vertex indices of the faces. This is done in parallel and the result is
+            // recorded per face, together with the number of its vertices after removing duplicated ones:
+            //  - 0: valid face;
+            //  - 1: face with less than 3 vertices (ignored);
+            //  - 2: face with duplicated vertices, which cannot be fixed (ignored);
+            //  - 3: face with duplicated vertices, and the duplication can be removed.
+            std::vector<unsigned char> face_status(num_faces, 0);
+            std::vector<unsigned int> face_size(num_faces, 0);
+            parallel_for(0, num_faces, [&](int f) {
+                const unsigned int fv = fom->face_vertices[face_ids[f]];
+                std::vector<int> ids;
+                ids.reserve(fv);
+                for (unsigned int kk = 0; kk < fv; ++kk) {
+                    const int v = corner_vertex(fom->indices[face_index_offset[f] + kk]);
+                    if (v >= 0)
+                        ids.push_back(v);
+                }
+                if (ids.size() < 3) {
+                    face_status[f] = 1;
+                    return;
+                }
+                const std::size_t size = ids.size();
+                std::sort(ids.begin(), ids.end());
+                ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+                if (ids.size() != size)
+                    face_status[f] = (ids.size() < 3) ? 2 : 3;
+                if (face_status[f] != 2)
+                    face_size[f] = static_cast<unsigned int>(ids.size());
+            });
+
+            // the faces that will be ignored
+            for (int f = 0; f < num_faces; ++f) {
+                if (face_status[f] == 0)
+                    continue;
+                std::vector<int> ids;
+                for (unsigned int kk = 0; kk < fom->face_vertices[face_ids[f]]; ++kk)
+                    ids.push_back(corner_vertex(fom->indices[face_index_offset[f] + kk]));
+                switch (face_status[f]) {
+                    case 1:
+                        LOG_N_TIMES(3, ERROR) << "face has less than 3 vertices " << ids << " (face ignored). " << COUNTER;
+                        break;
+                    case 2:
+                        LOG_N_TIMES(3, ERROR) << "face has duplicated vertices " << ids << " (face ignored). " << COUNTER;
+                        break;
+                    default:
+                        LOG_N_TIMES(3, ERROR) << "face has duplicated vertices " << ids << " (duplication removed). " << COUNTER;
+                        break;
+                }
+            }
+
+            // Group the faces by materials (stable, i.e., the original order of the faces sharing the same material
+            // is kept), such that faces of the same material form a contiguous range in the mesh. The ignored faces
+            // are skipped.
+            const bool has_materials = (fom->material_count > 0 && fom->materials);
+            auto face_material = [&](int f) -> unsigned int {
+                const unsigned int m = has_materials ? fom->face_materials[face_ids[f]] : 0;
+                return m < fom->material_count ? m : 0;
+            };
+            std::vector<int> face_order;
+            face_order.reserve(num_faces);
+            if (has_materials) {
+                std::vector<int> count(fom->material_count + 1, 0);
+                for (int f = 0; f < num_faces; ++f) {
+                    if (face_size[f] > 0)
+                        ++count[face_material(f) + 1];
+                }
+                for (std::size_t m = 1; m < count.size(); ++m)
+                    count[m] += count[m - 1];
+                face_order.resize(count.back());
+                for (int f = 0; f < num_faces; ++f) {
+                    if (face_size[f] > 0)
+                        face_order[count[face_material(f)]++] = f;
+                }
+            } else {
+                for (int f = 0; f < num_faces; ++f) {
+                    if (face_size[f] > 0)
+                        face_order.push_back(f);
+                }
+            }
+
+            // the vertices (and the texture coordinates) of the faces, face after face in the new order
+            const int num_valid_faces = static_cast<int>(face_order.size());
+            std::vector<unsigned int> sizes(num_valid_faces);
+            std::vector<std::size_t> corner_offset(num_valid_faces + 1, 0);
+            for (int ii = 0; ii < num_valid_faces; ++ii) {
+                sizes[ii] = face_size[face_order[ii]];
+                corner_offset[ii + 1] = corner_offset[ii] + sizes[ii];
+            }
+            std::vector<SurfaceMesh::Vertex> corners(corner_offset.back());
+            std::vector<int> corner_texcoords(has_texcoords ? corner_offset.back() : 0, -1);
+            parallel_for(0, num_valid_faces, [&](int ii) {
+                const int f = face_order[ii];
+                std::size_t c = corner_offset[ii];
+                for (unsigned int kk = 0; kk < fom->face_vertices[face_ids[f]]; ++kk) {
+                    const fastObjIndex &mi = fom->indices[face_index_offset[f] + kk];
+                    const int v = corner_vertex(mi);
+                    if (v < 0)
+                        continue;
+                    // keep the first occurrence of a duplicated vertex (face status 3)
+                    const SurfaceMesh::Vertex vertex(v);
+                    if (face_status[f] == 3 && std::find(corners.begin() + corner_offset[ii], corners.begin() + c, vertex) != corners.begin() + c)
+                        continue;
+                    if (has_texcoords && mi.t > 0 && mi.t < fom->texcoord_count)
+                        corner_texcoords[c] = texcoord_ids[mi.t];
+                    corners[c++] = vertex;
+                }
+            });
+
             // ------------------------ build the mesh ------------------------
 
             // clear the mesh in case of existing data
             mesh->clear();
+            mesh->reserve(num_positions, corner_offset.back() / 2, num_valid_faces);
 
             SurfaceMeshBuilder builder(mesh);
             builder.begin_surface();
 
-            if (Translator::instance()->status() == Translator::DISABLED) {
-                for (std::size_t v = 1; v < fom->position_count; ++v)
-                    builder.add_vertex(vec3(fom->positions + v * 3));
-            } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT) {
-                // the first point
-                const dvec3 origin(fom->positions + 3); // index starts from 1 and the first element is dummy
+            // Convert (and translate if requested) the vertex coordinates in parallel, and then add them in bulk.
+            dvec3 origin(0, 0, 0);
+            if (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT) {
+                if (fom->position_count > 1)
+                    origin = dvec3(fom->positions + 3); // index starts from 1 and the first element is dummy
                 Translator::instance()->set_translation(origin);
-                // remaining points
-                for (std::size_t v = 1; v < fom->position_count; ++v) {
-                    const double *data = fom->positions + v * 3;
-                    builder.add_vertex(vec3(data[0] - origin.x, data[1] - origin.y, data[2] - origin.z));
-                }
-
+            }
+            else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET)
+                origin = Translator::instance()->translation();
+
+            std::vector<vec3> points(num_positions);
+            parallel_for(0, num_positions, [&](int v) {
+                const double *data = fom->positions + unique_positions[v] * 3;
+                points[v] = vec3(static_cast<float>(data[0] - origin.x),
+                                 static_cast<float>(data[1] - origin.y),
+                                 static_cast<float>(data[2] - origin.z));
+            });
+            for (const auto &p : points)
+                builder.add_vertex(p);
+            // Release memory immediately when not needed any more.
+            std::vector<vec3>().swap(points);
+
+            if (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT) {
                 auto trans = mesh->add_model_property<dvec3>("translation", dvec3(0,0,0));
                 trans[0] = origin;
                 LOG(INFO) << "model translated w.r.t. the first vertex (" << origin << "), stored as ModelProperty<dvec3>(\"translation\")";
             } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET) {
-                const dvec3 &origin = Translator::instance()->translation();
-                for (std::size_t v = 1; v < fom->position_count; ++v) {
-                    const double *data = fom->positions + v * 3;
-                    builder.add_vertex(vec3(data[0] - origin.x, data[1] - origin.y, data[2] - origin.z));
-                }
                 auto trans = mesh->add_model_property<dvec3>("translation", dvec3(0,0,0));
                 trans[0] = origin;
                 LOG(INFO) << "model translated w.r.t. last known reference point (" << origin
                           << "), stored as ModelProperty<dvec3>(\"translation\")";
             }
 
-            // create texture coordinate property if texture coordinates present
+            // The connectivity is built in bulk, and the halfedge of each face points to its first vertex.
+            const std::vector<SurfaceMesh::Face> faces = builder.add_faces(corners, sizes);
+            std::vector<SurfaceMesh::Vertex>().swap(corners);
+
+            // Create texture coordinate property if texture coordinates present. The texture coordinates are
+            // converted once here, such that per-corner assignment is a plain lookup.
             SurfaceMesh::HalfedgeProperty<vec2> prop_texcoords;
-            if (fom->texcoord_count > 0 && fom->texcoords) // index starts from 1 and the first element is dummy
+            std::vector<vec2> texcoords;
+            if (has_texcoords) {
                 prop_texcoords = mesh->add_halfedge_property<vec2>("h:texcoord");
+                texcoords.resize(unique_texcoords.size());
+                parallel_for(0, static_cast<int>(unique_texcoords.size()), [&](int t) {
+                    const double *data = fom->texcoords + unique_texcoords[t] * 2;
+                    texcoords[t] = vec2(static_cast<float>(data[0]), static_cast<float>(data[1]));
+                });
+            }
 
             // create face color property if material information exists
             SurfaceMesh::FaceProperty<vec3> prop_face_color;
-            if (fom->material_count > 0 && fom->materials)  // index starts from 1 and the first element is dummy
+            if (has_materials) // index starts from 1 and the first element is dummy
                 prop_face_color = mesh->add_face_property<vec3>("f:color");
 
-            // find the face's halfedge that points to v.
-            auto find_face_halfedge = [](SurfaceMesh *mesh, SurfaceMesh::Face face,
-                                         SurfaceMesh::Vertex v) -> SurfaceMesh::Halfedge {
-                for (auto h : mesh->halfedges(face)) {
-                    if (mesh->target(h) == v)
-                        return h;
-                }
-                LOG_N_TIMES(3, ERROR) << "could not find a halfedge pointing to " << v << " in face " << face
-                                      << ". " << COUNTER;
-                return SurfaceMesh::Halfedge();
-            };
-
-            // for each shape
-            for (std::size_t ii = 0; ii < fom->group_count; ii++) {
-                const fastObjGroup &grp = fom->groups[ii];
-
-//                if (grp.name)
-//                    std::cout << "group name: " << std::string(grp.name) << std::endl;
-
-                unsigned int idx = 0;
-                for (unsigned int jj = 0; jj < grp.face_count; ++jj) {
-                    // number of vertices in the face
-                    unsigned int fv = fom->face_vertices[grp.face_offset + jj];
-                    std::vector<SurfaceMesh::Vertex> vertices;
-                    std::vector<unsigned int> texcoord_ids;
-                    for (unsigned int kk = 0; kk < fv; ++kk) {  // for each vertex in the face
-                        const fastObjIndex &mi = fom->indices[grp.index_offset + idx];
-                        if (mi.p)
-                            vertices.emplace_back(SurfaceMesh::Vertex(mi.p - 1));
-                        if (mi.t)
-                            texcoord_ids.emplace_back(mi.t);
-                        ++idx;
+            // the texture coordinates and the colors of the faces
+            parallel_for(0, num_valid_faces, [&](int ii) {
+                const SurfaceMesh::Face face = faces[ii];
+                if (!face.is_valid())
+                    return;
+
+                // texture coordinates (only if all the corners have one)
+                const int *ids = corner_texcoords.data() + corner_offset[ii];
+                if (prop_texcoords && std::find(ids, ids + sizes[ii], -1) == ids + sizes[ii]) {
+                    auto h = mesh->halfedge(face);
+                    for (unsigned int kk = 0; kk < sizes[ii]; ++kk) {
+                        prop_texcoords[h] = texcoords[ids[kk]];
+                        h = mesh->next(h);
                     }
+                }
 
-#if 1 // verify validity of vertex indices of the face
-
-                    // a face must have at least three vertices
-                    if (vertices.size() < 3) {
-                        LOG_N_TIMES(3, ERROR) << "face has less than 3 vertices " << vertices << " (face ignored). " << COUNTER;
+                // now materials
+                if (prop_face_color) {
+                    const fastObjMaterial &mat = fom->materials[face_material(face_order[ii])];
+                    prop_face_color[face] = vec3(mat.Kd); // currently easy3d uses only diffuse
+                }
+            });
+
+            // The range of the faces [first, first + count) of each material. The faces of the same material are
+            // contiguous in the mesh, so they can be rendered by a single draw (see buffers::update()).
+            if (has_materials) {
+                std::vector<std::pair<int, int> > ranges(fom->material_count, std::make_pair(0, 0));
+                for (int ii = 0; ii < num_valid_faces; ++ii) {
+                    if (!faces[ii].is_valid())
                         continue;
-                    }
-
-                    // a face cannot have duplicated vertices
-                    std::vector<SurfaceMesh::Vertex> tmp = vertices;
-                    std::sort(tmp.begin(),tmp.end());
-                    auto last = std::unique(tmp.begin(),tmp.end());
-                    tmp.erase(last, tmp.end());
-                    if(tmp.size() != vertices.size()) {
-                        if (tmp.size() < 3) {
-                            LOG_N_TIMES(3, ERROR) << "face has duplicated vertices " << vertices << " (face ignored). " << COUNTER;
-                            continue;
-                        }
-                        else {
-                            LOG_N_TIMES(3, ERROR) << "face has duplicated vertices " << vertices << " (duplication removed). " << COUNTER;
-                            vertices = tmp;
-                        }
-                    }
-#endif
-
-                    SurfaceMesh::Face face = builder.add_face(vertices);
-                    if (face.is_valid()) {
-                        // texture coordinates
-                        if (prop_texcoords && texcoord_ids.size() == vertices.size()) {
-                            auto begin = find_face_halfedge(mesh, face, builder.face_vertices()[0]);
-                            auto cur = begin;
-                            unsigned int vid = 0;
-                            do {
-                                unsigned int tid = texcoord_ids[vid++];
-                                prop_texcoords[cur] = vec2(fom->texcoords + 2 * tid);
-                                cur = mesh->next(cur);
-                            } while (cur != begin);
-                        }
-
-                        // now materials
-                        if (prop_face_color) {
-                            unsigned int mat_id = fom->face_materials[grp.face_offset + jj];
-                            const fastObjMaterial &mat = fom->materials[mat_id];
-                            prop_face_color[face] = vec3(mat.Kd); // currently easy3d uses only diffuse
-                        }
-                    }
+                    auto &range = ranges[face_material(face_order[ii])];
+                    if (range.second == 0)
+                        range.first = faces[ii].idx();
+                    ++range.second;
                 }
+                mesh->add_model_property<std::vector<std::pair<int, int> > >("material_ranges", ranges);
             }
 
             builder.end_surface();
@@ -56,7 +56,7 @@ namespace easy3d {
 
 
 			template <typename T, typename PropertyT>
-			inline void add_vertex_properties(SurfaceMesh* mesh, const std::vector<PropertyT>& properties)
+			inline void add_vertex_properties(SurfaceMesh* mesh, const std::vector<PropertyT>& properties, const LoadOptions& options)
 			{
 				for (const auto& p : properties) {
                     std::string name = p.name;
@@ -66,6 +66,8 @@ namespace easy3d {
 					}
 					if (name.find("v:") == std::string::npos)
 						name = "v:" + name;
+					if (!options.imports(name))
+						continue;
 					auto prop = mesh->vertex_property<T>(name);
 					prop.vector() = p;
 				}
@@ -73,7 +75,7 @@ namespace easy3d {
 
 
 			template <typename T, typename PropertyT>
-			inline void add_face_properties(SurfaceMesh* mesh, const std::vector<PropertyT>& properties)
+			inline void add_face_properties(SurfaceMesh* mesh, const std::vector<PropertyT>& properties, const LoadOptions& options)
 			{
 				for (const auto& p : properties) {
                     std::string name = p.name;
@@ -83,6 +85,8 @@ namespace easy3d {
 					}
 					if (name.find("f:") == std::string::npos)
 						name = "f:" + name;
+					if (!options.imports(name))
+						continue;
 					auto prop = mesh->face_property<T>(name);
 					prop.vector() = p;
 				}
@@ -90,7 +94,7 @@ namespace easy3d {
 
 
 			template <typename T, typename PropertyT>
-			inline void add_edge_properties(SurfaceMesh* mesh, const std::vector<PropertyT>& properties)
+			inline void add_edge_properties(SurfaceMesh* mesh, const std::vector<PropertyT>& properties, const LoadOptions& options)
 			{
 				for (const auto& p : properties) {
                     std::string name = p.name;
@@ -100,6 +104,8 @@ namespace easy3d {
 					}
 					if (name.find("e:") == std::string::npos)
 						name = "e:" + name;
+					if (!options.imports(name))
+						continue;
 					auto prop = mesh->edge_property<T>(name);
 					prop.vector() = p;
 				}
@@ -108,7 +114,7 @@ namespace easy3d {
 		} // namespace details
 
 
-		bool load_ply(const std::string& file_name, SurfaceMesh* mesh)
+		bool load_ply(const std::string& file_name, SurfaceMesh* mesh, const LoadOptions& options)
 		{
 			if (!mesh) {
 				LOG(ERROR) << "null mesh pointer";
@@ -171,12 +177,12 @@ namespace easy3d {
 
             if (element_vertex) {// add vertex properties
                 // NOTE: to properly handle non-manifold meshes, vertex properties must be added before adding the faces
-                details::add_vertex_properties<vec3>(mesh, element_vertex->vec3_properties);
-                details::add_vertex_properties<vec2>(mesh, element_vertex->vec2_properties);
-                details::add_vertex_properties<float>(mesh, element_vertex->float_properties);
-                details::add_vertex_properties<int>(mesh, element_vertex->int_properties);
-                details::add_vertex_properties<std::vector<int> >(mesh, element_vertex->int_list_properties);
-                details::add_vertex_properties<std::vector<float> >(mesh, element_vertex->float_list_properties);
+                details::add_vertex_properties<vec3>(mesh, element_vertex->vec3_properties, options);
+                details::add_vertex_properties<vec2>(mesh, element_vertex->vec2_properties, options);
+                details::add_vertex_properties<float>(mesh, element_vertex->float_properties, options);
+                details::add_vertex_properties<int>(mesh, element_vertex->int_properties, options);
+                details::add_vertex_properties<std::vector<int> >(mesh, element_vertex->int_list_properties, options);
+                details::add_vertex_properties<std::vector<float> >(mesh, element_vertex->float_list_properties, options);
             } else {
                 LOG(ERROR) << "element 'vertex' not found";
             }
@@ -185,8 +191,8 @@ namespace easy3d {
 
             // create texture coordinate property if texture coordinates present
             SurfaceMesh::HalfedgeProperty<vec2> prop_texcoords;
-            if (face_halfedge_texcoords.size() == face_vertex_indices.size())
-                prop_texcoords = prop_texcoords = mesh->add_halfedge_property<vec2>("h:texcoord");
+            if (face_halfedge_texcoords.size() == face_vertex_indices.size() && options.imports("h:texcoord"))
+                prop_texcoords = mesh->add_halfedge_property<vec2>("h:texcoord");
 
             // find the face's halfedge that points to v.
             auto find_face_halfedge = [](SurfaceMesh *mesh, SurfaceMesh::Face face,
@@ -230,20 +236,20 @@ namespace easy3d {
                     continue;   // the vertex property has already been added
                 }
                 else if (e.name == "face") {
-					details::add_face_properties<vec3>(mesh, e.vec3_properties);
-                    details::add_face_properties<vec2>(mesh, e.vec2_properties);
-					details::add_face_properties<float>(mesh, e.float_properties);
-					details::add_face_properties<int>(mesh, e.int_properties);
-					details::add_face_properties< std::vector<int> >(mesh, e.int_list_properties);
-					details::add_face_properties< std::vector<float> >(mesh, e.float_list_properties);
+					details::add_face_properties<vec3>(mesh, e.vec3_properties, options);
+                    details::add_face_properties<vec2>(mesh, e.vec2_properties, options);
+					details::add_face_properties<float>(mesh, e.float_properties, options);
+					details::add_face_properties<int>(mesh, e.int_properties, options);
+					details::add_face_properties< std::vector<int> >(mesh, e.int_list_properties, options);
+					details::add_face_properties< std::vector<float> >(mesh, e.float_list_properties, options);
 				}
                 else if (e.name == "edge") {
-					details::add_edge_properties<vec3>(mesh, e.vec3_properties);
-                    details::add_edge_properties<vec2>(mesh, e.vec2_properties);
-					details::add_edge_properties<float>(mesh, e.float_properties);
-					details::add_edge_properties<int>(mesh, e.int_properties);
-					details::add_edge_properties< std::vector<int> >(mesh, e.int_list_properties);
-					details::add_edge_properties< std::vector<float> >(mesh, e.float_list_properties);
+					details::add_edge_properties<vec3>(mesh, e.vec3_properties, options);
+                    details::add_edge_properties<vec2>(mesh, e.vec2_properties, options);
+					details::add_edge_properties<float>(mesh, e.float_properties, options);
+					details::add_edge_properties<int>(mesh, e.int_properties, options);
+					details::add_edge_properties< std::vector<int> >(mesh, e.int_list_properties, options);
+					details::add_edge_properties< std::vector<float> >(mesh, e.float_list_properties, options);
 				}
 				else {
 				    const std::string name = "element-" + e.name;
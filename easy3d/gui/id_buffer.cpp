@@ -0,0 +1,310 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/gui/id_buffer.h>
+
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/drawable_points.h>
+#include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/shader_program.h>
+#include <easy3d/renderer/shader_manager.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    namespace internal {
+
+        ShaderProgram *id_buffer_program(const std::string &name) {
+            ShaderProgram *program = ShaderManager::get_program(name);
+            if (!program) {
+                std::vector<ShaderProgram::Attribute> attributes;
+                attributes.push_back(ShaderProgram::Attribute(ShaderProgram::POSITION, "vtx_position"));
+                program = ShaderManager::create_program_from_files(name, attributes);
+            }
+            LOG_IF(!program, ERROR) << "shader program not available: " << name;
+            return program;
+        }
+
+        // exact comparison (any change must be detected)
+        inline bool same(const mat4 &a, const mat4 &b) {
+            return std::memcmp(static_cast<const float *>(a), static_cast<const float *>(b), sizeof(mat4)) == 0;
+        }
+
+    }
+
+
+    bool IdBuffer::Key::operator==(const Key &other) const {
+        return drawable == other.drawable && revision == other.revision && num_vertices == other.num_vertices &&
+               size == other.size && impostor == other.impostor && internal::same(matrix, other.matrix);
+    }
+
+
+    IdBuffer::IdBuffer()
+            : fbo_(nullptr), reader_(3), valid_(false), width_(0), height_(0), num_renders_(0) {
+    }
+
+
+    IdBuffer::~IdBuffer() {
+        delete fbo_;
+    }
+
+
+    void IdBuffer::release() {
+        delete fbo_;
+        fbo_ = nullptr;
+        reader_.release();
+        requests_.clear();
+        valid_ = false;
+    }
+
+
+    bool IdBuffer::update(const std::vector<Drawable *> &drawables, const Camera *camera, int width, int height) {
+        // the sphere impostors are sized according to the camera's pivot point
+        const float ratio = camera->pixelGLRatio(camera->pivotPoint());
+
+        std::vector<Key> keys;
+        keys.reserve(drawables.size());
+        for (auto d : drawables) {
+            if (!d)
+                continue;
+            Key key;
+            key.drawable = d;
+            key.revision = d->buffer_revision();
+            key.num_vertices = d->num_vertices();
+            key.matrix = d->position_matrix();
+            key.size = 0.0f;
+            key.impostor = -1;
+            if (d->type() == Drawable::DT_POINTS) {
+                auto points = dynamic_cast<const PointsDrawable *>(d);
+                key.impostor = points->impostor_type();
+                key.size = (points->impostor_type() == PointsDrawable::PLAIN) ? points->point_size()
+                                                                               : points->point_size() * ratio * 0.5f;
+            }
+            keys.push_back(key);
+        }
+
+        const mat4 &mvp = camera->modelViewProjectionMatrix();
+        if (valid_ && fbo_ && width == width_ && height == height_ && internal::same(mvp, mvp_) && keys == keys_)
+            return false;
+
+        keys_.swap(keys);
+        mvp_ = mvp;
+        width_ = width;
+        height_ = height;
+
+        drawables_.clear();
+        models_.clear();
+        model_ids_.clear();
+        for (const auto &key : keys_) {
+            auto d = const_cast<Drawable *>(key.drawable);
+            auto pos = std::find(models_.begin(), models_.end(), d->model());
+            if (pos == models_.end())
+                pos = models_.insert(models_.end(), d->model());
+            drawables_.push_back(d);
+            model_ids_.push_back(static_cast<unsigned int>(pos - models_.begin()) + 1);  // 0 is the background
+        }
+
+        render(camera);
+        valid_ = true;
+        ++num_renders_;
+        return true;
+    }
+
+
+    void IdBuffer::render(const Camera *camera) {
+        if (!fbo_) {
+            fbo_ = new FramebufferObject(width_, height_, 0); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+            fbo_->add_color_buffer(GL_RGBA32UI, GL_RGBA, GL_UNSIGNED_INT); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+            fbo_->add_depth_buffer(); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+        }
+        fbo_->ensure_size(width_, height_); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+
+        fbo_->bind(); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+
+        // glClearColor() does not apply to integer color buffers
+        const GLuint background[4] = {0, 0, 0, 0};
+        glClearBufferuiv(GL_COLOR, 0, background);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        easy3d_debug_log_gl_error;
+
+        for (std::size_t i = 0; i < drawables_.size(); ++i) {
+            Drawable *d = drawables_[i];
+            const Key &key = keys_[i];
+            const auto drawable_id = static_cast<unsigned int>(i + 1);  // 0 is the background
+
+            if (key.impostor == PointsDrawable::SPHERE || key.impostor == PointsDrawable::SURFEL) {
+                // surfels are picked as spheres (no normals needed)
+                ShaderProgram *program = internal::id_buffer_program("selection/selection_id_buffer_sphere");
+                if (!program)
+                    continue;
+                glEnable(GL_PROGRAM_POINT_SIZE); // before OpenGL3.2, use GL_VERTEX_PROGRAM_POINT_SIZE
+                program->bind();
+                program->set_uniform("perspective", camera->type() == Camera::PERSPECTIVE)
+                        ->set_uniform("MV", camera->modelViewMatrix())
+                        ->set_uniform("PROJ", camera->projectionMatrix())
+                        ->set_uniform("MANIP", key.matrix)
+                        ->set_uniform("sphere_radius", key.size)
+                        ->set_uniform("screen_width", width_)
+                        ->set_uniform("model_id", model_ids_[i])
+                        ->set_uniform("drawable_id", drawable_id);
+                d->gl_draw();
+                program->release();
+                glDisable(GL_PROGRAM_POINT_SIZE);
+            } else {
+                ShaderProgram *program = internal::id_buffer_program("selection/selection_id_buffer");
+                if (!program)
+                    continue;
+                if (key.impostor == PointsDrawable::PLAIN)
+                    glPointSize(key.size);
+                program->bind();
+                program->set_uniform("MVP", mvp_)
+                        ->set_uniform("MANIP", key.matrix)
+                        ->set_uniform("model_id", model_ids_[i])
+                        ->set_uniform("drawable_id", drawable_id);
+                d->gl_draw();
+                program->release();
+            }
+            easy3d_debug_log_gl_error;
+        }
+
+        fbo_->release(); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+    }
+
+
+    bool IdBuffer::region(int x, int y, int radius, int &x0, int &y0, int &w, int &h) const {
+        radius = std::max(radius, 0);
+        x0 = std::max(x - radius, 0);
+        y0 = std::max(y - radius, 0);
+        w = std::min(x + radius, width_ - 1) - x0 + 1;
+        h = std::min(y + radius, height_ - 1) - y0 + 1;
+        return w > 0 && h > 0;
+    }
+
+
+    IdBuffer::Hit IdBuffer::decode(const unsigned int *pixels, int x0, int y0, int w, int h, int x, int y) const {
+        Hit hit;
+        int closest = INT_MAX;
+        for (int j = 0; j < h; ++j) {
+            for (int i = 0; i < w; ++i) {
+                const unsigned int *p = pixels + 4 * (static_cast<std::size_t>(j) * w + i);
+                if (p[0] == 0 || p[0] > models_.size() || p[1] == 0 || p[1] > drawables_.size())
+                    continue;   // background
+                const int dx = x0 + i - x, dy = y0 + j - y;
+                const int dist = dx * dx + dy * dy;
+                if (dist < closest) {
+                    closest = dist;
+                    hit.model = models_[p[0] - 1];
+                    hit.drawable = drawables_[p[1] - 1];
+                    hit.primitive = static_cast<int>(p[2]);
+                }
+            }
+        }
+        return hit;
+    }
+
+
+    IdBuffer::Hit IdBuffer::pick(int x, int y, int radius) {
+        int x0, y0, w, h;
+        if (!valid_ || !fbo_ || !region(x, y, radius, x0, y0, w, h))
+            return Hit();
+
+        std::vector<unsigned int> pixels(static_cast<std::size_t>(w) * h * 4);
+        fbo_->bind(GL_READ_FRAMEBUFFER); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glReadPixels(x0, y0, w, h, GL_RGBA_INTEGER, GL_UNSIGNED_INT, pixels.data());
+        easy3d_debug_log_gl_error;
+        fbo_->release(GL_READ_FRAMEBUFFER); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+
+        return decode(pixels.data(), x0, y0, w, h, x, y);
+    }
+
+
+    bool IdBuffer::request(int x, int y, int radius) {
+        if (!valid_ || !fbo_)
+            return false;
+
+        Request req;
+        req.x = x;
+        req.y = y;
+        req.render = num_renders_;
+        int w, h;
+        req.empty = !region(x, y, radius, req.x0, req.y0, w, h);
+        if (req.empty) {    // nothing to read, but the request will report nothing is picked
+            if (requests_.empty() || !requests_.back().empty)
+                requests_.push_back(req);
+            return true;
+        }
+
+        if (reader_.is_full())
+            return false;
+        fbo_->bind(GL_READ_FRAMEBUFFER); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+        const bool success = reader_.request(req.x0, req.y0, w, h, GL_RGBA_INTEGER);
+        fbo_->release(GL_READ_FRAMEBUFFER); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
+        if (success)
+            requests_.push_back(req);
+        return success;
+    }
+
+
+    bool IdBuffer::fetch(Hit &hit) {
+        bool fetched = false;
+        std::vector<unsigned char> bytes;
+        std::vector<unsigned int> pixels;
+        while (!requests_.empty()) {
+            const Request req = requests_.front();
+            if (req.empty) {
+                requests_.pop_front();
+                hit = Hit();
+                fetched = true;
+                continue;
+            }
+
+            // the requests are served in order, so stop at the first unfinished one
+            if (!reader_.is_ready())
+                break;
+            requests_.pop_front();
+            int w = 0, h = 0;
+            if (!reader_.retrieve(bytes, w, h) || req.render != num_renders_)
+                continue;   // failed, or read from a buffer that has been rendered again since
+
+            pixels.resize(bytes.size() / sizeof(unsigned int));
+            std::memcpy(pixels.data(), bytes.data(), pixels.size() * sizeof(unsigned int));
+            hit = decode(pixels.data(), req.x0, req.y0, w, h, req.x, req.y);
+            fetched = true;
+        }
+        return fetched;
+    }
+
+}
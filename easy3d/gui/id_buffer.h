@@ -0,0 +1,160 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_GUI_ID_BUFFER_H
+#define EASY3D_GUI_ID_BUFFER_H
+
+#include <easy3d/core/types.h>
+#include <easy3d/renderer/async_pixel_reader.h>
+
+#include <vector>
+#include <deque>
+
+
+namespace easy3d {
+
+    class Model;
+    class Drawable;
+    class Camera;
+    class FramebufferObject;
+
+    /**
+     * \brief A persistent ID buffer for picking.
+     * \class IdBuffer easy3d/gui/id_buffer.h
+     * \details The drawables are rendered into an offscreen integer color buffer, in which each pixel records the
+     *      model, the drawable, and the primitive (i.e., the point, the line segment, or the triangle) covering it.
+     *      The buffer is rendered again only if the camera, the size of the viewport, or the drawables (i.e., the set
+     *      of drawables, the content of their buffers, or their manipulation) change. Between the changes, picking
+     *      only reads back the pixels. Small regions can also be read back asynchronously using pixel buffer objects,
+     *      so picking under the cursor (e.g., for highlighting) does not stall the rendering pipeline.
+     * \note All methods must be called with the OpenGL context current.
+     * \see Picker::set_persistent_id_buffer()
+     */
+    class IdBuffer {
+    public:
+        /// \brief The result of picking.
+        struct Hit {
+            Hit() : model(nullptr), drawable(nullptr), primitive(-1) {}
+            bool is_valid() const { return drawable != nullptr; }
+            Model *model;       ///< The model of the drawable (can be nullptr for a standalone drawable).
+            Drawable *drawable; ///< The picked drawable.
+            int primitive;      ///< The index of the picked point, line segment, or triangle in the drawable.
+        };
+
+    public:
+        IdBuffer();
+        ~IdBuffer();
+
+        /**
+         * \brief Makes sure the buffer holds the drawables seen by the camera, and renders it if needed.
+         * \param drawables The drawables to render (the visibility of the drawables is not checked).
+         * \param camera The camera.
+         * \param width, height The size of the viewport (in pixels).
+         * \return true if the buffer has been rendered, false if the cached one is still valid.
+         */
+        bool update(const std::vector<Drawable *> &drawables, const Camera *camera, int width, int height);
+
+        /// \brief Forces the buffer to be rendered at the next update(), e.g., after changing a shader uniform.
+        void invalidate() { valid_ = false; }
+
+        /// \brief The number of times the buffer has been rendered (for statistics).
+        std::size_t num_renders() const { return num_renders_; }
+
+        /**
+         * \brief Picks the primitive at a pixel. This reads back the pixels immediately.
+         * \param x, y The pixel position, in the OpenGL coordinate system (see Picker::screen_to_opengl()).
+         * \param radius If larger than 0, the closest primitive within a square of (2 * radius + 1) pixels centered
+         *      at (x, y) is picked.
+         */
+        Hit pick(int x, int y, int radius = 0);
+
+        /**
+         * \brief Starts reading back the pixels around a pixel. Returns immediately. The result can be fetched by
+         *      fetch() when the transfer has finished (usually by the next frame).
+         * \param x, y The pixel position, in the OpenGL coordinate system (see Picker::screen_to_opengl()).
+         * \param radius See pick().
+         * \return false if too many requests are pending.
+         */
+        bool request(int x, int y, int radius = 0);
+
+        /**
+         * \brief Fetches the result of the latest finished request. It never blocks.
+         * \param hit Returns the picked primitive. It is not modified if no request has finished.
+         * \return true if a request has finished since the last call. The results of requests issued before the
+         *      buffer was rendered again are discarded.
+         */
+        bool fetch(Hit &hit);
+
+        /// \brief Releases the OpenGL resources (all pending requests are discarded).
+        void release();
+
+    private:
+        void render(const Camera *camera);
+        // the visible primitive closest to pixel (x, y) within a region starting at (x0, y0)
+        Hit decode(const unsigned int *pixels, int x0, int y0, int w, int h, int x, int y) const;
+        // the region (clipped to the buffer) around a pixel, false if empty
+        bool region(int x, int y, int radius, int &x0, int &y0, int &w, int &h) const;
+
+    private:
+        FramebufferObject *fbo_;
+        AsyncPixelReader reader_;
+
+        // what the buffer has been rendered from, for detecting the changes
+        struct Key {
+            bool operator==(const Key &other) const;
+            const Drawable *drawable;
+            std::size_t revision;
+            std::size_t num_vertices;
+            mat4 matrix;
+            float size;     // point size or sphere radius
+            int impostor;
+        };
+        std::vector<Key> keys_;
+        bool valid_;
+        mat4 mvp_;
+        int width_;
+        int height_;
+
+        std::vector<Drawable *> drawables_;
+        std::vector<Model *> models_;
+        std::vector<unsigned int> model_ids_;   // of each drawable
+
+        // the pending asynchronous requests (oldest first)
+        struct Request {
+            int x, y, x0, y0;
+            bool empty;             // the region is outside the buffer (nothing to read)
+            std::size_t render;     // the buffer the request reads from
+        };
+        std::deque<Request> requests_;
+
+        std::size_t num_renders_;
+    };
+
+}
+
+
+#endif  // EASY3D_GUI_ID_BUFFER_H
@@ -26,6 +26,8 @@
 
 
 #include <easy3d/gui/picker.h>
+#include <easy3d/gui/id_buffer.h>
+#include <easy3d/gui/selection_engine.h>
 #include <easy3d/renderer/framebuffer_object.h>
 #include <easy3d/renderer/opengl_error.h>
 
@@ -34,6 +36,8 @@ namespace easy3d {
 
 
     FramebufferObject *Picker::fbo_ = 0;
+    IdBuffer *Picker::id_buffer_ = nullptr;
+    bool Picker::persistent_id_buffer_ = false;
 
 
     Picker::Picker(const Camera *cam)
@@ -64,6 +68,43 @@ namespace easy3d {
     }
 
 
+    IdBuffer *Picker::id_buffer(const std::vector<Drawable *> &drawables, int &width, int &height) const {
+        int viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        width = viewport[2];
+        height = viewport[3];
+
+        if (!id_buffer_)
+            id_buffer_ = new IdBuffer;
+        id_buffer_->update(drawables, camera(), width, height);
+        return id_buffer_;
+    }
+
+
+    void Picker::release_id_buffer() {
+        delete id_buffer_;
+        id_buffer_ = nullptr;
+    }
+
+
+    namespace {
+        SelectionEngineCache &selection_engines() {
+            static SelectionEngineCache cache;
+            return cache;
+        }
+    }
+
+
+    SelectionEngine &Picker::selection_engine(const Model *model) {
+        return selection_engines().engine(model);
+    }
+
+
+    void Picker::release_selection_engine(const Model *model) {
+        selection_engines().remove(model);
+    }
+
+
     void Picker::screen_to_opengl(int x, int y, int &gl_x, int &gl_y, int width, int height) const {
         float dpi_scaling_x = width / static_cast<float>(camera()->screenWidth());
         float dpi_scaling_y = height / static_cast<float>(camera()->screenHeight());
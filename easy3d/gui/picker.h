@@ -34,6 +34,10 @@
 namespace easy3d {
 
     class FramebufferObject;
+    class IdBuffer;
+    class Drawable;
+    class Model;
+    class SelectionEngine;
 
     /**
      * \brief Base class for picking mechanism.
@@ -116,11 +120,40 @@ namespace easy3d {
          */
         void screen_to_opengl(int x, int y, int &gl_x, int &gl_y, int width, int height) const;
 
+        /**
+         * \brief Enables/Disables the persistent ID buffer (disabled by default).
+         * \details By default, the GPU implementations of picking render the scene again for each pick. With the
+         *      persistent ID buffer, the scene is rendered only if the camera, the viewport, or the drawables have
+         *      changed since the last pick, and picking reads back only the pixels under the cursor. The ID buffer is
+         *      shared by all pickers (ModelPicker, SurfaceMeshPicker, PointCloudPicker), so it is rendered again when
+         *      a picker is used with other models than the previous one.
+         * \see IdBuffer, release_id_buffer()
+         */
+        static void set_persistent_id_buffer(bool b) { persistent_id_buffer_ = b; }
+        /// \brief Returns whether the persistent ID buffer is enabled.
+        static bool persistent_id_buffer() { return persistent_id_buffer_; }
+
+        /**
+         * \brief Releases the persistent ID buffer. This must be called while the OpenGL context is still current,
+         *      e.g., in Viewer::cleanup().
+         */
+        static void release_id_buffer();
+
+        /// \brief Releases the selection engine kept for \p model (see selection_engine()), e.g., when it is deleted.
+        static void release_selection_engine(const Model *model);
+
     protected:
 
         // prepare a frame buffer for the offscreen rendering
         void setup_framebuffer(int width, int height);
 
+        // the persistent ID buffer (created on demand) updated for the drawables in the current viewport
+        IdBuffer *id_buffer(const std::vector<Drawable *> &drawables, int &width, int &height) const;
+
+        // the selection engine of a model (shared by all pickers, see SelectionEngineCache). Its cells are built only
+        // once for each revision of the geometry of the model.
+        static SelectionEngine &selection_engine(const Model *model);
+
     protected:
         const Camera *camera_;
 
@@ -128,6 +161,9 @@ namespace easy3d {
 
         // All the picking tasks can share the same framebuffer
         static FramebufferObject *fbo_;
+
+        static IdBuffer *id_buffer_;
+        static bool persistent_id_buffer_;
     };
 
 }
@@ -26,6 +26,7 @@
 
 
 #include <easy3d/gui/picker_model.h>
+#include <easy3d/gui/id_buffer.h>
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/graph.h>
 #include <easy3d/core/surface_mesh.h>
@@ -36,13 +37,14 @@
 #include <easy3d/renderer/drawable_points.h>
 #include <easy3d/renderer/drawable_lines.h>
 #include <easy3d/renderer/drawable_triangles.h>
+#include <easy3d/renderer/drawable_batcher.h>
 #include <easy3d/renderer/framebuffer_object.h>
 #include <easy3d/util/logging.h>
 
 
 namespace easy3d {
 
-    ModelPicker::ModelPicker(const Camera *cam) : Picker(cam) {
+    ModelPicker::ModelPicker(const Camera *cam) : Picker(cam), batcher_(nullptr) {
         use_gpu_if_supported_ = true;
     }
 
@@ -55,6 +57,14 @@ namespace easy3d {
         if (models.empty())
             return nullptr;
 
+        if (persistent_id_buffer_) {
+            int width, height;
+            IdBuffer *buffer = id_buffer(visible_drawables(models), width, height);
+            int gl_x, gl_y;
+            screen_to_opengl(x, y, gl_x, gl_y, width, height);
+            return buffer->pick(gl_x, gl_y).model;
+        }
+
         int viewport[4];
         glGetIntegerv(GL_VIEWPORT, viewport);
         int width = viewport[2];
@@ -64,9 +74,8 @@ namespace easy3d {
         //--------------------------------------------------------------------------
         // render the 'scene' into the new FBO.
 
-        // TODO: the performance can be improved. Since the 'scene' is static, we need to render it to the fbo only
-        //       once. Then just query. Re-rendering is needed only when the scene is changed/manipulated, or the canvas
-        //       size is changed.
+        // NOTE: with the persistent ID buffer (see Picker::set_persistent_id_buffer()), the 'scene' is rendered only
+        //       when the camera, the canvas size, or the models change.
 
         // Bind the offscreen fbo for drawing
         fbo_->bind(); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
@@ -111,8 +120,46 @@ namespace easy3d {
     }
 
 
+    bool ModelPicker::pick_async(const std::vector<Model *> &models, int x, int y, Model *&model) {
+        int width, height;
+        IdBuffer *buffer = id_buffer(visible_drawables(models), width, height);
+        IdBuffer::Hit hit;
+        const bool fetched = buffer->fetch(hit);
+        int gl_x, gl_y;
+        screen_to_opengl(x, y, gl_x, gl_y, width, height);
+        buffer->request(gl_x, gl_y);
+
+        if (fetched)
+            model = hit.model;
+        return fetched;
+    }
+
+
+    std::vector<Drawable *> ModelPicker::visible_drawables(const std::vector<Model *> &models) const {
+        std::vector<Drawable *> drawables;
+        for (auto model : models) {
+            if (!model->renderer()->is_visible())
+                continue;
+            for (auto d : model->renderer()->triangles_drawables()) {
+                if (d->is_visible())    drawables.push_back(d);
+            }
+            for (auto d : model->renderer()->lines_drawables()) {
+                if (d->is_visible())    drawables.push_back(d);
+            }
+            for (auto d : model->renderer()->points_drawables()) {
+                if (d->is_visible())    drawables.push_back(d);
+            }
+        }
+        return drawables;
+    }
+
+
     // draw the scene
     void ModelPicker::draw(const std::vector<Model *> &models) {
+        const bool batched = batcher_ && batcher_->num_drawables() > 0 && batcher_->models() == models;
+        if (batched)
+            batcher_->draw_ids(camera());
+
         for (std::size_t i = 0; i < models.size(); ++i) {
             Model *model = models[i];
             if (!model->renderer()->is_visible())
@@ -124,7 +171,7 @@ namespace easy3d {
             const vec4 color(r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f);
 
             for (auto d : model->renderer()->triangles_drawables()) {
-                if (d->is_visible())    draw(d, color);
+                if (d->is_visible() && !(batched && batcher_->contains(d)))    draw(d, color);
             }
             for (auto d : model->renderer()->lines_drawables()) {
                 if (d->is_visible())    draw(d, color);
@@ -39,6 +39,7 @@ namespace easy3d {
 
     class Model;
     class Drawable;
+    class DrawableBatcher;
 
     /**
      * \brief Implementation of picking mechanism for set of models.
@@ -62,8 +63,33 @@ namespace easy3d {
          */
         Model *pick(const std::vector<Model *> &models, int x, int y);
 
+        /**
+         * \brief Picks a model asynchronously, e.g., for highlighting the model under the cursor. It always uses the
+         *      persistent ID buffer (see Picker::set_persistent_id_buffer()) and never waits for the GPU: it starts
+         *      reading the model at the cursor position and returns the model read by a previous call (if the read
+         *      has finished), so the result may lag a frame behind the cursor.
+         * @param models The models
+         * @param x The cursor x-coordinate, relative to the left edge of the content area.
+         * @param y The cursor y-coordinate, relative to the top edge of the content area.
+         * @param model Returns the picked model (nullptr if no model is under the cursor). It is not modified if no
+         *      read has finished.
+         * @return true if a read has finished, i.e., the model has been updated.
+         */
+        bool pick_async(const std::vector<Model *> &models, int x, int y, Model *&model);
+
+        /**
+         * \brief Sets the batcher that draws (some of) the drawables of the models, e.g., Viewer::batcher().
+         * \details The batched drawables are then rendered for picking in a few draw calls. The batcher is used only
+         *      if it was updated with the same models as the ones given to pick(). It is not used with the persistent
+         *      ID buffer, which renders each drawable separately (but only when the scene has changed).
+         */
+        void set_batcher(const DrawableBatcher *batcher) { batcher_ = batcher; }
+
     private:
 
+        // the visible drawables of the visible models
+        std::vector<Drawable *> visible_drawables(const std::vector<Model *> &models) const;
+
         // render each model of the scene with a unique color
         void draw(const std::vector<Model *> &models);
         // render the drawable with color
@@ -72,6 +98,7 @@ namespace easy3d {
     private:
 
         std::unordered_map<Drawable *, State> states_;
+        const DrawableBatcher *batcher_;
 
     };
 
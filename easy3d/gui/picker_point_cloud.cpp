@@ -26,6 +26,8 @@
 
 
 #include <easy3d/gui/picker_point_cloud.h>
+#include <easy3d/gui/selection_engine.h>
+#include <easy3d/gui/id_buffer.h>
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/renderer/manipulator.h>
 #include <easy3d/renderer/renderer.h>
@@ -34,6 +36,7 @@
 #include <easy3d/renderer/framebuffer_object.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/thread_pool.h>
 
 
 namespace easy3d {
@@ -69,7 +72,9 @@ namespace easy3d {
             }
         }
 
-        if (use_gpu_if_supported_ && program_) {
+        if (use_gpu_if_supported_ && program_ && persistent_id_buffer_)
+            return pick_vertex_id_buffer(model, x, y);
+        else if (use_gpu_if_supported_ && program_) {
             switch (drawable->impostor_type()) {
                 case PointsDrawable::PLAIN:
                     return pick_vertex_gpu_plain(model, x, y);
@@ -85,6 +90,35 @@ namespace easy3d {
     }
 
 
+    PointCloud::Vertex PointCloudPicker::pick_vertex_id_buffer(PointCloud *model, int x, int y) {
+        auto drawable = model->renderer()->get_points_drawable("vertices");
+        int width, height;
+        IdBuffer *buffer = id_buffer({drawable}, width, height);
+        int gl_x, gl_y;
+        screen_to_opengl(x, y, gl_x, gl_y, width, height);
+        return PointCloud::Vertex(buffer->pick(gl_x, gl_y).primitive);
+    }
+
+
+    bool PointCloudPicker::pick_vertex_async(PointCloud *model, int x, int y, PointCloud::Vertex &vertex) {
+        auto drawable = model ? model->renderer()->get_points_drawable("vertices") : nullptr;
+        if (!drawable)
+            return false;
+
+        int width, height;
+        IdBuffer *buffer = id_buffer({drawable}, width, height);
+        IdBuffer::Hit hit;
+        const bool fetched = buffer->fetch(hit);
+        int gl_x, gl_y;
+        screen_to_opengl(x, y, gl_x, gl_y, width, height);
+        buffer->request(gl_x, gl_y);
+
+        if (fetched)
+            vertex = PointCloud::Vertex(hit.primitive);
+        return fetched;
+    }
+
+
     PointCloud::Vertex PointCloudPicker::pick_vertex_cpu(PointCloud* model, int px, int py) {
         const std::vector<vec3>& points = model->points();
         std::size_t num = points.size();
@@ -102,8 +136,7 @@ namespace easy3d {
         const mat4& MANIP = model->manipulator()->matrix();
         const mat4& m = MVP * MANIP;
 
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
+        parallel_for(std::size_t(0), num, [&](std::size_t i) {
             const vec3& p = points[i];
             float x = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
             float y = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
@@ -117,7 +150,7 @@ namespace easy3d {
                 status[i] = 1;
                 sqr_dist_to_near[i] = distance2(p, p_near);
             }
-        }
+        });
 
         int idx = -1;
         float min_s_dist = FLT_MAX;
@@ -148,9 +181,8 @@ namespace easy3d {
         //--------------------------------------------------------------------------
         // render the 'scene' to the new FBO.
 
-        // TODO: the performance can be improved. Since the 'scene' is static, we need to render it to the fbo only
-        //       once. Then just query. Re-rendering is needed only when the scene is changed/manipulated, or the size
-        //       of the viewer changed.
+        // NOTE: with the persistent ID buffer (see Picker::set_persistent_id_buffer()), the 'scene' is rendered only
+        //       when the camera, the size of the viewer, or the model change.
 
         // Bind the offscreen fbo for drawing
         fbo_->bind(); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
@@ -162,7 +194,7 @@ namespace easy3d {
 
         program_->bind();
         program_->set_uniform("MVP", camera()->modelViewProjectionMatrix())
-                ->set_uniform("MANIP", model->manipulator()->matrix());
+                ->set_uniform("MANIP", drawable->position_matrix());
         drawable->gl_draw();
         program_->release();
 
@@ -207,9 +239,8 @@ namespace easy3d {
         //--------------------------------------------------------------------------
         // render the 'scene' to the new FBO.
 
-        // TODO: the performance can be improved. Since the 'scene' is static, we need to render it to the fbo only
-        //       once. Then just query. Re-rendering is needed only when the scene is changed/manipulated, or the size
-        //       of the viewer changed.
+        // NOTE: with the persistent ID buffer (see Picker::set_persistent_id_buffer()), the 'scene' is rendered only
+        //       when the camera, the size of the viewer, or the model change.
 
         glEnable(GL_PROGRAM_POINT_SIZE); // before OpenGL3.2, use GL_VERTEX_PROGRAM_POINT_SIZE
 
@@ -225,7 +256,7 @@ namespace easy3d {
         program_->set_uniform("perspective", camera()->type() == Camera::PERSPECTIVE);
         program_->set_uniform("MV", camera_->modelViewMatrix());easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
         program_->set_uniform("PROJ", camera_->projectionMatrix());
-        program_->set_uniform("MANIP", model->manipulator()->matrix());
+        program_->set_uniform("MANIP", drawable->position_matrix());
         float ratio = camera_->pixelGLRatio(camera_->pivotPoint());
         program_->set_uniform("sphere_radius", drawable->point_size() * ratio * 0.5f);  // 0.5f from size -> radius
         program_->set_uniform("screen_width", width);easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
@@ -262,40 +293,13 @@ namespace easy3d {
     void PointCloudPicker::pick_vertices(PointCloud *model, const Rect& rect, bool deselect) {
         if (!model)
             return;
-        int win_width = camera()->screenWidth();
-        int win_height = camera()->screenHeight();
-
-        float xmin = rect.left() / (win_width - 1.0f);
-        float ymin = 1.0f - rect.top() / (win_height - 1.0f);
-        float xmax = rect.right() / (win_width - 1);
-        float ymax = 1.0f - rect.bottom() / (win_height - 1.0f);
-        if (xmin > xmax) std::swap(xmin, xmax);
-        if (ymin > ymax) std::swap(ymin, ymax);
 
         const auto &points = model->get_vertex_property<vec3>("v:point").vector();
-        int num = static_cast<int>(points.size());
         const mat4 &m = camera()->modelViewProjectionMatrix() * model->manipulator()->matrix();
 
-        auto &select = model->vertex_property<bool>("v:select").vector();
-
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
-            const vec3 &p = points[i];
-            float x = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
-            float y = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
-            //float z = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]; // I don't need z
-            float w = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
-            x /= w;
-            y /= w;
-            x = 0.5f * x + 0.5f;
-            y = 0.5f * y + 0.5f;
-
-            if (x >= xmin && x <= xmax && y >= ymin && y <= ymax)
-                select[i] = !deselect;
-        }
-
-        auto count = std::count(select.begin(), select.end(), 1);
-        LOG(INFO) << "current selection: " << count << " points";
+        std::vector<unsigned char> inside;
+        selection_engine(model).select(points, model->geometry_revision(), m, camera()->screenWidth(), camera()->screenHeight(), rect, inside);
+        mark_selection(model, inside, deselect);
     }
 
 
@@ -303,50 +307,24 @@ namespace easy3d {
         if (!model)
             return;
 
-        int win_width = camera()->screenWidth();
-        int win_height = camera()->screenHeight();
-
-        std::vector<vec2> region; // the transformed selection region
-        for (std::size_t i = 0; i < plg.size(); ++i) {
-            const vec2 &p = plg[i];
-            float x = p.x / float(win_width - 1);
-            float y = 1.0f - p.y / float(win_height - 1);
-            region.push_back(vec2(x, y));
-        }
-
-        const Box2& box = plg.bbox();
-        float xmin = box.min_point().x / (win_width - 1.0f);
-        float ymin = 1.0f - box.min_point().y / (win_height - 1.0f);
-        float xmax = box.max_point().x / (win_width - 1);
-        float ymax = 1.0f - box.max_point().y / (win_height - 1.0f);
-        if (xmin > xmax) std::swap(xmin, xmax);
-        if (ymin > ymax) std::swap(ymin, ymax);
-
         const auto &points = model->get_vertex_property<vec3>("v:point").vector();
-        int num = static_cast<int>(points.size());
         const mat4 &m = camera()->modelViewProjectionMatrix() * model->manipulator()->matrix();
 
-        auto& select = model->vertex_property<bool>("v:select").vector();
+        std::vector<unsigned char> inside;
+        selection_engine(model).select(points, model->geometry_revision(), m, camera()->screenWidth(), camera()->screenHeight(), plg, inside);
+        mark_selection(model, inside, deselect);
+    }
 
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
-            const vec3 &p = points[i];
-            float x = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
-            float y = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
-            //float z = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]; // I don't need z
-            float w = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
-            x /= w;
-            y /= w;
-            x = 0.5f * x + 0.5f;
-            y = 0.5f * y + 0.5f;
 
-            if (x >= xmin && x <= xmax && y >= ymin && y <= ymax) {
-                if (geom::point_in_polygon(vec2(x, y), region))
-                    select[i] = !deselect;
-            }
+    void PointCloudPicker::mark_selection(PointCloud *model, const std::vector<unsigned char> &inside, bool deselect) {
+        auto &select = model->vertex_property<bool>("v:select").vector();
+        const std::size_t num = std::min(select.size(), inside.size());
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < num; ++i) {
+            if (inside[i])
+                select[i] = !deselect;
+            count += select[i];
         }
-
-        auto count = std::count(select.begin(), select.end(), 1);
         LOG(INFO) << "current selection: " << count << " points";
     }
 
@@ -58,9 +58,22 @@ namespace easy3d {
          */
         PointCloud::Vertex pick_vertex(PointCloud *model, int x, int y);
 
+        /**
+         * @brief Picks a vertex asynchronously, e.g., for highlighting the vertex under the cursor. It always uses the
+         *      persistent ID buffer (see Picker::set_persistent_id_buffer()) and never waits for the GPU: it starts
+         *      reading the vertex at the cursor position and returns the vertex read by a previous call (if the read
+         *      has finished), so the result may lag a frame behind the cursor.
+         * @param (x, y) The screen point.
+         * @param vertex Returns the picked vertex (invalid if no vertex is under the cursor). It is not modified if no
+         *      read has finished.
+         * @return true if a read has finished, i.e., the vertex has been updated.
+         */
+        bool pick_vertex_async(PointCloud *model, int x, int y, PointCloud::Vertex &vertex);
+
         /**
          * @brief Pick vertices of a point cloud by a rectangle. The selected vertices will be marked in vertex property
-         * "v:select".
+         * "v:select". The selection is done by a SelectionEngine, which is kept by the pickers for each
+         * model. It is rebuilt when the geometry revision of the model changes (see Model::geometry_revision()).
          * @param rect The rectangle region.
          * @param deselect True to perform an inverse operation.
          */
@@ -78,6 +91,12 @@ namespace easy3d {
         // pick implemented in CPU (with OpenMP if supported)
         PointCloud::Vertex pick_vertex_cpu(PointCloud *model, int x, int y);
 
+        // pick using the persistent ID buffer
+        PointCloud::Vertex pick_vertex_id_buffer(PointCloud *model, int x, int y);
+
+        // marks the vertices inside the selection region in the vertex property "v:select"
+        void mark_selection(PointCloud *model, const std::vector<unsigned char> &inside, bool deselect);
+
         // pick plain points implemented in GPU (using shader program)
         PointCloud::Vertex pick_vertex_gpu_plain(PointCloud *model, int x, int y);
 
@@ -26,6 +26,8 @@
 
 
 #include <easy3d/gui/picker_surface_mesh.h>
+#include <easy3d/gui/selection_engine.h>
+#include <easy3d/gui/id_buffer.h>
 #include <easy3d/renderer/renderer.h>
 #include <easy3d/renderer/shader_program.h>
 #include <easy3d/renderer/shader_manager.h>
@@ -34,6 +36,7 @@
 #include <easy3d/renderer/drawable_triangles.h>
 #include <easy3d/renderer/manipulator.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/thread_pool.h>
 
 
 namespace easy3d {
@@ -68,7 +71,9 @@ namespace easy3d {
             }
         }
 
-        if (use_gpu_if_supported_ && program)
+        if (use_gpu_if_supported_ && program && persistent_id_buffer_)
+            return pick_face_id_buffer(model, x, y);
+        else if (use_gpu_if_supported_ && program)
             return pick_face_gpu(model, x, y, program);
         else // CPU with OpenMP (if supported)
             return pick_face_cpu(model, x, y);
@@ -209,11 +214,10 @@ namespace easy3d {
         const OrientedLine3 oline(p_near, p_far);
 
         std::vector<char> status(num, 0);
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
+        parallel_for(0, num, [&](int i) {
             if (do_intersect(model, SurfaceMesh::Face(i), oline))
                 status[i] = 1;
-        }
+        });
 
         picked_face_ = SurfaceMesh::Face();
         double squared_distance = FLT_MAX;
@@ -258,9 +262,8 @@ namespace easy3d {
         //--------------------------------------------------------------------------
         // render the 'scene' to the new FBO.
 
-        // TODO: the performance can be improved. Since the 'scene' is static, we need to render it to the fbo only
-        //       once. Then just query. Re-rendering is needed only when the scene is changed/manipulated, or the size
-        //       of the viewer changed.
+        // NOTE: with the persistent ID buffer (see Picker::set_persistent_id_buffer()), the 'scene' is rendered only
+        //       when the camera, the size of the viewer, or the model change.
 
         // Bind the offscreen fbo for drawing
         fbo_->bind(); easy3d_debug_log_gl_error; easy3d_debug_log_frame_buffer_error;
@@ -274,7 +277,7 @@ namespace easy3d {
 
         program->bind();
         program->set_uniform("MVP", camera()->modelViewProjectionMatrix())
-                ->set_uniform("MANIP", model->manipulator()->matrix());
+                ->set_uniform("MANIP", drawable->position_matrix());
         drawable->gl_draw();
         program->release();
 
@@ -299,11 +302,50 @@ namespace easy3d {
 
         // Convert the color back to an integer ID
         int id = rgb::rgba(c[0], c[1], c[2], c[3]);
-        picked_face_ = SurfaceMesh::Face();
+        picked_face_ = face_of_triangle(model, id);
+        return picked_face_;
+    }
 
-#if 0 // If the mesh is a triangle mesh.
-        picked_face_ = SurfaceMesh::Face(id);
+
+    SurfaceMesh::Face SurfaceMeshPicker::pick_face_id_buffer(SurfaceMesh *model, int x, int y) {
+        auto drawable = model->renderer()->get_triangles_drawable("faces");
+        if (!drawable) {
+            LOG_N_TIMES(3, WARNING) << "drawable 'faces' does not exist. " << COUNTER;
+            return SurfaceMesh::Face();
+        }
+
+        int width, height;
+        IdBuffer *buffer = id_buffer({drawable}, width, height);
+        int gl_x, gl_y;
+        screen_to_opengl(x, y, gl_x, gl_y, width, height);
+
+        picked_face_ = face_of_triangle(model, buffer->pick(gl_x, gl_y).primitive);
         return picked_face_;
+    }
+
+
+    bool SurfaceMeshPicker::pick_face_async(SurfaceMesh *model, int x, int y, SurfaceMesh::Face &face) {
+        auto drawable = model ? model->renderer()->get_triangles_drawable("faces") : nullptr;
+        if (!drawable)
+            return false;
+
+        int width, height;
+        IdBuffer *buffer = id_buffer({drawable}, width, height);
+        IdBuffer::Hit hit;
+        const bool fetched = buffer->fetch(hit);
+        int gl_x, gl_y;
+        screen_to_opengl(x, y, gl_x, gl_y, width, height);
+        buffer->request(gl_x, gl_y);
+
+        if (fetched)
+            face = picked_face_ = face_of_triangle(model, hit.primitive);
+        return fetched;
+    }
+
+
+    SurfaceMesh::Face SurfaceMeshPicker::face_of_triangle(SurfaceMesh *model, int id) const {
+#if 0 // If the mesh is a triangle mesh.
+        return SurfaceMesh::Face(id);
 #else
         if (id >= 0) {
             // We draw the polygonal faces as triangles and the picked id is the index of the picked triangle. So we
@@ -318,19 +360,15 @@ namespace easy3d {
             if (static_cast<unsigned int>(id) < model->n_faces()) {
                 auto face = SurfaceMesh::Face(id);
                 const auto &range = triangle_range[face];
-                if (id >= range.first && id <= range.second) {
-                    picked_face_ = face;
-                    return picked_face_;
-                }
+                if (id >= range.first && id <= range.second)
+                    return face;
             }
 
             // Now treat the model as a general polygonal mesh.
             for (unsigned int face_id = 0; face_id < model->n_faces(); ++face_id) {
                 const auto &range = triangle_range[SurfaceMesh::Face(face_id)];
-                if (id >= range.first && id <= range.second) {
-                    picked_face_ = SurfaceMesh::Face(face_id);
-                    return picked_face_;
-                }
+                if (id >= range.first && id <= range.second)
+                    return SurfaceMesh::Face(face_id);
             }
         }
 #endif
@@ -340,113 +378,39 @@ namespace easy3d {
 
 
     std::vector<SurfaceMesh::Face> SurfaceMeshPicker::pick_faces(SurfaceMesh *model, const Rect& rect) {
-        std::vector<SurfaceMesh::Face> faces;
         if (!model)
-            return faces;
-
-        const int win_width = camera()->screenWidth();
-        const int win_height = camera()->screenHeight();
-
-        float xmin = rect.left() / (win_width - 1.0f);
-        float ymin = 1.0f - rect.top() / (win_height - 1.0f);
-        float xmax = rect.right() / (win_width - 1);
-        float ymax = 1.0f - rect.bottom() / (win_height - 1.0f);
-        if (xmin > xmax) std::swap(xmin, xmax);
-        if (ymin > ymax) std::swap(ymin, ymax);
+            return std::vector<SurfaceMesh::Face>();
 
         const auto &points = model->get_vertex_property<vec3>("v:point").vector();
-        const int num = static_cast<int>(points.size());
         const mat4 &m = camera()->modelViewProjectionMatrix() * model->manipulator()->matrix();
 
-        std::vector<bool> status(num, false);
-
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
-            const vec3 &p = points[i];
-            float x = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
-            float y = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
-            //float z = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]; // I don't need z
-            float w = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
-            x /= w;
-            y /= w;
-            x = 0.5f * x + 0.5f;
-            y = 0.5f * y + 0.5f;
-
-            if (x >= xmin && x <= xmax && y >= ymin && y <= ymax)
-                status[i] = true;
-        }
-
-        // a face is selected if all its vertices are selected
-        for (auto f : model->faces()) {
-            bool selected = true;
-            for (auto v : model->vertices(f)) {
-                if (!status[v.idx()]) {
-                    selected = false;
-                    break;
-                }
-            }
-
-            if (selected)
-                faces.push_back(f);
-        }
-
-        return faces;
+        std::vector<unsigned char> inside;
+        selection_engine(model).select(points, model->geometry_revision(), m, camera()->screenWidth(), camera()->screenHeight(), rect, inside);
+        return faces_inside(model, inside);
     }
 
 
     std::vector<SurfaceMesh::Face> SurfaceMeshPicker::pick_faces(SurfaceMesh *model, const Polygon2 &plg) {
-        std::vector<SurfaceMesh::Face> faces;
         if (!model)
-            return faces;
-
-        const int win_width = camera()->screenWidth();
-        const int win_height = camera()->screenHeight();
-
-        std::vector<vec2> region; // the transformed selection region
-        for (std::size_t i = 0; i < plg.size(); ++i) {
-            const vec2 &p = plg[i];
-            const float x = p.x / float(win_width - 1);
-            const float y = 1.0f - p.y / float(win_height - 1);
-            region.push_back(vec2(x, y));
-        }
-
-        const Box2& box = plg.bbox();
-        float xmin = box.min_point().x / (win_width - 1.0f);
-        float ymin = 1.0f - box.min_point().y / (win_height - 1.0f);
-        float xmax = box.max_point().x / (win_width - 1);
-        float ymax = 1.0f - box.max_point().y / (win_height - 1.0f);
-        if (xmin > xmax) std::swap(xmin, xmax);
-        if (ymin > ymax) std::swap(ymin, ymax);
+            return std::vector<SurfaceMesh::Face>();
 
         const auto &points = model->get_vertex_property<vec3>("v:point").vector();
-        const int num = static_cast<int>(points.size());
         const mat4 &m = camera()->modelViewProjectionMatrix() * model->manipulator()->matrix();
 
-        std::vector<bool> select_vertices(num, false);
+        std::vector<unsigned char> inside;
+        selection_engine(model).select(points, model->geometry_revision(), m, camera()->screenWidth(), camera()->screenHeight(), plg, inside);
+        return faces_inside(model, inside);
+    }
 
-#pragma omp parallel for
-        for (int i = 0; i < num; ++i) {
-            const vec3& p = points[i];
-            float x = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
-            float y = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
-            //float z = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]; // I don't need z
-            float w = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
-            x /= w;
-            y /= w;
-            x = 0.5f * x + 0.5f;
-            y = 0.5f * y + 0.5f;
-
-            if (x >= xmin && x <= xmax && y >= ymin && y <= ymax) {
-                if (geom::point_in_polygon(vec2(x, y), region))
-                    select_vertices[i] = true;
-            }
-        }
 
+    std::vector<SurfaceMesh::Face>
+    SurfaceMeshPicker::faces_inside(SurfaceMesh *model, const std::vector<unsigned char> &inside_vertices) {
         // a face is selected if all its vertices are selected
+        std::vector<SurfaceMesh::Face> faces;
         for (auto f : model->faces()) {
             bool selected = true;
             for (auto v : model->vertices(f)) {
-                if (!select_vertices[v.idx()]) {
+                if (!inside_vertices[v.idx()]) {
                     selected = false;
                     break;
                 }
@@ -455,9 +419,7 @@ namespace easy3d {
             if (selected)
                 faces.push_back(f);
         }
-
         return faces;
     }
 
-
 }
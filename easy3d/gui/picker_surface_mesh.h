@@ -66,6 +66,19 @@ namespace easy3d {
          */
         SurfaceMesh::Face pick_face(SurfaceMesh *model, int x, int y);
 
+        /**
+         * \brief Picks a face asynchronously, e.g., for highlighting the face under the cursor. It always uses the
+         *      persistent ID buffer (see Picker::set_persistent_id_buffer()) and never waits for the GPU: it starts
+         *      reading the face at the cursor position and returns the face read by a previous call (if the read
+         *      has finished), so the result may lag a frame behind the cursor.
+         * @param x The cursor x-coordinate, relative to the left edge of the content area.
+         * @param y The cursor y-coordinate, relative to the top edge of the content area.
+         * @param face Returns the picked face (invalid if no face is under the cursor). It is not modified if no
+         *      read has finished.
+         * @return true if a read has finished, i.e., the face has been updated.
+         */
+        bool pick_face_async(SurfaceMesh *model, int x, int y, SurfaceMesh::Face &face);
+
         /**
          * \brief Pick a vertex from a surface mesh given the cursor position.
          * @param x The cursor x-coordinate, relative to the left edge of the content area.
@@ -142,7 +155,9 @@ namespace easy3d {
         //------------------ multiple selection of faces ------------------
 
         /**
-         * @brief Pick faces of a surface mesh by a rectangle.
+         * @brief Pick faces of a surface mesh by a rectangle. The vertices are selected by a SelectionEngine, which is
+         * kept by the pickers for each model. It is rebuilt when the geometry revision of the model changes (see
+         * Model::geometry_revision()).
          * @param rect The rectangle region.
          * @return The faces selected during this operation (regardless of their previous status).
          */
@@ -159,9 +174,18 @@ namespace easy3d {
         // selection implemented in GPU (using shader program)
         SurfaceMesh::Face pick_face_gpu(SurfaceMesh *model, int x, int y, ShaderProgram* program);
 
+        // selection using the persistent ID buffer
+        SurfaceMesh::Face pick_face_id_buffer(SurfaceMesh *model, int x, int y);
+
         // selection implemented in CPU (with OpenMP if supported)
         SurfaceMesh::Face pick_face_cpu(SurfaceMesh *model, int x, int y);
 
+        // the face from which a triangle of the "faces" drawable comes
+        SurfaceMesh::Face face_of_triangle(SurfaceMesh *model, int triangle) const;
+
+        // the faces whose vertices are all inside the selection region
+        std::vector<SurfaceMesh::Face> faces_inside(SurfaceMesh *model, const std::vector<unsigned char> &inside_vertices);
+
         Plane3 face_plane(SurfaceMesh *model, SurfaceMesh::Face face) const;
 
         /**
@@ -0,0 +1,317 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/gui/selection_engine.h>
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include <easy3d/renderer/chunk_culler.h>
+#include <easy3d/util/thread_pool.h>
+
+
+namespace easy3d {
+
+
+    // The region in screen coordinates (in pixels, with the origin at the top left corner).
+    struct SelectionEngine::Region {
+        float xmin, xmax, ymin, ymax;   // the bounding box
+        bool lasso;
+
+        // the coverage of the pixels [x0, x0 + w) x [y0, y0 + h) by the lasso, and its summed-area table
+        int x0, y0, w, h;
+        std::vector<unsigned char> coverage;
+        std::vector<uint32_t> sat;
+
+        explicit Region(const Rect &rect) : lasso(false), x0(0), y0(0), w(0), h(0) {
+            xmin = std::min(rect.left(), rect.right());
+            xmax = std::max(rect.left(), rect.right());
+            ymin = std::min(rect.top(), rect.bottom());
+            ymax = std::max(rect.top(), rect.bottom());
+        }
+
+        Region(const Polygon2 &plg, int width, int height) : lasso(true), x0(0), y0(0), w(0), h(0) {
+            if (plg.size() < 3)
+                return;
+            const Box2 &box = plg.bbox();
+            xmin = box.min_coord(0);
+            xmax = box.max_coord(0);
+            ymin = box.min_coord(1);
+            ymax = box.max_coord(1);
+
+            // only the pixel centers inside the bounding box (and the screen) can be covered
+            x0 = std::max(0, static_cast<int>(std::ceil(xmin)));
+            y0 = std::max(0, static_cast<int>(std::ceil(ymin)));
+            w = std::min(width - 1, static_cast<int>(std::floor(xmax))) - x0 + 1;
+            h = std::min(height - 1, static_cast<int>(std::floor(ymax))) - y0 + 1;
+            if (w <= 0 || h <= 0) {
+                w = h = 0;
+                return;
+            }
+
+            // Scan conversion with the same crossing rule as geom::point_in_polygon(): a pixel center (x, y) is
+            // inside if an odd number of edges cross the horizontal line through it to the right of x.
+            coverage.assign(static_cast<std::size_t>(w) * h, 0);
+            std::vector<double> crossings;
+            const std::size_t n = plg.size();
+            for (int j = 0; j < h; ++j) {
+                const double y = y0 + j;
+                crossings.clear();
+                for (std::size_t a = 0, b = n - 1; a < n; b = a, ++a) {
+                    const vec2 &u0 = plg[a];
+                    const vec2 &u1 = plg[b];
+                    if ((u0.y <= y && y < u1.y) || (u1.y <= y && y < u0.y))
+                        crossings.push_back(u0.x + (y - u0.y) * (u1.x - u0.x) / (u1.y - u0.y));
+                }
+                std::sort(crossings.begin(), crossings.end());
+                unsigned char *row = coverage.data() + static_cast<std::size_t>(j) * w;
+                for (std::size_t k = 0; k + 1 < crossings.size(); k += 2) {
+                    // the pixels x with crossings[k] <= x < crossings[k + 1]
+                    const int from = std::max(x0, static_cast<int>(std::ceil(crossings[k])));
+                    const int to = std::min(x0 + w - 1, static_cast<int>(std::ceil(crossings[k + 1])) - 1);
+                    for (int x = from; x <= to; ++x)
+                        row[x - x0] = 1;
+                }
+            }
+
+            sat.assign(static_cast<std::size_t>(w + 1) * (h + 1), 0);
+            for (int j = 0; j < h; ++j) {
+                for (int i = 0; i < w; ++i) {
+                    sat[(j + 1) * (w + 1) + i + 1] = coverage[j * w + i] + sat[j * (w + 1) + i + 1] +
+                                                     sat[(j + 1) * (w + 1) + i] - sat[j * (w + 1) + i];
+                }
+            }
+        }
+
+        bool contains(float x, float y) const {
+            if (!lasso)
+                return x >= xmin && x <= xmax && y >= ymin && y <= ymax;
+            // the pixel of the point, i.e., the nearest pixel center
+            const float fx = x + 0.5f - static_cast<float>(x0);
+            const float fy = y + 0.5f - static_cast<float>(y0);
+            if (!(fx >= 0.0f && fx < static_cast<float>(w) && fy >= 0.0f && fy < static_cast<float>(h)))
+                return false;
+            return coverage[static_cast<std::size_t>(fy) * w + static_cast<std::size_t>(fx)] != 0;
+        }
+
+        enum Status { OUTSIDE, INSIDE, PARTIAL };
+
+        // classifies the points within the bounds [bx0, bx1] x [by0, by1]
+        Status classify(float bx0, float bx1, float by0, float by1) const {
+            if (bx1 < xmin || bx0 > xmax || by1 < ymin || by0 > ymax)
+                return OUTSIDE;
+            if (!lasso)
+                return (bx0 >= xmin && bx1 <= xmax && by0 >= ymin && by1 <= ymax) ? INSIDE : PARTIAL;
+            if (w == 0)
+                return OUTSIDE;
+
+            // the range of the pixels of the points, clipped to the coverage bitmap
+            const float px0 = std::floor(bx0 + 0.5f), px1 = std::floor(bx1 + 0.5f);
+            const float py0 = std::floor(by0 + 0.5f), py1 = std::floor(by1 + 0.5f);
+            if (px1 < x0 || px0 > x0 + w - 1 || py1 < y0 || py0 > y0 + h - 1)
+                return OUTSIDE;
+            const bool within = px0 >= x0 && px1 <= x0 + w - 1 && py0 >= y0 && py1 <= y0 + h - 1;
+            const int i0 = std::max(static_cast<int>(px0), x0) - x0, i1 = std::min(static_cast<int>(px1), x0 + w - 1) - x0;
+            const int j0 = std::max(static_cast<int>(py0), y0) - y0, j1 = std::min(static_cast<int>(py1), y0 + h - 1) - y0;
+            const uint32_t covered = sat[(j1 + 1) * (w + 1) + i1 + 1] - sat[j0 * (w + 1) + i1 + 1] -
+                                     sat[(j1 + 1) * (w + 1) + i0] + sat[j0 * (w + 1) + i0];
+            if (covered == 0)
+                return OUTSIDE;
+            const uint32_t area = static_cast<uint32_t>(i1 - i0 + 1) * static_cast<uint32_t>(j1 - j0 + 1);
+            return (within && covered == area) ? INSIDE : PARTIAL;
+        }
+    };
+
+
+    SelectionEngine::SelectionEngine(std::size_t cell_size)
+            : cell_size_(std::max<std::size_t>(cell_size, 1)), data_(nullptr), size_(0), revision_(0),
+              num_accepted_(0),
+              num_rejected_(0), num_tested_(0) {
+    }
+
+
+    void SelectionEngine::build(const std::vector<vec3> &points, std::size_t revision) {
+        offsets_ = ChunkCuller::partition(points, cell_size_, order_);
+        const int num = static_cast<int>(offsets_.size()) - 1;
+        boxes_.assign(std::max(num, 0), Box3());
+        parallel_for(0, num, [&](int c) {
+            for (std::size_t i = offsets_[c]; i < offsets_[c + 1]; ++i)
+                boxes_[c].grow(points[order_[i]]);
+        });
+        data_ = points.data();
+        size_ = points.size();
+        revision_ = revision;
+    }
+
+
+    bool SelectionEngine::is_built_for(const std::vector<vec3> &points, std::size_t revision) const {
+        return data_ == points.data() && size_ == points.size() && revision_ == revision && !points.empty();
+    }
+
+
+    std::size_t SelectionEngine::select(const std::vector<vec3> &points, std::size_t revision, const mat4 &mvp,
+                                        int width, int height, const Rect &rect, std::vector<unsigned char> &inside) {
+        return select(points, revision, mvp, width, height, Region(rect), inside);
+    }
+
+
+    std::size_t SelectionEngine::select(const std::vector<vec3> &points, std::size_t revision, const mat4 &mvp,
+                                        int width, int height, const Polygon2 &lasso,
+                                        std::vector<unsigned char> &inside) {
+        return select(points, revision, mvp, width, height, Region(lasso, width, height), inside);
+    }
+
+
+    std::size_t SelectionEngine::select(const std::vector<vec3> &points, std::size_t revision, const mat4 &mvp,
+                                        int width, int height, const Region &region,
+                                        std::vector<unsigned char> &inside) {
+        inside.assign(points.size(), 0);
+        num_accepted_ = num_rejected_ = num_tested_ = 0;
+        if (points.empty() || (region.lasso && region.w == 0))
+            return 0;
+        if (!is_built_for(points, revision))
+            build(points, revision);
+
+        // the rows of the matrix, and the mapping from the normalized device coordinates to the screen
+        const float m00 = mvp(0, 0), m01 = mvp(0, 1), m02 = mvp(0, 2), m03 = mvp(0, 3);
+        const float m10 = mvp(1, 0), m11 = mvp(1, 1), m12 = mvp(1, 2), m13 = mvp(1, 3);
+        const float m30 = mvp(3, 0), m31 = mvp(3, 1), m32 = mvp(3, 2), m33 = mvp(3, 3);
+        const float sx = 0.5f * static_cast<float>(width - 1);
+        const float sy = 0.5f * static_cast<float>(height - 1);
+
+        struct Counts {
+            std::size_t count, accepted, rejected, tested;
+        };
+        const Counts none = {0, 0, 0, 0};
+        const int num_cells = static_cast<int>(boxes_.size());
+        const Counts total = parallel_reduce(0, num_cells, none, [&](int begin, int end, Counts counts) {
+            for (int c = begin; c < end; ++c) {
+                const std::size_t first = offsets_[c], last = offsets_[c + 1];
+
+                // the projection of the box is the convex hull of its projected corners if they are all in front of the
+                // camera. Otherwise, the points are tested one by one.
+                const Box3 &box = boxes_[c];
+                Region::Status status = Region::OUTSIDE;
+                if (box.is_valid()) {
+                    float bx0 = FLT_MAX, bx1 = -FLT_MAX, by0 = FLT_MAX, by1 = -FLT_MAX;
+                    bool in_front = true;
+                    for (int k = 0; k < 8 && in_front; ++k) {
+                        const float x = (k & 1) ? box.max_coord(0) : box.min_coord(0);
+                        const float y = (k & 2) ? box.max_coord(1) : box.min_coord(1);
+                        const float z = (k & 4) ? box.max_coord(2) : box.min_coord(2);
+                        const float w = m30 * x + m31 * y + m32 * z + m33;
+                        if (w <= 0.0f) {
+                            in_front = false;
+                            break;
+                        }
+                        const float px = ((m00 * x + m01 * y + m02 * z + m03) / w + 1.0f) * sx;
+                        const float py = (1.0f - (m10 * x + m11 * y + m12 * z + m13) / w) * sy;
+                        bx0 = std::min(bx0, px);
+                        bx1 = std::max(bx1, px);
+                        by0 = std::min(by0, py);
+                        by1 = std::max(by1, py);
+                    }
+                    status = in_front ? region.classify(bx0, bx1, by0, by1) : Region::PARTIAL;
+                }
+
+                if (status == Region::OUTSIDE) {
+                    ++counts.rejected;
+                    continue;
+                } else if (status == Region::INSIDE) {
+                    for (std::size_t i = first; i < last; ++i)
+                        inside[order_[i]] = 1;
+                    counts.count += last - first;
+                    ++counts.accepted;
+                    continue;
+                }
+
+                // project the points in batches (the middle loop has no dependencies and is vectorized)
+                ++counts.tested;
+                const std::size_t batch = 64;
+                float px[batch], py[batch], pz[batch], qx[batch], qy[batch], qw[batch];
+                for (std::size_t start = first; start < last; start += batch) {
+                    const std::size_t n = std::min(batch, last - start);
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const vec3 &p = points[order_[start + k]];
+                        px[k] = p.x;
+                        py[k] = p.y;
+                        pz[k] = p.z;
+                    }
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const float w = m30 * px[k] + m31 * py[k] + m32 * pz[k] + m33;
+                        const float inv = 1.0f / w;
+                        qx[k] = ((m00 * px[k] + m01 * py[k] + m02 * pz[k] + m03) * inv + 1.0f) * sx;
+                        qy[k] = (1.0f - (m10 * px[k] + m11 * py[k] + m12 * pz[k] + m13) * inv) * sy;
+                        qw[k] = w;
+                    }
+                    for (std::size_t k = 0; k < n; ++k) {
+                        if (qw[k] > 0.0f && region.contains(qx[k], qy[k])) {  // points behind the camera are ignored
+                            inside[order_[start + k]] = 1;
+                            ++counts.count;
+                        }
+                    }
+                }
+            }
+            return counts;
+        }, [](Counts a, const Counts &b) {
+            a.count += b.count;
+            a.accepted += b.accepted;
+            a.rejected += b.rejected;
+            a.tested += b.tested;
+            return a;
+        }, nullptr, 8);
+
+        num_accepted_ = total.accepted;
+        num_rejected_ = total.rejected;
+        num_tested_ = total.tested;
+        return total.count;
+    }
+
+
+
+    SelectionEngine &SelectionEngineCache::engine(const Model *model) {
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first == model) {
+                entries_.splice(entries_.begin(), entries_, it);
+                return entries_.front().second;
+            }
+        }
+        entries_.emplace_front(model, SelectionEngine());
+        if (entries_.size() > capacity_)
+            entries_.pop_back();
+        return entries_.front().second;
+    }
+
+
+    void SelectionEngineCache::remove(const Model *model) {
+        entries_.remove_if([model](const std::pair<const Model *, SelectionEngine> &entry) {
+            return entry.first == model;
+        });
+    }
+
+}
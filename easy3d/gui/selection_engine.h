@@ -0,0 +1,163 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_GUI_SELECTION_ENGINE_H
+#define EASY3D_GUI_SELECTION_ENGINE_H
+
+
+#include <list>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    class Model;
+
+    /**
+     * \brief Fast selection of the points inside a screen-space rectangle or lasso.
+     * \class SelectionEngine easy3d/gui/selection_engine.h
+     * \details The points are partitioned into spatially coherent cells (see ChunkCuller::partition()). For each
+     *      selection, the corners of the bounding box of each cell are projected first: a cell whose projection is
+     *      entirely outside (or inside) the region is rejected (or accepted) as a whole, and only the points of the
+     *      remaining cells are projected. The points are projected in batches (as structure of arrays, so the loops
+     *      are vectorized by the compiler), and the cells are processed in parallel using OpenMP (if enabled).
+     *      A lasso is rasterized once into a coverage bitmap (with a summed-area table for testing the cells), so
+     *      testing a point is a single lookup instead of a point-in-polygon test. A point is inside the lasso if the
+     *      center of the pixel it falls in is inside.
+     *
+     *      The selection is written into a byte array, in which each cell is written by a single thread. So, unlike
+     *      a std::vector<bool>, there is no data race between the threads.
+     *
+     *      The cells are built when the engine is first used on a set of points, and they are rebuilt if the points
+     *      are reallocated or resized. Since the points can also be modified in place, the cells are built for a
+     *      revision of the points (e.g., Model::geometry_revision()), and they are rebuilt if the revision changes.
+     *      This class contains no OpenGL code, so it can be tested without a rendering context.
+     * \see PointCloudPicker::pick_vertices(), SurfaceMeshPicker::pick_faces()
+     */
+    class SelectionEngine {
+    public:
+        /// \param cell_size The maximum number of points in each cell.
+        explicit SelectionEngine(std::size_t cell_size = 4096);
+
+        /// \brief (Re)builds the cells for the \p points at the given \p revision.
+        void build(const std::vector<vec3> &points, std::size_t revision = 0);
+
+        /**
+         * \brief Returns whether the cells have been built for the \p points, i.e., the same array with the same size
+         *      at the same \p revision.
+         */
+        bool is_built_for(const std::vector<vec3> &points, std::size_t revision = 0) const;
+
+        std::size_t num_cells() const { return boxes_.size(); }
+
+        /**
+         * \brief Determines the points inside a rectangle.
+         * \param points The points (in the coordinate system of \p mvp).
+         * \param revision The revision of the points, e.g., Model::geometry_revision(). The cells are rebuilt if it
+         *      differs from the one they were built for.
+         * \param mvp The transformation from the points to the clip space, e.g., the model view projection matrix
+         *      combined with the manipulation of the model.
+         * \param width The width of the screen (in the same unit as the region, e.g., Camera::screenWidth()).
+         * \param height The height of the screen.
+         * \param rect The rectangle in screen coordinates (the origin is the top left corner).
+         * \param inside Returns 1 for each point inside the region, and 0 otherwise.
+         * \return The number of points inside the region.
+         */
+        std::size_t select(const std::vector<vec3> &points, std::size_t revision, const mat4 &mvp, int width,
+                           int height, const Rect &rect, std::vector<unsigned char> &inside);
+
+        /// \brief Determines the points inside a polygon/lasso (in screen coordinates). \see select()
+        std::size_t select(const std::vector<vec3> &points, std::size_t revision, const mat4 &mvp, int width,
+                           int height, const Polygon2 &lasso, std::vector<unsigned char> &inside);
+
+        /// \brief The numbers of cells that were accepted, rejected, and tested point by point in the last selection.
+        void last_statistics(std::size_t &accepted, std::size_t &rejected, std::size_t &tested) const {
+            accepted = num_accepted_;
+            rejected = num_rejected_;
+            tested = num_tested_;
+        }
+
+    private:
+        struct Region;
+        std::size_t select(const std::vector<vec3> &points, std::size_t revision, const mat4 &mvp, int width,
+                           int height, const Region &region, std::vector<unsigned char> &inside);
+
+    private:
+        std::size_t cell_size_;
+
+        // the points the cells were built for
+        const vec3 *data_;
+        std::size_t size_;
+        std::size_t revision_;
+
+        std::vector<unsigned int> order_;   // the points ordered cell by cell
+        std::vector<std::size_t> offsets_;  // cell i: order_[offsets_[i]], ..., order_[offsets_[i + 1] - 1]
+        std::vector<Box3> boxes_;
+
+        std::size_t num_accepted_;
+        std::size_t num_rejected_;
+        std::size_t num_tested_;
+    };
+
+
+    /**
+     * \brief The selection engines of the most recently used models.
+     * \class SelectionEngineCache easy3d/gui/selection_engine.h
+     * \details The engines are kept aside (rather than with the models, e.g., as model properties, which would be
+     *      listed and copied with the models). An engine is found by its model, and its cells are rebuilt if the
+     *      geometry revision of the model changes (see Model::geometry_revision()). Only a few engines are kept, and
+     *      the least recently used one is dropped when another model is added.
+     */
+    class SelectionEngineCache {
+    public:
+        /// \param capacity The maximum number of engines to keep.
+        explicit SelectionEngineCache(std::size_t capacity = 4) : capacity_(capacity > 0 ? capacity : 1) {}
+
+        /// \brief Returns the engine of \p model, which is created if it does not exist.
+        SelectionEngine &engine(const Model *model);
+
+        /// \brief Drops the engine of \p model (if exists), e.g., when the model is deleted.
+        void remove(const Model *model);
+        /// \brief Drops all the engines.
+        void clear() { entries_.clear(); }
+
+        /// \brief The number of engines kept.
+        std::size_t size() const { return entries_.size(); }
+
+    private:
+        std::size_t capacity_;
+        std::list< std::pair<const Model *, SelectionEngine> > entries_;   // the most recently used first
+    };
+
+}
+
+
+#endif  // EASY3D_GUI_SELECTION_ENGINE_H
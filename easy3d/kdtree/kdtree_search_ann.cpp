@@ -28,6 +28,7 @@
 
 #include <easy3d/kdtree/kdtree_search_ann.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/kdtree/ANN/ANN.h>
 
@@ -83,6 +84,8 @@ namespace easy3d {
 
 
     void KdTreeSearch_ANN::end()  {
+        EASY3D_PROFILE_ZONE("KdTreeSearch_ANN::build");
+        EASY3D_PROFILE_ELEMENTS(points_num_);
         tree_ = new ANNkd_tree(points_, points_num_, 3);
     }
 
@@ -26,6 +26,7 @@
 
 #include <easy3d/kdtree/kdtree_search_eth.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/kdtree/ETH_Kd_Tree/kdTree.h>
 
@@ -58,6 +59,8 @@ namespace easy3d {
 
 
     void KdTreeSearch_ETH::end()  {
+        EASY3D_PROFILE_ZONE("KdTreeSearch_ETH::build");
+        EASY3D_PROFILE_ELEMENTS(points_num_);
         int maxBucketSize = 16 ;	// number of points per bucket
         tree_ = new kdtree::KdTree(reinterpret_cast<kdtree::Vector3D*>(points_), points_num_, maxBucketSize);
     }
@@ -26,6 +26,7 @@
 
 #include <easy3d/kdtree/kdtree_search_flann.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/kdtree/FLANN/flann.hpp>
 
@@ -60,6 +61,8 @@ namespace easy3d {
 
 
     void KdTreeSearch_FLANN::end()  {
+        EASY3D_PROFILE_ZONE("KdTreeSearch_FLANN::build");
+        EASY3D_PROFILE_ELEMENTS(points_num_);
         flann::Matrix<float> dataset(points_, points_num_, 3);
 
         // construct a single kd-tree optimized for searching lower dimensionality data
@@ -26,6 +26,7 @@
 
 #include <easy3d/kdtree/kdtree_search_nanoflann.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/profiler.h>
 
 #include <3rd_party/kdtree/nanoflann/nanoflann.hpp>
 
@@ -87,6 +88,8 @@ namespace easy3d {
 
 
     void KdTreeSearch_NanoFLANN::end() {
+        EASY3D_PROFILE_ZONE("KdTreeSearch_NanoFLANN::build");
+        EASY3D_PROFILE_ELEMENTS(points_ ? points_->size() : 0);
         PointSet* pset = new PointSet(points_);
         KdTree* tree = new KdTree(pset);
         tree->buildIndex();
@@ -32,6 +32,7 @@
 #include <easy3d/renderer/camera.h>
 #include <easy3d/renderer/shader_program.h>
 #include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/frame_profiler.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/shapes.h>
 #include <easy3d/renderer/shader_manager.h>
@@ -145,15 +146,24 @@ namespace easy3d {
 
 
     unsigned int AmbientOcclusion::generate(const std::vector<Model*>& models) {
+        FrameProfiler::Scope scope("ambient_occlusion");
+
         int viewport[4];
         glGetIntegerv(GL_VIEWPORT, viewport);
         init(viewport[2], viewport[3]);
 
-        geometry_pass(models);
-
-        ssao_pass();
-
-        blur_pass();
+        {
+            FrameProfiler::Scope pass("geometry_pass");
+            geometry_pass(models);
+        }
+        {
+            FrameProfiler::Scope pass("ssao_pass");
+            ssao_pass();
+        }
+        {
+            FrameProfiler::Scope pass("blur_pass");
+            blur_pass();
+        }
 
         return ssao_texture();
     }
@@ -194,18 +204,16 @@ namespace easy3d {
 
         for (auto model : models) {
             if (model->renderer()->is_visible()) {
-                // transformation introduced by manipulation
-                const mat4 MANIP = model->manipulator()->matrix();
+                // transformation introduced by manipulation (MANIP is per drawable, see Drawable::position_matrix())
                 // needs be padded when using uniform blocks
-                const mat3 NORMAL = transform::normal_matrix(MANIP);
-
-                program->set_uniform("MANIP", MANIP)
-                        ->set_uniform("NORMAL", NORMAL);
+                const mat3 NORMAL = transform::normal_matrix(model->manipulator()->matrix());
+                program->set_uniform("NORMAL", NORMAL);
 
                 for (auto d : model->renderer()->points_drawables()) {
                     if (d->is_visible()) {
                         if (setting::clipping_plane)
                             setting::clipping_plane->set_program(program);
+                        program->set_uniform("MANIP", d->position_matrix());
                         d->gl_draw(); easy3d_debug_log_gl_error
                     }
                 }
@@ -216,6 +224,7 @@ namespace easy3d {
                             setting::clipping_plane->set_discard_primitives(program, d->plane_clip_discard_primitive());
                         }
                         program->set_uniform("smooth_shading", d->smooth_shading());
+                        program->set_uniform("MANIP", d->position_matrix());
                         d->gl_draw(); easy3d_debug_log_gl_error
                     }
                 }
@@ -225,6 +234,7 @@ namespace easy3d {
                             setting::clipping_plane->set_program(program);
                             setting::clipping_plane->set_discard_primitives(program, d->plane_clip_discard_primitive());
                         }
+                        program->set_uniform("MANIP", d->position_matrix());
                         d->gl_draw(); easy3d_debug_log_gl_error
                     }
                 }
@@ -0,0 +1,197 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/renderer/async_pixel_reader.h>
+
+#include <cstring>
+
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    AsyncPixelReader::AsyncPixelReader(int num_buffers)
+            : buffers_(num_buffers > 0 ? num_buffers : 1), next_(0) {
+    }
+
+
+    AsyncPixelReader::~AsyncPixelReader() {
+        release();
+    }
+
+
+    void AsyncPixelReader::release() {
+        for (auto &buffer : buffers_) {
+            if (buffer.fence) {
+                glDeleteSync(static_cast<GLsync>(buffer.fence));
+                buffer.fence = nullptr;
+            }
+            if (buffer.id) {
+                glDeleteBuffers(1, &buffer.id);
+                easy3d_debug_log_gl_error;
+                buffer.id = 0;
+            }
+            buffer.capacity = 0;
+        }
+        pending_.clear();
+        next_ = 0;
+    }
+
+
+    bool AsyncPixelReader::request(int x, int y, int width, int height, unsigned int format, int index) {
+        if (is_full()) {
+            LOG(ERROR) << "all pixel buffers are pending. Retrieve the pixels before requesting new ones";
+            return false;
+        }
+
+        int pixel_size = 0;
+        GLenum type = GL_UNSIGNED_BYTE;
+        switch (format) {
+            case GL_RGB:
+            case GL_BGR:
+                pixel_size = 3;
+                break;
+            case GL_RGBA:
+            case GL_BGRA:
+                pixel_size = 4;
+                break;
+            case GL_RED_INTEGER:
+                pixel_size = 4;
+                type = GL_UNSIGNED_INT;
+                break;
+            case GL_RG_INTEGER:
+                pixel_size = 8;
+                type = GL_UNSIGNED_INT;
+                break;
+            case GL_RGBA_INTEGER:
+                pixel_size = 16;
+                type = GL_UNSIGNED_INT;
+                break;
+            default:
+                LOG(ERROR) << "unsupported pixel format (only GL_RGB, GL_BGR, GL_RGBA, GL_BGRA, GL_RED_INTEGER, "
+                              "GL_RG_INTEGER, and GL_RGBA_INTEGER are accepted)";
+                return false;
+        }
+
+        Buffer &buffer = buffers_[next_];
+        const std::size_t size = static_cast<std::size_t>(width) * height * pixel_size;
+        if (buffer.id == 0) {
+            glGenBuffers(1, &buffer.id);
+            easy3d_debug_log_gl_error;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id);
+        easy3d_debug_log_gl_error;
+        if (buffer.capacity < size) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+            easy3d_debug_log_gl_error;
+            buffer.capacity = size;
+        }
+
+        GLint read_buffer = 0, alignment = 0;
+        glGetIntegerv(GL_READ_BUFFER, &read_buffer);
+        glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+        // the default framebuffer has no color attachments
+        GLint framebuffer = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &framebuffer);
+        if (framebuffer != 0)
+            glReadBuffer(GL_COLOR_ATTACHMENT0 + index);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        // with a buffer bound to GL_PIXEL_PACK_BUFFER, the last argument is an offset and the call returns immediately
+        glReadPixels(x, y, width, height, format, type, nullptr);
+        easy3d_debug_log_gl_error;
+
+        glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+        glReadBuffer(static_cast<GLenum>(read_buffer));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        easy3d_debug_log_gl_error;
+        // make sure the commands are submitted, otherwise waiting for the fence may never return
+        glFlush();
+
+        buffer.width = width;
+        buffer.height = height;
+        buffer.pixel_size = pixel_size;
+        pending_.push_back(next_);
+        next_ = (next_ + 1) % buffers_.size();
+        return true;
+    }
+
+
+    bool AsyncPixelReader::is_ready() const {
+        if (pending_.empty())
+            return false;
+        const Buffer &buffer = buffers_[pending_.front()];
+        if (!buffer.fence)
+            return true;
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(static_cast<GLsync>(buffer.fence), GL_SYNC_STATUS, sizeof(GLint), nullptr, &status);
+        return status == GL_SIGNALED;
+    }
+
+
+    bool AsyncPixelReader::retrieve(std::vector<unsigned char> &pixels, int &width, int &height) {
+        if (pending_.empty())
+            return false;
+
+        Buffer &buffer = buffers_[pending_.front()];
+        pending_.pop_front();
+
+        if (buffer.fence) {
+            const GLuint64 timeout = 1000000000; // 1 second, in nanoseconds
+            GLenum status = GL_TIMEOUT_EXPIRED;
+            while (status == GL_TIMEOUT_EXPIRED)
+                status = glClientWaitSync(static_cast<GLsync>(buffer.fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            LOG_IF(status == GL_WAIT_FAILED, ERROR) << "failed waiting for the pixel transfer";
+            glDeleteSync(static_cast<GLsync>(buffer.fence));
+            buffer.fence = nullptr;
+        }
+
+        const std::size_t size = static_cast<std::size_t>(buffer.width) * buffer.height * buffer.pixel_size;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id);
+        easy3d_debug_log_gl_error;
+        const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+        easy3d_debug_log_gl_error;
+        bool success = (data != nullptr);
+        if (success) {
+            pixels.resize(size);
+            std::memcpy(pixels.data(), data, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            easy3d_debug_log_gl_error;
+            width = buffer.width;
+            height = buffer.height;
+        } else
+            LOG(ERROR) << "failed mapping the pixel buffer";
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return success;
+    }
+
+}
@@ -0,0 +1,121 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_RENDERER_ASYNC_PIXEL_READER_H
+#define EASY3D_RENDERER_ASYNC_PIXEL_READER_H
+
+#include <vector>
+#include <deque>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Asynchronous readback of the color pixels of a framebuffer using pixel buffer objects (PBOs).
+     *
+     * \class AsyncPixelReader easy3d/renderer/async_pixel_reader.h
+     *
+     * \details glReadPixels() into client memory stalls the CPU until the GPU has finished rendering and the
+     * transfer is completed. With a pixel buffer object bound to GL_PIXEL_PACK_BUFFER, glReadPixels() returns
+     * immediately and the transfer runs in the background. Using several PBOs in a ring (double buffering by
+     * default), the pixels of frame i are retrieved only after frame i+1 has been submitted, so rendering and
+     * readback overlap.
+     *
+     * \note The framebuffer must not be multisampled (i.e., blit a multisample framebuffer into a normal one first).
+     *      All methods must be called from a thread with the OpenGL context bound.
+     *
+     * Usage example:
+     *      \code
+     *      AsyncPixelReader reader;
+     *      for (std::size_t i = 0; i < num_frames; ++i) {
+     *          // ... render the i-th frame into the currently bound framebuffer ...
+     *          if (reader.is_full())    // retrieve the oldest frame before requesting a new one
+     *              reader.retrieve(pixels, w, h);
+     *          reader.request(0, 0, width, height);
+     *      }
+     *      while (reader.num_pending() > 0)
+     *          reader.retrieve(pixels, w, h);
+     *      \endcode
+     */
+    class AsyncPixelReader {
+    public:
+        /// \param num_buffers The number of pixel buffer objects (i.e., the maximum number of pending requests).
+        explicit AsyncPixelReader(int num_buffers = 2);
+        ~AsyncPixelReader();
+
+        /**
+         * \brief Starts reading the pixels of a region of the currently bound read framebuffer. Returns immediately.
+         * \param x, y The lower left corner of the region, in the OpenGL coordinate system.
+         * \param width, height The size of the region.
+         * \param format The format of the pixel data. The following formats are accepted: GL_RGB, GL_BGR, GL_RGBA,
+         *      and GL_BGRA, for which each channel is an unsigned byte, and GL_RED_INTEGER, GL_RG_INTEGER, and
+         *      GL_RGBA_INTEGER (for integer color buffers), for which each channel is an unsigned int.
+         * \param index The color attachment to read from.
+         * \return false if all buffers are pending (call retrieve() first).
+         */
+        bool request(int x, int y, int width, int height, unsigned int format, int index = 0);
+
+        /**
+         * \brief Retrieves the pixels of the oldest pending request. This blocks only if the transfer hasn't finished.
+         * \param pixels Returns the pixel data. The rows are ordered from bottom to top (the OpenGL convention). For
+         *      the integer formats, the bytes of each channel are in the native byte order.
+         * \param width, height Return the size of the region.
+         * \return false if there is no pending request.
+         */
+        bool retrieve(std::vector<unsigned char> &pixels, int &width, int &height);
+
+        /// Returns true if the oldest pending request has finished, i.e., retrieve() will not block.
+        bool is_ready() const;
+
+        /// Returns the number of pending requests.
+        std::size_t num_pending() const { return pending_.size(); }
+
+        /// Returns true if all buffers are pending.
+        bool is_full() const { return pending_.size() == buffers_.size(); }
+
+        /// Releases the pixel buffer objects (all pending requests are discarded).
+        void release();
+
+    private:
+        struct Buffer {
+            Buffer() : id(0), capacity(0), width(0), height(0), pixel_size(0), fence(nullptr) {}
+            unsigned int id;
+            std::size_t capacity;
+            int width;
+            int height;
+            int pixel_size;     // in bytes
+            void *fence;
+        };
+        std::vector<Buffer> buffers_;
+        std::deque<std::size_t> pending_;   // indices of the pending buffers, the oldest first
+        std::size_t next_;
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_ASYNC_PIXEL_READER_H
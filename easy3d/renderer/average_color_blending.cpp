@@ -27,6 +27,7 @@
 #include <easy3d/renderer/average_color_blending.h>
 #include <easy3d/renderer/camera.h>
 #include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/frame_profiler.h>
 #include <easy3d/renderer/drawable_triangles.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/shader_manager.h>
@@ -106,9 +107,9 @@ namespace easy3d {
         for (auto d : surfaces) {
             if (d->is_visible()) {
                 // transformation introduced by manipulation
-                const mat4 MANIP = d->manipulated_matrix();
+                const mat4 MANIP = d->position_matrix();
                 // needs be padded when using uniform blocks
-                const mat3 NORMAL = transform::normal_matrix(MANIP);
+                const mat3 NORMAL = transform::normal_matrix(d->manipulated_matrix());
                 program->set_uniform("MANIP", MANIP)
                         ->set_uniform( "NORMAL", NORMAL);
                 program->set_uniform("smooth_shading", d->smooth_shading());
@@ -135,6 +136,7 @@ namespace easy3d {
     {
         if (surfaces.empty())
             return;
+        FrameProfiler::Scope scope("average_color_blending");
 
         int viewport[4];
         glGetIntegerv(GL_VIEWPORT, viewport);
@@ -154,7 +156,10 @@ namespace easy3d {
         glEnable(GL_BLEND);
         glBlendEquation(GL_FUNC_ADD);
         glBlendFunc(GL_ONE, GL_ONE);
-        geometry_pass(surfaces);
+        {
+            FrameProfiler::Scope pass("geometry_pass");
+            geometry_pass(surfaces);
+        }
         fbo_->release();
 
         // ---------------------------------------------------------------------
@@ -27,6 +27,7 @@
 #include <easy3d/renderer/buffers.h>
 
 #include <algorithm>
+#include <cstring>
 
 #include <easy3d/core/graph.h>
 #include <easy3d/core/point_cloud.h>
@@ -38,6 +39,9 @@
 #include <easy3d/renderer/drawable_triangles.h>
 #include <easy3d/renderer/texture_manager.h>
 #include <easy3d/algo/tessellator.h>
+#include <easy3d/algo/triangle_order_optimizer.h>
+#include <easy3d/util/profiler.h>
+#include <easy3d/util/thread_pool.h>
 
 
 namespace easy3d {
@@ -90,6 +94,467 @@ namespace easy3d {
             }
 
 
+            // colors may be stored in 8-bit (as u8vec3, see LoadOptions). These return them as floats for the GPU.
+            inline const vec3 &to_float_color(const vec3 &c) { return c; }
+            inline vec3 to_float_color(const u8vec3 &c) { return rgb::unpack(c); }
+            inline const std::vector<vec3> &to_float_colors(const std::vector<vec3> &colors) { return colors; }
+            inline std::vector<vec3> to_float_colors(const std::vector<u8vec3> &colors) {
+                std::vector<vec3> result(colors.size());
+                for (std::size_t i = 0; i < colors.size(); ++i)
+                    result[i] = rgb::unpack(colors[i]);
+                return result;
+            }
+
+
+            // uploads the vertex normals (if exist) of a point cloud or a graph, which may be stored in half precision
+            // (as hvec3 "v:normal_h", see LoadOptions).
+            template<typename MODEL>
+            inline void update_vertex_normals(MODEL *model, Drawable *drawable) {
+                auto normals = model->template get_vertex_property<vec3>("v:normal");
+                if (normals) {
+                    drawable->update_normal_buffer(normals.vector());
+                    return;
+                }
+                auto half_normals = model->template get_vertex_property<hvec3>("v:normal_h");
+                if (half_normals) {
+                    const auto &packed = half_normals.vector();
+                    std::vector<vec3> d_normals(packed.size());
+                    for (std::size_t i = 0; i < packed.size(); ++i)
+                        d_normals[i] = half::unpack(packed[i]);
+                    drawable->update_normal_buffer(d_normals);
+                }
+            }
+
+
+            /**
+             * Triangulates the faces of a surface mesh in terms of their corners (i.e., the halfedges pointing to the
+             * vertices of the faces), so the attributes of each triangle vertex can be looked up directly from the
+             * model. Triangles are used as they are and convex quads are split along the shorter diagonal, both in
+             * parallel. Only the other faces (concave quads and general polygons) go through the Tessellator. The
+             * corners are stored face by face (3 per triangle), and the range of the triangles of each face is
+             * recorded in "f:triangle_range".
+             */
+            inline void triangulate(SurfaceMesh *model, std::vector<SurfaceMesh::Halfedge> &corners) {
+                typedef SurfaceMesh::Face       Face;
+                typedef SurfaceMesh::Halfedge   Halfedge;
+
+                auto points = model->get_vertex_property<vec3>("v:point");
+                const int num_faces = static_cast<int>(model->faces_size());
+
+                // the number of triangles of each face (-1: to be triangulated by the Tessellator)
+                std::vector<int> num_triangles(num_faces, 0);
+                parallel_for(0, num_faces, [&](int i) {
+                    const Face f(i);
+                    if (model->is_deleted(f))
+                        return;
+                    const unsigned int valence = model->valence(f);
+                    if (valence == 3)
+                        num_triangles[i] = 1;
+                    else if (valence == 4) {
+                        const Halfedge h0 = model->halfedge(f);
+                        const vec3 &p0 = points[model->target(h0)];
+                        const vec3 &p1 = points[model->target(model->next(h0))];
+                        const vec3 &p2 = points[model->target(model->next(model->next(h0)))];
+                        const vec3 &p3 = points[model->target(model->prev(h0))];
+                        // a quad is convex if all its corners turn to the same side as its normal
+                        const vec3 n = cross(p2 - p0, p3 - p1);
+                        const bool convex = dot(cross(p1 - p0, p2 - p1), n) > 0 && dot(cross(p2 - p1, p3 - p2), n) > 0 &&
+                                            dot(cross(p3 - p2, p0 - p3), n) > 0 && dot(cross(p0 - p3, p1 - p0), n) > 0;
+                        num_triangles[i] = convex ? 2 : -1;
+                    } else
+                        num_triangles[i] = -1;
+                });
+
+                // faces that can not be split directly
+                std::vector< std::vector<Halfedge> > complex_corners;
+                std::vector<int> complex_index(num_faces, -1);
+                Tessellator tessellator;
+                std::vector<Halfedge> face_corners;
+                for (int i = 0; i < num_faces; ++i) {
+                    if (num_triangles[i] >= 0)
+                        continue;
+                    const Face f(i);
+                    face_corners.clear();
+                    for (auto h : model->halfedges(f))
+                        face_corners.push_back(h);
+
+                    tessellator.reset();
+                    tessellator.begin_polygon(model->compute_face_normal(f));
+                    tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
+                    tessellator.begin_contour();
+                    for (std::size_t k = 0; k < face_corners.size(); ++k)
+                        tessellator.add_vertex(points[model->target(face_corners[k])], static_cast<int>(k));
+                    tessellator.end_contour();
+                    tessellator.end_polygon();
+
+                    std::vector<Halfedge> triangles;
+                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
+                    bool valid = true;
+                    for (const auto &tri : tessellator.elements()) {
+                        for (unsigned char j = 0; j < 3; ++j) {
+                            const int k = vts[tri[j]]->index;
+                            if (k < 0 || k >= static_cast<int>(face_corners.size())) {
+                                valid = false; // a new vertex was generated (self-intersecting face)
+                                break;
+                            }
+                            triangles.push_back(face_corners[k]);
+                        }
+                    }
+                    if (!valid) {
+                        LOG_N_TIMES(3, WARNING) << "face " << f << " is self-intersecting (triangulated as a fan). " << COUNTER;
+                        triangles.clear();
+                        for (std::size_t k = 1; k + 1 < face_corners.size(); ++k) {
+                            triangles.push_back(face_corners[0]);
+                            triangles.push_back(face_corners[k]);
+                            triangles.push_back(face_corners[k + 1]);
+                        }
+                    }
+
+                    complex_index[i] = static_cast<int>(complex_corners.size());
+                    num_triangles[i] = static_cast<int>(triangles.size() / 3);
+                    complex_corners.push_back(triangles);
+                }
+
+                // the first triangle of each face
+                std::vector<int> offsets(num_faces + 1, 0);
+                for (int i = 0; i < num_faces; ++i)
+                    offsets[i + 1] = offsets[i] + num_triangles[i];
+
+                auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
+                corners.resize(offsets[num_faces] * 3);
+                parallel_for(0, num_faces, [&](int i) {
+                    const Face f(i);
+                    if (model->is_deleted(f))
+                        return;
+                    triangle_range[f] = std::make_pair(offsets[i], offsets[i + 1] - 1);
+
+                    Halfedge *out = corners.data() + offsets[i] * 3;
+                    if (complex_index[i] >= 0) {
+                        const auto &triangles = complex_corners[complex_index[i]];
+                        std::copy(triangles.begin(), triangles.end(), out);
+                    } else {
+                        const Halfedge h0 = model->halfedge(f);
+                        const Halfedge h1 = model->next(h0);
+                        const Halfedge h2 = model->next(h1);
+                        if (num_triangles[i] == 1) {
+                            out[0] = h0; out[1] = h1; out[2] = h2;
+                        } else { // convex quad: split along the shorter diagonal
+                            const Halfedge h3 = model->next(h2);
+                            const float d02 = distance2(points[model->target(h0)], points[model->target(h2)]);
+                            const float d13 = distance2(points[model->target(h1)], points[model->target(h3)]);
+                            if (d02 <= d13) {
+                                out[0] = h0; out[1] = h1; out[2] = h2;
+                                out[3] = h0; out[4] = h2; out[5] = h3;
+                            } else {
+                                out[0] = h0; out[1] = h1; out[2] = h3;
+                                out[3] = h1; out[4] = h2; out[5] = h3;
+                            }
+                        }
+                    }
+                });
+            }
+
+
+            // returns the element buffer of the triangulated faces (given by their corners) with the per-vertex
+            // attributes of the model.
+            inline std::vector<unsigned int> vertex_indices(SurfaceMesh *model, const std::vector<SurfaceMesh::Halfedge> &corners) {
+                const int num = static_cast<int>(corners.size());
+                std::vector<unsigned int> indices(num);
+                parallel_for(0, num, [&](int i) {
+                    indices[i] = model->target(corners[i]).idx();
+                });
+                return indices;
+            }
+
+
+            // collects the faces of a surface mesh in the order of their triangles in the element buffer, and the
+            // groups of triangles of the faces (i.e., the first triangle of each face, followed by the number of
+            // triangles, see TriangleOrderOptimizer).
+            inline bool face_groups(SurfaceMesh *model, std::size_t num_triangles, std::vector<SurfaceMesh::Face> &faces,
+                                    std::vector<unsigned int> &groups) {
+                auto triangle_range = model->get_face_property<std::pair<int, int> >("f:triangle_range");
+                if (!triangle_range)
+                    return false;
+
+                faces.clear();
+                faces.reserve(model->n_faces());
+                for (auto f : model->faces())
+                    faces.push_back(f);
+                // the triangles are stored face by face after triangulate(), but not after reordering
+                std::stable_sort(faces.begin(), faces.end(), [&triangle_range](SurfaceMesh::Face a, SurfaceMesh::Face b) {
+                    return triangle_range[a].first < triangle_range[b].first;
+                });
+                groups.resize(faces.size() + 1);
+                for (std::size_t i = 0; i < faces.size(); ++i)
+                    groups[i] = static_cast<unsigned int>(triangle_range[faces[i]].first);
+                groups.back() = static_cast<unsigned int>(num_triangles);
+                return true;
+            }
+
+
+            // reorders the groups of triangles of the faces in an element buffer, and updates "f:triangle_range".
+            inline void reorder_faces(SurfaceMesh *model, const std::vector<unsigned int> &order,
+                                      const std::vector<SurfaceMesh::Face> &faces, std::vector<unsigned int> &indices,
+                                      std::vector<unsigned int> &groups) {
+                auto triangle_range = model->get_face_property<std::pair<int, int> >("f:triangle_range");
+                TriangleOrderOptimizer::apply(order, indices, groups);
+                for (std::size_t i = 0; i < order.size(); ++i)
+                    triangle_range[faces[order[i]]] = std::make_pair(int(groups[i]), int(groups[i + 1]) - 1);
+            }
+
+
+            // reorders the triangles of an element buffer of a surface mesh for the vertex cache and overdraw, if
+            // requested by the drawable. The triangles of each face stay together, and "f:triangle_range" is updated.
+            inline void optimize_triangle_order(SurfaceMesh *model, TrianglesDrawable *drawable,
+                                                std::vector<unsigned int> &indices, const std::vector<vec3> &points) {
+                if (!drawable->optimize_triangle_order() || indices.size() < 6)
+                    return;
+
+                std::vector<SurfaceMesh::Face> faces;
+                std::vector<unsigned int> groups;
+                if (!face_groups(model, indices.size() / 3, faces, groups))
+                    return;
+
+                const auto &order = TriangleOrderOptimizer::optimize(indices, points, groups);
+                reorder_faces(model, order, faces, indices, groups);
+            }
+
+
+            // the material of each face (given in the order of the element buffer), according to the range of the
+            // faces of each material stored in the model property "material_ranges" (see io::load_obj()). Faces not
+            // covered by the ranges get the last material id (i.e., the number of ranges). Returns false if the model
+            // has no material ranges, or if the ranges do not match the faces (e.g., after the model was edited).
+            inline bool face_materials(SurfaceMesh *model, const std::vector<SurfaceMesh::Face> &faces,
+                                       std::vector<int> &materials) {
+                auto prop = model->get_model_property<std::vector<std::pair<int, int> > >("material_ranges");
+                if (!prop || model->has_garbage())
+                    return false;
+
+                const auto &ranges = prop[0];
+                const int num_ranges = static_cast<int>(ranges.size());
+                std::vector<int> material(model->faces_size(), num_ranges);
+                for (int m = 0; m < num_ranges; ++m) {
+                    const int first = ranges[m].first, count = ranges[m].second;
+                    if (first < 0 || count < 0 || first + count > static_cast<int>(model->faces_size()))
+                        return false;
+                    std::fill(material.begin() + first, material.begin() + first + count, m);
+                }
+
+                materials.resize(faces.size());
+                for (std::size_t i = 0; i < faces.size(); ++i)
+                    materials[i] = material[faces[i].idx()];
+                return true;
+            }
+
+
+            // groups the triangles of an element buffer of a surface mesh by material (see face_materials()), keeping
+            // their current order within each material, and updates "f:triangle_range". Returns the first face (in the
+            // order of the element buffer) of each material, followed by the number of faces (the faces without
+            // material come last), and the range of the element buffer (the first index and the number of indices) of
+            // each material in \p ranges. Both are empty if the model has no materials.
+            inline std::vector<std::size_t> group_by_material(SurfaceMesh *model, std::vector<unsigned int> &indices,
+                                                              std::vector<std::pair<std::size_t, std::size_t> > &ranges) {
+                ranges.clear();
+                std::vector<SurfaceMesh::Face> faces;
+                std::vector<unsigned int> groups;
+                std::vector<int> materials;
+                if (!face_groups(model, indices.size() / 3, faces, groups) || !face_materials(model, faces, materials))
+                    return std::vector<std::size_t>();
+
+                const std::size_t num_materials = model->get_model_property<std::vector<std::pair<int, int> > >(
+                        "material_ranges")[0].size();
+                std::vector<std::size_t> offsets(num_materials + 2, 0);
+                for (auto m : materials)
+                    ++offsets[m + 1];
+                for (std::size_t m = 1; m < offsets.size(); ++m)
+                    offsets[m] += offsets[m - 1];
+
+                std::vector<unsigned int> order(faces.size());
+                std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+                for (std::size_t i = 0; i < faces.size(); ++i)
+                    order[next[materials[i]]++] = static_cast<unsigned int>(i);
+                reorder_faces(model, order, faces, indices, groups);
+
+                for (std::size_t m = 0; m < num_materials; ++m) {
+                    const std::size_t first = groups[offsets[m]] * 3;
+                    ranges.emplace_back(first, groups[offsets[m + 1]] * 3 - first);
+                }
+                return offsets;
+            }
+
+
+            // the chunks of a range of an element buffer, given by the offsets of the chunks (in number of primitives)
+            inline std::vector<ChunkCuller::Chunk> make_chunks(const std::vector<unsigned int> &indices,
+                                                               const std::vector<vec3> &points,
+                                                               const std::vector<std::size_t> &offsets,
+                                                               std::size_t indices_per_primitive) {
+                std::vector<ChunkCuller::Chunk> chunks(offsets.size() - 1);
+                const int num = static_cast<int>(chunks.size());
+                parallel_for(0, num, [&](int i) {
+                    const std::size_t first = offsets[i] * indices_per_primitive;
+                    const std::size_t last = offsets[i + 1] * indices_per_primitive;
+                    Box3 box;
+                    for (std::size_t j = first; j < last; ++j)
+                        box.grow(points[indices[j]]);
+                    chunks[i] = ChunkCuller::Chunk(box, first, last - first);
+                });
+                return chunks;
+            }
+
+
+            // partitions the triangles of an element buffer of a surface mesh into spatially coherent chunks, if
+            // requested by the drawable. The triangles of each face stay together (in their current order within each
+            // chunk), and "f:triangle_range" is updated. If the faces are grouped by material (given by the offsets
+            // returned by group_by_material()), each material is partitioned separately, so no chunk spans materials.
+            inline void build_triangle_chunks(SurfaceMesh *model, TrianglesDrawable *drawable,
+                                              std::vector<unsigned int> &indices, const std::vector<vec3> &points,
+                                              const std::vector<std::size_t> &material_offsets) {
+                const std::size_t num_triangles = indices.size() / 3;
+                if (drawable->chunk_size() == 0 || num_triangles <= drawable->chunk_size())
+                    return;
+
+                std::vector<SurfaceMesh::Face> faces;
+                std::vector<unsigned int> groups;
+                if (!face_groups(model, num_triangles, faces, groups))
+                    return;
+
+                // each face is represented by the center of its vertices
+                const int num_faces = static_cast<int>(faces.size());
+                std::vector<vec3> centers(num_faces);
+                parallel_for(0, num_faces, [&](int i) {
+                    vec3 center(0.0f, 0.0f, 0.0f);
+                    const std::size_t first = groups[i] * 3, last = groups[i + 1] * 3;
+                    for (std::size_t j = first; j < last; ++j)
+                        center += points[indices[j]];
+                    centers[i] = (last > first) ? center / static_cast<float>(last - first) : center;
+                });
+
+                // the number of faces in each chunk, such that each chunk has about chunk_size() triangles
+                const std::size_t faces_per_chunk = std::max<std::size_t>(
+                        1, drawable->chunk_size() * faces.size() / num_triangles);
+                std::vector<std::size_t> segments = material_offsets;
+                if (segments.empty())
+                    segments = {0, faces.size()};
+                std::vector<unsigned int> order;
+                std::vector<std::size_t> face_offsets(1, 0);
+                for (std::size_t s = 0; s + 1 < segments.size(); ++s) {
+                    if (segments[s + 1] == segments[s])
+                        continue;
+                    const std::vector<vec3> segment_centers(centers.begin() + segments[s], centers.begin() + segments[s + 1]);
+                    std::vector<unsigned int> segment_order;
+                    const auto segment_offsets = ChunkCuller::partition(segment_centers, faces_per_chunk, segment_order);
+                    for (auto i : segment_order)
+                        order.push_back(static_cast<unsigned int>(i + segments[s]));
+                    for (std::size_t c = 1; c < segment_offsets.size(); ++c)
+                        face_offsets.push_back(segment_offsets[c] + segments[s]);
+                }
+                // keep the current order (e.g., optimized for the vertex cache) within each chunk
+                for (std::size_t c = 0; c + 1 < face_offsets.size(); ++c)
+                    std::sort(order.begin() + face_offsets[c], order.begin() + face_offsets[c + 1]);
+                reorder_faces(model, order, faces, indices, groups);
+
+                std::vector<std::size_t> offsets(face_offsets.size());
+                for (std::size_t c = 0; c < face_offsets.size(); ++c)
+                    offsets[c] = groups[face_offsets[c]];
+                drawable->set_chunks(make_chunks(indices, points, offsets, 3));
+            }
+
+
+            // reorders the triangles of an element buffer of a surface mesh for rendering efficiency and culling, as
+            // requested by the drawable. The triangles of each material (if any) stay contiguous, and their ranges are
+            // given to the drawable, i.e., one draw range per material.
+            inline void organize_triangles(SurfaceMesh *model, TrianglesDrawable *drawable,
+                                           std::vector<unsigned int> &indices, const std::vector<vec3> &points) {
+                optimize_triangle_order(model, drawable, indices, points);
+                // the chunks keep the faces within their materials, so the ranges of the materials do not change
+                std::vector<std::pair<std::size_t, std::size_t> > ranges;
+                const auto material_offsets = group_by_material(model, indices, ranges);
+                build_triangle_chunks(model, drawable, indices, points, material_offsets);
+                drawable->set_material_ranges(ranges);
+            }
+
+
+            // partitions the points of a points drawable (given in the order of the vertex buffer) into spatially
+            // coherent chunks, if requested by the drawable. The chunks are ranges of an element buffer that lists the
+            // points chunk by chunk.
+            inline void build_point_chunks(PointsDrawable *drawable, const std::vector<vec3> &points) {
+                if (drawable->chunk_size() == 0 || points.size() <= drawable->chunk_size() ||
+                    drawable->num_vertices() != points.size()) {
+                    if (drawable->element_buffer())
+                        drawable->disable_element_buffer();
+                    return;
+                }
+
+                std::vector<unsigned int> indices;
+                const auto offsets = ChunkCuller::partition(points, drawable->chunk_size(), indices);
+                drawable->update_element_buffer(indices);
+                drawable->set_chunks(make_chunks(indices, points, offsets, 1));
+            }
+
+
+            // returns the element buffer of the triangulated faces with the per-vertex attributes of the model,
+            // reordered for rendering efficiency if requested by the drawable.
+            inline std::vector<unsigned int> element_indices(SurfaceMesh *model, TrianglesDrawable *drawable,
+                                                             const std::vector<SurfaceMesh::Halfedge> &corners) {
+                std::vector<unsigned int> indices = vertex_indices(model, corners);
+                organize_triangles(model, drawable, indices, model->points());
+                return indices;
+            }
+
+
+            /**
+             * Eliminates the duplicate (vertex, attribute) pairs of the corners of the triangulated faces, such that
+             * each unique pair is sent to the GPU only once. The attributes (e.g., per-face colors, per-halfedge
+             * texture coordinates) are given for each corner. A flat (i.e., open addressing) hash table is used so no
+             * memory is allocated per corner.
+             */
+            template<typename AT>
+            inline void unique_corners(SurfaceMesh *model, const std::vector<SurfaceMesh::Halfedge> &corners,
+                                       const std::vector<AT> &attributes, std::vector<unsigned int> &indices,
+                                       std::vector<SurfaceMesh::Vertex> &unique_vertices, std::vector<AT> &unique_attributes) {
+                std::size_t capacity = 16;
+                while (capacity < corners.size() * 2)
+                    capacity *= 2;
+                std::vector<int> table(capacity, -1);
+
+                auto hash = [](int vertex, const AT &attribute) -> std::size_t {
+                    // FNV-1a over the vertex index and the bytes of the attribute
+                    std::size_t h = 14695981039346656037ull;
+                    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&vertex);
+                    for (std::size_t i = 0; i < sizeof(int); ++i)
+                        h = (h ^ bytes[i]) * 1099511628211ull;
+                    bytes = reinterpret_cast<const unsigned char *>(&attribute);
+                    for (std::size_t i = 0; i < sizeof(AT); ++i)
+                        h = (h ^ bytes[i]) * 1099511628211ull;
+                    return h;
+                };
+
+                indices.resize(corners.size());
+                unique_vertices.clear();
+                unique_attributes.clear();
+                for (std::size_t i = 0; i < corners.size(); ++i) {
+                    const auto v = model->target(corners[i]);
+                    const AT &a = attributes[i];
+                    std::size_t slot = hash(v.idx(), a) & (capacity - 1);
+                    while (true) {
+                        const int id = table[slot];
+                        if (id < 0) {
+                            table[slot] = static_cast<int>(unique_vertices.size());
+                            indices[i] = static_cast<unsigned int>(unique_vertices.size());
+                            unique_vertices.push_back(v);
+                            unique_attributes.push_back(a);
+                            break;
+                        }
+                        if (unique_vertices[id] == v && std::memcmp(&unique_attributes[id], &a, sizeof(AT)) == 0) {
+                            indices[i] = static_cast<unsigned int>(id);
+                            break;
+                        }
+                        slot = (slot + 1) & (capacity - 1);
+                    }
+                }
+            }
+
+
             template<typename MODEL, typename FT>
             inline void
             update_scalar_on_vertices(MODEL *model, PointsDrawable *drawable, typename MODEL::template VertexProperty<FT> prop) {
@@ -119,9 +584,7 @@ namespace easy3d {
                 drawable->update_vertex_buffer(points.vector());
                 drawable->update_texcoord_buffer(d_texcoords);
 
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
-                if (normals)
-                    drawable->update_normal_buffer(normals.vector());
+                details::update_vertex_normals(model, drawable);
             }
 
 
@@ -216,126 +679,55 @@ namespace easy3d {
                     return;
                 }
 
-                if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
-                    const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
-                    float min_value = std::numeric_limits<float>::max();
-                    float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
-
-                    std::vector<vec3> d_points, d_normals;
-                    std::vector<vec2> d_texcoords;
-                    d_points.reserve(model->n_faces() * 3);
-                    d_normals.reserve(model->n_faces() * 3);
-                    d_texcoords.reserve(model->n_faces() * 3);
-                    for (auto face : model->faces()) {
-                        const float coord = (prop[face] - min_value) / (max_value - min_value);
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            d_points.emplace_back(points[v]);
-                            d_normals.emplace_back(normals[v]);
-                            d_texcoords.emplace_back(vec2(coord, 0.5f));
-                        }
-                    }
-
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_normal_buffer(d_normals);
-                    drawable->update_texcoord_buffer(d_texcoords);
-                    drawable->disable_element_buffer();
-
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int idx = 0;
-                    for (auto face : model->faces()) {
-                        triangle_range[face] = std::make_pair(idx, idx);
-                        ++idx;
-                    }
-                } else {
-
-                    /**
-                     * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
-                     * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
-                     * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
-                     * for the rendering purpose be shared for selection. Yeah, performance gain!
-                     */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
-
-                    /**
-                     * Efficiency in switching between flat and smooth shading.
-                     * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
-                     * the fragment shader:
-                     *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
-                     *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
-                     *              normal = -normal;
-                     * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
-                     * between flat and smooth shading without transferring different data to the GPU.
-                     */
-
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
-                    const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
-                    float min_value = std::numeric_limits<float>::max();
-                    float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
-
-                    std::vector<vec3> d_points, d_normals;
-                    std::vector<vec2> d_texcoords;
-
-                    /**
-                     * Tessellator can actually eliminate duplicate vertices, but I want to updated only the texcoord
-                     * buffer outside (using the "f:triangle_range"). This will be easier if each triangle has
-                     * exact 3 txcoords, that is why the "tessellator.reset()"
-                     */
-                    Tessellator tessellator;
-                    for (auto face : model->faces()) {
-                        tessellator.reset();
-
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        float coord = (prop[face] - min_value) / (max_value - min_value);
+                /**
+                 * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
+                 * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
+                 * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
+                 * for the rendering purpose be shared for selection. Yeah, performance gain!
+                 */
 
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-                            vertex.append(vec2(coord, 0.5f));
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
+                /**
+                 * Efficiency in switching between flat and smooth shading.
+                 * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
+                 * the fragment shader:
+                 *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
+                 *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
+                 *              normal = -normal;
+                 * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
+                 * between flat and smooth shading without transferring different data to the GPU.
+                 */
+                auto points = model->get_vertex_property<vec3>("v:point");
+                model->update_vertex_normals();
+                auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-
-                        const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                        const auto& indices = tessellator.elements();
-                        for (const auto& tri : indices) {
-                            for (unsigned char i=0; i<3; ++i) {
-                                Tessellator::Vertex *v = vts[tri[i]];
-                                d_points.emplace_back(v->data());
-                                d_normals.emplace_back(v->data() + 3);
-                                d_texcoords.emplace_back(v->data() + 6);
-                            }
-                        }
-                    }
+                const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
+                const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
+                float min_value = std::numeric_limits<float>::max();
+                float max_value = -std::numeric_limits<float>::max();
+                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
 
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_normal_buffer(d_normals);
-                    drawable->update_texcoord_buffer(d_texcoords);
-                    drawable->disable_element_buffer();
+                /**
+                 * Each triangle has exact 3 texcoords (i.e., no element buffer), so the texcoord buffer can be updated
+                 * outside for individual faces (using the "f:triangle_range").
+                 */
+                std::vector<SurfaceMesh::Halfedge> corners;
+                details::triangulate(model, corners);
+
+                const int num = static_cast<int>(corners.size());
+                std::vector<vec3> d_points(num), d_normals(num);
+                std::vector<vec2> d_texcoords(num);
+                parallel_for(0, num, [&](int i) {
+                    const auto v = model->target(corners[i]);
+                    const float coord = (prop[model->face(corners[i])] - min_value) / (max_value - min_value);
+                    d_points[i] = points[v];
+                    d_normals[i] = normals[v];
+                    d_texcoords[i] = vec2(coord, 0.5f);
+                });
 
-                    DLOG(INFO) << "num of vertices in model/sent to GPU: " << model->n_vertices() << "/"
-                               << d_points.size();
-                }
+                drawable->update_vertex_buffer(d_points);
+                drawable->update_normal_buffer(d_normals);
+                drawable->update_texcoord_buffer(d_texcoords);
+                drawable->disable_element_buffer();
             }
 
 
@@ -351,125 +743,47 @@ namespace easy3d {
                     return;
                 }
 
-                if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
-                    const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
-                    float min_value = std::numeric_limits<float>::max();
-                    float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
-
-                    std::vector<vec2> d_texcoords;
-                    d_texcoords.reserve(model->n_vertices());
-                    for (auto v : model->vertices()) {
-                        const float coord = (prop[v] - min_value) / (max_value - min_value);
-                        d_texcoords.emplace_back(vec2(coord, 0.5f));
-                    }
-
-                    std::vector<unsigned int> d_indices;
-                    d_indices.reserve(model->n_faces() * 3);
-                    for (auto f : model->faces()) {
-                        for (auto h : model->halfedges(f))
-                            d_indices.push_back(model->target(h).idx());
-                    }
-
-                    drawable->update_vertex_buffer(points.vector());
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(normals.vector());
-                    drawable->update_texcoord_buffer(d_texcoords);
-
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int idx = 0;
-                    for (auto face : model->faces()) {
-                        triangle_range[face] = std::make_pair(idx, idx);
-                        ++idx;
-                    }
-                } else {
-                    /**
-                     * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
-                     * buffer to minimize the number of vertices sent to the GPU.
-                     */
-                    Tessellator tessellator;
-
-                    /**
-                     * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
-                     * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
-                     * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
-                     * for the rendering purpose be shared for selection. Yeah, performance gain!
-                     */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
-
-                    /**
-                     * Efficiency in switching between flat and smooth shading.
-                     * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
-                     * the fragment shader:
-                     *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
-                     *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
-                     *              normal = -normal;
-                     * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
-                     * between flat and smooth shading without transferring different data to the GPU.
-                     */
-
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
-                    const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
-                    float min_value = std::numeric_limits<float>::max();
-                    float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
-
-                    for (auto face : model->faces()) {
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-
-                            float coord = (prop[v] - min_value) / (max_value - min_value);
-                            vertex.append(vec2(coord, 0.5f));
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
+                /**
+                 * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
+                 * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
+                 * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
+                 * for the rendering purpose be shared for selection. Yeah, performance gain!
+                 */
 
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-                    }
+                /**
+                 * Efficiency in switching between flat and smooth shading.
+                 * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
+                 * the fragment shader:
+                 *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
+                 *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
+                 *              normal = -normal;
+                 * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
+                 * between flat and smooth shading without transferring different data to the GPU.
+                 */
+                auto points = model->get_vertex_property<vec3>("v:point");
+                model->update_vertex_normals();
+                auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                    std::vector<vec3> d_points, d_normals;
-                    std::vector<vec2> d_texcoords;
-                    d_points.reserve(vts.size());
-                    d_normals.reserve(vts.size());
-                    d_texcoords.reserve(vts.size());
-                    for (auto v :vts) {
-                        std::size_t offset = 0;
-                        d_points.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_normals.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_texcoords.emplace_back(v->data() + offset);
-                    }
+                const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
+                const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
+                float min_value = std::numeric_limits<float>::max();
+                float max_value = -std::numeric_limits<float>::max();
+                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
 
-                    const auto &d_indices = tessellator.elements();
+                const int num = static_cast<int>(model->vertices_size());
+                std::vector<vec2> d_texcoords(num);
+                parallel_for(0, num, [&](int i) {
+                    const float coord = (prop[SurfaceMesh::Vertex(i)] - min_value) / (max_value - min_value);
+                    d_texcoords[i] = vec2(coord, 0.5f);
+                });
 
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(d_normals);
-                    drawable->update_texcoord_buffer(d_texcoords);
+                std::vector<SurfaceMesh::Halfedge> corners;
+                details::triangulate(model, corners);
 
-                    DLOG(INFO) << "num of vertices in model/sent to GPU: " << model->n_vertices() << "/"
-                               << d_points.size();
-                }
+                drawable->update_vertex_buffer(points.vector());
+                drawable->update_element_buffer(details::element_indices(model, drawable, corners));
+                drawable->update_normal_buffer(normals.vector());
+                drawable->update_texcoord_buffer(d_texcoords);
             }
 
 
@@ -879,8 +1193,8 @@ namespace easy3d {
             }
 
 
-            template<typename Mesh>
-            void update_colors_on_vertices(Mesh *model, PointsDrawable *drawable, typename Mesh::template VertexProperty<vec3> prop) {
+            template<typename Mesh, typename CT>
+            void update_colors_on_vertices(Mesh *model, PointsDrawable *drawable, typename Mesh::template VertexProperty<CT> prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -892,11 +1206,9 @@ namespace easy3d {
 
                 auto points = model->template get_vertex_property<vec3>("v:point");
                 drawable->update_vertex_buffer(points.vector());
-                drawable->update_color_buffer(prop.vector());
+                drawable->update_color_buffer(details::to_float_colors(prop.vector()));
 
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
-                if (normals)
-                    drawable->update_normal_buffer(normals.vector());
+                details::update_vertex_normals(model, drawable);
             }
 
 
@@ -915,9 +1227,7 @@ namespace easy3d {
                 drawable->update_vertex_buffer(points.vector());
                 drawable->update_texcoord_buffer(prop.vector());
 
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
-                if (normals)
-                    drawable->update_normal_buffer(normals.vector());
+                details::update_vertex_normals(model, drawable);
             }
 
 
@@ -925,227 +1235,47 @@ namespace easy3d {
                 assert(model);
                 assert(drawable);
 
-                if (model->empty()) {
-                    LOG(WARNING) << "model has no valid geometry";
-                    return;
-                }
-
-                if (model->is_triangle_mesh()) {
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    std::vector<unsigned int> d_indices;
-                    d_indices.reserve(model->n_faces() * 3);
-                    for (auto face : model->faces()) {
-                        for (auto h : model->halfedges(face))
-                            d_indices.push_back(model->target(h).idx());
-                    }
-                    drawable->update_vertex_buffer(model->points());
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(normals.vector());
-
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int idx = 0;
-                    for (auto face : model->faces()) {
-                        triangle_range[face] = std::make_pair(idx, idx);
-                        ++idx;
-                    }
-                } else {
-                    /**
-                     * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
-                     * buffer to minimize the number of vertices sent to the GPU.
-                     */
-                    Tessellator tessellator;
-
-                    /**
-                     * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
-                     * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
-                     * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
-                     * for the rendering purpose be shared for selection. Yeah, performance gain!
-                     */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
-
-                    /**
-                     * Efficiency in switching between flat and smooth shading.
-                     * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
-                     * the fragment shader:
-                     *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
-                     *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
-                     *              normal = -normal;
-                     * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
-                     * between flat and smooth shading without transferring different data to the GPU.
-                     */
-
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    for (auto face : model->faces()) {
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        // tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
-
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-                    }
-
-                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                    std::vector<vec3> d_points, d_normals;
-                    d_points.reserve(vts.size());
-                    d_normals.reserve(vts.size());
-                    for (auto v :vts) {
-                        std::size_t offset = 0;
-                        d_points.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_normals.emplace_back(v->data() + offset);
-                    }
-
-                    const auto &d_indices = tessellator.elements();
-
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(d_normals);
-
-                    DLOG(INFO) << "num of vertices in model/sent to GPU: " << model->n_vertices() << "/"
-                               << d_points.size();
-                }
-            }
-
-            // with a per-face color
-            void update_colors_on_faces(SurfaceMesh *model, TrianglesDrawable *drawable,
-                        SurfaceMesh::FaceProperty<vec3> fcolor) {
-                assert(model);
-                assert(drawable);
-                assert(fcolor);
-
-                if (model->empty()) {
-                    LOG(WARNING) << "model has no valid geometry";
-                    return;
-                }
-
-                if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    std::vector<vec3> d_points, d_normals, d_colors;
-                    d_points.reserve(model->n_faces() * 3);
-                    d_normals.reserve(model->n_faces() * 3);
-                    d_colors.reserve(model->n_faces() * 3);
-
-                    for (auto f : model->faces()) {
-                        const vec3 &color = fcolor[f];
-                        for (auto v : model->vertices(f)) {
-                            d_points.push_back(points[v]);
-                            d_normals.push_back(normals[v]);
-                            d_colors.push_back(color);
-                        }
-                    }
-
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_normal_buffer(d_normals);
-                    drawable->update_color_buffer(d_colors);
-                    drawable->disable_element_buffer();
-
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int idx = 0;
-                    for (auto face : model->faces()) {
-                        triangle_range[face] = std::make_pair(idx, idx);
-                        ++idx;
-                    }
-                } else {
-                    /**
-                     * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
-                     * buffer to minimize the number of vertices sent to the GPU.
-                     */
-                    Tessellator tessellator;
-
-                    /**
-                     * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
-                     * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
-                     * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
-                     * for the rendering purpose be shared for selection. Yeah, performance gain!
-                     */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
-
-                    /**
-                     * Efficiency in switching between flat and smooth shading.
-                     * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
-                     * the fragment shader:
-                     *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
-                     *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
-                     *              normal = -normal;
-                     * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
-                     * between flat and smooth shading without transferring different data to the GPU.
-                     */
-
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    for (auto face : model->faces()) {
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        // tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        const vec3 &color = fcolor[face];
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-                            vertex.append(color);
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
-
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-                    }
-
-                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                    std::vector<vec3> d_points, d_normals, d_colors;
-                    d_points.reserve(vts.size());
-                    d_normals.reserve(vts.size());
-                    d_colors.reserve(vts.size());
-
-                    for (auto v :vts) {
-                        std::size_t offset = 0;
-                        d_points.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_normals.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_colors.emplace_back(v->data() + offset);
-                    }
+                if (model->empty()) {
+                    LOG(WARNING) << "model has no valid geometry";
+                    return;
+                }
 
-                    const auto &d_indices = tessellator.elements();
+                /**
+                 * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
+                 * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
+                 * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
+                 * for the rendering purpose be shared for selection. Yeah, performance gain!
+                 */
 
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(d_normals);
-                    drawable->update_color_buffer(d_colors);
+                /**
+                 * Efficiency in switching between flat and smooth shading.
+                 * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
+                 * the fragment shader:
+                 *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
+                 *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
+                 *              normal = -normal;
+                 * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
+                 * between flat and smooth shading without transferring different data to the GPU.
+                 */
+                auto points = model->get_vertex_property<vec3>("v:point");
+                model->update_vertex_normals();
+                auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    DLOG(INFO) << "num of vertices in model/sent to GPU: " << model->n_vertices() << "/"
-                               << d_points.size();
-                }
-            }
+                std::vector<SurfaceMesh::Halfedge> corners;
+                details::triangulate(model, corners);
 
+                drawable->update_vertex_buffer(points.vector());
+                drawable->update_element_buffer(details::element_indices(model, drawable, corners));
+                drawable->update_normal_buffer(normals.vector());
+            }
 
-            void update_colors_on_vertices(SurfaceMesh *model, TrianglesDrawable *drawable, SurfaceMesh::VertexProperty<vec3> vcolor) {
+            // with a per-face color
+            template<typename CT>
+            void update_colors_on_faces(SurfaceMesh *model, TrianglesDrawable *drawable,
+                        SurfaceMesh::FaceProperty<CT> fcolor) {
                 assert(model);
                 assert(drawable);
-                assert(vcolor);
+                assert(fcolor);
 
                 if (model->empty()) {
                     LOG(WARNING) << "model has no valid geometry";
@@ -1157,17 +1287,24 @@ namespace easy3d {
                     model->update_vertex_normals();
                     auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    std::vector<unsigned int> d_indices;
-                    d_indices.reserve(model->n_faces() * 3);
+                    std::vector<vec3> d_points, d_normals, d_colors;
+                    d_points.reserve(model->n_faces() * 3);
+                    d_normals.reserve(model->n_faces() * 3);
+                    d_colors.reserve(model->n_faces() * 3);
+
                     for (auto f : model->faces()) {
-                        for (auto h : model->halfedges(f))
-                            d_indices.push_back(model->target(h).idx());
+                        const vec3 &color = details::to_float_color(fcolor[f]);
+                        for (auto v : model->vertices(f)) {
+                            d_points.push_back(points[v]);
+                            d_normals.push_back(normals[v]);
+                            d_colors.push_back(color);
+                        }
                     }
 
-                    drawable->update_vertex_buffer(points.vector());
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(normals.vector());
-                    drawable->update_color_buffer(vcolor.vector());
+                    drawable->update_vertex_buffer(d_points);
+                    drawable->update_normal_buffer(d_normals);
+                    drawable->update_color_buffer(d_colors);
+                    drawable->disable_element_buffer();
 
                     auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
                     int idx = 0;
@@ -1176,20 +1313,12 @@ namespace easy3d {
                         ++idx;
                     }
                 } else {
-                    /**
-                     * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
-                     * buffer to minimize the number of vertices sent to the GPU.
-                     */
-                    Tessellator tessellator;
-
                     /**
                      * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
                      * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
                      * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
                      * for the rendering purpose be shared for selection. Yeah, performance gain!
                      */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
 
                     /**
                      * Efficiency in switching between flat and smooth shading.
@@ -1205,42 +1334,30 @@ namespace easy3d {
                     model->update_vertex_normals();
                     auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    for (auto face : model->faces()) {
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        // tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-                            vertex.append(vcolor[v]);
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
-
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-                    }
-
-                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                    std::vector<vec3> d_points, d_normals, d_colors;
-                    d_points.reserve(vts.size());
-                    d_normals.reserve(vts.size());
-                    d_colors.reserve(vts.size());
-
-                    for (auto v :vts) {
-                        std::size_t offset = 0;
-                        d_points.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_normals.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_colors.emplace_back(v->data() + offset);
-                    }
+                    std::vector<SurfaceMesh::Halfedge> corners;
+                    details::triangulate(model, corners);
 
-                    const auto &d_indices = tessellator.elements();
+                    const int num = static_cast<int>(corners.size());
+                    std::vector<vec3> colors(num);
+                    parallel_for(0, num, [&](int i) {
+                        colors[i] = details::to_float_color(fcolor[model->face(corners[i])]);
+                    });
 
+                    // eliminate duplicate vertices (i.e., the same vertex with the same color). This allows us to take
+                    // advantage of element buffer to minimize the number of vertices sent to the GPU.
+                    std::vector<unsigned int> d_indices;
+                    std::vector<SurfaceMesh::Vertex> vertices;
+                    std::vector<vec3> d_colors;
+                    details::unique_corners(model, corners, colors, d_indices, vertices, d_colors);
+
+                    const int num_vertices = static_cast<int>(vertices.size());
+                    std::vector<vec3> d_points(num_vertices), d_normals(num_vertices);
+                    parallel_for(0, num_vertices, [&](int i) {
+                        d_points[i] = points[vertices[i]];
+                        d_normals[i] = normals[vertices[i]];
+                    });
+
+                    details::organize_triangles(model, drawable, d_indices, d_points);
                     drawable->update_vertex_buffer(d_points);
                     drawable->update_element_buffer(d_indices);
                     drawable->update_normal_buffer(d_normals);
@@ -1252,116 +1369,87 @@ namespace easy3d {
             }
 
 
-            void update_texcoords_on_vertices(SurfaceMesh *model, TrianglesDrawable *drawable,
-                        SurfaceMesh::VertexProperty<vec2> vtexcoords) {
+            template<typename CT>
+            void update_colors_on_vertices(SurfaceMesh *model, TrianglesDrawable *drawable, SurfaceMesh::VertexProperty<CT> vcolor) {
                 assert(model);
                 assert(drawable);
-                assert(vtexcoords);
+                assert(vcolor);
 
                 if (model->empty()) {
                     LOG(WARNING) << "model has no valid geometry";
                     return;
                 }
 
-                if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
-
-                    std::vector<unsigned int> d_indices;
-                    d_indices.reserve(model->n_faces() * 3);
-                    for (auto f : model->faces()) {
-                        for (auto h : model->halfedges(f))
-                            d_indices.push_back(model->target(h).idx());
-                    }
-
-                    drawable->update_vertex_buffer(points.vector());
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(normals.vector());
-                    drawable->update_texcoord_buffer(vtexcoords.vector());
-
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int idx = 0;
-                    for (auto face : model->faces()) {
-                        triangle_range[face] = std::make_pair(idx, idx);
-                        ++idx;
-                    }
-                } else {
-                    /**
-                     * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
-                     * buffer to minimize the number of vertices sent to the GPU.
-                     */
-                    Tessellator tessellator;
+                /**
+                 * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
+                 * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
+                 * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
+                 * for the rendering purpose be shared for selection. Yeah, performance gain!
+                 */
 
-                    /**
-                     * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
-                     * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
-                     * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
-                     * for the rendering purpose be shared for selection. Yeah, performance gain!
-                     */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
+                /**
+                 * Efficiency in switching between flat and smooth shading.
+                 * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
+                 * the fragment shader:
+                 *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
+                 *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
+                 *              normal = -normal;
+                 * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
+                 * between flat and smooth shading without transferring different data to the GPU.
+                 */
+                auto points = model->get_vertex_property<vec3>("v:point");
+                model->update_vertex_normals();
+                auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    /**
-                     * Efficiency in switching between flat and smooth shading.
-                     * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
-                     * the fragment shader:
-                     *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
-                     *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
-                     *              normal = -normal;
-                     * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
-                     * between flat and smooth shading without transferring different data to the GPU.
-                     */
+                std::vector<SurfaceMesh::Halfedge> corners;
+                details::triangulate(model, corners);
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                drawable->update_vertex_buffer(points.vector());
+                drawable->update_element_buffer(details::element_indices(model, drawable, corners));
+                drawable->update_normal_buffer(normals.vector());
+                drawable->update_color_buffer(details::to_float_colors(vcolor.vector()));
+            }
 
-                    for (auto face : model->faces()) {
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        // tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-                            vertex.append(vtexcoords[v]);
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
 
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-                    }
+            void update_texcoords_on_vertices(SurfaceMesh *model, TrianglesDrawable *drawable,
+                        SurfaceMesh::VertexProperty<vec2> vtexcoords) {
+                assert(model);
+                assert(drawable);
+                assert(vtexcoords);
 
-                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                    std::vector<vec3> d_points, d_normals;
-                    std::vector<vec2> d_texcoords;
-                    d_points.reserve(vts.size());
-                    d_normals.reserve(vts.size());
-                    d_texcoords.reserve(vts.size());
+                if (model->empty()) {
+                    LOG(WARNING) << "model has no valid geometry";
+                    return;
+                }
 
-                    for (auto v :vts) {
-                        std::size_t offset = 0;
-                        d_points.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_normals.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_texcoords.emplace_back(v->data() + offset);
-                    }
+                /**
+                 * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
+                 * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
+                 * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
+                 * for the rendering purpose be shared for selection. Yeah, performance gain!
+                 */
 
-                    const auto &d_indices = tessellator.elements();
+                /**
+                 * Efficiency in switching between flat and smooth shading.
+                 * Easy3d always transfer vertex normals to GPU and the normals for flat shading are computed on the fly in
+                 * the fragment shader:
+                 *          normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
+                 *          if ((gl_FrontFacing == false) && (two_sides_lighting == false))
+                 *              normal = -normal;
+                 * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
+                 * between flat and smooth shading without transferring different data to the GPU.
+                 */
+                auto points = model->get_vertex_property<vec3>("v:point");
+                model->update_vertex_normals();
+                auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    drawable->update_vertex_buffer(d_points);
-                    drawable->update_element_buffer(d_indices);
-                    drawable->update_normal_buffer(d_normals);
-                    drawable->update_texcoord_buffer(d_texcoords);
+                std::vector<SurfaceMesh::Halfedge> corners;
+                details::triangulate(model, corners);
 
-                    DLOG(INFO) << "num of vertices in model/sent to GPU: " << model->n_vertices() << "/"
-                               << d_points.size();
-                }
+                drawable->update_vertex_buffer(points.vector());
+                drawable->update_element_buffer(details::element_indices(model, drawable, corners));
+                drawable->update_normal_buffer(normals.vector());
+                drawable->update_texcoord_buffer(vtexcoords.vector());
             }
 
 
@@ -1407,20 +1495,12 @@ namespace easy3d {
                         ++idx;
                     }
                 } else {
-                    /**
-                     * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
-                     * buffer to minimize the number of vertices sent to the GPU.
-                     */
-                    Tessellator tessellator;
-
                     /**
                      * For non-triangular surface meshes, all polygonal faces are internally triangulated to allow a unified
                      * rendering APIs. Thus for performance reasons, the selection of polygonal faces is also internally
                      * implemented by selecting triangle primitives using shaders. This allows data uploaded to the GPU
                      * for the rendering purpose be shared for selection. Yeah, performance gain!
                      */
-                    auto triangle_range = model->face_property<std::pair<int, int> >("f:triangle_range");
-                    int count_triangles = 0;
 
                     /**
                      * Efficiency in switching between flat and smooth shading.
@@ -1432,48 +1512,34 @@ namespace easy3d {
                      * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
-
                     auto points = model->get_vertex_property<vec3>("v:point");
                     model->update_vertex_normals();
                     auto normals = model->get_vertex_property<vec3>("v:normal");
 
-                    for (auto face : model->faces()) {
-                        tessellator.begin_polygon(model->compute_face_normal(face));
-                        // tessellator.set_winding_rule(Tessellator::WINDING_NONZERO);  // or POSITIVE
-                        tessellator.begin_contour();
-                        for (auto h : model->halfedges(face)) {
-                            auto v = model->target(h);
-                            Tessellator::Vertex vertex(points[v], v.idx());
-                            vertex.append(normals[v]);
-                            vertex.append(htexcoords[h]);
-                            tessellator.add_vertex(vertex);
-                        }
-                        tessellator.end_contour();
-                        tessellator.end_polygon();
+                    std::vector<SurfaceMesh::Halfedge> corners;
+                    details::triangulate(model, corners);
 
-                        std::size_t num = tessellator.num_elements_in_polygon();
-                        triangle_range[face] = std::make_pair(count_triangles, count_triangles + num - 1);
-                        count_triangles += num;
-                    }
+                    const int num = static_cast<int>(corners.size());
+                    std::vector<vec2> texcoords(num);
+                    parallel_for(0, num, [&](int i) {
+                        texcoords[i] = htexcoords[corners[i]];
+                    });
 
-                    const std::vector<Tessellator::Vertex *> &vts = tessellator.vertices();
-                    std::vector<vec3> d_points, d_normals;
+                    // eliminate duplicate vertices (i.e., the same vertex with the same texture coordinates). This allows
+                    // us to take advantage of element buffer to minimize the number of vertices sent to the GPU.
+                    std::vector<unsigned int> d_indices;
+                    std::vector<SurfaceMesh::Vertex> vertices;
                     std::vector<vec2> d_texcoords;
-                    d_points.reserve(vts.size());
-                    d_normals.reserve(vts.size());
-                    d_texcoords.reserve(vts.size());
-
-                    for (auto v :vts) {
-                        std::size_t offset = 0;
-                        d_points.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_normals.emplace_back(v->data() + offset);
-                        offset += 3;
-                        d_texcoords.emplace_back(v->data() + offset);
-                    }
+                    details::unique_corners(model, corners, texcoords, d_indices, vertices, d_texcoords);
 
-                    const auto &d_indices = tessellator.elements();
+                    const int num_vertices = static_cast<int>(vertices.size());
+                    std::vector<vec3> d_points(num_vertices), d_normals(num_vertices);
+                    parallel_for(0, num_vertices, [&](int i) {
+                        d_points[i] = points[vertices[i]];
+                        d_normals[i] = normals[vertices[i]];
+                    });
 
+                    details::organize_triangles(model, drawable, d_indices, d_points);
                     drawable->update_vertex_buffer(d_points);
                     drawable->update_element_buffer(d_indices);
                     drawable->update_normal_buffer(d_normals);
@@ -1485,8 +1551,8 @@ namespace easy3d {
             }
 
 
-            template <typename MODEL>
-            void update_colors_on_edges(MODEL *model, LinesDrawable *drawable, typename MODEL::template EdgeProperty<vec3> prop) {
+            template <typename MODEL, typename CT>
+            void update_colors_on_edges(MODEL *model, LinesDrawable *drawable, typename MODEL::template EdgeProperty<CT> prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -1505,8 +1571,9 @@ namespace easy3d {
                     auto t = model->vertex(e, 1);
                     d_points.push_back(points[s]);
                     d_points.push_back(points[t]);
-                    d_colors.push_back(prop[e]);
-                    d_colors.push_back(prop[e]);
+                    const vec3 &color = details::to_float_color(prop[e]);
+                    d_colors.push_back(color);
+                    d_colors.push_back(color);
                 }
                 drawable->update_vertex_buffer(d_points);
                 drawable->update_color_buffer(d_colors);
@@ -1514,9 +1581,9 @@ namespace easy3d {
             }
 
 
-            template <typename MODEL>
+            template <typename MODEL, typename CT>
             void
-            update_colors_on_vertices(MODEL *model, LinesDrawable *drawable, typename MODEL::template VertexProperty<vec3> prop) {
+            update_colors_on_vertices(MODEL *model, LinesDrawable *drawable, typename MODEL::template VertexProperty<CT> prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -1535,8 +1602,8 @@ namespace easy3d {
                     auto t = model->vertex(e, 1);
                     d_points.push_back(points[s]);
                     d_points.push_back(points[t]);
-                    d_colors.push_back(prop[s]);
-                    d_colors.push_back(prop[t]);
+                    d_colors.push_back(details::to_float_color(prop[s]));
+                    d_colors.push_back(details::to_float_color(prop[t]));
                 }
                 drawable->update_vertex_buffer(d_points);
                 drawable->update_color_buffer(d_colors);
@@ -1651,9 +1718,7 @@ namespace easy3d {
             void update_uniform_colors(MODEL *model, PointsDrawable *drawable) {
                 auto points = model->template get_vertex_property<vec3>("v:point");
                 drawable->update_vertex_buffer(points.vector());
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
-                if (normals)
-                    drawable->update_normal_buffer(normals.vector());
+                details::update_vertex_normals(model, drawable);
             }
 
 
@@ -1676,8 +1741,11 @@ namespace easy3d {
             template<typename MODEL>
             void update_colors_on_vertices(MODEL *model, PointsDrawable *drawable, const std::string& name) {
                 auto colors = model->template get_vertex_property<vec3>(name);
+                auto narrowed_colors = model->template get_vertex_property<u8vec3>(name);
                 if (colors)
-                    details::update_colors_on_vertices<MODEL>(model, drawable, colors);
+                    details::update_colors_on_vertices<MODEL, vec3>(model, drawable, colors);
+                else if (narrowed_colors)
+                    details::update_colors_on_vertices<MODEL, u8vec3>(model, drawable, narrowed_colors);
                 else {
                     LOG(WARNING) << "color property \'" << name
                                  << "\' not found on vertices (use uniform coloring)";
@@ -1690,8 +1758,11 @@ namespace easy3d {
             template<typename MODEL>
             void update_colors_on_vertices(MODEL *model, LinesDrawable *drawable, const std::string& name) {
                 auto colors = model->template get_vertex_property<vec3>(name);
+                auto narrowed_colors = model->template get_vertex_property<u8vec3>(name);
                 if (colors)
-                    details::update_colors_on_vertices(model, drawable, colors);
+                    details::update_colors_on_vertices<MODEL, vec3>(model, drawable, colors);
+                else if (narrowed_colors)
+                    details::update_colors_on_vertices<MODEL, u8vec3>(model, drawable, narrowed_colors);
                 else {
                     LOG(WARNING) << "color property \'" << name
                                  << "\' not found on vertices (use uniform coloring)";
@@ -1704,8 +1775,11 @@ namespace easy3d {
             template<typename MODEL>
             void update_colors_on_edges(MODEL *model, LinesDrawable *drawable, const std::string& name) {
                 auto colors = model->template get_edge_property<vec3>(name);
+                auto narrowed_colors = model->template get_edge_property<u8vec3>(name);
                 if (colors)
-                    details::update_colors_on_edges(model, drawable, colors);
+                    details::update_colors_on_edges<MODEL, vec3>(model, drawable, colors);
+                else if (narrowed_colors)
+                    details::update_colors_on_edges<MODEL, u8vec3>(model, drawable, narrowed_colors);
                 else {
                     LOG(WARNING) << "color property \'" << name
                                  << "\' not found on edges (use uniform coloring)";
@@ -1772,6 +1846,9 @@ namespace easy3d {
                 } else if (model->template get_vertex_property<unsigned int>(name)) {
                     auto prop = model->template get_vertex_property<unsigned int>(name);
                     details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
+                } else if (model->template get_vertex_property<unsigned short>(name)) {
+                    auto prop = model->template get_vertex_property<unsigned short>(name);
+                    details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
                 } else if (model->template get_vertex_property<char>(name)) {
                     auto prop = model->template get_vertex_property<char>(name);
                     details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
@@ -1805,6 +1882,9 @@ namespace easy3d {
                 } else if (model->template get_edge_property<unsigned int>(name)) {
                     auto prop = model->template get_edge_property<unsigned int>(name);
                     details::update_scalar_on_edges<MODEL>(model, drawable, prop);
+                } else if (model->template get_edge_property<unsigned short>(name)) {
+                    auto prop = model->template get_edge_property<unsigned short>(name);
+                    details::update_scalar_on_edges<MODEL>(model, drawable, prop);
                 } else if (model->template get_edge_property<char>(name)) {
                     auto prop = model->template get_edge_property<char>(name);
                     details::update_scalar_on_edges<MODEL>(model, drawable, prop);
@@ -1825,6 +1905,8 @@ namespace easy3d {
 
             template <typename MODEL>
             void update(MODEL *model, LinesDrawable *drawable) {
+                EASY3D_PROFILE_ZONE("buffers::update (lines)");
+                EASY3D_PROFILE_ELEMENTS(model->n_vertices());
                 assert(model);
                 assert(drawable);
 
@@ -1896,6 +1978,8 @@ namespace easy3d {
 
             template <typename MODEL>
             void update(MODEL *model, PointsDrawable *drawable) {
+                EASY3D_PROFILE_ZONE("buffers::update (points)");
+                EASY3D_PROFILE_ELEMENTS(model->n_vertices());
                 assert(model);
                 assert(drawable);
 
@@ -1922,6 +2006,117 @@ namespace easy3d {
                         details::update_uniform_colors<MODEL>(model, drawable);
                         break;
                 }
+
+                auto points = model->template get_vertex_property<vec3>("v:point");
+                details::build_point_chunks(drawable, points.vector());
+            }
+
+
+            // uploads the modified ranges of a vertex attribute stored in a type (e.g., u8vec3 colors or hvec3 normals)
+            // that has to be converted (to FT) before being sent to the GPU.
+            template<typename FT, typename T, typename FUNC>
+            inline bool update_converted_ranges(Drawable *drawable, unsigned int buffer, const std::vector<T> &data,
+                                                const DirtyRanges &ranges, FUNC convert) {
+                if (buffer == 0 || data.size() != drawable->num_vertices())
+                    return false;
+
+                DirtyRanges clipped = ranges;
+                clipped.clip(data.size());
+                clipped.coalesce();
+                std::vector<FT> values;
+                for (const auto &r : clipped.ranges()) {
+                    values.resize(r.second - r.first);
+                    for (std::size_t i = r.first; i < r.second; ++i)
+                        values[i - r.first] = convert(data[i]);
+                    if (!drawable->update_buffer_range(buffer, r.first, values.size(), values.data()))
+                        return false;
+                }
+                return true;
+            }
+
+
+            // recomputes the normals of the vertices around the modified vertices of a surface mesh. The vertices
+            // whose normals changed are recorded in 'changed'.
+            inline void update_modified_normals(SurfaceMesh *model, const DirtyRanges &points, DirtyRanges &changed) {
+                auto normals = model->get_vertex_property<vec3>("v:normal");
+                if (!normals || points.all()) {
+                    model->update_vertex_normals();
+                    changed.add_all();
+                    return;
+                }
+
+                // the normal of a vertex depends on the positions of its one-ring neighbors
+                std::vector<int> affected;
+                for (const auto &r : points.ranges()) {
+                    for (std::size_t i = r.first; i < std::min<std::size_t>(r.second, model->vertices_size()); ++i) {
+                        SurfaceMesh::Vertex v(static_cast<int>(i));
+                        if (model->is_deleted(v))
+                            continue;
+                        affected.push_back(v.idx());
+                        for (auto w : model->vertices(v))
+                            affected.push_back(w.idx());
+                    }
+                }
+                std::sort(affected.begin(), affected.end());
+                affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+                const int num = static_cast<int>(affected.size());
+                parallel_for(0, num, [&](int i) {
+                    SurfaceMesh::Vertex v(affected[i]);
+                    normals[v] = model->compute_vertex_normal(v);
+                });
+
+                for (auto idx : affected)   // sorted, so each range is appended at the end
+                    changed.add(static_cast<std::size_t>(idx));
+            }
+
+
+            // uploads the modified ranges of the per-vertex buffers of a drawable, whose buffers store the vertex
+            // attributes in the order of the model's vertices.
+            template<typename MODEL>
+            bool update_modified_vertices(MODEL *model, Drawable *drawable,
+                                          const std::map<std::string, DirtyRanges> &modified) {
+                const std::string &name = drawable->property_name();
+                for (const auto &entry : modified) {
+                    const std::string &property = entry.first;
+                    const DirtyRanges &ranges = entry.second;
+                    if (property == "v:point")
+                        drawable->update_vertex_buffer(model->points(), ranges);
+                    else if (property == "v:normal" || property == "v:normal_h") {
+                        if (drawable->type() == Drawable::DT_LINES)
+                            continue;
+                        // the full-precision normals are used if both exist
+                        auto normals = model->template get_vertex_property<vec3>("v:normal");
+                        auto half_normals = model->template get_vertex_property<hvec3>("v:normal_h");
+                        if (normals)
+                            drawable->update_normal_buffer(normals.vector(), ranges);
+                        else if (half_normals) {
+                            auto convert = [](const hvec3 &n) -> vec3 { return half::unpack(n); };
+                            if (!update_converted_ranges<vec3>(drawable, drawable->normal_buffer(),
+                                                               half_normals.vector(), ranges, convert))
+                                return false;
+                        }
+                    } else if (property == name && drawable->coloring_method() == State::COLOR_PROPERTY) {
+                        auto colors = model->template get_vertex_property<vec3>(property);
+                        auto narrowed_colors = model->template get_vertex_property<u8vec3>(property);
+                        if (colors)
+                            drawable->update_color_buffer(colors.vector(), ranges);
+                        else if (narrowed_colors) {
+                            auto convert = [](const u8vec3 &c) -> vec3 { return to_float_color(c); };
+                            if (!update_converted_ranges<vec3>(drawable, drawable->color_buffer(),
+                                                               narrowed_colors.vector(), ranges, convert))
+                                return false;
+                        } else
+                            return false;
+                    } else if (property == name && drawable->coloring_method() == State::TEXTURED) {
+                        auto texcoords = model->template get_vertex_property<vec2>(property);
+                        if (!texcoords)
+                            return false;
+                        drawable->update_texcoord_buffer(texcoords.vector(), ranges);
+                    }
+                    // other properties are not shown by this drawable
+                }
+                return true;
             }
 
 
@@ -2083,6 +2278,8 @@ namespace easy3d {
 
 
         void update(SurfaceMesh *model, TrianglesDrawable *drawable) {
+            EASY3D_PROFILE_ZONE("buffers::update (surface mesh faces)");
+            EASY3D_PROFILE_ELEMENTS(model->n_faces());
             assert(model);
             assert(drawable);
 
@@ -2133,8 +2330,11 @@ namespace easy3d {
                     switch (drawable->property_location()) {
                         case State::FACE: {
                             auto colors = model->get_face_property<vec3>(name);
+                            auto narrowed_colors = model->get_face_property<u8vec3>(name);
                             if (colors)
                                 details::update_colors_on_faces(model, drawable, colors);
+                            else if (narrowed_colors)
+                                details::update_colors_on_faces(model, drawable, narrowed_colors);
                             else {
                                 LOG(WARNING) << "color property \'" << name
                                              << "\' not found on faces (use uniform coloring)";
@@ -2146,8 +2346,11 @@ namespace easy3d {
                         }
                         case State::VERTEX: {
                             auto colors = model->get_vertex_property<vec3>(name);
+                            auto narrowed_colors = model->get_vertex_property<u8vec3>(name);
                             if (colors)
                                 details::update_colors_on_vertices(model, drawable, colors);
+                            else if (narrowed_colors)
+                                details::update_colors_on_vertices(model, drawable, narrowed_colors);
                             else {
                                 LOG(WARNING) << "color property \'" << name
                                              << "\' not found on vertices (use uniform coloring)";
@@ -2180,6 +2383,9 @@ namespace easy3d {
                             } else if (model->get_face_property<unsigned int>(name)) {
                                 auto prop = model->get_face_property<unsigned int>(name);
                                 details::update_scalar_on_faces(model, drawable, prop);
+                            } else if (model->get_face_property<unsigned short>(name)) {
+                                auto prop = model->get_face_property<unsigned short>(name);
+                                details::update_scalar_on_faces(model, drawable, prop);
                             } else if (model->get_face_property<char>(name)) {
                                 auto prop = model->get_face_property<char>(name);
                                 details::update_scalar_on_faces(model, drawable, prop);
@@ -2211,6 +2417,9 @@ namespace easy3d {
                             } else if (model->get_vertex_property<unsigned int>(name)) {
                                 auto prop = model->get_vertex_property<unsigned int>(name);
                                 details::update_scalar_on_vertices(model, drawable, prop);
+                            } else if (model->get_vertex_property<unsigned short>(name)) {
+                                auto prop = model->get_vertex_property<unsigned short>(name);
+                                details::update_scalar_on_vertices(model, drawable, prop);
                             } else if (model->get_vertex_property<char>(name)) {
                                 auto prop = model->get_vertex_property<char>(name);
                                 details::update_scalar_on_vertices(model, drawable, prop);
@@ -2276,6 +2485,8 @@ namespace easy3d {
 
 
         void update(PolyMesh *model, TrianglesDrawable *drawable, bool border) {
+            EASY3D_PROFILE_ZONE("buffers::update (polyhedral mesh faces)");
+            EASY3D_PROFILE_ELEMENTS(model->n_faces());
             assert(model);
             assert(drawable);
 
@@ -2361,6 +2572,9 @@ namespace easy3d {
                             } else if (model->get_face_property<unsigned int>(name)) {
                                 auto prop = model->get_face_property<unsigned int>(name);
                                 details::update_scalar_on_faces(model, drawable, prop, border);
+                            } else if (model->get_face_property<unsigned short>(name)) {
+                                auto prop = model->get_face_property<unsigned short>(name);
+                                details::update_scalar_on_faces(model, drawable, prop, border);
                             } else if (model->get_face_property<char>(name)) {
                                 auto prop = model->get_face_property<char>(name);
                                 details::update_scalar_on_faces(model, drawable, prop, border);
@@ -2392,6 +2606,9 @@ namespace easy3d {
                             } else if (model->get_vertex_property<unsigned int>(name)) {
                                 auto prop = model->get_vertex_property<unsigned int>(name);
                                 details::update_scalar_on_vertices(model, drawable, prop, border);
+                            } else if (model->get_vertex_property<unsigned short>(name)) {
+                                auto prop = model->get_vertex_property<unsigned short>(name);
+                                details::update_scalar_on_vertices(model, drawable, prop, border);
                             } else if (model->get_vertex_property<char>(name)) {
                                 auto prop = model->get_vertex_property<char>(name);
                                 details::update_scalar_on_vertices(model, drawable, prop, border);
@@ -2530,7 +2747,61 @@ namespace easy3d {
         // -------------------------------------------------------------------------------------------------------------
 
 
+        bool update(Model *model, Drawable *drawable, const std::map<std::string, DirtyRanges> &modified) {
+            if (model->empty() || drawable->num_vertices() != model->points().size())
+                return false;
+
+            // only buffers storing the vertex attributes in the order of the model's vertices can be partially
+            // updated. Scalar fields are excluded because a change of the values may change their range.
+            const State::Method coloring = drawable->coloring_method();
+            switch (drawable->type()) {
+                case Drawable::DT_POINTS:
+                    if (coloring == State::SCALAR_FIELD || drawable->name() == "locks")
+                        return false;
+                    break;
+                case Drawable::DT_LINES:
+                    if (coloring != State::UNIFORM_COLOR || drawable->name() == "borders" ||
+                        dynamic_cast<PointCloud *>(model))
+                        return false;
+                    break;
+                case Drawable::DT_TRIANGLES:
+                    if (!dynamic_cast<SurfaceMesh *>(model))
+                        return false;
+                    if (coloring == State::SCALAR_FIELD ||
+                        (coloring != State::UNIFORM_COLOR && drawable->property_location() != State::VERTEX))
+                        return false;
+                    break;
+            }
+
+            if (dynamic_cast<SurfaceMesh *>(model)) {
+                SurfaceMesh *mesh = dynamic_cast<SurfaceMesh *>(model);
+                if (!details::update_modified_vertices(mesh, drawable, modified))
+                    return false;
+                // moving vertices changes the normals of the surrounding vertices
+                auto pos = modified.find("v:point");
+                if (pos != modified.end() && drawable->type() != Drawable::DT_LINES) {
+                    DirtyRanges changed;
+                    details::update_modified_normals(mesh, pos->second, changed);
+                    auto normals = mesh->get_vertex_property<vec3>("v:normal");
+                    if (drawable->normal_buffer())
+                        drawable->update_normal_buffer(normals.vector(), changed);
+                }
+                return true;
+            } else if (dynamic_cast<PointCloud *>(model))
+                return details::update_modified_vertices(dynamic_cast<PointCloud *>(model), drawable, modified);
+            else if (dynamic_cast<Graph *>(model))
+                return details::update_modified_vertices(dynamic_cast<Graph *>(model), drawable, modified);
+            else if (dynamic_cast<PolyMesh *>(model)) {
+                if (drawable->type() == Drawable::DT_TRIANGLES)
+                    return false;
+                return details::update_modified_vertices(dynamic_cast<PolyMesh *>(model), drawable, modified);
+            }
+            return false;
+        }
+
+
         void update(Model *model, Drawable *drawable) {
+            EASY3D_PROFILE_ZONE("buffers::update");
             if (model->empty()) {
                 LOG(WARNING) << "model has no valid geometry";
                 return;
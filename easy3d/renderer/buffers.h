@@ -29,8 +29,10 @@
 
 
 #include <easy3d/renderer/state.h>
+#include <easy3d/core/dirty_ranges.h>
 
 #include <string>
+#include <map>
 
 namespace easy3d {
 
@@ -58,6 +60,20 @@ namespace easy3d {
          * @param drawable  The drawable.
          */
         void update(Model* model, Drawable* drawable);
+
+        /**
+         * @brief Uploads only the modified parts of the render buffers of a drawable.
+         * @details This is possible if the buffers of the drawable store the vertex attributes in the order of the
+         *      model's vertices, i.e., for the default "vertices" drawables, the "edges" drawables with a uniform
+         *      color, and the "faces" drawables of surface meshes with a uniform color or per-vertex colors/texture
+         *      coordinates. For surface meshes, the normals of the vertices around the moved ones are recomputed.
+         * @param model     The model.
+         * @param drawable  The drawable.
+         * @param modified  The modified ranges of the model's properties (see Model::mark_modified()).
+         * @return \c true if the buffers have been updated, or \c false if the buffers have to be rebuilt (e.g., the
+         *      drawable duplicates vertices, or shows a scalar field whose range may have changed).
+         */
+        bool update(Model* model, Drawable* drawable, const std::map<std::string, DirtyRanges>& modified);
         //@}
 
         /// \name Render buffer update for PointCloud
@@ -0,0 +1,245 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/renderer/chunk_culler.h>
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include <easy3d/util/thread_pool.h>
+
+
+namespace easy3d {
+
+
+    namespace {
+        // the number of chunks tested together (see ChunkCuller::cull())
+        const int block_size = 1024;
+        // more chunks than this are culled in parallel
+        const int parallel_threshold = 16 * 1024;
+    }
+
+
+    void ChunkCuller::set_chunks(const std::vector<Chunk> &chunks) {
+        chunks_ = chunks;
+        const std::size_t num = chunks.size();
+        cx_.resize(num);
+        cy_.resize(num);
+        cz_.resize(num);
+        ex_.resize(num);
+        ey_.resize(num);
+        ez_.resize(num);
+        radius_.resize(num);
+        for (std::size_t i = 0; i < num; ++i) {
+            const Box3 &box = chunks[i].box;
+            if (!box.is_valid()) {  // an empty chunk: never visible
+                cx_[i] = cy_[i] = cz_[i] = 0.0f;
+                ex_[i] = ey_[i] = ez_[i] = -1.0f;
+                radius_[i] = 0.0f;
+                continue;
+            }
+            const vec3 c = box.center();
+            cx_[i] = c.x;
+            cy_[i] = c.y;
+            cz_[i] = c.z;
+            ex_[i] = box.range(0) * 0.5f;
+            ey_[i] = box.range(1) * 0.5f;
+            ez_[i] = box.range(2) * 0.5f;
+            radius_[i] = box.radius();
+        }
+    }
+
+
+    void ChunkCuller::clear() {
+        chunks_.clear();
+        cx_.clear();
+        cy_.clear();
+        cz_.clear();
+        ex_.clear();
+        ey_.clear();
+        ez_.clear();
+        radius_.clear();
+    }
+
+
+    std::size_t ChunkCuller::cull(const mat4 &mvp, int width, int height, float min_pixels,
+                                  std::vector<std::size_t> &visible) const {
+        visible.clear();
+        const int num = static_cast<int>(chunks_.size());
+        if (num == 0)
+            return 0;
+
+        // the planes of the frustum (pointing inwards) extracted from the rows of the matrix, in the order left,
+        // right, bottom, top, near, and far. A point p is inside if dot(plane.xyz, p) + plane.w >= 0 for all planes.
+        // A box is outside if its center is farther outside a plane than the box extends in the plane's direction.
+        float a[6], b[6], c[6], d[6];
+        for (int k = 0; k < 3; ++k) {
+            const float sign[2] = {1.0f, -1.0f};
+            for (int s = 0; s < 2; ++s) {
+                a[k * 2 + s] = mvp(3, 0) + sign[s] * mvp(k, 0);
+                b[k * 2 + s] = mvp(3, 1) + sign[s] * mvp(k, 1);
+                c[k * 2 + s] = mvp(3, 2) + sign[s] * mvp(k, 2);
+                d[k * 2 + s] = mvp(3, 3) + sign[s] * mvp(k, 3);
+            }
+        }
+        float abs_a[6], abs_b[6], abs_c[6];
+        for (int k = 0; k < 6; ++k) {
+            abs_a[k] = std::abs(a[k]);
+            abs_b[k] = std::abs(b[k]);
+            abs_c[k] = std::abs(c[k]);
+        }
+
+        // The projected diameter (in pixels) of a sphere with radius r centered at p is approximately
+        // 2 * r * scale / w, where w is the clip-space w of p. This is exact for an orthographic projection (w = 1)
+        // and for a sphere in the center of a perspective view. It is only used if the sphere is entirely in front of
+        // the viewer, i.e., w > r * |row_w|.
+        const vec3 row_x(mvp(0, 0), mvp(0, 1), mvp(0, 2));
+        const vec3 row_y(mvp(1, 0), mvp(1, 1), mvp(1, 2));
+        const vec3 row_w(mvp(3, 0), mvp(3, 1), mvp(3, 2));
+        const float scale = std::max(length(row_x) * static_cast<float>(width),
+                                     length(row_y) * static_cast<float>(height)) * 0.5f;
+        const float w_scale = length(row_w);
+        const float min_size = std::max(min_pixels, 0.0f) * 0.5f;   // compared with r * scale / w
+        const float wx = row_w.x, wy = row_w.y, wz = row_w.z, ww = mvp(3, 3);
+
+        // The chunks are tested block by block. Within a block, the planes are tested one after another and each test
+        // is a branch-free loop over the arrays, which is vectorized by the compiler. Large numbers of chunks are
+        // culled in parallel, a block per task.
+        flags_.resize(num);
+        unsigned char *flags = flags_.data();
+        const int num_blocks = (num + block_size - 1) / block_size;
+        std::vector<std::size_t> counts(num_blocks + 1, 0);
+        auto cull_block = [&](int block) {
+            const int first = block * block_size;
+            const int n = std::min(num, first + block_size) - first;
+            const float *x = cx_.data() + first, *y = cy_.data() + first, *z = cz_.data() + first;
+            const float *hx = ex_.data() + first, *hy = ey_.data() + first, *hz = ez_.data() + first;
+            const float *radius = radius_.data() + first;
+            unsigned char *visibility = flags + first;
+
+            // the smallest margin to the planes (negative if outside one of the planes)
+            float margin[block_size];
+            for (int j = 0; j < n; ++j)
+                margin[j] = hx[j];  // empty chunks have a negative extent
+            for (int k = 0; k < 6; ++k) {
+                const float ak = a[k], bk = b[k], ck = c[k], dk = d[k];
+                const float abs_ak = abs_a[k], abs_bk = abs_b[k], abs_ck = abs_c[k];
+                for (int j = 0; j < n; ++j) {
+                    const float m = ak * x[j] + bk * y[j] + ck * z[j] + dk + abs_ak * hx[j] + abs_bk * hy[j] + abs_ck * hz[j];
+                    margin[j] = std::min(margin[j], m);
+                }
+            }
+
+            // computed as int (and narrowed afterwards) so that both loops are vectorized
+            int visible_in_block[block_size];
+            for (int j = 0; j < n; ++j) {
+                const float r = radius[j];
+                const float w = wx * x[j] + wy * y[j] + wz * z[j] + ww;
+                const bool small = (w > r * w_scale) & (r * scale < min_size * w);
+                visible_in_block[j] = (margin[j] >= 0.0f) & !small;
+            }
+            int count = 0;
+            for (int j = 0; j < n; ++j) {
+                visibility[j] = static_cast<unsigned char>(visible_in_block[j]);
+                count += visible_in_block[j];
+            }
+            counts[block + 1] = static_cast<std::size_t>(count);
+        };
+
+        // the visible chunks of each block start at the total count of the previous blocks. Each index is written
+        // and kept only if visible, which avoids unpredictable branches.
+        auto collect_block = [&](int block) {
+            const int first = block * block_size, last = std::min(num, first + block_size);
+            std::size_t indices[block_size + 1];
+            std::size_t count = 0;
+            for (int i = first; i < last; ++i) {
+                indices[count] = static_cast<std::size_t>(i);
+                count += flags[i];
+            }
+            std::copy(indices, indices + count, visible.begin() + counts[block]);
+        };
+
+        const bool parallel = num > parallel_threshold;
+        if (parallel)
+            parallel_for(0, num_blocks, cull_block);
+        else {
+            for (int block = 0; block < num_blocks; ++block)
+                cull_block(block);
+        }
+        for (int block = 0; block < num_blocks; ++block)
+            counts[block + 1] += counts[block];
+        visible.resize(counts[num_blocks]);
+        if (parallel)
+            parallel_for(0, num_blocks, collect_block);
+        else {
+            for (int block = 0; block < num_blocks; ++block)
+                collect_block(block);
+        }
+        return visible.size();
+    }
+
+
+    std::vector<std::size_t> ChunkCuller::partition(const std::vector<vec3> &points, std::size_t chunk_size,
+                                                    std::vector<unsigned int> &order) {
+        order.resize(points.size());
+        std::iota(order.begin(), order.end(), 0u);
+
+        std::vector<std::size_t> offsets(1, 0);
+        if (points.empty())
+            return offsets;
+        chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+        // the ranges of 'order' still to be split. Processed depth first and front to back, so the chunks are
+        // generated in the order of 'order'.
+        std::vector<std::pair<std::size_t, std::size_t> > stack(1, std::make_pair(std::size_t(0), points.size()));
+        while (!stack.empty()) {
+            const auto range = stack.back();
+            stack.pop_back();
+            if (range.second - range.first <= chunk_size) {
+                offsets.push_back(range.second);
+                continue;
+            }
+
+            Box3 box;
+            for (std::size_t i = range.first; i < range.second; ++i)
+                box.grow(points[order[i]]);
+            const int axis = static_cast<int>(box.max_range_axis());
+
+            const std::size_t mid = range.first + (range.second - range.first) / 2;
+            std::nth_element(order.begin() + range.first, order.begin() + mid, order.begin() + range.second,
+                             [&points, axis](unsigned int a, unsigned int b) -> bool {
+                                 return points[a][axis] < points[b][axis];
+                             });
+            stack.emplace_back(mid, range.second);
+            stack.emplace_back(range.first, mid);
+        }
+        return offsets;
+    }
+
+}
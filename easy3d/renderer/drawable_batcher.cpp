@@ -0,0 +1,517 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/renderer/drawable_batcher.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include <easy3d/core/model.h>
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/renderer/opengl_info.h>
+#include <easy3d/renderer/renderer.h>
+#include <easy3d/renderer/drawable_triangles.h>
+#include <easy3d/renderer/vertex_array_object.h>
+#include <easy3d/renderer/shader_program.h>
+#include <easy3d/renderer/shader_manager.h>
+#include <easy3d/renderer/clipping_plane.h>
+#include <easy3d/renderer/transform.h>
+#include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/setting.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+    namespace details {
+
+        // the number of floats (i.e., 9 RGBA texels) of the per-draw data of each drawable
+        const std::size_t draw_data_size = 36;
+
+        // the layout of glMultiDrawElementsIndirect() commands
+        struct DrawCommand {
+            GLuint count;
+            GLuint instance_count;
+            GLuint first_index;
+            GLint base_vertex;
+            GLuint base_instance;
+        };
+
+
+        inline bool multi_draw_indirect_supported() {
+            static const bool supported = OpenglInfo::is_supported("GL_VERSION_4_3") ||
+                                          OpenglInfo::is_supported("GL_ARB_multi_draw_indirect");
+            return supported;
+        }
+
+
+        // the draw IDs are stored as floats, which represent integers exactly up to 2^24
+        inline std::size_t max_draws_per_batch() {
+            static std::size_t max_draws = 0;
+            if (max_draws == 0) {
+                GLint max_texels = 0;
+                glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);	easy3d_debug_log_gl_error;
+                max_draws = std::max<std::size_t>(1, std::min<std::size_t>(max_texels / (draw_data_size / 4), 1 << 24));
+            }
+            return max_draws;
+        }
+
+
+        inline void copy_buffer(GLuint source, GLuint target, std::size_t offset, std::size_t size) {
+            glBindBuffer(GL_COPY_READ_BUFFER, source);	easy3d_debug_log_gl_error;
+            glBindBuffer(GL_COPY_WRITE_BUFFER, target);	easy3d_debug_log_gl_error;
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, GLintptr(offset), GLsizeiptr(size));
+            easy3d_debug_log_gl_error;
+        }
+
+    }
+
+
+    struct DrawableBatcher::Batch {
+        Batch() : vao(nullptr), vertex_buffer(0), normal_buffer(0), color_buffer(0), id_buffer(0), element_buffer(0),
+                  data_buffer(0), data_texture(0), command_buffer(0), index_size(sizeof(unsigned int)) {}
+
+        ~Batch() {
+            VertexArrayObject::release_buffer(vertex_buffer);
+            VertexArrayObject::release_buffer(normal_buffer);
+            VertexArrayObject::release_buffer(color_buffer);
+            VertexArrayObject::release_buffer(id_buffer);
+            VertexArrayObject::release_buffer(element_buffer);
+            VertexArrayObject::release_buffer(data_buffer);
+            VertexArrayObject::release_buffer(command_buffer);
+            if (data_texture)
+                glDeleteTextures(1, &data_texture);
+            delete vao;
+        }
+
+        Key key;
+        std::vector<Record> records;
+
+        VertexArrayObject *vao;
+        GLuint vertex_buffer;
+        GLuint normal_buffer;
+        GLuint color_buffer;
+        GLuint id_buffer;           // the draw ID of each vertex
+        GLuint element_buffer;
+        GLuint data_buffer;         // the per-draw data, accessed through the buffer texture
+        GLuint data_texture;
+        GLuint command_buffer;      // the indirect draw commands (0 if multi-draw-indirect is not supported)
+        std::size_t index_size;
+
+        std::vector<float> data;        // the per-draw data in the data buffer
+        std::vector<float> new_data;
+        std::vector<details::DrawCommand> commands;         // the draws of the visible drawables
+        std::vector<details::DrawCommand> new_commands;
+        // the arguments of glMultiDrawElementsBaseVertex()
+        std::vector<GLsizei> counts;
+        std::vector<void *> offsets;
+        std::vector<GLint> base_vertices;
+    };
+
+
+    DrawableBatcher::DrawableBatcher() {
+    }
+
+
+    DrawableBatcher::~DrawableBatcher() {
+        clear();
+    }
+
+
+    void DrawableBatcher::clear() {
+        for (auto batch : batches_)
+            delete batch;
+        batches_.clear();
+        batches_by_key_.clear();
+        groups_.clear();
+        drawables_.clear();
+        models_.clear();
+    }
+
+
+    bool DrawableBatcher::is_batchable(const Drawable *drawable) {
+        if (!drawable || drawable->type() != Drawable::DT_TRIANGLES)
+            return false;
+        if (drawable->compact_attributes() || !drawable->chunks().empty() || drawable->highlight() ||
+            drawable->is_ssao_enabled())
+            return false;
+        if (!drawable->vertex_buffer() || !drawable->normal_buffer() || !drawable->element_buffer() ||
+            drawable->num_indices() == 0)
+            return false;
+        const bool use_texture = drawable->texture() && (drawable->coloring_method() == State::SCALAR_FIELD ||
+                                                         drawable->coloring_method() == State::TEXTURED);
+        return !use_texture;
+    }
+
+
+    DrawableBatcher::Key DrawableBatcher::make_key(const TrianglesDrawable *d) {
+        const bool per_vertex_color = d->coloring_method() != State::UNIFORM_COLOR && d->color_buffer();
+        const auto &material = d->material();
+        const Key key = {{
+                                 float(d->lighting()), float(d->lighting_two_sides()),
+                                 float(d->distinct_back_color()),
+                                 d->back_color().r, d->back_color().g, d->back_color().b,
+                                 float(d->smooth_shading()), float(per_vertex_color),
+                                 material.ambient.x, material.ambient.y, material.ambient.z,
+                                 material.specular.x, material.specular.y, material.specular.z, material.shininess,
+                                 float(d->plane_clip_discard_primitive()), float(d->index_size())
+                         }};
+        return key;
+    }
+
+
+    std::size_t DrawableBatcher::update(const std::vector<Model *> &models) {
+        if (models_ != models)
+            models_ = models;
+
+        for (auto &group : groups_)
+            group.second.clear();
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            const Model *model = models[i];
+            if (!model->renderer())
+                continue;
+            const bool model_visible = model->renderer()->is_visible();
+            for (const auto d : model->renderer()->triangles_drawables()) {
+                // the buffers of hidden drawables are not built until they are shown
+                if (d->vertex_buffer() == 0 && !(model_visible && d->is_visible()))
+                    continue;
+                d->update_buffers_if_needed();
+                if (!is_batchable(d))
+                    continue;
+                const Record record = {d, d->buffer_revision(), static_cast<int>(i), 0, 0};
+                groups_[make_key(d)].push_back(record);
+            }
+        }
+
+        bool changed = false;
+        const std::size_t max_draws = details::max_draws_per_batch();
+        for (auto it = groups_.begin(); it != groups_.end();) {
+            const Key &key = it->first;
+            const std::vector<Record> &records = it->second;
+            std::vector<Batch *> &batches = batches_by_key_[key];
+
+            // the existing batches can be reused if they have the same drawables, with the same buffers
+            bool same = true;
+            std::size_t idx = 0;
+            for (auto batch : batches) {
+                for (auto &r : batch->records) {
+                    if (idx >= records.size() || records[idx].drawable != r.drawable ||
+                        records[idx].revision != r.revision) {
+                        same = false;
+                        break;
+                    }
+                    r.model_index = records[idx].model_index;
+                    ++idx;
+                }
+                if (!same)
+                    break;
+            }
+            if (!same || idx != records.size()) {
+                for (auto batch : batches)
+                    delete batch;
+                batches.clear();
+                for (std::size_t first = 0; first < records.size(); first += max_draws) {
+                    const std::size_t last = std::min(first + max_draws, records.size());
+                    Batch *batch = new Batch;
+                    build(batch, key, std::vector<Record>(records.begin() + first, records.begin() + last));
+                    batches.push_back(batch);
+                }
+                changed = true;
+            }
+
+            if (records.empty()) {
+                batches_by_key_.erase(key);
+                it = groups_.erase(it);
+            } else
+                ++it;
+        }
+
+        if (changed) {
+            batches_.clear();
+            drawables_.clear();
+            for (const auto &entry : batches_by_key_) {
+                for (auto batch : entry.second) {
+                    batches_.push_back(batch);
+                    for (const auto &r : batch->records)
+                        drawables_.insert(r.drawable);
+                }
+            }
+        }
+
+        for (auto batch : batches_)
+            update_draws(batch);
+
+        return drawables_.size();
+    }
+
+
+    void DrawableBatcher::build(Batch *batch, const Key &key, const std::vector<Record> &records) {
+        batch->key = key;
+        batch->records = records;
+
+        std::size_t num_vertices = 0, num_indices = 0;
+        for (auto &r : batch->records) {
+            r.first_vertex = num_vertices;
+            r.first_index = num_indices;
+            num_vertices += r.drawable->num_vertices();
+            num_indices += r.drawable->num_indices();
+        }
+        batch->index_size = records.front().drawable->index_size();
+        const bool per_vertex_color = key[7] > 0.5f;
+
+        std::vector<float> ids(num_vertices);
+        for (std::size_t i = 0; i < batch->records.size(); ++i) {
+            const auto &r = batch->records[i];
+            std::fill(ids.begin() + r.first_vertex, ids.begin() + r.first_vertex + r.drawable->num_vertices(),
+                      static_cast<float>(i));
+        }
+
+        // the pools are allocated, and then filled with the content of the buffers of the drawables
+        batch->vao = new VertexArrayObject;
+        bool success =
+                batch->vao->create_array_buffer(batch->vertex_buffer, ShaderProgram::POSITION, nullptr,
+                                                num_vertices * sizeof(vec3), 3) &&
+                batch->vao->create_array_buffer(batch->normal_buffer, ShaderProgram::NORMAL, nullptr,
+                                                num_vertices * sizeof(vec3), 3) &&
+                (!per_vertex_color ||
+                 batch->vao->create_array_buffer(batch->color_buffer, ShaderProgram::COLOR, nullptr,
+                                                 num_vertices * sizeof(vec3), 3)) &&
+                batch->vao->create_array_buffer(batch->id_buffer, ShaderProgram::ATTRIB_1, ids.data(),
+                                                ids.size() * sizeof(float), 1) &&
+                batch->vao->create_element_buffer(batch->element_buffer, nullptr, num_indices * batch->index_size);
+        if (!success) {
+            LOG(ERROR) << "failed creating the buffers of a batch of " << records.size() << " drawables";
+            batch->records.clear();   // the drawables will be drawn individually
+            return;
+        }
+
+        for (const auto &r : batch->records) {
+            const TrianglesDrawable *d = r.drawable;
+            const std::size_t offset = r.first_vertex * sizeof(vec3);
+            const std::size_t size = d->num_vertices() * sizeof(vec3);
+            details::copy_buffer(d->vertex_buffer(), batch->vertex_buffer, offset, size);
+            details::copy_buffer(d->normal_buffer(), batch->normal_buffer, offset, size);
+            if (per_vertex_color)
+                details::copy_buffer(d->color_buffer(), batch->color_buffer, offset, size);
+            details::copy_buffer(d->element_buffer(), batch->element_buffer, r.first_index * batch->index_size,
+                                 d->num_indices() * batch->index_size);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);	easy3d_debug_log_gl_error;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);	easy3d_debug_log_gl_error;
+
+        // the per-draw data
+        glGenBuffers(1, &batch->data_buffer);	easy3d_debug_log_gl_error;
+        glBindBuffer(GL_TEXTURE_BUFFER, batch->data_buffer);	easy3d_debug_log_gl_error;
+        glBufferData(GL_TEXTURE_BUFFER, GLsizeiptr(records.size() * details::draw_data_size * sizeof(float)), nullptr,
+                     GL_DYNAMIC_DRAW);	easy3d_debug_log_gl_error;
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);	easy3d_debug_log_gl_error;
+        glGenTextures(1, &batch->data_texture);	easy3d_debug_log_gl_error;
+        glBindTexture(GL_TEXTURE_BUFFER, batch->data_texture);	easy3d_debug_log_gl_error;
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, batch->data_buffer);	easy3d_debug_log_gl_error;
+        glBindTexture(GL_TEXTURE_BUFFER, 0);	easy3d_debug_log_gl_error;
+
+        if (details::multi_draw_indirect_supported()) {
+            glGenBuffers(1, &batch->command_buffer);	easy3d_debug_log_gl_error;
+        }
+    }
+
+
+    void DrawableBatcher::update_draws(Batch *batch) {
+        const std::size_t num = batch->records.size();
+        std::vector<float> &data = batch->new_data;
+        data.resize(num * details::draw_data_size);
+        const bool has_data = (batch->data.size() == data.size());
+        batch->new_commands.clear();
+
+        for (std::size_t i = 0; i < num; ++i) {
+            const Record &r = batch->records[i];
+            const TrianglesDrawable *d = r.drawable;
+            float *texels = data.data() + i * details::draw_data_size;
+
+            // MANIP and NORMAL (the normal matrix is computed only if the manipulation has changed)
+            const mat4 manip = d->manipulated_matrix();
+            for (int col = 0; col < 4; ++col) {
+                for (int row = 0; row < 4; ++row)
+                    texels[col * 4 + row] = manip(row, col);
+            }
+            const float *old_texels = has_data ? batch->data.data() + i * details::draw_data_size : nullptr;
+            if (old_texels && std::equal(texels, texels + 16, old_texels))
+                std::copy(old_texels + 16, old_texels + 28, texels + 16);
+            else {
+                const mat3 normal = transform::normal_matrix(manip);
+                for (int col = 0; col < 3; ++col) {
+                    for (int row = 0; row < 3; ++row)
+                        texels[16 + col * 4 + row] = normal(row, col);
+                    texels[16 + col * 4 + 3] = 0.0f;
+                }
+            }
+            texels[19] = d->is_selected() ? 1.0f : 0.0f;
+
+            const vec4 &color = d->color();
+            std::copy(color.data(), color.data() + 4, texels + 28);
+
+            int red, green, blue, alpha;
+            rgb::encode(r.model_index, red, green, blue, alpha);
+            texels[32] = red / 255.0f;
+            texels[33] = green / 255.0f;
+            texels[34] = blue / 255.0f;
+            texels[35] = alpha / 255.0f;
+
+            const Model *model = d->model();
+            if (d->is_visible() && (!model || model->renderer()->is_visible())) {
+                const details::DrawCommand command = {
+                        static_cast<GLuint>(d->num_indices()), 1, static_cast<GLuint>(r.first_index),
+                        static_cast<GLint>(r.first_vertex), 0
+                };
+                batch->new_commands.push_back(command);
+            }
+        }
+
+        if (data != batch->data) {
+            glBindBuffer(GL_TEXTURE_BUFFER, batch->data_buffer);	easy3d_debug_log_gl_error;
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, GLsizeiptr(data.size() * sizeof(float)), data.data());
+            easy3d_debug_log_gl_error;
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);	easy3d_debug_log_gl_error;
+            batch->data.swap(data);
+        }
+
+        const auto &commands = batch->new_commands;
+        if (commands.size() == batch->commands.size() &&
+            (commands.empty() ||
+             std::memcmp(commands.data(), batch->commands.data(), commands.size() * sizeof(details::DrawCommand)) == 0))
+            return;
+        batch->commands = commands;
+
+        if (batch->command_buffer) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->command_buffer);	easy3d_debug_log_gl_error;
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, GLsizeiptr(commands.size() * sizeof(details::DrawCommand)),
+                         commands.data(), GL_DYNAMIC_DRAW);	easy3d_debug_log_gl_error;
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);	easy3d_debug_log_gl_error;
+        } else {
+            batch->counts.clear();
+            batch->offsets.clear();
+            batch->base_vertices.clear();
+            for (const auto &c : commands) {
+                batch->counts.push_back(static_cast<GLsizei>(c.count));
+                batch->offsets.push_back(reinterpret_cast<void *>(c.first_index * batch->index_size));
+                batch->base_vertices.push_back(c.base_vertex);
+            }
+        }
+    }
+
+
+    void DrawableBatcher::draw(const Camera *camera) const {
+        draw(camera, false);
+    }
+
+
+    void DrawableBatcher::draw_ids(const Camera *camera) const {
+        draw(camera, true);
+    }
+
+
+    void DrawableBatcher::draw(const Camera *camera, bool picking) const {
+        if (batches_.empty())
+            return;
+
+        ShaderProgram *program = ShaderManager::get_program("surface/surface_batch");
+        if (!program) {
+            std::vector<ShaderProgram::Attribute> attributes = {
+                    ShaderProgram::Attribute(ShaderProgram::POSITION, "vtx_position"),
+                    ShaderProgram::Attribute(ShaderProgram::COLOR, "vtx_color"),
+                    ShaderProgram::Attribute(ShaderProgram::NORMAL, "vtx_normal"),
+                    ShaderProgram::Attribute(ShaderProgram::ATTRIB_1, "vtx_draw_id")
+            };
+            program = ShaderManager::create_program_from_files("surface/surface_batch", attributes);
+        }
+        if (!program)
+            return;
+
+        const mat4 &MVP = camera->modelViewProjectionMatrix();
+        const vec3 &wCamPos = camera->position();
+        const mat4 &MV = camera->modelViewMatrix();
+        const vec4 &wLightPos = inverse(MV) * setting::light_position;
+
+        program->bind();
+        program->set_uniform("MVP", MVP)
+                ->set_uniform("wLightPos", wLightPos)
+                ->set_uniform("wCamPos", wCamPos)
+                ->set_uniform("picking", picking);
+        if (setting::clipping_plane)
+            setting::clipping_plane->set_program(program);
+
+        // the batched surfaces are always drawn with the polygon offset the viewer uses for surfaces with edges
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(0.5f, -0.0001f);
+
+        for (auto batch : batches_) {
+            if (batch->commands.empty())
+                continue;
+
+            const Key &key = batch->key;
+            const vec3 back_color(key[3], key[4], key[5]);
+            const vec3 ambient(key[8], key[9], key[10]);
+            const vec3 specular(key[11], key[12], key[13]);
+            const float shininess = key[14];
+            program->set_uniform("lighting", key[0] > 0.5f && !picking)
+                    ->set_uniform("two_sides_lighting", key[1] > 0.5f)
+                    ->set_uniform("distinct_back_color", key[2] > 0.5f)
+                    ->set_uniform("backside_color", back_color)
+                    ->set_uniform("smooth_shading", key[6] > 0.5f)
+                    ->set_uniform("per_vertex_color", key[7] > 0.5f)
+                    ->set_block_uniform("Material", "ambient", ambient)
+                    ->set_block_uniform("Material", "specular", specular)
+                    ->set_block_uniform("Material", "shininess", &shininess)
+                    ->bind_texture("draw_data", batch->data_texture, 0, GL_TEXTURE_BUFFER);
+            if (setting::clipping_plane)
+                setting::clipping_plane->set_discard_primitives(program, key[15] > 0.5f);
+
+            batch->vao->bind();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->element_buffer);	easy3d_debug_log_gl_error;
+            const GLenum index_type = (batch->index_size == sizeof(unsigned short)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            if (batch->command_buffer) {
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->command_buffer);	easy3d_debug_log_gl_error;
+                glMultiDrawElementsIndirect(GL_TRIANGLES, index_type, nullptr, GLsizei(batch->commands.size()), 0);
+                easy3d_debug_log_gl_error;
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);	easy3d_debug_log_gl_error;
+            } else {
+                glMultiDrawElementsBaseVertex(GL_TRIANGLES, batch->counts.data(), index_type, batch->offsets.data(),
+                                              GLsizei(batch->counts.size()), batch->base_vertices.data());
+                easy3d_debug_log_gl_error;
+            }
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);	easy3d_debug_log_gl_error;
+            batch->vao->release();
+            ++Drawable::draw_call_count_;
+        }
+
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        program->release_texture(GL_TEXTURE_BUFFER);
+        program->release();
+    }
+
+}
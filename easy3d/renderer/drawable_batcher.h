@@ -0,0 +1,136 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_RENDERER_DRAWABLE_BATCHER_H
+#define EASY3D_RENDERER_DRAWABLE_BATCHER_H
+
+
+#include <map>
+#include <array>
+#include <vector>
+#include <unordered_set>
+#include <cstddef>
+
+
+namespace easy3d {
+
+    class Model;
+    class Camera;
+    class Drawable;
+    class TrianglesDrawable;
+
+    /**
+     * \brief Draws the triangles drawables of many models using a few multi-draw calls.
+     * \class DrawableBatcher easy3d/renderer/drawable_batcher.h
+     * \details Drawing each drawable requires binding its program, setting its uniforms, and issuing its own draw
+     *      call. For scenes with thousands of small models (e.g., the buildings of a city), this CPU overhead
+     *      dominates the rendering time. The batcher merges the drawables that share the same rendering state (i.e.,
+     *      everything except the color, the selection status, and the manipulation) into shared vertex and index
+     *      pools. Each pool is drawn by a single glMultiDrawElementsIndirect() call (or glMultiDrawElementsBaseVertex()
+     *      if indirect drawing is not supported). The data that differ per drawable are stored in a buffer texture
+     *      indexed by a per-vertex draw ID.
+     *
+     *      A drawable is batched if it is a triangles drawable with an element buffer and a normal buffer that does
+     *      not use compact attributes, textures, highlighting, SSAO, or chunking (see is_batchable()). The other
+     *      drawables have to be drawn as usual, i.e., skip those for which contains() returns \c true.
+     *      The visibility of the models and the drawables, the selection status, the uniform colors, and the
+     *      manipulation are taken into account each time update() is called. Modifying the buffers of a batched
+     *      drawable or its rendering state rebuilds the pool it belongs to.
+     *
+     * \note The pools store copies (made on the GPU) of the buffers of the drawables, so the batched drawables use
+     *      about twice the GPU memory.
+     * \see Drawable::buffer_revision(), setting::drawable_batching_threshold
+     */
+    class DrawableBatcher {
+    public:
+        DrawableBatcher();
+        ~DrawableBatcher();
+
+        /**
+         * \brief Collects the drawables of \p models that can be batched and updates the batches.
+         * \details The pools are rebuilt only if the batched drawables or their buffers have changed. This should be
+         *      called in each frame before draw(), with the rendering context current.
+         * \return The number of batched drawables.
+         */
+        std::size_t update(const std::vector<Model *> &models);
+
+        /// \brief Draws the visible batched drawables.
+        void draw(const Camera *camera) const;
+
+        /**
+         * \brief Draws the visible batched drawables without lighting, each in the color encoding the index of its
+         *      model in the models given to update() (see rgb::encode()). This is used by ModelPicker.
+         */
+        void draw_ids(const Camera *camera) const;
+
+        /// \brief Returns whether the drawable is drawn by the batcher.
+        bool contains(const Drawable *drawable) const { return drawables_.find(drawable) != drawables_.end(); }
+
+        /// \brief The models given to the last call of update().
+        const std::vector<Model *> &models() const { return models_; }
+
+        /// \brief The number of batches, i.e., the number of multi-draw calls issued by draw().
+        std::size_t num_batches() const { return batches_.size(); }
+        /// \brief The number of batched drawables.
+        std::size_t num_drawables() const { return drawables_.size(); }
+
+        /// \brief Releases all the batches.
+        void clear();
+
+        /// \brief Returns whether a drawable can be batched.
+        static bool is_batchable(const Drawable *drawable);
+
+    private:
+        // the rendering state shared by the drawables of a batch (see make_key())
+        typedef std::array<float, 17> Key;
+        static Key make_key(const TrianglesDrawable *drawable);
+
+        struct Record {
+            const TrianglesDrawable *drawable;
+            std::size_t revision;       // Drawable::buffer_revision() when the pool was built
+            int model_index;            // the index of the model in models_
+            std::size_t first_vertex;   // the ranges in the pools
+            std::size_t first_index;
+        };
+
+        struct Batch;
+        void build(Batch *batch, const Key &key, const std::vector<Record> &records);
+        void update_draws(Batch *batch);
+        void draw(const Camera *camera, bool picking) const;
+
+    private:
+        std::vector<Model *> models_;
+        std::map<Key, std::vector<Batch *> > batches_by_key_;
+        std::vector<Batch *> batches_;
+        std::unordered_set<const Drawable *> drawables_;
+        std::map<Key, std::vector<Record> > groups_;    // the drawables collected by update() (kept to avoid allocations)
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_DRAWABLE_BATCHER_H
@@ -53,10 +53,7 @@ namespace easy3d {
 
 
     void LinesDrawable::draw(const Camera *camera /* = false */) const {
-        if (update_needed_ || vertex_buffer_ == 0) {
-            const_cast<LinesDrawable *>(this)->update_buffers_internal();
-            const_cast<LinesDrawable *>(this)->update_needed_ = false;
-        }
+        update_buffers_if_needed();
 
         switch (impostor_type_) {
             case PLAIN:
@@ -97,7 +94,7 @@ namespace easy3d {
 
             const mat4 &MVP = camera->modelViewProjectionMatrix();
             // transformation introduced by manipulation
-            const mat4 MANIP = manipulated_matrix();
+            const mat4 MANIP = position_matrix();
 
             program->bind();
             program->set_uniform("MVP", MVP)
@@ -134,7 +131,7 @@ namespace easy3d {
                     ->set_uniform("invMV", inverse(camera->modelViewMatrix()))
                     ->set_uniform("MV", camera->modelViewMatrix())
                     ->set_uniform("PROJ", camera->projectionMatrix())
-                    ->set_uniform("MANIP", manipulated_matrix());
+                    ->set_uniform("MANIP", position_matrix());
 
             float ratio = camera->pixelGLRatio(camera->pivotPoint());
             program->set_uniform("radius", line_width_ * ratio * 0.5f)  // 0.5f from width -> radius
@@ -171,7 +168,7 @@ namespace easy3d {
                 ->set_uniform("invMV", inverse(camera->modelViewMatrix()))
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix());
+                ->set_uniform("MANIP", position_matrix());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
         program->set_uniform("radius", line_width_ * ratio * 0.5f)  // 0.5f from width -> radius
@@ -213,7 +210,7 @@ namespace easy3d {
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("invMV", inverse(camera->modelViewMatrix()))
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix());
+                ->set_uniform("MANIP", position_matrix());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
         program->set_uniform("radius", line_width() * ratio * 0.5f)  // 0.5f from width -> radius
@@ -251,7 +248,7 @@ namespace easy3d {
 
             const mat4 &MVP = camera->modelViewProjectionMatrix();
             // transformation introduced by manipulation
-            const mat4 MANIP = manipulated_matrix();
+            const mat4 MANIP = position_matrix();
 
             program->bind();
             program->set_uniform("MVP", MVP)
@@ -288,7 +285,7 @@ namespace easy3d {
             program->set_uniform("MV", camera->modelViewMatrix())
                     ->set_uniform("invMV", inverse(camera->modelViewMatrix()))
                     ->set_uniform("PROJ", camera->projectionMatrix())
-                    ->set_uniform("MANIP", manipulated_matrix());
+                    ->set_uniform("MANIP", position_matrix());
             float ratio = camera->pixelGLRatio(camera->pivotPoint());
             program->set_uniform("radius", line_width() * ratio * 0.5f);  // 0.5f from width -> radius
 
@@ -325,7 +322,7 @@ namespace easy3d {
                 ->set_uniform("invMV", inverse(camera->modelViewMatrix()))
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix());
+                ->set_uniform("MANIP", position_matrix());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
         program->set_uniform("radius", line_width_ * ratio * 0.5f)  // 0.5f from width -> radius
@@ -368,7 +365,7 @@ namespace easy3d {
                 ->set_uniform("invMV", inverse(camera->modelViewMatrix()))
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix());
+                ->set_uniform("MANIP", position_matrix());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
         program->set_uniform("radius", line_width_ * ratio * 0.5f)  // 0.5f from width -> radius
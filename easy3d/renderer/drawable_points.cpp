@@ -55,10 +55,7 @@ namespace easy3d {
 
 
     void PointsDrawable::draw(const Camera *camera /* = false */) const {
-        if (update_needed_ || vertex_buffer_ == 0) {
-            const_cast<PointsDrawable *>(this)->update_buffers_internal();
-            const_cast<PointsDrawable *>(this)->update_needed_ = false;
-        }
+        update_buffers_if_needed();
 
         switch (impostor_type_) {
             case PLAIN:
@@ -114,9 +111,9 @@ namespace easy3d {
         const vec4 &wLightPos = inverse(MV) * setting::light_position;
 
         // transformation introduced by manipulation
-        const mat4 MANIP = manipulated_matrix();
+        const mat4 MANIP = position_matrix();
         // needs be padded when using uniform blocks
-        const mat3 NORMAL = transform::normal_matrix(MANIP);
+        const mat3 NORMAL = transform::normal_matrix(manipulated_matrix());
 
         glPointSize(point_size());
 
@@ -145,7 +142,7 @@ namespace easy3d {
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
-        gl_draw();
+        gl_draw(camera);
         program->release();
     }
 
@@ -170,7 +167,7 @@ namespace easy3d {
         program->set_uniform("perspective", camera->type() == Camera::PERSPECTIVE)
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix())
+                ->set_uniform("MANIP", position_matrix())
                 ->set_uniform("screen_width", camera->screenWidth());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
@@ -193,7 +190,7 @@ namespace easy3d {
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
-        gl_draw();
+        gl_draw(camera);
         program->release();
 
         glDisable(GL_VERTEX_PROGRAM_POINT_SIZE); // starting from GL3.2, using GL_PROGRAM_POINT_SIZE
@@ -218,7 +215,7 @@ namespace easy3d {
         program->set_uniform("perspective", camera->type() == Camera::PERSPECTIVE)
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix());
+                ->set_uniform("MANIP", position_matrix());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
         program->set_uniform("sphere_radius", point_size() * ratio * 0.5f)  // 0.5f from size -> radius
@@ -240,7 +237,7 @@ namespace easy3d {
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
-        gl_draw();
+        gl_draw(camera);
         program->release();
     }
 
@@ -267,9 +264,9 @@ namespace easy3d {
         const vec4 &wLightPos = inverse(MV) * setting::light_position;
 
         // transformation introduced by manipulation
-        const mat4 MANIP = manipulated_matrix();
+        const mat4 MANIP = position_matrix();
         // needs be padded when using uniform blocks
-        const mat3 NORMAL = transform::normal_matrix(MANIP);
+        const mat3 NORMAL = transform::normal_matrix(manipulated_matrix());
 
         glPointSize(point_size());
 
@@ -298,7 +295,7 @@ namespace easy3d {
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
-        gl_draw();
+        gl_draw(camera);
         program->release_texture();
 
         program->release();
@@ -329,7 +326,7 @@ namespace easy3d {
         program->set_uniform("perspective", camera->type() == Camera::PERSPECTIVE)
                 ->set_uniform("MV", camera->modelViewMatrix())
                 ->set_uniform("PROJ", camera->projectionMatrix())
-                ->set_uniform("MANIP", manipulated_matrix());
+                ->set_uniform("MANIP", position_matrix());
 
         float ratio = camera->pixelGLRatio(camera->pivotPoint());
         program->set_uniform("sphere_radius", point_size() * ratio * 0.5f)  // 0.5f from size -> radius
@@ -350,7 +347,7 @@ namespace easy3d {
             setting::clipping_plane->set_program(program);
 
         program->bind_texture("textureID",texture()->id(), 0);
-        gl_draw();
+        gl_draw(camera);
         program->release_texture();
 
         program->release();
@@ -378,9 +375,9 @@ namespace easy3d {
         const vec4 &wLightPos = inverse(camera->modelViewMatrix()) * setting::light_position;
 
         // transformation introduced by manipulation
-        const mat4 MANIP = manipulated_matrix();
+        const mat4 MANIP = position_matrix();
         // needs be padded when using uniform blocks
-        const mat3 NORMAL = transform::normal_matrix(MANIP);
+        const mat3 NORMAL = transform::normal_matrix(manipulated_matrix());
 
         program->bind();
         program->set_uniform("MVP", MVP)
@@ -411,7 +408,7 @@ namespace easy3d {
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
-        gl_draw();
+        gl_draw(camera);
         program->release();
     }
 
@@ -437,9 +434,9 @@ namespace easy3d {
         const vec4 &wLightPos = inverse(camera->modelViewMatrix()) * setting::light_position;
 
         // transformation introduced by manipulation
-        const mat4 MANIP = manipulated_matrix();
+        const mat4 MANIP = position_matrix();
         // needs be padded when using uniform blocks
-        const mat3 NORMAL = transform::normal_matrix(MANIP);
+        const mat3 NORMAL = transform::normal_matrix(manipulated_matrix());
 
         program->bind();
         program->set_uniform("MVP", MVP)
@@ -465,7 +462,7 @@ namespace easy3d {
             setting::clipping_plane->set_program(program);
 
         program->bind_texture("textureID",texture()->id(), 0);
-        gl_draw();
+        gl_draw(camera);
         program->release_texture();
 
         program->release();
@@ -43,6 +43,7 @@ namespace easy3d {
             : Drawable(name, model)
             , smooth_shading_(setting::surface_mesh_phong_shading)
             , opacity_(0.6f)
+            , optimize_triangle_order_(setting::surface_mesh_optimize_triangle_order)
     {
         lighting_two_sides_ = setting::triangles_drawable_two_side_lighting;
         distinct_back_color_ = setting::triangles_drawable_distinct_backside_color;
@@ -57,10 +58,7 @@ namespace easy3d {
 
 
     void TrianglesDrawable::draw(const Camera *camera) const {
-        if (update_needed_ || vertex_buffer_ == 0) {
-            const_cast<TrianglesDrawable *>(this)->update_buffers_internal();
-            const_cast<TrianglesDrawable *>(this)->update_needed_ = false;
-        }
+        update_buffers_if_needed();
 
         ShaderProgram *program = ShaderManager::get_program("surface/surface");
         if (!program) {
@@ -85,9 +83,9 @@ namespace easy3d {
         const vec4 &wLightPos = inverse(MV) * setting::light_position;
 
         // transformation introduced by manipulation
-        const mat4 MANIP = manipulated_matrix();
+        const mat4 MANIP = position_matrix();
         // needs be padded when using uniform blocks
-        const mat3 NORMAL = transform::normal_matrix(MANIP);
+        const mat3 NORMAL = transform::normal_matrix(manipulated_matrix());
 
         program->bind();
         program->set_uniform("MVP", MVP)
@@ -125,7 +123,7 @@ namespace easy3d {
 
         if (is_ssao_enabled())
             program->bind_texture("ssaoTexture", ssao_texture_, 1);
-        gl_draw();
+        gl_draw(camera);
         if (is_ssao_enabled())
             program->release_texture();
 
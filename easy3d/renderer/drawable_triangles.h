@@ -64,12 +64,43 @@ namespace easy3d {
          */
         void set_opacity(float opacity) { opacity_ = opacity; }
 
+        /**
+         * @brief Query if the triangles are reordered for rendering efficiency when the buffers are built.
+         * @sa set_optimize_triangle_order()
+         */
+        bool optimize_triangle_order() const { return optimize_triangle_order_; }
+
+        /**
+         * @brief Enable/Disable reordering the triangles of the element buffer for rendering efficiency.
+         * @details If enabled, the triangles are reordered to make better use of the post-transform vertex cache and
+         *      to reduce overdraw (see TriangleOrderOptimizer). The triangles of each face are kept together, and
+         *      "f:triangle_range" is updated accordingly. This applies to the indexed buffers of surface meshes, and
+         *      takes effect the next time the buffers are built (e.g., after calling update()). The element buffer then
+         *      also uses 16-bit indices if the vertices allow it, and the gain can be checked using acmr() and atvr(),
+         *      which are also reported by buffer_stats(). If disabled, the element buffer is uploaded as is.
+         */
+        void set_optimize_triangle_order(bool b) { optimize_triangle_order_ = b; }
+
+        /**
+         * @brief The ranges of the element buffer of the materials of the model, one per material.
+         * @details Each range is given by its first index and the number of indices, and can be drawn using
+         *      gl_draw_range(), e.g., after binding the texture of the material. The ranges are set when the buffers
+         *      of a surface mesh with materials (i.e., the model property "material_ranges" recording the faces of
+         *      each material) are built, and the triangles of each material are kept contiguous by the reordering
+         *      (see set_optimize_triangle_order() and set_chunk_size()). Empty if the model has no materials.
+         */
+        const std::vector<std::pair<std::size_t, std::size_t> >& material_ranges() const { return material_ranges_; }
+        void set_material_ranges(const std::vector<std::pair<std::size_t, std::size_t> >& ranges) { material_ranges_ = ranges; }
+
         // Rendering.
         virtual void draw(const Camera* camera) const override;
 
 	private:
         bool    smooth_shading_;
         float   opacity_;
+        bool    optimize_triangle_order_;
+
+        std::vector<std::pair<std::size_t, std::size_t> > material_ranges_;
 	};
 
 }
@@ -30,6 +30,7 @@
 
 #include <easy3d/renderer/drawable_triangles.h>
 #include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/frame_profiler.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/shader_manager.h>
 #include <easy3d/renderer/shader_program.h>
@@ -195,7 +196,7 @@ namespace easy3d {
             program->set_uniform("MVP", MVP);
             for (auto d : surfaces) {
                 if (d->is_visible()) {
-                    program->set_uniform("MANIP", d->manipulated_matrix());
+                    program->set_uniform("MANIP", d->position_matrix());
                     if (setting::clipping_plane) {
                         setting::clipping_plane->set_program(program);
                         setting::clipping_plane->set_discard_primitives(program, d->plane_clip_discard_primitive());
@@ -241,9 +242,9 @@ namespace easy3d {
             for (auto d : surfaces) {
                 if (d->is_visible()) {
                     // transformation introduced by manipulation
-                    const mat4 MANIP = d->manipulated_matrix();
+                    const mat4 MANIP = d->position_matrix();
                     // needs be padded when using uniform blocks
-                    const mat3 NORMAL = transform::normal_matrix(MANIP);
+                    const mat3 NORMAL = transform::normal_matrix(d->manipulated_matrix());
                     program->set_uniform("MANIP", MANIP)
                             ->set_uniform( "NORMAL", NORMAL)
                             ->set_uniform("lighting", d->lighting())
@@ -316,6 +317,7 @@ namespace easy3d {
     void DualDepthPeeling::draw(const std::vector<TrianglesDrawable*>& surfaces) {
         if (surfaces.empty())
             return;
+        FrameProfiler::Scope scope("dual_depth_peeling");
 
         int viewport[4];
         glGetIntegerv(GL_VIEWPORT, viewport);
@@ -333,7 +335,10 @@ namespace easy3d {
         // ---------------------------------------------------------------------
 
         stage_ = DDP_InitDepth;
-        init_depth_buffers(surfaces);
+        {
+            FrameProfiler::Scope pass("init_depth");
+            init_depth_buffers(surfaces);
+        }
 
         // ---------------------------------------------------------------------
         // 2. Dual Depth Peeling + Blending
@@ -348,6 +353,7 @@ namespace easy3d {
         glClear(GL_COLOR_BUFFER_BIT);
 
         while (!peeling_done()) {
+            FrameProfiler::Scope pass("peel");
             peel(surfaces);
             swap_targets();
         }
@@ -359,7 +365,10 @@ namespace easy3d {
         // ---------------------------------------------------------------------
 
         stage_ = DDP_Blend;
-        blend_final_image();
+        {
+            FrameProfiler::Scope pass("blend");
+            blend_final_image();
+        }
 
         //////////////////////////////////////////////////////////////////////////
 
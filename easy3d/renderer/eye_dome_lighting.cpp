@@ -28,6 +28,7 @@
 #include <easy3d/renderer/shader_manager.h>
 #include <easy3d/renderer/shader_program.h>
 #include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/frame_profiler.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/shapes.h>
 #include <easy3d/renderer/camera.h>
@@ -277,6 +278,8 @@ namespace easy3d {
 
     void EyeDomeLighting::begin()
     {
+        FrameProfiler::Scope scope("eye_dome_lighting_begin");
+
         int viewport[4];
         glGetIntegerv(GL_VIEWPORT, viewport);
         width_ = viewport[2];
@@ -306,17 +309,27 @@ namespace easy3d {
 
     void EyeDomeLighting::end()
     {
+        FrameProfiler::Scope scope("eye_dome_lighting");
         projection_fbo_->release();
 
         // full resolution pass
-        shade_high(camera_->sceneRadius());
+        {
+            FrameProfiler::Scope pass("shade_high");
+            shade_high(camera_->sceneRadius());
+        }
 
         // low resolution + blur pass
-        shade_low();
-        blur_low();
+        {
+            FrameProfiler::Scope pass("shade_low");
+            shade_low();
+            blur_low();
+        }
 
         // compositing pass (in original framebuffer)
-        compose();
+        {
+            FrameProfiler::Scope pass("compose");
+            compose();
+        }
     }
 
 
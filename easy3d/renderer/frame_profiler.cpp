@@ -0,0 +1,383 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/renderer/frame_profiler.h>
+
+#include <chrono>
+#include <algorithm>
+
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+    FrameProfiler *FrameProfiler::active_ = nullptr;
+
+
+    namespace details {
+
+        double steady_clock_ms() {
+            using namespace std::chrono;
+            return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        double mean(const std::deque<double> &values) {
+            if (values.empty())
+                return 0.0;
+            double sum = 0.0;
+            for (auto v : values)
+                sum += v;
+            return sum / static_cast<double>(values.size());
+        }
+
+        // the smallest value that is not exceeded by 95% of the values
+        double p95(const std::deque<double> &values) {
+            if (values.empty())
+                return 0.0;
+            std::vector<double> sorted(values.begin(), values.end());
+            const std::size_t k = (sorted.size() * 95 + 99) / 100 - 1;
+            std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+            return sorted[k];
+        }
+
+    }
+
+
+    FrameProfiler::Scope::Scope(const std::string &name, bool drawable) : profiler_(FrameProfiler::active()) {
+        // the drawables are recorded (in both profilers) only if the active profiler times them
+        if (drawable && !(profiler_ && profiler_->drawable_timing())) {
+            profiler_ = nullptr;
+            return;
+        }
+        if (profiler_)
+            profiler_->begin_scope(name);
+#ifndef EASY3D_DISABLE_PROFILER
+        if (Profiler::is_recording())
+            zone_.reset(new Profiler::Zone(Profiler::intern(name)));
+#endif
+    }
+
+
+    FrameProfiler::Scope::~Scope() {
+        zone_.reset();
+        // the frame may have been ended in the scope
+        if (profiler_ && profiler_ == FrameProfiler::active())
+            profiler_->end_scope();
+    }
+
+
+    FrameProfiler::FrameProfiler(std::size_t history)
+            : enabled_(true), gpu_timing_(true), drawable_timing_(false), history_(std::max<std::size_t>(history, 1)),
+              clock_(details::steady_clock_ms), in_frame_(false), num_frames_(0) {
+        clear();
+    }
+
+
+    FrameProfiler::~FrameProfiler() {
+        if (active_ == this)
+            active_ = nullptr;
+        if (!all_queries_.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(all_queries_.size()), all_queries_.data());  easy3d_debug_log_gl_error;
+        }
+    }
+
+
+    void FrameProfiler::set_history(std::size_t n) {
+        history_ = std::max<std::size_t>(n, 1);
+        clear();
+    }
+
+
+    void FrameProfiler::set_clock(const std::function<double()> &clock) {
+        clock_ = clock ? clock : std::function<double()>(details::steady_clock_ms);
+    }
+
+
+    bool FrameProfiler::gpu_supported() const {
+        // GLEW reports nothing before the rendering context has been created
+        return (GLEW_VERSION_3_3 || GLEW_ARB_timer_query) && glQueryCounter && glGetQueryObjectui64v;
+    }
+
+
+    unsigned int FrameProfiler::acquire_query() {
+        if (free_queries_.empty()) {
+            std::vector<GLuint> ids(64, 0);
+            glGenQueries(static_cast<GLsizei>(ids.size()), ids.data());   easy3d_debug_log_gl_error;
+            free_queries_.insert(free_queries_.end(), ids.begin(), ids.end());
+            all_queries_.insert(all_queries_.end(), ids.begin(), ids.end());
+        }
+        const unsigned int id = free_queries_.back();
+        free_queries_.pop_back();
+        glQueryCounter(id, GL_TIMESTAMP);
+        return id;
+    }
+
+
+    void FrameProfiler::release_queries(Frame &frame) {
+        for (auto &e : frame.events) {
+            if (e.query_begin) free_queries_.push_back(e.query_begin);
+            if (e.query_end) free_queries_.push_back(e.query_end);
+            e.query_begin = e.query_end = 0;
+        }
+    }
+
+
+    std::size_t FrameProfiler::child(std::size_t parent, const std::string &name) {
+        for (auto c : nodes_[parent].children) {
+            if (nodes_[c].name == name)
+                return c;
+        }
+        Node node;
+        node.name = name;
+        node.parent = parent;
+        node.depth = nodes_[parent].depth + 1;
+        node.count = 0;
+        nodes_.push_back(node);
+        nodes_[parent].children.push_back(nodes_.size() - 1);
+        return nodes_.size() - 1;
+    }
+
+
+    void FrameProfiler::push(std::deque<double> &window, double value) const {
+        window.push_back(value);
+        while (window.size() > history_)
+            window.pop_front();
+    }
+
+
+    void FrameProfiler::begin_frame() {
+        if (in_frame_)
+            end_frame();
+        if (!enabled_)
+            return;
+
+        in_frame_ = true;
+        active_ = this;
+        current_.events.clear();
+        current_.has_gpu = gpu_timing_ && gpu_supported();
+        stack_.clear();
+
+        Event e;
+        e.node = 0;
+        e.cpu_begin = clock_();
+        e.cpu_end = e.cpu_begin;
+        e.query_begin = current_.has_gpu ? acquire_query() : 0;
+        e.query_end = 0;
+        e.gpu_begin = e.gpu_end = 0.0;
+        current_.events.push_back(e);
+        stack_.push_back(0);
+    }
+
+
+    void FrameProfiler::begin_scope(const std::string &name) {
+        if (!in_frame_)
+            return;
+        Event e;
+        e.node = child(current_.events[stack_.back()].node, name);
+        e.query_begin = current_.has_gpu ? acquire_query() : 0;
+        e.query_end = 0;
+        e.gpu_begin = e.gpu_end = 0.0;
+        e.cpu_begin = clock_();
+        e.cpu_end = e.cpu_begin;
+        current_.events.push_back(e);
+        stack_.push_back(current_.events.size() - 1);
+    }
+
+
+    void FrameProfiler::end_scope() {
+        if (!in_frame_ || stack_.size() < 2)    // the frame itself is closed by end_frame()
+            return;
+        Event &e = current_.events[stack_.back()];
+        e.cpu_end = clock_();
+        if (current_.has_gpu)
+            e.query_end = acquire_query();
+        stack_.pop_back();
+    }
+
+
+    void FrameProfiler::end_frame() {
+        if (!in_frame_)
+            return;
+        while (stack_.size() > 1)
+            end_scope();
+        Event &e = current_.events[0];
+        e.cpu_end = clock_();
+        if (current_.has_gpu)
+            e.query_end = acquire_query();
+        stack_.clear();
+        in_frame_ = false;
+        if (active_ == this)
+            active_ = nullptr;
+
+        ++num_frames_;
+        accumulate(current_, false);
+        if (current_.has_gpu) {
+            pending_.push_back(current_);
+            resolve();
+        } else
+            archive(current_);
+    }
+
+
+    void FrameProfiler::accumulate(const Frame &frame, bool gpu) {
+        std::vector<double> time(nodes_.size(), 0.0);
+        std::vector<std::size_t> count(nodes_.size(), 0);
+        for (const auto &e : frame.events) {
+            time[e.node] += gpu ? (e.gpu_end - e.gpu_begin) : (e.cpu_end - e.cpu_begin);
+            ++count[e.node];
+        }
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            if (count[i] == 0)
+                continue;
+            if (gpu)
+                push(nodes_[i].gpu, time[i]);
+            else {
+                push(nodes_[i].cpu, time[i]);
+                nodes_[i].count = count[i];
+            }
+        }
+    }
+
+
+    void FrameProfiler::resolve() {
+        // keep a few frames in flight, and wait only if the GPU is lagging far behind
+        static const std::size_t max_pending = 4;
+        while (!pending_.empty()) {
+            Frame &frame = pending_.front();
+            // the results of a query being available implies those of all the previous ones are also available
+            GLuint available = 0;
+            glGetQueryObjectuiv(frame.events[0].query_end, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available && pending_.size() <= max_pending)
+                break;
+
+            GLuint64 origin = 0;
+            glGetQueryObjectui64v(frame.events[0].query_begin, GL_QUERY_RESULT, &origin);
+            for (auto &e : frame.events) {
+                GLuint64 t0 = 0, t1 = 0;
+                glGetQueryObjectui64v(e.query_begin, GL_QUERY_RESULT, &t0);
+                glGetQueryObjectui64v(e.query_end, GL_QUERY_RESULT, &t1);
+                // aligned with the beginning of the frame on the CPU
+                e.gpu_begin = frame.events[0].cpu_begin + static_cast<double>(t0 - origin) * 1e-6;
+                e.gpu_end = frame.events[0].cpu_begin + static_cast<double>(t1 - origin) * 1e-6;
+            }
+            easy3d_debug_log_gl_error;
+            release_queries(frame);
+            accumulate(frame, true);
+            archive(frame);
+            pending_.pop_front();
+        }
+    }
+
+
+    void FrameProfiler::archive(Frame &frame) {
+        frames_.push_back(Frame());
+        frames_.back().events.swap(frame.events);
+        frames_.back().has_gpu = frame.has_gpu;
+        while (frames_.size() > history_)
+            frames_.pop_front();
+    }
+
+
+    std::vector<FrameProfiler::Statistics> FrameProfiler::statistics() const {
+        std::vector<Statistics> result;
+        std::vector<std::pair<std::size_t, std::string> > stack = {{0, nodes_[0].name}};
+        while (!stack.empty()) {
+            const std::size_t id = stack.back().first;
+            const std::string path = stack.back().second;
+            stack.pop_back();
+
+            const Node &node = nodes_[id];
+            if (!node.cpu.empty()) {
+                Statistics s;
+                s.name = node.name;
+                s.path = path;
+                s.depth = node.depth;
+                s.count = node.count;
+                s.frames = node.cpu.size();
+                s.cpu_last = node.cpu.back();
+                s.cpu_mean = details::mean(node.cpu);
+                s.cpu_p95 = details::p95(node.cpu);
+                s.has_gpu = !node.gpu.empty();
+                s.gpu_last = s.has_gpu ? node.gpu.back() : 0.0;
+                s.gpu_mean = details::mean(node.gpu);
+                s.gpu_p95 = details::p95(node.gpu);
+                result.push_back(s);
+            }
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it)
+                stack.emplace_back(*it, path + "/" + nodes_[*it].name);
+        }
+        return result;
+    }
+
+
+    bool FrameProfiler::save_chrome_trace(const std::string &file_name) const {
+        TraceWriter writer;
+        writer.add_thread(0, "CPU");
+        writer.add_thread(1, "GPU");
+        const double origin = frames_.empty() ? 0.0 : frames_.front().events[0].cpu_begin;
+        for (const auto &frame : frames_) {
+            for (int tid = 0; tid < (frame.has_gpu ? 2 : 1); ++tid) {
+                for (const auto &e : frame.events) {
+                    const double begin = tid == 0 ? e.cpu_begin : e.gpu_begin;
+                    const double end = tid == 0 ? e.cpu_end : e.gpu_end;
+                    // in microseconds
+                    writer.add_event(nodes_[e.node].name, tid == 0 ? "cpu" : "gpu", tid, (begin - origin) * 1000.0,
+                                     (end - begin) * 1000.0);
+                }
+            }
+        }
+        return writer.save(file_name);
+    }
+
+
+    void FrameProfiler::clear() {
+        for (auto &frame : pending_)
+            release_queries(frame);
+        pending_.clear();
+        frames_.clear();
+        if (in_frame_) {
+            release_queries(current_);
+            in_frame_ = false;
+            if (active_ == this)
+                active_ = nullptr;
+        }
+        current_.events.clear();
+        stack_.clear();
+        num_frames_ = 0;
+
+        nodes_.clear();
+        Node root;
+        root.name = "frame";
+        root.parent = 0;
+        root.depth = 0;
+        root.count = 0;
+        nodes_.push_back(root);
+    }
+
+}
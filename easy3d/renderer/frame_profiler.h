@@ -0,0 +1,228 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_RENDERER_FRAME_PROFILER_H
+#define EASY3D_RENDERER_FRAME_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+#include <easy3d/util/profiler.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Records the CPU and GPU time spent in each frame, each render pass, and (optionally) each drawable.
+     * \class FrameProfiler easy3d/renderer/frame_profiler.h
+     * \details A frame is enclosed by begin_frame() and end_frame(), within which named scopes can be nested. The
+     *      CPU time of a scope is measured with the clock (a steady clock by default, see set_clock()). If GPU timing
+     *      is enabled and supported, a timestamp query is also issued at the beginning and the end of each scope.
+     *      The query results are collected a few frames later, when they are available, so the rendering is never
+     *      stalled. Scopes with the same name and the same parent are merged, and the time spent in them is
+     *      accumulated over a rolling window of frames, from which the mean and the 95th percentile are computed.
+     *      The recorded frames can also be saved in the Chrome trace format (viewable in chrome://tracing or
+     *      https://ui.perfetto.dev).
+     *
+     *      The profiler is meant to be used by the rendering thread only. The render passes are instrumented with
+     *      FrameProfiler::Scope, which does nothing unless a frame of a profiler is being recorded or the
+     *      hierarchical Profiler is recording (the render passes then appear among the other zones).
+     *
+     *      Usage example:
+     *      \code
+     *      profiler.begin_frame();
+     *      {
+     *          FrameProfiler::Scope scope("shadow");
+     *          ...
+     *      }
+     *      profiler.end_frame();
+     *      for (const auto& s : profiler.statistics())
+     *          std::cout << std::string(s.depth * 2, ' ') << s.name << ": " << s.cpu_mean << " ms" << std::endl;
+     *      \endcode
+     * \see Profiler
+     */
+    class FrameProfiler {
+    public:
+        /// The statistics of a scope over the frames in the rolling window. All the times are in milliseconds.
+        struct Statistics {
+            std::string name;   ///< The name of the scope.
+            std::string path;   ///< The names of the enclosing scopes and the scope, separated by '/'.
+            int depth;          ///< The nesting depth. The whole frame has depth 0.
+            std::size_t count;  ///< The number of times the scope was entered in the last frame it appeared.
+            std::size_t frames; ///< The number of frames (in the rolling window) in which the scope appeared.
+            double cpu_last, cpu_mean, cpu_p95;
+            bool has_gpu;       ///< Whether the GPU times are available.
+            double gpu_last, gpu_mean, gpu_p95;
+        };
+
+        /**
+         * \brief A scope that is recorded by the active profiler (i.e., the one whose frame is being recorded)
+         *      from its construction to its destruction. It is also recorded as a zone of the hierarchical
+         *      Profiler, if that one is recording.
+         */
+        class Scope {
+        public:
+            /**
+             * \param name The name of the scope.
+             * \param drawable \c true if the scope encloses a single drawable. It is then recorded only if the
+             *      drawable timing of the active profiler is enabled (see set_drawable_timing()).
+             */
+            explicit Scope(const std::string &name, bool drawable = false);
+            ~Scope();
+        private:
+            Scope(const Scope &);
+            Scope &operator=(const Scope &);
+            FrameProfiler *profiler_;
+            std::unique_ptr<Profiler::Zone> zone_;
+        };
+
+    public:
+        /// \param history The number of frames in the rolling window.
+        explicit FrameProfiler(std::size_t history = 120);
+        /// The rendering context must be current if GPU timing has been used.
+        ~FrameProfiler();
+
+        void set_enabled(bool b) { enabled_ = b; }
+        bool is_enabled() const { return enabled_; }
+
+        /// Enables/Disables GPU timing. It is effective only if timestamp queries are supported.
+        void set_gpu_timing(bool b) { gpu_timing_ = b; }
+        bool gpu_timing() const { return gpu_timing_; }
+
+        /// Enables/Disables the timing of individual drawables (see Scope). Disabled by default.
+        void set_drawable_timing(bool b) { drawable_timing_ = b; }
+        bool drawable_timing() const { return drawable_timing_; }
+
+        /// Sets the number of frames in the rolling window. The recorded statistics are cleared.
+        void set_history(std::size_t n);
+        std::size_t history() const { return history_; }
+
+        /**
+         * \brief Replaces the clock that measures the CPU time.
+         * \param clock A function returning the current time in milliseconds. An empty function restores the
+         *      default steady clock.
+         */
+        void set_clock(const std::function<double()> &clock);
+
+        /// Starts recording a frame. This profiler becomes the active one.
+        void begin_frame();
+        /// Stops recording the current frame. The scopes that are still open are closed.
+        void end_frame();
+        /// Whether a frame is being recorded.
+        bool in_frame() const { return in_frame_; }
+
+        /// Opens a scope nested in the current one. It is ignored outside a frame.
+        void begin_scope(const std::string &name);
+        /// Closes the current scope. It is ignored outside a frame.
+        void end_scope();
+
+        /// The profiler whose frame is being recorded, or \c nullptr.
+        static FrameProfiler *active() { return active_; }
+
+        /// The number of frames recorded since construction or the last clear().
+        std::size_t num_frames() const { return num_frames_; }
+
+        /**
+         * \brief The statistics of the whole frame (the first entry, named "frame") and all the scopes. The entries
+         *      are in depth-first order, and the children of a scope are in the order they first appeared.
+         */
+        std::vector<Statistics> statistics() const;
+
+        /**
+         * \brief Saves the frames in the rolling window in the Chrome trace (JSON) format. The CPU scopes are on
+         *      thread 0 and the GPU scopes are on thread 1. The GPU timestamps are aligned with the beginning of
+         *      the frame on the CPU.
+         */
+        bool save_chrome_trace(const std::string &file_name) const;
+
+        /// Clears all the recorded frames and statistics.
+        void clear();
+
+    private:
+        // a scope recorded in a frame
+        struct Event {
+            std::size_t node;
+            double cpu_begin, cpu_end;
+            unsigned int query_begin, query_end;
+            double gpu_begin, gpu_end;
+        };
+
+        struct Frame {
+            std::vector<Event> events;  // events[0] is the whole frame
+            bool has_gpu;
+        };
+
+        // a scope merged over the frames
+        struct Node {
+            std::string name;
+            std::size_t parent;
+            int depth;
+            std::vector<std::size_t> children;
+            std::size_t count;
+            std::deque<double> cpu;
+            std::deque<double> gpu;
+        };
+
+        std::size_t child(std::size_t parent, const std::string &name);
+        void push(std::deque<double> &window, double value) const;
+        void accumulate(const Frame &frame, bool gpu);
+        // collects the GPU times of the pending frames
+        void resolve();
+        void archive(Frame &frame);
+        unsigned int acquire_query();
+        void release_queries(Frame &frame);
+        bool gpu_supported() const;
+
+    private:
+        bool enabled_;
+        bool gpu_timing_;
+        bool drawable_timing_;
+        std::size_t history_;
+        std::function<double()> clock_;
+
+        bool in_frame_;
+        Frame current_;
+        std::vector<std::size_t> stack_;    // the open events of the current frame
+        std::deque<Frame> pending_;         // frames waiting for their GPU times
+        std::deque<Frame> frames_;          // the recent frames (for the trace)
+        std::vector<unsigned int> free_queries_;
+        std::vector<unsigned int> all_queries_;
+
+        std::vector<Node> nodes_;
+        std::size_t num_frames_;
+
+        static FrameProfiler *active_;
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_FRAME_PROFILER_H
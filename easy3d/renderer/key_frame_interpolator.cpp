@@ -36,9 +36,6 @@
 
 #include <easy3d/renderer/key_frame_interpolator.h>
 
-#include <chrono>
-#include <thread>
-
 #include <easy3d/renderer/frame.h>
 #include <easy3d/renderer/drawable_lines.h>
 #include <easy3d/renderer/drawable_triangles.h>
@@ -213,40 +210,44 @@ namespace easy3d {
 
 
     void KeyFrameInterpolator::start_interpolation() {
-        auto animation = [this]() {
-            // interval in ms (0.9 to approximately compensate the overhead the timer thread and viewer update)
-            const int interval = static_cast<int>(1000.0f / frame_rate() * 0.9f);
-            for (int id = last_stopped_index_; id < interpolated_path_.size(); ++id) {
-                if (timer_.is_stopped()) {
-                    last_stopped_index_ = id;
-                    break;
-                }
-                const auto &f = interpolated_path_[id];
-                frame()->setPositionAndOrientation(f.position(), f.orientation());
-                std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-                if (id == interpolated_path_.size() - 1)  // reaches the end frame
-                    last_stopped_index_ = 0;
-                frame_interpolated.send();
-            }
-            interpolation_stopped.send();
-            interpolation_started_ = false;
-        };
-
         if (keyframes_.empty())
             return;
 
         if (!pathIsValid_)
             interpolate();
 
-        // all done in another thread.
+        if (interpolated_path_.empty())
+            return;
+
+        // one frame per tick of the timer, so the (shared) timer thread is never blocked by the animation
+        auto animation = [this]() {
+            const int num_frames = static_cast<int>(interpolated_path_.size());
+            if (last_stopped_index_ >= num_frames)
+                last_stopped_index_ = 0;
+            const auto &f = interpolated_path_[last_stopped_index_];
+            frame()->setPositionAndOrientation(f.position(), f.orientation());
+            ++last_stopped_index_;
+            frame_interpolated.send();
+
+            if (last_stopped_index_ == num_frames) {  // reaches the end frame
+                last_stopped_index_ = 0;
+                timer_.stop();
+                interpolation_started_ = false;
+                interpolation_stopped.send();
+            }
+        };
+
         interpolation_started_ = true;
-        timer_.set_timeout(0, animation);
+        timer_.set_interval(interpolation_period(), animation);
     }
 
 
     void KeyFrameInterpolator::stop_interpolation() {
         timer_.stop();
-        interpolation_started_ = false;
+        if (interpolation_started_) {
+            interpolation_started_ = false;
+            interpolation_stopped.send();
+        }
     }
 
 
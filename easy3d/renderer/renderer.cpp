@@ -158,6 +158,11 @@ namespace easy3d {
             drawable->set_property_coloring(State::VERTEX, "v:color");
             return;
         }
+        // colors may also be stored in 8-bit (see LoadOptions)
+        if (model->get_vertex_property<u8vec3>("v:color_u8")) {
+            drawable->set_property_coloring(State::VERTEX, "v:color_u8");
+            return;
+        }
 
         auto texcoord = model->get_vertex_property<vec2>("v:texcoord");
         if (texcoord) {
@@ -176,6 +181,7 @@ namespace easy3d {
         const auto properties = model->vertex_properties();
         for (const auto& name : properties) {
             if (model->get_vertex_property<int>(name) || model->get_vertex_property<unsigned int>(name) ||
+                model->get_vertex_property<unsigned short>(name) || model->get_vertex_property<unsigned char>(name) ||
                 model->get_vertex_property<float>(name)) {
                 drawable->set_scalar_coloring(State::VERTEX, name);
                 return;
@@ -205,12 +211,21 @@ namespace easy3d {
             drawable->set_property_coloring(State::FACE, "f:color");
             return;
         }
+        // colors may also be stored in 8-bit (see LoadOptions)
+        if (model->get_face_property<u8vec3>("f:color_u8")) {
+            drawable->set_property_coloring(State::FACE, "f:color_u8");
+            return;
+        }
 
         auto vertex_colors = model->get_vertex_property<vec3>("v:color");
         if (vertex_colors) {
             drawable->set_property_coloring(State::VERTEX, "v:color");
             return;
         }
+        if (model->get_vertex_property<u8vec3>("v:color_u8")) {
+            drawable->set_property_coloring(State::VERTEX, "v:color_u8");
+            return;
+        }
 
         auto halfedge_texcoords = model->get_halfedge_property<vec2>("h:texcoord");
         if (halfedge_texcoords) {
@@ -235,6 +250,7 @@ namespace easy3d {
         const auto face_properties = model->face_properties();
         for (const auto& name : face_properties) {
             if (model->get_face_property<int>(name) || model->get_face_property<unsigned int>(name) ||
+                model->get_face_property<unsigned short>(name) || model->get_face_property<unsigned char>(name) ||
                 model->get_face_property<float>(name)) {
                 drawable->set_scalar_coloring(State::FACE, name);
                 return;
@@ -245,6 +261,7 @@ namespace easy3d {
         const auto vertex_properties = model->vertex_properties();
         for (const auto& name : vertex_properties) {
             if (model->get_vertex_property<int>(name) || model->get_vertex_property<unsigned int>(name) ||
+                model->get_vertex_property<unsigned short>(name) || model->get_vertex_property<unsigned char>(name) ||
                 model->get_vertex_property<float>(name)) {
                 drawable->set_scalar_coloring(State::VERTEX, name);
                 return;
@@ -266,6 +283,18 @@ namespace easy3d {
     }
 
 
+    memory::Usage Renderer::memory_usage() const {
+        memory::Usage usage("drawables");
+        for (auto d : points_drawables_)
+            usage.add(d->memory_usage());
+        for (auto d : lines_drawables_)
+            usage.add(d->memory_usage());
+        for (auto d : triangles_drawables_)
+            usage.add(d->memory_usage());
+        return usage;
+    }
+
+
     void Renderer::update() {
         for (auto d : points_drawables_)
             d->update();
@@ -273,6 +302,23 @@ namespace easy3d {
             d->update();
         for (auto d : triangles_drawables_)
             d->update();
+        if (model_) {
+            model_->invalidate_bounding_box();  // the geometry may have changed
+            model_->clear_modified();
+        }
+    }
+
+
+    void Renderer::update_modified() {
+        if (!model_)
+            return;
+        for (auto d : points_drawables_)
+            d->update_modified();
+        for (auto d : lines_drawables_)
+            d->update_modified();
+        for (auto d : triangles_drawables_)
+            d->update_modified();
+        model_->clear_modified();
     }
 
 
@@ -96,12 +96,23 @@ namespace easy3d {
          * @brief Invalidates the rendering buffers of the model and thus updates the rendering (delayed in rendering).
          * @details This method triggers an update of the rendering buffers of all the drawables of the model to which
          *      this renderer is attached. The effect is equivalent to calling Drawable::update() functions for all
-         *      the drawables of this model.
-         * todo: for better performance, it is wise to update only the affected drawables and buffers.
-         * \sa  Drawable::update()
+         *      the drawables of this model. Use this method if the topology of the model has changed. If only the
+         *      values of some properties changed (e.g., some vertices were moved), record the modifications using
+         *      Model::mark_modified() and call update_modified() instead. The bounding box of the model is also
+         *      invalidated (see Model::invalidate_bounding_box()).
+         * \sa  Drawable::update(), update_modified()
          */
         void update();
 
+        /**
+         * @brief Updates only the parts of the rendering buffers affected by the modifications recorded on the model.
+         * @details The modifications are recorded using Model::mark_modified(). Each drawable uploads only the modified
+         *      ranges of its buffers (if its buffer layout allows it, otherwise it rebuilds all its buffers). The
+         *      actual update is delayed to the rendering phase, and the recorded modifications are cleared.
+         * \sa  Drawable::update_modified(), update()
+         */
+        void update_modified();
+
         //-------------------- drawable management  -----------------------
 
         /**
@@ -161,6 +172,11 @@ namespace easy3d {
          */
         const std::vector<TrianglesDrawable *> &triangles_drawables() const { return triangles_drawables_; }
 
+        /**
+         * The GPU memory used by all the drawables managed by this renderer, one child per drawable.
+         */
+        memory::Usage memory_usage() const;
+
     public:
         /**
          * @brief Create default drawables for rendering.
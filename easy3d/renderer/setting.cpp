@@ -60,6 +60,14 @@ namespace easy3d {
         vec4 material_specular = vec4(0.4f, 0.4f, 0.4f, 1.0f);
         float material_shininess = 64.0f;
 
+        // chunking and culling of large drawables
+        std::size_t drawable_chunk_size = 0;
+        float drawable_culling_min_pixels = 1.0f;
+        std::size_t drawable_batching_threshold = 100;
+
+        // cache the linked shader programs on disk
+        bool shader_binary_cache = true;
+
         // effect
         int effect_ssao_algorithm = 0; // disabled
         float effect_ssao_radius = 2.0f;
@@ -86,6 +94,7 @@ namespace easy3d {
         vec4 surface_mesh_faces_color = vec4(1.0f, 0.8f, 0.4f, 1.0f);
         bool surface_mesh_use_color_property = true;
         float surface_mesh_opacity = 0.6f;
+        bool surface_mesh_optimize_triangle_order = false;
 
         // surface mesh - vertices
         bool surface_mesh_show_vertices = false;
@@ -68,6 +68,16 @@ namespace easy3d {
         extern vec4 material_specular;
         extern float material_shininess;    // specular power
 
+        // chunking and culling of large drawables
+        extern std::size_t drawable_chunk_size;     // max number of primitives in each chunk (0 disables chunking)
+        extern float drawable_culling_min_pixels;   // chunks smaller than this on the screen are not drawn
+        // batching of the drawables of many small models (see DrawableBatcher)
+        extern std::size_t drawable_batching_threshold; // min number of models for the viewer to batch (0 disables)
+
+        // cache the linked shader programs on disk (in "~/.easy3d/shader_cache") to speed up the startup. The programs
+        // used in previous sessions are recompiled in background if outdated, programs never used are not prewarmed.
+        extern bool shader_binary_cache;
+
         // effect
         extern int effect_ssao_algorithm;
         extern float effect_ssao_radius;
@@ -94,6 +104,7 @@ namespace easy3d {
         extern vec4 surface_mesh_faces_color;
         extern bool surface_mesh_use_color_property;
         extern float surface_mesh_opacity;
+        extern bool surface_mesh_optimize_triangle_order;   // reorder triangles for the vertex cache and overdraw, 16-bit indices
         // surface mesh - vertices
         extern bool surface_mesh_show_vertices;
         extern vec4 surface_mesh_vertices_color;
@@ -25,7 +25,18 @@
  ********************************************************************/
 
 #include <easy3d/renderer/shader_manager.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+
+#include <easy3d/renderer/opengl.h>
 #include <easy3d/renderer/opengl_error.h>
+#include <easy3d/renderer/opengl_info.h>
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/string.h>
@@ -36,6 +47,295 @@ namespace easy3d {
 
     std::unordered_map<std::string, ShaderProgram*>     ShaderManager::programs_;
     std::unordered_map<std::string, bool>				ShaderManager::attempt_load_program_; // avoid multiple attempt
+    std::string                                         ShaderManager::binary_cache_directory_;
+
+
+    namespace details {
+
+        // how a program is created from shader files. This is also what the manifest of the binary cache records.
+        struct ProgramRecipe {
+            std::string name;
+            bool expand_includes;   // base name version: "#include" is expanded; otherwise, extra code is inserted
+            std::string files[3];   // the vertex, fragment, and geometry shader files (relative to the shader dir)
+            std::string extra[3];   // the extra code of each shader
+            std::vector<ShaderProgram::Attribute> attributes;
+            std::vector<std::string> outputs;
+        };
+
+
+        // FNV-1a, which (unlike std::hash) gives the same value across sessions and platforms
+        inline uint64_t hash(uint64_t h, const std::string& str) {
+            for (unsigned char c : str) {
+                h ^= c;
+                h *= 1099511628211ull;
+            }
+            // also hash the length to separate the fields
+            for (std::size_t n = str.size(), i = 0; i < sizeof(n); ++i, n >>= 8) {
+                h ^= static_cast<unsigned char>(n & 0xff);
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+
+
+        // escapes the tabs and line breaks, such that a recipe can be stored in a single line of the manifest
+        inline std::string escape(const std::string& str) {
+            std::string result;
+            result.reserve(str.size());
+            for (char c : str) {
+                switch (c) {
+                    case '\\': result += "\\\\"; break;
+                    case '\t': result += "\\t"; break;
+                    case '\n': result += "\\n"; break;
+                    case '\r': result += "\\r"; break;
+                    default: result += c;
+                }
+            }
+            return result;
+        }
+
+
+        inline std::string unescape(const std::string& str) {
+            std::string result;
+            result.reserve(str.size());
+            for (std::size_t i = 0; i < str.size(); ++i) {
+                if (str[i] != '\\' || i + 1 == str.size()) {
+                    result += str[i];
+                    continue;
+                }
+                switch (str[++i]) {
+                    case 't': result += '\t'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    default: result += str[i];
+                }
+            }
+            return result;
+        }
+
+
+        // one line of the manifest: the fields are separated by tabs
+        std::string to_string(const ProgramRecipe& recipe) {
+            std::string attributes;
+            for (const auto& a : recipe.attributes)
+                attributes += (attributes.empty() ? "" : ",") + std::to_string(a.first) + " " + a.second;
+            std::string outputs;
+            for (const auto& o : recipe.outputs)
+                outputs += (outputs.empty() ? "" : ",") + o;
+
+            std::string line = escape(recipe.name) + "\t" + (recipe.expand_includes ? "1" : "0");
+            for (int i = 0; i < 3; ++i)
+                line += "\t" + escape(recipe.files[i]) + "\t" + escape(recipe.extra[i]);
+            return line + "\t" + escape(attributes) + "\t" + escape(outputs);
+        }
+
+
+        bool from_string(const std::string& line, ProgramRecipe& recipe) {
+            std::vector<std::string> fields;
+            string::split(line, '\t', fields, false);
+            if (fields.size() != 10)
+                return false;
+            recipe.name = unescape(fields[0]);
+            recipe.expand_includes = (fields[1] == "1");
+            for (int i = 0; i < 3; ++i) {
+                recipe.files[i] = unescape(fields[2 + i * 2]);
+                recipe.extra[i] = unescape(fields[3 + i * 2]);
+            }
+
+            recipe.attributes.clear();
+            std::vector<std::string> items;
+            string::split(unescape(fields[8]), ',', items, true);
+            for (const auto& item : items) {
+                std::istringstream in(item);
+                int index = -1;
+                std::string name;
+                if (!(in >> index >> name) || index < 0)
+                    return false;
+                recipe.attributes.emplace_back(static_cast<ShaderProgram::AttribType>(index), name);
+            }
+            recipe.outputs.clear();
+            string::split(unescape(fields[9]), ',', recipe.outputs, true);
+            return true;
+        }
+
+
+        // reads the complete source code of each shader of a program (empty if the shader is not used)
+        bool read_sources(const ProgramRecipe& recipe, std::string sources[3]) {
+            const std::string dir = resource::directory() + "/shaders/";
+            for (int i = 0; i < 3; ++i) {
+                sources[i].clear();
+                if (recipe.files[i].empty())
+                    continue;
+                const std::string file = dir + recipe.files[i];
+                if (recipe.expand_includes)
+                    sources[i] = ShaderProgram::load_shader_source(file);
+                else {
+                    file_system::read_file_to_string(file, sources[i]);
+                    if (!recipe.extra[i].empty())
+                        string::replace(sources[i], "//INSERT", recipe.extra[i]);
+                }
+                if (sources[i].empty()) {
+                    LOG(ERROR) << "failed reading shader file \'" << file << "\'";
+                    return false;
+                }
+            }
+            return true;
+        }
+
+
+        // the file storing the binary of a program, identified by its sources, its bindings, and the driver
+        std::string binary_file(const std::string& dir, const ProgramRecipe& recipe, const std::string sources[3]) {
+            uint64_t h = 14695981039346656037ull;
+            h = hash(h, OpenglInfo::gl_vendor());
+            h = hash(h, OpenglInfo::gl_renderer());
+            h = hash(h, OpenglInfo::gl_version());
+            h = hash(h, OpenglInfo::glsl_version());
+            for (int i = 0; i < 3; ++i)
+                h = hash(h, sources[i]);
+            for (const auto& a : recipe.attributes)
+                h = hash(h, std::to_string(a.first) + " " + a.second);
+            for (const auto& o : recipe.outputs)
+                h = hash(h, o);
+
+            std::ostringstream name;
+            name << std::hex << h;
+            return dir + "/" + name.str() + ".bin";
+        }
+
+
+        // compiles and links a program. With 'cacheable', the driver is told that the binary will be retrieved.
+        // 'link' is false for programs that are only compiled for the cache: the uniforms and blocks (shared by all
+        // programs) are not registered then, so it is safe to call from another thread.
+        ShaderProgram* compile_program(const ProgramRecipe& recipe, const std::string sources[3], bool cacheable,
+                                       bool link) {
+            static const ShaderProgram::ShaderType types[3] = {
+                    ShaderProgram::VERTEX, ShaderProgram::FRAGMENT, ShaderProgram::GEOMETRY
+            };
+            ShaderProgram* program = new ShaderProgram(recipe.name);
+            for (int i = 0; i < 3; ++i) {
+                if (!recipe.files[i].empty() && !program->load_shader_from_code(types[i], sources[i])) {
+                    delete program;
+                    return nullptr;
+                }
+            }
+
+            program->set_attrib_names(recipe.attributes);	easy3d_debug_log_gl_error;
+            for (std::size_t i = 0; i < recipe.outputs.size(); ++i)
+                program->set_program_output(static_cast<int>(i), recipe.outputs[i]);
+            if (cacheable)
+                glProgramParameteri(program->get_program(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+            bool success = false;
+            if (link) {
+                success = program->link_program();	easy3d_debug_log_gl_error;
+            } else {
+                glLinkProgram(program->get_program());	easy3d_debug_log_gl_error;
+                std::string log;
+                success = program->program_info_log(log);
+                LOG_IF(!success, ERROR) << log << " - \'" << recipe.name << "\'";
+            }
+            if (!success) {
+                delete program;
+                return nullptr;
+            }
+            return program;
+        }
+
+
+        // serializes the loading, compiling, and storing of a program binary among the threads of this process, e.g.,
+        // the prewarm thread and the rendering thread requesting the same program. It locks only the binary file
+        // given at construction, so the threads work on the other programs concurrently.
+        class BinaryLock {
+        public:
+            explicit BinaryLock(const std::string& file) : file_(file) {
+                std::unique_lock<std::mutex> lock(mutex());
+                released().wait(lock, [this]() { return files().count(file_) == 0; });
+                files().insert(file_);
+            }
+            ~BinaryLock() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex());
+                    files().erase(file_);
+                }
+                released().notify_all();
+            }
+
+        private:
+            static std::mutex& mutex() { static std::mutex m; return m; }
+            static std::condition_variable& released() { static std::condition_variable c; return c; }
+            static std::set<std::string>& files() { static std::set<std::string> f; return f; }   // the locked ones
+
+            std::string file_;
+        };
+
+
+        // stores the binary of a program. It is written to a temporary file first, so another process never reads an
+        // incomplete binary.
+        void save_binary(ShaderProgram* program, const std::string& file) {
+            std::ostringstream suffix;
+            suffix << ".tmp" << std::this_thread::get_id();
+            const std::string tmp_file = file + suffix.str();
+            if (!program->save_binary(tmp_file) || !file_system::rename_file(tmp_file, file))
+                file_system::delete_file(tmp_file);   // an identical binary may have been stored meanwhile
+        }
+
+
+        std::mutex manifest_mutex;
+        std::set<std::string> manifest_entries;  // of the current cache directory, loaded when the directory is set
+
+
+        inline std::string manifest_file(const std::string& dir) {
+            return dir + "/programs.txt";
+        }
+
+
+        // adds a recipe to the manifest (if not recorded yet), such that the program can be prewarmed later
+        void record(const std::string& dir, const ProgramRecipe& recipe) {
+            const std::string line = to_string(recipe);
+            std::lock_guard<std::mutex> lock(manifest_mutex);
+            if (!manifest_entries.insert(line).second)
+                return;
+            std::ofstream output(manifest_file(dir).c_str(), std::ios::app);
+            output << line << std::endl;
+        }
+
+
+        inline bool binary_cache_supported(const std::string& dir) {
+            return !dir.empty() && OpenglInfo::is_supported("GL_ARB_get_program_binary");
+        }
+
+
+        // creates a program, loading its binary from the cache (if possible and not outdated)
+        ShaderProgram* create_program(const ProgramRecipe& recipe, const std::string& cache_dir) {
+            std::string sources[3];
+            if (!read_sources(recipe, sources))
+                return nullptr;
+
+            if (!binary_cache_supported(cache_dir))
+                return compile_program(recipe, sources, false, true);
+
+            const std::string file = binary_file(cache_dir, recipe, sources);
+            BinaryLock lock(file);  // waits if the binary is being compiled in another thread
+            if (file_system::is_file(file)) {
+                ShaderProgram* program = new ShaderProgram(recipe.name);
+                if (program->load_binary(file)) {
+                    record(cache_dir, recipe);
+                    return program;
+                }
+                LOG(WARNING) << "program binary rejected by the driver (recompiling): " << recipe.name;
+                delete program;
+                file_system::delete_file(file);
+            }
+
+            ShaderProgram* program = compile_program(recipe, sources, true, true);
+            if (program) {
+                save_binary(program, file);
+                record(cache_dir, recipe);
+            }
+            return program;
+        }
+
+    }
 
 
     ShaderProgram* ShaderManager::get_program(const std::string& shader_name) {
@@ -78,38 +378,19 @@ namespace easy3d {
             return nullptr;
         }
 
-        ShaderProgram* program = new ShaderProgram(base_name);
-
-        bool success = program->load_shader_from_file(ShaderProgram::VERTEX, vs_file);
-        if (!success) {
-            attempt_load_program_[base_name] = false;
-            delete program;
-            return nullptr;
-        }
-
-        success = program->load_shader_from_file(ShaderProgram::FRAGMENT, fs_file);
-        if (!success) {
+        details::ProgramRecipe recipe;
+        recipe.name = base_name;
+        recipe.expand_includes = true;
+        recipe.files[0] = base_name + ".vert";
+        recipe.files[1] = base_name + ".frag";
+        if (geom_shader)
+            recipe.files[2] = base_name + ".geom";
+        recipe.attributes = attributes;
+        recipe.outputs = outputs;
+
+        ShaderProgram* program = details::create_program(recipe, binary_cache_directory_);
+        if (!program) {
             attempt_load_program_[base_name] = false;
-            delete program;
-            return nullptr;
-        }
-
-        if (geom_shader) {
-            success = program->load_shader_from_file(ShaderProgram::GEOMETRY, gs_file);
-            if (!success) {
-                attempt_load_program_[base_name] = false;
-                delete program;
-                return nullptr;
-            }
-        }
-
-        program->set_attrib_names(attributes);	easy3d_debug_log_gl_error;
-        for (std::size_t i = 0; i < outputs.size(); ++i)
-            program->set_program_output(static_cast<int>(i), outputs[i]);
-
-        success = program->link_program();	easy3d_debug_log_gl_error;
-        if (!success) {
-            delete program;
             return nullptr;
         }
 
@@ -158,54 +439,82 @@ namespace easy3d {
 			return nullptr;
 		}
 
-		ShaderProgram* program = new ShaderProgram(name);
-
-		std::string vert_code;
-        file_system::read_file_to_string(vert_file, vert_code);
-		if (!extra_vert_code.empty())
-			string::replace(vert_code, "//INSERT", extra_vert_code);
-        bool success = program->load_shader_from_code(ShaderProgram::VERTEX, vert_code);
-        if (!success) {
-            delete program;
+        details::ProgramRecipe recipe;
+        recipe.name = name;
+        recipe.expand_includes = false;
+        recipe.files[0] = vert_file_name;
+        recipe.files[1] = frag_file_name;
+        recipe.files[2] = geom_file_name;
+        recipe.extra[0] = extra_vert_code;
+        recipe.extra[1] = extra_frag_code;
+        recipe.extra[2] = extra_geom_code;
+        recipe.attributes = attributes;
+        recipe.outputs = outputs;
+
+        ShaderProgram* program = details::create_program(recipe, binary_cache_directory_);
+        if (!program)
             return nullptr;
+
+		programs_[name] = program;
+		return program;
+	}
+
+
+    void ShaderManager::set_binary_cache_directory(const std::string& dir) {
+        std::lock_guard<std::mutex> lock(details::manifest_mutex);
+        binary_cache_directory_ = dir;
+        details::manifest_entries.clear();
+        if (dir.empty())
+            return;
+
+        if (!file_system::is_directory(dir) && !file_system::create_directory(dir)) {
+            LOG(WARNING) << "program binary cache disabled (could not create directory \'" << dir << "\')";
+            binary_cache_directory_.clear();
+            return;
         }
-		
-		std::string frag_code;
-        file_system::read_file_to_string(frag_file, frag_code);
-		if (!extra_frag_code.empty())
-			string::replace(frag_code, "//INSERT", extra_frag_code);
-        success = program->load_shader_from_code(ShaderProgram::FRAGMENT, frag_code);
-        if (!success) {
-            delete program;
-            return nullptr;
+
+        std::ifstream input(details::manifest_file(dir).c_str());
+        std::string line;
+        while (std::getline(input, line)) {
+            if (!line.empty())
+                details::manifest_entries.insert(line);
         }
+    }
 
-		if (!geom_file_name.empty()) {
-			std::string geom_code;
-            file_system::read_file_to_string(geom_file, geom_code);
-			if (!extra_geom_code.empty())
-				string::replace(geom_code, "//INSERT", extra_geom_code);
-            success = program->load_shader_from_code(ShaderProgram::GEOMETRY, geom_code);
-            if (!success) {
-                delete program;
-                return nullptr;
-            }
-		}
 
-		program->set_attrib_names(attributes);	easy3d_debug_log_gl_error;
-		for (std::size_t i = 0; i < outputs.size(); ++i)
-			program->set_program_output(static_cast<int>(i), outputs[i]);
+    std::size_t ShaderManager::prewarm_binary_cache() {
+        const std::string dir = binary_cache_directory_;
+        if (!details::binary_cache_supported(dir))
+            return 0;
 
-        success = program->link_program();	easy3d_debug_log_gl_error;
-        if (!success) {
-            delete program;
-            return nullptr;
+        std::vector<std::string> lines;
+        {
+            std::lock_guard<std::mutex> lock(details::manifest_mutex);
+            lines.assign(details::manifest_entries.begin(), details::manifest_entries.end());
         }
 
-		programs_[name] = program;
-		return program;
-
-	}
+        std::size_t count = 0;
+        for (const auto& line : lines) {
+            details::ProgramRecipe recipe;
+            std::string sources[3];
+            if (!details::from_string(line, recipe) || !details::read_sources(recipe, sources))
+                continue;   // e.g., the shader files have been removed
+            const std::string file = details::binary_file(dir, recipe, sources);
+            details::BinaryLock lock(file);
+            if (file_system::is_file(file))
+                continue;
+
+            ShaderProgram* program = details::compile_program(recipe, sources, true, false);
+            if (program) {
+                details::save_binary(program, file);
+                delete program;
+                ++count;
+            }
+        }
+        glFinish();     // make sure the programs are deleted before the context is released
+        LOG_IF(count > 0, INFO) << count << " shader programs compiled into the binary cache";
+        return count;
+    }
 
 
     // create a shader program from completed shader source codes
@@ -29,6 +29,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <cstddef>
 
 #include <easy3d/renderer/shader_program.h>
 
@@ -41,6 +42,14 @@ namespace easy3d {
      * \brief Management of shader programs.
      * \class ShaderManager easy3d/renderer/shader_manager.h
      * \note make sure to call terminate() to destroy existing programs before the OpenGL context is deleted.
+     *
+     * Compiling and linking the programs from source takes a noticeable time, e.g., at the startup of a viewer with
+     * shadows, SSAO, transparency, and EDL. With a binary cache directory set (see set_binary_cache_directory()),
+     * the binaries of the programs created by create_program_from_files() are stored on disk and loaded directly
+     * the next time. A binary is identified by a hash of the complete source code of the program (including the
+     * inserted extra code), its attribute and output bindings, and the OpenGL driver (i.e., the vendor, renderer, and
+     * versions reported by OpenglInfo). If any of them changes or the driver rejects the binary, the program is
+     * compiled from source and the binary is replaced.
      */
     class ShaderManager
     {
@@ -86,11 +95,36 @@ namespace easy3d {
 
 		static void reload();
 
+        /// \name Program binary cache
+        //@{
+        /**
+         * \brief Sets the directory of the program binary cache (created if it does not exist). An empty string
+         *      (the default) disables the cache. The cache requires OpenGL 4.1 or GL_ARB_get_program_binary, and it
+         *      is ignored otherwise.
+         */
+        static void set_binary_cache_directory(const std::string& dir);
+        static const std::string& binary_cache_directory() { return binary_cache_directory_; }
+
+        /**
+         * \brief Makes sure the cache has the binaries of all the programs created in previous sessions.
+         * \details The programs whose binaries are missing or outdated (e.g., after an update of the driver or of
+         *      the shader files) are compiled, and their binaries are stored. The programs are not added to the
+         *      manager, so this function can be called from a background thread that has its own OpenGL context (e.g.,
+         *      of a hidden window sharing the context of the viewer), while the main thread creates programs.
+         * \attention Only the programs recorded in the manifest of the cache directory (i.e., created in previous
+         *      sessions) are known, so nothing is prewarmed in the first session with an empty cache. The built-in
+         *      programs are then compiled (and stored in the cache) when they are first used.
+         * \return The number of programs compiled.
+         */
+        static std::size_t prewarm_binary_cache();
+        //@}
+
     private:
         // maps of std::string can be super slow when calling find with a string literal or const char*
         // as find forces construction/copy/destruction of a std::sting copy of the const char*.
         static std::unordered_map<std::string, ShaderProgram*>	programs_;
         static std::unordered_map<std::string, bool>			attempt_load_program_; // avoid multiple attempt
+        static std::string binary_cache_directory_;
     };
 
 }
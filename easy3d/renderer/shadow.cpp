@@ -28,6 +28,7 @@
 #include <easy3d/renderer/shader_manager.h>
 #include <easy3d/renderer/shader_program.h>
 #include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/frame_profiler.h>
 #include <easy3d/renderer/camera.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/transform.h>
@@ -148,15 +149,22 @@ namespace easy3d {
         const int w = viewport[2];
         const int h = viewport[3];
 
+        FrameProfiler::Scope scope("shadow");
         init();
 
         // generate shadow map
         glViewport(0, 0, shadow_map_size_, shadow_map_size_);
-        shadow_map_pass(surfaces);          easy3d_debug_log_gl_error;
+        {
+            FrameProfiler::Scope pass("shadow_map_pass");
+            shadow_map_pass(surfaces);          easy3d_debug_log_gl_error;
+        }
 
         // rendering
         glViewport(0, 0, w, h);
-        render_pass(surfaces);      easy3d_debug_log_gl_error;
+        {
+            FrameProfiler::Scope pass("render_pass");
+            render_pass(surfaces);      easy3d_debug_log_gl_error;
+        }
 
         // for debugging
     #ifdef SHOW_SHADOW_MAP_AND_LIGHT_FRUSTUM
@@ -195,6 +203,7 @@ namespace easy3d {
                     setting::clipping_plane->set_program(program);
                     setting::clipping_plane->set_discard_primitives(program, d->plane_clip_discard_primitive());
                 }
+                program->set_uniform("MANIP", d->position_matrix());
                 d->gl_draw();
             }
         }
@@ -236,9 +245,9 @@ namespace easy3d {
         for (auto d : surfaces) {
             if (d->is_visible()) {
                 // transformation introduced by manipulation
-                const mat4 MANIP = d->manipulated_matrix();
+                const mat4 MANIP = d->position_matrix();
                 // needs be padded when using uniform blocks
-                const mat3 NORMAL = transform::normal_matrix(MANIP);
+                const mat3 NORMAL = transform::normal_matrix(d->manipulated_matrix());
                 program->set_uniform("MANIP", MANIP)
                         ->set_uniform( "NORMAL", NORMAL)
                         ->set_uniform("smooth_shading", d->smooth_shading())
@@ -263,6 +272,8 @@ namespace easy3d {
         program->set_uniform("default_color", virtual_background_color_);				easy3d_debug_log_gl_error;
         program->set_uniform("per_vertex_color", false);
         program->set_uniform("is_background", true);
+        program->set_uniform("MANIP", virtual_background_drawable_->position_matrix())
+                ->set_uniform("NORMAL", mat3::identity());
         virtual_background_drawable_->gl_draw();
 
         program->release_texture();
@@ -100,6 +100,7 @@ namespace easy3d {
                     setting::clipping_plane->set_program(program);
                     setting::clipping_plane->set_discard_primitives(program, d->plane_clip_discard_primitive());
                 }
+                program->set_uniform("MANIP", d->position_matrix());
                 d->gl_draw();
             }
         }
@@ -157,9 +158,9 @@ namespace easy3d {
         for (auto d : surfaces) {
             if (d->is_visible()) {
                 // transformation introduced by manipulation
-                const mat4 MANIP = d->manipulated_matrix();
+                const mat4 MANIP = d->position_matrix();
                 // needs be padded when using uniform blocks
-                const mat3 NORMAL = transform::normal_matrix(MANIP);
+                const mat3 NORMAL = transform::normal_matrix(d->manipulated_matrix());
                 program->set_uniform("MANIP", MANIP)
                         ->set_uniform( "NORMAL", NORMAL)
                         ->set_uniform("two_sides_lighting", d->lighting_two_sides())
@@ -195,6 +196,8 @@ namespace easy3d {
         program->set_uniform("default_color", virtual_background_color_);				easy3d_debug_log_gl_error;
         program->set_uniform("per_vertex_color", false);
         program->set_uniform("is_background", true);
+        program->set_uniform("MANIP", virtual_background_drawable_->position_matrix())
+                ->set_uniform("NORMAL", mat3::identity());
         virtual_background_drawable_->gl_draw();
 
         program->release_texture();
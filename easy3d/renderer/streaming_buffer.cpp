@@ -0,0 +1,341 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/renderer/streaming_buffer.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/renderer/opengl_info.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+    StreamingBuffer::StreamingBuffer(bool per_vertex_color, std::size_t segment_size)
+            : per_vertex_color_(per_vertex_color), segment_size_(std::max<std::size_t>(segment_size, 1)),
+              initialized_(false), persistent_(false), size_(0), capacity_(0) {
+        for (int a = 0; a < 2; ++a) {
+            staging_buffers_[a] = 0;
+            mapped_[a] = nullptr;
+            storage_[a] = 0;
+        }
+    }
+
+
+    StreamingBuffer::~StreamingBuffer() {
+        for (auto &segment : segments_) {
+            if (segment.fence)
+                glDeleteSync(static_cast<GLsync>(segment.fence));
+        }
+        for (int a = 0; a < 2; ++a) {
+            if (staging_buffers_[a]) {
+                glBindBuffer(GL_COPY_READ_BUFFER, staging_buffers_[a]);
+                glUnmapBuffer(GL_COPY_READ_BUFFER);
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glDeleteBuffers(1, &staging_buffers_[a]);
+            }
+            if (storage_[a])
+                glDeleteBuffers(1, &storage_[a]);
+        }
+        easy3d_debug_log_gl_error;
+    }
+
+
+    void StreamingBuffer::initialize() {
+        initialized_ = true;
+        const int num_attributes = per_vertex_color_ ? 2 : 1;
+        const std::size_t ring_size = num_segments * segment_size_ * 3;   // in floats
+
+        persistent_ = OpenglInfo::is_supported("GL_VERSION_4_4") || OpenglInfo::is_supported("GL_ARB_buffer_storage");
+        if (persistent_) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            for (int a = 0; a < num_attributes; ++a) {
+                glGenBuffers(1, &staging_buffers_[a]);	easy3d_debug_log_gl_error;
+                glBindBuffer(GL_COPY_READ_BUFFER, staging_buffers_[a]);	easy3d_debug_log_gl_error;
+                glBufferStorage(GL_COPY_READ_BUFFER, GLsizeiptr(ring_size * sizeof(float)), nullptr, flags);
+                easy3d_debug_log_gl_error;
+                mapped_[a] = static_cast<float *>(glMapBufferRange(GL_COPY_READ_BUFFER, 0,
+                                                                   GLsizeiptr(ring_size * sizeof(float)), flags));
+                easy3d_debug_log_gl_error;
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                if (!mapped_[a]) {
+                    LOG(WARNING) << "failed mapping the staging buffer persistently (using client memory instead)";
+                    persistent_ = false;
+                }
+            }
+        }
+
+        if (!persistent_) {
+            for (int a = 0; a < 2; ++a) {
+                if (staging_buffers_[a]) {
+                    if (mapped_[a]) {
+                        glBindBuffer(GL_COPY_READ_BUFFER, staging_buffers_[a]);
+                        glUnmapBuffer(GL_COPY_READ_BUFFER);
+                        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                        mapped_[a] = nullptr;
+                    }
+                    glDeleteBuffers(1, &staging_buffers_[a]);
+                    staging_buffers_[a] = 0;
+                }
+            }
+            for (int a = 0; a < num_attributes; ++a)
+                memory_[a].resize(ring_size);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_[0].state = FILLING;
+        filling_.push_back(0);
+    }
+
+
+    float *StreamingBuffer::staging(int attribute, int segment) {
+        float *ring = persistent_ ? mapped_[attribute] : memory_[attribute].data();
+        return ring + segment * segment_size_ * 3;
+    }
+
+
+    void StreamingBuffer::append(const vec3 *points, const vec3 *colors, std::size_t count) {
+        if (count == 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < count; ++i)
+            box_.grow(points[i]);
+        write(points, colors, count);
+    }
+
+
+    void StreamingBuffer::append(const std::vector<vec3> &points, const std::vector<vec3> &colors) {
+        LOG_IF(per_vertex_color_ && !colors.empty() && colors.size() != points.size(), ERROR)
+                        << "the number of colors (" << colors.size() << ") does not match the number of points ("
+                        << points.size() << ")";
+        const bool has_colors = per_vertex_color_ && colors.size() == points.size();
+        append(points.data(), has_colors ? colors.data() : nullptr, points.size());
+    }
+
+
+    void StreamingBuffer::write(const vec3 *points, const vec3 *colors, std::size_t count) {
+        const vec3 black(0.0f, 0.0f, 0.0f);
+        std::size_t done = 0;
+        // the vertices go to the overflow arrays once they are in use, to keep the order
+        while (done < count && overflow_[0].empty() && !filling_.empty()) {
+            const int index = filling_.back();
+            Segment &segment = segments_[index];
+            const std::size_t num = std::min(count - done, segment_size_ - segment.used);
+            if (num > 0) {
+                std::memcpy(staging(0, index) + segment.used * 3, points + done, num * sizeof(vec3));
+                if (per_vertex_color_) {
+                    float *dest = staging(1, index) + segment.used * 3;
+                    if (colors)
+                        std::memcpy(dest, colors + done, num * sizeof(vec3));
+                    else {
+                        for (std::size_t i = 0; i < num; ++i)
+                            std::memcpy(dest + i * 3, black.data(), sizeof(vec3));
+                    }
+                }
+                segment.used += num;
+                done += num;
+                continue;
+            }
+
+            // the segment is full: continue with the next one if it is free
+            const int next = (index + 1) % num_segments;
+            if (segments_[next].state != FREE)
+                break;
+            segments_[next].state = FILLING;
+            segments_[next].used = 0;
+            filling_.push_back(next);
+        }
+
+        if (done < count) {
+            overflow_[0].insert(overflow_[0].end(), points[done].data(), points[done].data() + (count - done) * 3);
+            if (per_vertex_color_) {
+                if (colors)
+                    overflow_[1].insert(overflow_[1].end(), colors[done].data(), colors[done].data() + (count - done) * 3);
+                else
+                    overflow_[1].resize(overflow_[1].size() + (count - done) * 3, 0.0f);
+            }
+        }
+    }
+
+
+    bool StreamingBuffer::sync() {
+        if (!initialized_)
+            initialize();
+
+        const int num_attributes = per_vertex_color_ ? 2 : 1;
+
+        // collect the data to transfer. The segments are handed over, so the producers continue with the next ones.
+        std::vector<int> submitted;
+        std::vector<float> overflow[2];
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            // the segments whose copies have completed can be written again
+            for (auto &segment : segments_) {
+                if (segment.state != SUBMITTED)
+                    continue;
+                const GLenum status = glClientWaitSync(static_cast<GLsync>(segment.fence), 0, 0);
+                if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                    glDeleteSync(static_cast<GLsync>(segment.fence));
+                    segment.fence = nullptr;
+                    segment.state = FREE;
+                    segment.used = 0;
+                }
+            }
+
+            for (auto index : filling_) {
+                if (segments_[index].used > 0) {
+                    segments_[index].state = SUBMITTED;
+                    submitted.push_back(index);
+                }
+            }
+            // keep writing into the current segment if it is still empty, or continue with the next free one
+            const int last = filling_.empty() ? num_segments - 1 : filling_.back();
+            filling_.clear();
+            if (segments_[last].state == FILLING)
+                filling_.push_back(last);
+            else {
+                for (int i = 1; i <= num_segments; ++i) {
+                    const int next = (last + i) % num_segments;
+                    if (segments_[next].state == FREE) {
+                        segments_[next].state = FILLING;
+                        filling_.push_back(next);
+                        break;
+                    }
+                }
+            }
+
+            for (int a = 0; a < num_attributes; ++a)
+                overflow[a].swap(overflow_[a]);
+        }
+
+        std::size_t count = overflow[0].size() / 3;
+        for (auto index : submitted)
+            count += segments_[index].used;
+
+        // grow the storage (the existing vertices are copied on the GPU)
+        bool created = false;
+        if (size_ + count > capacity_ || storage_[0] == 0) {
+            const std::size_t capacity = std::max(std::max(size_ + count, capacity_ * 2), segment_size_);
+            for (int a = 0; a < num_attributes; ++a) {
+                GLuint buffer = 0;
+                glGenBuffers(1, &buffer);	easy3d_debug_log_gl_error;
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);	easy3d_debug_log_gl_error;
+                glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(capacity * sizeof(vec3)), nullptr, GL_DYNAMIC_DRAW);
+                easy3d_debug_log_gl_error;
+                if (storage_[a]) {
+                    glBindBuffer(GL_COPY_READ_BUFFER, storage_[a]);	easy3d_debug_log_gl_error;
+                    if (size_ > 0)
+                        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                                            GLsizeiptr(size_ * sizeof(vec3)));
+                    easy3d_debug_log_gl_error;
+                    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                    // the deletion is deferred by the driver until the pending draws using it have completed
+                    glDeleteBuffers(1, &storage_[a]);	easy3d_debug_log_gl_error;
+                }
+                storage_[a] = buffer;
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            VLOG(1) << "streaming buffer grown from " << capacity_ << " to " << capacity << " vertices";
+            capacity_ = capacity;
+            created = true;
+        }
+
+        for (auto index : submitted) {
+            Segment &segment = segments_[index];
+            for (int a = 0; a < num_attributes; ++a) {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, storage_[a]);	easy3d_debug_log_gl_error;
+                if (persistent_) {
+                    glBindBuffer(GL_COPY_READ_BUFFER, staging_buffers_[a]);	easy3d_debug_log_gl_error;
+                    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                        GLintptr(index * segment_size_ * sizeof(vec3)), GLintptr(size_ * sizeof(vec3)),
+                                        GLsizeiptr(segment.used * sizeof(vec3)));
+                } else
+                    glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(size_ * sizeof(vec3)),
+                                    GLsizeiptr(segment.used * sizeof(vec3)), staging(a, index));
+                easy3d_debug_log_gl_error;
+            }
+            size_ += segment.used;
+
+            if (persistent_)    // the segment is written again only after the copy has been executed
+                segment.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            else {              // the data has been copied by glBufferSubData()
+                std::lock_guard<std::mutex> lock(mutex_);
+                segment.state = FREE;
+                segment.used = 0;
+                if (filling_.empty()) {
+                    segment.state = FILLING;
+                    filling_.push_back(index);
+                }
+            }
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+        if (!overflow[0].empty()) {
+            const std::size_t num = overflow[0].size() / 3;
+            for (int a = 0; a < num_attributes; ++a) {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, storage_[a]);	easy3d_debug_log_gl_error;
+                glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(size_ * sizeof(vec3)), GLsizeiptr(num * sizeof(vec3)),
+                                overflow[a].data());	easy3d_debug_log_gl_error;
+            }
+            size_ += num;
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        return created;
+    }
+
+
+    std::size_t StreamingBuffer::num_pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t count = overflow_[0].size() / 3;
+        for (auto index : filling_)
+            count += segments_[index].used;
+        return count;
+    }
+
+
+    Box3 StreamingBuffer::bounding_box() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return box_;
+    }
+
+
+    void StreamingBuffer::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto index : filling_)
+            segments_[index].used = 0;
+        for (auto &overflow : overflow_)
+            overflow.clear();
+        box_.clear();
+        size_ = 0;
+    }
+
+}
@@ -0,0 +1,149 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_RENDERER_STREAMING_BUFFER_H
+#define EASY3D_RENDERER_STREAMING_BUFFER_H
+
+
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <cstddef>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Append-only GPU storage of vertices (i.e., positions and optionally colors) that are streamed in, e.g.,
+     *      from a sensor, by other threads.
+     * \class StreamingBuffer easy3d/renderer/streaming_buffer.h
+     * \details Producer threads call append(), which makes no OpenGL calls. The vertices are written directly into a
+     *      staging ring of three segments, which is persistently mapped if OpenGL 4.4 (or GL_ARB_buffer_storage) is
+     *      available and is plain memory otherwise. In each frame, the rendering thread calls sync() to copy the
+     *      filled segments into the storage buffers on the GPU. A fence is inserted after each copy, and a segment
+     *      is written again only after its fence has been signaled. If no segment is free, the vertices are kept in
+     *      an overflow array until the next sync(). The storage grows geometrically, and the existing vertices are
+     *      then copied on the GPU (i.e., they are never uploaded again).
+     *
+     *      Call Drawable::enable_streaming() to draw the streamed vertices with a PointsDrawable or a LinesDrawable
+     *      (each two consecutive vertices define a line segment).
+     */
+    class StreamingBuffer {
+    public:
+        /**
+         * \param per_vertex_color \c true to stream a color with each vertex.
+         * \param segment_size The number of vertices each segment of the staging ring can hold.
+         */
+        explicit StreamingBuffer(bool per_vertex_color = false, std::size_t segment_size = 65536);
+        /// The OpenGL objects are released, so the rendering context must be current.
+        ~StreamingBuffer();
+
+        bool per_vertex_color() const { return per_vertex_color_; }
+
+        /**
+         * \brief Appends \p count vertices. This can be called from any thread, and it makes no OpenGL calls.
+         * \param points The positions of the vertices.
+         * \param colors The colors of the vertices. It is ignored if per_vertex_color() is \c false, and black is
+         *      used if it is \c nullptr.
+         */
+        void append(const vec3 *points, const vec3 *colors, std::size_t count);
+        void append(const std::vector<vec3> &points, const std::vector<vec3> &colors = std::vector<vec3>());
+
+        /**
+         * \brief Transfers the vertices appended since the last call to the GPU. It must be called by the thread
+         *      owning the rendering context.
+         * \return \c true if the storage buffers have been (re)created, i.e., they need to be attached to the vertex
+         *      array object again.
+         */
+        bool sync();
+
+        /// \brief The storage buffer of the positions (0 before the first sync()).
+        unsigned int position_buffer() const { return storage_[0]; }
+        /// \brief The storage buffer of the colors (0 if per_vertex_color() is \c false).
+        unsigned int color_buffer() const { return storage_[1]; }
+
+        /// \brief The number of vertices in the storage buffers, i.e., transferred by sync(). It can be queried from
+        ///     any thread.
+        std::size_t size() const { return size_; }
+        /// \brief The number of vertices the storage buffers can hold before they have to grow.
+        std::size_t capacity() const { return capacity_; }
+        /// \brief The number of vertices appended but not transferred yet.
+        std::size_t num_pending() const;
+        /// \brief The bounding box of all the appended vertices.
+        Box3 bounding_box() const;
+
+        /// \brief Returns whether the staging ring is persistently mapped (known after the first sync()).
+        bool persistent_mapping() const { return persistent_; }
+
+        /// \brief Removes all the vertices (the storage is kept). It must be called by the rendering thread.
+        void clear();
+
+    private:
+        void initialize();
+        // writes vertices into the ring or the overflow arrays (the mutex must be locked)
+        void write(const vec3 *points, const vec3 *colors, std::size_t count);
+        float *staging(int attribute, int segment);
+
+        enum SegmentState { FREE, FILLING, SUBMITTED };
+        struct Segment {
+            Segment() : state(FREE), used(0), fence(nullptr) {}
+            SegmentState state;
+            std::size_t used;
+            void *fence;    // a GLsync
+        };
+
+        static const int num_segments = 3;
+
+    private:
+        const bool per_vertex_color_;
+        const std::size_t segment_size_;
+        bool initialized_;
+        bool persistent_;
+
+        mutable std::mutex mutex_;
+        Segment segments_[num_segments];
+        std::deque<int> filling_;               // the segments written by the producers, in order
+        std::vector<float> overflow_[2];        // the vertices that did not fit into the ring
+        Box3 box_;
+
+        // the staging ring: persistently mapped buffers or plain memory
+        unsigned int staging_buffers_[2];
+        float *mapped_[2];
+        std::vector<float> memory_[2];
+
+        unsigned int storage_[2];
+        std::atomic<std::size_t> size_;     // updated by sync() and clear(), read by any thread
+        std::size_t capacity_;
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_STREAMING_BUFFER_H
@@ -27,14 +27,64 @@
 #include <easy3d/renderer/vertex_array_object.h>
 
 #include <cassert>
+#include <mutex>
+#include <unordered_map>
 
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/opengl_info.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/memory.h>
 
 
 namespace easy3d {
 
+    namespace {
+
+        // the sizes of the buffers created by VertexArrayObject, for the process-wide memory tallies
+        struct BufferTally {
+            std::mutex mutex;
+            std::unordered_map<GLuint, std::size_t> sizes;
+            std::size_t bytes;
+        };
+
+        BufferTally &buffer_tally() {
+            // never destroyed: the buffers may be released during exit
+            static BufferTally *tally = nullptr;
+            static std::once_flag flag;
+            std::call_once(flag, []() {
+                tally = new BufferTally;
+                tally->bytes = 0;
+                memory::register_tally("GPU buffers", []() -> memory::Usage {
+                    std::lock_guard<std::mutex> lock(tally->mutex);
+                    const std::size_t num = tally->sizes.size();
+                    return memory::Usage("", num, num, tally->bytes, tally->bytes);
+                });
+            });
+            return *tally;
+        }
+
+        void record_buffer(GLuint buffer, std::size_t size) {
+            if (buffer == 0)
+                return;
+            BufferTally &tally = buffer_tally();
+            std::lock_guard<std::mutex> lock(tally.mutex);
+            std::size_t &bytes = tally.sizes[buffer];
+            tally.bytes += size - bytes;
+            bytes = size;
+        }
+
+        void forget_buffer(GLuint buffer) {
+            BufferTally &tally = buffer_tally();
+            std::lock_guard<std::mutex> lock(tally.mutex);
+            auto pos = tally.sizes.find(buffer);
+            if (pos != tally.sizes.end()) {
+                tally.bytes -= pos->second;
+                tally.sizes.erase(pos);
+            }
+        }
+
+    }
+
 
     bool VertexArrayObject::is_supported() {
         return OpenglInfo::is_supported("GL_VERSION_2_1") ||
@@ -90,6 +140,7 @@ namespace easy3d {
 
     void VertexArrayObject::release_buffer(GLuint& buffer) {
         if (buffer != 0) {
+            forget_buffer(buffer);
 			glBindVertexArray(0);			easy3d_debug_log_gl_error;
             glDeleteBuffers(1, &buffer);	easy3d_debug_log_gl_error;
             buffer = 0;
@@ -98,6 +149,12 @@ namespace easy3d {
 
 
     bool VertexArrayObject::create_array_buffer(GLuint& buffer, GLuint index, const void* data, std::size_t size, std::size_t dim, bool dynamic) {
+        return create_array_buffer(buffer, index, data, size, dim, GL_FLOAT, false, dynamic);
+    }
+
+
+    bool VertexArrayObject::create_array_buffer(GLuint& buffer, GLuint index, const void* data, std::size_t size,
+                                                std::size_t dim, GLenum type, bool normalized, bool dynamic) {
         release_buffer(buffer);
 		bind();
         glGenBuffers(1, &buffer);                       easy3d_debug_log_gl_error;
@@ -105,13 +162,14 @@ namespace easy3d {
         glBindBuffer(GL_ARRAY_BUFFER, buffer);			easy3d_debug_log_gl_error;
         glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);		easy3d_debug_log_gl_error;
         glEnableVertexAttribArray(index);               easy3d_debug_log_gl_error;
-        glVertexAttribPointer(index, int(dim), GL_FLOAT, GL_FALSE, 0, nullptr);		easy3d_debug_log_gl_error;
+        glVertexAttribPointer(index, int(dim), type, normalized ? GL_TRUE : GL_FALSE, 0, nullptr);		easy3d_debug_log_gl_error;
         if (glGetError() != GL_NO_ERROR) {
             glBindBuffer(GL_ARRAY_BUFFER, 0);           easy3d_debug_log_gl_error;
             glDeleteBuffers(1, &buffer);                easy3d_debug_log_gl_error;
             buffer = 0;
             LOG(ERROR) << "failed creating array buffer";
 		}
+        record_buffer(buffer, size);
         glBindBuffer(GL_ARRAY_BUFFER, 0);               easy3d_debug_log_gl_error;
         release();
         return (glGetError() == GL_NO_ERROR && buffer != 0);
@@ -131,12 +189,24 @@ namespace easy3d {
             buffer = 0;
             LOG(ERROR) << "failed creating element array buffer";
 		}
+        record_buffer(buffer, size);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);	easy3d_debug_log_gl_error;
         release();
         return (glGetError() == GL_NO_ERROR && buffer != 0);
 	}
 
 
+    bool VertexArrayObject::attach_array_buffer(GLuint buffer, GLuint index, std::size_t dim) {
+        bind();
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);			easy3d_debug_log_gl_error;
+        glEnableVertexAttribArray(index);               easy3d_debug_log_gl_error;
+        glVertexAttribPointer(index, int(dim), GL_FLOAT, GL_FALSE, 0, nullptr);		easy3d_debug_log_gl_error;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);               easy3d_debug_log_gl_error;
+        release();
+        return (glGetError() == GL_NO_ERROR);
+    }
+
+
     bool VertexArrayObject::create_storage_buffer(GLuint& buffer, GLuint index, const void* data, std::size_t size) {
         if (!OpenglInfo::is_supported("GL_ARB_shader_storage_buffer_object")) {
             LOG(ERROR) << "shader storage buffer object not supported on this platform";
@@ -155,12 +225,23 @@ namespace easy3d {
             buffer = 0;
             LOG(ERROR) << "failed creating shader storage buffer";
 		}
+        record_buffer(buffer, size);
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);                                  easy3d_debug_log_gl_error;
         release();                                                                  easy3d_debug_log_gl_error;
         return (glGetError() == GL_NO_ERROR && buffer != 0);
 	}
 
 
+    bool VertexArrayObject::update_array_buffer(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) {
+        if (buffer == 0 || size <= 0)
+            return false;
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);                  easy3d_debug_log_gl_error;
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);   easy3d_debug_log_gl_error;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);                       easy3d_debug_log_gl_error;
+        return (glGetError() == GL_NO_ERROR);
+    }
+
+
     bool VertexArrayObject::update_storage_buffer(GLuint& buffer, GLintptr offset, GLsizeiptr size, const void* data) {
 		bind();
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);                     easy3d_debug_log_gl_error;
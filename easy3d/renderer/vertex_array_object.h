@@ -74,8 +74,37 @@ namespace easy3d {
          * @return OpenGL error code.
          */
         bool create_array_buffer(GLuint& buffer, GLuint index, const void* data, std::size_t size, std::size_t dim, bool dynamic = false);
+
+        /**
+         * @brief Creates an OpenGL array buffer of a given data type and upload data to the buffer.
+         * @details This is used for compact vertex attributes (see packing), e.g., GL_UNSIGNED_SHORT positions,
+         *      GL_INT_2_10_10_10_REV normals, GL_UNSIGNED_BYTE colors, and GL_HALF_FLOAT texture coordinates.
+         * @param type   The data type of each component, e.g., GL_FLOAT, GL_UNSIGNED_BYTE.
+         * @param normalized Whether integer values are mapped to [0, 1] (unsigned) or [-1, 1] (signed) when accessed.
+         * @return OpenGL error code.
+         */
+        bool create_array_buffer(GLuint& buffer, GLuint index, const void* data, std::size_t size, std::size_t dim,
+                                 GLenum type, bool normalized, bool dynamic = false);
         bool create_element_buffer(GLuint& buffer, const void* data, std::size_t size, bool dynamic = false);
 
+        /**
+         * @brief Uses an existing array buffer (e.g., of a StreamingBuffer) for a generic vertex attribute.
+         * @details The buffer is not owned by the VAO, i.e., it is not released by release_buffer().
+         * @param index  The index of the generic vertex attribute.
+         * @param dim    The number of float components per generic vertex attribute. Must be 1, 2, 3, 4.
+         * @return OpenGL error code.
+         */
+        bool attach_array_buffer(GLuint buffer, GLuint index, std::size_t dim);
+
+        /**
+         * @brief Updates a part of an existing array buffer (without reallocating its storage).
+         * @param offset The offset (in bytes) into the buffer where the update starts.
+         * @param size   The size of the data (in bytes) to be uploaded.
+         * @param data   The pointer to the data, i.e., the new values of the bytes [offset, offset + size).
+         * @return OpenGL error code.
+         */
+        bool update_array_buffer(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+
         // @param index: the index of the binding point.
         bool create_storage_buffer(GLuint& buffer, GLuint index, const void* data, std::size_t size);
         bool update_storage_buffer(GLuint& buffer, GLintptr offset, GLsizeiptr size, const void* data);
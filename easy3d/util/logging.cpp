@@ -28,6 +28,12 @@
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stack_tracer.h>
 
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <iostream>
+
 
 INITIALIZE_EASYLOGGINGPP
 
@@ -222,6 +228,390 @@ namespace easy3d
             ELPP->installLogDispatchCallback<Dispatcher>("Easy3D-Logger");
         }
 
+
+        Logger::~Logger() {
+            if (logger == this)
+                logger = nullptr;
+        }
+
+        //_________________________________________________________
+
+
+        /// A bounded lock-free multi-producer single-consumer queue (the algorithm of Dmitry Vyukov).
+        template <typename T>
+        class MessageQueue {
+        public:
+            explicit MessageQueue(std::size_t capacity) : enqueue_pos_(0), dequeue_pos_(0) {
+                std::size_t size = 2;
+                while (size < capacity)
+                    size *= 2;
+                mask_ = size - 1;
+                cells_.reset(new Cell[size]);
+                for (std::size_t i = 0; i < size; ++i)
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            // called by any thread, returns false if the queue is full
+            bool push(T &&data) {
+                Cell *cell = nullptr;
+                std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+                for (;;) {
+                    cell = &cells_[pos & mask_];
+                    const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                    if (diff == 0) {
+                        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    } else if (diff < 0)
+                        return false;
+                    else
+                        pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+                cell->data = std::move(data);
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            // called by the consumer thread only, returns false if the queue is empty
+            bool pop(T &data) {
+                const std::size_t pos = dequeue_pos_;
+                Cell &cell = cells_[pos & mask_];
+                if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+                    return false;
+                data = std::move(cell.data);
+                cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                dequeue_pos_ = pos + 1;
+                return true;
+            }
+
+        private:
+            struct Cell {
+                std::atomic<std::size_t> sequence;
+                T data;
+            };
+            std::unique_ptr<Cell[]> cells_;
+            std::size_t mask_;
+            char padding0_[64];
+            std::atomic<std::size_t> enqueue_pos_;
+            char padding1_[64];
+            std::size_t dequeue_pos_;
+        };
+
+
+        // a log message as captured by the logging thread, to be formatted by the background thread
+        struct Message {
+            Message() : logger(nullptr), level(el::Level::Unknown), line(0), verbose_level(0), to_file(false),
+                        to_console(false) {}
+            el::Logger *logger;
+            el::Level level;
+            std::string file;
+            el::base::type::LineNumber line;
+            std::string func;
+            el::base::type::VerboseLevel verbose_level;
+            std::string thread;     // the name of the logging thread (only if the log format needs it)
+            struct timeval time;    // the time the message was logged
+            std::string text;
+            bool to_file;
+            bool to_console;
+        };
+
+
+        // formats a message according to the log format of its logger, as el::base::DefaultLogBuilder does, but
+        // with the time the message was logged (the level, the user, and the host are already part of the format).
+        // Custom format specifiers are not supported.
+        static std::string format(const Message &msg) {
+            using el::base::FormatFlags;
+            using el::base::utils::Str;
+            el::base::TypedConfigurations *tc = msg.logger->typedConfigurations();
+            const el::base::LogFormat &format = tc->logFormat(msg.level);
+            std::string line = format.format();
+            char buff[el::base::consts::kSourceFilenameMaxLength] = "";
+
+            if (format.hasFlag(FormatFlags::AppName))
+                Str::replaceFirstWithEscape(line, "%app", msg.logger->parentApplicationName());
+            if (format.hasFlag(FormatFlags::ThreadId))
+                Str::replaceFirstWithEscape(line, "%thread", msg.thread);
+            if (format.hasFlag(FormatFlags::DateTime)) {
+                const std::string time = el::base::utils::DateTime::timevalToString(
+                        msg.time, format.dateTimeFormat().c_str(), &tc->subsecondPrecision(msg.level));
+                Str::replaceFirstWithEscape(line, "%datetime", time);
+            }
+            if (format.hasFlag(FormatFlags::Function))
+                Str::replaceFirstWithEscape(line, "%func", msg.func);
+            if (format.hasFlag(FormatFlags::File)) {
+                el::base::utils::File::buildStrippedFilename(msg.file.c_str(), buff);
+                Str::replaceFirstWithEscape(line, "%file", buff);
+            }
+            if (format.hasFlag(FormatFlags::FileBase)) {
+                el::base::utils::File::buildBaseFilename(msg.file, buff);
+                Str::replaceFirstWithEscape(line, "%fbase", buff);
+            }
+            if (format.hasFlag(FormatFlags::Line))
+                Str::replaceFirstWithEscape(line, "%line", std::to_string(msg.line));
+            if (format.hasFlag(FormatFlags::Location)) {
+                el::base::utils::File::buildStrippedFilename(msg.file.c_str(), buff);
+                Str::replaceFirstWithEscape(line, "%loc", std::string(buff) + ":" + std::to_string(msg.line));
+            }
+            if (msg.level == el::Level::Verbose && format.hasFlag(FormatFlags::VerboseLevel))
+                Str::replaceFirstWithEscape(line, "%vlevel", std::to_string(msg.verbose_level));
+            if (format.hasFlag(FormatFlags::LogMessage))
+                Str::replaceFirstWithEscape(line, "%msg", msg.text);
+            line += "\n";
+            return line;
+        }
+
+
+        // formats and writes a message to the log file and/or the console
+        static void write(std::ofstream &file, const Message &msg) {
+            const std::string line = format(msg);
+            if (msg.to_file && file.is_open())
+                file << line;
+            if (msg.to_console) {
+                if (ELPP->hasFlag(el::LoggingFlag::ColoredTerminalOutput)) {
+                    std::string colored = line;
+                    msg.logger->logBuilder()->convertToColoredOutput(&colored, msg.level);
+                    std::cout << colored;
+                } else
+                    std::cout << line;
+            }
+        }
+
+
+        // writes the messages in a background thread
+        class AsyncSink {
+        public:
+            explicit AsyncSink(std::size_t capacity)
+                    : queue_(capacity), num_pushed_(0), num_written_(0), num_dropped_(0), stop_(false) {
+                if (!log_file_name.empty())
+                    file_.open(log_file_name.c_str(), std::ios::app);
+                thread_ = std::thread(&AsyncSink::run, this);
+            }
+
+            ~AsyncSink() {
+                stop_ = true;
+                thread_.join();
+            }
+
+            void push(Message &&msg) {
+                if (queue_.push(std::move(msg)))
+                    num_pushed_.fetch_add(1, std::memory_order_release);
+                else
+                    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void flush() {
+                const std::size_t target = num_pushed_.load(std::memory_order_acquire);
+                while (num_written_.load(std::memory_order_acquire) < target)
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+
+            // writes a message immediately (after the pending ones)
+            void write_now(const Message &msg) {
+                flush();
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                write(file_, msg);
+                file_.flush();
+                std::cout.flush();
+            }
+
+            std::size_t num_dropped() const { return num_dropped_; }
+
+        private:
+            void run() {
+                Message msg;
+                std::size_t reported_dropped = 0;
+                for (;;) {
+                    bool written = false;
+                    {
+                        std::lock_guard<std::mutex> lock(write_mutex_);
+                        while (queue_.pop(msg)) {
+                            write(file_, msg);
+                            num_written_.fetch_add(1, std::memory_order_release);
+                            written = true;
+                        }
+                        const std::size_t dropped = num_dropped_;
+                        if (dropped != reported_dropped) {
+                            const std::string line = "W " + std::to_string(dropped - reported_dropped) +
+                                                     " log messages dropped (the buffer was full)\n";
+                            if (file_.is_open())
+                                file_ << line;
+                            std::cout << line;
+                            reported_dropped = dropped;
+                            written = true;
+                        }
+                        if (written) {
+                            file_.flush();
+                            std::cout.flush();
+                        }
+                    }
+                    if (!written) {
+                        // the queue is drained before stopping
+                        if (stop_)
+                            break;
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+            }
+
+        private:
+            MessageQueue<Message> queue_;
+            std::atomic<std::size_t> num_pushed_;
+            std::atomic<std::size_t> num_written_;
+            std::atomic<std::size_t> num_dropped_;
+            std::atomic<bool> stop_;
+            std::ofstream file_;
+            std::mutex write_mutex_;
+            std::thread thread_;
+        };
+
+
+        static std::atomic<AsyncSink*> async_sink(nullptr);
+        static std::mutex async_mutex;  // serializes enabling/disabling the asynchronous mode
+
+        // stops the background thread (after writing the pending messages) when the program exits
+        // the sink is detached under the lock of easylogging++, which is held while dispatching a message, so no
+        // dispatcher is using it when it is deleted
+        static AsyncSink *detach_async_sink() {
+            el::base::threading::ScopedLock lock(ELPP->lock());
+            return async_sink.exchange(nullptr);
+        }
+
+        // stops the background thread (after writing the pending messages) when the program exits
+        static struct AsyncSinkDeleter {
+            ~AsyncSinkDeleter() {
+                std::lock_guard<std::mutex> lock(async_mutex);
+                delete detach_async_sink();
+            }
+        } async_sink_deleter;
+
+
+        // captures the messages for the background thread. This runs in the logging thread under the lock of
+        // easylogging++, so it only copies the message and leaves the formatting to the background thread.
+        class AsyncDispatcher : public el::LogDispatchCallback {
+        protected:
+            void handle(const el::LogDispatchData* data) noexcept override {
+                if (data->dispatchAction() != el::base::DispatchAction::NormalLog)
+                    return;
+                const el::LogMessage *message = data->logMessage();
+                el::Logger *elogger = message->logger();
+                const el::Level level = message->level();
+                el::base::TypedConfigurations *tc = elogger->typedConfigurations();
+
+                Message msg;
+                msg.to_file = tc->toFile(level) && !log_file_name.empty();
+                msg.to_console = tc->toStandardOutput(level);
+                if (!msg.to_file && !msg.to_console)
+                    return;
+                el::base::utils::DateTime::gettimeofday(&msg.time);
+                msg.logger = elogger;
+                msg.level = level;
+                msg.file = message->file();
+                msg.line = message->line();
+                msg.func = message->func();
+                msg.verbose_level = message->verboseLevel();
+                msg.text = message->message();
+                if (tc->logFormat(level).hasFlag(el::base::FormatFlags::ThreadId))
+                    msg.thread = ELPP->getThreadName(el::base::threading::getCurrentThreadId());
+
+                AsyncSink *sink = async_sink;
+                if (!sink) {    // the asynchronous mode was just disabled (or the program is exiting)
+                    std::ofstream file;
+                    if (msg.to_file)
+                        file.open(log_file_name.c_str(), std::ios::app);
+                    write(file, msg);
+                } else if (level == el::Level::Fatal)
+                    sink->write_now(msg);
+                else
+                    sink->push(std::move(msg));
+            }
+        };
+
+
+        void set_asynchronous(bool b, std::size_t capacity) {
+            std::lock_guard<std::mutex> lock(async_mutex);
+            if (b == (async_sink != nullptr))
+                return;
+
+            auto default_dispatcher = el::Helpers::logDispatchCallback<el::base::DefaultLogDispatchCallback>(
+                    "DefaultLogDispatchCallback");
+            if (b) {
+                async_sink = new AsyncSink(capacity);
+                el::Helpers::installLogDispatchCallback<AsyncDispatcher>("Easy3D-Async");
+                if (default_dispatcher)
+                    default_dispatcher->setEnabled(false);
+            } else {
+                if (default_dispatcher)
+                    default_dispatcher->setEnabled(true);
+                el::Helpers::uninstallLogDispatchCallback<AsyncDispatcher>("Easy3D-Async");
+                delete detach_async_sink();
+            }
+        }
+
+
+        bool is_asynchronous() {
+            return async_sink != nullptr;
+        }
+
+
+        void flush() {
+            std::lock_guard<std::mutex> lock(async_mutex);
+            AsyncSink *sink = async_sink;
+            if (sink)
+                sink->flush();
+        }
+
+
+        std::size_t num_dropped() {
+            std::lock_guard<std::mutex> lock(async_mutex);
+            AsyncSink *sink = async_sink;
+            return sink ? sink->num_dropped() : 0;
+        }
+
+        //_________________________________________________________
+
+
+        static std::atomic<LogSite*> log_sites(nullptr);
+
+
+        LogSite::LogSite(const char *file, int line)
+                : file_(file), line_(line), hits_(0), suppressed_(0), last_pass_(-1) {
+            next_ = log_sites.load();
+            while (!log_sites.compare_exchange_weak(next_, this)) {}
+        }
+
+
+        LogSite::Pass LogSite::every_seconds(double seconds) {
+            using namespace std::chrono;
+            const long long now = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+            long long last = last_pass_.load(std::memory_order_relaxed);
+            if ((last < 0 || now - last >= static_cast<long long>(seconds * 1e6)) &&
+                last_pass_.compare_exchange_strong(last, now, std::memory_order_relaxed))
+                return Pass(true, suppressed_.exchange(0, std::memory_order_relaxed));
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return Pass(false, 0);
+        }
+
+
+        std::ostream &operator<<(std::ostream &os, const LogSite::Pass &pass) {
+            if (pass.suppressed > 0)
+                os << "[" << pass.suppressed << " similar messages suppressed] ";
+            return os;
+        }
+
+
+        std::size_t report_suppressed() {
+            std::size_t total = 0;
+            for (LogSite *site = log_sites; site; site = site->next_) {
+                const std::size_t num = site->suppressed_.exchange(0, std::memory_order_relaxed);
+                if (num > 0) {
+                    LOG(WARNING) << num << " similar messages suppressed ("
+                                 << file_system::simple_name(site->file_) << ":" << site->line_ << ")";
+                    total += num;
+                }
+            }
+            return total;
+        }
+
     }
     // \endcond
 }
@@ -28,8 +28,52 @@
 #define EASY3D_UTIL_LOGGING_H
 
 
+// Compile-time filter of the log messages. Messages below EASY3D_MIN_LOG_LEVEL are disabled at compile time (and they
+// are removed entirely if logged by LOG_FILTERED(), see below):
+//  - 0: nothing is removed;
+//  - 1: DEBUG messages (including DLOG) are removed. This is the default for release builds;
+//  - 2: in addition, INFO and verbose (VLOG) messages are removed;
+//  - 3: in addition, WARNING messages are removed.
+#ifndef EASY3D_MIN_LOG_LEVEL
+#  ifdef NDEBUG
+#    define EASY3D_MIN_LOG_LEVEL 1
+#  else
+#    define EASY3D_MIN_LOG_LEVEL 0
+#  endif
+#endif
+
+#if EASY3D_MIN_LOG_LEVEL >= 1 && !defined(ELPP_DISABLE_DEBUG_LOGS)
+#  define ELPP_DISABLE_DEBUG_LOGS
+#endif
+#if EASY3D_MIN_LOG_LEVEL >= 2
+#  ifndef ELPP_DISABLE_INFO_LOGS
+#    define ELPP_DISABLE_INFO_LOGS
+#  endif
+#  ifndef ELPP_DISABLE_VERBOSE_LOGS
+#    define ELPP_DISABLE_VERBOSE_LOGS
+#  endif
+#endif
+#if EASY3D_MIN_LOG_LEVEL >= 3 && !defined(ELPP_DISABLE_WARNING_LOGS)
+#  define ELPP_DISABLE_WARNING_LOGS
+#endif
+
 #include <3rd_party/easyloggingpp/src/easylogging++.h>
 
+#include <atomic>
+
+
+// easylogging++ turns disabled messages into no-op streams, but the streamed expressions are still evaluated.
+// LOG_FILTERED(LEVEL) is LOG(LEVEL) for the messages that are kept, and the messages below EASY3D_MIN_LOG_LEVEL are
+// removed entirely (the condition is a compile-time constant), e.g., for logging in hot paths.
+// \cond
+#define EASY3D_LOG_ENABLED_DEBUG    (EASY3D_MIN_LOG_LEVEL < 1)
+#define EASY3D_LOG_ENABLED_INFO     (EASY3D_MIN_LOG_LEVEL < 2)
+#define EASY3D_LOG_ENABLED_WARNING  (EASY3D_MIN_LOG_LEVEL < 3)
+#define EASY3D_LOG_ENABLED_ERROR    1
+#define EASY3D_LOG_ENABLED_FATAL    1
+// \endcond
+#define LOG_FILTERED(LEVEL)  if (!(EASY3D_LOG_ENABLED_##LEVEL)) {} else LOG(LEVEL)
+
 
 // to have LOG_IF_EVERY_N
 #define LOG_IF_EVERY_N(n, condition, LEVEL)  if (condition) \
@@ -42,6 +86,23 @@ CLOG_N_TIMES(n, LEVEL, ELPP_CURR_FILE_LOGGER_ID)
 // for logging the counter number
 #define COUNTER     ELPP_COUNTER->hitCounts()
 
+// \cond
+#define EASY3D_LOG_SITE ([]() -> easy3d::logging::LogSite& {     \
+        static easy3d::logging::LogSite site(__FILE__, __LINE__);  \
+        return site;                                               \
+    }())
+// \endcond
+
+// Logs the first n messages of this statement. Unlike LOG_N_TIMES, it doesn't lock, and the suppressed messages are
+// counted (see logging::report_suppressed()).
+#define LOG_FIRST_N(n, LEVEL)  if (EASY3D_LOG_SITE.first_n(n)) LOG(LEVEL)
+
+// Logs a message of this statement at most once every \p seconds seconds. The number of messages suppressed since
+// the previous one is prepended to the message.
+#define LOG_EVERY_SECONDS(seconds, LEVEL)  \
+    if (easy3d::logging::LogSite::Pass easy3d_log_pass = EASY3D_LOG_SITE.every_seconds(seconds)) \
+        LOG(LEVEL) << easy3d_log_pass
+
 
 namespace easy3d {
 
@@ -77,12 +138,82 @@ namespace easy3d {
         /// Returns the full path of the log file (empty if no log file has been created).
         std::string log_file();
 
+        /**
+         * @brief Enables/Disables the asynchronous logging.
+         * @details In the asynchronous mode, the logging thread only captures the log messages (with their time and
+         *      location), and a background thread formats and writes them (to the standard output and the log file).
+         *      The messages are passed through a lock-free ring buffer, so logging never blocks on formatting or I/O.
+         *      If the buffer is full, the messages are dropped and counted (see num_dropped()). FATAL messages are
+         *      always written immediately, after the pending ones. Custom format specifiers are not supported in the
+         *      asynchronous mode.
+         * @param b \c true to enable the asynchronous logging.
+         * @param capacity The number of messages the ring buffer can hold (rounded up to a power of two).
+         */
+        void set_asynchronous(bool b, std::size_t capacity = 8192);
+
+        /// Returns whether the asynchronous logging is enabled.
+        bool is_asynchronous();
+
+        /// Blocks until all the pending messages of the asynchronous logging have been written.
+        void flush();
+
+        /// Returns the number of messages dropped by the asynchronous logging because its buffer was full.
+        std::size_t num_dropped();
+
+        /**
+         * @brief Logs (at the WARNING level) the number of messages suppressed by LOG_FIRST_N() and
+         *      LOG_EVERY_SECONDS() since the last report.
+         * @return The total number of the reported messages.
+         */
+        std::size_t report_suppressed();
+
+        /// \brief The state of a rate-limited logging statement. Used by LOG_FIRST_N() and LOG_EVERY_SECONDS().
+        /// \class LogSite easy3d/util/logging.h
+        class LogSite {
+        public:
+            /// The result of the test of a rate-limited logging statement.
+            struct Pass {
+                Pass(bool pass, std::size_t suppressed) : pass(pass), suppressed(suppressed) {}
+                explicit operator bool() const { return pass; }
+                bool pass;
+                std::size_t suppressed; // the number of messages suppressed before this one
+            };
+
+        public:
+            LogSite(const char *file, int line);
+
+            /// Returns true for the first \p n hits.
+            bool first_n(std::size_t n) {
+                if (hits_.fetch_add(1, std::memory_order_relaxed) < n)
+                    return true;
+                suppressed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            /// Passes if at least \p seconds seconds have elapsed since the last pass.
+            Pass every_seconds(double seconds);
+
+        private:
+            const char *file_;
+            int line_;
+            std::atomic<std::size_t> hits_;
+            std::atomic<std::size_t> suppressed_;   // not reported yet
+            std::atomic<long long> last_pass_;      // in microseconds
+            LogSite *next_;                         // all sites are chained for report_suppressed()
+
+            friend std::size_t report_suppressed();
+        };
+
+        /// Writes the number of suppressed messages (if any) in front of a message.
+        std::ostream &operator<<(std::ostream &os, const LogSite::Pass &pass);
+
         /// Base class for a logger (that can log messages to whatever)
         /// Users should subclass Logger and override send() to do whatever they want.
         /// \class Logger easy3d/util/logging.h
         class Logger {
         public:
             Logger();
+            virtual ~Logger();
             /// writes the log message \p msg (and may also other given information).
             virtual void send(el::Level level, const std::string& msg) = 0;
         };
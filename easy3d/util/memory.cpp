@@ -0,0 +1,336 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/util/memory.h>
+
+#include <3rd_party/json/json.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#endif
+
+
+using json = nlohmann::json;
+
+
+namespace easy3d {
+
+    namespace memory {
+
+        namespace {
+
+            // the tallies of the allocation counter, maintained by the replaced operator new/delete below
+            std::atomic<std::size_t> counter_current(0);
+            std::atomic<std::size_t> counter_peak(0);
+            std::atomic<std::size_t> counter_allocations(0);
+
+            struct Tallies {
+                std::mutex mutex;
+                std::vector<std::pair<std::string, std::function<Usage()> > > tallies;
+            };
+
+            Tallies &tallies() {
+                static Tallies t;
+                return t;
+            }
+
+            json to_json_object(const Usage &usage) {
+                json object = {
+                        {"name",      usage.name},
+                        {"size",      usage.size},
+                        {"capacity",  usage.capacity},
+                        {"used",      usage.used},
+                        {"allocated", usage.allocated},
+                        {"children",  json::array()}
+                };
+                for (const auto &child : usage.children)
+                    object["children"].push_back(to_json_object(child));
+                return object;
+            }
+
+            // the resident memory of the process and its peak, in bytes (zero if unknown)
+            void resident_memory(std::size_t &current, std::size_t &peak) {
+                current = peak = 0;
+#if defined(_WIN32)
+                PROCESS_MEMORY_COUNTERS counters;
+                if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+                    current = counters.WorkingSetSize;
+                    peak = counters.PeakWorkingSetSize;
+                }
+#elif defined(__APPLE__)
+                mach_task_basic_info info;
+                mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+                if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) == KERN_SUCCESS) {
+                    current = info.resident_size;
+                    peak = info.resident_size_max;
+                }
+#else
+                std::ifstream input("/proc/self/status");
+                std::string line;
+                while (std::getline(input, line)) {
+                    std::size_t kb = 0;
+                    if (std::sscanf(line.c_str(), "VmRSS: %zu kB", &kb) == 1)
+                        current = kb * 1024;
+                    else if (std::sscanf(line.c_str(), "VmHWM: %zu kB", &kb) == 1)
+                        peak = kb * 1024;
+                }
+#endif
+            }
+
+            void raise_peak(std::size_t value) {
+                std::size_t peak = counter_peak.load(std::memory_order_relaxed);
+                while (value > peak && !counter_peak.compare_exchange_weak(peak, value, std::memory_order_relaxed)) {}
+            }
+
+        }
+
+
+        Usage &Usage::add(const Usage &child) {
+            children.push_back(child);
+            used += child.used;
+            allocated += child.allocated;
+            return *this;
+        }
+
+
+        void Usage::print(std::ostream &output, std::size_t depth) const {
+            output << std::string(depth, '\t') << name << ": ";
+            if (size > 0 || capacity > 0) {
+                output << size << " elements";
+                if (capacity != size)
+                    output << " (capacity " << capacity << ")";
+                output << ", ";
+            }
+            output << to_string(used);
+            if (allocated != used)
+                output << " (allocated " << to_string(allocated) << ")";
+            output << std::endl;
+            for (const auto &child : children)
+                child.print(output, depth + 1);
+        }
+
+
+        std::string Usage::to_json() const {
+            return to_json_object(*this).dump();
+        }
+
+
+        std::string to_string(std::size_t bytes) {
+            static const char *units[] = {"bytes", "KB", "MB", "GB", "TB"};
+            if (bytes < 1024)
+                return std::to_string(bytes) + " bytes";
+            double value = static_cast<double>(bytes);
+            int unit = 0;
+            while (value >= 1024.0 && unit < 4) {
+                value /= 1024.0;
+                ++unit;
+            }
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.1f %s", value, units[unit]);
+            return buffer;
+        }
+
+
+        void register_tally(const std::string &name, const std::function<Usage()> &tally) {
+            Tallies &t = tallies();
+            std::lock_guard<std::mutex> lock(t.mutex);
+            t.tallies.emplace_back(name, tally);
+        }
+
+
+        Usage process_usage() {
+            std::size_t resident = 0, peak = 0;
+            resident_memory(resident, peak);
+            Usage usage("process", 0, 0, resident, peak);
+
+            if (allocation_counter_enabled())
+                usage.children.push_back(Usage("heap (operator new)", 0, 0, allocated_bytes(), peak_allocated_bytes()));
+
+            Tallies &t = tallies();
+            std::lock_guard<std::mutex> lock(t.mutex);
+            for (const auto &tally : t.tallies) {
+                Usage child = tally.second();
+                child.name = tally.first;
+                usage.children.push_back(child);
+            }
+            return usage;
+        }
+
+
+        bool allocation_counter_enabled() {
+#ifdef EASY3D_ENABLE_ALLOCATION_COUNTER
+            return true;
+#else
+            return false;
+#endif
+        }
+
+
+        std::size_t allocated_bytes() {
+            return counter_current.load(std::memory_order_relaxed);
+        }
+
+
+        std::size_t peak_allocated_bytes() {
+            return counter_peak.load(std::memory_order_relaxed);
+        }
+
+
+        std::size_t num_allocations() {
+            return counter_allocations.load(std::memory_order_relaxed);
+        }
+
+
+        PeakScope::PeakScope() {
+            start_ = counter_current.load(std::memory_order_relaxed);
+            outer_peak_ = counter_peak.exchange(start_, std::memory_order_relaxed);
+        }
+
+
+        PeakScope::~PeakScope() {
+            raise_peak(outer_peak_);
+        }
+
+
+        std::size_t PeakScope::peak() const {
+            const std::size_t peak = counter_peak.load(std::memory_order_relaxed);
+            return peak > start_ ? peak - start_ : 0;
+        }
+
+
+#ifdef EASY3D_ENABLE_ALLOCATION_COUNTER
+        // \cond
+        namespace internal {
+
+            // the size of each block is stored in a header, which keeps the alignment guaranteed by operator new
+            const std::size_t header_size = alignof(std::max_align_t);
+
+            void *counted_malloc(std::size_t size) {
+                void *block = std::malloc(size + header_size);
+                if (!block)
+                    return nullptr;
+                *static_cast<std::size_t *>(block) = size;
+                raise_peak(counter_current.fetch_add(size, std::memory_order_relaxed) + size);
+                counter_allocations.fetch_add(1, std::memory_order_relaxed);
+                return static_cast<char *>(block) + header_size;
+            }
+
+            void counted_free(void *p) {
+                if (!p)
+                    return;
+                char *block = static_cast<char *>(p) - header_size;
+                counter_current.fetch_sub(*reinterpret_cast<std::size_t *>(block), std::memory_order_relaxed);
+                std::free(block);
+            }
+
+        }
+        // \endcond
+#endif
+
+    }
+
+}
+
+
+#ifdef EASY3D_ENABLE_ALLOCATION_COUNTER
+
+void *operator new(std::size_t size) {
+    if (size == 0)
+        size = 1;
+    void *p = nullptr;
+    while (!(p = easy3d::memory::internal::counted_malloc(size))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+    return p;
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *p) noexcept {
+    easy3d::memory::internal::counted_free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    easy3d::memory::internal::counted_free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    easy3d::memory::internal::counted_free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    easy3d::memory::internal::counted_free(p);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *p, std::size_t) noexcept {
+    easy3d::memory::internal::counted_free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    easy3d::memory::internal::counted_free(p);
+}
+#endif
+
+#endif  // EASY3D_ENABLE_ALLOCATION_COUNTER
@@ -0,0 +1,134 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#ifndef EASY3D_UTIL_MEMORY_H
+#define EASY3D_UTIL_MEMORY_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+#include <cstddef>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Memory accounting: structured reports of the memory used by models, drawables, and the process.
+     * \namespace easy3d::memory
+     * \details The memory used by an object (e.g., Model::memory_usage(), Drawable::memory_usage()) is reported as
+     *      a tree of Usage nodes. The process-wide tallies are given by process_usage().
+     *
+     *      An optional allocation counter replaces the global operator new/delete to count the bytes allocated by the
+     *      process. It is compiled in only if the CMake option EASY3D_ENABLE_ALLOCATION_COUNTER is ON, because it adds
+     *      a small header to every allocation. With it, the peak memory of an algorithm can be measured:
+     *      \code
+     *          memory::PeakScope scope;
+     *          SurfaceMesh* mesh = reconstruction.apply(cloud);
+     *          std::cout << "peak memory: " << memory::to_string(scope.peak()) << std::endl;
+     *      \endcode
+     */
+    namespace memory {
+
+        /**
+         * \brief A node in a memory report, e.g., a model, a property, or a GPU buffer.
+         * \details \c used is the number of bytes holding data, and \c allocated is the number of bytes reserved for
+         *      it (e.g., the capacity of a std::vector), which is never smaller than \c used. The bytes of the children
+         *      are included in their parent (see add()).
+         */
+        struct Usage {
+            explicit Usage(const std::string &name = "", std::size_t size = 0, std::size_t capacity = 0,
+                           std::size_t used = 0, std::size_t allocated = 0)
+                    : name(name), size(size), capacity(capacity), used(used), allocated(allocated) {}
+
+            /// Appends a child and accumulates its bytes.
+            Usage &add(const Usage &child);
+
+            /// Prints the tree, one node per line, indented by depth.
+            void print(std::ostream &output, std::size_t depth = 0) const;
+
+            /// Returns the tree in the JSON format.
+            std::string to_json() const;
+
+            std::string name;
+            std::size_t size;       ///< The number of elements (0 if not applicable).
+            std::size_t capacity;   ///< The number of elements that fit in the allocated memory.
+            std::size_t used;       ///< The bytes holding data.
+            std::size_t allocated;  ///< The bytes reserved.
+            std::vector<Usage> children;
+        };
+
+        /// Returns a human-readable string of a number of bytes, e.g., "12.3 MB".
+        std::string to_string(std::size_t bytes);
+
+        /**
+         * \brief Registers a process-wide tally to be included in process_usage().
+         * \details For example, the renderer registers the memory of the GPU buffers it has created.
+         */
+        void register_tally(const std::string &name, const std::function<Usage()> &tally);
+
+        /**
+         * \brief Returns the process-wide tallies.
+         * \details The root reports the resident memory of the process (\c used) and its peak (\c allocated), as
+         *      given by the operating system (zero if unknown). Its children are the heap allocated by operator new
+         *      (current and peak, if the allocation counter is enabled) and the registered tallies. The children are
+         *      not accumulated into the root.
+         */
+        Usage process_usage();
+
+        /// Returns whether the allocation counter has been compiled in (CMake option EASY3D_ENABLE_ALLOCATION_COUNTER).
+        bool allocation_counter_enabled();
+        /// Returns the number of bytes currently allocated by operator new (zero if the counter is not enabled).
+        std::size_t allocated_bytes();
+        /// Returns the peak of allocated_bytes() (zero if the counter is not enabled).
+        std::size_t peak_allocated_bytes();
+        /// Returns the number of allocations made by operator new so far (zero if the counter is not enabled).
+        std::size_t num_allocations();
+
+        /**
+         * \brief Measures the peak heap memory allocated during a scope, using the allocation counter.
+         * \details The peak counts the allocations of all threads. Scopes can be nested.
+         */
+        class PeakScope {
+        public:
+            PeakScope();
+            ~PeakScope();
+            /// Returns the peak of the bytes allocated since the scope was entered, on top of what was allocated
+            /// before (zero if the counter is not enabled).
+            std::size_t peak() const;
+        private:
+            std::size_t start_;
+            std::size_t outer_peak_;
+        };
+
+    }
+
+}
+
+
+#endif  // EASY3D_UTIL_MEMORY_H
@@ -0,0 +1,419 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/util/profiler.h>
+#include <easy3d/util/logging.h>
+
+#include <3rd_party/json/json.hpp>
+
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cstdio>
+
+
+// the keys are written in the order they are added
+using json = nlohmann::ordered_json;
+
+
+namespace easy3d {
+
+    // \cond
+    namespace internal {
+
+        struct ProfilerEvent {
+            const char *name;
+            double begin;   // in microseconds since the start of the recording
+            double end;
+            std::size_t elements;
+            std::size_t bytes;
+            int depth;
+        };
+
+
+        // the zones recorded by a single thread. Only the owner thread appends, without locking.
+        class ProfilerEventLog {
+        public:
+            explicit ProfilerEventLog(int id) : id_(id) { head_ = tail_ = new Chunk; }
+
+            ~ProfilerEventLog() {
+                clear();
+                delete head_;
+            }
+
+            int id() const { return id_; }
+
+            // called by the owner thread only
+            void append(const ProfilerEvent &e) {
+                Chunk *chunk = tail_;
+                std::size_t n = chunk->count.load(std::memory_order_relaxed);
+                if (n == Chunk::capacity) {
+                    auto next = new Chunk;
+                    chunk->next.store(next, std::memory_order_release);
+                    tail_ = chunk = next;
+                    n = 0;
+                }
+                chunk->events[n] = e;
+                chunk->count.store(n + 1, std::memory_order_release);
+            }
+
+            std::vector<ProfilerEvent> events() const {
+                std::vector<ProfilerEvent> result;
+                for (const Chunk *c = head_; c; c = c->next.load(std::memory_order_acquire)) {
+                    const std::size_t n = c->count.load(std::memory_order_acquire);
+                    result.insert(result.end(), c->events, c->events + n);
+                }
+                return result;
+            }
+
+            // must not be called while the owner thread is appending
+            void clear() {
+                Chunk *c = head_->next.load();
+                while (c) {
+                    Chunk *next = c->next.load();
+                    delete c;
+                    c = next;
+                }
+                head_->next = nullptr;
+                head_->count = 0;
+                tail_ = head_;
+            }
+
+        private:
+            struct Chunk {
+                Chunk() : count(0), next(nullptr) {}
+                static const std::size_t capacity = 4096;
+                ProfilerEvent events[capacity];
+                std::atomic<std::size_t> count;
+                std::atomic<Chunk *> next;
+            };
+
+            int id_;
+            Chunk *head_;
+            Chunk *tail_;
+        };
+
+
+        struct ProfilerRegistry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ProfilerEventLog> > logs;
+            std::atomic<unsigned int> session{0};
+            std::chrono::steady_clock::time_point origin;
+            std::mutex names_mutex;
+            std::set<std::string> names;    // the names interned for the zones
+        };
+
+        ProfilerRegistry &profiler_registry() {
+            static ProfilerRegistry registry;
+            return registry;
+        }
+
+        // the state of the calling thread
+        thread_local ProfilerEventLog *thread_log = nullptr;
+        thread_local Profiler::Zone *thread_zone = nullptr;
+        thread_local int thread_depth = 0;
+
+        ProfilerEventLog *profiler_thread_log() {
+            if (!thread_log) {
+                auto &registry = profiler_registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.logs.emplace_back(new ProfilerEventLog(static_cast<int>(registry.logs.size())));
+                thread_log = registry.logs.back().get();
+            }
+            return thread_log;
+        }
+
+        inline double profiler_time() {
+            using namespace std::chrono;
+            return duration<double, std::micro>(steady_clock::now() - profiler_registry().origin).count();
+        }
+
+    }
+    // \endcond
+
+
+    std::atomic<bool> Profiler::recording_(false);
+
+
+    void Profiler::Zone::begin(const char *name) {
+        name_ = name;
+        session_ = internal::profiler_registry().session.load(std::memory_order_relaxed);
+        elements_ = 0;
+        bytes_ = 0;
+        parent_ = internal::thread_zone;
+        internal::thread_zone = this;
+        ++internal::thread_depth;
+        start_ = internal::profiler_time();
+    }
+
+
+    void Profiler::Zone::end() {
+        const double end = internal::profiler_time();
+        internal::thread_zone = parent_;
+        const int depth = --internal::thread_depth;
+        // the zones still open when the recording stops are dropped
+        if (recording_.load(std::memory_order_acquire) &&
+            session_ == internal::profiler_registry().session.load(std::memory_order_relaxed))
+            internal::profiler_thread_log()->append({name_, start_, end, elements_, bytes_, depth});
+    }
+
+
+    void Profiler::start() {
+        stop();
+        clear();
+        auto &registry = internal::profiler_registry();
+        registry.origin = std::chrono::steady_clock::now();
+        ++registry.session;
+        recording_.store(true, std::memory_order_release);
+    }
+
+
+    void Profiler::stop() {
+        recording_.store(false, std::memory_order_release);
+    }
+
+
+    void Profiler::clear() {
+        auto &registry = internal::profiler_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto &log : registry.logs)
+            log->clear();
+    }
+
+
+    const char *Profiler::intern(const std::string &name) {
+        auto &registry = internal::profiler_registry();
+        std::lock_guard<std::mutex> lock(registry.names_mutex);
+        return registry.names.insert(name).first->c_str();
+    }
+
+
+    void Profiler::add_elements(std::size_t n) {
+        if (internal::thread_zone)
+            internal::thread_zone->add_elements(n);
+    }
+
+
+    void Profiler::add_bytes(std::size_t n) {
+        if (internal::thread_zone)
+            internal::thread_zone->add_bytes(n);
+    }
+
+
+    std::size_t Profiler::num_events() {
+        auto &registry = internal::profiler_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::size_t num = 0;
+        for (const auto &log : registry.logs)
+            num += log->events().size();
+        return num;
+    }
+
+
+    std::vector<Profiler::Statistics> Profiler::statistics() {
+        struct Node {
+            Statistics stats;
+            std::vector<std::size_t> children;
+            std::map<std::string, std::size_t> child_index;
+        };
+        std::vector<Node> nodes(1); // nodes[0] is the (virtual) root
+
+        auto &registry = internal::profiler_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto &log : registry.logs) {
+            auto events = log->events();
+            // the enclosing zones first
+            std::sort(events.begin(), events.end(), [](const internal::ProfilerEvent &a, const internal::ProfilerEvent &b) {
+                return a.begin < b.begin || (a.begin == b.begin && a.depth < b.depth);
+            });
+
+            std::vector<std::pair<std::size_t, int> > stack;    // (node, depth) of the enclosing zones
+            for (const auto &e : events) {
+                while (!stack.empty() && stack.back().second >= e.depth)
+                    stack.pop_back();
+                const std::size_t parent = stack.empty() ? 0 : stack.back().first;
+
+                std::size_t index = 0;
+                auto pos = nodes[parent].child_index.find(e.name);
+                if (pos == nodes[parent].child_index.end()) {
+                    index = nodes.size();
+                    nodes[parent].child_index[e.name] = index;
+                    nodes[parent].children.push_back(index);
+                    Node node;
+                    node.stats.name = e.name;
+                    node.stats.path = parent == 0 ? e.name : nodes[parent].stats.path + "/" + e.name;
+                    node.stats.depth = parent == 0 ? 0 : nodes[parent].stats.depth + 1;
+                    node.stats.count = 0;
+                    node.stats.total = node.stats.self = 0.0;
+                    node.stats.min = std::numeric_limits<double>::max();
+                    node.stats.max = 0.0;
+                    node.stats.elements = node.stats.bytes = 0;
+                    nodes.push_back(node);
+                } else
+                    index = pos->second;
+
+                const double duration = (e.end - e.begin) * 0.001;
+                Statistics &s = nodes[index].stats;
+                ++s.count;
+                s.total += duration;
+                s.self += duration;
+                s.min = std::min(s.min, duration);
+                s.max = std::max(s.max, duration);
+                s.elements += e.elements;
+                s.bytes += e.bytes;
+                if (parent != 0)
+                    nodes[parent].stats.self -= duration;
+
+                stack.emplace_back(index, e.depth);
+            }
+        }
+
+        std::vector<Statistics> result;
+        std::vector<std::size_t> stack(nodes[0].children.rbegin(), nodes[0].children.rend());
+        while (!stack.empty()) {
+            const std::size_t index = stack.back();
+            stack.pop_back();
+            result.push_back(nodes[index].stats);
+            stack.insert(stack.end(), nodes[index].children.rbegin(), nodes[index].children.rend());
+        }
+        return result;
+    }
+
+
+    std::string Profiler::report() {
+        const auto stats = statistics();
+        std::ostringstream output;
+        char line[512];
+        std::snprintf(line, sizeof(line), "%-48s %10s %12s %12s %12s %12s %12s\n",
+                      "zone", "count", "total (ms)", "self (ms)", "max (ms)", "elements", "bytes");
+        output << line;
+        for (const auto &s : stats) {
+            const std::string name = std::string(s.depth * 2, ' ') + s.name;
+            std::snprintf(line, sizeof(line), "%-48s %10zu %12.3f %12.3f %12.3f %12zu %12zu\n",
+                          name.c_str(), s.count, s.total, s.self, s.max, s.elements, s.bytes);
+            output << line;
+        }
+        return output.str();
+    }
+
+
+    bool Profiler::save_trace(const std::string &file_name) {
+        TraceWriter writer;
+        auto &registry = internal::profiler_registry();
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (const auto &log : registry.logs) {
+                const auto events = log->events();
+                if (events.empty())
+                    continue;
+                writer.add_thread(log->id(), "thread " + std::to_string(log->id()));
+                for (const auto &e : events) {
+                    writer.add_event(e.name, "easy3d", log->id(), e.begin, e.end - e.begin,
+                                     {{"elements", e.elements}, {"bytes", e.bytes}});
+                }
+            }
+        }
+        return writer.save(file_name);
+    }
+
+
+    bool Profiler::save_statistics(const std::string &file_name) {
+        const auto stats = statistics();
+        std::ofstream output(file_name.c_str());
+        if (!output.is_open()) {
+            LOG(ERROR) << "could not open file: " << file_name;
+            return false;
+        }
+
+        json zones = json::array();
+        for (const auto &s : stats) {
+            zones.push_back({
+                    {"name",     s.name},
+                    {"path",     s.path},
+                    {"depth",    s.depth},
+                    {"count",    s.count},
+                    {"total_ms", s.total},
+                    {"self_ms",  s.self},
+                    {"min_ms",   s.min},
+                    {"max_ms",   s.max},
+                    {"elements", s.elements},
+                    {"bytes",    s.bytes}
+            });
+        }
+        output << zones.dump(2) << std::endl;
+        return output.good();
+    }
+
+    //_________________________________________________________
+
+
+    void TraceWriter::add_thread(int tid, const std::string &name) {
+        threads_.emplace_back(tid, name);
+    }
+
+
+    void TraceWriter::add_event(const std::string &name, const std::string &category, int tid, double begin,
+                                double duration, const Arguments &args) {
+        events_.push_back({name, category, tid, begin, duration, args});
+    }
+
+
+    bool TraceWriter::save(const std::string &file_name) const {
+        std::ofstream output(file_name.c_str());
+        if (!output.is_open()) {
+            LOG(ERROR) << "could not open file: " << file_name;
+            return false;
+        }
+
+        json events = json::array();
+        for (const auto &t : threads_)
+            events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", t.first},
+                              {"args", {{"name", t.second}}}});
+        for (const auto &e : events_) {
+            json event = {{"name", e.name}, {"cat", e.category}, {"ph", "X"}, {"ts", e.begin}, {"dur", e.duration},
+                          {"pid", 0}, {"tid", e.tid}};
+            if (!e.args.empty()) {
+                json args = json::object();
+                for (const auto &arg : e.args)
+                    args[arg.first] = arg.second;
+                event["args"] = args;
+            }
+            events.push_back(event);
+        }
+
+        const json trace = {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+        output << trace.dump() << std::endl;
+        return output.good();
+    }
+
+}
@@ -0,0 +1,221 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#ifndef EASY3D_UTIL_PROFILER_H
+#define EASY3D_UTIL_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <utility>
+#include <cstddef>
+
+
+// The profiling zones are compiled out if EASY3D_DISABLE_PROFILER is defined (CMake option EASY3D_ENABLE_PROFILER).
+#ifndef EASY3D_DISABLE_PROFILER
+// \cond
+#  define EASY3D_PROFILER_CONCAT_(a, b) a##b
+#  define EASY3D_PROFILER_CONCAT(a, b) EASY3D_PROFILER_CONCAT_(a, b)
+// \endcond
+/// Profiles the enclosing scope as a zone named \p name (a string literal).
+#  define EASY3D_PROFILE_ZONE(name) easy3d::Profiler::Zone EASY3D_PROFILER_CONCAT(easy3d_profile_zone_, __LINE__)(name)
+/// Profiles the enclosing function.
+#  define EASY3D_PROFILE_FUNCTION() EASY3D_PROFILE_ZONE(__func__)
+/// Adds \p n to the number of elements processed in the innermost zone of the calling thread (\p n is evaluated
+/// only when recording).
+#  define EASY3D_PROFILE_ELEMENTS(n) \
+    do { if (easy3d::Profiler::is_recording()) easy3d::Profiler::add_elements(n); } while (false)
+/// Adds \p n to the number of bytes processed in the innermost zone of the calling thread (\p n is evaluated
+/// only when recording).
+#  define EASY3D_PROFILE_BYTES(n) \
+    do { if (easy3d::Profiler::is_recording()) easy3d::Profiler::add_bytes(n); } while (false)
+#else
+#  define EASY3D_PROFILE_ZONE(name) ((void)0)
+#  define EASY3D_PROFILE_FUNCTION() ((void)0)
+#  define EASY3D_PROFILE_ELEMENTS(n) ((void)0)
+#  define EASY3D_PROFILE_BYTES(n) ((void)0)
+#endif
+
+
+namespace easy3d {
+
+    /**
+     * \brief A hierarchical profiler of scoped zones, which can be used from any thread.
+     * \class Profiler easy3d/util/profiler.h
+     * \details The code to be profiled is instrumented with zones (see EASY3D_PROFILE_ZONE()), which record the
+     *      time spent from their construction to their destruction, and optionally the number of elements and bytes
+     *      processed in them. Zones record nothing unless the profiler is recording (a single atomic load), and they
+     *      are compiled out entirely if EASY3D_DISABLE_PROFILER is defined.
+     *
+     *      Each thread records its zones into its own buffer without any lock. The zones of a thread nested in each
+     *      other form a hierarchy. The statistics aggregate the zones having the same path (i.e., the names of the
+     *      enclosing zones and the zone) over all threads. The recorded zones can be saved in the Chrome trace format
+     *      (viewable in chrome://tracing or https://ui.perfetto.dev).
+     *
+     *      The recorded data should be accessed (i.e., statistics(), report(), save_trace()) after stop().
+     *
+     *      Usage example:
+     *      \code
+     *      Profiler::start();
+     *      {
+     *          EASY3D_PROFILE_ZONE("load");
+     *          ...
+     *          EASY3D_PROFILE_ELEMENTS(mesh->n_faces());
+     *      }
+     *      Profiler::stop();
+     *      std::cout << Profiler::report();
+     *      Profiler::save_trace("trace.json");
+     *      \endcode
+     * \see FrameProfiler, StopWatch
+     */
+    class Profiler {
+    public:
+        /// The aggregated statistics of the zones with the same path. All the times are in milliseconds.
+        struct Statistics {
+            std::string name;       ///< The name of the zone.
+            std::string path;       ///< The names of the enclosing zones and the zone, separated by '/'.
+            int depth;              ///< The nesting depth. Zones not enclosed by any other zone have depth 0.
+            std::size_t count;      ///< The number of times the zone was entered.
+            double total;           ///< The total time spent in the zone.
+            double self;            ///< The total time spent in the zone, excluding the nested zones.
+            double min, max;        ///< The minimum and maximum time of a single entry.
+            std::size_t elements;   ///< The total number of elements processed.
+            std::size_t bytes;      ///< The total number of bytes processed.
+        };
+
+        /// \brief A zone that is recorded from its construction to its destruction, if the profiler is recording.
+        /// \details Use EASY3D_PROFILE_ZONE() instead, which can be compiled out.
+        class Zone {
+        public:
+            /// \param name The name of the zone. It must outlive the recording (a string literal, or see intern()).
+            explicit Zone(const char *name) : session_(0) {
+                if (recording_.load(std::memory_order_acquire))
+                    begin(name);
+            }
+            ~Zone() {
+                if (session_ != 0)
+                    end();
+            }
+            void add_elements(std::size_t n) { elements_ += n; }
+            void add_bytes(std::size_t n) { bytes_ += n; }
+
+        private:
+            Zone(const Zone &);
+            Zone &operator=(const Zone &);
+            void begin(const char *name);
+            void end();
+
+            const char *name_;
+            unsigned int session_;  // 0 if the zone is not recorded
+            double start_;
+            std::size_t elements_;
+            std::size_t bytes_;
+            Zone *parent_;
+        };
+
+    public:
+        /// Starts recording. The previously recorded data is discarded.
+        static void start();
+        /// Stops recording. The zones still open are not recorded.
+        static void stop();
+        /// Returns whether the profiler is recording.
+        static bool is_recording() { return recording_.load(std::memory_order_relaxed); }
+        /// Discards the recorded data.
+        static void clear();
+
+        /// Returns a copy of \p name that lives until the program exits, for naming zones at run time.
+        static const char *intern(const std::string &name);
+
+        /// Adds \p n to the number of elements processed in the innermost zone of the calling thread.
+        static void add_elements(std::size_t n);
+        /// Adds \p n to the number of bytes processed in the innermost zone of the calling thread.
+        static void add_bytes(std::size_t n);
+
+        /// Returns the number of recorded zones.
+        static std::size_t num_events();
+
+        /// Returns the aggregated statistics, in depth-first order (the children of a zone in the order of their
+        /// first occurrence).
+        static std::vector<Statistics> statistics();
+
+        /// Returns a text report of the statistics (one line per zone, indented by depth).
+        static std::string report();
+
+        /// Saves the recorded zones in the Chrome trace format (JSON).
+        static bool save_trace(const std::string &file_name);
+
+        /// Saves the aggregated statistics in JSON.
+        static bool save_statistics(const std::string &file_name);
+
+    private:
+        static std::atomic<bool> recording_;
+    };
+
+
+    /**
+     * \brief Collects events and saves them in the Chrome trace format (JSON), which can be viewed in
+     *      chrome://tracing or https://ui.perfetto.dev.
+     * \class TraceWriter easy3d/util/profiler.h
+     * \see Profiler::save_trace(), FrameProfiler::save_chrome_trace()
+     */
+    class TraceWriter {
+    public:
+        /// The arguments of an event (pairs of names and values), shown when the event is selected.
+        typedef std::vector<std::pair<std::string, std::size_t> > Arguments;
+
+        /// Names the thread \p tid.
+        void add_thread(int tid, const std::string &name);
+
+        /**
+         * \brief Adds an event that spans a time interval.
+         * \param begin The beginning of the event, in microseconds.
+         * \param duration The duration of the event, in microseconds.
+         */
+        void add_event(const std::string &name, const std::string &category, int tid, double begin, double duration,
+                       const Arguments &args = Arguments());
+
+        /// Saves the threads and the events to a file.
+        bool save(const std::string &file_name) const;
+
+    private:
+        struct Event {
+            std::string name;
+            std::string category;
+            int tid;
+            double begin;
+            double duration;
+            Arguments args;
+        };
+        std::vector<std::pair<int, std::string> > threads_;
+        std::vector<Event> events_;
+    };
+
+}   // namespace easy3d
+
+
+#endif  // EASY3D_UTIL_PROFILER_H
@@ -13,6 +13,8 @@
 
 #include <cassert>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
 
 
 namespace easy3d {
@@ -27,22 +29,24 @@ namespace easy3d {
             virtual void notify(std::size_t percent, bool update_viewer);
 
             void set_client(ProgressClient *c) { client_ = c; }
+            void remove_client(ProgressClient *c) { client_.compare_exchange_strong(c, nullptr); }
 
             void push();
             void pop();
 
-            void cancel() { canceled_ = true; }
-            void clear_canceled() { canceled_ = false; }
-            bool is_canceled() const { return canceled_; }
+            void cancel() { canceled_.store(true, std::memory_order_relaxed); }
+            void clear_canceled() { canceled_.store(false, std::memory_order_relaxed); }
+            bool is_canceled() const { return canceled_.load(std::memory_order_relaxed); }
 
         protected:
             Progress() : client_(nullptr), level_(0), canceled_(false) {}
 
             virtual ~Progress() {}
 
-            ProgressClient *client_;
-            int level_;
-            bool canceled_;
+            std::atomic<ProgressClient*> client_;
+            std::atomic<int> level_;
+            std::atomic<bool> canceled_;
+            std::mutex mutex_;  // serializes the notifications of the client
         };
 
         Progress* Progress::instance() {
@@ -51,8 +55,7 @@ namespace easy3d {
         }
 
         void Progress::push() {
-            level_++;
-            if (level_ == 1) {
+            if (++level_ == 1) {
                 clear_canceled();
             }
         }
@@ -63,8 +66,28 @@ namespace easy3d {
         }
 
         void Progress::notify(std::size_t percent, bool update_viewer) {
-            if (client_ != nullptr && level_ < 2)
-                client_->notify(percent, update_viewer);
+            if (level_ < 2) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ProgressClient *client = client_;
+                if (client != nullptr)
+                    client->notify(percent, update_viewer);
+            }
+        }
+
+
+        // the progress of the sub-ranges is accumulated in fractions of 1/sub_scale step
+        const std::size_t sub_scale = 1024;
+
+        // each thread picks one of the counters of a logger (the same for all loggers), round-robin
+        inline int counter_index(int num_counters) {
+            static std::atomic<int> next_index(0);
+            static thread_local int index = next_index++;
+            return index % num_counters;
+        }
+
+        inline double time_ms() {
+            using namespace std::chrono;
+            return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
         }
     }
     //  \endcond
@@ -76,6 +99,12 @@ namespace easy3d {
         details::Progress::instance()->set_client(this);
     }
 
+
+    ProgressClient::~ProgressClient() {
+        details::Progress::instance()->remove_client(this);
+    }
+
+
     void ProgressClient::cancel() {
         details::Progress::instance()->cancel();
     }
@@ -83,13 +112,27 @@ namespace easy3d {
     //_________________________________________________________
 
 
+    std::atomic<unsigned int> ProgressLogger::notification_interval_(100);
+
+
     ProgressLogger::ProgressLogger(std::size_t max_val, bool update_viewer, bool quiet)
             : max_val_(max_val)
-            , cur_val_(0)
+            , base_val_(0)
+            , sub_val_(0)
             , cur_percent_(0)
             , quiet_(quiet)
             , update_viewer_(update_viewer)
+            , parent_(nullptr)
+            , parent_steps_(0)
+            , reported_(0)
+            , owner_(std::this_thread::get_id())
+            , calls_(0)
+            , stride_(1)
     {
+        for (auto &c : counters_)
+            c.value = 0;
+        last_check_ = last_notify_ = details::time_ms();
+
         details::Progress::instance()->push();
         if (!quiet_) {
             details::Progress::instance()->notify(0, update_viewer_);
@@ -97,7 +140,35 @@ namespace easy3d {
     }
 
 
+    ProgressLogger::ProgressLogger(ProgressLogger *parent, std::size_t parent_steps, std::size_t max_val)
+            : max_val_(max_val)
+            , base_val_(0)
+            , sub_val_(0)
+            , cur_percent_(0)
+            , quiet_(true)
+            , update_viewer_(false)
+            , parent_(parent)
+            , parent_steps_(parent_steps)
+            , reported_(0)
+            , owner_(std::this_thread::get_id())
+            , calls_(0)
+            , stride_(1)
+    {
+        assert(parent);
+        for (auto &c : counters_)
+            c.value = 0;
+        last_check_ = last_notify_ = details::time_ms();
+    }
+
+
     ProgressLogger::~ProgressLogger() {
+        if (parent_) {
+            // replaces the partial progress by the full sub-range
+            parent_->sub_val_ -= reported_;
+            parent_->advance(parent_steps_);
+            return;
+        }
+
         // one more notification to make sure the progress reaches its end
         details::Progress::instance()->notify(100, update_viewer_);
         details::Progress::instance()->pop();
@@ -105,17 +176,33 @@ namespace easy3d {
 
 
     void ProgressLogger::notify(std::size_t new_value) {
-        cur_val_ = new_value;
-        update();
+        for (auto &c : counters_)
+            c.value.store(0, std::memory_order_relaxed);
+        base_val_ = new_value;
+        if (std::this_thread::get_id() == owner_)
+            publish(true);
     }
 
 
-    void ProgressLogger::next() {
-        cur_val_++;
+    void ProgressLogger::advance(std::size_t steps) {
+        counters_[details::counter_index(num_counters)].value.fetch_add(steps, std::memory_order_relaxed);
         update();
     }
 
 
+    std::size_t ProgressLogger::steps() const {
+        std::size_t steps = base_val_.load(std::memory_order_relaxed);
+        for (const auto &c : counters_)
+            steps += c.value.load(std::memory_order_relaxed);
+        return steps;
+    }
+
+
+    std::size_t ProgressLogger::value() const {
+        return steps() + sub_val_.load(std::memory_order_relaxed) / details::sub_scale;
+    }
+
+
     bool ProgressLogger::is_canceled() const {
         return details::Progress::instance()->is_canceled();
     }
@@ -127,8 +214,61 @@ namespace easy3d {
     }
 
 
+    void ProgressLogger::set_notification_interval(unsigned int ms) {
+        notification_interval_ = ms;
+    }
+
+
+    unsigned int ProgressLogger::notification_interval() {
+        return notification_interval_;
+    }
+
+
     void ProgressLogger::update() {
-        std::size_t percent = cur_val_ * 100 / std::max<std::size_t>(1, max_val_ - 1);
+        // only the thread that created the logger notifies the client (and the parent)
+        if (std::this_thread::get_id() != owner_)
+            return;
+
+        const unsigned int interval = notification_interval_;
+        if (interval == 0) {
+            publish(false);
+            return;
+        }
+
+        // reading the clock is not free, so the clock is read every stride_ calls, where the stride adapts to keep
+        // about one reading per millisecond
+        if (++calls_ < stride_)
+            return;
+        calls_ = 0;
+        const double now = details::time_ms();
+        if (now - last_check_ < 1.0)
+            stride_ = std::min<std::size_t>(stride_ * 2, 4096);
+        else if (stride_ > 1)
+            stride_ /= 2;
+        last_check_ = now;
+
+        if (now - last_notify_ >= interval)
+            publish(false);
+    }
+
+
+    void ProgressLogger::publish(bool force) {
+        last_notify_ = details::time_ms();
+        const double current = static_cast<double>(steps()) + static_cast<double>(sub_val_.load()) / details::sub_scale;
+
+        if (parent_) {
+            const double fraction = std::min(1.0, current / static_cast<double>(std::max<std::size_t>(1, max_val_)));
+            const auto reported = static_cast<std::size_t>(fraction * parent_steps_ * details::sub_scale);
+            parent_->sub_val_ += reported - reported_;  // wraps around correctly if the progress has been reset
+            reported_ = reported;
+            if (force && parent_->owner_ == std::this_thread::get_id())
+                parent_->publish(true);
+            else
+                parent_->update();
+            return;
+        }
+
+        const auto percent = static_cast<std::size_t>(current * 100 / std::max<std::size_t>(1, max_val_ - 1));
         if (percent != cur_percent_) {
             cur_percent_ = percent;
             if (!quiet_) {
@@ -137,4 +277,4 @@ namespace easy3d {
         }
     }
 
-}
\ No newline at end of file
+}
@@ -13,18 +13,22 @@
 
 
 #include <string>
+#include <atomic>
+#include <thread>
 
 
 namespace easy3d {
 
     /**
      * \brief The based class of GUI element reporting the progress.
+     * \details The client is notified only from the thread that created the (outermost) ProgressLogger, which is
+     *      typically the GUI thread, so the client doesn't have to be thread-safe.
      * \class ProgressClient easy3d/util/progress.h
      */
     class ProgressClient {
     public:
         ProgressClient();
-        virtual ~ProgressClient() {}
+        virtual ~ProgressClient();
         virtual void notify(std::size_t percent, bool update_viewer) = 0;
         virtual void cancel();
     };
@@ -33,7 +37,25 @@ namespace easy3d {
 
     /**
      * \brief An implementation of progress logging mechanism.
+     * \details The progress can be advanced concurrently (by the threads of the ThreadPool, OpenMP, or any other
+     *      threads) using next() and advance(). The steps are accumulated in per-thread counters to avoid contention,
+     *      and the client is notified at most once per notification_interval() (plus the first and the last
+     *      notifications). A long task can be split into weighted sub-ranges, each reported by a child logger.
+     *      is_canceled() is a single atomic load and can be called in inner loops.
      * \class ProgressLogger easy3d/util/progress.h
+     *
+     * Example usage:
+     *      \code
+     *          ProgressLogger progress(2, false);  // two stages
+     *          {
+     *              ProgressLogger stage(&progress, 1, num);  // the first stage, taking num steps
+     *              parallel_for(0, num, [&](int i) {
+     *                  ...
+     *                  stage.next();
+     *              }, &stage);
+     *          }   // the parent has advanced by one step
+     *          ...
+     *      \endcode
      */
     class ProgressLogger {
     public:
@@ -41,12 +63,30 @@ namespace easy3d {
         /// \param update_viewer \c true to trigger the viewer to update for each step.
         /// \param quiet \c true to make the logger quiet (i.e., don't notify the client).
         ProgressLogger(std::size_t max_val, bool update_viewer, bool quiet = false);
+
+        /// \brief Creates a logger reporting a sub-range of \p parent.
+        /// \details When this logger reaches its end, \p parent has advanced by \p parent_steps. In between, \p parent
+        ///     advances proportionally. The sub-range is completed when this logger is destroyed.
+        /// \param parent The parent logger (must outlive this logger).
+        /// \param parent_steps The number of steps of \p parent this logger corresponds to.
+        /// \param max_val The max value (i.e., upper bound) of the progress range of this logger.
+        ProgressLogger(ProgressLogger *parent, std::size_t parent_steps, std::size_t max_val);
+
         virtual ~ProgressLogger();
 
+        /// Sets the progress value. Unlike next() and advance(), it should not be called concurrently.
         virtual void notify(std::size_t new_value);
-        virtual void next();
+        /// Advances the progress by one step. It is thread-safe.
+        virtual void next() { advance(1); }
+        /// Advances the progress by \p steps steps. It is thread-safe.
+        void advance(std::size_t steps);
         virtual void done() { notify(max_val_); }
 
+        /// Returns the current progress value, i.e., the steps done so far, including the fraction of the sub-ranges.
+        std::size_t value() const;
+        /// Returns the max value (i.e., upper bound) of the progress range.
+        std::size_t max_value() const { return max_val_; }
+
         bool is_canceled() const;
 
         /// Resets the progress logger without changing the progress range.
@@ -54,19 +94,50 @@ namespace easy3d {
         /// Resets the progress logger, and meanwhile changes the progress range.
         void reset(std::size_t max_val);
 
+        /// Sets the minimum time interval (in milliseconds) between two consecutive notifications of the client.
+        /// The default value is 100 ms. Use 0 to notify the client at every percent change.
+        static void set_notification_interval(unsigned int ms);
+        /// Returns the minimum time interval (in milliseconds) between two consecutive notifications of the client.
+        static unsigned int notification_interval();
+
     protected:
         virtual void update();
 
     private:
+        void publish(bool force);
+        std::size_t steps() const;
+
+    private:
+        // the counters are padded to separate cache lines so threads don't contend
+        struct Counter {
+            std::atomic<std::size_t> value;
+            char padding[64 - sizeof(std::atomic<std::size_t>)];
+        };
+        static const int num_counters = 16;
+        Counter counters_[num_counters];
+
         std::size_t max_val_;
-        std::size_t cur_val_;
+        std::atomic<std::size_t> base_val_;  // the value set by notify()
+        std::atomic<std::size_t> sub_val_;   // the (scaled) progress of the unfinished sub-ranges
         std::size_t cur_percent_;
         bool quiet_;
         bool update_viewer_;
+
+        ProgressLogger *parent_;
+        std::size_t parent_steps_;
+        std::size_t reported_;  // the (scaled) progress reported to the parent
+
+        // the throttling state, accessed only by the owner thread
+        std::thread::id owner_;
+        std::size_t calls_;
+        std::size_t stride_;
+        double last_check_;
+        double last_notify_;
+
+        static std::atomic<unsigned int> notification_interval_;
     };
 
 }   // namespace easy3d
 
 
 #endif  // EASY3D_UTIL_PROGRESS_H
-
@@ -0,0 +1,295 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/util/thread_pool.h>
+
+#include <cstdlib>
+#include <chrono>
+#include <deque>
+
+#include <easy3d/util/progress.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    std::atomic<std::size_t> ThreadPool::concurrency_(0);
+    std::shared_ptr<ThreadPool> ThreadPool::instance_;
+    std::mutex ThreadPool::instance_mutex_;
+
+
+    struct ThreadPool::State {
+        explicit State(std::size_t num_queues);
+
+        // pops a task, from the queue of worker 'self' first (if self >= 0), otherwise steals one from the others
+        bool pop(int self, std::function<void()> &task);
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()> > tasks;
+        };
+        std::vector<std::unique_ptr<Queue> > queues;    // at least one, even if there are no workers
+
+        std::atomic<std::size_t> num_pending;   // the number of tasks in all the queues
+        std::atomic<std::size_t> next_queue;    // for distributing the tasks submitted by non-worker threads
+        bool stopped;
+        std::mutex mutex;                       // for the idle workers
+        std::condition_variable condition;
+    };
+
+
+    namespace {
+        // the index of the worker running on the current thread (-1 for the other threads), and the state of its pool
+        thread_local int worker_index = -1;
+        thread_local const void *worker_pool = nullptr;
+    }
+
+
+    std::size_t ThreadPool::default_concurrency() {
+        const char *value = std::getenv("EASY3D_NUM_THREADS");
+        if (value) {
+            const int n = std::atoi(value);
+            if (n > 0)
+                return static_cast<std::size_t>(n);
+            LOG(WARNING) << "ignored invalid value of EASY3D_NUM_THREADS: " << value;
+        }
+        const unsigned int n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+
+    std::size_t ThreadPool::concurrency() {
+        std::size_t n = concurrency_;
+        if (n == 0) {
+            std::size_t expected = 0;
+            concurrency_.compare_exchange_strong(expected, default_concurrency());
+            n = concurrency_;
+        }
+        return n;
+    }
+
+
+    void ThreadPool::set_concurrency(std::size_t n) {
+        std::lock_guard<std::mutex> lock(instance_mutex_);
+        if (n == 0)
+            n = default_concurrency();
+        if (n == concurrency_)
+            return;
+        // the workers are (re)started with the new concurrency at the next use. The running algorithms hold the
+        // previous pool, which is destroyed (and its workers joined) when they are done.
+        std::atomic_store(&instance_, std::shared_ptr<ThreadPool>());
+        concurrency_ = n;
+    }
+
+
+    std::shared_ptr<ThreadPool> ThreadPool::instance() {
+        std::shared_ptr<ThreadPool> pool = std::atomic_load(&instance_);
+        if (pool)
+            return pool;
+
+        std::lock_guard<std::mutex> lock(instance_mutex_);
+        pool = std::atomic_load(&instance_);
+        if (!pool) {
+            pool.reset(new ThreadPool(concurrency() - 1));
+            std::atomic_store(&instance_, pool);
+        }
+        return pool;
+    }
+
+
+    int ThreadPool::current_worker() {
+        return worker_index;
+    }
+
+
+    int ThreadPool::self() const {
+        return worker_pool == state_.get() ? worker_index : -1;
+    }
+
+
+    ThreadPool::State::State(std::size_t num_queues)
+            : num_pending(0), next_queue(0), stopped(false) {
+        for (std::size_t i = 0; i < num_queues; ++i)
+            queues.emplace_back(new Queue);
+    }
+
+
+    ThreadPool::ThreadPool(std::size_t num_workers)
+            : state_(new State(std::max<std::size_t>(num_workers, 1))) {
+        for (std::size_t i = 0; i < num_workers; ++i)
+            workers_.emplace_back(&ThreadPool::work, state_, i);
+    }
+
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stopped = true;
+        }
+        state_->condition.notify_all();
+        for (auto &worker : workers_) {
+            // The last reference may be released by a task running on one of the workers. The worker then exits
+            // when the task returns, and it keeps the state alive until then.
+            if (worker.get_id() == std::this_thread::get_id())
+                worker.detach();
+            else
+                worker.join();
+        }
+        LOG_IF(state_->num_pending > 0, WARNING) << state_->num_pending << " pending tasks discarded";
+    }
+
+
+    void ThreadPool::submit(std::function<void()> task) {
+        State &state = *state_;
+        const int self = this->self();
+        const std::size_t index = (self >= 0 && static_cast<std::size_t>(self) < state.queues.size())
+                                  ? static_cast<std::size_t>(self) : (state.next_queue++ % state.queues.size());
+        // counted first, so the counter never underflows when the task is stolen immediately
+        ++state.num_pending;
+        {
+            std::lock_guard<std::mutex> lock(state.queues[index]->mutex);
+            state.queues[index]->tasks.push_back(std::move(task));
+        }
+        {   // an idle worker checks the counter while holding the mutex, so the notification cannot be missed
+            std::lock_guard<std::mutex> lock(state.mutex);
+        }
+        state.condition.notify_one();
+    }
+
+
+    bool ThreadPool::State::pop(int self, std::function<void()> &task) {
+        const std::size_t num = queues.size();
+        if (self >= 0 && static_cast<std::size_t>(self) < num) {   // the most recent task of its own queue
+            Queue &queue = *queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                --num_pending;
+                return true;
+            }
+        }
+
+        // steal the oldest task of another queue
+        const std::size_t start = (self >= 0) ? static_cast<std::size_t>(self) + 1 : next_queue.load();
+        for (std::size_t k = 0; k < num; ++k) {
+            const std::size_t index = (start + k) % num;
+            if (static_cast<int>(index) == self)
+                continue;
+            Queue &queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                --num_pending;
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    bool ThreadPool::run_pending_task() {
+        std::function<void()> task;
+        if (!state_->pop(self(), task))
+            return false;
+        task();
+        return true;
+    }
+
+
+    void ThreadPool::work(std::shared_ptr<State> state, std::size_t index) {
+        worker_index = static_cast<int>(index);
+        worker_pool = state.get();
+        std::function<void()> task;
+        while (true) {
+            if (state->pop(worker_index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->condition.wait(lock, [&state]() { return state->stopped || state->num_pending > 0; });
+            if (state->stopped)
+                break;
+        }
+    }
+
+
+    //_________________________________________________________
+
+
+    TaskGroup::TaskGroup(ProgressLogger *progress)
+            : pool_(ThreadPool::instance()), progress_(progress), num_running_(0), canceled_(false) {
+    }
+
+
+    TaskGroup::~TaskGroup() {
+        wait_all();
+    }
+
+
+    bool TaskGroup::is_canceled() const {
+        return canceled_ || (progress_ && progress_->is_canceled());
+    }
+
+
+    void TaskGroup::finish_task() {
+        // decremented while holding the mutex, so wait_all() cannot return (and the group be destroyed) before the
+        // notification is done
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--num_running_ == 0)
+            finished_.notify_all();
+    }
+
+
+    void TaskGroup::wait_all() {
+        while (num_running_ > 0) {
+            // help executing the pending tasks (which may belong to other groups, e.g., nested ones)
+            if (pool_->run_pending_task())
+                continue;
+            // the remaining tasks are running in other threads
+            std::unique_lock<std::mutex> lock(mutex_);
+            finished_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return num_running_ == 0; });
+        }
+        std::lock_guard<std::mutex> lock(mutex_);   // the last task may still be notifying
+    }
+
+
+    bool TaskGroup::wait() {
+        wait_all();
+        if (exception_) {
+            std::exception_ptr exception = exception_;
+            exception_ = nullptr;
+            std::rethrow_exception(exception);
+        }
+        return !is_canceled();
+    }
+
+}
@@ -0,0 +1,366 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_UTIL_THREAD_POOL_H
+#define EASY3D_UTIL_THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+
+namespace easy3d {
+
+    class ProgressLogger;
+
+    /**
+     * \brief A work-stealing thread pool shared by all the parallel algorithms of Easy3D.
+     *
+     * \class ThreadPool easy3d/util/thread_pool.h
+     *
+     * \details Each worker thread has its own task queue. A worker executes the tasks of its own queue in LIFO order
+     *      (the most recently spawned, cache-hot tasks first) and, when its queue is empty, steals the oldest tasks
+     *      from the other workers. A thread waiting for a TaskGroup executes pending tasks instead of blocking, so
+     *      parallel algorithms can be nested without deadlocks.
+     *
+     *      The concurrency (i.e., the number of threads executing tasks, including the thread waiting for them) is a
+     *      global limit. It defaults to the number of hardware threads, or to the value of the environment variable
+     *      \c EASY3D_NUM_THREADS if defined. An application embedding Easy3D can cap the CPU usage with
+     *      set_concurrency(). It does not depend on OpenMP.
+     *
+     *      Most users don't need the pool directly, but the algorithms built on top of it: parallel_for(),
+     *      parallel_reduce(), parallel_sort(), and TaskGroup.
+     *
+     * Example usage:
+     *      \code
+     *          // estimate the normals in parallel, stop early if the user cancels the progress
+     *          ProgressLogger progress(num, false);
+     *          bool finished = parallel_for(0, num, [&](int i) {
+     *              normals[i] = estimate_normal(points[i]);
+     *              progress.next();    // thread-safe
+     *          }, &progress);
+     *      \endcode
+     */
+    class ThreadPool {
+    public:
+        /**
+         * \brief Returns the shared thread pool (it is created at the first call).
+         * \details The returned pointer keeps the pool alive, even if it is replaced by set_concurrency().
+         */
+        static std::shared_ptr<ThreadPool> instance();
+
+        /**
+         * \brief Sets the global concurrency, i.e., the maximum number of threads executing tasks simultaneously.
+         * \param n The concurrency. 0 means the default (\c EASY3D_NUM_THREADS or the number of hardware threads),
+         *      and 1 makes all the parallel algorithms run sequentially in the calling thread.
+         * \details The parallel algorithms started afterwards use a new set of worker threads. The ones still running
+         *      finish on the previous workers, which are joined when the last of them is done.
+         */
+        static void set_concurrency(std::size_t n);
+
+        /// \brief Returns the global concurrency.
+        static std::size_t concurrency();
+
+        /**
+         * \brief Returns the index of the worker thread calling this function, in the range [0, concurrency() - 2],
+         *      or -1 if the calling thread is not a worker of the pool.
+         */
+        static int current_worker();
+
+        /**
+         * \brief Submits a task to the pool. Prefer TaskGroup, which allows waiting for the tasks.
+         * \details A task submitted by a worker goes to the worker's own queue, others are distributed evenly.
+         */
+        void submit(std::function<void()> task);
+
+        /// \brief Executes one pending task (if any) in the calling thread. Returns false if there was none.
+        bool run_pending_task();
+
+        /// \brief Returns the number of worker threads (i.e., concurrency() - 1 when the pool was created).
+        std::size_t num_workers() const { return workers_.size(); }
+
+        ~ThreadPool();
+
+    private:
+        // The queues and the synchronization of the pool. The workers own it too, so it outlives the pool if the last
+        // reference to the pool is released by a task running on one of its workers.
+        struct State;
+
+        explicit ThreadPool(std::size_t num_workers);
+        // the index of the calling thread among the workers of this pool, or -1
+        int self() const;
+
+        // the main loop of a worker thread
+        static void work(std::shared_ptr<State> state, std::size_t index);
+
+        static std::size_t default_concurrency();
+
+    private:
+        std::shared_ptr<State> state_;
+        std::vector<std::thread> workers_;
+
+        static std::atomic<std::size_t> concurrency_;   // 0 if not decided yet
+        static std::shared_ptr<ThreadPool> instance_;   // accessed with atomic operations only
+        static std::mutex instance_mutex_;
+    };
+
+
+    /**
+     * \brief A group of tasks executed by the shared ThreadPool, which can be waited for and canceled together.
+     *
+     * \class TaskGroup easy3d/util/thread_pool.h
+     *
+     * \details The group is canceled by cancel(), or when the ProgressLogger given to the constructor has been
+     *      canceled (e.g., by the user). The tasks not yet started are then skipped, and the running ones can stop
+     *      early by checking is_canceled(). The first exception thrown by a task is rethrown by wait().
+     *
+     * Example usage:
+     *      \code
+     *          TaskGroup group;
+     *          group.run([&]() { build_kd_tree(); });
+     *          group.run([&]() { compute_bbox(); });
+     *          group.wait();
+     *      \endcode
+     */
+    class TaskGroup {
+    public:
+        /// \param progress The progress logger whose cancellation cancels this group (can be nullptr).
+        explicit TaskGroup(ProgressLogger *progress = nullptr);
+        /// \brief Waits for the tasks to finish (exceptions are not rethrown).
+        ~TaskGroup();
+
+        /// \brief Schedules a task (any callable object without arguments).
+        template<typename Function>
+        void run(Function func);
+
+        /**
+         * \brief Waits for all the tasks to finish. The waiting thread executes pending tasks in the meantime.
+         * \return false if the group has been canceled.
+         */
+        bool wait();
+
+        /// \brief Cancels the group: the tasks not yet started will be skipped.
+        void cancel() { canceled_ = true; }
+
+        /// \brief Returns true if the group (or the progress logger it is tied to) has been canceled.
+        bool is_canceled() const;
+
+    private:
+        void finish_task();
+        // waits for the tasks to finish (without rethrowing the exceptions)
+        void wait_all();
+
+    private:
+        std::shared_ptr<ThreadPool> pool_;      // the pool executing the tasks of this group
+        ProgressLogger *progress_;
+        std::atomic<std::size_t> num_running_;  // the tasks scheduled but not finished
+        std::atomic<bool> canceled_;
+        std::exception_ptr exception_;
+        std::mutex mutex_;
+        std::condition_variable finished_;
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+    };
+
+
+    /**
+     * \brief Executes \p func(i) for each index i in the range [\p begin, \p end) using the shared ThreadPool.
+     * \details The range is split into chunks of contiguous indices executed as separate tasks.
+     * \param func The function to execute, called as func(i). It must be safe to call concurrently.
+     * \param progress The progress logger whose cancellation stops the loop (can be nullptr). The cancellation is
+     *      checked before each chunk.
+     * \param grain The minimum number of indices of a chunk. 0 lets the pool decide.
+     * \return false if the loop has been canceled, i.e., not all the indices have been processed.
+     */
+    template<typename Index, typename Function>
+    bool parallel_for(Index begin, Index end, const Function &func, ProgressLogger *progress = nullptr,
+                      std::size_t grain = 0);
+
+    /**
+     * \brief Reduces the range [\p begin, \p end) in parallel using the shared ThreadPool.
+     * \details The range is split into chunks. Each chunk [b, e) is accumulated by \p map(b, e, identity), and the
+     *      results of the chunks are then combined (in the order of the chunks, so the result is deterministic for a
+     *      given concurrency) by \p reduce(a, b).
+     * \param identity The identity of the reduction, e.g., 0 for a sum.
+     * \param map The function accumulating a chunk, called as map(Index b, Index e, T init) and returning T.
+     * \param reduce The function combining two partial results, called as reduce(T a, T b) and returning T.
+     * \param progress The progress logger whose cancellation stops the reduction (can be nullptr). The result is
+     *      then partial.
+     * \param grain The minimum number of indices of a chunk. 0 lets the pool decide.
+     */
+    template<typename Index, typename T, typename Map, typename Reduce>
+    T parallel_reduce(Index begin, Index end, const T &identity, const Map &map, const Reduce &reduce,
+                      ProgressLogger *progress = nullptr, std::size_t grain = 0);
+
+    /**
+     * \brief Sorts the range [\p first, \p last) in parallel using the shared ThreadPool.
+     * \details The range is split into chunks sorted concurrently by std::sort(), which are then merged pairwise
+     *      (the merges of each round running concurrently). Like std::sort(), the sort is not stable.
+     * \param first, last The random-access iterators of the range.
+     * \param comp The comparison function (a strict weak ordering).
+     */
+    template<typename RandomIt, typename Compare>
+    void parallel_sort(RandomIt first, RandomIt last, Compare comp);
+
+    /// \brief Sorts the range [\p first, \p last) in parallel in ascending order. \see parallel_sort()
+    template<typename RandomIt>
+    void parallel_sort(RandomIt first, RandomIt last) {
+        parallel_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+    }
+
+}
+
+
+//------------------------------------- implementation ---------------------------------------
+
+namespace easy3d {
+
+    template<typename Function>
+    inline void TaskGroup::run(Function func) {
+        ++num_running_;
+        pool_->submit([this, func]() {
+            if (!is_canceled()) {
+                try {
+                    func();
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!exception_)
+                        exception_ = std::current_exception();
+                    canceled_ = true;
+                }
+            }
+            finish_task();
+        });
+    }
+
+
+    namespace details {
+
+        // the number of indices of each chunk of a parallel loop over n indices
+        inline std::size_t chunk_size(std::size_t n, std::size_t grain) {
+            // a few chunks per thread, so the idle threads can steal some of them
+            const std::size_t num_chunks = ThreadPool::concurrency() * 8;
+            return std::max<std::size_t>(std::max<std::size_t>(grain, 1), (n + num_chunks - 1) / num_chunks);
+        }
+
+    }
+
+
+    template<typename Index, typename Function>
+    inline bool parallel_for(Index begin, Index end, const Function &func, ProgressLogger *progress, std::size_t grain) {
+        if (!(begin < end))
+            return true;
+
+        const std::size_t n = static_cast<std::size_t>(end - begin);
+        const std::size_t chunk = details::chunk_size(n, grain);
+        TaskGroup group(progress);
+        if (ThreadPool::concurrency() == 1 || chunk >= n) {   // sequential
+            for (std::size_t b = 0; b < n && !group.is_canceled(); b += chunk) {
+                const std::size_t e = std::min(n, b + chunk);
+                for (std::size_t i = b; i < e; ++i)
+                    func(static_cast<Index>(begin + i));
+            }
+            return !group.is_canceled();
+        }
+
+        for (std::size_t b = 0; b < n; b += chunk) {
+            const std::size_t e = std::min(n, b + chunk);
+            group.run([&func, begin, b, e]() {
+                for (std::size_t i = b; i < e; ++i)
+                    func(static_cast<Index>(begin + i));
+            });
+        }
+        return group.wait();
+    }
+
+
+    template<typename Index, typename T, typename Map, typename Reduce>
+    inline T parallel_reduce(Index begin, Index end, const T &identity, const Map &map, const Reduce &reduce,
+                             ProgressLogger *progress, std::size_t grain) {
+        if (!(begin < end))
+            return identity;
+
+        const std::size_t n = static_cast<std::size_t>(end - begin);
+        const std::size_t chunk = details::chunk_size(n, grain);
+        const std::size_t num_chunks = (n + chunk - 1) / chunk;
+        std::vector<T> partial(num_chunks, identity);
+        parallel_for(std::size_t(0), num_chunks, [&](std::size_t c) {
+            const std::size_t b = c * chunk;
+            const std::size_t e = std::min(n, b + chunk);
+            partial[c] = map(static_cast<Index>(begin + b), static_cast<Index>(begin + e), identity);
+        }, progress, 1);
+
+        T result = identity;
+        for (const auto &value : partial)
+            result = reduce(result, value);
+        return result;
+    }
+
+
+    template<typename RandomIt, typename Compare>
+    inline void parallel_sort(RandomIt first, RandomIt last, Compare comp) {
+        const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+        const std::size_t concurrency = ThreadPool::concurrency();
+        const std::size_t min_chunk = 4096;    // sorting smaller ranges is not worth the overhead
+        if (concurrency == 1 || n < 2 * min_chunk) {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        // sort the chunks (a power of two, so the merge rounds are balanced)
+        std::size_t num_chunks = 1;
+        while (num_chunks < concurrency * 2 && n / (num_chunks * 2) >= min_chunk)
+            num_chunks *= 2;
+        std::vector<std::size_t> bounds(num_chunks + 1);
+        for (std::size_t c = 0; c <= num_chunks; ++c)
+            bounds[c] = n * c / num_chunks;
+        parallel_for(std::size_t(0), num_chunks, [&](std::size_t c) {
+            std::sort(first + bounds[c], first + bounds[c + 1], comp);
+        }, nullptr, 1);
+
+        // merge the sorted chunks pairwise
+        for (std::size_t width = 1; width < num_chunks; width *= 2) {
+            parallel_for(std::size_t(0), num_chunks / (2 * width), [&](std::size_t p) {
+                const std::size_t c = p * 2 * width;
+                std::inplace_merge(first + bounds[c], first + bounds[c + width], first + bounds[c + 2 * width], comp);
+            }, nullptr, 1);
+        }
+    }
+
+}
+
+
+#endif  // EASY3D_UTIL_THREAD_POOL_H
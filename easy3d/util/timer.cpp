@@ -0,0 +1,225 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/util/timer.h>
+
+#include <algorithm>
+#include <exception>
+
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+    namespace internal {
+
+        struct TimerTask {
+            TimerTask(TimerService::Task f, std::chrono::milliseconds i)
+                    : func(std::move(f)), interval(i), canceled(false), finished(false), dispatched(false) {}
+
+            TimerService::Task func;
+            std::chrono::milliseconds interval;     // zero for a single-shot task
+            std::atomic<bool> canceled;
+            std::atomic<bool> finished;             // a single-shot task has been executed
+            std::atomic<bool> dispatched;           // an invocation is waiting in the dispatcher
+        };
+
+    }
+
+
+    void TimerService::Handle::cancel() {
+        if (task_)
+            task_->canceled = true;
+    }
+
+
+    bool TimerService::Handle::is_active() const {
+        return task_ && !task_->canceled && !task_->finished;
+    }
+
+
+    TimerService *TimerService::instance() {
+        // joined at exit: tasks still pending by then are discarded
+        static TimerService service;
+        return &service;
+    }
+
+
+    TimerService::TimerService() : sequence_(0), stopping_(false), has_posted_(false) {
+    }
+
+
+    TimerService::~TimerService() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_one();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+
+    TimerService::Handle TimerService::schedule(int delay, Task task) {
+        return add(std::chrono::milliseconds(std::max(delay, 0)), std::chrono::milliseconds(0), std::move(task));
+    }
+
+
+    TimerService::Handle TimerService::schedule_interval(int interval, Task task) {
+        if (interval <= 0) {
+            LOG(WARNING) << "invalid timer interval (" << interval << " ms), 1 ms is used instead";
+            interval = 1;
+        }
+        const std::chrono::milliseconds period(interval);
+        return add(period, period, std::move(task));
+    }
+
+
+    TimerService::Handle TimerService::add(std::chrono::milliseconds delay, std::chrono::milliseconds interval, Task task) {
+        auto entry = std::make_shared<internal::TimerTask>(std::move(task), interval);
+        bool earliest = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)  // during exit
+                return Handle();
+            if (!thread_.joinable())
+                thread_ = std::thread(&TimerService::run, this);
+            const Clock::time_point deadline = Clock::now() + delay;
+            earliest = heap_.empty() || deadline < heap_.front().deadline;
+            push({deadline, 0, entry});
+        }
+        // the scheduler only needs to wake up if it is now sleeping too long
+        if (earliest)
+            condition_.notify_one();
+        return Handle(entry);
+    }
+
+
+    void TimerService::push(Entry entry) {
+        entry.sequence = sequence_++;
+        heap_.push_back(std::move(entry));
+        std::push_heap(heap_.begin(), heap_.end(), Later());
+    }
+
+
+    void TimerService::set_dispatcher(Dispatcher dispatcher) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dispatcher_ = std::move(dispatcher);
+    }
+
+
+    void TimerService::post(Task task) {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        posted_.push_back(std::move(task));
+        has_posted_.store(true, std::memory_order_release);
+    }
+
+
+    std::size_t TimerService::process_posted() {
+        if (!has_posted_.load(std::memory_order_acquire))
+            return 0;
+
+        std::vector<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(posted_mutex_);
+            tasks.swap(posted_);
+            has_posted_.store(false, std::memory_order_release);
+        }
+        for (auto &task : tasks)
+            task();
+        return tasks.size();
+    }
+
+
+    void TimerService::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (heap_.empty()) {
+                condition_.wait(lock);
+                continue;
+            }
+
+            const Clock::time_point deadline = heap_.front().deadline;
+            if (Clock::now() < deadline) {
+                condition_.wait_until(lock, deadline);
+                continue;
+            }
+
+            std::pop_heap(heap_.begin(), heap_.end(), Later());
+            std::shared_ptr<internal::TimerTask> task = std::move(heap_.back().task);
+            heap_.pop_back();
+            if (task->canceled)
+                continue;
+
+            if (task->interval.count() > 0) {
+                // coalesce: if we are behind schedule, the missed ticks are merged into this one
+                Clock::time_point next = deadline + task->interval;
+                const Clock::time_point now = Clock::now();
+                if (next <= now)
+                    next += task->interval * ((now - next) / task->interval + 1);
+                push({next, 0, task});
+            }
+
+            const Dispatcher dispatcher = dispatcher_;
+            lock.unlock();
+            if (!dispatcher)
+                invoke(task);
+            else if (!task->dispatched.exchange(true)) {  // drop the tick if the previous one is still waiting
+                dispatcher([task]() {
+                    task->dispatched = false;
+                    invoke(task);
+                });
+            }
+            lock.lock();
+        }
+    }
+
+
+    void TimerService::invoke(const std::shared_ptr<internal::TimerTask> &task) {
+        if (task->canceled || task->finished)
+            return;
+
+        const bool single_shot = (task->interval.count() == 0);
+        if (single_shot)
+            task->finished = true;
+
+        try {
+            task->func();
+        }
+        catch (const std::exception &e) {
+            LOG(ERROR) << "exception thrown by a timer task: " << e.what();
+        }
+        catch (...) {
+            LOG(ERROR) << "unknown exception thrown by a timer task";
+        }
+
+        // release the captured arguments as early as possible
+        if (single_shot)
+            Task().swap(task->func);
+    }
+
+}
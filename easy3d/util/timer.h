@@ -30,17 +30,137 @@
 #include <thread>
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdint>
 
 namespace easy3d {
 
+    namespace internal {
+        struct TimerTask;
+    }
+
+    /**
+     * \brief The scheduler behind Timer: a single event thread serving all timed tasks of the process.
+     * \class TimerService easy3d/util/timer.h
+     * \details Pending tasks are kept in a min-heap ordered by their deadlines. The scheduler thread sleeps until
+     *      the earliest deadline (or until a new, earlier task arrives), so any number of timers costs one thread.
+     *      Each scheduled task is identified by a Handle that can cancel it. Repeated tasks are coalesced: if the
+     *      scheduler falls behind (e.g., a previous invocation took longer than the interval), the missed ticks are
+     *      merged into a single invocation instead of being fired back-to-back.
+     *
+     *      By default, tasks run on the scheduler thread, so they should return quickly. An application can install
+     *      a dispatcher to run them elsewhere, typically on the GUI thread. The service provides a minimal posting
+     *      queue for this purpose, which the Viewer drains in its main loop:
+     *      \code
+     *          TimerService::instance()->set_dispatcher([&viewer](TimerService::Task task) {
+     *              TimerService::instance()->post(std::move(task));
+     *              viewer.update();    // wakes up the main loop
+     *          });
+     *      \endcode
+     *      While an invocation of a repeated task is still waiting in the dispatcher, further ticks of that task
+     *      are dropped, so a busy GUI thread is never flooded.
+     */
+    class TimerService {
+    public:
+        /// A task to be executed.
+        typedef std::function<void()> Task;
+        /// A function that receives a due task and decides where and when to execute it.
+        typedef std::function<void(Task)> Dispatcher;
+
+        /**
+         * \brief Identifies a scheduled task.
+         * \details Handles are cheap to copy. Destroying a handle does not cancel the task.
+         */
+        class Handle {
+        public:
+            Handle() = default;
+
+            /// Cancels the task. An invocation already in progress is completed, but no further one will start.
+            void cancel();
+
+            /// Returns whether the task is still scheduled, i.e., not canceled and (for a single-shot task) not
+            /// executed yet.
+            bool is_active() const;
+
+        private:
+            explicit Handle(const std::shared_ptr<internal::TimerTask> &task) : task_(task) {}
+            std::shared_ptr<internal::TimerTask> task_;
+            friend class TimerService;
+        };
+
+    public:
+        /// Returns the service instance. The scheduler thread is started when the first task is scheduled.
+        static TimerService *instance();
+
+        /// Executes \p task once after \p delay milliseconds.
+        Handle schedule(int delay, Task task);
+
+        /// Executes \p task every \p interval milliseconds until it is canceled.
+        Handle schedule_interval(int interval, Task task);
+
+        /// Sets the dispatcher that executes due tasks. An empty dispatcher (the default) runs the tasks directly
+        /// on the scheduler thread.
+        void set_dispatcher(Dispatcher dispatcher);
+
+        /// Queues \p task to be executed by the next call to process_posted(). Thread-safe.
+        void post(Task task);
+
+        /**
+         * \brief Executes all tasks queued by post() in the calling thread.
+         * \return The number of executed tasks.
+         * \details This is cheap if nothing has been posted, so it can be called in every iteration of an event loop.
+         */
+        std::size_t process_posted();
+
+    private:
+        TimerService();
+        ~TimerService();
+
+        Handle add(std::chrono::milliseconds delay, std::chrono::milliseconds interval, Task task);
+        void run();
+        static void invoke(const std::shared_ptr<internal::TimerTask> &task);
+
+        typedef std::chrono::steady_clock Clock;
+        struct Entry {
+            Clock::time_point deadline;
+            std::uint64_t sequence;     // keeps the order of tasks having the same deadline
+            std::shared_ptr<internal::TimerTask> task;
+        };
+        struct Later {
+            bool operator()(const Entry &a, const Entry &b) const {
+                return a.deadline > b.deadline || (a.deadline == b.deadline && a.sequence > b.sequence);
+            }
+        };
+        void push(Entry entry);
+
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::vector<Entry> heap_;
+        std::uint64_t sequence_;
+        bool stopping_;
+        Dispatcher dispatcher_;
+
+        std::mutex posted_mutex_;
+        std::vector<Task> posted_;
+        std::atomic<bool> has_posted_;
+    };
+
+
     /**
      * \brief A light-weight implementation of the timer mechanism.
      * \class Timer easy3d/util/timer.h
      * \details Timer functionalities are usually implemented in large libraries
      *      (e.g., the [QTimer of Qt](http://doc.qt.io/archives/qt-5.5/qtimer.html)).
-     *      This Timer class provides a single-header implementation.
+     *      This Timer class provides a light-weight implementation.
      *      With Timer, tasks (i.e., calling to functions) can be easily scheduled at either constant intervals
      *      or after a specified period. Timer supports any types of functions with any number of arguments.
+     *      All timers share the single scheduler thread of TimerService, on which the functions are called
+     *      (unless a dispatcher has been installed). Functions executed by a timer should therefore not block.
      *
      * \example Test_Timer  \include test_timer.cpp
      */
@@ -50,7 +170,11 @@ namespace easy3d {
     public:
         Timer() : stopped_(false) {}
 
-        ~Timer() { stopped_ = true; }
+        /// The pending tasks started by set_timeout() and set_interval() are canceled.
+        ~Timer() { stop(); }
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
 
         /**
          * \brief Executes function \p func after \p delay milliseconds.
@@ -148,14 +272,19 @@ namespace easy3d {
         template<class Class>
         void set_interval(int interval, Class const *inst, void (Class::*func)(Args...) const, Args... args);
 
-        /** \brief Stops the timer. */
-        void stop() { stopped_ = true; }
+        /** \brief Stops the timer, i.e., cancels all pending tasks started by set_timeout() and set_interval(). */
+        void stop();
 
         /** \brief Returns whether the timer has been stopped. */
         bool is_stopped() const { return stopped_; }
 
     private:
-        mutable bool stopped_;
+        void add(const TimerService::Handle &handle) const;
+
+    private:
+        mutable std::atomic<bool> stopped_;
+        mutable std::mutex mutex_;
+        mutable std::vector<TimerService::Handle> handles_;
     };
 
 
@@ -165,46 +294,28 @@ namespace easy3d {
 
     template<class... Args>
     void Timer<Args...>::single_shot(int delay, std::function<void(Args...)> const &func, Args... args) {
-        std::thread t([=]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            func(args...);
-        });
-        t.detach();
+        TimerService::instance()->schedule(delay, [=]() { func(args...); });
     }
 
 
     template<class... Args>
     template<class Class>
     void Timer<Args...>::single_shot(int delay, Class *inst, void (Class::*func)(Args...), Args... args) {
-        std::thread t([=]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            (inst->*func)(args...);
-        });
-        t.detach();
+        TimerService::instance()->schedule(delay, [=]() { (inst->*func)(args...); });
     }
 
 
     template<class... Args>
     template<class Class>
     void Timer<Args...>::single_shot(int delay, Class const *inst, void (Class::*func)(Args...) const, Args... args) {
-        std::thread t([=]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            (inst->*func)(args...);
-        });
-        t.detach();
+        TimerService::instance()->schedule(delay, [=]() { (inst->*func)(args...); });
     }
 
 
     template<class... Args>
     void Timer<Args...>::set_timeout(int delay, std::function<void(Args...)> const &func, Args... args) const {
         stopped_ = false;
-        std::thread t([=]() {
-            if (stopped_) return;
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            if (stopped_) return;
-            func(args...);
-        });
-        t.detach();
+        add(TimerService::instance()->schedule(delay, [=]() { func(args...); }));
     }
 
 
@@ -212,13 +323,7 @@ namespace easy3d {
     template<class Class>
     void Timer<Args...>::set_timeout(int delay, Class *inst, void (Class::*func)(Args...), Args... args) const {
         stopped_ = false;
-        std::thread t([=]() {
-            if (stopped_) return;
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            if (stopped_) return;
-            (inst->*func)(args...);
-        });
-        t.detach();
+        add(TimerService::instance()->schedule(delay, [=]() { (inst->*func)(args...); }));
     }
 
 
@@ -226,28 +331,14 @@ namespace easy3d {
     template<class Class>
     void Timer<Args...>::set_timeout(int delay, Class const *inst, void (Class::*func)(Args...) const, Args... args) const {
         stopped_ = false;
-        std::thread t([=]() {
-            if (stopped_) return;
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            if (stopped_) return;
-            (inst->*func)(args...);
-        });
-        t.detach();
+        add(TimerService::instance()->schedule(delay, [=]() { (inst->*func)(args...); }));
     }
 
 
     template<class... Args>
     void Timer<Args...>::set_interval(int interval, std::function<void(Args...)> const &func, Args... args) {
         stopped_ = false;
-        std::thread t([=]() {
-            while (true) {
-                if (stopped_) return;
-                std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-                if (stopped_) return;
-                func(args...);
-            }
-        });
-        t.detach();
+        add(TimerService::instance()->schedule_interval(interval, [=]() { func(args...); }));
     }
 
 
@@ -255,30 +346,39 @@ namespace easy3d {
     template<class Class>
     void Timer<Args...>::set_interval(int interval, Class *inst, void (Class::*func)(Args...), Args... args) {
         stopped_ = false;
-        std::thread t([=]() {
-            while (true) {
-                if (stopped_) return;
-                std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-                if (stopped_) return;
-                (inst->*func)(args...);
-            }
-        });
-        t.detach();
+        add(TimerService::instance()->schedule_interval(interval, [=]() { (inst->*func)(args...); }));
     }
 
+
     template<class... Args>
     template<class Class>
     void Timer<Args...>::set_interval(int interval, Class const *inst, void (Class::*func)(Args...) const, Args... args) {
         stopped_ = false;
-        std::thread t([=]() {
-            while (true) {
-                if (stopped_) return;
-                std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-                if (stopped_) return;
-                (inst->*func)(args...);
-            }
-        });
-        t.detach();
+        add(TimerService::instance()->schedule_interval(interval, [=]() { (inst->*func)(args...); }));
+    }
+
+
+    template<class... Args>
+    void Timer<Args...>::stop() {
+        stopped_ = true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &handle : handles_)
+            handle.cancel();
+        handles_.clear();
+    }
+
+
+    template<class... Args>
+    void Timer<Args...>::add(const TimerService::Handle &handle) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // forget the tasks that have completed, so that the list does not grow with repeated set_timeout() calls
+        std::size_t num = 0;
+        for (std::size_t i = 0; i < handles_.size(); ++i) {
+            if (handles_[i].is_active())
+                handles_[num++] = handles_[i];
+        }
+        handles_.resize(num);
+        handles_.push_back(handle);
     }
 
 
@@ -28,6 +28,8 @@
 
 #include <chrono>
 #include <iostream>
+#include <fstream>
+#include <algorithm>
 
 
 #if !defined(_WIN32)
@@ -48,6 +50,8 @@
 #include <easy3d/renderer/drawable_points.h>
 #include <easy3d/renderer/drawable_lines.h>
 #include <easy3d/renderer/drawable_triangles.h>
+#include <easy3d/renderer/drawable_batcher.h>
+#include <easy3d/renderer/frame_profiler.h>
 #include <easy3d/renderer/shader_program.h>
 #include <easy3d/renderer/shader_manager.h>
 #include <easy3d/renderer/transform.h>
@@ -57,6 +61,7 @@
 #include <easy3d/renderer/key_frame_interpolator.h>
 #include <easy3d/renderer/framebuffer_object.h>
 #include <easy3d/renderer/opengl_error.h>
+#include <easy3d/renderer/opengl_info.h>
 #include <easy3d/renderer/setting.h>
 #include <easy3d/renderer/text_renderer.h>
 #include <easy3d/renderer/texture_manager.h>
@@ -70,9 +75,12 @@
 #include <easy3d/util/dialogs.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/memory.h>
 #include <easy3d/util/timer.h>
 #include <easy3d/util/string.h>
 
+#include <3rd_party/json/json.hpp>
+
 
 // To have the same shortcut behavior on macOS and other platforms (i.e., Windows, Linux)
 #ifdef __APPLE__
@@ -99,6 +107,7 @@ namespace easy3d {
     )
         : window_(nullptr)
         , should_exit_(false)
+        , prewarm_context_(nullptr)
         , dpi_scaling_(1.0)
         , title_(title)
         , camera_(nullptr)
@@ -108,6 +117,8 @@ namespace easy3d {
         , background_color_(0.9f, 0.9f, 1.0f, 1.0f)
         , process_events_(true)
         , texter_(nullptr)
+        , batcher_(nullptr)
+        , profiler_(nullptr)
         , pressed_button_(-1)
         , modifiers_(-1)
         , drag_active_(false)
@@ -118,6 +129,8 @@ namespace easy3d {
         , pressed_key_(-1)
         , show_pivot_point_(false)
         , show_frame_rate_(false)
+        , render_on_demand_(false)
+        , redraw_requested_(true)
         , drawable_axes_(nullptr)
         , show_camera_path_(false)
         , model_idx_(-1)
@@ -137,6 +150,8 @@ namespace easy3d {
                                 depth_bits, stencil_bits, width, height);
         setup_callbacks(window_);
 
+        prewarm_shader_programs();
+
         // create and setup the camera
         camera_ = new Camera;
         camera_->setType(Camera::PERSPECTIVE);
@@ -146,6 +161,10 @@ namespace easy3d {
 
         easy3d::connect(&camera_->frame_modified, this, &Viewer::update);
 
+        batcher_ = new DrawableBatcher;
+        profiler_ = new FrameProfiler;
+        profiler_->set_enabled(false);
+
         kfi_ = new KeyFrameInterpolator(camera_->frame());
         easy3d::connect(&kfi_->interpolation_stopped, this, &Viewer::update);
 
@@ -287,6 +306,31 @@ namespace easy3d {
     }
 
 
+    void Viewer::prewarm_shader_programs() {
+        if (!setting::shader_binary_cache)
+            return;
+        ShaderManager::set_binary_cache_directory(file_system::home_directory() + "/.easy3d/shader_cache");
+        if (ShaderManager::binary_cache_directory().empty() || !OpenglInfo::is_supported("GL_ARB_get_program_binary"))
+            return;
+
+        // the other hints are kept from creating the main window, so the contexts are compatible
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+        prewarm_context_ = glfwCreateWindow(1, 1, "", nullptr, window_);
+        glfwWindowHint(GLFW_VISIBLE, GL_TRUE);  // windows created later (e.g., by the client) are visible again
+        if (!prewarm_context_) {
+            LOG(WARNING) << "could not create a shared context for compiling the shader programs in background";
+            return;
+        }
+
+        GLFWwindow* context = prewarm_context_;
+        prewarm_thread_ = std::thread([context]() {
+            glfwMakeContextCurrent(context);
+            ShaderManager::prewarm_binary_cache();
+            glfwMakeContextCurrent(nullptr);
+        });
+    }
+
+
     void Viewer::setup_callbacks(GLFWwindow *window) {
         glfwSetWindowRefreshCallback(window, [](GLFWwindow *win) {
             auto viewer = reinterpret_cast<Viewer *>(glfwGetWindowUserPointer(win));
@@ -303,8 +347,10 @@ namespace easy3d {
 
             int w = viewer->width();
             int h = viewer->height();
-            if (x >= 0 && x <= w && y >= 0 && y <= h)
-                viewer->callback_event_cursor_pos(x, y);
+            if (x >= 0 && x <= w && y >= 0 && y <= h) {
+                if (viewer->callback_event_cursor_pos(x, y) || viewer->drag_active_)
+                    viewer->redraw_requested_ = true;
+            }
             else if (viewer->drag_active_) {
                 // Restrict the cursor to be within the client area during dragging
                 if (x < 0) x = 0;
@@ -320,6 +366,7 @@ namespace easy3d {
             if (!viewer->process_events_)
                 return;
             viewer->callback_event_mouse_button(button, action, modifiers);
+            viewer->redraw_requested_ = true;
         });
 
         glfwSetKeyCallback(window, [](GLFWwindow *win, int key, int scancode, int action, int mods) {
@@ -328,6 +375,7 @@ namespace easy3d {
                 return;
             (void) scancode;
             viewer->callback_event_keyboard(key, action, mods);
+            viewer->redraw_requested_ = true;
         });
 
         glfwSetCharCallback(window, [](GLFWwindow *win, unsigned int codepoint) {
@@ -335,6 +383,7 @@ namespace easy3d {
             if (!viewer->process_events_)
                 return;
             viewer->callback_event_character(codepoint);
+            viewer->redraw_requested_ = true;
         });
 
         glfwSetDropCallback(window, [](GLFWwindow *win, int count, const char **filenames) {
@@ -342,6 +391,7 @@ namespace easy3d {
             if (!viewer->process_events_)
                 return;
             viewer->callback_event_drop(count, filenames);
+            viewer->redraw_requested_ = true;
         });
 
         glfwSetScrollCallback(window, [](GLFWwindow *win, double dx, double dy) {
@@ -349,6 +399,7 @@ namespace easy3d {
             if (!viewer->process_events_)
                 return;
             viewer->callback_event_scroll(dx, dy);
+            viewer->redraw_requested_ = true;
         });
 
 #if 0
@@ -367,6 +418,7 @@ namespace easy3d {
             if (!viewer->process_events_)
                 return;
             viewer->callback_event_resize(width, height);
+            viewer->redraw_requested_ = true;
         });
 #endif
 
@@ -374,6 +426,7 @@ namespace easy3d {
         glfwSetWindowFocusCallback(window, [](GLFWwindow *win, int focused) {
             auto viewer = reinterpret_cast<Viewer *>(glfwGetWindowUserPointer(win));
             viewer->focus_event(focused != 0);// true for focused
+            viewer->redraw_requested_ = true;
         });
 
         glfwSetWindowCloseCallback(window, [](GLFWwindow *win) {
@@ -539,9 +592,20 @@ namespace easy3d {
         delete kfi_;
         delete drawable_axes_;
         delete texter_;
+        delete batcher_;
+        batcher_ = nullptr;
+        delete profiler_;
+        profiler_ = nullptr;
 
         clear_scene();
 
+        if (prewarm_thread_.joinable())
+            prewarm_thread_.join();
+        if (prewarm_context_) {
+            glfwDestroyWindow(prewarm_context_);
+            prewarm_context_ = nullptr;
+        }
+
         ShaderManager::terminate();
         TextureManager::terminate();
 
@@ -574,6 +638,7 @@ namespace easy3d {
 
 
     void Viewer::update() const {
+        redraw_requested_ = true;
         glfwPostEmptyEvent();
     }
 
@@ -944,6 +1009,7 @@ namespace easy3d {
                 }
 
                 current_model()->property_stats(output);
+                memory::process_usage().print(output);
             }
         } else if (key == GLFW_KEY_R && modifiers == 0) {
             // Reload the shader(s) - useful for writing/debugging shader code.
@@ -1041,11 +1107,22 @@ namespace easy3d {
             double last_time = glfwGetTime();   // for frame rate counter
 
             while (!glfwWindowShouldClose(window_) && !should_exit_) {
+                // run the tasks that timers have posted to this (i.e., the GUI) thread
+                TimerService::instance()->process_posted();
+
                 if (!glfwGetWindowAttrib(window_, GLFW_VISIBLE)) { // not visible
                     glfwWaitEvents();
                     continue;
                 }
 
+                // in render-on-demand mode, wait until something has changed
+                const bool continuous = show_frame_rate_ || (is_animating_ && animation_func_);
+                if (render_on_demand_ && !continuous && !redraw_requested_) {
+                    glfwWaitEvents();
+                    continue;
+                }
+                redraw_requested_ = false;
+
                 if (show_frame_rate_) {
                     // Calculate ms/frame
                     double current_time = glfwGetTime();
@@ -1058,9 +1135,17 @@ namespace easy3d {
                     }
                 }
 
+                profiler_->begin_frame();
                 pre_draw();
-                draw();
-                post_draw();
+                {
+                    FrameProfiler::Scope scope("draw");
+                    draw();
+                }
+                {
+                    FrameProfiler::Scope scope("post_draw");
+                    post_draw();
+                }
+                profiler_->end_frame();
                 glfwSwapBuffers(window_);
 
                 if (is_animating_ && animation_func_) {
@@ -1093,6 +1178,137 @@ namespace easy3d {
     }
 
 
+    int Viewer::benchmark(int num_frames, const std::string &stats_file, KeyFrameInterpolator *path, int width,
+                          int height) {
+        if (num_frames <= 0 || width <= 0 || height <= 0) {
+            LOG(ERROR) << "invalid benchmark settings: " << num_frames << " frames of " << width << "x" << height;
+            return EXIT_FAILURE;
+        }
+
+        init();
+        fit_screen();
+
+        // the camera path: the given one, the one of the viewer, or an orbit around the scene
+        if (!path || path->number_of_keyframes() == 0)
+            path = kfi_;
+        KeyFrameInterpolator orbit(camera_->frame());
+        if (path->number_of_keyframes() == 0) {
+            const vec3 center = camera_->sceneCenter();
+            const vec3 offset = camera_->position() - center;
+            const vec3 up = camera_->upVector();
+            const int num_keyframes = 12;
+            for (int i = 0; i <= num_keyframes; ++i) {
+                const quat q(up, static_cast<float>(2.0 * M_PI * i / num_keyframes));
+                camera_->setPosition(center + q.rotate(offset));
+                camera_->lookAt(center);
+                orbit.add_keyframe(*camera_->frame(), static_cast<float>(i));
+            }
+            path = &orbit;
+        }
+        const std::vector<Frame> &frames = path->interpolate();
+        if (frames.empty()) {
+            LOG(ERROR) << "failed to create the camera path";
+            cleanup();
+            return EXIT_FAILURE;
+        }
+
+        FramebufferObject fbo(width, height, samples_);
+        fbo.add_color_buffer();
+        fbo.add_depth_buffer();
+        camera_->setScreenWidthAndHeight(width, height);
+        glViewport(0, 0, width, height);
+
+        using clock = std::chrono::steady_clock;
+        auto elapsed_ms = [](const clock::time_point &t) {
+            return std::chrono::duration<double, std::milli>(clock::now() - t).count();
+        };
+
+        // upload the buffers of all drawables
+        auto t = clock::now();
+        std::size_t num_drawables = 0;
+        auto upload = [&num_drawables](const Drawable *d) {
+            d->update_buffers_if_needed();
+            ++num_drawables;
+        };
+        for (auto m : models_) {
+            for (auto d : m->renderer()->points_drawables()) upload(d);
+            for (auto d : m->renderer()->lines_drawables()) upload(d);
+            for (auto d : m->renderer()->triangles_drawables()) upload(d);
+        }
+        for (auto d : drawables_) upload(d);
+        glFinish();
+        const double upload_time = elapsed_ms(t);
+
+        auto render = [&](const Frame &frame) {
+            camera_->frame()->setPositionAndOrientation(frame.position(), frame.orientation());
+            fbo.bind();
+            glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+            draw();
+            fbo.release();
+            glFinish();
+        };
+
+        // the first frame also compiles the shaders, so it is not part of the statistics
+        t = clock::now();
+        render(frames.front());
+        const double first_frame_time = elapsed_ms(t);
+
+        std::vector<double> times(num_frames);
+        std::size_t draw_calls = 0;
+        for (int i = 0; i < num_frames; ++i) {
+            const std::size_t index = (num_frames > 1) ? i * (frames.size() - 1) / (num_frames - 1) : 0;
+            Drawable::reset_draw_call_count();
+            t = clock::now();
+            render(frames[index]);
+            times[i] = elapsed_ms(t);
+            draw_calls += Drawable::draw_call_count();
+        }
+        easy3d_debug_log_gl_error;
+
+        std::vector<double> sorted = times;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (auto v : times)
+            total += v;
+        const double mean = total / num_frames;
+        const double p99 = sorted[(sorted.size() * 99 + 99) / 100 - 1];
+        const double draw_calls_per_frame = static_cast<double>(draw_calls) / num_frames;
+
+        LOG(INFO) << "benchmark: " << num_frames << " frames (" << width << "x" << height << "), frame time (ms): min "
+                  << sorted.front() << ", mean " << mean << ", p99 " << p99 << ", max " << sorted.back()
+                  << ", upload time (ms): " << upload_time << ", draw calls per frame: " << draw_calls_per_frame;
+
+        bool success = true;
+        if (!stats_file.empty()) {
+            nlohmann::ordered_json stats;
+            stats["frames"] = num_frames;
+            stats["width"] = width;
+            stats["height"] = height;
+            const GLubyte *renderer = glGetString(GL_RENDERER);
+            stats["renderer"] = renderer ? reinterpret_cast<const char *>(renderer) : "";
+            stats["models"] = models_.size();
+            stats["drawables"] = num_drawables;
+            stats["upload_ms"] = upload_time;
+            stats["first_frame_ms"] = first_frame_time;
+            stats["frame_ms"]["min"] = sorted.front();
+            stats["frame_ms"]["mean"] = mean;
+            stats["frame_ms"]["p99"] = p99;
+            stats["frame_ms"]["max"] = sorted.back();
+            stats["fps"] = 1000.0 / mean;
+            stats["draw_calls_per_frame"] = draw_calls_per_frame;
+
+            std::ofstream output(stats_file.c_str());
+            output << stats.dump(2) << std::endl;
+            success = !output.fail();
+            LOG_IF(!success, ERROR) << "failed writing the statistics to file: " << stats_file;
+        }
+
+        cleanup();
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+
     void Viewer::exit() {
         should_exit_ = true;
         update();
@@ -1205,7 +1421,7 @@ namespace easy3d {
             is_ply_mesh = (io::PlyReader::num_instances(file_name, "face") > 0);
 
         Model *model = nullptr;
-        if ((ext == "ply" && is_ply_mesh) || ext == "obj" || ext == "off" || ext == "stl" || ext == "sm" || ext == "geojson" || ext == "trilist") { // mesh
+        if ((ext == "ply" && is_ply_mesh) || ext == "obj" || ext == "off" || ext == "stl" || ext == "sm" || ext == "csm" || ext == "geojson" || ext == "trilist") { // mesh
             model = SurfaceMeshIO::load(file_name);
         } else if (ext == "ply" && io::PlyReader::num_instances(file_name, "edge") > 0) {
             model = GraphIO::load(file_name);
@@ -1215,8 +1431,8 @@ namespace easy3d {
         else { // point cloud
             if (ext == "ptx") {
                 io::PointCloudIO_ptx serializer(file_name);
-                PointCloud *cloud = nullptr;
-                while ((cloud = serializer.load_next())) {
+                const std::vector<PointCloud *> clouds = serializer.load_all();
+                for (auto cloud : clouds) {
                     model = add_model(cloud, create_default_drawables);
                     update();
                 }
@@ -1362,8 +1578,8 @@ namespace easy3d {
         const std::string title("Please choose a file");
         const std::string &default_path = resource::directory() + "/data/";
         const std::vector<std::string> &filters = {
-                "Surface Mesh (*.obj *.ply *.off *.stl *.sm *.geojson *.trilist)", "*.obj *.ply *.off *.stl *.sm *.geojson *.trilist",
-                "Point Cloud (*.bin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg *.ptx)", "*.bin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg *.ptx",
+                "Surface Mesh (*.obj *.ply *.off *.stl *.sm *.csm *.geojson *.trilist)", "*.obj *.ply *.off *.stl *.sm *.csm *.geojson *.trilist",
+                "Point Cloud (*.bin *.cbin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg *.ptx)", "*.bin *.cbin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg *.ptx",
                 "Polyhedral Mesh (*.plm *.pm *.mesh)", "*.plm *.pm *.mesh",
                 "Graph (*.ply)", "*.ply",
                 "All Files (*.*)", "*"
@@ -1393,9 +1609,9 @@ namespace easy3d {
 
         const std::string &title = "Please choose a file name";
         const std::vector<std::string> &filters = {
-                "Surface Mesh (*.obj *.ply *.off *.stl *.sm)", "*.obj *.ply *.off *.stl *.sm",
-                "Point Cloud (*.bin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg)",
-                "*.bin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg",
+                "Surface Mesh (*.obj *.ply *.off *.stl *.sm *.csm)", "*.obj *.ply *.off *.stl *.sm *.csm",
+                "Point Cloud (*.bin *.cbin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg)",
+                "*.bin *.cbin *.ply *.xyz *.bxyz *.las *.laz *.vg *.bvg",
                 "Polyhedral Mesh (*.plm *.pm *.mesh)", "*.plm *.pm *.mesh",
                 "Graph (*.ply)", "*.ply",
                 "All Files (*.*)", "*"
@@ -1742,9 +1958,20 @@ namespace easy3d {
 
 
     void Viewer::draw() const {
+        // with many models, the surfaces that can be batched are drawn by a few multi-draw calls
+        const bool batching = setting::drawable_batching_threshold > 0 &&
+                              models_.size() >= setting::drawable_batching_threshold;
+        if (batching) {
+            FrameProfiler::Scope scope("batcher");
+            batcher_->update(models_);
+            batcher_->draw(camera());   easy3d_debug_log_gl_error;
+        } else if (batcher_->num_drawables() > 0)
+            batcher_->clear();
+
         for (const auto m : models_) {
             if (!m->renderer()->is_visible())
                 continue;
+            FrameProfiler::Scope model_scope(m->name(), true);
 
             // Let's check if edges and surfaces are both shown. If true, we
             // make the depth coordinates of the surface smaller, so that displaying
@@ -1752,14 +1979,17 @@ namespace easy3d {
             std::size_t count = 0;
             for (auto d : m->renderer()->lines_drawables()) {
                 if (d->is_visible()) {
+                    FrameProfiler::Scope scope(d->name(), true);
                     d->draw(camera()); easy3d_debug_log_gl_error;
                     ++count;
                 }
             }
 
             for (auto d : m->renderer()->points_drawables()) {
-                if (d->is_visible())
+                if (d->is_visible()) {
+                    FrameProfiler::Scope scope(d->name(), true);
                     d->draw(camera()); easy3d_debug_log_gl_error;
+                }
             }
 
             if (count > 0) {
@@ -1767,16 +1997,20 @@ namespace easy3d {
                 glPolygonOffset(0.5f, -0.0001f);
             }
             for (auto d : m->renderer()->triangles_drawables()) {
-                if (d->is_visible())
+                if (d->is_visible() && !(batching && batcher_->contains(d))) {
+                    FrameProfiler::Scope scope(d->name(), true);
                     d->draw(camera()); easy3d_debug_log_gl_error;
+                }
             }
             if (count > 0)
                 glDisable(GL_POLYGON_OFFSET_FILL);
         }
 
         for (auto d : drawables_) {
-            if (d->is_visible())
+            if (d->is_visible()) {
+                FrameProfiler::Scope scope(d->name(), true);
                 d->draw(camera());
+            }
         }
 
 #if 0 // draw face labels and vertex labels
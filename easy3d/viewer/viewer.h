@@ -30,6 +30,8 @@
 
 #include <string>
 #include <vector>
+#include <thread>
+#include <atomic>
 
 #include <easy3d/core/types.h>
 
@@ -44,6 +46,8 @@ namespace easy3d {
     class TrianglesDrawable;
     class TextRenderer;
     class KeyFrameInterpolator;
+    class DrawableBatcher;
+    class FrameProfiler;
 
     /**
      * @brief The built-in Easy3D Viewer.
@@ -100,6 +104,25 @@ namespace easy3d {
          */
         int run(bool see_all = true);
 
+        /**
+         * @brief Renders the scene along a camera path without showing the window, and reports the frame times.
+         * @details The frames are rendered into an offscreen framebuffer and each frame is finished (i.e., glFinish())
+         *      before it is timed, so no GPU timer queries are needed and it also works with software OpenGL (e.g.,
+         *      Mesa's llvmpipe). The statistics are written in JSON: the number of frames, the framebuffer size, the
+         *      OpenGL renderer, the time for uploading the buffers of all drawables, the min/mean/p99/max frame time
+         *      (in milliseconds), and the number of draw calls per frame. Like run(), it should be called instead of
+         *      run() and it cleans up the viewer when it returns.
+         * @param num_frames The number of frames to render.
+         * @param stats_file The JSON file to write the statistics. If empty, the statistics are only logged.
+         * @param path The camera path to replay. If it has no keyframes, the path of the viewer is used, and if that
+         *      path is also empty, the camera orbits around the scene.
+         * @param width The width of the offscreen framebuffer.
+         * @param height The height of the offscreen framebuffer.
+         * @return EXIT_SUCCESS if the benchmark completed, EXIT_FAILURE otherwise.
+         */
+        int benchmark(int num_frames, const std::string& stats_file, KeyFrameInterpolator* path = nullptr,
+                      int width = 1280, int height = 720);
+
         /**
          * Terminate the viewer.
          */
@@ -170,6 +193,18 @@ namespace easy3d {
         Camera* camera() { return camera_; }
         /// @brief Returns the camera used by the viewer. See \c Camera.
         const Camera* camera() const { return camera_; }
+
+        /**
+         * @brief Returns the batcher that draws the surfaces of the models if the scene has many models (see
+         *        setting::drawable_batching_threshold). It can be given to a ModelPicker.
+         */
+        const DrawableBatcher* batcher() const { return batcher_; }
+
+        /**
+         * @brief Returns the profiler that records the CPU/GPU time of each frame and its render passes. It is
+         *        disabled by default.
+         */
+        FrameProfiler* profiler() { return profiler_; }
         //@}
 
         /// @name File IO
@@ -306,6 +341,16 @@ namespace easy3d {
          */
         void update() const;
 
+        /**
+         * @brief Enables/Disables render-on-demand (disabled by default).
+         * @details In this mode, the scene is redrawn only if update() has been called (e.g., when the camera is
+         *      changed, a model is added, or an animation is running) or if an input event has been handled, instead
+         *      of after every event. Mouse moves without dragging trigger a redraw only if mouse_free_move_event()
+         *      returns true. Client code that changes the scene should call update().
+         */
+        void set_render_on_demand(bool b) { render_on_demand_ = b; update(); }
+        bool render_on_demand() const { return render_on_demand_; }
+
         /**
          * @brief Moves the camera so that the entire scene or the active model is centered on the
          *        screen at a proper scale.
@@ -455,6 +500,10 @@ namespace easy3d {
 
         void setup_callbacks(GLFWwindow*);
 
+        // compiles the cached shader programs that are outdated (e.g., after a driver update) in a background thread.
+        // Only programs used in previous sessions are known (see ShaderManager::prewarm_binary_cache()).
+        void prewarm_shader_programs();
+
 		/* Event handlers. Client code should not touch these */
         virtual bool callback_event_cursor_pos(double x, double y);
         virtual bool callback_event_mouse_button(int button, int action, int modifiers);
@@ -475,6 +524,9 @@ namespace easy3d {
     protected:
 		GLFWwindow*	window_;
 		bool        should_exit_;
+
+		GLFWwindow* prewarm_context_;   // hidden window sharing the context of window_ (for the prewarm thread)
+		std::thread prewarm_thread_;
         float       dpi_scaling_;
         int         width_;
         int         height_;
@@ -495,6 +547,8 @@ namespace easy3d {
 		char   gpu_time_[48];       // show the frame rate
 
         TextRenderer* texter_;
+        DrawableBatcher* batcher_;
+        FrameProfiler* profiler_;
 
 		// mouse
 		int		pressed_button_;    // for mouse drag
@@ -509,6 +563,9 @@ namespace easy3d {
 		bool    show_pivot_point_;
 		bool    show_frame_rate_;
 
+		bool    render_on_demand_;
+		mutable std::atomic<bool> redraw_requested_;  // set by update() and the handled events
+
 		//----------------- viewer data -------------------
 
 		// corner axes
@@ -52,7 +52,7 @@ out Data{
 void main() {
     vec4 new_position = MANIP * vec4(vtx_position, 1.0);
 
-    DataOut.position = vtx_position;
+    DataOut.position = new_position.xyz;
     DataOut.texcoord = vtx_texcoord;
     DataOut.normal = NORMAL * vtx_normal;
 
@@ -0,0 +1,43 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#version 150
+
+
+// the IDs of the model and the drawable (0 is reserved for the background)
+uniform uint model_id;
+uniform uint drawable_id;
+
+out uvec4   outputF;
+
+void main()
+{
+    // NOTE: For points, the gl_PrimitiveID represent the ID of the input points.
+    //		 For polygonal models, the gl_PrimitiveID represent the ID of triangles (the GPU assembles
+    //		 all primitive type, e.g., triangle fan, polygon, triangle strips as triangles).
+    outputF = uvec4(model_id, drawable_id, uint(gl_PrimitiveID), 0u);
+}
@@ -0,0 +1,119 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+// The drawables merged by DrawableBatcher (see surface_batch.vert). Same as surface.frag, except that the selection
+// flag comes from the per-draw data, and textures and highlighting are not supported (such drawables are not batched).
+
+#version 150
+
+uniform vec3	wLightPos;
+uniform vec3	wCamPos;
+layout(std140) uniform Material {
+        vec3	ambient;
+        vec3	specular;
+        float	shininess;
+};
+
+uniform bool        lighting = true;
+// two sides
+uniform bool        two_sides_lighting = true;
+// backside color
+uniform bool        distinct_back_color = true;
+uniform vec3        backside_color = vec3(0.8f, 0.4f, 0.4f);
+
+// smooth shading
+uniform bool        smooth_shading = true;
+
+// output the picking color only
+uniform bool        picking = false;
+
+in Data{
+    vec4 color;
+    vec3 position;
+    vec3 normal;
+    float clipped;
+    flat float selected;
+} DataIn;
+
+out vec4 outputF;
+
+void main(void) {
+    if (DataIn.clipped > 0.0)
+        discard;
+
+    vec4 color = DataIn.color;
+    if (picking) {
+        outputF = color;
+        return;
+    }
+
+    bool selected = (DataIn.selected > 0.5);
+    if (!lighting) {
+        outputF = color;
+        if (selected)
+            outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
+        return;
+    }
+
+    if ((gl_FrontFacing == false) && distinct_back_color)
+        color = vec4(backside_color, color.a);
+
+    if (selected)
+        color = mix(color, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
+
+    vec3 normal;
+    if (smooth_shading)
+        normal = normalize(DataIn.normal);
+    else {
+        normal = normalize(cross(dFdx(DataIn.position), dFdy(DataIn.position)));
+        if ((gl_FrontFacing == false) && (two_sides_lighting == false))
+            normal = -normal;
+    }
+
+    vec3 view_dir = normalize(wCamPos - DataIn.position);
+    vec3 light_dir = normalize(wLightPos);
+
+    float df = 0.0;	// diffuse factor
+    if (two_sides_lighting)
+        df = abs(dot(light_dir, normal));
+    else
+        df = max(dot(light_dir, normal), 0);
+
+    float sf = 0.0;	// specular factor
+    if (df > 0.0) {	// if the vertex is lit compute the specular color
+            vec3 half_vector = normalize(light_dir + view_dir);	// compute the half vector
+
+            if (two_sides_lighting)
+                    sf = abs(dot(half_vector, normal));
+            else
+                    sf = max(dot(half_vector, normal), 0.0);
+
+            sf = pow(sf, shininess);
+    }
+
+    outputF = vec4(color.xyz * df + specular * sf + ambient, color.a);
+}
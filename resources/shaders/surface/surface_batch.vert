@@ -0,0 +1,95 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+// The drawables merged by DrawableBatcher. The per-draw data (i.e., the data that are uniforms for a single drawable)
+// are fetched from a buffer texture using the index of the drawable, stored with each vertex.
+
+#version 150
+
+in  vec3  vtx_position;
+in  vec3  vtx_normal;
+in  vec3  vtx_color;
+in  float vtx_draw_id;
+
+// 9 texels per drawable: MANIP (4 columns), NORMAL (3 columns, the 'w' of the first one is the selection flag),
+// the color, and the color encoding the picking ID.
+uniform samplerBuffer draw_data;
+
+uniform bool per_vertex_color = false;
+uniform bool picking = false;
+
+uniform mat4 MVP;
+
+uniform bool planeClippingDiscard = false;
+uniform bool clippingPlaneEnabled = false;
+uniform bool crossSectionEnabled = false;
+uniform vec4 clippingPlane0;
+uniform vec4 clippingPlane1;
+
+
+out Data{
+    vec4 color;
+    vec3 position;
+    vec3 normal;
+    float clipped;
+    flat float selected;
+} DataOut;
+
+void main() {
+    int base = int(vtx_draw_id + 0.5) * 9;
+    mat4 MANIP = mat4(texelFetch(draw_data, base), texelFetch(draw_data, base + 1),
+                      texelFetch(draw_data, base + 2), texelFetch(draw_data, base + 3));
+    vec4 n0 = texelFetch(draw_data, base + 4);
+    mat3 NORMAL = mat3(n0.xyz, texelFetch(draw_data, base + 5).xyz, texelFetch(draw_data, base + 6).xyz);
+
+    vec4 new_position = MANIP * vec4(vtx_position, 1.0);
+
+    DataOut.clipped = 0.0;
+    if (clippingPlaneEnabled) {
+        gl_ClipDistance[0] = dot(new_position, clippingPlane0);
+        if (planeClippingDiscard && gl_ClipDistance[0] < 0)
+            DataOut.clipped = 1.0;
+        if (crossSectionEnabled) {
+            gl_ClipDistance[1] = dot(new_position, clippingPlane1);
+            if (planeClippingDiscard && gl_ClipDistance[1] < 0)
+                DataOut.clipped = 1.0;
+        }
+    }
+
+    if (picking)
+        DataOut.color = texelFetch(draw_data, base + 8);
+    else if (per_vertex_color)
+        DataOut.color = vec4(vtx_color, 1.0);
+    else
+        DataOut.color = texelFetch(draw_data, base + 7);
+
+    DataOut.selected = n0.w;
+    DataOut.position = new_position.xyz;
+    DataOut.normal = NORMAL * vtx_normal;
+
+    gl_Position = MVP * new_position;
+}
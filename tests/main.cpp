@@ -29,8 +29,23 @@
 #include <easy3d/util/logging.h>
 
 int test_timer();
+int test_timer_service();
 int test_signal();
 int test_console_style();
+int test_frame_sink();
+int test_dirty_ranges();
+int test_triangle_order_optimizer();
+int test_attribute_packing();
+int test_chunk_culler();
+int test_frame_profiler();
+int test_selection_engine();
+int test_thread_pool();
+int test_progress();
+int test_async_logging();
+int test_profiler();
+int test_memory();
+int test_point_cloud_io_ptx();
+int test_surface_mesh_io_obj();
 
 int test_linear_solvers();
 int test_spline();
@@ -81,7 +96,22 @@ int main(int argc, char* argv[]) {
 
     result += test_console_style();
     result += test_timer();
+    result += test_timer_service();
     result += test_signal();
+    result += test_frame_sink();
+    result += test_dirty_ranges();
+    result += test_triangle_order_optimizer();
+    result += test_attribute_packing();
+    result += test_chunk_culler();
+    result += test_frame_profiler();
+    result += test_selection_engine();
+    result += test_thread_pool();
+    result += test_progress();
+    result += test_async_logging();
+    result += test_profiler();
+    result += test_memory();
+    result += test_point_cloud_io_ptx();
+    result += test_surface_mesh_io_obj();
 
     result += test_linear_solvers();
     result += test_spline();
@@ -31,6 +31,7 @@
 #include <easy3d/core/random.h>
 #include <easy3d/renderer/renderer.h>
 #include <easy3d/renderer/drawable_points.h>
+#include <easy3d/renderer/streaming_buffer.h>
 #include <easy3d/util/logging.h>
 #include <easy3d/util/timer.h>
 
@@ -52,6 +53,19 @@ void edit_model(PointCloud *cloud, Viewer *viewer) {
     viewer->update();
 }
 
+void stream_points(PointsDrawable *drawable, Viewer *viewer) {
+    // simulate a sensor feed: the points are written directly into the streaming buffer of the drawable, and only the
+    // new points are transferred to the GPU in the next frame.
+    std::vector<vec3> points(200), colors(200);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = vec3(1.5f + random_float(), random_float(), random_float());
+        colors[i] = vec3(0.0f, random_float(), 1.0f);
+    }
+    drawable->streaming()->append(points, colors);
+    // notify the viewer to update the display
+    viewer->update();
+}
+
 int test_multithread() {
     // initialize logging.
     logging::initialize();
@@ -78,6 +92,17 @@ int test_multithread() {
     // set coloring method: we want to visualize the point cloud using the per point color property
     drawable->set_coloring(Drawable::COLOR_PROPERTY, Drawable::VERTEX, "v:color");
 
+    // a drawable rendering points streamed in by another thread
+    auto stream = new PointsDrawable("stream");
+    stream->enable_streaming(true);
+    stream->set_point_size(5.0f);
+    stream->set_coloring(Drawable::COLOR_PROPERTY, Drawable::VERTEX, "");
+    viewer.add_drawable(stream);
+
+    Timer<PointsDrawable*, Viewer*> stream_timer;
+    stream_timer.set_interval(30, stream_points, stream, &viewer);
+    Timer<>::single_shot(4000, &stream_timer, &Timer<PointsDrawable*, Viewer*>::stop);
+
     // run the process in another thread
     Timer<PointCloud*, Viewer*> timer;
     // call the edit_model() function every 300 milliseconds
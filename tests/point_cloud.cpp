@@ -27,6 +27,7 @@
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/random.h>
 #include <easy3d/fileio/point_cloud_io.h>
+#include <easy3d/algo/point_cloud_normals.h>
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/file_system.h>
 
@@ -68,6 +69,67 @@ int test_point_cloud() {
     }
 
 
+    //  - read only the requested properties from a file and narrow their storage.
+    {
+        auto normals = cloud.add_vertex_property<vec3>("v:normal", vec3(0, 0, 1));
+        auto labels = cloud.add_vertex_property<int>("v:label");
+        auto weights = cloud.add_vertex_property<float>("v:weight", 1.0f);
+        for (auto v : cloud.vertices())
+            labels[v] = v.idx() % 7;
+
+        const std::string file_name = "./grid-copy.ply";
+        if (!PointCloudIO::save(file_name, &cloud)) {
+            LOG(ERROR) << "Error: failed to save the point cloud into a ply file";
+            return EXIT_FAILURE;
+        }
+
+        LoadOptions options = LoadOptions::compact();
+        options.properties = {"v:color", "v:normal", "v:label"};
+        PointCloud* copy = PointCloudIO::load(file_name, options);
+        file_system::delete_file(file_name);
+        if (!copy || copy->n_vertices() != cloud.n_vertices()) {
+            LOG(ERROR) << "Error: failed to read the point cloud with load options";
+            delete copy;
+            return EXIT_FAILURE;
+        }
+
+        auto colors = cloud.get_vertex_property<vec3>("v:color");
+        // the narrowed properties are stored under distinct names
+        auto narrowed_colors = copy->get_vertex_property<u8vec3>("v:color_u8");
+        auto half_normals = copy->get_vertex_property<hvec3>("v:normal_h");
+        auto narrowed_labels = copy->get_vertex_property<unsigned char>("v:label_u8");
+        bool ok = narrowed_colors && half_normals && narrowed_labels && !copy->get_vertex_property<float>("v:weight") &&
+                  !copy->get_vertex_property<vec3>("v:color") && !copy->get_vertex_property<vec3>("v:normal");
+        for (auto v : cloud.vertices()) {
+            if (!ok)
+                break;
+            ok = distance(rgb::unpack(narrowed_colors[v]), colors[v]) < 0.01f &&
+                 half::unpack(half_normals[v]) == normals[v] &&
+                 narrowed_labels[v] == labels[v];
+        }
+
+        // algorithms don't meet the narrowed properties, e.g., normal estimation creates full-precision normals
+        if (ok) {
+            ok = PointCloudNormals().estimate(copy, 8);
+            auto estimated = copy->get_vertex_property<vec3>("v:normal");
+            for (auto v : copy->vertices()) {
+                if (!ok || !estimated)
+                    break;
+                ok = std::abs(std::abs(estimated[v].z) - 1.0f) < 1e-4f;   // the points are on the XY plane
+            }
+        }
+        delete copy;
+        cloud.remove_vertex_property(normals);
+        cloud.remove_vertex_property(labels);
+        cloud.remove_vertex_property(weights);
+        if (!ok) {
+            LOG(ERROR) << "Error: the properties read with load options differ from the original ones";
+            return EXIT_FAILURE;
+        }
+        std::cout << "point cloud read with selected and narrowed properties" << std::endl;
+    }
+
+
     //  - load a point cloud from a file;
     //  - save a point cloud to a file.
     {
@@ -109,6 +171,34 @@ int test_point_cloud() {
             else
                 std::cerr << "failed to delete the saved file" << std::endl;
         }
+
+        // Save the model into a compressed file and read it back. The coordinates are quantized, so we check the
+        // difference w.r.t. the maximum quantization error.
+        const std::string compressed_file_name = "./bunny-copy.cbin";
+        if (!io::save_cbin(compressed_file_name, cloud, 16)) {
+            LOG(ERROR) << "Error: failed to save the point cloud into a compressed file";
+            return EXIT_FAILURE;
+        }
+        PointCloud* copy = PointCloudIO::load(compressed_file_name);
+        file_system::delete_file(compressed_file_name);
+        if (!copy || copy->n_vertices() != cloud->n_vertices()) {
+            LOG(ERROR) << "Error: the point cloud read from the compressed file differs from the original one";
+            delete copy;
+            return EXIT_FAILURE;
+        }
+        Box3 box;
+        for (const auto& p : cloud->points())
+            box.grow(p);
+        float max_error = 0.0f;
+        for (auto v : cloud->vertices())
+            max_error = std::max(max_error, distance(cloud->position(v), copy->position(v)));
+        std::cout << "point cloud saved to and read from a compressed file (max error: " << max_error << ")" << std::endl;
+        delete copy;
+        delete cloud;
+        if (max_error > box.diagonal_length() / 65535.0f) {
+            LOG(ERROR) << "Error: quantization error is too large";
+            return EXIT_FAILURE;
+        }
     }
     
     return EXIT_SUCCESS;
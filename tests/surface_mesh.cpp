@@ -30,6 +30,11 @@
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/file_system.h>
 
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <cstring>
+
 
 using namespace easy3d;
 
@@ -315,6 +320,74 @@ int test_surface_mesh() {
             std::cout << "the saved file has been deleted"  << std::endl;
         else
             std::cerr << "failed to delete the saved file" << std::endl;
+
+        // Write the mesh into a compressed file and read it back.
+        const std::string compressed_file_name = "./sphere-copy.csm";
+        if (!io::save_csm(compressed_file_name, mesh, 20)) {
+            LOG(ERROR) << "Error: failed to save the mesh into a compressed file";
+            return EXIT_FAILURE;
+        }
+        SurfaceMesh* copy = SurfaceMeshIO::load(compressed_file_name);
+        file_system::delete_file(compressed_file_name);
+        if (!copy || copy->n_vertices() != mesh->n_vertices() || copy->n_faces() != mesh->n_faces()) {
+            LOG(ERROR) << "Error: the mesh read from the compressed file differs from the original one";
+            delete copy;
+            return EXIT_FAILURE;
+        }
+        // The vertices are renumbered when saving, but the faces keep their order. So the positions are compared
+        // face by face (up to the quantization error).
+        const float tolerance = 2.0f * mesh->bounding_box().diagonal_length() / static_cast<float>((1 << 20) - 1);
+        float max_error = 0.0f;
+        for (auto f : mesh->faces()) {
+            const SurfaceMesh::Face g(f.idx());
+            for (auto v : mesh->vertices(f)) {
+                float dist = std::numeric_limits<float>::max();
+                for (auto u : copy->vertices(g))
+                    dist = std::min(dist, distance(mesh->position(v), copy->position(u)));
+                max_error = std::max(max_error, dist);
+            }
+        }
+        delete copy;
+        if (max_error > tolerance) {
+            LOG(ERROR) << "Error: the positions read from the compressed file differ from the original ones (max error: "
+                       << max_error << ")";
+            return EXIT_FAILURE;
+        }
+        std::cout << "mesh saved to and read from a compressed file (max error: " << max_error << ")" << std::endl;
+
+        // A truncated file and files with a wrong number of faces must be rejected.
+        if (!io::save_csm(compressed_file_name, mesh, 20)) {
+            LOG(ERROR) << "Error: failed to save the mesh into a compressed file";
+            return EXIT_FAILURE;
+        }
+        std::vector<char> bytes;
+        {
+            std::ifstream input(compressed_file_name.c_str(), std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        }
+        std::vector<char> truncated(bytes.begin(), bytes.begin() + bytes.size() / 2);
+        std::vector<char> more_faces = bytes, fewer_faces = bytes;
+        uint32_t nf = 0;
+        std::memcpy(&nf, bytes.data() + 12, sizeof(uint32_t)); // after the magic, the version, and #vertices
+        const uint32_t more = nf + 1, fewer = nf - 1;
+        std::memcpy(more_faces.data() + 12, &more, sizeof(uint32_t));
+        std::memcpy(fewer_faces.data() + 12, &fewer, sizeof(uint32_t));
+        for (const auto &data : {truncated, more_faces, fewer_faces}) {
+            {
+                std::ofstream output(compressed_file_name.c_str(), std::ios::binary);
+                output.write(data.data(), static_cast<std::streamsize>(data.size()));
+            }
+            copy = SurfaceMeshIO::load(compressed_file_name);
+            if (copy) {
+                LOG(ERROR) << "Error: a corrupted compressed file has been accepted";
+                delete copy;
+                file_system::delete_file(compressed_file_name);
+                return EXIT_FAILURE;
+            }
+        }
+        file_system::delete_file(compressed_file_name);
+        std::cout << "corrupted compressed files rejected" << std::endl;
+        delete mesh;
     }
 
     return EXIT_SUCCESS;
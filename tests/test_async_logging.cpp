@@ -0,0 +1,161 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/util/logging.h>
+#include <easy3d/util/thread_pool.h>
+
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+
+
+using namespace easy3d;
+
+
+// counts the messages it receives
+class CountingLogger : public logging::Logger {
+public:
+    CountingLogger() : count(0) {}
+    void send(el::Level, const std::string &) override { ++count; }
+    std::atomic<int> count;
+};
+
+
+// logs messages from several threads through the asynchronous sink, and checks in the console output that no message
+// is lost (unless it has been dropped and counted because the buffer was full) and that the messages of each thread
+// are in order
+bool test_async_sink(int num_threads, int num_messages, std::size_t capacity) {
+    // a tag that identifies the messages of this run in the log file
+    const std::string tag = "async-sink-test-" + std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+
+    // ERROR messages are written to the console (see main.cpp), which is captured while the sink is enabled
+    std::ostringstream output;
+    std::streambuf *console = std::cout.rdbuf(output.rdbuf());
+    logging::set_asynchronous(true, capacity);
+    if (!logging::is_asynchronous()) {
+        std::cout.rdbuf(console);
+        LOG(ERROR) << "failed enabling asynchronous logging";
+        return false;
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&tag, t, num_messages]() {
+            for (int i = 0; i < num_messages; ++i)
+                LOG(ERROR) << tag << " " << t << " " << i;
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    logging::flush();
+    const std::size_t dropped = logging::num_dropped();
+    logging::set_asynchronous(false);
+    std::cout.rdbuf(console);
+    if (logging::is_asynchronous()) {
+        LOG(ERROR) << "failed disabling asynchronous logging";
+        return false;
+    }
+
+    std::istringstream input(output.str());
+    std::vector<int> last(num_threads, -1);
+    std::size_t received = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        const std::size_t pos = line.find(tag);
+        if (pos == std::string::npos)
+            continue;
+        std::istringstream stream(line.substr(pos + tag.size()));
+        int t = -1, i = -1;
+        stream >> t >> i;
+        if (t < 0 || t >= num_threads || i <= last[t] || i >= num_messages) {
+            LOG(ERROR) << "message out of order: " << line;
+            return false;
+        }
+        last[t] = i;
+        ++received;
+    }
+    const std::size_t total = static_cast<std::size_t>(num_threads) * num_messages;
+    if (received + dropped != total || (capacity >= total && dropped > 0)) {
+        LOG(ERROR) << "lost messages: " << received << " written and " << dropped << " dropped (expected " << total
+                   << ")";
+        return false;
+    }
+    return true;
+}
+
+
+int test_async_logging() {
+    CountingLogger logger;
+
+    // LOG_FIRST_N logs the first n messages and counts the others
+    logging::report_suppressed();
+    for (int i = 0; i < 1000; ++i)
+        LOG_FIRST_N(3, INFO) << "message " << i;
+    if (logger.count != 3) {
+        LOG(ERROR) << "LOG_FIRST_N logged " << logger.count << " messages (expected 3)";
+        return EXIT_FAILURE;
+    }
+    logger.count = 0;
+    const std::size_t suppressed = logging::report_suppressed();
+    if (suppressed != 997 || logger.count != 1) {  // the report is one message
+        LOG(ERROR) << "LOG_FIRST_N suppressed " << suppressed << " messages (expected 997)";
+        return EXIT_FAILURE;
+    }
+
+    // LOG_EVERY_SECONDS logs once per interval, also from concurrent threads
+    logger.count = 0;
+    parallel_for(0, 100000, [](int i) {
+        LOG_EVERY_SECONDS(100, INFO) << "message " << i;
+    });
+    if (logger.count != 1 || logging::report_suppressed() != 99999) {
+        LOG(ERROR) << "LOG_EVERY_SECONDS logged " << logger.count << " messages (expected 1)";
+        return EXIT_FAILURE;
+    }
+
+    // LOG_FILTERED removes the DEBUG messages from release builds, including the streamed expressions
+    int evaluated = 0;
+    LOG_FILTERED(DEBUG) << "debug message " << ++evaluated;
+    LOG_FILTERED(ERROR) << "error message " << ++evaluated;
+#ifdef NDEBUG
+    if (evaluated != 1) {
+#else
+    if (evaluated != 2) {
+#endif
+        LOG(ERROR) << "LOG_FILTERED evaluated " << evaluated << " messages";
+        return EXIT_FAILURE;
+    }
+
+    // asynchronous logging from multiple threads: a buffer large enough for all the messages, and a small one that
+    // wraps around many times (and may drop messages)
+    if (!test_async_sink(8, 2000, 1 << 15) || !test_async_sink(8, 5000, 256))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
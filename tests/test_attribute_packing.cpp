@@ -0,0 +1,168 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+
+
+#include <easy3d/core/attribute_packing.h>
+#include <easy3d/core/random.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <cmath>
+
+using namespace easy3d;
+
+
+int test_attribute_packing() {
+    const std::size_t num = 10000;
+
+    // positions: the error is bounded by half a quantization step (plus rounding errors of floats)
+    const Box3 box(vec3(-3.0f, 10.0f, 0.5f), vec3(7.0f, 12.0f, 100.5f));
+    std::vector<vec3> points(num);
+    for (auto &p : points) {
+        for (int j = 0; j < 3; ++j)
+            p[j] = random_float() * box.range(j) + box.min_coord(j);
+    }
+    points[0] = box.min_point();
+    points[1] = box.max_point();
+
+    std::vector<uint16_t> quantized(num * 4);
+    packing::quantize_positions(points.data(), num, box, quantized.data());
+    std::vector<vec3> dequantized(num);
+    packing::dequantize_positions(quantized.data(), num, box, dequantized.data());
+    for (std::size_t i = 0; i < num; ++i) {
+        if (quantized[i * 4 + 3] != 65535) {
+            LOG(ERROR) << "wrong w component of quantized position " << i << ": " << quantized[i * 4 + 3];
+            return EXIT_FAILURE;
+        }
+        for (int j = 0; j < 3; ++j) {
+            const float tolerance = box.range(j) / 65535.0f;
+            if (std::abs(points[i][j] - dequantized[i][j]) > tolerance) {
+                LOG(ERROR) << "quantization error too large: " << points[i] << " vs. " << dequantized[i];
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // the dequantization matrix maps what the GPU sees (i.e., quantized / 65535) to the positions
+    const mat4 m = packing::dequantization_matrix(box);
+    for (std::size_t i = 0; i < num; i += 97) {
+        const vec3 normalized(quantized[i * 4] / 65535.0f, quantized[i * 4 + 1] / 65535.0f,
+                              quantized[i * 4 + 2] / 65535.0f);
+        const vec3 p = m * normalized;
+        if (distance(p, dequantized[i]) > 1e-4f * box.diagonal_length()) {
+            LOG(ERROR) << "wrong dequantization matrix: " << p << " vs. " << dequantized[i];
+            return EXIT_FAILURE;
+        }
+    }
+    if (distance(m * vec3(0, 0, 0), box.min_point()) > 1e-5f || distance(m * vec3(1, 1, 1), box.max_point()) > 1e-4f) {
+        LOG(ERROR) << "the dequantization matrix does not map the unit cube to the box";
+        return EXIT_FAILURE;
+    }
+
+    // normals: 10:10:10:2 has 511 steps per half axis
+    std::vector<vec3> normals(num);
+    for (auto &n : normals)
+        n = normalize(vec3(random_float() - 0.5f, random_float() - 0.5f, random_float() - 0.5f) + vec3(1e-3f));
+    normals[0] = vec3(1, 0, 0);
+    normals[1] = vec3(0, -1, 0);
+    normals[2] = vec3(0, 0, -1);
+    std::vector<uint32_t> packed(num);
+    packing::pack_normals(normals.data(), num, packed.data());
+    std::vector<vec3> unpacked(num);
+    packing::unpack_normals(packed.data(), num, unpacked.data());
+    for (std::size_t i = 0; i < num; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (std::abs(normals[i][j] - unpacked[i][j]) > 0.5f / 511.0f + 1e-6f) {
+                LOG(ERROR) << "normal packing error too large: " << normals[i] << " vs. " << unpacked[i];
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // octahedral encoding (for storage): two 16-bit components give an angular error of about 1e-4
+    for (std::size_t i = 0; i < num; ++i) {
+        const vec3 n = packing::decode_octahedral(packing::encode_octahedral(normals[i]));
+        if (distance(n, normals[i]) > 1e-4f) {
+            LOG(ERROR) << "octahedral encoding error too large: " << normals[i] << " vs. " << n;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // colors: RGBA8 has 255 steps
+    std::vector<vec3> colors(num);
+    for (auto &c : colors)
+        c = random_color(false);
+    colors[0] = vec3(0, 0, 0);
+    colors[1] = vec3(1, 1, 1);
+    packing::pack_colors(colors.data(), num, packed.data());
+    std::vector<vec3> unpacked_colors(num);
+    packing::unpack_colors(packed.data(), num, unpacked_colors.data());
+    for (std::size_t i = 0; i < num; ++i) {
+        if ((packed[i] >> 24) != 255) {
+            LOG(ERROR) << "packed colors must be opaque";
+            return EXIT_FAILURE;
+        }
+        for (int j = 0; j < 3; ++j) {
+            if (std::abs(colors[i][j] - unpacked_colors[i][j]) > 0.5f / 255.0f + 1e-6f) {
+                LOG(ERROR) << "color packing error too large: " << colors[i] << " vs. " << unpacked_colors[i];
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    if (packing::unpack_color(packing::pack_color(vec4(0.2f, 0.4f, 0.6f, 0.8f))) != vec4(51, 102, 153, 204) / 255.0f) {
+        LOG(ERROR) << "wrong RGBA8 conversion";
+        return EXIT_FAILURE;
+    }
+
+    // texture coordinates: half floats have an 11-bit significand, i.e., a relative error of 2^-11
+    std::vector<vec2> texcoords(num);
+    for (auto &t : texcoords)
+        t = vec2(random_float() * 4.0f - 2.0f, random_float());
+    texcoords[0] = vec2(0, 1);
+    texcoords[1] = vec2(0.5f, 0.25f);
+    std::vector<uint16_t> halfs(num * 2);
+    packing::pack_texcoords(texcoords.data(), num, halfs.data());
+    std::vector<vec2> unpacked_texcoords(num);
+    packing::unpack_texcoords(halfs.data(), num, unpacked_texcoords.data());
+    for (std::size_t i = 0; i < num; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            const float t = texcoords[i][j];
+            if (std::abs(t - unpacked_texcoords[i][j]) > std::abs(t) / 2048.0f + 1e-7f) {
+                LOG(ERROR) << "texcoord packing error too large: " << texcoords[i] << " vs. " << unpacked_texcoords[i];
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    if (unpacked_texcoords[0] != texcoords[0] || unpacked_texcoords[1] != texcoords[1]) {
+        LOG(ERROR) << "exactly representable texcoords must be preserved";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+
+
+#include <easy3d/renderer/chunk_culler.h>
+#include <easy3d/renderer/transform.h>
+#include <easy3d/core/random.h>
+#include <easy3d/util/stop_watch.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <algorithm>
+
+using namespace easy3d;
+
+
+// a chunk is outside the frustum if all the corners of its box are outside one of the clipping planes
+bool is_outside(const Box3 &box, const mat4 &mvp) {
+    int outside[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 8; ++i) {
+        const vec3 p((i & 1) ? box.max_coord(0) : box.min_coord(0),
+                     (i & 2) ? box.max_coord(1) : box.min_coord(1),
+                     (i & 4) ? box.max_coord(2) : box.min_coord(2));
+        const vec4 c = mvp * vec4(p, 1.0f);
+        outside[0] += c.x < -c.w;
+        outside[1] += c.x > c.w;
+        outside[2] += c.y < -c.w;
+        outside[3] += c.y > c.w;
+        outside[4] += c.z < -c.w;
+        outside[5] += c.z > c.w;
+    }
+    return std::find(outside, outside + 6, 8) != outside + 6;
+}
+
+
+int test_chunk_culler() {
+    // partition: bounded chunk sizes, a permutation of the primitives, and compact chunks
+    std::vector<vec3> points(100000);
+    for (auto &p : points)
+        p = vec3(random_float(), random_float(), random_float());
+    std::vector<unsigned int> order;
+    const auto offsets = ChunkCuller::partition(points, 1000, order);
+    std::vector<unsigned int> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        if (sorted[i] != i) {
+            LOG(ERROR) << "the partition is not a permutation of the primitives";
+            return EXIT_FAILURE;
+        }
+    }
+    if (offsets.front() != 0 || offsets.back() != points.size() || offsets.size() < 101) {
+        LOG(ERROR) << "wrong chunk offsets (" << offsets.size() - 1 << " chunks)";
+        return EXIT_FAILURE;
+    }
+    float volume = 0.0f;
+    for (std::size_t c = 0; c + 1 < offsets.size(); ++c) {
+        if (offsets[c + 1] <= offsets[c] || offsets[c + 1] - offsets[c] > 1000) {
+            LOG(ERROR) << "wrong size of chunk " << c << ": " << offsets[c + 1] - offsets[c];
+            return EXIT_FAILURE;
+        }
+        Box3 box;
+        for (std::size_t i = offsets[c]; i < offsets[c + 1]; ++i)
+            box.grow(points[order[i]]);
+        volume += box.range(0) * box.range(1) * box.range(2);
+    }
+    if (volume > 1.1f) {  // the chunks of the unit cube barely overlap
+        LOG(ERROR) << "the chunks are not spatially coherent (total volume " << volume << ")";
+        return EXIT_FAILURE;
+    }
+
+    // frustum culling: 100k random chunks around a perspective camera
+    std::vector<ChunkCuller::Chunk> chunks(100000);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const vec3 center(random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f));
+        const vec3 extent(random_float(0.01f, 0.5f), random_float(0.01f, 0.5f), random_float(0.01f, 0.5f));
+        Box3 box;
+        box.grow(center - extent);
+        box.grow(center + extent);
+        chunks[i] = ChunkCuller::Chunk(box, i * 3, 3);
+    }
+    ChunkCuller culler;
+    culler.set_chunks(chunks);
+
+    const mat4 view = transform::look_at(vec3(0, 0, 12), vec3(0, 0, 0), vec3(0, 1, 0));
+    const mat4 mvp = transform::perspective(static_cast<float>(M_PI) / 4.0f, 800.0f, 600.0f, 0.1f, 20.0f) * view;
+    std::vector<std::size_t> visible;
+    StopWatch w;
+    const std::size_t num_visible = culler.cull(mvp, 800, 600, 0.0f, visible);
+    LOG(INFO) << "culling " << chunks.size() << " chunks took " << w.time_string() << " (" << num_visible
+              << " visible)";
+
+    std::vector<bool> is_visible(chunks.size(), false);
+    for (auto i : visible)
+        is_visible[i] = true;
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const bool outside = is_outside(chunks[i].box, mvp);
+        expected += !outside;
+        if (outside == is_visible[i]) {
+            LOG(ERROR) << "chunk " << i << " wrongly " << (outside ? "drawn" : "culled");
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_visible != expected || num_visible == 0 || num_visible == chunks.size()) {
+        LOG(ERROR) << "unexpected number of visible chunks: " << num_visible << " (expected " << expected << ")";
+        return EXIT_FAILURE;
+    }
+
+    // small-feature culling: an orthographic view of 100 pixels for 2 units, i.e., 50 pixels per unit
+    Box3 small, large;  // the diameters of the bounding spheres are about 1.7 and 17 pixels, respectively
+    small.grow(vec3(-0.01f, -0.01f, -0.01f));
+    small.grow(vec3(0.01f, 0.01f, 0.01f));
+    large.grow(vec3(-0.1f, -0.1f, -0.1f));
+    large.grow(vec3(0.1f, 0.1f, 0.1f));
+    culler.set_chunks({ChunkCuller::Chunk(small, 0, 3), ChunkCuller::Chunk(large, 3, 3),
+                       ChunkCuller::Chunk(Box3(), 6, 0)});  // empty chunks are never visible
+    const mat4 ortho = transform::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+    if (culler.cull(ortho, 100, 100, 1.0f, visible) != 2 || culler.cull(ortho, 100, 100, 2.0f, visible) != 1 ||
+        visible[0] != 1) {
+        LOG(ERROR) << "wrong small-feature culling";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
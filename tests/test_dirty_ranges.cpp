@@ -0,0 +1,146 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+
+#include <easy3d/core/dirty_ranges.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+
+using namespace easy3d;
+
+
+// checks the ranges against the expected ones, given as {begin, end, begin, end, ...}
+bool check_ranges(const DirtyRanges &ranges, const std::vector<std::size_t> &expected, const std::string &what) {
+    std::vector<std::size_t> values;
+    for (const auto &r : ranges.ranges()) {
+        values.push_back(r.first);
+        values.push_back(r.second);
+    }
+    if (values != expected) {
+        std::string str;
+        for (std::size_t i = 0; i < values.size(); i += 2)
+            str += "[" + std::to_string(values[i]) + ", " + std::to_string(values[i + 1]) + ") ";
+        LOG(ERROR) << what << ": unexpected ranges " << str;
+        return false;
+    }
+    return true;
+}
+
+
+int test_dirty_ranges() {
+    // merging of overlapping and adjacent ranges
+    DirtyRanges ranges;
+    ranges.add(10, 20);
+    ranges.add(30, 40);
+    ranges.add(5);
+    ranges.add(7, 7);   // empty, ignored
+    if (!check_ranges(ranges, {5, 6, 10, 20, 30, 40}, "insertion"))
+        return EXIT_FAILURE;
+    ranges.add(20, 25); // adjacent
+    ranges.add(15, 32); // overlaps two ranges
+    if (!check_ranges(ranges, {5, 6, 10, 40}, "merging"))
+        return EXIT_FAILURE;
+    if (ranges.count() != 31 || !ranges.contains(5) || ranges.contains(6) || !ranges.contains(39) || ranges.contains(40)) {
+        LOG(ERROR) << "wrong count or membership";
+        return EXIT_FAILURE;
+    }
+    ranges.add(0, 100);
+    if (!check_ranges(ranges, {0, 100}, "covering"))
+        return EXIT_FAILURE;
+
+    // merging of ranges separated by small gaps
+    DirtyRanges gapped(2);
+    gapped.add(0, 2);
+    gapped.add(4, 5);   // gap 2: merged
+    gapped.add(8, 9);   // gap 3: kept
+    gapped.add(12);     // gap 3: kept
+    if (!check_ranges(gapped, {0, 5, 8, 9, 12, 13}, "gap merging"))
+        return EXIT_FAILURE;
+    gapped.add(10);     // closes the gaps around it
+    if (!check_ranges(gapped, {0, 5, 8, 13}, "gap closing"))
+        return EXIT_FAILURE;
+
+    // bounding the number of ranges: the smallest gaps are merged first
+    DirtyRanges scattered;
+    for (std::size_t i : {0, 10, 12, 50, 52, 100})
+        scattered.add(i);
+    scattered.coalesce(3);
+    if (!check_ranges(scattered, {0, 13, 50, 53, 100, 101}, "coalescing"))
+        return EXIT_FAILURE;
+    scattered.coalesce(1);
+    if (!check_ranges(scattered, {0, 101}, "coalescing into one range") || scattered.bounds() != DirtyRanges::Range(0, 101))
+        return EXIT_FAILURE;
+
+    // clipping to the number of elements, and "all"
+    scattered.clip(60);
+    if (!check_ranges(scattered, {0, 60}, "clipping"))
+        return EXIT_FAILURE;
+    scattered.add_all();
+    scattered.add(3, 4);
+    if (!scattered.all() || scattered.empty() || !scattered.contains(1000)) {
+        LOG(ERROR) << "all elements should be modified";
+        return EXIT_FAILURE;
+    }
+    scattered.clip(8);
+    if (scattered.all() || !check_ranges(scattered, {0, 8}, "clipping all"))
+        return EXIT_FAILURE;
+    scattered.clear();
+    if (!scattered.empty()) {
+        LOG(ERROR) << "ranges not cleared";
+        return EXIT_FAILURE;
+    }
+
+    // the modifications recorded on a model
+    PointCloud cloud;
+    for (int i = 0; i < 100; ++i)
+        cloud.add_vertex(vec3(static_cast<float>(i), 0.0f, 0.0f));
+    const Box3 &box = cloud.bounding_box();
+    if (box.max_point().x != 99.0f) {
+        LOG(ERROR) << "wrong bounding box";
+        return EXIT_FAILURE;
+    }
+    cloud.position(PointCloud::Vertex(42)) = vec3(200.0f, 0.0f, 0.0f);
+    cloud.mark_modified("v:point", 42);
+    cloud.mark_modified("v:color", 10, 20);
+    cloud.mark_modified("v:color", 20, 30);
+    if (!cloud.modified_ranges("v:point") || !check_ranges(*cloud.modified_ranges("v:color"), {10, 30}, "model"))
+        return EXIT_FAILURE;
+    if (cloud.bounding_box().max_point().x != 200.0f) {
+        LOG(ERROR) << "bounding box not updated after moving a point";
+        return EXIT_FAILURE;
+    }
+    cloud.clear_modified();
+    if (cloud.modified_ranges("v:point") || !cloud.modified_ranges().empty()) {
+        LOG(ERROR) << "modifications not cleared";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
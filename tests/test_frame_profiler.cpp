@@ -0,0 +1,180 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/renderer/frame_profiler.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace easy3d;
+
+
+// a manual clock (in milliseconds) advanced by the "work" of the scopes
+static double now = 0.0;
+
+static bool equal(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+
+int test_frame_profiler() {
+    FrameProfiler profiler(10);
+    profiler.set_clock([]() { return now; });
+
+    // 20 frames: "shadow" (with two passes) costs 1..20 ms, "ssao" is entered twice per frame at 0.5 ms each
+    for (int i = 1; i <= 20; ++i) {
+        profiler.begin_frame();
+        {
+            FrameProfiler::Scope shadow("shadow");
+            {
+                FrameProfiler::Scope pass("shadow_map_pass");
+                now += i * 0.25;
+            }
+            {
+                FrameProfiler::Scope pass("render_pass");
+                now += i * 0.75;
+            }
+        }
+        for (int k = 0; k < 2; ++k) {
+            FrameProfiler::Scope ssao("ssao");
+            now += 0.5;
+        }
+        {
+            FrameProfiler::Scope drawable("faces", true);  // ignored: drawable timing is disabled
+            now += 100.0;
+        }
+        profiler.end_frame();
+        now += 3.0;     // e.g., swapping buffers, which is not part of the frame
+    }
+
+    FrameProfiler::Scope outside("outside");    // ignored: no frame is being recorded
+    if (FrameProfiler::active() != nullptr || profiler.num_frames() != 20) {
+        LOG(ERROR) << "the profiler should be inactive after 20 frames";
+        return EXIT_FAILURE;
+    }
+
+    const auto stats = profiler.statistics();
+    const char *paths[] = {"frame", "frame/shadow", "frame/shadow/shadow_map_pass", "frame/shadow/render_pass",
+                           "frame/ssao"};
+    if (stats.size() != 5) {
+        LOG(ERROR) << "expected 5 scopes, but got " << stats.size();
+        return EXIT_FAILURE;
+    }
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].path != paths[i] || stats[i].frames != 10 || stats[i].has_gpu) {
+            LOG(ERROR) << "unexpected scope " << stats[i].path << " (expected " << paths[i] << ")";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the window holds frames 11..20: the shadow costs 11..20 ms (mean 15.5, p95 20), ssao 1 ms (called twice)
+    const auto &shadow = stats[1];
+    const auto &ssao = stats[4];
+    if (shadow.depth != 1 || !equal(shadow.cpu_last, 20.0) || !equal(shadow.cpu_mean, 15.5) ||
+        !equal(shadow.cpu_p95, 20.0) || !equal(stats[2].cpu_mean, 15.5 * 0.25) || stats[3].depth != 2) {
+        LOG(ERROR) << "wrong statistics of shadow: " << shadow.cpu_last << ", " << shadow.cpu_mean << ", "
+                   << shadow.cpu_p95;
+        return EXIT_FAILURE;
+    }
+    if (ssao.count != 2 || !equal(ssao.cpu_mean, 1.0) || !equal(ssao.cpu_p95, 1.0)) {
+        LOG(ERROR) << "wrong statistics of ssao: " << ssao.count << ", " << ssao.cpu_mean;
+        return EXIT_FAILURE;
+    }
+    if (!equal(stats[0].cpu_mean, 15.5 + 1.0 + 100.0)) {
+        LOG(ERROR) << "wrong frame time: " << stats[0].cpu_mean;
+        return EXIT_FAILURE;
+    }
+
+    // the drawables are recorded on demand, and unclosed scopes are closed with the frame
+    profiler.set_drawable_timing(true);
+    profiler.begin_frame();
+    {
+        FrameProfiler::Scope drawable("faces", true);
+        now += 2.0;
+    }
+    profiler.begin_scope("unclosed");
+    now += 1.0;
+    profiler.end_frame();
+    const auto last = profiler.statistics();
+    if (last.size() != 7 || last[5].name != "faces" || !equal(last[5].cpu_last, 2.0) ||
+        !equal(last[6].cpu_last, 1.0) || !equal(last[0].cpu_last, 3.0)) {
+        LOG(ERROR) << "wrong drawable or unclosed scopes";
+        return EXIT_FAILURE;
+    }
+
+    // the scopes are also zones of the hierarchical profiler when it is recording, even without a frame
+    Profiler::start();
+    profiler.begin_frame();
+    {
+        FrameProfiler::Scope shadow("shadow");
+        FrameProfiler::Scope drawable("faces", true);
+    }
+    profiler.end_frame();
+    {
+        FrameProfiler::Scope pass("outside");
+        FrameProfiler::Scope drawable("lines", true);  // ignored: no active profiler times the drawables
+    }
+    Profiler::stop();
+    const auto zones = Profiler::statistics();
+    Profiler::clear();
+#ifndef EASY3D_DISABLE_PROFILER
+    if (zones.size() != 3 || zones[0].path != "shadow" || zones[1].path != "shadow/faces" ||
+        zones[2].path != "outside") {
+        LOG(ERROR) << "the scopes are not recorded as zones of the hierarchical profiler";
+        return EXIT_FAILURE;
+    }
+#endif
+
+    // Chrome trace: 10 frames in the window
+    const std::string file = "./frame_trace.json";
+    if (!profiler.save_chrome_trace(file)) {
+        LOG(ERROR) << "failed saving the trace";
+        return EXIT_FAILURE;
+    }
+    std::ifstream input(file.c_str());
+    std::stringstream buffer;
+    buffer << input.rdbuf();
+    const std::string json = buffer.str();
+    std::size_t events = 0;
+    for (std::size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos; pos = json.find("\"ph\":\"X\"", pos + 1))
+        ++events;
+    file_system::delete_file(file);
+    if (json.find("{\"traceEvents\":[") != 0 || events != 8 * 6 + 3 + 3) {
+        LOG(ERROR) << "unexpected trace (" << events << " events)";
+        return EXIT_FAILURE;
+    }
+
+    profiler.clear();
+    if (profiler.num_frames() != 0 || profiler.statistics().size() != 0) {
+        LOG(ERROR) << "the profiler was not cleared";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
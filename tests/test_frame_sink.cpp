@@ -0,0 +1,155 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/fileio/frame_sink.h>
+#include <easy3d/fileio/image_io.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+
+using namespace easy3d;
+
+
+// creates a test image (with smooth regions that compress well and noise that doesn't, or only noise)
+std::vector<unsigned char> create_image(int width, int height, int channels, bool noise_only = false) {
+    std::vector<unsigned char> data(static_cast<std::size_t>(width) * height * channels);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                const std::size_t idx = (static_cast<std::size_t>(y) * width + x) * channels + c;
+                if (x < width / 2 && !noise_only)
+                    data[idx] = static_cast<unsigned char>((x * (c + 1) + y) & 0xff);
+                else
+                    data[idx] = static_cast<unsigned char>(rand() & 0xff);
+            }
+        }
+    }
+    return data;
+}
+
+
+// writes an image band by band through a frame sink and checks the file content
+bool test_image_stream(const std::string &file_name, int width, int height, int channels, int band_height,
+                       bool noise_only = false) {
+    const std::vector<unsigned char> &image = create_image(width, height, channels, noise_only);
+    const std::size_t stride = static_cast<std::size_t>(width) * channels;
+
+    ImageStreamWriter writer;
+    if (!writer.open(file_name, width, height, channels))
+        return false;
+
+    // the bands are consumed in order by a single worker
+    FrameSink sink([&writer](FrameSink::Frame &frame) -> bool {
+        return writer.write_rows(frame.pixels.data(), frame.height);
+    }, 1, 2);
+
+    for (int y = 0, band = 0; y < height; y += band_height, ++band) {
+        const int rows = std::min(band_height, height - y);
+        FrameSink::Frame frame = sink.new_frame(band, width, rows, channels);
+        frame.bottom_up = false;
+        std::copy(image.begin() + stride * y, image.begin() + stride * (y + rows), frame.pixels.begin());
+        if (!sink.push(std::move(frame)))
+            return false;
+    }
+    if (!sink.finish() || !writer.close())
+        return false;
+
+    std::vector<unsigned char> data;
+    int w = 0, h = 0, c = 0;
+    if (!ImageIO::load(file_name, data, w, h, c, channels, false))
+        return false;
+    file_system::delete_file(file_name);
+    if (w != width || h != height || data != image) {
+        LOG(ERROR) << "image content differs after reading back: " << file_name;
+        return false;
+    }
+    return true;
+}
+
+
+int test_frame_sink() {
+    // streamed images of all supported formats and channels
+    if (!test_image_stream("test_frame_sink.png", 301, 257, 1, 64) ||
+        !test_image_stream("test_frame_sink.png", 301, 257, 2, 64) ||
+        !test_image_stream("test_frame_sink.png", 301, 257, 3, 100) ||
+        !test_image_stream("test_frame_sink.png", 301, 257, 4, 257) ||
+        !test_image_stream("test_frame_sink.png", 301, 257, 3, 64, true) ||  // stored (not compressed) by the encoder
+        !test_image_stream("test_frame_sink.ppm", 301, 257, 3, 64) ||
+        !test_image_stream("test_frame_sink.bmp", 301, 257, 3, 64) ||
+        !test_image_stream("test_frame_sink.bmp", 301, 257, 4, 64) ||
+        !test_image_stream("test_frame_sink.tga", 301, 257, 4, 64))
+        return EXIT_FAILURE;
+
+    // incomplete images must be reported
+    {
+        ImageStreamWriter writer;
+        const std::vector<unsigned char> &rows = create_image(16, 8, 3);
+        if (!writer.open("test_frame_sink.png", 16, 16, 3) || !writer.write_rows(rows.data(), 8) || writer.close()) {
+            LOG(ERROR) << "incomplete image not reported";
+            return EXIT_FAILURE;
+        }
+        file_system::delete_file("test_frame_sink.png");
+    }
+
+    // an image sequence saved by multiple workers
+    const int num_frames = 6;
+    {
+        FrameSink sink(FrameSink::image_sequence("test_frame_sink.png"), 3, 2);
+        for (int i = 0; i < num_frames; ++i) {
+            FrameSink::Frame frame = sink.new_frame(i, 64, 48, 4);
+            frame.pixels = create_image(64, 48, 4);
+            if (!sink.push(std::move(frame)))
+                return EXIT_FAILURE;
+        }
+        if (!sink.finish() || sink.num_consumed() != num_frames)
+            return EXIT_FAILURE;
+    }
+    for (int i = 0; i < num_frames; ++i) {
+        const std::string name = "test_frame_sink-000" + std::to_string(i) + ".png";
+        if (!file_system::is_file(name)) {
+            LOG(ERROR) << "frame not saved: " << name;
+            return EXIT_FAILURE;
+        }
+        file_system::delete_file(name);
+    }
+
+    // a failing consumer stops the pipeline
+    {
+        FrameSink sink([](FrameSink::Frame &frame) -> bool { return frame.index < 2; }, 1, 1);
+        bool stopped = false;
+        for (int i = 0; i < 100 && !stopped; ++i)
+            stopped = !sink.push(sink.new_frame(i, 4, 4, 3));
+        if (!stopped || sink.finish()) {
+            LOG(ERROR) << "failure of the consumer not reported";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/util/memory.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+
+using namespace easy3d;
+
+
+namespace {
+    const memory::Usage *find(const memory::Usage &usage, const std::string &name) {
+        if (usage.name == name)
+            return &usage;
+        for (const auto &child : usage.children) {
+            const memory::Usage *found = find(child, name);
+            if (found)
+                return found;
+        }
+        return nullptr;
+    }
+}
+
+
+int test_memory() {
+    const std::size_t n = 1000;
+    PointCloud cloud;
+    cloud.set_name("cloud");
+    cloud.points().reserve(2 * n);
+    for (std::size_t i = 0; i < n; ++i)
+        cloud.add_vertex(vec3(0.0f, 0.0f, 0.0f));
+    cloud.add_vertex_property<vec3>("v:color");
+    cloud.add_vertex_property<bool>("v:flag");
+
+    // the properties report their sizes, capacities, and bytes
+    const memory::Usage usage = cloud.memory_usage();
+    const memory::Usage *points = find(usage, "v:point");
+    const memory::Usage *flags = find(usage, "v:flag");
+    const memory::Usage *vertices = find(usage, "vertex properties");
+    if (!points || !flags || !vertices) {
+        LOG(ERROR) << "missing properties in the memory report";
+        return EXIT_FAILURE;
+    }
+    if (points->size != n || points->capacity < 2 * n || points->used != n * sizeof(vec3) ||
+        points->allocated != points->capacity * sizeof(vec3)) {
+        LOG(ERROR) << "wrong memory usage of 'v:point': " << points->used << " (allocated " << points->allocated << ")";
+        return EXIT_FAILURE;
+    }
+    if (flags->used != (n + 7) / 8) {
+        LOG(ERROR) << "wrong memory usage of a bool property: " << flags->used;
+        return EXIT_FAILURE;
+    }
+
+    // the bytes of the children are accumulated into their parents
+    std::size_t used = 0, allocated = 0;
+    for (const auto &p : vertices->children) {
+        used += p.used;
+        allocated += p.allocated;
+    }
+    if (vertices->used != used || vertices->allocated != allocated || vertices->size != n) {
+        LOG(ERROR) << "the memory of the vertex properties is not the sum of its properties";
+        return EXIT_FAILURE;
+    }
+    if (usage.used < vertices->used || usage.allocated < vertices->allocated || usage.allocated < usage.used) {
+        LOG(ERROR) << "inconsistent memory usage of the model";
+        return EXIT_FAILURE;
+    }
+
+    // the unused capacity is freed by shrinking
+    cloud.vertex_property<vec3>("v:point").vector().shrink_to_fit();
+    const memory::Usage *shrunk = find(cloud.memory_usage(), "v:point");
+    if (!shrunk || shrunk->allocated != shrunk->used) {
+        LOG(ERROR) << "the capacity of 'v:point' is still reported after shrinking";
+        return EXIT_FAILURE;
+    }
+
+    std::ostringstream stats;
+    cloud.property_stats(stats);
+    if (stats.str().find("v:color") == std::string::npos || stats.str().find("vertex properties") == std::string::npos) {
+        LOG(ERROR) << "the property statistics miss the properties";
+        return EXIT_FAILURE;
+    }
+    const std::string json = usage.to_json();
+    if (json.empty() || json.front() != '{' || json.find("\"name\":\"v:flag\"") == std::string::npos) {
+        LOG(ERROR) << "invalid JSON memory report";
+        return EXIT_FAILURE;
+    }
+    if (memory::to_string(512) != "512 bytes" || memory::to_string(3 * 1024 * 1024) != "3.0 MB") {
+        LOG(ERROR) << "unexpected human-readable sizes: " << memory::to_string(512) << ", "
+                   << memory::to_string(3 * 1024 * 1024);
+        return EXIT_FAILURE;
+    }
+
+    // the process-wide tallies, including the registered ones
+    memory::register_tally("test", []() { return memory::Usage("", 0, 0, 42, 64); });
+    const memory::Usage process = memory::process_usage();
+    const memory::Usage *tally = find(process, "test");
+    if (process.name != "process" || !tally || tally->used != 42) {
+        LOG(ERROR) << "the registered tally is missing in the process report";
+        return EXIT_FAILURE;
+    }
+
+    // the allocation counter (if compiled in) measures the peak of a scope
+    {
+        memory::PeakScope scope;
+        {
+            std::vector<char> buffer(4 * 1024 * 1024, 1);
+            if (buffer[1024] != 1)
+                return EXIT_FAILURE;
+        }
+        if (memory::allocation_counter_enabled()) {
+            if (scope.peak() < 4 * 1024 * 1024 || memory::num_allocations() == 0) {
+                LOG(ERROR) << "the allocation counter missed a 4 MB allocation (peak " << scope.peak() << ")";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (scope.peak() != 0 || memory::allocated_bytes() != 0) {
+            LOG(ERROR) << "the allocation counter is not enabled but reports allocations";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
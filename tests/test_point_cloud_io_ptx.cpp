@@ -0,0 +1,157 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/fileio/point_cloud_io_ptx.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/random.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+using namespace easy3d;
+
+
+namespace {
+
+    // writes a PTX file of scans with the given grid sizes, with colors and a different transformation per scan
+    bool write_scans(const std::string &file_name, const std::vector<std::pair<int, int> > &sizes) {
+        std::ofstream output(file_name.c_str());
+        if (output.fail())
+            return false;
+        output << std::fixed << std::setprecision(6);
+        for (std::size_t s = 0; s < sizes.size(); ++s) {
+            output << sizes[s].first << "\n" << sizes[s].second << "\n";
+            output << "0 0 0\n1 0 0\n0 1 0\n0 0 1\n";
+            const float angle = 0.3f * static_cast<float>(s + 1);
+            output << std::cos(angle) << " " << std::sin(angle) << " 0 0\n";
+            output << -std::sin(angle) << " " << std::cos(angle) << " 0 0\n";
+            output << "0 0 1 0\n";
+            output << 1.5 * s << " " << -2.0 * s << " " << 0.5 * s << " 1\n";
+            const int num = sizes[s].first * sizes[s].second;
+            for (int i = 0; i < num; ++i) {
+                output << random_float() * 10 << " " << random_float() * 10 << " " << random_float() * 10 << " "
+                       << random_float() << " " << rand() % 256 << " " << rand() % 256 << " " << rand() % 256 << "\n";
+            }
+        }
+        return output.good();
+    }
+
+    bool same_points(const PointCloud *a, std::size_t offset_a, const PointCloud *b) {
+        const auto &pa = a->get_vertex_property<vec3>("v:point").vector();
+        const auto &pb = b->get_vertex_property<vec3>("v:point").vector();
+        const auto &ca = a->get_vertex_property<vec3>("v:color").vector();
+        const auto &cb = b->get_vertex_property<vec3>("v:color").vector();
+        for (std::size_t i = 0; i < b->n_vertices(); ++i) {
+            if (distance(pa[offset_a + i], pb[i]) > 1e-4f || distance(ca[offset_a + i], cb[i]) > 1e-6f) {
+                LOG(ERROR) << "point " << i << " differs: " << pa[offset_a + i] << " vs. " << pb[i];
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+
+int test_point_cloud_io_ptx() {
+    // the scans span several blocks of the reader, and the scan boundaries fall inside the blocks
+    const std::vector<std::pair<int, int> > sizes = {{300, 300}, {250, 400}, {123, 77}};
+    const std::string file_name = "./test_scans.ptx";
+    if (!write_scans(file_name, sizes)) {
+        LOG(ERROR) << "failed writing the test file";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<PointCloud *> expected;
+    {
+        io::PointCloudIO_ptx serializer(file_name);
+        while (PointCloud *cloud = serializer.load_next())
+            expected.push_back(cloud);
+    }
+
+    int result = EXIT_SUCCESS;
+    if (expected.size() != sizes.size()) {
+        LOG(ERROR) << "load_next() read " << expected.size() << " scans (expected " << sizes.size() << ")";
+        result = EXIT_FAILURE;
+    }
+
+    // separate clouds
+    if (result == EXIT_SUCCESS) {
+        io::PointCloudIO_ptx serializer(file_name);
+        const std::vector<PointCloud *> clouds = serializer.load_all(false);
+        if (clouds.size() != expected.size()) {
+            LOG(ERROR) << "load_all() read " << clouds.size() << " scans (expected " << expected.size() << ")";
+            result = EXIT_FAILURE;
+        }
+        for (std::size_t i = 0; i < clouds.size() && result == EXIT_SUCCESS; ++i) {
+            if (clouds[i]->n_vertices() != expected[i]->n_vertices() || !same_points(clouds[i], 0, expected[i])) {
+                LOG(ERROR) << "load_all() and load_next() differ for scan #" << i;
+                result = EXIT_FAILURE;
+            }
+        }
+        for (auto cloud : clouds)
+            delete cloud;
+    }
+
+    // a single merged cloud
+    if (result == EXIT_SUCCESS) {
+        io::PointCloudIO_ptx serializer(file_name);
+        const std::vector<PointCloud *> clouds = serializer.load_all(true);
+        std::size_t total = 0;
+        for (auto cloud : expected)
+            total += cloud->n_vertices();
+        if (clouds.size() != 1 || clouds[0]->n_vertices() != total) {
+            LOG(ERROR) << "load_all(true) should read a single cloud with " << total << " points";
+            result = EXIT_FAILURE;
+        }
+        else {
+            const auto scan_id = clouds[0]->get_vertex_property<int>("v:scan_id");
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < expected.size() && result == EXIT_SUCCESS; ++i) {
+                if (!same_points(clouds[0], offset, expected[i]) ||
+                    scan_id.vector()[offset] != static_cast<int>(i) ||
+                    scan_id.vector()[offset + expected[i]->n_vertices() - 1] != static_cast<int>(i)) {
+                    LOG(ERROR) << "the merged cloud differs from load_next() for scan #" << i;
+                    result = EXIT_FAILURE;
+                }
+                offset += expected[i]->n_vertices();
+            }
+        }
+        for (auto cloud : clouds)
+            delete cloud;
+    }
+
+    for (auto cloud : expected)
+        delete cloud;
+    file_system::delete_file(file_name);
+
+    return result;
+}
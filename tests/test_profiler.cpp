@@ -0,0 +1,163 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/util/profiler.h>
+#include <easy3d/util/thread_pool.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+#include <3rd_party/json/json.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <chrono>
+
+
+using namespace easy3d;
+using json = nlohmann::json;
+
+
+static void work(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+
+static void load() {
+    EASY3D_PROFILE_ZONE("load");
+    work(5);
+    EASY3D_PROFILE_ELEMENTS(100);
+    EASY3D_PROFILE_BYTES(4096);
+}
+
+
+int test_profiler() {
+    // nothing is recorded unless recording
+    load();
+    if (Profiler::num_events() != 0) {
+        LOG(ERROR) << "zones recorded while the profiler is not recording";
+        return EXIT_FAILURE;
+    }
+
+    Profiler::start();
+    {
+        EASY3D_PROFILE_ZONE("pipeline");
+        load();
+        load();
+        {
+            // a zone named at run time, with characters to be escaped in the trace
+            Profiler::Zone zone(Profiler::intern("\"step\" \\ " + std::to_string(1)));
+        }
+        {
+            EASY3D_PROFILE_ZONE("process");
+            work(10);
+            parallel_for(0, 8, [](int) {
+                EASY3D_PROFILE_ZONE("task");
+                work(1);
+            }, nullptr, 1);
+        }
+    }
+    Profiler::stop();
+    load(); // not recorded
+
+    if (Profiler::num_events() != 13) {
+        LOG(ERROR) << "expected 13 recorded zones, got " << Profiler::num_events();
+        return EXIT_FAILURE;
+    }
+    if (Profiler::intern("\"step\" \\ 1") != Profiler::intern(std::string("\"step\" \\ ") + "1")) {
+        LOG(ERROR) << "the same name is interned twice";
+        return EXIT_FAILURE;
+    }
+
+    const auto stats = Profiler::statistics();
+    const Profiler::Statistics *pipeline = nullptr, *load_stats = nullptr, *process = nullptr;
+    std::size_t num_tasks = 0;
+    for (const auto &s : stats) {
+        if (s.path == "pipeline") pipeline = &s;
+        else if (s.path == "pipeline/load") load_stats = &s;
+        else if (s.path == "pipeline/process") process = &s;
+        if (s.name == "task") num_tasks += s.count;
+    }
+    if (!pipeline || !load_stats || !process || stats.front().path != "pipeline") {
+        LOG(ERROR) << "unexpected zone hierarchy:\n" << Profiler::report();
+        return EXIT_FAILURE;
+    }
+    if (num_tasks != 8 || load_stats->count != 2 || load_stats->depth != 1) {
+        LOG(ERROR) << "unexpected zone counts:\n" << Profiler::report();
+        return EXIT_FAILURE;
+    }
+    if (load_stats->elements != 200 || load_stats->bytes != 8192 || pipeline->elements != 0) {
+        LOG(ERROR) << "the counters are not attributed to the innermost zones:\n" << Profiler::report();
+        return EXIT_FAILURE;
+    }
+    // the self time of the pipeline excludes the loads and the processing
+    if (load_stats->total < 10.0 || pipeline->total < load_stats->total + process->total ||
+        pipeline->self > pipeline->total - load_stats->total - process->total + 1e-6) {
+        LOG(ERROR) << "inconsistent zone times:\n" << Profiler::report();
+        return EXIT_FAILURE;
+    }
+
+    const std::string trace_file = "./profiler-trace.json";
+    const std::string stats_file = "./profiler-statistics.json";
+    if (!Profiler::save_trace(trace_file) || !Profiler::save_statistics(stats_file)) {
+        LOG(ERROR) << "failed saving the profiling results";
+        return EXIT_FAILURE;
+    }
+    std::ifstream input(trace_file.c_str());
+    const std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (content.compare(0, 15, "{\"traceEvents\":") != 0 || content.find("\"name\":\"pipeline\"") == std::string::npos) {
+        LOG(ERROR) << "unexpected trace file content";
+        return EXIT_FAILURE;
+    }
+    std::size_t num_steps = 0;
+    try {
+        const json trace = json::parse(content);
+        for (const auto &event : trace.at("traceEvents")) {
+            if (event.at("name") == "\"step\" \\ 1" && event.at("ph") == "X")
+                ++num_steps;
+        }
+    }
+    catch (const std::exception &e) {
+        LOG(ERROR) << "invalid trace file: " << e.what();
+        return EXIT_FAILURE;
+    }
+    if (num_steps != 1) {
+        LOG(ERROR) << "the zone named at run time is missing in the trace file";
+        return EXIT_FAILURE;
+    }
+    input.close();
+    file_system::delete_file(trace_file);
+    file_system::delete_file(stats_file);
+
+    Profiler::clear();
+    if (Profiler::num_events() != 0) {
+        LOG(ERROR) << "the recorded zones were not cleared";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/util/progress.h>
+#include <easy3d/util/thread_pool.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+
+using namespace easy3d;
+
+
+// a client recording the notifications and the threads delivering them
+class RecordingClient : public ProgressClient {
+public:
+    void notify(std::size_t percent, bool update_viewer) override {
+        percents.push_back(percent);
+        threads.push_back(std::this_thread::get_id());
+    }
+    std::vector<std::size_t> percents;
+    std::vector<std::thread::id> threads;
+};
+
+
+int test_progress() {
+    ThreadPool::set_concurrency(4);
+    RecordingClient client;
+
+    // concurrent steps are all counted, and the (throttled) notifications come from the owner thread in order
+    const int n = 2000000;
+    {
+        ProgressLogger progress(n, false);
+        parallel_for(0, n, [&](int) { progress.next(); }, &progress);
+        if (progress.value() != static_cast<std::size_t>(n)) {
+            LOG(ERROR) << "progress value " << progress.value() << " != " << n;
+            return EXIT_FAILURE;
+        }
+    }
+    if (client.percents.size() < 2 || client.percents.front() != 0 || client.percents.back() != 100) {
+        LOG(ERROR) << "the progress did not go from 0 to 100";
+        return EXIT_FAILURE;
+    }
+    if (client.percents.size() > 50) {
+        LOG(ERROR) << "the notifications are not throttled (" << client.percents.size() << " notifications)";
+        return EXIT_FAILURE;
+    }
+    for (std::size_t i = 0; i < client.percents.size(); ++i) {
+        if (client.threads[i] != std::this_thread::get_id()) {
+            LOG(ERROR) << "the client was notified from a worker thread";
+            return EXIT_FAILURE;
+        }
+        if (i > 0 && client.percents[i] < client.percents[i - 1]) {
+            LOG(ERROR) << "the progress went backwards";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // without throttling, each percent is reported
+    client.percents.clear();
+    ProgressLogger::set_notification_interval(0);
+    {
+        ProgressLogger progress(101, false);
+        for (int i = 0; i < 101; ++i)
+            progress.next();
+    }
+    ProgressLogger::set_notification_interval(100);
+    if (client.percents.size() < 100) {
+        LOG(ERROR) << "expected a notification per percent, got " << client.percents.size();
+        return EXIT_FAILURE;
+    }
+
+    // sub-ranges advance the parent proportionally to their weights
+    client.percents.clear();
+    {
+        ProgressLogger progress(4, false);  // the values are reported relative to 3 (i.e., max_val - 1)
+        {
+            ProgressLogger stage(&progress, 3, 1000);
+            parallel_for(0, 500, [&](int) { stage.next(); });
+            stage.notify(500);  // forces the report to the parent
+            if (progress.value() != 1) {   // 1.5 steps
+                LOG(ERROR) << "half of the sub-range should advance the parent by 1.5 steps, got " << progress.value();
+                return EXIT_FAILURE;
+            }
+            {
+                ProgressLogger nested(&stage, 500, 10);
+                nested.done();
+            }
+            if (stage.value() != 1000) {
+                LOG(ERROR) << "the nested sub-range did not complete the stage";
+                return EXIT_FAILURE;
+            }
+        }
+        if (progress.value() != 3) {
+            LOG(ERROR) << "the finished sub-range should advance the parent by 3 steps, got " << progress.value();
+            return EXIT_FAILURE;
+        }
+        if (std::find(client.percents.begin(), client.percents.end(), 50) == client.percents.end()) {
+            LOG(ERROR) << "the client was not notified of the half progress";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the cancellation is visible from all threads
+    {
+        ProgressLogger progress(n, false);
+        client.cancel();
+        std::atomic<int> seen(0);
+        parallel_for(0, 64, [&](int) { if (progress.is_canceled()) ++seen; }, nullptr, 1);
+        if (seen != 64) {
+            LOG(ERROR) << "the cancellation was not visible from all threads";
+            return EXIT_FAILURE;
+        }
+    }
+
+    ThreadPool::set_concurrency(0);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/gui/selection_engine.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/renderer/transform.h>
+#include <easy3d/core/random.h>
+#include <easy3d/util/stop_watch.h>
+#include <easy3d/util/logging.h>
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace easy3d;
+
+
+// the reference: each point is projected and tested against the region individually
+static std::vector<unsigned char> brute_force(const std::vector<vec3> &points, const mat4 &mvp, int width, int height,
+                                              const Polygon2 *lasso, const Rect *rect) {
+    std::vector<unsigned char> inside(points.size(), 0);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const vec4 q = mvp * vec4(points[i], 1.0f);
+        if (q.w <= 0.0f)
+            continue;
+        const float x = (q.x / q.w + 1.0f) * 0.5f * (width - 1);
+        const float y = (1.0f - q.y / q.w) * 0.5f * (height - 1);
+        if (rect)
+            inside[i] = (x >= rect->left() && x <= rect->right() && y >= rect->top() && y <= rect->bottom());
+        else {  // the center of the pixel the point falls in
+            const vec2 pixel(std::floor(x + 0.5f), std::floor(y + 0.5f));
+            inside[i] = geom::point_in_polygon(pixel, *lasso);
+        }
+    }
+    return inside;
+}
+
+
+static bool check(const std::vector<unsigned char> &result, const std::vector<unsigned char> &expected,
+                  std::size_t count, const std::string &name) {
+    std::size_t expected_count = 0, mismatches = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        expected_count += expected[i];
+        mismatches += (result[i] != expected[i]);
+    }
+    // points exactly on the boundary may go either way due to rounding
+    if (result.size() != expected.size() || mismatches > expected.size() / 100000 || count == 0 ||
+        count == expected.size() || std::abs(double(count) - double(expected_count)) > double(mismatches)) {
+        LOG(ERROR) << name << ": " << count << " points selected (expected " << expected_count << "), "
+                   << mismatches << " mismatches";
+        return false;
+    }
+    return true;
+}
+
+
+int test_selection_engine() {
+    // a cube of 2M points, seen from a perspective camera located inside the cloud's bounding sphere (so some
+    // cells are partially behind the camera)
+    std::vector<vec3> points(2000000);
+    for (auto &p : points)
+        p = vec3(random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f));
+    const int width = 800, height = 600;
+    const mat4 view = transform::look_at(vec3(0.3f, 0.5f, 1.6f), vec3(0, 0, 0), vec3(0, 1, 0));
+    const mat4 mvp = transform::perspective(static_cast<float>(M_PI) / 3.0f, float(width), float(height), 0.01f, 10.0f) * view;
+
+    SelectionEngine engine;
+    std::vector<unsigned char> inside;
+
+    // a star-shaped (non-convex) lasso
+    Polygon2 lasso;
+    for (int i = 0; i < 20; ++i) {
+        const float angle = static_cast<float>(2.0 * M_PI * i / 20);
+        const float radius = (i % 2) ? 120.0f : 250.0f;
+        lasso.push_back(vec2(410.3f + radius * std::cos(angle), 295.7f + radius * std::sin(angle)));
+    }
+    StopWatch w;
+    std::size_t count = engine.select(points, 0, mvp, width, height, lasso, inside);
+    std::size_t accepted, rejected, tested;
+    engine.last_statistics(accepted, rejected, tested);
+    LOG(INFO) << "lasso selection of " << points.size() << " points (including building " << engine.num_cells()
+              << " cells) took " << w.time_string() << ": " << accepted << " cells accepted, " << rejected
+              << " rejected, " << tested << " tested";
+    if (!check(inside, brute_force(points, mvp, width, height, &lasso, nullptr), count, "lasso"))
+        return EXIT_FAILURE;
+    if (accepted == 0 || rejected == 0 || tested == 0) {
+        LOG(ERROR) << "no cells were accepted or rejected as a whole";
+        return EXIT_FAILURE;
+    }
+
+    const Rect rect(150.2f, 520.6f, 100.4f, 380.9f);
+    w.restart();
+    count = engine.select(points, 0, mvp, width, height, rect, inside);
+    LOG(INFO) << "rectangle selection took " << w.time_string();
+    if (!check(inside, brute_force(points, mvp, width, height, nullptr, &rect), count, "rectangle"))
+        return EXIT_FAILURE;
+
+    // the cells are rebuilt for other points
+    std::vector<vec3> others(points.begin(), points.begin() + 1000);
+    count = engine.select(others, 0, mvp, width, height, rect, inside);
+    if (!engine.is_built_for(others, 0) || !check(inside, brute_force(others, mvp, width, height, nullptr, &rect), count, "rebuilt"))
+        return EXIT_FAILURE;
+
+    // the cells are rebuilt if the points are modified in place (i.e., a new revision of the same array)
+    PointCloud cloud;
+    for (const auto &p : others)
+        cloud.add_vertex(p);
+    auto &cloud_points = cloud.points();
+    const std::size_t revision = cloud.geometry_revision();
+    engine.select(cloud_points, revision, mvp, width, height, rect, inside);
+    for (auto &p : cloud_points)
+        p = -p;
+    cloud.mark_modified("v:point");
+    if (cloud.geometry_revision() == revision || engine.is_built_for(cloud_points, cloud.geometry_revision())) {
+        LOG(ERROR) << "the geometry revision did not change after modifying the points";
+        return EXIT_FAILURE;
+    }
+    count = engine.select(cloud_points, cloud.geometry_revision(), mvp, width, height, rect, inside);
+    if (!check(inside, brute_force(cloud_points, mvp, width, height, nullptr, &rect), count, "modified in place"))
+        return EXIT_FAILURE;
+
+    // the engines of the models are kept aside, so nothing is added to the models
+    SelectionEngineCache cache(2);
+    PointCloud other_cloud, third_cloud;
+    SelectionEngine *cloud_engine = &cache.engine(&cloud);
+    cloud_engine->select(cloud_points, cloud.geometry_revision(), mvp, width, height, rect, inside);
+    if (&cache.engine(&other_cloud) == cloud_engine || &cache.engine(&cloud) != cloud_engine ||
+        !cloud_engine->is_built_for(cloud_points, cloud.geometry_revision()) || !cloud.model_properties().empty()) {
+        LOG(ERROR) << "the selection engine of a model is not kept (or it is kept with the model)";
+        return EXIT_FAILURE;
+    }
+    cache.engine(&third_cloud);     // drops the least recently used one (of other_cloud)
+    cache.remove(&cloud);
+    if (cache.size() != 1 || cache.engine(&third_cloud).num_cells() != 0) {
+        LOG(ERROR) << "wrong number of selection engines kept: " << cache.size();
+        return EXIT_FAILURE;
+    }
+
+    // a lasso outside the screen selects nothing
+    Polygon2 outside;
+    outside.push_back(vec2(-100, -100));
+    outside.push_back(vec2(-10, -100));
+    outside.push_back(vec2(-10, -10));
+    if (engine.select(others, 0, mvp, width, height, outside, inside) != 0 || inside.size() != others.size()) {
+        LOG(ERROR) << "wrong selection with a lasso outside the screen";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -27,6 +27,10 @@
 
 #include <easy3d/core/signal.h>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
 
 
 using namespace easy3d;
@@ -246,6 +250,144 @@ void test_signal_for_connect_signal_to_signal() {
 }
 
 
+bool test_signal_for_connection_handles() {
+    Signal<int> signal;
+    int sum = 0;
+
+    {
+        ScopedConnection connection = signal.connect([&sum](int v) { sum += v; });
+        signal.send(1);
+        if (!connection.connected()) {
+            std::cerr << "a scoped connection should be connected while in scope" << std::endl;
+            return false;
+        }
+    }
+    signal.send(10);    // the slot has been disconnected by the scoped connection
+    if (sum != 1 || !signal.empty()) {
+        std::cerr << "a scoped connection should disconnect when going out of scope" << std::endl;
+        return false;
+    }
+
+    Connection connection = signal.connect([&sum](int v) { sum += v; });
+    const int id = connection;  // the handle converts to the id
+    signal.emit_for(id, 100);
+    connection.disconnect();
+    signal.send(1000);
+    if (sum != 101 || connection.connected()) {
+        std::cerr << "a disconnected slot should not be called" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool test_signal_for_queued_connections() {
+    Signal<const std::string &, int> signal;
+    std::vector<std::function<void()> > queue;  // a trivial event loop
+    auto dispatcher = [&queue](std::function<void()> call) { queue.push_back(call); };
+
+    std::string received;
+    signal.connect([&received](const std::string &msg, int n) { received = msg + std::to_string(n); }, dispatcher);
+    auto connection = signal.connect([&received](const std::string &, int) { received = "should not happen"; },
+                                     dispatcher);
+
+    {
+        std::string msg = "queued";
+        signal.send(msg, 1);
+        msg = "modified";   // the queued call has its own copy of the arguments
+    }
+    connection.disconnect();    // the queued call of a disconnected slot is not executed
+    if (!received.empty() || queue.size() != 2) {
+        std::cerr << "a queued slot should be called only by the event loop" << std::endl;
+        return false;
+    }
+
+    for (const auto &call : queue)
+        call();
+    if (received != "queued1") {
+        std::cerr << "unexpected result of the queued calls: " << received << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool test_signal_for_threads() {
+    Signal<int> signal;
+    std::atomic<long> sum(0);
+    signal.connect([&sum](int v) { sum += v; });
+
+    const int num_threads = 4;
+    const int num_sends = 20000;
+    std::atomic<bool> stop(false);
+
+    // connect and disconnect slots while the other threads are sending
+    std::thread modifier([&signal, &stop]() {
+        while (!stop) {
+            Connection c = signal.connect([](int) {});
+            ScopedConnection scoped = signal.connect([](int) {});
+            signal.disconnect(c);
+        }
+    });
+
+    std::vector<std::thread> senders;
+    for (int i = 0; i < num_threads; ++i) {
+        senders.emplace_back([&signal]() {
+            for (int j = 0; j < num_sends; ++j)
+                signal.send(1);
+        });
+    }
+    for (auto &t : senders)
+        t.join();
+    stop = true;
+    modifier.join();
+
+    if (sum != static_cast<long>(num_threads) * num_sends) {
+        std::cerr << "concurrent sends lost calls: " << sum << " vs. " << num_threads * num_sends << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool test_signal_for_disconnecting_running_slots() {
+    Signal<> signal;
+    std::atomic<bool> entered(false), finished(false);
+    Connection connection = signal.connect([&entered, &finished]() {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+
+    std::thread sender([&signal]() { signal.send(); });
+    while (!entered)
+        std::this_thread::yield();
+    connection.disconnect();    // waits for the call running in the sender
+    const bool finished_on_return = finished;
+    sender.join();
+    if (!finished_on_return) {
+        std::cerr << "disconnect() returned while the slot was still running" << std::endl;
+        return false;
+    }
+
+    // a slot can disconnect itself (and its signal) without waiting for itself
+    int calls = 0;
+    Connection self;
+    self = signal.connect([&self, &calls, &signal]() {
+        ++calls;
+        self.disconnect();
+        signal.disconnect_all();
+    });
+    signal.send();
+    signal.send();
+    if (calls != 1 || !signal.empty()) {
+        std::cerr << "a slot failed disconnecting itself" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
 int test_signal() {
     MyCar car(100);
 
@@ -261,5 +403,21 @@ int test_signal() {
     std::cout << "connect a signal to another signal -----------------------------------------------------\n";
     test_signal_for_connect_signal_to_signal();
 
+    std::cout << "connection handles ---------------------------------------------------------------------\n";
+    if (!test_signal_for_connection_handles())
+        return EXIT_FAILURE;
+
+    std::cout << "queued connections ---------------------------------------------------------------------\n";
+    if (!test_signal_for_queued_connections())
+        return EXIT_FAILURE;
+
+    std::cout << "send from multiple threads -------------------------------------------------------------\n";
+    if (!test_signal_for_threads())
+        return EXIT_FAILURE;
+
+    std::cout << "disconnect running slots ---------------------------------------------------------------\n";
+    if (!test_signal_for_disconnecting_running_slots())
+        return EXIT_FAILURE;
+
     return EXIT_SUCCESS;
 }
\ No newline at end of file
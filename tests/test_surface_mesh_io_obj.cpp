@@ -0,0 +1,173 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/fileio/surface_mesh_io.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace easy3d;
+
+
+namespace {
+
+    // the texture coordinates of a corner are derived from the position of its vertex
+    vec2 texcoord(const vec3 &p) {
+        return vec2(p.x + 0.5f * p.y, p.z);
+    }
+
+    // writes a unit cube whose faces don't share vertices (i.e., each face has its own copies of the positions and
+    // texture coordinates). The faces alternate between two materials.
+    bool write_cube(const std::string &file_name, const std::string &mtl_name) {
+        std::ofstream mtl(mtl_name.c_str());
+        mtl << "newmtl red\nKd 1 0 0\n\nnewmtl blue\nKd 0 0 1\n";
+        if (mtl.fail())
+            return false;
+
+        const int faces[6][4] = {{0, 3, 2, 1}, {4, 5, 6, 7}, {0, 1, 5, 4}, {2, 3, 7, 6}, {1, 2, 6, 5}, {0, 4, 7, 3}};
+        std::ofstream output(file_name.c_str());
+        output << "mtllib " << file_system::simple_name(mtl_name) << "\n";
+        for (int f = 0; f < 6; ++f) {
+            output << "usemtl " << (f % 2 == 0 ? "red" : "blue") << "\n";
+            for (int k = 0; k < 4; ++k) {
+                const int v = faces[f][k];
+                const vec3 p(float(v & 1), float((v >> 1) & 1), float((v >> 2) & 1));
+                const vec2 t = texcoord(p);
+                output << "v " << p.x << " " << p.y << " " << p.z << "\n";
+                output << "vt " << t.x << " " << t.y << "\n";
+            }
+            const int b = f * 4 + 1;
+            output << "f " << b << "/" << b << " " << b + 1 << "/" << b + 1 << " " << b + 2 << "/" << b + 2 << " "
+                   << b + 3 << "/" << b + 3 << "\n";
+        }
+        return output.good();
+    }
+
+
+    bool check_cube(SurfaceMesh *mesh) {
+        if (mesh->n_vertices() != 8 || mesh->n_edges() != 12 || mesh->n_faces() != 6) {
+            LOG(ERROR) << "the duplicated vertices of the cube were not merged (#vertices: " << mesh->n_vertices()
+                       << ", #edges: " << mesh->n_edges() << ", #faces: " << mesh->n_faces() << ")";
+            return false;
+        }
+        if (!mesh->is_closed()) {
+            LOG(ERROR) << "the cube is not closed";
+            return false;
+        }
+        for (auto v : mesh->vertices()) {
+            if (!mesh->is_manifold(v) || mesh->valence(v) != 3) {
+                LOG(ERROR) << "wrong connectivity of vertex " << v;
+                return false;
+            }
+        }
+
+        auto texcoords = mesh->get_halfedge_property<vec2>("h:texcoord");
+        if (!texcoords) {
+            LOG(ERROR) << "the cube has no texture coordinates";
+            return false;
+        }
+        for (auto f : mesh->faces()) {
+            for (auto h : mesh->halfedges(f)) {
+                if (distance(texcoords[h], texcoord(mesh->position(mesh->target(h)))) > 1e-6f) {
+                    LOG(ERROR) << "wrong texture coordinates of halfedge " << h << ": " << texcoords[h];
+                    return false;
+                }
+            }
+        }
+
+        // the faces are grouped by material: red (the faces 0, 2, 4 in the file) and then blue
+        auto ranges = mesh->get_model_property<std::vector<std::pair<int, int> > >("material_ranges");
+        auto colors = mesh->get_face_property<vec3>("f:color");
+        if (!ranges || !colors || ranges[0].size() != 2 ||
+            ranges[0][0] != std::make_pair(0, 3) || ranges[0][1] != std::make_pair(3, 3)) {
+            LOG(ERROR) << "wrong material ranges";
+            return false;
+        }
+        for (auto f : mesh->faces()) {
+            if (colors[f] != (f.idx() < 3 ? vec3(1, 0, 0) : vec3(0, 0, 1))) {
+                LOG(ERROR) << "wrong color of face " << f << ": " << colors[f];
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    // three triangles sharing an edge (non-manifold), a degenerate face, and a face with a duplicated vertex
+    bool write_non_manifold(const std::string &file_name) {
+        std::ofstream output(file_name.c_str());
+        output << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 -1 0\nv 0 0 1\nv 1 1 1\n";
+        output << "f 1 2 3\nf 2 1 4\nf 1 2 5\nf 1 1 2\nf 2 6 3 6\n";
+        return output.good();
+    }
+
+}
+
+
+int test_surface_mesh_io_obj() {
+    const std::string file_name = "./test_cube.obj";
+    const std::string mtl_name = "./test_cube.mtl";
+    if (!write_cube(file_name, mtl_name)) {
+        LOG(ERROR) << "failed writing the test file";
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    SurfaceMesh mesh;
+    if (!io::load_obj(file_name, &mesh) || !check_cube(&mesh))
+        result = EXIT_FAILURE;
+
+    // the non-manifold edge is resolved by adding the faces one by one
+    if (result == EXIT_SUCCESS) {
+        if (!write_non_manifold(file_name)) {
+            LOG(ERROR) << "failed writing the test file";
+            result = EXIT_FAILURE;
+        }
+        else if (!io::load_obj(file_name, &mesh) || mesh.n_faces() != 4) {
+            LOG(ERROR) << "the non-manifold mesh should have 4 faces (" << mesh.n_faces() << " loaded)";
+            result = EXIT_FAILURE;
+        }
+        else {
+            // the duplicated vertex is removed, keeping the order of the other vertices
+            const SurfaceMesh::Face f(3);
+            std::vector<SurfaceMesh::Vertex> vertices;
+            for (auto v : mesh.vertices(f))
+                vertices.push_back(v);
+            if (vertices.size() != 3 || mesh.position(vertices[0]) != vec3(1, 0, 0) ||
+                mesh.position(vertices[1]) != vec3(1, 1, 1) || mesh.position(vertices[2]) != vec3(0, 1, 0)) {
+                LOG(ERROR) << "wrong vertices of the face with a duplicated vertex";
+                result = EXIT_FAILURE;
+            }
+        }
+    }
+
+    file_system::delete_file(file_name);
+    file_system::delete_file(mtl_name);
+    return result;
+}
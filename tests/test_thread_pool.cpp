@@ -0,0 +1,205 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/util/thread_pool.h>
+#include <easy3d/util/progress.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+
+using namespace easy3d;
+
+
+// a client that cancels the progress as soon as it is notified (only if armed)
+class CancelingClient : public ProgressClient {
+public:
+    CancelingClient() : armed(false) {}
+    void notify(std::size_t percent, bool update_viewer) override {
+        if (armed && percent > 0)
+            cancel();
+    }
+    bool armed;
+};
+
+
+static bool test_algorithms() {
+    // parallel_for: each index is visited exactly once
+    const int n = 1000003;
+    std::vector<int> visits(n, 0);
+    if (!parallel_for(0, n, [&](int i) { ++visits[i]; }) ||
+        std::count(visits.begin(), visits.end(), 1) != n) {
+        LOG(ERROR) << "parallel_for did not visit each index exactly once";
+        return false;
+    }
+
+    // parallel_reduce: the sum of 0..n-1
+    const long long sum = parallel_reduce(0, n, 0LL,
+            [](int b, int e, long long init) {
+                for (int i = b; i < e; ++i)
+                    init += i;
+                return init;
+            },
+            [](long long a, long long b) { return a + b; });
+    if (sum != static_cast<long long>(n) * (n - 1) / 2) {
+        LOG(ERROR) << "wrong result of parallel_reduce: " << sum;
+        return false;
+    }
+
+    // parallel_sort
+    std::vector<unsigned int> values(n);
+    unsigned int seed = 42;
+    for (auto &v : values)
+        v = (seed = seed * 1664525u + 1013904223u);
+    std::vector<unsigned int> expected = values;
+    std::sort(expected.begin(), expected.end());
+    parallel_sort(values.begin(), values.end());
+    if (values != expected) {
+        LOG(ERROR) << "wrong result of parallel_sort";
+        return false;
+    }
+
+    // nested loops (the waiting threads execute the inner tasks, so there must be no deadlock)
+    std::vector<long long> rows(64, 0);
+    parallel_for(0, 64, [&](int r) {
+        rows[r] = parallel_reduce(0, 10000, 0LL,
+                [r](int b, int e, long long init) { return init + static_cast<long long>(e - b) * r; },
+                [](long long a, long long b) { return a + b; }, nullptr, 100);
+    }, nullptr, 1);
+    for (int r = 0; r < 64; ++r) {
+        if (rows[r] != 10000LL * r) {
+            LOG(ERROR) << "wrong result of nested loops";
+            return false;
+        }
+    }
+
+    // task groups: the first exception is rethrown by wait()
+    TaskGroup group;
+    std::atomic<int> count(0);
+    for (int i = 0; i < 100; ++i)
+        group.run([&count]() { ++count; });
+    group.run([]() { throw std::runtime_error("expected"); });
+    bool thrown = false;
+    try {
+        group.wait();
+    }
+    catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    if (!thrown || count > 100) {
+        LOG(ERROR) << "the exception of a task was not rethrown";
+        return false;
+    }
+
+    return true;
+}
+
+
+int test_thread_pool() {
+    const std::size_t default_concurrency = ThreadPool::concurrency();
+
+    // the same results with any concurrency, including sequential execution
+    for (std::size_t concurrency : {std::size_t(1), std::size_t(2), std::size_t(5), default_concurrency}) {
+        ThreadPool::set_concurrency(concurrency);
+        if (ThreadPool::concurrency() != concurrency || ThreadPool::instance()->num_workers() != concurrency - 1) {
+            LOG(ERROR) << "the concurrency was not changed to " << concurrency;
+            return EXIT_FAILURE;
+        }
+        if (!test_algorithms()) {
+            LOG(ERROR) << "failed with concurrency " << concurrency;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // a loop tied to a canceled progress stops early
+    CancelingClient client;
+    client.armed = true;
+    ProgressLogger progress(100, false);
+    progress.notify(50);
+    client.armed = false;
+    std::atomic<int> count(0);
+    const bool finished = parallel_for(0, 1000000, [&](int) { ++count; }, &progress);
+    if (finished || count == 1000000) {
+        LOG(ERROR) << "the canceled loop was not stopped";
+        return EXIT_FAILURE;
+    }
+
+    // changing the concurrency while a loop is running on another thread: the loop finishes on its pool
+    ThreadPool::set_concurrency(4);
+    std::atomic<long long> total(0);
+    std::thread loop([&total]() {
+        parallel_for(0, 2000, [&total](int i) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            total += i;
+        }, nullptr, 1);
+    });
+    for (std::size_t concurrency : {std::size_t(2), std::size_t(3), std::size_t(1), std::size_t(4)}) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ThreadPool::set_concurrency(concurrency);
+    }
+    loop.join();
+    if (total != 2000LL * 1999 / 2) {
+        LOG(ERROR) << "a loop running while the concurrency changed gave a wrong result";
+        return EXIT_FAILURE;
+    }
+
+    // the last reference to a replaced pool is released by a task running on one of its workers
+    ThreadPool::set_concurrency(4);
+    std::atomic<int> stage(0);
+    std::atomic<int> worker(-1);
+    {
+        std::shared_ptr<ThreadPool> pool = ThreadPool::instance();
+        pool->submit([pool, &stage, &worker]() mutable {
+            while (stage == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            worker = ThreadPool::current_worker();
+            pool.reset();   // destroys the pool on this worker
+            stage = 2;
+        });
+    }
+    ThreadPool::set_concurrency(2);     // the shared instance no longer refers to the pool
+    stage = 1;
+    for (int i = 0; i < 10000 && stage != 2; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (stage != 2 || worker < 0) {
+        LOG(ERROR) << "the task releasing the last reference to its pool did not finish on a worker";
+        return EXIT_FAILURE;
+    }
+    // the new pool works
+    std::atomic<long long> sum(0);
+    parallel_for(0, 1000, [&sum](int i) { sum += i; });
+    if (sum != 1000LL * 999 / 2) {
+        LOG(ERROR) << "wrong result after a pool was destroyed by its worker";
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool::set_concurrency(0);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+#include <easy3d/util/timer.h>
+#include <easy3d/util/logging.h>
+
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+using namespace easy3d;
+
+
+namespace {
+    void sleep_ms(int ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+
+int test_timer_service() {
+    TimerService *service = TimerService::instance();
+
+    // single-shot tasks are executed once, in the order of their deadlines
+    {
+        std::mutex mutex;
+        std::vector<int> order;
+        auto record = [&](int id) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+        };
+        service->schedule(60, [&]() { record(3); });
+        service->schedule(20, [&]() { record(1); });
+        auto handle = service->schedule(40, [&]() { record(2); });
+        if (!handle.is_active()) {
+            LOG(ERROR) << "a pending task is not active";
+            return EXIT_FAILURE;
+        }
+        sleep_ms(200);
+        if (order != std::vector<int>({1, 2, 3})) {
+            LOG(ERROR) << "the tasks were not executed in the order of their deadlines";
+            return EXIT_FAILURE;
+        }
+        if (handle.is_active()) {
+            LOG(ERROR) << "an executed single-shot task is still active";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // a canceled task is never executed
+    {
+        std::atomic<int> count(0);
+        auto handle = service->schedule(30, [&]() { ++count; });
+        handle.cancel();
+        sleep_ms(100);
+        if (count != 0 || handle.is_active()) {
+            LOG(ERROR) << "a canceled task was executed";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // repeated tasks run until canceled
+    {
+        std::atomic<int> count(0);
+        auto handle = service->schedule_interval(10, [&]() { ++count; });
+        sleep_ms(200);
+        handle.cancel();
+        sleep_ms(20);   // an invocation may have been in progress
+        const int stopped = count;
+        sleep_ms(100);
+        if (stopped < 5 || count != stopped) {
+            LOG(ERROR) << "unexpected number of invocations of a repeated task (" << stopped << ", " << count << ")";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the missed ticks of a slow repeated task are coalesced instead of fired back-to-back
+    {
+        std::atomic<int> count(0);
+        auto handle = service->schedule_interval(5, [&]() {
+            ++count;
+            sleep_ms(50);
+        });
+        sleep_ms(280);
+        handle.cancel();
+        sleep_ms(60);
+        if (count > 8) {
+            LOG(ERROR) << "the ticks of a slow repeated task were not coalesced (" << count << " invocations)";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Timer::stop() cancels all the tasks started by the timer
+    {
+        std::atomic<int> count(0);
+        Timer<int> timer;
+        timer.set_interval(10, [&](int step) { count += step; }, 1);
+        timer.set_timeout(100, [&](int step) { count += step; }, 1000);
+        sleep_ms(55);
+        timer.stop();
+        sleep_ms(20);
+        const int stopped = count;
+        sleep_ms(150);
+        if (!timer.is_stopped() || stopped == 0 || stopped >= 1000 || count != stopped) {
+            LOG(ERROR) << "Timer::stop() did not cancel the pending tasks";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // with a dispatcher, the tasks are posted to and executed by the thread processing the posted tasks
+    {
+        service->set_dispatcher([service](TimerService::Task task) { service->post(std::move(task)); });
+
+        std::atomic<int> count(0);
+        std::thread::id thread;
+        service->schedule(10, [&]() {
+            ++count;
+            thread = std::this_thread::get_id();
+        });
+        auto handle = service->schedule_interval(5, [&]() { ++count; });
+        sleep_ms(100);
+        const int before = count;
+        // the repeated task has at most one invocation waiting, however many ticks have passed
+        const std::size_t num = service->process_posted();
+        handle.cancel();
+        service->set_dispatcher(nullptr);
+        service->process_posted();
+
+        if (before != 0 || num != 2 || count != 2 || thread != std::this_thread::get_id()) {
+            LOG(ERROR) << "the dispatched tasks were not executed by the processing thread";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
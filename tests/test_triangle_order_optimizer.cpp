@@ -0,0 +1,136 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+
+
+#include <easy3d/algo/triangle_order_optimizer.h>
+#include <easy3d/util/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <cstdlib>
+
+using namespace easy3d;
+
+
+// a regular grid of quads (each made of two triangles), with the quads in random order
+void create_grid(int res, std::vector<vec3> &points, std::vector<unsigned int> &indices, std::vector<unsigned int> &groups) {
+    points.clear();
+    for (int j = 0; j <= res; ++j) {
+        for (int i = 0; i <= res; ++i)
+            points.emplace_back(static_cast<float>(i), static_cast<float>(j), 0.0f);
+    }
+
+    std::vector<int> quads(res * res);
+    for (std::size_t i = 0; i < quads.size(); ++i)
+        quads[i] = static_cast<int>(i);
+    std::mt19937 rng(42);
+    std::shuffle(quads.begin(), quads.end(), rng);
+
+    indices.clear();
+    groups.clear();
+    for (auto q : quads) {
+        const unsigned int i = q % res, j = q / res;
+        const unsigned int a = j * (res + 1) + i, b = a + 1, c = a + res + 2, d = a + res + 1;
+        groups.push_back(static_cast<unsigned int>(indices.size() / 3));
+        indices.insert(indices.end(), {a, b, c, a, c, d});
+    }
+    groups.push_back(static_cast<unsigned int>(indices.size() / 3));
+}
+
+
+// the triangles (with their vertices in the original rotation), sorted
+std::vector< std::array<unsigned int, 3> > sorted_triangles(const std::vector<unsigned int> &indices) {
+    std::vector< std::array<unsigned int, 3> > triangles;
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+        triangles.push_back({{indices[i], indices[i + 1], indices[i + 2]}});
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+
+int test_triangle_order_optimizer() {
+    // a single triangle: all vertices are transformed once
+    auto stats = TriangleOrderOptimizer::analyze({0, 1, 2}, 3);
+    if (stats.acmr != 3.0f || stats.atvr != 1.0f) {
+        LOG(ERROR) << "wrong statistics of a single triangle: ACMR " << stats.acmr << ", ATVR " << stats.atvr;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<vec3> points;
+    std::vector<unsigned int> indices, groups;
+    create_grid(64, points, indices, groups);
+    const std::vector<unsigned int> original_indices = indices, original_groups = groups;
+    const auto before = TriangleOrderOptimizer::analyze(indices, points.size());
+
+    // vertex cache only, with each triangle as a group
+    std::vector<unsigned int> triangle_indices = indices, no_groups;
+    const auto order = TriangleOrderOptimizer::optimize_vertex_cache(triangle_indices, points.size(), no_groups);
+    TriangleOrderOptimizer::apply(order, triangle_indices, no_groups);
+    const auto cache_only = TriangleOrderOptimizer::analyze(triangle_indices, points.size());
+    if (!no_groups.empty() || sorted_triangles(triangle_indices) != sorted_triangles(original_indices)) {
+        LOG(ERROR) << "the triangles changed after reordering";
+        return EXIT_FAILURE;
+    }
+
+    // vertex cache and overdraw, with the two triangles of each quad as a group
+    const auto full_order = TriangleOrderOptimizer::optimize(indices, points, groups);
+    TriangleOrderOptimizer::apply(full_order, indices, groups);
+    const auto after = TriangleOrderOptimizer::analyze(indices, points.size());
+    if (sorted_triangles(indices) != sorted_triangles(original_indices)) {
+        LOG(ERROR) << "the triangles changed after reordering";
+        return EXIT_FAILURE;
+    }
+
+    // each group is kept together and in its original order
+    if (groups.size() != original_groups.size() || groups.back() != original_groups.back()) {
+        LOG(ERROR) << "wrong number of groups after reordering";
+        return EXIT_FAILURE;
+    }
+    for (std::size_t g = 0; g < full_order.size(); ++g) {
+        const unsigned int old_start = original_groups[full_order[g]], new_start = groups[g];
+        if (groups[g + 1] - new_start != original_groups[full_order[g] + 1] - old_start ||
+            !std::equal(indices.begin() + new_start * 3, indices.begin() + groups[g + 1] * 3,
+                        original_indices.begin() + old_start * 3)) {
+            LOG(ERROR) << "group " << full_order[g] << " not preserved";
+            return EXIT_FAILURE;
+        }
+    }
+
+    LOG(INFO) << "ACMR/ATVR of a shuffled grid: " << before.acmr << "/" << before.atvr
+              << ", vertex cache optimized: " << cache_only.acmr << "/" << cache_only.atvr
+              << ", vertex cache and overdraw optimized: " << after.acmr << "/" << after.atvr;
+
+    // a regular grid reaches an ACMR of about 0.7 with a cache of 16 entries
+    if (cache_only.acmr > 0.85f || after.acmr > 0.95f || after.acmr >= before.acmr || after.atvr < 1.0f) {
+        LOG(ERROR) << "the vertex cache efficiency has not been improved as expected";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
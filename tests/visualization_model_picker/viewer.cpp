@@ -49,6 +49,7 @@ ModelPickerViewer::ModelPickerViewer(const std::string &title)
 
 bool ModelPickerViewer::mouse_press_event(int x, int y, int button, int modifiers) {
     ModelPicker picker(camera());
+    picker.set_batcher(batcher());
     auto model = picker.pick(models(), x, y);
     if (model)
         mark(model);
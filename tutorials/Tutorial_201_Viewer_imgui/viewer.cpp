@@ -29,10 +29,13 @@
 #include <iostream>
 
 #include <easy3d/util/file_system.h>
+#include <easy3d/util/dialogs.h>
+#include <easy3d/util/logging.h>
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/renderer/text_renderer.h>
 #include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/frame_profiler.h>
 
 #include <3rd_party/imgui/misc/fonts/imgui_fonts_droid_sans.h>
 #include <3rd_party/imgui/imgui.h>
@@ -245,11 +248,71 @@ namespace easy3d {
     }
 
 
+    void ViewerImGui::draw_profiler(bool* visible) {
+        FrameProfiler* profiler = this->profiler();
+        ImGui::SetNextWindowPos(ImVec2(width() * 0.5f, height() * 0.5f), ImGuiCond_FirstUseEver, ImVec2(0.5f, 0.5f));
+        ImGui::SetNextWindowSize(ImVec2(520, 300), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(alpha_);
+        if (ImGui::Begin("Profiler", visible)) {
+            bool gpu = profiler->gpu_timing();
+            if (ImGui::Checkbox("GPU", &gpu))
+                profiler->set_gpu_timing(gpu);
+            ImGui::SameLine();
+            bool drawables = profiler->drawable_timing();
+            if (ImGui::Checkbox("Drawables", &drawables))
+                profiler->set_drawable_timing(drawables);
+            ImGui::SameLine();
+            if (ImGui::Button("Reset"))
+                profiler->clear();
+            ImGui::SameLine();
+            if (ImGui::Button("Save Trace")) {
+                const std::vector<std::string> filters = {"Chrome Trace (*.json)", "*.json"};
+                const std::string file_name = dialog::save("Save the trace", "frame_trace.json", filters, true);
+                if (!file_name.empty() && profiler->save_chrome_trace(file_name))
+                    LOG(INFO) << "trace saved to: " << file_name;
+            }
+
+            const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY;
+            if (ImGui::BeginTable("statistics", 6, flags)) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+                const char* columns[] = {"Calls", "CPU mean", "CPU p95", "GPU mean", "GPU p95"};
+                for (auto c : columns)
+                    ImGui::TableSetupColumn(c, ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableHeadersRow();
+                for (const auto& s : profiler->statistics()) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%*s%s", s.depth * 2, "", s.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", static_cast<int>(s.count));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", s.cpu_mean);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", s.cpu_p95);
+                    ImGui::TableNextColumn();
+                    if (s.has_gpu) ImGui::Text("%.3f", s.gpu_mean); else ImGui::TextDisabled("-");
+                    ImGui::TableNextColumn();
+                    if (s.has_gpu) ImGui::Text("%.3f", s.gpu_p95); else ImGui::TextDisabled("-");
+                }
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+
+
     void ViewerImGui::post_draw() {
         static bool show_overlay = true;
         if (show_overlay)
             draw_overlay(&show_overlay);
 
+        bool show_profiler = profiler()->is_enabled();
+        if (show_profiler) {
+            draw_profiler(&show_profiler);
+            profiler()->set_enabled(show_profiler);
+        }
+
         static bool show_about = false;
 		if (show_about) {
             ImGui::SetNextWindowPos(ImVec2(width() * 0.5f, height() * 0.5f), ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
@@ -352,6 +415,10 @@ namespace easy3d {
             if (ImGui::MenuItem("Snapshot", nullptr))
                 snapshot();
 
+            bool show_profiler = profiler()->is_enabled();
+            if (ImGui::MenuItem("Profiler", nullptr, &show_profiler))
+                profiler()->set_enabled(show_profiler);
+
             ImGui::Separator();
             if (ImGui::BeginMenu("Options"))
             {
@@ -95,6 +95,9 @@ namespace easy3d {
         // with no decoration + a context-menu to choose its position.
         void  draw_overlay(bool* visible);
 
+        // Shows the CPU/GPU time of the frames, render passes, and drawables recorded by the profiler.
+        void  draw_profiler(bool* visible);
+
 	protected:
 		// Single global context by default, but can be overridden by the user
 		static ImGuiContext *	context_;
@@ -26,12 +26,21 @@
 
 #include "viewer.h"
 #include <easy3d/fileio/resources.h>
+#include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/manipulated_camera_frame.h>
+#include <easy3d/renderer/key_frame_interpolator.h>
 #include <easy3d/util/logging.h>
 
+#include <cstdlib>
+
 
 // This example shows how to
 //        - creat an exploration path using the key frame interpolator,
-//        - play the path as an animation.
+//        - play the path as an animation,
+//        - benchmark the rendering along a camera path without showing the window, e.g.,
+//              Tutorial_204_CameraInterpolation --benchmark 300 stats.json [model_file] [camera_path_file]
+//          The camera orbits around the model if no camera path is given. It also works with software OpenGL,
+//          e.g., "LIBGL_ALWAYS_SOFTWARE=1 xvfb-run Tutorial_204_CameraInterpolation --benchmark ...".
 
 using namespace easy3d;
 
@@ -39,7 +48,8 @@ int main(int argc, char** argv) {
     // Initialize logging.
     logging::initialize();
 
-    const std::string& file_name = resource::directory() + "/data/building.off";
+    const bool benchmark = argc >= 4 && std::string(argv[1]) == "--benchmark";
+    const std::string& file_name = (benchmark && argc >= 5) ? argv[4] : resource::directory() + "/data/building.off";
 
     CameraIntrepolation viewer("Tutorial_204_CameraInterpolation");
     if (!viewer.add_model(file_name, true)) {
@@ -47,5 +57,14 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    if (benchmark) {
+        KeyFrameInterpolator path(viewer.camera()->frame());
+        if (argc >= 6 && !path.read_keyframes(argv[5])) {
+            LOG(ERROR) << "Error: failed to read the camera path from file: " << argv[5];
+            return EXIT_FAILURE;
+        }
+        return viewer.benchmark(std::atoi(argv[2]), argv[3], &path);
+    }
+
     return viewer.run();
 }
@@ -55,6 +55,7 @@ std::string PickerViewer::usage() const {
 
 bool PickerViewer::mouse_press_event(int x, int y, int button, int modifiers) {
     ModelPicker picker(camera());
+    picker.set_batcher(batcher());
     auto model = picker.pick(models(), x, y);
     if (model)
         mark(model);
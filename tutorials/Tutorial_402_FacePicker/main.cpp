@@ -31,7 +31,8 @@
 
 using namespace easy3d;
 
-// This example shows how to select a face of a surface mesh by clicking the mouse.
+// This example shows how to select a face of a surface mesh by clicking the mouse, and how to highlight the face
+// under the cursor.
 
 int main(int argc, char **argv) {
     // Initialize logging.
@@ -40,6 +40,9 @@ PickerViewer::PickerViewer(const std::string &title)
         : Viewer(title) {
     camera()->setUpVector(vec3(0, 1, 0));
     camera()->setViewDirection(vec3(0, 0, -1));
+
+    // the scene is rendered for picking only when the camera or the model changes
+    Picker::set_persistent_id_buffer(true);
 }
 
 
@@ -49,36 +52,66 @@ PickerViewer::~PickerViewer() {
 
 std::string PickerViewer::usage() const {
     return ("------------ Picker Viewer usage ---------- \n"
+            "Move the mouse to highlight a face\n"
             "Press the mouse to pick a face\n"
             "------------------------------------------ \n");
 }
 
 
+// highlights a face (the highlight is removed if the face is invalid)
+static void highlight(SurfaceMesh *model, SurfaceMesh::Face face) {
+    auto drawable = model->renderer()->get_triangles_drawable("faces");
+    auto triangle_range = model->get_face_property<std::pair<int, int> >("f:triangle_range");
+    if (triangle_range && face.is_valid()) {
+        drawable->set_highlight_range(triangle_range[face]);
+        drawable->set_highlight(true);
+    }
+    else {
+        drawable->set_highlight_range(std::make_pair(-1, -1));
+        drawable->set_highlight(false);
+    }
+
+    LOG_IF(!triangle_range, ERROR) << "face property 'f:triangle_range' not defined";
+}
+
+
 bool PickerViewer::mouse_press_event(int x, int y, int button, int modifiers) {
     auto model = dynamic_cast<SurfaceMesh *>(current_model());
     if (model) {
         SurfaceMeshPicker picker(camera());
         auto face = picker.pick_face(model, x, y);
-        auto drawable = model->renderer()->get_triangles_drawable("faces");
-        auto triangle_range = model->get_face_property<std::pair<int, int> >("f:triangle_range");
-        if (triangle_range && face.is_valid()) {
-            const auto& range = triangle_range[face];
-            drawable->set_highlight_range(range);
-            drawable->set_highlight(true);
+        highlight(model, face);
+        if (face.is_valid())
             std::cout << "picked face " << face << std::endl;
-        }
-        else {
-            drawable->set_highlight_range(std::make_pair(-1, -1));
-            drawable->set_highlight(false);
-        }
-
-        LOG_IF(!triangle_range, ERROR) << "face property 'f:triangle_range' not defined";
     }
 
     return Viewer::mouse_press_event(x, y, button, modifiers);
 }
 
 
+bool PickerViewer::mouse_free_move_event(int x, int y, int dx, int dy, int modifiers) {
+    auto model = dynamic_cast<SurfaceMesh *>(current_model());
+    if (model) {
+        // the face is read back asynchronously, so this never waits for the GPU
+        SurfaceMeshPicker picker(camera());
+        SurfaceMesh::Face face;
+        if (picker.pick_face_async(model, x, y, face)) {
+            highlight(model, face);
+            update();
+        }
+    }
+
+    return Viewer::mouse_free_move_event(x, y, dx, dy, modifiers);
+}
+
+
+void PickerViewer::cleanup() {
+    // the ID buffer must be released while the OpenGL context still exists
+    Picker::release_id_buffer();
+    Viewer::cleanup();
+}
+
+
 Model* PickerViewer::add_model(const std::string& file_name, bool create_default_drawables) {
     Model* model = Viewer::add_model(file_name, create_default_drawables);
 
@@ -30,7 +30,8 @@
 #include <easy3d/viewer/viewer.h>
 
 
-// This class demonstrates how to pick faces in a surface mesh using the mouse
+// This class demonstrates how to pick faces in a surface mesh using the mouse, and how to highlight the face under
+// the cursor
 
 namespace easy3d {
     class Model;
@@ -45,6 +46,9 @@ public:
 
 protected:
     bool mouse_press_event(int x, int y, int button, int modifiers) override;
+    bool mouse_free_move_event(int x, int y, int dx, int dy, int modifiers) override;
+
+    void cleanup() override;
 
     std::string usage() const override;
 };
@@ -127,8 +127,20 @@ void PointSelection::mark_selection(PointCloud *cloud) {
     auto drawable = cloud->renderer()->get_points_drawable("vertices");
     auto select = cloud->vertex_property<bool>("v:select");
     auto colors = cloud->vertex_property<vec3>("v:color");
-    for(auto v : cloud->vertices())
-        colors[v] = select[v] ? vec3(1,0,0) : drawable->color();    // mark selected points red
-    drawable->set_coloring(easy3d::State::COLOR_PROPERTY, easy3d::State::VERTEX, "v:color");
-    drawable->update();
+    const bool colored = drawable->coloring_method() == easy3d::State::COLOR_PROPERTY &&
+                         drawable->property_name() == "v:color";
+    for (auto v : cloud->vertices()) {
+        const vec3 color = select[v] ? vec3(1, 0, 0) : drawable->color();    // mark selected points red
+        if (colors[v] != color) {
+            colors[v] = color;
+            cloud->mark_modified("v:color", v.idx());
+        }
+    }
+
+    if (!colored) {   // the first selection creates the color buffer
+        drawable->set_coloring(easy3d::State::COLOR_PROPERTY, easy3d::State::VERTEX, "v:color");
+        drawable->update();
+        cloud->clear_modified();
+    } else  // only the colors of the points whose selection changed are uploaded
+        cloud->renderer()->update_modified();
 }
\ No newline at end of file